@@ -24,6 +24,11 @@ def print_usage(projects):
     else:
         print("  No projects found (expected directories in the root folder starting with 'prj_').")
 
+    print("\nOptions:")
+    print("  -jN               Number of parallel compile jobs (default: CPU count).")
+    print("  --profile=<name>  Build profile: debug (default), release, or speed.")
+    print("                    See BUILD_PROFILES in tools/config.py.")
+
     print("\nCommands:")
     print("  build    (default) Incrementally builds the selected project.")
     print("  rebuild  Cleans and then builds the project from scratch.")
@@ -33,6 +38,9 @@ def print_usage(projects):
     print("  nucleus  Builds and programs using Nuclei-specific OpenOCD.")
     print("  dfu      Builds and programs using DFU-util.")
     print("  debug    Builds the project and starts an interactive GDB debug session.")
+    print("  bench    Builds and runs the host benchmark harness (HOST_BENCH in config.py).")
+    print("  audit    Builds, then flags dead and duplicated code in the linked image")
+    print("           and writes a symbol-to-component map (bldmgr/linkaudit.py).")
     sys.exit(1)
 
 def main():
@@ -40,6 +48,36 @@ def main():
     project_root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
     available_projects = find_projects(project_root)
 
+    # Extract an optional make-style -jN (or "-j N") before positional parsing.
+    jobs = None
+    args = sys.argv[:]
+    for i, arg in enumerate(args):
+        if arg.startswith("-j"):
+            value = arg[2:] if len(arg) > 2 else (args[i + 1] if i + 1 < len(args) else "")
+            try:
+                jobs = int(value)
+            except ValueError:
+                print(f"\n❌ Error: Invalid job count '{value}' for -j.", file=sys.stderr)
+                sys.exit(1)
+            del sys.argv[i:i + (1 if len(arg) > 2 else 2)]
+            break
+
+    # Extract an optional --profile=<name> (or "--profile <name>").
+    profile = None
+    args = sys.argv[:]
+    for i, arg in enumerate(args):
+        if arg.startswith("--profile"):
+            if arg.startswith("--profile="):
+                profile = arg[len("--profile="):]
+                del sys.argv[i:i + 1]
+            else:
+                profile = args[i + 1] if i + 1 < len(args) else ""
+                del sys.argv[i:i + 2]
+            if not profile:
+                print("\n❌ Error: --profile requires a profile name.", file=sys.stderr)
+                sys.exit(1)
+            break
+
     if len(sys.argv) < 2 or sys.argv[1] not in available_projects:
         print("\n❌ Error: Project name not specified or not found.")
         print_usage(available_projects)
@@ -58,7 +96,7 @@ def main():
         sys.exit(1)
 
     # Pass both the loaded config module and the project name to the builder
-    builder = Builder(config, project_name)
+    builder = Builder(config, project_name, jobs=jobs, profile=profile)
     command = "build"
     if len(sys.argv) > 2:
         command = sys.argv[2]
@@ -85,6 +123,10 @@ def main():
     elif command == "debug":
         builder.build_all()
         builder.debug_session()
+    elif command == "bench":
+        builder.host_bench()
+    elif command == "audit":
+        builder.link_audit()
     else:
         print(f"\n❌ Error: Unknown command '{command}'")
         print_usage(available_projects)
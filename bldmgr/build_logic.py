@@ -2,10 +2,13 @@ import os
 import subprocess
 import shutil
 import sys
-import re
 import urllib.request
 import zipfile
 import tarfile
+import hashlib
+import json
+import zlib
+from concurrent.futures import ThreadPoolExecutor
 
 def _download_and_extract_tool(url: str, archive_path: str, extract_dir: str, final_check_path: str, rename_map: dict = None):
     """
@@ -92,12 +95,34 @@ class Builder:
     Receives configuration dynamically and supports incremental C/C++ builds.
     """
 
-    def __init__(self, config_module, project_name):
+    def __init__(self, config_module, project_name, jobs=None, profile=None):
         """Initializes the builder, sets up toolchain paths, and constructs build flags."""
         self.config = config_module
         self.project_name = project_name
-        # Create a project-specific build directory, e.g., 'build/prj_usb_serial'
-        self.build_dir = os.path.join(self.config.BUILD_DIR, self.project_name)
+        # Build profile (debug/release/speed): baseline optimization level,
+        # debug info, and LTO. See BUILD_PROFILES in tools/config.py.
+        profile_name = profile or "debug"
+        profiles = self.config.BUILD_PROFILES
+        if profile_name not in profiles:
+            print(f"❌ Error: Unknown build profile '{profile_name}'. "
+                  f"Available: {', '.join(sorted(profiles))}.", file=sys.stderr)
+            sys.exit(1)
+        self.profile_name = profile_name
+        self.profile = profiles[profile_name]
+        # Number of parallel compile jobs (-j). Compile steps are independent;
+        # only the final link is serialized.
+        self.jobs = jobs if jobs and jobs > 0 else (os.cpu_count() or 1)
+        # Shared object cache, keyed on content hashes. It lives beside the
+        # per-project build directories, so objects for lib/ and gd32/ sources
+        # compiled with identical flags are reused across projects/branches.
+        self.cache_dir = os.path.join(self.config.BUILD_DIR, ".objcache")
+        # Create a project-specific build directory, e.g., 'build/prj_usb_serial'.
+        # Non-default profiles get their own directory (build/prj_usb_serial-release)
+        # so switching profiles never mixes objects; the shared cache makes the
+        # switch cheap anyway.
+        build_dir_name = self.project_name if profile_name == "debug" \
+            else f"{self.project_name}-{profile_name}"
+        self.build_dir = os.path.join(self.config.BUILD_DIR, build_dir_name)
 
         self._ensure_tools_are_present()
         if self.config.TOOLCHAIN_PATH and self.config.TOOLCHAIN_PATH not in os.environ['PATH']:
@@ -106,7 +131,9 @@ class Builder:
         self.cc = self.config.TOOLCHAIN_PREFIX + "gcc"
         self.cpp = self.config.TOOLCHAIN_PREFIX + "g++"
         self.asm = self.config.TOOLCHAIN_PREFIX + "gcc"
+        self.ar = self.config.TOOLCHAIN_PREFIX + "ar"
         self.cp = self.config.TOOLCHAIN_PREFIX + "objcopy"
+        self.nm = self.config.TOOLCHAIN_PREFIX + "nm"
         self.sz = self.config.TOOLCHAIN_PREFIX + "size"
 
         self._collect_sources_and_includes()
@@ -143,6 +170,14 @@ class Builder:
         self.cpp_sources = []
         self.asm_sources = []
         self.include_paths = []
+        # Per-source optimization level, from a component's optional
+        # 'optimization' key. Overrides the profile baseline for every
+        # source in that component.
+        self.opt_overrides = {}
+        # Sources grouped by component, in table order: each component is
+        # archived into its own .a so a relink only re-archives the
+        # component(s) that actually recompiled.
+        self.component_sources = {}
 
         print("🔎 Analyzing project components...")
         for name, component in self.config.COMPONENTS.items():
@@ -151,9 +186,19 @@ class Builder:
                 module = component.get("module", self.project_name)
 
                 # Prepend the project directory to all relative paths from the config
-                self.c_sources.extend([os.path.join(module, p) for p in component.get("c_sources", [])])
-                self.cpp_sources.extend([os.path.join(module, p) for p in component.get("cpp_sources", [])])
-                self.asm_sources.extend([os.path.join(module, p) for p in component.get("asm_sources", [])])
+                c_sources = [os.path.join(module, p) for p in component.get("c_sources", [])]
+                cpp_sources = [os.path.join(module, p) for p in component.get("cpp_sources", [])]
+                asm_sources = [os.path.join(module, p) for p in component.get("asm_sources", [])]
+                self.c_sources.extend(c_sources)
+                self.cpp_sources.extend(cpp_sources)
+                self.asm_sources.extend(asm_sources)
+                if c_sources or cpp_sources or asm_sources:
+                    self.component_sources[name] = c_sources + cpp_sources + asm_sources
+
+                opt = component.get("optimization")
+                if opt:
+                    for src in c_sources + cpp_sources + asm_sources:
+                        self.opt_overrides[src] = opt
 
                 for inc_path in component.get("include_paths", []):
                     if inc_path.startswith("-I"):
@@ -165,41 +210,77 @@ class Builder:
             else:
                 print(f"  - Disabling component: {name}")
         
+        # Generated fonts (GENERATED_FONTS in the project config) compile
+        # like any other component; the sources appear once generate_fonts()
+        # has run. Older project configs simply do not define the list.
+        self.font_specs = getattr(self.config, "GENERATED_FONTS", [])
+        # Shared protocol definitions (PROTOCOL_DEF) render into the same
+        # generated directory; see generate_protocol().
+        self.protocol_def = getattr(self.config, "PROTOCOL_DEF", None)
+        self.protocol_host_out = getattr(self.config, "PROTOCOL_HOST_OUT", None)
+        # Code overlays (OVERLAYS in the project config): cold functions
+        # the linker parks in one shared RAM region, stored compressed in
+        # flash by ovlpack.py after the link. See lib/overlay/overlay.h.
+        self.overlays = getattr(self.config, "OVERLAYS", [])
+        # Every project has a generated directory now: buildinfo.h is
+        # emitted unconditionally (generate_buildinfo), and the fonts and
+        # protocol outputs render into the same place when configured.
+        self.generated_dir = os.path.join(self.build_dir, "generated")
+        self.include_paths.append(f"-I{self.generated_dir}")
+        if self.font_specs:
+            font_sources = [os.path.join(self.generated_dir, f"font_{spec['name']}.c")
+                            for spec in self.font_specs]
+            self.c_sources.extend(font_sources)
+            self.component_sources["generated_fonts"] = font_sources
+
         self.is_cpp_project = bool(self.cpp_sources)
         self.include_paths = sorted(list(set(self.include_paths)))
 
     def _construct_flags(self):
         """Builds the final lists of CFLAGS, ASFLAGS, CPPFLAGS, and LDFLAGS."""
+        # The profile sets the baseline optimization level; components may
+        # override it per-source (see _source_flags).
+        self.optimization = self.profile["optimization"]
+        lto_flags = self.config.LTO_FLAGS if self.profile["lto"] else []
+
         # Add global C definitions to the base flags for all compiler invocations.
         base_flags = self.config.CPU_FLAGS + [
-            self.config.OPTIMIZATION,
+            self.optimization,
             "-Wall", # Enable all standard warnings.
             "-ffunction-sections", # Place each function in its own section.
             "-fdata-sections"
-        ] + self.config.COMMON_WARNING_FLAGS + self.config.GLOBAL_C_DEFINES
+        ] + lto_flags + self.config.COMMON_WARNING_FLAGS + self.config.GLOBAL_C_DEFINES
 
         # C Flags
         self.cflags = base_flags + [self.config.C_STANDARD] + self.config.C_WARNING_FLAGS + self.include_paths + ["-MMD", "-MP"]
-        if self.config.DEBUG_MODE:
+        if self.config.DEBUG_MODE and self.profile["debug_info"]:
             self.cflags.extend(["-g", "-gdwarf-2"])
 
         # C++ Flags
         self.cppflags = base_flags + [self.config.CPP_STANDARD] + self.config.CPP_WARNING_FLAGS + self.config.CPP_EMBEDDED_FLAGS + self.include_paths + ["-MMD", "-MP"]
-        if self.config.DEBUG_MODE:
+        if self.config.DEBUG_MODE and self.profile["debug_info"]:
             self.cppflags.extend(["-g", "-gdwarf-2"])
 
         # Assembler Flags (Definitions are also needed here for C preprocessor directives in .S files)
-        self.asflags = self.config.CPU_FLAGS + [self.config.OPTIMIZATION] + self.include_paths + self.config.GLOBAL_C_DEFINES
+        self.asflags = self.config.CPU_FLAGS + [self.optimization] + self.include_paths + self.config.GLOBAL_C_DEFINES + ["-MMD", "-MP"]
 
         # Linker Flags
         linker_script_path = self.config.LINKER_SCRIPT
         self.ldflags = self.config.CPU_FLAGS + [
             "-nostartfiles",
             f"-T{linker_script_path}",
+            # The linker script INCLUDEs the function-order fragments that
+            # generate_function_order() writes into the build directory.
+            f"-Wl,-L{self.build_dir}",
             "--specs=nano.specs", # Use newlib-nano for reduced code size.
             "-Xlinker", "--gc-sections", # Allow the linker to remove unused sections.
             f"-Wl,-Map={os.path.join(self.build_dir, self.config.TARGET_NAME)}.map"
         ] + self.config.LIBRARIES
+
+        # LTO happens at link time: the driver needs the optimization level
+        # and -flto again so the whole-program compile sees the same options.
+        if self.profile["lto"]:
+            self.ldflags = [self.optimization] + lto_flags + self.ldflags
         
         if self.is_cpp_project:
             self.ldflags.append("-lstdc++")
@@ -232,19 +313,28 @@ class Builder:
             - build_dir: "build/prj_usb_serial"
             - Returns: "build/prj_usb_serial/src/main.c.o"
         """
+        # Generated sources already live in the build directory; their
+        # objects go right next to them.
+        if src_file.startswith(self.build_dir):
+            return src_file + '.o'
         relative_src_path = os.path.relpath(src_file, self.project_name)
         return os.path.join(self.build_dir, os.path.normpath(relative_src_path) + '.o')
 
     def _parse_dependencies(self, dep_file):
         """
-        Parses a GCC-generated dependency file (.d) to extract all header dependencies.
+        Parses a GCC-generated dependency file (.d) to extract all prerequisites.
         This is used for incremental build checks.
+
+        Every prerequisite counts, whatever its extension: the old .h/.inc
+        regex silently skipped the project's .hpp headers, so edits to them
+        left stale objects behind. Make targets (the object itself and the
+        -MP phony targets) end with ':' and are dropped.
         """
         if not os.path.exists(dep_file):
             return []
         with open(dep_file, 'r') as f:
-            content = f.read()
-        return re.findall(r'([^\s\\]+\.(?:h|inc))', content)
+            content = f.read().replace('\\\n', ' ')
+        return [tok for tok in content.split() if not tok.endswith(':')]
 
     def _is_rebuild_needed(self, src_file, obj_file):
         """
@@ -261,8 +351,9 @@ class Builder:
         if os.path.getmtime(src_file) > obj_mtime:
             return True
 
-        # For C/C++ files, check their header dependencies.
-        if src_file.endswith((".c", ".cpp", ".cc", ".cxx")):
+        # Check header dependencies (.S files include headers too, e.g.
+        # riscv_encoding.h in start.S, and now emit .d files as well).
+        if src_file.endswith((".c", ".cpp", ".cc", ".cxx", ".S", ".s")):
             dep_file = obj_file.replace('.o', '.d')
             if not os.path.exists(dep_file):
                 return True
@@ -274,10 +365,321 @@ class Builder:
                     return True
         return False
 
+    # ------------------------------------------------------------------
+    # Content-hash object cache
+    #
+    # An entry is keyed in two steps, the way ccache's direct mode works:
+    #   base key = hash(compile flags + source file content)
+    #   full key = hash(base key + content of every header the compile
+    #              actually included, per the .d file of a prior compile)
+    # The base-key directory stores the last-known dependency list; a
+    # lookup re-hashes those headers as they are NOW, so any header edit
+    # changes the full key and misses. A hit is only possible when source,
+    # flags and every included header are byte-identical to a previous
+    # compile, which makes reuse across projects and branches safe.
+    # ------------------------------------------------------------------
+
+    @staticmethod
+    def _hash_file(path):
+        digest = hashlib.sha256()
+        with open(path, 'rb') as f:
+            digest.update(f.read())
+        return digest.hexdigest()
+
+    def _cache_base_key(self, src, cmd):
+        digest = hashlib.sha256()
+        # The command already encodes compiler, standard, defines and -I
+        # paths; drop the object path so the key is location-independent.
+        flags = [arg for arg in cmd if not arg.endswith('.o')]
+        digest.update(' '.join(flags).encode())
+        digest.update(self._hash_file(src).encode())
+        return digest.hexdigest()
+
+    def _cache_full_key(self, base_key, deps):
+        digest = hashlib.sha256(base_key.encode())
+        for dep in deps:
+            if not os.path.exists(dep):
+                return None
+            digest.update(self._hash_file(dep).encode())
+        return digest.hexdigest()
+
+    def _cache_fetch(self, src, cmd, obj_path):
+        """Copies a cached object (and its .d file) into place. Returns True on a hit."""
+        base_key = self._cache_base_key(src, cmd)
+        entry_dir = os.path.join(self.cache_dir, base_key[:2], base_key)
+        manifest = os.path.join(entry_dir, 'deps')
+        if not os.path.exists(manifest):
+            return False
+        with open(manifest, 'r') as f:
+            deps = [line.strip() for line in f if line.strip()]
+        full_key = self._cache_full_key(base_key, deps)
+        if full_key is None:
+            return False
+        cached_obj = os.path.join(entry_dir, full_key + '.o')
+        if not os.path.exists(cached_obj):
+            return False
+        shutil.copyfile(cached_obj, obj_path)
+        cached_dep = os.path.join(entry_dir, full_key + '.d')
+        if os.path.exists(cached_dep):
+            shutil.copyfile(cached_dep, obj_path.replace('.o', '.d'))
+        return True
+
+    def _cache_store(self, src, cmd, obj_path):
+        """Files a freshly compiled object under its content keys."""
+        base_key = self._cache_base_key(src, cmd)
+        entry_dir = os.path.join(self.cache_dir, base_key[:2], base_key)
+        os.makedirs(entry_dir, exist_ok=True)
+
+        dep_file = obj_path.replace('.o', '.d')
+        deps = sorted(set(self._parse_dependencies(dep_file)))
+        full_key = self._cache_full_key(base_key, deps)
+        if full_key is None:
+            return
+
+        # Write-then-rename so a parallel job never sees a partial entry.
+        tmp = os.path.join(entry_dir, full_key + '.o.tmp')
+        shutil.copyfile(obj_path, tmp)
+        os.replace(tmp, os.path.join(entry_dir, full_key + '.o'))
+        if os.path.exists(dep_file):
+            tmp = os.path.join(entry_dir, full_key + '.d.tmp')
+            shutil.copyfile(dep_file, tmp)
+            os.replace(tmp, os.path.join(entry_dir, full_key + '.d'))
+        tmp = os.path.join(entry_dir, 'deps.tmp')
+        with open(tmp, 'w') as f:
+            f.write('\n'.join(deps))
+        os.replace(tmp, os.path.join(entry_dir, 'deps'))
+
+    def _compile_one(self, src, cmd):
+        """
+        Runs a single compile command with captured output so parallel jobs
+        do not interleave their diagnostics. Returns (src, returncode, output).
+        """
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        output = (result.stdout or "") + (result.stderr or "")
+        if result.returncode == 0:
+            # cmd ends with ["-o", obj_path]
+            self._cache_store(src, cmd, cmd[-1])
+        return (src, result.returncode, output)
+
+    def _source_flags(self, src, flags):
+        """
+        Applies a component's per-source optimization override by swapping
+        the profile's baseline level out of the flag list. The object cache
+        keys on the full command, so overridden and baseline objects never
+        collide.
+        """
+        opt = self.opt_overrides.get(src)
+        if opt is None or opt == self.optimization:
+            return flags
+        return [opt if flag == self.optimization else flag for flag in flags]
+
+    def generate_fonts(self):
+        """
+        Runs bldmgr/fontgen.py for every entry in GENERATED_FONTS, emitting
+        font_<name>.c/.h into the build directory. A font is regenerated
+        when its output is missing or older than the TTF or the generator.
+        """
+        if not self.font_specs:
+            return
+        print("🔤 Generating fonts...")
+        generator = os.path.join("bldmgr", "fontgen.py")
+        regenerated = 0
+        for spec in self.font_specs:
+            out_c = os.path.join(self.generated_dir, f"font_{spec['name']}.c")
+            if os.path.exists(out_c):
+                out_mtime = os.path.getmtime(out_c)
+                if (os.path.getmtime(spec["ttf"]) <= out_mtime
+                        and os.path.getmtime(generator) <= out_mtime):
+                    continue
+            cmd = [sys.executable, generator, spec["ttf"],
+                   "--size", str(spec["size"]), "--name", spec["name"],
+                   "--out-dir", self.generated_dir]
+            if "chars" in spec:
+                cmd.extend(["--chars", spec["chars"]])
+            if spec.get("rle"):
+                cmd.append("--rle")
+            result = subprocess.run(cmd, capture_output=True, text=True)
+            if result.returncode != 0:
+                print(result.stdout + result.stderr, file=sys.stderr)
+                print(f"❌ Error: Font generation for '{spec['name']}' failed.", file=sys.stderr)
+                sys.exit(1)
+            print(result.stdout, end="")
+            regenerated += 1
+        if not regenerated:
+            print("  - All fonts up-to-date.")
+
+    def generate_protocol(self):
+        """
+        Runs bldmgr/protogen.py to render the declarative protocol
+        description (PROTOCOL_DEF) into the firmware's display_protocol.h
+        and the host tools' display_protocol.py (PROTOCOL_HOST_OUT), so
+        the two sides of the link share one definition of every command
+        id, report id and flag bit. Regenerated when either output is
+        missing or older than the description or the generator; the
+        generator itself skips the write when nothing changed, keeping
+        incremental builds from recompiling every includer.
+        """
+        if not self.protocol_def:
+            return
+        generator = os.path.join("bldmgr", "protogen.py")
+        cpp_out = os.path.join(self.generated_dir, "display_protocol.h")
+        outputs = [cpp_out] + ([self.protocol_host_out]
+                               if self.protocol_host_out else [])
+        src_mtime = max(os.path.getmtime(self.protocol_def),
+                        os.path.getmtime(generator))
+        if all(os.path.exists(out) and os.path.getmtime(out) >= src_mtime
+               for out in outputs):
+            return
+        print("📜 Generating protocol definitions...")
+        cmd = [sys.executable, generator, self.protocol_def,
+               "--cpp-out", cpp_out]
+        if self.protocol_host_out:
+            cmd.extend(["--py-out", self.protocol_host_out])
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            print(result.stdout + result.stderr, file=sys.stderr)
+            print("❌ Error: Protocol generation failed.", file=sys.stderr)
+            sys.exit(1)
+        print(result.stdout, end="")
+
+    def generate_buildinfo(self):
+        """
+        Writes buildinfo.h into the generated directory: the git
+        revision, the build profile name, the project's feature defines
+        and a CRC32 fingerprint over the configuration. The firmware
+        embeds the strings in flash so a running board can always answer
+        "what build is this?" (the `build` console command and the
+        GET_BUILD report); the fingerprint is the one word host tools
+        compare when matching stored benchmark results to a
+        configuration — it covers profile, defines and component set,
+        but not the commit, so it stays stable across changes that do
+        not alter the build shape. Written only when the content
+        changes, like the other generators, so an unchanged tree does
+        not recompile every includer.
+        """
+        result = subprocess.run(["git", "describe", "--always", "--dirty"],
+                                capture_output=True, text=True)
+        git_rev = result.stdout.strip() if result.returncode == 0 else "unknown"
+        defines = [d[2:] for d in getattr(self.config, "GLOBAL_C_DEFINES", [])
+                   if d.startswith("-D")]
+        components = sorted(self.component_sources)
+        fingerprint = zlib.crc32("\n".join(
+            [self.profile_name] + defines + components).encode()) & 0xFFFFFFFF
+
+        lines = [
+            "// Auto-generated by bldmgr/build_logic.py (generate_buildinfo).",
+            "// Do not edit: identity of this exact build, embedded so the",
+            "// board can report what it is running (console `build` command,",
+            "// GET_BUILD on the status endpoint).",
+            "#pragma once",
+            "",
+            f'#define BUILDINFO_GIT "{git_rev}"',
+            f'#define BUILDINFO_PROFILE "{self.profile_name}"',
+            f'#define BUILDINFO_FLAGS "{" ".join(defines)}"',
+            "// CRC32 over profile + feature defines + component set; host",
+            "// benchmark records key on this, not on the commit hash.",
+            f"#define BUILDINFO_FINGERPRINT 0x{fingerprint:08X}u",
+            "",
+        ]
+        content = "\n".join(lines)
+        out_path = os.path.join(self.generated_dir, "buildinfo.h")
+        if os.path.exists(out_path):
+            with open(out_path, "r") as f:
+                if f.read() == content:
+                    return
+        os.makedirs(self.generated_dir, exist_ok=True)
+        with open(out_path, "w") as f:
+            f.write(content)
+        print(f"🔖 Build identity: {git_rev} [{self.profile_name}] "
+              f"fingerprint 0x{fingerprint:08X}")
+
+    def generate_function_order(self):
+        """
+        Writes the hot_text.ld / hot_ramtext.ld fragments the linker script
+        INCLUDEs. With FUNCTION_ORDER_PROFILE in the project config pointing
+        at a hit-count dump (captured over UART), bldmgr/funcorder.py orders
+        hot functions into early flash and promotes the top of the profile
+        into .ramtext; without one the fragments are empty and the layout is
+        unchanged.
+        """
+        profile = getattr(self.config, "FUNCTION_ORDER_PROFILE", None)
+        generator = os.path.join("bldmgr", "funcorder.py")
+        fragments = [os.path.join(self.build_dir, name)
+                     for name in ("hot_text.ld", "hot_ramtext.ld")]
+        os.makedirs(self.build_dir, exist_ok=True)
+
+        if profile and os.path.exists(profile):
+            if (all(os.path.exists(f) for f in fragments)
+                    and all(os.path.getmtime(profile) <= os.path.getmtime(f)
+                            and os.path.getmtime(generator) <= os.path.getmtime(f)
+                            for f in fragments)):
+                return
+            print("🔥 Generating function order from profile...")
+            cmd = [sys.executable, generator, profile,
+                   "--out-dir", self.build_dir,
+                   "--ramtext-top",
+                   str(getattr(self.config, "FUNCTION_ORDER_RAMTEXT_TOP", 0))]
+            self.run_command(cmd)
+        else:
+            for fragment in fragments:
+                if not os.path.exists(fragment):
+                    with open(fragment, 'w') as f:
+                        f.write("/* No function-order profile configured; "
+                                "see bldmgr/funcorder.py. */\n")
+
+    def generate_overlay_fragment(self):
+        """
+        Writes the overlay.ld fragment the linker script INCLUDEs. With
+        OVERLAYS in the project config it emits the OVERLAY directive
+        that parks every .ovl.<name> section at one shared RAM address
+        (carved from the heap, so the existing __heap_floor assert still
+        bounds it) and pins the packed store's flash address; without it
+        the fragment is an empty placeholder, like the function-order
+        ones.
+        """
+        path = os.path.join(self.build_dir, "overlay.ld")
+        os.makedirs(self.build_dir, exist_ok=True)
+        if not self.overlays:
+            text = "/* No code overlays configured; see lib/overlay/overlay.h. */\n"
+        else:
+            members = "\n".join(
+                f"  .ovl.{name} {{ *(.ovl.{name} .ovl.{name}.*) }}"
+                for name in self.overlays)
+            sizes = " + ".join(f"SIZEOF(.ovl.{name})" for name in self.overlays)
+            text = (
+                "/* Code overlays (OVERLAYS in the project config): the members\n"
+                "   share one RAM address and are loaded on demand by ovl::load();\n"
+                "   bldmgr/ovlpack.py replaces their raw flash images with a\n"
+                "   compressed store after the link. Generated; do not edit. */\n"
+                ".ovlalign : { . = ALIGN(4); PROVIDE( _ovl_lma = . ); } >flash AT>flash\n"
+                "OVERLAY : NOCROSSREFS AT ( _ovl_lma )\n"
+                "{\n"
+                f"{members}\n"
+                "} >ram\n"
+                f"PROVIDE( _ovl_ram = ADDR(.ovl.{self.overlays[0]}) );\n"
+                "/* AT() bypasses the flash region accounting, so check the\n"
+                "   raw (pre-pack) images against the region end by hand. */\n"
+                f"ASSERT( _ovl_lma + {sizes} <= ORIGIN(flash) + LENGTH(flash),\n"
+                "        \"flash overflow: code overlays past the resident region\" )\n"
+            )
+        if os.path.exists(path):
+            with open(path, 'r') as f:
+                if f.read() == text:
+                    return
+        with open(path, 'w') as f:
+            f.write(text)
+
     def compile_sources(self):
-        """Compiles all C, C++, and Assembly sources into object files, skipping unchanged files."""
-        print("⚙️  Compiling sources...")
+        """
+        Compiles all C, C++, and Assembly sources into object files, skipping
+        unchanged files. Out-of-date files are compiled in parallel (-j jobs,
+        defaulting to the CPU count); the object list keeps source order so
+        the final link is deterministic.
+        """
+        print(f"⚙️  Compiling sources ({self.profile_name} profile, {self.jobs} parallel jobs)...")
         object_files = []
+        pending = []
+        cache_hits = 0
         cpp_extensions = (".cpp", ".cc", ".cxx")
 
         all_sources = self.c_sources + self.cpp_sources + self.asm_sources
@@ -285,54 +687,281 @@ class Builder:
             obj_path = self._get_obj_path(src)
             object_files.append(obj_path)
 
-            print(f"  - Checking '{src}'...")
             if not self._is_rebuild_needed(src, obj_path):
-                print("    -> Up-to-date. Skipping.")
                 continue
 
-            print(f"    -> Compiling...")
             os.makedirs(os.path.dirname(obj_path), exist_ok=True)
 
             if src.endswith(".c"):
-                cmd = [self.cc] + self.cflags + ["-c", src, "-o", obj_path]
+                cmd = [self.cc] + self._source_flags(src, self.cflags) + ["-c", src, "-o", obj_path]
             elif src.endswith(cpp_extensions):
-                cmd = [self.cpp] + self.cppflags + ["-c", src, "-o", obj_path]
+                cmd = [self.cpp] + self._source_flags(src, self.cppflags) + ["-c", src, "-o", obj_path]
             else: # Assumes .S
-                cmd = [self.asm, "-x", "assembler-with-cpp"] + self.asflags + ["-c", src, "-o", obj_path]
-            
-            self.run_command(cmd)
+                cmd = [self.asm, "-x", "assembler-with-cpp"] + self._source_flags(src, self.asflags) + ["-c", src, "-o", obj_path]
+
+            if self._cache_fetch(src, cmd, obj_path):
+                cache_hits += 1
+                continue
+
+            pending.append((src, cmd))
+
+        up_to_date = len(all_sources) - len(pending) - cache_hits
+        if up_to_date:
+            print(f"  - {up_to_date} file(s) up-to-date.")
+        if cache_hits:
+            print(f"  - {cache_hits} file(s) restored from the object cache.")
+        if not pending:
+            return object_files
+
+        failed = False
+        with ThreadPoolExecutor(max_workers=self.jobs) as pool:
+            futures = [pool.submit(self._compile_one, src, cmd) for src, cmd in pending]
+            for future in futures:
+                src, returncode, output = future.result()
+                status = "✅" if returncode == 0 else "❌"
+                print(f"  {status} {src}")
+                if output:
+                    print(output, end="" if output.endswith("\n") else "\n")
+                if returncode != 0:
+                    failed = True
+
+        if failed:
+            print("❌ Error: Compilation failed.", file=sys.stderr)
+            sys.exit(1)
 
         return object_files
 
-    def link_objects(self, object_files):
-        """Links all compiled object files into a single .elf executable."""
+    def archive_components(self):
+        """
+        Bundles each component's objects into a static archive in the build
+        directory, skipping archives whose members are all older than the
+        archive. Returns the archive paths in component-table order.
+        """
+        print("📚 Archiving components...")
+        archives = []
+        refreshed = 0
+        for name, sources in self.component_sources.items():
+            objects = [self._get_obj_path(src) for src in sources]
+            archive = os.path.join(self.build_dir, f"{name}.a")
+            archives.append(archive)
+
+            if os.path.exists(archive):
+                ar_mtime = os.path.getmtime(archive)
+                if all(os.path.getmtime(obj) <= ar_mtime for obj in objects):
+                    continue
+                # 'ar r' would keep stale members after a source is removed
+                # from the component; recreate from scratch instead.
+                os.remove(archive)
+
+            result = subprocess.run([self.ar, "rcs", archive] + objects,
+                                    capture_output=True, text=True)
+            if result.returncode != 0:
+                print(result.stdout + result.stderr, file=sys.stderr)
+                print(f"❌ Error: Archiving '{name}' failed.", file=sys.stderr)
+                sys.exit(1)
+            print(f"  - {os.path.basename(archive)} ({len(objects)} objects)")
+            refreshed += 1
+        if not refreshed:
+            print("  - All archives up-to-date.")
+        return archives
+
+    def link_objects(self, link_inputs):
+        """
+        Links the component archives (or plain objects) into a single .elf
+        executable. Archives are linked --whole-archive so every member is
+        pulled in exactly as the old flat object list was — interrupt
+        handlers and libc overrides stay present without reference tricks —
+        and --gc-sections then discards what is unused.
+        """
         linker = self.cpp if self.is_cpp_project else self.cc
         print(f"🔗 Linking objects (using {os.path.basename(linker)})...")
-        
+
         elf_path = os.path.join(self.build_dir, f"{self.config.TARGET_NAME}.elf")
-        cmd = [linker] + self.ldflags + object_files + ["-o", elf_path]
+        cmd = [linker] + self.ldflags \
+            + ["-Wl,--whole-archive"] + link_inputs + ["-Wl,--no-whole-archive"] \
+            + ["-o", elf_path]
         self.run_command(cmd)
 
         print("📊 Calculating size...")
         self.run_command([self.sz, elf_path])
+        self.report_budget([path for path in link_inputs if path.endswith(".a")])
         return elf_path
 
+    def _archive_sizes(self, archive):
+        """Sums .text/.data/.bss over an archive's members via 'size'."""
+        result = subprocess.run([self.sz, archive], capture_output=True, text=True)
+        if result.returncode != 0:
+            return None
+        text = data = bss = 0
+        for line in result.stdout.splitlines()[1:]:
+            fields = line.split()
+            if len(fields) >= 3 and fields[0].isdigit():
+                text += int(fields[0])
+                data += int(fields[1])
+                bss += int(fields[2])
+        return (text, data, bss)
+
+    def report_budget(self, archives):
+        """
+        Prints a per-component flash/RAM table after every link, with deltas
+        against the previous build of this project/profile (snapshot kept in
+        the build directory). Flash is .text + .data (both occupy the image);
+        RAM is .data + .bss. Numbers are what each component brings to the
+        link, before --gc-sections, so the total exceeds the final .elf —
+        but the deltas attribute a size regression to its component exactly.
+        """
+        current = {}
+        for archive in archives:
+            sizes = self._archive_sizes(archive)
+            if sizes is None:
+                continue
+            text, data, bss = sizes
+            name = os.path.basename(archive)[:-len(".a")]
+            current[name] = {"flash": text + data, "data": data, "bss": bss}
+        if not current:
+            return
+
+        snapshot_path = os.path.join(self.build_dir, "budget.json")
+        previous = {}
+        if os.path.exists(snapshot_path):
+            with open(snapshot_path, 'r') as f:
+                previous = json.load(f)
+
+        def delta(name, field):
+            if name not in previous:
+                return "new" if previous else ""
+            diff = current[name][field] - previous[name].get(field, 0)
+            return f"{diff:+d}" if diff else ""
+
+        name_width = max(len("component"), max(len(n) for n in current))
+        print("📊 Component footprint (flash = .text + .data, RAM = .data + .bss):")
+        print(f"  {'component':<{name_width}} {'flash':>8} {'Δ':>7} "
+              f"{'.data':>7} {'.bss':>7} {'ΔRAM':>7}")
+        totals = {"flash": 0, "data": 0, "bss": 0}
+        for name, sizes in current.items():
+            ram_delta = ""
+            if name in previous:
+                diff = (sizes["data"] + sizes["bss"]) \
+                    - (previous[name].get("data", 0) + previous[name].get("bss", 0))
+                ram_delta = f"{diff:+d}" if diff else ""
+            print(f"  {name:<{name_width}} {sizes['flash']:>8} {delta(name, 'flash'):>7} "
+                  f"{sizes['data']:>7} {sizes['bss']:>7} {ram_delta:>7}")
+            for field in totals:
+                totals[field] += sizes[field]
+        print(f"  {'total':<{name_width}} {totals['flash']:>8} {'':>7} "
+              f"{totals['data']:>7} {totals['bss']:>7}")
+
+        tmp = snapshot_path + ".tmp"
+        with open(tmp, 'w') as f:
+            json.dump(current, f, indent=2)
+        os.replace(tmp, snapshot_path)
+
     def create_binaries(self, elf_path):
-        """Creates .hex and .bin files from the .elf file for programming."""
+        """
+        Creates .hex and .bin files from the .elf file for programming.
+        With OVERLAYS configured, ovlpack.py first replaces the raw
+        overlay images at the tail of the .bin with the compressed store,
+        and the .hex is then derived from the packed .bin (not the .elf)
+        so both programming paths carry it.
+        """
         print("📦 Creating final binaries...")
         hex_path = elf_path.replace(".elf", ".hex")
         bin_path = elf_path.replace(".elf", ".bin")
-        self.run_command([self.cp, "-O", "ihex", elf_path, hex_path])
         self.run_command([self.cp, "-O", "binary", "-S", elf_path, bin_path])
+        if self.overlays:
+            print("🗜️  Packing code overlays...")
+            self.run_command([sys.executable, os.path.join("bldmgr", "ovlpack.py"),
+                              elf_path, bin_path,
+                              "--objcopy", self.cp, "--nm", self.nm,
+                              "--overlays"] + self.overlays)
+            # 0x08000000 is ORIGIN(flash) in the linker script.
+            self.run_command([self.cp, "-I", "binary", "-O", "ihex",
+                              "--change-addresses", "0x08000000",
+                              bin_path, hex_path])
+        else:
+            self.run_command([self.cp, "-O", "ihex", elf_path, hex_path])
         print(f"Successfully created binaries in {self.build_dir}/")
 
     def build_all(self):
-        """Runs the entire build process: compile (incrementally), link, and create binaries."""
-        objects = self.compile_sources()
-        elf_file = self.link_objects(objects)
+        """Runs the entire build process: generate, compile (incrementally), archive, link, and create binaries."""
+        self.generate_buildinfo()
+        self.generate_protocol()
+        self.generate_fonts()
+        self.generate_function_order()
+        self.generate_overlay_fragment()
+        self.compile_sources()
+        archives = self.archive_components()
+        elf_file = self.link_objects(archives)
         self.create_binaries(elf_file)
         print("\n✅ Build complete.")
 
+    def link_audit(self):
+        """
+        Builds the project, then runs bldmgr/linkaudit.py over the link
+        map and component archives: per-component kept/discarded byte
+        totals, members --gc-sections emptied out entirely (candidates
+        to drop from the component tables), symbols defined by more
+        than one component, and a full symbol-to-component map written
+        into the build directory.
+        """
+        self.build_all()
+        map_path = os.path.join(self.build_dir, f"{self.config.TARGET_NAME}.map")
+        archives = [os.path.join(self.build_dir, f"{name}.a")
+                    for name in self.component_sources]
+        print("🔎 Auditing the linked image...")
+        self.run_command([sys.executable, os.path.join("bldmgr", "linkaudit.py"),
+                          map_path, "--nm", self.nm, "--archives"] + archives)
+
+    def host_bench(self):
+        """
+        Builds and runs the host benchmark harness (HOST_BENCH in the
+        project config): device-logic modules compiled with the native
+        g++/gcc against the stub headers in tools/hostbench/stubs, so
+        decoder throughput and ring behavior can be measured per commit
+        without flashing a board.
+        """
+        spec = getattr(self.config, "HOST_BENCH", None)
+        if not spec:
+            print("❌ Error: This project defines no HOST_BENCH configuration.", file=sys.stderr)
+            sys.exit(1)
+
+        bench_dir = os.path.join(self.build_dir, "hostbench")
+        os.makedirs(bench_dir, exist_ok=True)
+        flags = ["-O2", "-g", "-Wall", "-Wextra"] \
+            + spec.get("include_paths", []) + spec.get("defines", [])
+
+        # Generated fonts are plain C tables, so the bench consumes them
+        # like the firmware does; this keeps device modules that render
+        # text compilable here without a hand-maintained copy of the list.
+        sources = list(spec["sources"])
+        if self.protocol_def:
+            self.generate_protocol()
+            flags.append(f"-I{self.generated_dir}")
+        if self.font_specs:
+            self.generate_fonts()
+            sources.extend(self.component_sources["generated_fonts"])
+            if f"-I{self.generated_dir}" not in flags:
+                flags.append(f"-I{self.generated_dir}")
+
+        print("🧪 Building host benchmarks...")
+        objects = []
+        for src in sources:
+            obj = os.path.join(bench_dir, os.path.basename(src) + ".o")
+            objects.append(obj)
+            if (os.path.exists(obj)
+                    and os.path.getmtime(src) <= os.path.getmtime(obj)):
+                continue
+            if src.endswith(".c"):
+                cmd = ["gcc", self.config.C_STANDARD] + flags + ["-c", src, "-o", obj]
+            else:
+                cmd = ["g++", self.config.CPP_STANDARD] + flags + ["-c", src, "-o", obj]
+            self.run_command(cmd)
+
+        bench_bin = os.path.join(bench_dir, "bench")
+        self.run_command(["g++"] + objects + ["-o", bench_bin])
+        print("🏃 Running benchmarks...")
+        self.run_command([os.path.abspath(bench_bin)])
+
     def program_dfu(self):
         """Builds and programs the target using dfu-util."""
         self.build_all()
@@ -0,0 +1,503 @@
+#!/usr/bin/env python3
+"""
+Compiles TrueType glyphs into packed 1-bpp bitmap C arrays for the firmware.
+
+Usage:
+    python bldmgr/fontgen.py <font.ttf> --size N --name ident --out-dir DIR
+                             [--chars FIRST..LAST] [--rle]
+
+Emits DIR/font_<ident>.c and DIR/font_<ident>.h containing an
+'lcd_font_prop' table (see lib/lcd_font/include/lcd_font.h): per-glyph
+bitmaps packed MSB-first, one bit per pixel, plus advance widths, bearing
+offsets and a kerning pair table. With --rle the bitmap pool is PackBits
+compressed (worthwhile for sizes above ~20 px where blank runs dominate).
+
+The parser is deliberately stdlib-only so the build has no host-side
+package dependencies: it reads cmap (format 4), glyf (simple and
+composite outlines), loca, hmtx and the legacy 'kern' table. Fonts that
+carry kerning only in GPOS come out with an empty kerning table, which
+is merely a spacing regression, not an error. Outlines are rasterized at
+pixel centers with the nonzero winding rule, matching what FreeType
+produces in monochrome mode closely enough for UI text.
+"""
+
+import math
+import os
+import struct
+import sys
+
+
+# ----------------------------------------------------------------------
+# TrueType parsing
+# ----------------------------------------------------------------------
+
+class TrueTypeFont:
+    """Minimal reader for the tables needed to rasterize ASCII glyphs."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        (_, num_tables) = struct.unpack_from('>IH', self.data, 0)
+        self.tables = {}
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack_from('>4sIII', self.data, 12 + 16 * i)
+            self.tables[tag.decode('latin-1')] = (offset, length)
+
+        head = self.tables['head'][0]
+        self.units_per_em = struct.unpack_from('>H', self.data, head + 18)[0]
+        self.index_to_loc_format = struct.unpack_from('>h', self.data, head + 50)[0]
+
+        hhea = self.tables['hhea'][0]
+        self.ascent, self.descent, self.line_gap = struct.unpack_from('>hhh', self.data, hhea + 4)
+        self.num_hmetrics = struct.unpack_from('>H', self.data, hhea + 34)[0]
+
+        maxp = self.tables['maxp'][0]
+        self.num_glyphs = struct.unpack_from('>H', self.data, maxp + 4)[0]
+
+        self._read_cmap()
+        self._read_loca()
+
+    def _read_cmap(self):
+        base, _ = self.tables['cmap']
+        num_subtables = struct.unpack_from('>H', self.data, base + 2)[0]
+        subtable = None
+        for i in range(num_subtables):
+            platform, encoding, offset = struct.unpack_from('>HHI', self.data, base + 4 + 8 * i)
+            if (platform, encoding) in ((3, 1), (0, 3), (0, 2), (0, 1)):
+                subtable = base + offset
+        if subtable is None or struct.unpack_from('>H', self.data, subtable)[0] != 4:
+            raise ValueError("no format-4 cmap subtable found")
+
+        seg_count = struct.unpack_from('>H', self.data, subtable + 6)[0] // 2
+        ends = struct.unpack_from(f'>{seg_count}H', self.data, subtable + 14)
+        starts_at = subtable + 16 + 2 * seg_count
+        starts = struct.unpack_from(f'>{seg_count}H', self.data, starts_at)
+        deltas = struct.unpack_from(f'>{seg_count}h', self.data, starts_at + 2 * seg_count)
+        range_offsets_at = starts_at + 4 * seg_count
+        range_offsets = struct.unpack_from(f'>{seg_count}H', self.data, range_offsets_at)
+        self._cmap = (ends, starts, deltas, range_offsets, range_offsets_at)
+
+    def glyph_id(self, char_code):
+        ends, starts, deltas, range_offsets, range_offsets_at = self._cmap
+        for seg, end in enumerate(ends):
+            if char_code <= end:
+                if char_code < starts[seg]:
+                    return 0
+                if range_offsets[seg] == 0:
+                    return (char_code + deltas[seg]) & 0xFFFF
+                at = (range_offsets_at + 2 * seg + range_offsets[seg]
+                      + 2 * (char_code - starts[seg]))
+                gid = struct.unpack_from('>H', self.data, at)[0]
+                return (gid + deltas[seg]) & 0xFFFF if gid else 0
+        return 0
+
+    def _read_loca(self):
+        base, _ = self.tables['loca']
+        n = self.num_glyphs + 1
+        if self.index_to_loc_format == 0:
+            raw = struct.unpack_from(f'>{n}H', self.data, base)
+            self.loca = [v * 2 for v in raw]
+        else:
+            self.loca = list(struct.unpack_from(f'>{n}I', self.data, base))
+
+    def advance(self, gid):
+        base, _ = self.tables['hmtx']
+        index = min(gid, self.num_hmetrics - 1)
+        return struct.unpack_from('>H', self.data, base + 4 * index)[0]
+
+    def contours(self, gid, depth=0):
+        """
+        Returns the glyph outline as a list of closed contours, each a list
+        of (x, y, on_curve) points in font units. Composites are resolved
+        recursively (offset and plain scale only; the exotic transform
+        forms do not occur in the fonts we ship).
+        """
+        start, end = self.loca[gid], self.loca[gid + 1]
+        if start == end or depth > 4:
+            return []
+        base = self.tables['glyf'][0] + start
+        num_contours = struct.unpack_from('>h', self.data, base)[0]
+        if num_contours >= 0:
+            return self._simple_contours(base, num_contours)
+
+        # Composite glyph: a list of transformed component glyphs.
+        contours = []
+        at = base + 10
+        while True:
+            flags, component_gid = struct.unpack_from('>HH', self.data, at)
+            at += 4
+            if flags & 0x0001:  # ARG_1_AND_2_ARE_WORDS
+                dx, dy = struct.unpack_from('>hh', self.data, at)
+                at += 4
+            else:
+                dx, dy = struct.unpack_from('>bb', self.data, at)
+                at += 2
+            scale = 1.0
+            if flags & 0x0008:  # WE_HAVE_A_SCALE (F2Dot14)
+                scale = struct.unpack_from('>h', self.data, at)[0] / 16384.0
+                at += 2
+            elif flags & 0x0040:  # WE_HAVE_AN_X_AND_Y_SCALE
+                at += 4
+            elif flags & 0x0080:  # WE_HAVE_A_TWO_BY_TWO
+                at += 8
+            for contour in self.contours(component_gid, depth + 1):
+                contours.append([(x * scale + dx, y * scale + dy, on)
+                                 for (x, y, on) in contour])
+            if not flags & 0x0020:  # MORE_COMPONENTS
+                break
+        return contours
+
+    def _simple_contours(self, base, num_contours):
+        end_pts = struct.unpack_from(f'>{num_contours}H', self.data, base + 10)
+        num_points = end_pts[-1] + 1
+        at = base + 10 + 2 * num_contours
+        instruction_length = struct.unpack_from('>H', self.data, at)[0]
+        at += 2 + instruction_length
+
+        flags = []
+        while len(flags) < num_points:
+            flag = self.data[at]
+            at += 1
+            flags.append(flag)
+            if flag & 0x08:  # REPEAT
+                count = self.data[at]
+                at += 1
+                flags.extend([flag] * count)
+
+        xs, x = [], 0
+        for flag in flags:
+            if flag & 0x02:  # X_SHORT
+                dx = self.data[at]
+                at += 1
+                x += dx if flag & 0x10 else -dx
+            elif not flag & 0x10:
+                x += struct.unpack_from('>h', self.data, at)[0]
+                at += 2
+            xs.append(x)
+        ys, y = [], 0
+        for flag in flags:
+            if flag & 0x04:  # Y_SHORT
+                dy = self.data[at]
+                at += 1
+                y += dy if flag & 0x20 else -dy
+            elif not flag & 0x20:
+                y += struct.unpack_from('>h', self.data, at)[0]
+                at += 2
+            ys.append(y)
+
+        contours, first = [], 0
+        for end in end_pts:
+            contour = [(xs[i], ys[i], bool(flags[i] & 0x01))
+                       for i in range(first, end + 1)]
+            contours.append(contour)
+            first = end + 1
+        return contours
+
+    def kern_pairs(self):
+        """Legacy 'kern' table (format 0, horizontal) as {(lgid, rgid): units}."""
+        if 'kern' not in self.tables:
+            return {}
+        base, _ = self.tables['kern']
+        num_subtables = struct.unpack_from('>H', self.data, base + 2)[0]
+        at = base + 4
+        pairs = {}
+        for _ in range(num_subtables):
+            _, length, coverage = struct.unpack_from('>HHH', self.data, at)
+            if (coverage >> 8) == 0 and coverage & 0x01:
+                num_pairs = struct.unpack_from('>H', self.data, at + 6)[0]
+                pair_at = at + 14
+                for _ in range(num_pairs):
+                    left, right, value = struct.unpack_from('>HHh', self.data, pair_at)
+                    pairs[(left, right)] = value
+                    pair_at += 6
+            at += length
+        return pairs
+
+
+# ----------------------------------------------------------------------
+# Rasterization
+# ----------------------------------------------------------------------
+
+def _flatten(contour, steps=8):
+    """
+    Expands a TrueType contour (on/off-curve points, quadratic beziers)
+    into a closed polyline. Consecutive off-curve points imply an
+    on-curve midpoint between them.
+    """
+    # Normalize to an alternating on/off sequence starting on-curve.
+    points = list(contour)
+    if not any(p[2] for p in points):
+        # All off-curve: start at an implied midpoint.
+        x0, y0, _ = points[0]
+        x1, y1, _ = points[-1]
+        points.insert(0, ((x0 + x1) / 2.0, (y0 + y1) / 2.0, True))
+    while not points[0][2]:
+        points.append(points.pop(0))
+
+    expanded = []
+    i = 0
+    n = len(points)
+    while i < n:
+        current = points[i]
+        expanded.append(current)
+        nxt = points[(i + 1) % n]
+        if not nxt[2]:
+            after = points[(i + 2) % n]
+            if not after[2]:
+                after = ((nxt[0] + after[0]) / 2.0, (nxt[1] + after[1]) / 2.0, True)
+                points.insert((i + 2) % n, after)
+                n += 1
+            expanded.append(nxt)
+        i += 1
+
+    polyline = []
+    n = len(expanded)
+    i = 0
+    while i < n:
+        x0, y0, _ = expanded[i]
+        polyline.append((x0, y0))
+        nxt = expanded[(i + 1) % n]
+        if nxt[2]:
+            i += 1
+            continue
+        cx, cy, _ = nxt
+        x2, y2, _ = expanded[(i + 2) % n]
+        for step in range(1, steps):
+            t = step / steps
+            mt = 1.0 - t
+            polyline.append((mt * mt * x0 + 2 * mt * t * cx + t * t * x2,
+                             mt * mt * y0 + 2 * mt * t * cy + t * t * y2))
+        i += 2
+    return polyline
+
+
+def rasterize(contours, scale):
+    """
+    Fills the outline with the nonzero winding rule, sampling at pixel
+    centers. Returns (x_offset, y_top, width, height, rows) where rows is
+    a list of per-row lists of set column indices, y_top in pixel space
+    with y growing downward (0 at the font-unit origin).
+    """
+    segments = []
+    for contour in contours:
+        poly = [(x * scale, -y * scale) for (x, y) in _flatten(contour)]
+        for i in range(len(poly)):
+            a, b = poly[i], poly[(i + 1) % len(poly)]
+            if a[1] != b[1]:
+                segments.append((a, b))
+    if not segments:
+        return (0, 0, 0, 0, [])
+
+    xs = [p[0] for seg in segments for p in seg]
+    ys = [p[1] for seg in segments for p in seg]
+    x0, y0 = math.floor(min(xs)), math.floor(min(ys))
+    width = max(1, math.ceil(max(xs)) - x0)
+    height = max(1, math.ceil(max(ys)) - y0)
+
+    rows = []
+    for j in range(height):
+        yc = y0 + j + 0.5
+        crossings = []
+        for (ax, ay), (bx, by) in segments:
+            if ay <= yc < by:
+                crossings.append((ax + (yc - ay) * (bx - ax) / (by - ay), 1))
+            elif by <= yc < ay:
+                crossings.append((ax + (yc - ay) * (bx - ax) / (by - ay), -1))
+        crossings.sort()
+        cols, winding, span_start = [], 0, 0.0
+        for x, direction in crossings:
+            if winding == 0:
+                span_start = x
+            winding += direction
+            if winding == 0:
+                first = max(0, math.ceil(span_start - 0.5 - x0))
+                last = min(width - 1, math.floor(x - 0.5 - x0))
+                cols.extend(range(first, last + 1))
+        rows.append(sorted(set(cols)))
+    return (x0, y0, width, height, rows)
+
+
+# ----------------------------------------------------------------------
+# Packing and C emission
+# ----------------------------------------------------------------------
+
+def pack_rows(width, rows):
+    """Packs set-column lists into MSB-first 1-bpp row bytes."""
+    bytes_per_row = (width + 7) // 8
+    out = bytearray()
+    for cols in rows:
+        row = bytearray(bytes_per_row)
+        for col in cols:
+            row[col >> 3] |= 0x80 >> (col & 7)
+        out.extend(row)
+    return bytes(out)
+
+
+def packbits(data):
+    """PackBits RLE: control 0..127 = N+1 literals, 129..255 = repeat 257-N."""
+    out = bytearray()
+    i, n = 0, len(data)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+        literal_start = i
+        while i < n and i - literal_start < 128:
+            run = 1
+            while i + run < n and run < 3 and data[i + run] == data[i]:
+                run += 1
+            if run >= 3:
+                break
+            i += 1
+        out.append(i - literal_start - 1)
+        out.extend(data[literal_start:i])
+    return bytes(out)
+
+
+def c_bytes(data, indent="    "):
+    lines = []
+    for i in range(0, len(data), 12):
+        chunk = ", ".join(f"0x{b:02X}" for b in data[i:i + 12])
+        lines.append(f"{indent}{chunk},")
+    return "\n".join(lines)
+
+
+def generate(ttf_path, name, size, first, last, rle, out_dir):
+    font = TrueTypeFont(ttf_path)
+    scale = size / font.units_per_em
+    ascent_px = round(font.ascent * scale)
+    line_height = round((font.ascent - font.descent + font.line_gap) * scale)
+
+    glyphs, pool = [], bytearray()
+    gids = {}
+    for code in range(first, last + 1):
+        gid = font.glyph_id(code)
+        gids[code] = gid
+        x0, y0, width, height, rows = rasterize(font.contours(gid), scale)
+        bitmap = pack_rows(width, rows)
+        if rle and len(bitmap) > 192:  # LCD_GLYPH_MAX_BYTES, the renderer's decode buffer
+            raise ValueError(f"glyph {code} needs {len(bitmap)} bytes decoded; "
+                             "too large for the RLE decode buffer")
+        offset = len(pool)
+        if rle:
+            bitmap = packbits(bitmap)
+        pool.extend(bitmap)
+        glyphs.append({
+            "code": code, "width": width, "height": height,
+            "advance": max(1, round(font.advance(gid) * scale)),
+            "x_off": x0, "y_off": ascent_px + y0 if height else 0,
+            "offset": offset,
+        })
+    if len(pool) > 0xFFFF:
+        raise ValueError("bitmap pool exceeds 16-bit offsets; reduce size or range")
+
+    kern = []
+    gid_to_code = {}
+    for code, gid in gids.items():
+        if gid:
+            gid_to_code.setdefault(gid, code)
+    for (lgid, rgid), units in sorted(font.kern_pairs().items()):
+        if lgid in gid_to_code and rgid in gid_to_code:
+            adjust = round(units * scale)
+            if adjust:
+                kern.append((gid_to_code[lgid], gid_to_code[rgid], adjust))
+    kern.sort()
+
+    guard = f"FONT_{name.upper()}_H"
+    basename = f"font_{name}"
+    source = os.path.basename(ttf_path)
+    os.makedirs(out_dir, exist_ok=True)
+
+    with open(os.path.join(out_dir, basename + ".h"), 'w') as f:
+        f.write(f"""/* Generated by bldmgr/fontgen.py from {source} at {size} px.
+ * Do not edit; regenerate via the build. */
+
+#ifndef {guard}
+#define {guard}
+
+#include "lcd_font.h"
+
+extern const lcd_font_prop font_{name};
+
+#endif /* {guard} */
+""")
+
+    glyph_rows = "\n".join(
+        f"    {{ {g['width']:3}, {g['height']:3}, {g['advance']:3}, "
+        f"{g['x_off']:3}, {g['y_off']:3}, {g['offset']:5} }}, /* '{chr(g['code']) if 32 <= g['code'] < 127 else '?'}' */"
+        for g in glyphs)
+    kern_rows = "\n".join(
+        f"    {{ 0x{l:02X}, 0x{r:02X}, {a:3} }},"
+        for (l, r, a) in kern) or "    { 0, 0, 0 }, /* no legacy kern table in the source font */"
+    flags = "LCD_FONT_PROP_RLE" if rle else "0"
+
+    with open(os.path.join(out_dir, basename + ".c"), 'w') as f:
+        f.write(f"""/* Generated by bldmgr/fontgen.py from {source} at {size} px.
+ * Do not edit; regenerate via the build. */
+
+#include "{basename}.h"
+
+static const uint8_t font_{name}_bitmaps[] = {{
+{c_bytes(pool)}
+}};
+
+static const lcd_glyph font_{name}_glyphs[] = {{
+{glyph_rows}
+}};
+
+static const lcd_kern_pair font_{name}_kerning[] = {{
+{kern_rows}
+}};
+
+const lcd_font_prop font_{name} = {{
+    .first_char = {first},
+    .last_char = {last},
+    .line_height = {line_height},
+    .baseline = {ascent_px},
+    .flags = {flags},
+    .kerning_count = {len(kern)},
+    .glyphs = font_{name}_glyphs,
+    .bitmaps = font_{name}_bitmaps,
+    .kerning = font_{name}_kerning,
+}};
+""")
+    return len(pool), len(kern)
+
+
+def main():
+    args = sys.argv[1:]
+    options = {"size": None, "name": None, "out-dir": None,
+               "chars": "32..126", "rle": False}
+    ttf_path = None
+    i = 0
+    while i < len(args):
+        arg = args[i]
+        if arg == "--rle":
+            options["rle"] = True
+        elif arg.startswith("--"):
+            options[arg[2:]] = args[i + 1]
+            i += 1
+        else:
+            ttf_path = arg
+        i += 1
+
+    if not (ttf_path and options["size"] and options["name"] and options["out-dir"]):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    first, last = (int(v) for v in options["chars"].split(".."))
+    pool_bytes, kern_count = generate(
+        ttf_path, options["name"], int(options["size"]),
+        first, last, options["rle"], options["out-dir"])
+    print(f"  - font_{options['name']}: {last - first + 1} glyphs, "
+          f"{pool_bytes} bitmap bytes"
+          f"{' (RLE)' if options['rle'] else ''}, {kern_count} kern pairs")
+
+
+if __name__ == "__main__":
+    main()
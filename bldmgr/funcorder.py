@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Generates linker ordering fragments from a function hit-count profile.
+
+Usage:
+    python bldmgr/funcorder.py <profile.txt> --out-dir DIR [--ramtext-top N]
+
+The profile is what the firmware's hit-count export prints over UART:
+one '<hits> <symbol>' pair per line ('#' starts a comment), symbols as
+they appear in the image (C++ names mangled). The tool writes two
+fragments that the linker script pulls in with INCLUDE:
+
+    hot_ramtext.ld  input-section entries for the --ramtext-top N
+                    hottest functions, placed in the .ramtext copy
+                    region and so executed from zero-wait-state SRAM
+    hot_text.ld     entries for every other profiled function, hottest
+                    first, placed at the very start of flash .text
+
+Since every function is compiled with -ffunction-sections, naming
+.text.<symbol> input sections pins their order; anything unprofiled
+(cold vendor code) falls through to the *(.text*) catch-all behind them,
+which is exactly the cold-last layout the flash prefetcher wants. The
+build writes empty fragments when no profile is configured, so the
+linker script works unchanged either way.
+"""
+
+import os
+import sys
+
+
+def parse_profile(path):
+    """Returns [(hits, symbol)] sorted hottest-first, stable on ties."""
+    entries = []
+    with open(path, 'r') as f:
+        for line_number, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 2 or not fields[0].isdigit():
+                print(f"⚠️  {path}:{line_number}: expected '<hits> <symbol>', "
+                      f"skipping: {line}", file=sys.stderr)
+                continue
+            entries.append((int(fields[0]), fields[1]))
+    entries.sort(key=lambda e: -e[0])
+    return entries
+
+
+def write_fragment(path, symbols, banner):
+    with open(path, 'w') as f:
+        f.write(f"/* {banner}\n   Generated by bldmgr/funcorder.py; do not edit. */\n")
+        for symbol in symbols:
+            f.write(f"*(.text.{symbol})\n")
+
+
+def main():
+    args = sys.argv[1:]
+    profile_path = None
+    out_dir = None
+    ramtext_top = 0
+    i = 0
+    while i < len(args):
+        if args[i] == "--out-dir":
+            out_dir = args[i + 1]
+            i += 1
+        elif args[i] == "--ramtext-top":
+            ramtext_top = int(args[i + 1])
+            i += 1
+        else:
+            profile_path = args[i]
+        i += 1
+
+    if not (profile_path and out_dir):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    entries = parse_profile(profile_path)
+    symbols = [symbol for hits, symbol in entries if hits > 0]
+    ram_symbols = symbols[:ramtext_top]
+    flash_symbols = symbols[ramtext_top:]
+
+    source = os.path.basename(profile_path)
+    write_fragment(os.path.join(out_dir, "hot_ramtext.ld"), ram_symbols,
+                   f"Hottest {len(ram_symbols)} functions from {source}, promoted to SRAM.")
+    write_fragment(os.path.join(out_dir, "hot_text.ld"), flash_symbols,
+                   f"Remaining {len(flash_symbols)} profiled functions from {source}, "
+                   "hottest first in flash.")
+    print(f"  - function order: {len(ram_symbols)} in .ramtext, "
+          f"{len(flash_symbols)} ordered in .text")
+
+
+if __name__ == "__main__":
+    main()
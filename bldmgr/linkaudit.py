@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Audits a linked image for dead and duplicated code.
+
+Usage:
+    python bldmgr/linkaudit.py <firmware.map> --nm NM --archives A.a [B.a ...]
+
+Reads the GNU ld map the link already writes (-Wl,-Map) and attributes
+every input section to its component archive, splitting kept bytes from
+what --gc-sections discarded. With -ffunction-sections each section is
+one symbol, so this is the full symbol-to-component map; it is written
+next to the map file as linkaudit_symbols.txt.
+
+On top of the raw map the audit flags what gc-sections cannot tell you:
+
+    dead members     object files whose every section was discarded.
+                     The linker drops the code, but the member still
+                     costs compile time, archive/link time and budget-
+                     table noise on every build — remove the source
+                     from its component table instead.
+    duplicate defs   global symbols defined by more than one component
+                     (per nm over the archives). Strong duplicates are
+                     a multiple-definition error waiting to happen
+                     under --whole-archive; weak ones (inline/template
+                     instantiations) are compiled once per includer and
+                     merely discarded again at link, so heavy ones are
+                     candidates for a single out-of-line definition.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+# ' .text.foo  0x08000100  0x84 build/.../app.a(main.cpp.o)' — the name
+# moves to its own line when longer than the column, handled via 'pending'.
+ENTRY_RE = re.compile(
+    r'^ +(?:(\S+) +)?(0x[0-9a-fA-F]+) +(0x[0-9a-fA-F]+) +(\S+)$')
+NAME_RE = re.compile(r'^ ((?:\.|COMMON)\S*)$')
+
+
+def split_origin(path):
+    """'build/.../app.a(main.cpp.o)' -> ('app', 'main.cpp.o')."""
+    m = re.match(r'(.*)\((.*)\)$', path)
+    if m:
+        archive, member = m.groups()
+        component = os.path.basename(archive)
+        if component.endswith('.a'):
+            component = component[:-len('.a')]
+        return component, member
+    # Bare objects do not occur with archived components, but keep the
+    # audit usable on hand-linked images.
+    return os.path.basename(path), os.path.basename(path)
+
+
+def parse_map(path):
+    """
+    Returns (kept, discarded) where kept maps (component, member) to a
+    list of (section, size) and discarded maps the same key to a byte
+    total. Zero-size and *fill* entries are skipped.
+    """
+    kept = {}
+    discarded = {}
+    state = None
+    pending = None
+    with open(path, 'r') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if line.startswith('Discarded input sections'):
+                state = 'discarded'
+                continue
+            if line.startswith('Memory Configuration'):
+                state = None
+                continue
+            if line.startswith('Linker script and memory map'):
+                state = 'kept'
+                continue
+            if state is None or not line.startswith(' '):
+                pending = None
+                continue
+            m = NAME_RE.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = ENTRY_RE.match(line)
+            if not m:
+                pending = None
+                continue
+            section = m.group(1) or pending
+            pending = None
+            size = int(m.group(3), 16)
+            origin = m.group(4)
+            if not section or size == 0:
+                continue
+            if not (origin.endswith('.o') or origin.endswith('.o)')):
+                continue
+            key = split_origin(origin)
+            if state == 'kept':
+                kept.setdefault(key, []).append((section, size))
+            else:
+                discarded[key] = discarded.get(key, 0) + size
+    return kept, discarded
+
+
+def collect_definitions(nm, archives):
+    """
+    Maps every defined global symbol to {component: (size, linkage)} via
+    nm -S over the archives. Strong definitions are T/D/R/B; weak ones
+    (W/V) are the once-per-includer inline/template copies.
+    """
+    definitions = {}
+    for archive in archives:
+        component = os.path.basename(archive)
+        if component.endswith('.a'):
+            component = component[:-len('.a')]
+        result = subprocess.run([nm, '-S', archive],
+                                capture_output=True, text=True)
+        if result.returncode != 0:
+            print(f"⚠️  nm failed on {archive}, skipping it in the "
+                  "duplicate scan.", file=sys.stderr)
+            continue
+        for line in result.stdout.splitlines():
+            fields = line.split()
+            if len(fields) != 4 or fields[2] not in 'TDRBWV':
+                continue
+            linkage = 'strong' if fields[2] in 'TDRB' else 'weak'
+            size = int(fields[1], 16)
+            per_component = definitions.setdefault(fields[3], {})
+            previous = per_component.get(component, (0, linkage))
+            per_component[component] = (max(previous[0], size), linkage)
+    return definitions
+
+
+def write_symbol_map(path, kept):
+    """One line per kept input section: size, component, member, section."""
+    rows = []
+    for (component, member), sections in kept.items():
+        for section, size in sections:
+            rows.append((component, -size, member, section))
+    rows.sort()
+    with open(path, 'w') as f:
+        f.write("# size component member section "
+                "(kept input sections, largest first per component)\n")
+        for component, neg_size, member, section in rows:
+            f.write(f"{-neg_size:8d} {component} {member} {section}\n")
+
+
+def main():
+    args = sys.argv[1:]
+    map_path = None
+    nm = None
+    archives = []
+    i = 0
+    while i < len(args):
+        if args[i] == "--nm":
+            nm = args[i + 1]
+            i += 1
+        elif args[i] == "--archives":
+            archives = args[i + 1:]
+            break
+        else:
+            map_path = args[i]
+        i += 1
+
+    if not (map_path and nm):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    if not os.path.exists(map_path):
+        print(f"❌ Error: map file '{map_path}' not found "
+              "(build the project first).", file=sys.stderr)
+        sys.exit(1)
+
+    kept, discarded = parse_map(map_path)
+    members = sorted(set(kept) | set(discarded))
+    if not members:
+        print("❌ Error: no input sections found in the map; was it "
+              "written by this link?", file=sys.stderr)
+        sys.exit(1)
+
+    # Per-component totals, and the members --gc-sections emptied out.
+    totals = {}
+    dead = []
+    for key in members:
+        component, member = key
+        kept_bytes = sum(size for _, size in kept.get(key, []))
+        dropped = discarded.get(key, 0)
+        row = totals.setdefault(component, [0, 0, 0])
+        row[0] += 1
+        row[1] += kept_bytes
+        row[2] += dropped
+        if kept_bytes == 0:
+            dead.append((component, member, dropped))
+
+    name_width = max(len("component"), max(len(n) for n in totals))
+    print("📊 Link input per component (kept vs --gc-sections discarded):")
+    print(f"  {'component':<{name_width}} {'members':>8} {'kept':>9} "
+          f"{'discarded':>10}")
+    for component in sorted(totals):
+        count, kept_bytes, dropped = totals[component]
+        print(f"  {component:<{name_width}} {count:>8} {kept_bytes:>9} "
+              f"{dropped:>10}")
+
+    if dead:
+        print("🪦 Members contributing nothing to the image:")
+        for component, member, dropped in sorted(dead, key=lambda d: -d[2]):
+            print(f"  - {component}({member}): {dropped} bytes compiled, "
+                  "all discarded")
+        print("  -> Remove these sources from their component tables "
+              "(gd32/components.py, lib/components.py) so no project "
+              "compiles or links them at all.")
+    else:
+        print("🪦 No fully-discarded members; every object contributes.")
+
+    if archives:
+        definitions = collect_definitions(nm, archives)
+        duplicates = [(symbol, per_component)
+                      for symbol, per_component in definitions.items()
+                      if len(per_component) > 1]
+        if duplicates:
+            print("💱 Symbols defined in more than one component:")
+            def weight(item):
+                return -max(size for size, _ in item[1].values())
+            for symbol, per_component in sorted(duplicates, key=weight):
+                size = max(size for size, _ in per_component.values())
+                linkage = next(iter(per_component.values()))[1]
+                where = ", ".join(sorted(per_component))
+                print(f"  - {symbol} ({linkage}, {size} bytes): {where}")
+            print("  -> Strong duplicates break the --whole-archive link; "
+                  "weak ones are inline/template copies worth a single "
+                  "out-of-line definition when large.")
+        else:
+            print("💱 No symbol is defined by more than one component.")
+
+    symbol_map = os.path.join(os.path.dirname(map_path),
+                              "linkaudit_symbols.txt")
+    write_symbol_map(symbol_map, kept)
+    print(f"📝 Full symbol-to-component map: {symbol_map}")
+
+
+if __name__ == "__main__":
+    main()
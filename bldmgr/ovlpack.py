@@ -0,0 +1,159 @@
+"""
+Packs code overlays into the flash image after the link.
+
+The generated overlay.ld fragment parks every overlay's raw bytes at the
+end of the flash image. This tool cuts that window out of the .bin and
+appends the packed store the runtime loader (lib/overlay/overlay.cpp)
+reads instead:
+
+    StoreHeader  { u32 magic "OVL1"; u8 count; u8 reserved[3]; }
+    StoreEntry[] { u32 offset; u16 csize; u16 usize; }   (one per overlay)
+    blobs        LZSS streams, or raw when compression would not help
+                 (signalled by csize == usize)
+
+Entry order follows the OVERLAYS list in the project config, which is
+also the order of the overlay sections and of the indices callers pass
+to ovl::load(). The .hex must be regenerated from the packed .bin
+afterwards (build_logic does this) so both programming paths carry the
+store.
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+# Must match lzss_expand() in lib/overlay/overlay.cpp.
+LZSS_WINDOW = 4096
+LZSS_MIN_MATCH = 3
+LZSS_MAX_MATCH = 18
+
+
+def lzss_compress(data):
+    """Greedy LZSS: control bytes of eight LSB-first flags, literals, and
+    2-byte references [dist_lo, dist_hi:4|len-3:4]."""
+    items = []  # (flag_bit, bytes)
+    index = {}  # 3-byte prefix -> ascending positions
+    i, n = 0, len(data)
+    while i < n:
+        best_len = 0
+        best_dist = 0
+        key = bytes(data[i:i + LZSS_MIN_MATCH])
+        if len(key) == LZSS_MIN_MATCH:
+            for pos in reversed(index.get(key, [])):
+                dist = i - pos
+                if dist > LZSS_WINDOW:
+                    break
+                length = LZSS_MIN_MATCH
+                while (length < LZSS_MAX_MATCH and i + length < n
+                       and data[pos + length] == data[i + length]):
+                    length += 1
+                if length > best_len:
+                    best_len, best_dist = length, dist
+                    if length == LZSS_MAX_MATCH:
+                        break
+        if best_len >= LZSS_MIN_MATCH:
+            items.append((0, bytes([best_dist - 1 & 0xFF,
+                                    ((best_dist - 1) >> 8 << 4)
+                                    | (best_len - LZSS_MIN_MATCH)])))
+            step = best_len
+        else:
+            items.append((1, bytes(data[i:i + 1])))
+            step = 1
+        for j in range(i, i + step):
+            prefix = bytes(data[j:j + LZSS_MIN_MATCH])
+            if len(prefix) == LZSS_MIN_MATCH:
+                index.setdefault(prefix, []).append(j)
+        i += step
+
+    out = bytearray()
+    for base in range(0, len(items), 8):
+        group = items[base:base + 8]
+        out.append(sum(bit << k for k, (bit, _) in enumerate(group)))
+        for _, payload in group:
+            out += payload
+    return bytes(out)
+
+
+def read_symbol(nm, elf, name):
+    result = subprocess.run([nm, elf], capture_output=True, text=True)
+    if result.returncode != 0:
+        print(result.stderr, file=sys.stderr)
+        sys.exit(1)
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if len(fields) >= 3 and fields[2] == name:
+            return int(fields[0], 16)
+    print(f"error: symbol '{name}' not found in {elf} "
+          "(is the overlay.ld fragment in the link?)", file=sys.stderr)
+    sys.exit(1)
+
+
+def section_bytes(objcopy, elf, section):
+    with tempfile.NamedTemporaryFile(delete=False) as tmp:
+        tmp_path = tmp.name
+    try:
+        result = subprocess.run(
+            [objcopy, "-O", "binary", f"--only-section={section}", elf, tmp_path],
+            capture_output=True, text=True)
+        if result.returncode != 0:
+            print(result.stderr, file=sys.stderr)
+            sys.exit(1)
+        with open(tmp_path, "rb") as f:
+            return f.read()
+    finally:
+        os.unlink(tmp_path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("elf")
+    parser.add_argument("bin")
+    parser.add_argument("--overlays", nargs="+", required=True,
+                        help="overlay names, in OVERLAYS (index) order")
+    parser.add_argument("--objcopy", required=True)
+    parser.add_argument("--nm", required=True)
+    parser.add_argument("--flash-origin", type=lambda v: int(v, 0),
+                        default=0x08000000,
+                        help="ORIGIN(flash) from the linker script")
+    args = parser.parse_args()
+
+    store_lma = read_symbol(args.nm, args.elf, "_ovl_lma")
+    store_off = store_lma - args.flash_origin
+
+    blobs = []
+    raw_total = 0
+    for name in args.overlays:
+        raw = section_bytes(args.objcopy, args.elf, f".ovl.{name}")
+        packed = lzss_compress(raw)
+        if len(packed) >= len(raw):
+            packed = raw  # incompressible; csize == usize marks it raw
+        blobs.append((name, raw, packed))
+        raw_total += len(raw)
+        print(f"  - {name}: {len(raw)} -> {len(packed)} bytes")
+
+    header = struct.pack("<I B 3x", 0x314C564F, len(blobs))  # "OVL1"
+    directory = bytearray()
+    payload = bytearray()
+    offset = len(header) + 8 * len(blobs)
+    for name, raw, packed in blobs:
+        directory += struct.pack("<I H H", offset, len(packed), len(raw))
+        payload += packed
+        offset += len(packed)
+    store = header + bytes(directory) + bytes(payload)
+
+    with open(args.bin, "rb") as f:
+        image = f.read()
+    if len(image) < store_off:
+        image += b"\xFF" * (store_off - len(image))
+    with open(args.bin, "wb") as f:
+        f.write(image[:store_off] + store)
+
+    print(f"  - store: {len(store)} bytes packed "
+          f"({raw_total} raw, {raw_total - len(store):+d} flash)")
+
+
+if __name__ == "__main__":
+    main()
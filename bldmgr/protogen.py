@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""
+Compiles the declarative display-protocol description into the C++ and
+Python constant definitions both sides of the link consume.
+
+Usage:
+    python bldmgr/protogen.py <protocol.py> [--cpp-out FILE] [--py-out FILE]
+
+The description (see prj_usb_composite/protocol.py) lists every command
+id, report id, flag bit and shared size exactly once, with optional doc
+lines per entry. This script renders the firmware surface (enum class
+HostCommand plus constexpr namespaces inside namespace display) and the
+host surface (flat CMD_*/REPORT_*/... module constants, the names the
+tools have always used), so the two cannot drift: regeneration is wired
+into bldmgr/build_logic.py the same way the font bake is.
+
+Stdlib-only, like the rest of bldmgr.
+"""
+
+import argparse
+import importlib.util
+import os
+import sys
+
+
+def load_description(path):
+    spec = importlib.util.spec_from_file_location("protocol_description", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def split_entry(entry):
+    """Normalizes (name, value) / (name, value, doc) to a 3-tuple."""
+    if len(entry) == 2:
+        return entry[0], entry[1], []
+    return entry
+
+
+def pascal(name):
+    """SEQ_NACK -> SeqNack; the C++ side uses the repo's PascalCase
+    constexpr style, which also keeps the generated names clear of the
+    peripheral library's ALL_CAPS register macros (CRC, LCD_WIDTH, ...)."""
+    return "".join(part.capitalize() for part in name.split("_"))
+
+
+BANNER = (
+    "Generated by bldmgr/protogen.py from {src} - DO NOT EDIT.\n"
+    "Every id, flag bit and shared size of the host <-> device display\n"
+    "protocol is defined once in the description and rendered into both\n"
+    "this file and its counterpart on the other side of the link."
+)
+
+
+# ----------------------------------------------------------------------
+# C++ output
+# ----------------------------------------------------------------------
+
+def emit_cpp(proto, src_path):
+    out = []
+    for line in BANNER.format(src=src_path).splitlines():
+        out.append(f"// {line}")
+    out.append("")
+    out.append("#ifndef DISPLAY_PROTOCOL_H")
+    out.append("#define DISPLAY_PROTOCOL_H")
+    out.append("")
+    out.append("#include <cstdint>")
+    out.append("")
+    out.append("namespace display {")
+    out.append("")
+
+    def doc(lines, indent=""):
+        for line in lines:
+            out.append(f"{indent}// {line}")
+
+    out.append("// Host -> device commands (first byte of a bulk OUT packet).")
+    out.append("enum class HostCommand : uint8_t {")
+    for name, value, d in map(split_entry, proto.COMMANDS):
+        doc(d, "    ")
+        out.append(f"    {name} = 0x{value:02X},")
+    out.append("};")
+    out.append("")
+
+    out.append("// Device -> host status reports (first byte of a bulk IN packet).")
+    out.append("namespace report {")
+    for name, value, d in map(split_entry, proto.REPORTS):
+        doc(d)
+        out.append(f"constexpr uint8_t {pascal(name)} = 0x{value:02X};")
+    out.append("} // namespace report")
+    out.append("")
+
+    out.append("// GET_CAPS reply flag masks.")
+    out.append("namespace caps {")
+    out.append(f"constexpr uint8_t Version = {proto.CAPS_VERSION};")
+    for name, bit, d in map(split_entry, proto.CAPS_FLAGS):
+        doc(d)
+        out.append(f"constexpr uint8_t {pascal(name)} = 1u << {bit};")
+    out.append("} // namespace caps")
+    out.append("")
+
+    out.append("// DRAW_RECT header flag-byte masks.")
+    out.append("namespace rectflag {")
+    for name, bit, d in map(split_entry, proto.RECT_FLAGS):
+        doc(d)
+        out.append(f"constexpr uint8_t {pascal(name)} = 1u << {bit};")
+    out.append("} // namespace rectflag")
+    out.append("")
+
+    out.append("// DRAW_RECT payload encodings.")
+    out.append("namespace enc {")
+    for name, value, d in map(split_entry, proto.ENCODINGS):
+        doc(d)
+        out.append(f"constexpr uint8_t {pascal(name)} = 0x{value:02X};")
+    out.append("} // namespace enc")
+    out.append("")
+
+    out.append("// Shared wire geometry, pixel formats and the asset-store agreement.")
+    out.append("namespace wire {")
+    for name, value, d in map(split_entry, proto.WIRE):
+        doc(d)
+        out.append(f"constexpr uint16_t {pascal(name)} = {value};")
+    for name, value, d in map(split_entry, proto.PIXEL_FORMATS):
+        doc(d)
+        out.append(f"constexpr uint8_t PixelFormat{pascal(name)} = {value};")
+    out.append("// The format this firmware announces in the CAPS reply.")
+    out.append(f"constexpr uint8_t NativePixelFormat = "
+               f"PixelFormat{pascal(proto.NATIVE_PIXEL_FORMAT)};")
+    for name, value, d in map(split_entry, proto.ASSET_STATES):
+        doc(d)
+        out.append(f"constexpr uint8_t AssetState{pascal(name)} = {value};")
+    for name, value, d in map(split_entry, proto.FW_STATES):
+        doc(d)
+        out.append(f"constexpr uint8_t FwState{pascal(name)} = {value};")
+    for name, value, d in map(split_entry, proto.ASSETS):
+        doc(d)
+        out.append(f"constexpr uint16_t {pascal(name)} = {value};")
+    out.append("} // namespace wire")
+    out.append("")
+
+    out.append("// DRAW_TEXT font atlas ids.")
+    out.append("namespace font {")
+    for name, value, d in map(split_entry, proto.FONTS):
+        doc(d)
+        out.append(f"constexpr uint8_t Font{pascal(name)} = 0x{value:02X};")
+    out.append("} // namespace font")
+    out.append("")
+
+    out.append("// Transport-benchmark sub-ops (USB_BENCH_MODE=1; command id is")
+    out.append("// HostCommand::GET_TRACE, which bench builds repurpose).")
+    out.append("namespace bench {")
+    for name, value, d in map(split_entry, proto.BENCH_OPS):
+        doc(d)
+        out.append(f"constexpr uint8_t {pascal(name)} = 0x{value:02X};")
+    out.append("} // namespace bench")
+    out.append("")
+
+    out.append("} // namespace display")
+    out.append("")
+    out.append("#endif // DISPLAY_PROTOCOL_H")
+    return "\n".join(out) + "\n"
+
+
+# ----------------------------------------------------------------------
+# Python output
+# ----------------------------------------------------------------------
+
+def emit_py(proto, src_path):
+    out = ['"""']
+    out.extend(BANNER.format(src=src_path).splitlines())
+    out.append('"""')
+    out.append("")
+
+    def doc(lines):
+        for line in lines:
+            out.append(f"# {line}")
+
+    def group(comment, entries, prefix, hexfmt=True):
+        out.append(f"# {comment}")
+        for name, value, d in map(split_entry, entries):
+            doc(d)
+            rendered = f"0x{value:02X}" if hexfmt else str(value)
+            out.append(f"{prefix}{name} = {rendered}")
+        out.append("")
+
+    group("Shared wire geometry.", proto.WIRE, "", hexfmt=False)
+    group("Host -> device commands (first byte of a bulk OUT packet).",
+          proto.COMMANDS, "CMD_")
+    group("Device -> host status reports (first byte of a bulk IN packet).",
+          proto.REPORTS, "REPORT_")
+
+    out.append("# GET_CAPS reply flag masks.")
+    out.append(f"CAPS_VERSION = {proto.CAPS_VERSION}")
+    for name, bit, d in map(split_entry, proto.CAPS_FLAGS):
+        doc(d)
+        out.append(f"CAPS_{name} = 0x{1 << bit:02X}")
+    out.append("")
+
+    out.append("# DRAW_RECT header flag-byte masks.")
+    for name, bit, d in map(split_entry, proto.RECT_FLAGS):
+        doc(d)
+        out.append(f"RECT_FLAG_{name} = 0x{1 << bit:02X}")
+    out.append("")
+
+    group("DRAW_RECT payload encodings.", proto.ENCODINGS, "ENC_")
+    group("Native wire pixel formats announced in the CAPS reply.",
+          proto.PIXEL_FORMATS, "PIXEL_FORMAT_", hexfmt=False)
+    group("DRAW_TEXT font atlas ids.", proto.FONTS, "FONT_")
+    group("Flash asset-store upload states (REPORT_ASSETS).",
+          proto.ASSET_STATES, "ASSET_STATE_", hexfmt=False)
+    group("Delta firmware update states (REPORT_FW_INFO).",
+          proto.FW_STATES, "FW_STATE_", hexfmt=False)
+    group("Flash asset-store agreement.", proto.ASSETS, "", hexfmt=False)
+    out.append("# Transport-benchmark sub-ops (USB_BENCH_MODE=1 firmware only;")
+    out.append("# bench builds repurpose CMD_GET_TRACE's id as the command).")
+    out.append("CMD_BENCH = CMD_GET_TRACE")
+    for name, value, d in map(split_entry, proto.BENCH_OPS):
+        doc(d)
+        out.append(f"BENCH_{name} = 0x{value:02X}")
+    out.append("")
+
+    group("Derived packet-layout constants.", proto.HOST_DERIVED, "",
+          hexfmt=False)
+    return "\n".join(out).rstrip("\n") + "\n"
+
+
+def write_if_changed(path, content):
+    if os.path.exists(path):
+        with open(path, "r") as f:
+            if f.read() == content:
+                return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(content)
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("description", help="protocol description module")
+    parser.add_argument("--cpp-out", help="C++ header output path")
+    parser.add_argument("--py-out", help="Python module output path")
+    args = parser.parse_args()
+
+    proto = load_description(args.description)
+    wrote = []
+    if args.cpp_out:
+        if write_if_changed(args.cpp_out, emit_cpp(proto, args.description)):
+            wrote.append(args.cpp_out)
+    if args.py_out:
+        if write_if_changed(args.py_out, emit_py(proto, args.description)):
+            wrote.append(args.py_out)
+    for path in wrote:
+        print(f"  - Generated {path}")
+
+
+if __name__ == "__main__":
+    main()
@@ -42,6 +42,7 @@ OF SUCH DAMAGE.
 #define OB_RDPT                 0x1ffff800
 #define MAL_MASK_OB             0xFFFFFF00
 #define FLASH_END_ADDR          0x08020000
+#define FLASH_PAGE_SIZE         0x400U
 #define INTER_FLASH_IF_STR      "@Internal Flash   /0x08000000/32*001Ka,96*001Kg"
 
 extern dfu_mem_prop dfu_inter_flash_cb;
@@ -162,6 +162,8 @@ static uint8_t flash_if_erase(uint32_t addr)
 static uint8_t flash_if_write(uint8_t *buf, uint32_t addr, uint32_t len)
 {
     uint32_t idx = 0U;
+    uint32_t page = 0U;
+    uint32_t word = 0U;
 
     /* unlock the flash program erase controller */
     fmc_unlock();
@@ -171,13 +173,32 @@ static uint8_t flash_if_write(uint8_t *buf, uint32_t addr, uint32_t len)
         for(idx = len; idx < ((len & 0xFFFCU) + 4U); idx++) {
             buf[idx] = 0xFFU;
         }
+        len = (len & 0xFFFCU) + 4U;
     }
 
-    /* data received are word multiple */
-    for (idx = 0U; idx < len; idx += 4U) {
-        fmc_word_program(addr, *(uint32_t *)(buf + idx));
+    /* erase any touched page that is not already blank. DfuSe hosts write
+       ascending addresses, so a page is never revisited after data has been
+       programmed into it and erasing on first touch is safe. Doing it here
+       lets hosts skip the per-page ERASE/GETSTATUS round trips. */
+    for (page = addr & ~(FLASH_PAGE_SIZE - 1U); page < (addr + len); page += FLASH_PAGE_SIZE) {
+        for (word = page; word < (page + FLASH_PAGE_SIZE); word += 4U) {
+            if (0xFFFFFFFFU != *(uint32_t *)word) {
+                if (FMC_READY != fmc_page_erase(page)) {
+                    fmc_lock();
+
+                    return MEM_FAIL;
+                }
+
+                break;
+            }
+        }
+    }
 
-        addr += 4U;
+    /* program the whole buffer with the PG bit held, skipping blank words */
+    if (FMC_READY != fmc_words_program(addr, (uint32_t *)buf, len >> 2)) {
+        fmc_lock();
+
+        return MEM_FAIL;
     }
 
     fmc_lock();
@@ -262,6 +262,8 @@ fmc_state_enum fmc_page_erase(uint32_t page_address);
 fmc_state_enum fmc_mass_erase(void);
 /* FMC program a word at the corresponding address */
 fmc_state_enum fmc_word_program(uint32_t address, uint32_t data);
+/* FMC program a buffer of words at the corresponding address */
+fmc_state_enum fmc_words_program(uint32_t address, const uint32_t *data, uint32_t count);
 /* FMC program a half word at the corresponding address */
 fmc_state_enum fmc_halfword_program(uint32_t address, uint16_t data);
 
@@ -155,6 +155,45 @@ fmc_state_enum fmc_word_program(uint32_t address, uint32_t data)
     /* return the FMC state */
     return fmc_state;
 }
+
+/*!
+    \brief      FMC program a buffer of words at the corresponding address
+    \param[in]  address: start address to program
+    \param[in]  data: pointer to the words to program
+    \param[in]  count: number of words to program
+    \param[out] none
+    \retval     state of FMC, refer to fmc_state_enum
+ */
+fmc_state_enum fmc_words_program(uint32_t address, const uint32_t *data, uint32_t count)
+{
+    fmc_state_enum fmc_state = FMC_READY;
+    fmc_state = fmc_ready_wait(FMC_TIMEOUT_COUNT);
+
+    if(FMC_READY == fmc_state){
+        /* set the PG bit once and keep it set for the whole buffer, so
+           each word costs one bus write and one busy wait instead of a
+           full control register round trip */
+        FMC_CTL |= FMC_CTL_PG;
+        while(0U != count--){
+            /* erased words need no programming */
+            if(0xFFFFFFFFU != *data){
+                REG32(address) = *data;
+                /* wait for the FMC ready */
+                fmc_state = fmc_ready_wait(FMC_TIMEOUT_COUNT);
+                if(FMC_READY != fmc_state){
+                    break;
+                }
+            }
+            address += 4U;
+            data++;
+        }
+        /* reset the PG bit */
+        FMC_CTL &= ~FMC_CTL_PG;
+    }
+    /* return the FMC state */
+    return fmc_state;
+}
+
 /*
     \brief      FMC program a half word at the corresponding address
     \param[in]  address: address to program
@@ -162,6 +162,20 @@ typedef struct {
     uint32_t base_addr;                  /*!< memory base address */
 
     uint8_t buf[TRANSFER_SIZE];          /*!< data transfer buff */
+
+    /* fast-update download pipeline: regular DNLOAD blocks land
+       alternately in the two block buffers and are programmed from the
+       application main loop (dfu_dnload_flush), so USB reception of
+       block N+1 overlaps the flash programming of block N. DFU_GETSTATUS
+       reports DNLOAD_IDLE only while a block buffer is free, which keeps
+       the flash programming back to back instead of idling during the
+       USB data phase. */
+    uint8_t blk_buf[2][TRANSFER_SIZE];   /*!< staged download blocks */
+    uint32_t blk_addr[2];                /*!< flash address per block */
+    uint32_t blk_len[2];                 /*!< byte count per block */
+    volatile uint8_t blk_pending[2];     /*!< block waits for programming */
+    volatile uint8_t prog_active;        /*!< dfu_dnload_flush is programming */
+    uint8_t blk_rx;                      /*!< block buffer receiving next */
 } usbd_dfu_handler;
 
 typedef void (*app_func)(void);
@@ -169,4 +183,7 @@ typedef void (*app_func)(void);
 extern usb_desc dfu_desc;
 extern usb_class_core dfu_class;
 
+/* program staged download blocks (call from the application main loop) */
+void dfu_dnload_flush(usb_dev *udev);
+
 #endif  /* DFU_CORE_H */
@@ -48,6 +48,7 @@ static uint8_t dfu_ctlx_in(usb_dev *udev);
 
 static void dfu_mode_leave(usb_dev *udev);
 static uint8_t dfu_getstatus_complete(usb_dev *udev);
+static uint8_t dfu_dnload_busy(usbd_dfu_handler *dfu);
 
 /* DFU requests management functions */
 static void dfu_detach(usb_dev *udev, usb_req *req);
@@ -392,7 +393,14 @@ static uint8_t dfu_getstatus_complete(usb_dev *udev)
             /* decode the required address */
             addr = (dfu->block_num - 2U) * TRANSFER_SIZE + dfu->base_addr;
 
-            dfu_mem_write(dfu->buf, addr, dfu->data_len);
+            /* fast path: stage the received block and return at once; the
+               application main loop programs it through dfu_dnload_flush
+               while the host already streams the next block into the
+               other buffer */
+            dfu->blk_addr[dfu->blk_rx] = addr;
+            dfu->blk_len[dfu->blk_rx] = dfu->data_len;
+            dfu->blk_pending[dfu->blk_rx] = 1U;
+            dfu->blk_rx ^= 1U;
 
             dfu->block_num = 0U;
         } else {
@@ -415,6 +423,52 @@ static uint8_t dfu_getstatus_complete(usb_dev *udev)
     return USBD_OK;
 }
 
+/*!
+    \brief      check whether the download pipeline still holds work
+    \param[in]  dfu: pointer to DFU handler
+    \param[out] none
+    \retval     1 if a block is staged or programming, 0 otherwise
+*/
+static uint8_t dfu_dnload_busy(usbd_dfu_handler *dfu)
+{
+    return (uint8_t)(dfu->blk_pending[0] || dfu->blk_pending[1] || dfu->prog_active);
+}
+
+/*!
+    \brief      program staged download blocks (call from the application main loop)
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     none
+*/
+void dfu_dnload_flush(usb_dev *udev)
+{
+    usbd_dfu_handler *dfu = (usbd_dfu_handler *)udev->dev.class_data[USBD_DFU_INTERFACE];
+
+    if(NULL == dfu) {
+        return;
+    }
+
+    /* when both buffers are staged the one the receiver would use next is
+       the older of the two, so program starting there */
+    uint8_t idx = dfu->blk_rx;
+
+    for(uint8_t n = 0U; n < 2U; n++, idx ^= 1U) {
+        if(0U != dfu->blk_pending[idx]) {
+            /* the USB interrupt never programs; prog_active only tells the
+               status gates that a block is mid-flight */
+            dfu->prog_active = 1U;
+
+            if(MEM_OK != dfu_mem_write(dfu->blk_buf[idx], dfu->blk_addr[idx], dfu->blk_len[idx])) {
+                dfu->bStatus = STATUS_ERR_WRITE;
+                dfu->bState = STATE_DFU_ERROR;
+            }
+
+            dfu->blk_pending[idx] = 0U;
+            dfu->prog_active = 0U;
+        }
+    }
+}
+
 /*!
     \brief      handle the DFU_DETACH request
     \param[in]  udev: pointer to USB device instance
@@ -478,7 +532,14 @@ static void dfu_dnload(usb_dev *udev, usb_req *req)
             dfu->bState = STATE_DFU_DNLOAD_SYNC;
 
             transc->remain_len = dfu->data_len;
-            transc->xfer_buf = dfu->buf;
+            /* regular blocks go to a free pipeline buffer (guaranteed by
+               the DFU_GETSTATUS gate), special commands keep using the
+               control buffer */
+            if(req->wValue > 1U) {
+                transc->xfer_buf = dfu->blk_buf[dfu->blk_rx];
+            } else {
+                transc->xfer_buf = dfu->buf;
+            }
         } else {
             dfu->manifest_state = MANIFEST_IN_PROGRESS;
             dfu->bState = STATE_DFU_MANIFEST_SYNC;
@@ -569,6 +630,15 @@ static void dfu_getstatus(usb_dev *udev, usb_req *req)
     switch(dfu->bState) {
     case STATE_DFU_DNLOAD_SYNC:
         if(0U != dfu->data_len) {
+            if((0U == dfu->block_num) && dfu_dnload_busy(dfu)) {
+                /* special commands (erase, set address) act on the flash
+                   directly, so hold them in DNLOAD_SYNC until the staged
+                   blocks have finished programming; the host polls again
+                   after the reported timeout */
+                dfu->bwPollTimeout0 = 1U;
+                break;
+            }
+
             dfu->bState = STATE_DFU_DNBUSY;
 
             if(0U == dfu->block_num) {
@@ -577,14 +647,30 @@ static void dfu_getstatus(usb_dev *udev, usb_req *req)
                 } else {
                     dfu_mem_getstatus(dfu->base_addr, CMD_WRITE, (uint8_t *)&dfu->bwPollTimeout0);
                 }
+            } else {
+                /* staged block: the status completion returns right after
+                   queueing it, so the host only needs a short poll delay */
+                dfu->bwPollTimeout0 = 1U;
             }
         } else {
-            dfu->bState = STATE_DFU_DNLOAD_IDLE;
+            if(0U != dfu->blk_pending[dfu->blk_rx]) {
+                /* both pipeline buffers are still owned by the programmer:
+                   delay DNLOAD_IDLE so the next block has somewhere to land */
+                dfu->bwPollTimeout0 = 1U;
+            } else {
+                dfu->bState = STATE_DFU_DNLOAD_IDLE;
+            }
         }
         break;
 
     case STATE_DFU_MANIFEST_SYNC:
         if(MANIFEST_IN_PROGRESS == dfu->manifest_state) {
+            if(dfu_dnload_busy(dfu)) {
+                /* the final blocks are still programming: stay in
+                   MANIFEST_SYNC, the device must not reset under them */
+                dfu->bwPollTimeout0 = 1U;
+                break;
+            }
             dfu->bState = STATE_DFU_MANIFEST;
             dfu->bwPollTimeout0 = 1U;
         } else if((MANIFEST_COMPLETE == dfu->manifest_state) && \
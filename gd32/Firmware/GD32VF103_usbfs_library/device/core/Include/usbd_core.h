@@ -86,6 +86,12 @@ uint32_t usbd_ep_setup(usb_core_driver *udev, const usb_desc_ep *ep_desc);
 uint32_t usbd_ep_clear(usb_core_driver *udev, uint8_t ep_addr);
 /* endpoint prepare to receive data */
 uint32_t usbd_ep_recev(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, uint32_t len);
+/* endpoint prepare to receive data with ping-pong (double) buffering */
+uint32_t usbd_ep_recev_pingpong(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf0, uint8_t *pbuf1, uint32_t len);
+/* keep the current ping-pong transfer from re-arming the alternate buffer */
+void usbd_ep_pingpong_hold(usb_core_driver *udev, uint8_t ep_addr);
+/* get the buffer (and byte count) of the last completed ping-pong transfer */
+uint8_t *usbd_ep_pingpong_rxbuf(usb_core_driver *udev, uint8_t ep_addr, uint32_t *len);
 /* endpoint prepare to transmit data */
 uint32_t usbd_ep_send(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, uint32_t len);
 /* set an endpoint to STALL status */
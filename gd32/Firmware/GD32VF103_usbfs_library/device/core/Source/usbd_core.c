@@ -59,8 +59,8 @@ void usbd_init(usb_core_driver *udev, usb_desc *desc, usb_class_core *class_core
     /* class callbacks */
     udev->dev.class_core = class_core;
 
-    /* create serial string */
-    serial_string_get(udev->dev.desc->strings[STR_IDX_SERIAL]);
+    /* the serial string is built lazily on the first GET_DESCRIPTOR
+       request (see _usb_str_desc_get in usbd_enum.c) */
 
     /* configure USB capabilities */
     (void)usb_basic_init(&udev->bp, &udev->regs);
@@ -165,6 +165,10 @@ uint32_t usbd_ep_recev(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, ui
 {
     usb_transc *transc = &udev->dev.transc_out[EP_ID(ep_addr)];
 
+    /* a single-buffer reception ends any ping-pong sequence */
+    transc->pp_enabled = 0U;
+    transc->pp_rxbuf = NULL;
+
     /* setup the transfer */
     transc->xfer_buf = pbuf;
     transc->xfer_len = len;
@@ -176,6 +180,79 @@ uint32_t usbd_ep_recev(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, ui
     return 0U;
 }
 
+/*!
+    \brief      endpoint prepare to receive data with ping-pong (double) buffering
+                on every transfer completion the endpoint is re-armed with the
+                alternate buffer before the class data callback runs, so the host
+                can push the next transfer while the previous one is consumed
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  ep_addr: endpoint address
+                  in this parameter:
+                    bit0..bit6: endpoint number (0..7)
+                    bit7: endpoint direction which can be IN(1) or OUT(0)
+    \param[in]  pbuf0: first receive buffer address pointer
+    \param[in]  pbuf1: second receive buffer address pointer
+    \param[in]  len: buffer length (each buffer is armed with this length)
+    \param[out] none
+    \retval     none
+*/
+uint32_t usbd_ep_recev_pingpong(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf0, uint8_t *pbuf1, uint32_t len)
+{
+    usb_transc *transc = &udev->dev.transc_out[EP_ID(ep_addr)];
+
+    transc->pp_buf[0] = pbuf0;
+    transc->pp_buf[1] = pbuf1;
+    transc->pp_len = len;
+    transc->pp_sel = 0U;
+    transc->pp_enabled = 1U;
+    transc->pp_arm_next = 1U;
+    transc->pp_rxbuf = NULL;
+    transc->pp_rxlen = 0U;
+
+    /* setup the transfer into the first buffer */
+    transc->xfer_buf = pbuf0;
+    transc->xfer_len = len;
+    transc->xfer_count = 0U;
+
+    /* start the transfer */
+    (void)usb_transc_outxfer(udev, transc);
+
+    return 0U;
+}
+
+/*!
+    \brief      keep the current ping-pong transfer from re-arming the alternate buffer
+                call while consuming the transfer before the last one, so the final
+                completion leaves the endpoint idle (e.g. for a following command
+                stage that needs a different buffer)
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  ep_addr: endpoint address
+    \param[out] none
+    \retval     none
+*/
+void usbd_ep_pingpong_hold(usb_core_driver *udev, uint8_t ep_addr)
+{
+    udev->dev.transc_out[EP_ID(ep_addr)].pp_arm_next = 0U;
+}
+
+/*!
+    \brief      get the buffer (and byte count) of the last completed ping-pong transfer
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  ep_addr: endpoint address
+    \param[out] len: byte count of the completed transfer (may be NULL)
+    \retval     buffer address of the completed transfer
+*/
+uint8_t *usbd_ep_pingpong_rxbuf(usb_core_driver *udev, uint8_t ep_addr, uint32_t *len)
+{
+    usb_transc *transc = &udev->dev.transc_out[EP_ID(ep_addr)];
+
+    if(NULL != len) {
+        *len = transc->pp_rxlen;
+    }
+
+    return transc->pp_rxbuf;
+}
+
 /*!
     \brief      endpoint prepare to transmit data
     \param[in]  udev: pointer to USB core instance
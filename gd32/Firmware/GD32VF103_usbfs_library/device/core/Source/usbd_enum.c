@@ -282,6 +282,20 @@ static uint8_t *_usb_str_desc_get(usb_core_driver *udev, uint8_t index, uint16_t
 {
     uint8_t *desc = udev->dev.desc->strings[index];
 
+    /* the serial string is converted from the device unique ID to UTF-16
+       here, on the first host request, rather than during usbd_init():
+       most hosts never ask for it, and keeping it out of init shortens
+       the time from reset to a connect-ready core */
+    if((uint8_t)STR_IDX_SERIAL == index) {
+        static uint8_t serial_built = 0U;
+
+        if(0U == serial_built) {
+            serial_string_get((uint16_t *)desc);
+
+            serial_built = 1U;
+        }
+    }
+
     *len = desc[0];
 
     return desc;
@@ -196,6 +196,28 @@ uint8_t usbd_out_transc(usb_core_driver *udev, uint8_t ep_num)
             break;
         }
     } else if((NULL != udev->dev.class_core->data_out) && ((uint8_t)USBD_CONFIGURED == udev->dev.cur_status)) {
+        usb_transc *transc = &udev->dev.transc_out[ep_num];
+
+        if(transc->pp_enabled) {
+            /* record the completed buffer, then re-arm the endpoint with the
+               alternate one before the class callback runs: the host can push
+               the next transfer while this one is still being consumed */
+            transc->pp_rxbuf = transc->pp_buf[transc->pp_sel];
+            transc->pp_rxlen = transc->xfer_count;
+
+            if(transc->pp_arm_next) {
+                transc->pp_sel ^= 1U;
+
+                transc->xfer_buf = transc->pp_buf[transc->pp_sel];
+                transc->xfer_len = transc->pp_len;
+                transc->xfer_count = 0U;
+
+                (void)usb_transc_outxfer(udev, transc);
+            } else {
+                transc->pp_enabled = 0U;
+            }
+        }
+
         (void)udev->dev.class_core->data_out(udev, ep_num);
     } else {
         /* no operation */
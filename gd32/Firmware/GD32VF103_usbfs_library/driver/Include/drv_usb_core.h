@@ -46,6 +46,22 @@ OF SUCH DAMAGE.
 
 #define EP_MAX_PACKET_SIZE_MASK             0x07FFU                             /*!< endpoint maximum packet size mask */
 
+/* use the word-wise FIFO copy path: buffer alignment is resolved once per
+   transfer and unaligned tails are handled after the word loop, instead of
+   going through a packed (bytewise) access for every word; define to 0 to
+   fall back to the original packed copy */
+#ifndef USB_FIFO_FAST_COPY
+#define USB_FIFO_FAST_COPY                  1
+#endif /* USB_FIFO_FAST_COPY */
+
+/* count FIFO back-pressure events (TX FIFO too full to take the next
+   packet, RX FIFO holding a further packet behind the one just drained)
+   so a misallocated FIFO split shows up as a counter instead of silently
+   NAK-throttled throughput; define to 0 to drop the counters */
+#ifndef USB_FIFO_STATS
+#define USB_FIFO_STATS                      1
+#endif /* USB_FIFO_STATS */
+
 enum _usb_mode {
     DEVICE_MODE = 0U,                                                           /*!< device mode */
     HOST_MODE,                                                                  /*!< host mode */
@@ -134,6 +150,15 @@ typedef struct {
     uint32_t       xfer_count;                                                  /*!< transmit buffer count */
 
     uint32_t       remain_len;                                                  /*!< remain packet length */
+
+    /* software ping-pong (double-buffered) reception for OUT endpoints */
+    uint8_t       *pp_buf[2];                                                   /*!< ping-pong receive buffers */
+    uint32_t       pp_len;                                                      /*!< length each buffer is armed with */
+    uint8_t        pp_sel;                                                      /*!< buffer the hardware fills next */
+    uint8_t        pp_enabled;                                                  /*!< ping-pong reception active flag */
+    uint8_t        pp_arm_next;                                                 /*!< re-arm the alternate buffer on completion */
+    uint8_t       *pp_rxbuf;                                                    /*!< buffer holding the completed transfer */
+    uint32_t       pp_rxlen;                                                    /*!< byte count of the completed transfer */
 } usb_transc;
 
 typedef struct _usb_core_driver usb_dev;
@@ -38,6 +38,17 @@ OF SUCH DAMAGE.
 #include "drv_usb_core.h"
 #include "drv_usb_dev.h"
 
+#if USB_FIFO_STATS
+/* FIFO back-pressure counters, incremented from the device ISR:
+   usb_fifo_tx_stall[n] counts the times IN endpoint n had data pending
+   but its TX FIFO could not take another packet; usb_fifo_rx_backlog
+   counts the times a further packet was already queued in the shared RX
+   FIFO behind the one just drained. Steadily climbing counters mean the
+   FIFO split in the project's usb_conf.h is starving that direction. */
+extern __IO uint32_t usb_fifo_tx_stall[4];
+extern __IO uint32_t usb_fifo_rx_backlog;
+#endif /* USB_FIFO_STATS */
+
 /* function declarations */
 /* USB device-mode interrupts global service routine handler */
 void usbd_isr(usb_core_driver *udev);
@@ -172,15 +172,53 @@ usb_status usb_txfifo_write(usb_core_regs *usb_regs, \
                             uint8_t  fifo_num, \
                             uint16_t byte_count)
 {
-    uint32_t word_count = (byte_count + 3U) / 4U;
-
     __IO uint32_t *fifo = usb_regs->DFIFO[fifo_num];
 
+#if defined(USB_FIFO_FAST_COPY) && (USB_FIFO_FAST_COPY == 1)
+    uint32_t word_count = (uint32_t)byte_count >> 2;
+    uint32_t residue = (uint32_t)byte_count & 3U;
+
+    if(0U == ((uintptr_t)src_buf & 3U)) {
+        /* aligned source (the common case): straight 32-bit loads */
+        const uint32_t *src32 = (const uint32_t *)(const void *)src_buf;
+
+        while(word_count-- > 0U) {
+            *fifo = *src32++;
+        }
+
+        src_buf = (uint8_t *)(uintptr_t)src32;
+    } else {
+        /* unaligned source: assemble words bytewise, but the alignment
+           decision is taken once per transfer instead of per word */
+        while(word_count-- > 0U) {
+            *fifo = (uint32_t)src_buf[0] | ((uint32_t)src_buf[1] << 8) | \
+                    ((uint32_t)src_buf[2] << 16) | ((uint32_t)src_buf[3] << 24);
+
+            src_buf += 4U;
+        }
+    }
+
+    /* partial tail word, at most once per transfer; unlike the packed
+       copy this never reads past the end of the source buffer */
+    if(residue > 0U) {
+        uint32_t word = 0U;
+        uint32_t i;
+
+        for(i = 0U; i < residue; i++) {
+            word |= (uint32_t)src_buf[i] << (8U * i);
+        }
+
+        *fifo = word;
+    }
+#else
+    uint32_t word_count = (byte_count + 3U) / 4U;
+
     while(word_count-- > 0U) {
         *fifo = *((uint32_t __attribute__((packed)) *)src_buf);
 
         src_buf += 4U;
     }
+#endif /* USB_FIFO_FAST_COPY */
 
     return USB_OK;
 }
@@ -195,15 +233,57 @@ usb_status usb_txfifo_write(usb_core_regs *usb_regs, \
 */
 void *usb_rxfifo_read(usb_core_regs *usb_regs, uint8_t *dest_buf, uint16_t byte_count)
 {
-    uint32_t word_count = (byte_count + 3U) / 4U;
-
     __IO uint32_t *fifo = usb_regs->DFIFO[0];
 
+#if defined(USB_FIFO_FAST_COPY) && (USB_FIFO_FAST_COPY == 1)
+    uint32_t word_count = (uint32_t)byte_count >> 2;
+    uint32_t residue = (uint32_t)byte_count & 3U;
+
+    if(0U == ((uintptr_t)dest_buf & 3U)) {
+        /* aligned destination (the common case): straight 32-bit stores */
+        uint32_t *dest32 = (uint32_t *)(void *)dest_buf;
+
+        while(word_count-- > 0U) {
+            *dest32++ = *fifo;
+        }
+
+        dest_buf = (uint8_t *)dest32;
+    } else {
+        /* unaligned destination: scatter words bytewise, alignment decided
+           once per transfer instead of per word */
+        while(word_count-- > 0U) {
+            uint32_t word = *fifo;
+
+            dest_buf[0] = (uint8_t)word;
+            dest_buf[1] = (uint8_t)(word >> 8);
+            dest_buf[2] = (uint8_t)(word >> 16);
+            dest_buf[3] = (uint8_t)(word >> 24);
+
+            dest_buf += 4U;
+        }
+    }
+
+    /* the FIFO always pops whole words: unpack the partial tail word, at
+       most once per transfer, without writing past the destination */
+    if(residue > 0U) {
+        uint32_t word = *fifo;
+        uint32_t i;
+
+        for(i = 0U; i < residue; i++) {
+            dest_buf[i] = (uint8_t)(word >> (8U * i));
+        }
+
+        dest_buf += residue;
+    }
+#else
+    uint32_t word_count = (byte_count + 3U) / 4U;
+
     while(word_count-- > 0U) {
         *(uint32_t __attribute__((packed)) *)dest_buf = *fifo;
 
         dest_buf += 4U;
     }
+#endif /* USB_FIFO_FAST_COPY */
 
     return ((void *)dest_buf);
 }
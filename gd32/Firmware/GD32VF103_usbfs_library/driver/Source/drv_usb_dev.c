@@ -335,9 +335,30 @@ usb_status usb_transc_inxfer(usb_core_driver *udev, usb_transc *transc)
 
     if((uint8_t)USB_USE_FIFO == udev->bp.transfer_mode) {
         if((uint8_t)USB_EPTYPE_ISOC != transc->ep_type) {
-            /* enable the TX FIFO empty interrupt for this endpoint */
             if(transc->xfer_len > 0U) {
-                udev->regs.dr->DIEPFEINTEN |= 1U << ep_num;
+                /* pre-load the first packet at submission time when the
+                   TX FIFO has room for it: waiting for the TX FIFO empty
+                   interrupt would leave the endpoint armed but empty, so
+                   the first IN token after submission gets a NAK and the
+                   data only goes out a full bus turnaround later. With
+                   the packet already in the FIFO that token is answered
+                   directly; the empty interrupt then streams any
+                   remaining packets exactly as before */
+                uint32_t len = USB_MIN(transc->xfer_len, transc->max_len);
+                uint32_t word_count = (len + 3U) / 4U;
+
+                if((udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS) >= word_count) {
+                    (void)usb_txfifo_write(&udev->regs, transc->xfer_buf, ep_num, (uint16_t)len);
+
+                    transc->xfer_buf += len;
+                    transc->xfer_count += len;
+                }
+
+                /* enable the TX FIFO empty interrupt for this endpoint
+                   only while packets remain to be loaded */
+                if(transc->xfer_count < transc->xfer_len) {
+                    udev->regs.dr->DIEPFEINTEN |= 1U << ep_num;
+                }
             }
         } else {
             (void)usb_txfifo_write(&udev->regs, transc->xfer_buf, ep_num, (uint16_t)transc->xfer_len);
@@ -34,6 +34,7 @@ OF SUCH DAMAGE.
 
 #include "drv_usbd_int.h"
 #include "usbd_transc.h"
+#include "ramtext.h"
 
 static const uint8_t USB_SPEED[4] = {
     [DSTAT_EM_HS_PHY_30MHZ_60MHZ] = (uint8_t)USB_SPEED_HIGH,
@@ -44,6 +45,12 @@ static const uint8_t USB_SPEED[4] = {
 
 __IO uint8_t setupc_flag = 0U;
 
+#if USB_FIFO_STATS
+/* FIFO back-pressure counters (see drv_usbd_int.h) */
+__IO uint32_t usb_fifo_tx_stall[4] = {0U, 0U, 0U, 0U};
+__IO uint32_t usb_fifo_rx_backlog = 0U;
+#endif /* USB_FIFO_STATS */
+
 /* local function prototypes ('static') */
 static uint32_t usbd_int_epout(usb_core_driver *udev);
 static uint32_t usbd_int_epin(usb_core_driver *udev);
@@ -59,7 +66,7 @@ static uint32_t usbd_emptytxfifo_write(usb_core_driver *udev, uint32_t ep_num);
     \param[out] none
     \retval     none
 */
-void usbd_isr(usb_core_driver *udev)
+RAMTEXT void usbd_isr(usb_core_driver *udev)
 {
     if(HOST_MODE != (udev->regs.gr->GINTF & GINTF_COPM)) {
         uint32_t intr = udev->regs.gr->GINTF;
@@ -177,7 +184,7 @@ void usbd_isr(usb_core_driver *udev)
     \param[out] none
     \retval     operation status
 */
-static uint32_t usbd_int_epout(usb_core_driver *udev)
+RAMTEXT static uint32_t usbd_int_epout(usb_core_driver *udev)
 {
     uint32_t epintnum = 0U;
     uint8_t ep_num = 0U;
@@ -218,7 +225,7 @@ static uint32_t usbd_int_epout(usb_core_driver *udev)
     \param[out] none
     \retval     operation status
 */
-static uint32_t usbd_int_epin(usb_core_driver *udev)
+RAMTEXT static uint32_t usbd_int_epin(usb_core_driver *udev)
 {
     uint32_t epintnum = 0U;
     uint8_t ep_num = 0U;
@@ -251,7 +258,7 @@ static uint32_t usbd_int_epin(usb_core_driver *udev)
     \param[out] none
     \retval     operation status
 */
-static uint32_t usbd_int_rxfifo(usb_core_driver *udev)
+RAMTEXT static uint32_t usbd_int_rxfifo(usb_core_driver *udev)
 {
     usb_transc *transc = NULL;
 
@@ -310,6 +317,14 @@ static uint32_t usbd_int_rxfifo(usb_core_driver *udev)
         break;
     }
 
+#if USB_FIFO_STATS
+    if(udev->regs.gr->GINTF & GINTF_RXFNEIF) {
+        /* another packet is already queued behind the one just drained:
+           the host is filling the RX FIFO faster than it is emptied */
+        usb_fifo_rx_backlog++;
+    }
+#endif /* USB_FIFO_STATS */
+
     /* enable the RX status queue level interrupt */
     udev->regs.gr->GINTEN |= GINTEN_RXFNEIE;
 
@@ -489,5 +504,13 @@ static uint32_t usbd_emptytxfifo_write(usb_core_driver *udev, uint32_t ep_num)
         }
     }
 
+#if USB_FIFO_STATS
+    if(transc->xfer_count < transc->xfer_len) {
+        /* data remains but the TX FIFO has no room for the next packet:
+           the endpoint will NAK until the host drains it */
+        usb_fifo_tx_stall[ep_num]++;
+    }
+#endif /* USB_FIFO_STATS */
+
     return 1U;
 }
@@ -3,15 +3,26 @@
 
 #include <stddef.h>
 
+extern char _end[];
+extern char _heap_end[];
+
+static char *curbrk = _end;
+static char *maxbrk = _end;
+
 void *_sbrk(ptrdiff_t incr)
 {
-  extern char _end[];
-  extern char _heap_end[];
-  static char *curbrk = _end;
-
   if ((curbrk + incr < _end) || (curbrk + incr > _heap_end))
     return NULL - 1;
 
   curbrk += incr;
+  if (curbrk > maxbrk)
+    maxbrk = curbrk;
   return curbrk - incr;
-}
\ No newline at end of file
+}
+
+/* Highest break ever granted; lib/system/memwatch.c reports it as the
+   heap high-water mark. */
+char *_sbrk_high_water(void)
+{
+  return maxbrk;
+}
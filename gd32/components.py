@@ -26,16 +26,15 @@ components = {
         "enabled": True,
     },
     "gd32_std_peripheral_lib": {
+        # Slimmed to the drivers some project actually calls (per the
+        # 'audit' build command): the rest sit in
+        # gd32_std_peripheral_extras so no project compiles and links
+        # them by default.
         "c_sources": [
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_adc.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_bkp.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_can.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_crc.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_dac.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_dbg.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_dma.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_eclic.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_exmc.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_exti.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_fmc.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_fwdgt.c",
@@ -43,10 +42,34 @@ components = {
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_i2c.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_pmu.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_rcu.c",
-            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_rtc.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_spi.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_timer.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_usart.c",
+        ],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [
+            r"-IFirmware/GD32VF103_standard_peripheral",
+            r"-IFirmware/GD32VF103_standard_peripheral/Include"
+        ],
+        "enabled": True,
+        # Cold vendor code: keep it small in every profile.
+        "optimization": "-Os",
+    },
+    "gd32_std_peripheral_extras": {
+        # Drivers no project references (every section --gc-sections
+        # discarded): backup domain, CAN, DAC, debug MCU, EXMC, RTC and
+        # the window watchdog. The headers stay visible through the
+        # gd32_std_peripheral_lib include paths, so a project that
+        # starts using one of these peripherals just adds this
+        # component to its list.
+        "c_sources": [
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_bkp.c",
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_can.c",
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_dac.c",
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_dbg.c",
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_exmc.c",
+            r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_rtc.c",
             r"Firmware/GD32VF103_standard_peripheral/Source/gd32vf103_wwdgt.c",
         ],
         "cpp_sources": [],
@@ -56,6 +79,7 @@ components = {
             r"-IFirmware/GD32VF103_standard_peripheral/Include"
         ],
         "enabled": True,
+        "optimization": "-Os",
     },
     "usb_driver_core": {
         "c_sources": [
@@ -65,6 +89,9 @@ components = {
         "asm_sources": [],
         "include_paths": [r"-IFirmware/GD32VF103_usbfs_library/driver/Include"],
         "enabled": True,
+        # FIFO push/pop and the ISR dispatch live here; -O2 even when
+        # building for size.
+        "optimization": "-O2",
     },
     "usb_driver_host": {
         "c_sources": [
@@ -85,6 +112,9 @@ components = {
         "asm_sources": [],
         "include_paths": [r"-IFirmware/GD32VF103_usbfs_library/driver/Include"],
         "enabled": True,
+        # Per-transfer hot path (endpoint ISR, FIFO drain); -O2 even when
+        # building for size.
+        "optimization": "-O2",
     },
     "usb_device_core": {
         "c_sources": [
@@ -0,0 +1,142 @@
+/* Block pools and linear arena; see alloc.h for the rationale. */
+
+#include "alloc.h"
+#include "riscv_encoding.h"
+
+typedef struct free_block {
+    struct free_block *next;
+} free_block_t;
+
+typedef struct {
+    uint8_t *storage;
+    uint16_t block_size;
+    uint16_t block_count;
+    free_block_t *free_list;
+    uint16_t in_use;
+    uint16_t high_water;
+} pool_t;
+
+static uint8_t small_storage[ALLOC_POOL_SMALL_BLOCK * ALLOC_POOL_SMALL_COUNT]
+    __attribute__((aligned(4)));
+static uint8_t large_storage[ALLOC_POOL_LARGE_BLOCK * ALLOC_POOL_LARGE_COUNT]
+    __attribute__((aligned(4)));
+
+/* Ordered smallest block first; pool_alloc walks this until one fits. */
+static pool_t pools[2] = {
+    { small_storage, ALLOC_POOL_SMALL_BLOCK, ALLOC_POOL_SMALL_COUNT, 0, 0, 0 },
+    { large_storage, ALLOC_POOL_LARGE_BLOCK, ALLOC_POOL_LARGE_COUNT, 0, 0, 0 },
+};
+
+static uint16_t pool_failures;
+
+static uint8_t arena_storage[ALLOC_ARENA_SIZE] __attribute__((aligned(4)));
+static size_t arena_top;
+
+/* Threads each pool's blocks onto its free list on first use; cheaper
+ * than demanding an init call from every early user. */
+static void pools_init_once(void)
+{
+    static uint8_t done;
+    if (done) {
+        return;
+    }
+    done = 1;
+    for (uint32_t p = 0; p < 2; p++) {
+        for (uint32_t i = 0; i < pools[p].block_count; i++) {
+            free_block_t *b =
+                (free_block_t *)(pools[p].storage + i * pools[p].block_size);
+            b->next = pools[p].free_list;
+            pools[p].free_list = b;
+        }
+    }
+}
+
+void *pool_alloc(size_t size)
+{
+    void *result = 0;
+    /* printf and the USB stack allocate from ISR context, so the
+     * free-list update must not be interrupted (same pattern as the
+     * debug UART ring in debug_write.cpp). */
+    uint32_t mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+    pools_init_once();
+    for (uint32_t p = 0; p < 2; p++) {
+        if (size > pools[p].block_size || !pools[p].free_list) {
+            continue;
+        }
+        free_block_t *b = pools[p].free_list;
+        pools[p].free_list = b->next;
+        pools[p].in_use++;
+        if (pools[p].in_use > pools[p].high_water) {
+            pools[p].high_water = pools[p].in_use;
+        }
+        result = b;
+        break;
+    }
+    if (!result) {
+        pool_failures++;
+    }
+
+    if (mie) {
+        set_csr(mstatus, MSTATUS_MIE);
+    }
+    return result;
+}
+
+void pool_free(void *block)
+{
+    if (!block) {
+        return;
+    }
+    uint32_t mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+
+    /* The owning pool is identified by address range, keeping the
+     * blocks headerless. */
+    for (uint32_t p = 0; p < 2; p++) {
+        uint8_t *base = pools[p].storage;
+        uint8_t *end = base + (size_t)pools[p].block_size * pools[p].block_count;
+        if ((uint8_t *)block >= base && (uint8_t *)block < end) {
+            free_block_t *b = (free_block_t *)block;
+            b->next = pools[p].free_list;
+            pools[p].free_list = b;
+            pools[p].in_use--;
+            break;
+        }
+    }
+
+    if (mie) {
+        set_csr(mstatus, MSTATUS_MIE);
+    }
+}
+
+void *arena_alloc(size_t size)
+{
+    size = (size + 3U) & ~(size_t)3U;
+    if (arena_top + size > ALLOC_ARENA_SIZE) {
+        return 0;
+    }
+    void *p = &arena_storage[arena_top];
+    arena_top += size;
+    return p;
+}
+
+size_t arena_mark(void)
+{
+    return arena_top;
+}
+
+void arena_release(size_t mark)
+{
+    if (mark <= arena_top) {
+        arena_top = mark;
+    }
+}
+
+void alloc_get_stats(alloc_stats_t *out)
+{
+    out->small_in_use = pools[0].in_use;
+    out->small_high_water = pools[0].high_water;
+    out->large_in_use = pools[1].in_use;
+    out->large_high_water = pools[1].high_water;
+    out->failures = pool_failures;
+}
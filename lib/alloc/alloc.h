@@ -0,0 +1,84 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Fixed-size block pools and a linear arena for hot-path allocation.
+ *
+ * The newlib heap behind _sbrk is first-fit with per-block headers: cost
+ * per call is unbounded and a long-running session can fragment 32 KB of
+ * SRAM beyond recovery. These allocators are O(1) and deterministic:
+ *
+ *  - pool_alloc()/pool_free(): two compile-time-sized block pools
+ *    (small/large) backed by intrusive free lists. A request is served
+ *    from the smallest pool whose block fits; there is never a heap
+ *    fallback, so exhaustion is visible instead of silent.
+ *
+ *  - arena_alloc() with arena_mark()/arena_release(): a linear bump
+ *    allocator for transient scratch. Freeing is rewinding to a mark,
+ *    so a whole parsing or command pass is released in one call.
+ *
+ * Sizing is compile-time: override the ALLOC_* macros from the build
+ * (GLOBAL_C_DEFINES), the same way TRACE_LEVEL and PROF_ENABLE are set.
+ * With ALLOC_NEW_HOOKS=1 the global operator new/delete route here too
+ * (see alloc_new.cpp).
+ *
+ * pool_alloc()/pool_free() briefly mask interrupts around the free-list
+ * update, so they are safe from both ISRs and the main loop. The arena
+ * is main-loop-only.
+ */
+
+#ifndef ALLOC_POOL_SMALL_BLOCK
+#define ALLOC_POOL_SMALL_BLOCK 32
+#endif
+#ifndef ALLOC_POOL_SMALL_COUNT
+#define ALLOC_POOL_SMALL_COUNT 8
+#endif
+#ifndef ALLOC_POOL_LARGE_BLOCK
+#define ALLOC_POOL_LARGE_BLOCK 256
+#endif
+#ifndef ALLOC_POOL_LARGE_COUNT
+#define ALLOC_POOL_LARGE_COUNT 4
+#endif
+#ifndef ALLOC_ARENA_SIZE
+#define ALLOC_ARENA_SIZE 1024
+#endif
+
+/* Pool occupancy counters, readable for tuning the ALLOC_* sizes. */
+typedef struct {
+    uint16_t small_in_use;
+    uint16_t small_high_water;
+    uint16_t large_in_use;
+    uint16_t large_high_water;
+    uint16_t failures; /* requests no pool could serve */
+} alloc_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* O(1) allocation from the smallest pool whose block fits `size`.
+ * Returns NULL (and counts a failure) when no pool can serve it. */
+void *pool_alloc(size_t size);
+
+/* Returns a pool block to its free list. NULL is ignored. */
+void pool_free(void *block);
+
+/* Word-aligned bump allocation; NULL once the arena is full. */
+void *arena_alloc(size_t size);
+
+/* Snapshot of the arena fill level, to pass to arena_release(). */
+size_t arena_mark(void);
+
+/* Rewinds the arena, freeing everything allocated since `mark`. */
+void arena_release(size_t mark);
+
+void alloc_get_stats(alloc_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALLOC_H */
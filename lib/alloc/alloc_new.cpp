@@ -0,0 +1,37 @@
+/* Optional global operator new/delete over the block pools.
+ *
+ * Build with ALLOC_NEW_HOOKS=1 (GLOBAL_C_DEFINES) to route every C++
+ * allocation through pool_alloc()/pool_free() instead of the newlib
+ * heap. Exhaustion halts through the same safe path as an unhandled
+ * interrupt rather than returning a pointer that would throw in a
+ * -fno-exceptions build.
+ */
+
+#include "alloc.h"
+
+#if defined(ALLOC_NEW_HOOKS) && (ALLOC_NEW_HOOKS == 1)
+
+#include <new>
+
+extern "C" void fault_puts(const char *s);
+
+static void *checked_pool_alloc(std::size_t size)
+{
+    void *p = pool_alloc(size);
+    if (!p) {
+        fault_puts("\n\n*** operator new: pool exhausted ***\nSystem Halted.\n");
+        while (1) {
+        }
+    }
+    return p;
+}
+
+void *operator new(std::size_t size) { return checked_pool_alloc(size); }
+void *operator new[](std::size_t size) { return checked_pool_alloc(size); }
+
+void operator delete(void *p) noexcept { pool_free(p); }
+void operator delete[](void *p) noexcept { pool_free(p); }
+void operator delete(void *p, std::size_t) noexcept { pool_free(p); }
+void operator delete[](void *p, std::size_t) noexcept { pool_free(p); }
+
+#endif /* ALLOC_NEW_HOOKS */
@@ -0,0 +1,66 @@
+#include "bench.h"
+#include "tfmt_chars.h"
+
+#include <cstring>
+
+/* Section bounds provided by GD32VF103xB.lds around KEEP(*(.bench_table)).
+   An image with no registered benchmarks links fine: start == end. */
+extern const bench::Desc __bench_table_start[];
+extern const bench::Desc __bench_table_end[];
+
+namespace bench {
+
+namespace {
+
+// Longest report name the line budget covers; Writer clamps (and flags)
+// anything longer rather than overflowing.
+constexpr size_t kNameBudget = 24;
+
+void report(const Desc &d, LineSink sink)
+{
+    Result r;
+    d.fn(r);
+
+    char line[TFMT_LIT_W("BENCH ") + kNameBudget +
+              TFMT_LIT_W(" cyc=") + tfmt::MaxU32Chars +
+              TFMT_LIT_W(" iters=") + tfmt::MaxU32Chars +
+              TFMT_LIT_W(" bytes=") + tfmt::MaxU32Chars +
+              TFMT_LIT_W(" cyc/it=") + tfmt::MaxU32Chars + 1];
+    uint32_t avg = (r.iters != 0U) ? (r.cycles / r.iters) : 0U;
+    tfmt::Writer w(line, sizeof(line));
+    w.str("BENCH ").str(d.name)
+     .str(" cyc=").dec(r.cycles)
+     .str(" iters=").dec(r.iters)
+     .str(" bytes=").dec(r.bytes)
+     .str(" cyc/it=").dec(avg);
+    sink(w.terminate());
+}
+
+} // namespace
+
+void run_all(LineSink sink)
+{
+    for (const Desc *d = __bench_table_start; d != __bench_table_end; ++d) {
+        report(*d, sink);
+    }
+}
+
+bool run_one(const char *name, LineSink sink)
+{
+    for (const Desc *d = __bench_table_start; d != __bench_table_end; ++d) {
+        if (strcmp(d->name, name) == 0) {
+            report(*d, sink);
+            return true;
+        }
+    }
+    return false;
+}
+
+void list(LineSink sink)
+{
+    for (const Desc *d = __bench_table_start; d != __bench_table_end; ++d) {
+        sink(d->name);
+    }
+}
+
+} // namespace bench
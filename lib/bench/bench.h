@@ -0,0 +1,65 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>
+
+/**
+ * @brief Declarative on-device micro-benchmark registry.
+ *
+ * The host-side harness (tools/hostbench) covers decoder logic, but DMA
+ * thresholds, flash wait states, and SPI command overhead only exist on
+ * silicon, and ad-hoc timing loops pasted into handlers never survive
+ * the next cleanup. Benchmarks register themselves instead: a
+ * BENCH_REGISTER() at file scope drops a descriptor into the .bench_table
+ * flash section (KEEP'd in GD32VF103xB.lds, like the dma_alloc claim
+ * registry this mirrors), and the runner walks the table between
+ * __bench_table_start and __bench_table_end. Adding a benchmark is one
+ * translation unit and zero edits anywhere else.
+ *
+ * A benchmark times its own hot loop with the mcycle CSR (prof::cycles)
+ * so setup cost stays out of the number, and fills in a Result. The
+ * runner prints one machine-readable line per benchmark:
+ *
+ *   BENCH <name> cyc=<total> iters=<n> bytes=<total> cyc/it=<avg>
+ *
+ * through a caller-supplied line sink, so the same runner serves the
+ * console (shell::printf) and the BENCH_AUTORUN boot dump (debug UART).
+ * Benchmarks run from main-loop context with interrupts live; anything
+ * that needs exclusive hardware (a DMA channel, the LCD bus) must claim
+ * or quiesce it itself.
+ */
+namespace bench {
+
+struct Result {
+    uint32_t cycles = 0; // mcycle delta over the hot loop
+    uint32_t iters = 0;  // hot-loop repetitions the delta covers
+    uint32_t bytes = 0;  // total bytes moved, 0 if not a bandwidth test
+};
+
+struct Desc {
+    const char *name;        // table key and report label
+    void (*fn)(Result &r);   // times itself, fills r
+};
+
+// One line of report text, NUL-terminated, no trailing newline.
+typedef void (*LineSink)(const char *line);
+
+// Runs every registered benchmark in table order.
+void run_all(LineSink sink);
+
+// Runs the benchmark registered under `name`; false if none matches.
+bool run_one(const char *name, LineSink sink);
+
+// Prints the registered names, one per line.
+void list(LineSink sink);
+
+} // namespace bench
+
+/* File-scope registration: emits a flash-resident descriptor the runner
+   finds by walking .bench_table. `ident` doubles as the report name. */
+#define BENCH_REGISTER(ident, func)                                      \
+    static const ::bench::Desc bench_desc_##ident                        \
+        __attribute__((section(".bench_table"), used, aligned(4))) =     \
+        { #ident, func }
+
+#endif /* BENCH_H */
@@ -0,0 +1,93 @@
+/*
+ * DMA-vs-CPU copy crossover. Settles "is DMA worth it below 64 bytes?"
+ * with numbers instead of folklore: for each size the _cpu line times
+ * memcpy and the _dma line times the full DMA round trip a driver would
+ * actually pay - configure, start, poll the FTF flag - on a DMA1
+ * mem-to-mem channel (every DMA0 request line is claimed, see
+ * lib/dma/longan_nano_dma_alloc.h; DMA1 has no peripheral bound to CH0
+ * in this project, so mem-to-mem traffic bothers nobody). Word-wide
+ * transfers, same as a driver would program for aligned buffers.
+ */
+
+#include "bench.h"
+#include "profile.h"
+#include "sram.h"
+#include "longan_nano_dma_alloc.h"
+#include "dma_arbiter.h"
+
+#include <cstring>
+
+extern "C" {
+    #include "gd32vf103.h"
+}
+
+namespace {
+
+constexpr uint32_t kMaxBytes = 256;
+constexpr uint32_t kIters = 64;
+
+SRAM_DMA_BUFFER uint8_t g_src[kMaxBytes];
+SRAM_DMA_BUFFER uint8_t g_dst[kMaxBytes];
+
+void dma_copy_once(uint32_t bytes)
+{
+    dma_parameter_struct cfg;
+    dma_channel_disable(DMA1, DMA1_BENCH_M2M_CH);
+    dma_deinit(DMA1, DMA1_BENCH_M2M_CH);
+    dma_struct_para_init(&cfg);
+    cfg.periph_addr  = (uint32_t)g_src; // m2m mode: "peripheral" side is the source
+    cfg.periph_inc   = DMA_PERIPH_INCREASE_ENABLE;
+    cfg.periph_width = DMA_PERIPHERAL_WIDTH_32BIT;
+    cfg.memory_addr  = (uint32_t)g_dst;
+    cfg.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+    cfg.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    cfg.direction    = DMA_PERIPHERAL_TO_MEMORY;
+    cfg.number       = bytes / 4U;
+    cfg.priority     = dma_arbiter_priority(DMA1, DMA1_BENCH_M2M_CH);
+    dma_init(DMA1, DMA1_BENCH_M2M_CH, &cfg);
+    dma_memory_to_memory_enable(DMA1, DMA1_BENCH_M2M_CH);
+    dma_flag_clear(DMA1, DMA1_BENCH_M2M_CH, DMA_FLAG_FTF);
+    dma_channel_enable(DMA1, DMA1_BENCH_M2M_CH);
+    while (dma_flag_get(DMA1, DMA1_BENCH_M2M_CH, DMA_FLAG_FTF) == RESET) {
+    }
+    dma_arbiter_note_start(DMA1, DMA1_BENCH_M2M_CH, bytes / 4U);
+}
+
+void run_dma(bench::Result &r, uint32_t bytes)
+{
+    rcu_periph_clock_enable(RCU_DMA1);
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        dma_copy_once(bytes);
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * bytes;
+}
+
+void run_cpu(bench::Result &r, uint32_t bytes)
+{
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        memcpy(g_dst, g_src, bytes);
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * bytes;
+}
+
+void copy16_cpu(bench::Result &r)  { run_cpu(r, 16); }
+void copy16_dma(bench::Result &r)  { run_dma(r, 16); }
+void copy64_cpu(bench::Result &r)  { run_cpu(r, 64); }
+void copy64_dma(bench::Result &r)  { run_dma(r, 64); }
+void copy256_cpu(bench::Result &r) { run_cpu(r, 256); }
+void copy256_dma(bench::Result &r) { run_dma(r, 256); }
+
+BENCH_REGISTER(copy16_cpu, copy16_cpu);
+BENCH_REGISTER(copy16_dma, copy16_dma);
+BENCH_REGISTER(copy64_cpu, copy64_cpu);
+BENCH_REGISTER(copy64_dma, copy64_dma);
+BENCH_REGISTER(copy256_cpu, copy256_cpu);
+BENCH_REGISTER(copy256_dma, copy256_dma);
+
+} // namespace
@@ -0,0 +1,81 @@
+/*
+ * SRAM copy/fill baselines. memcpy here is lib/system/memops.c (the
+ * word-wise routine the decode paths lean on); the explicit byte and
+ * word loops bracket it so a regression in memops shows up as the lib
+ * number drifting toward the byte-loop one. 256 passes over a 256-byte
+ * working set = 64 KB moved, short enough to run from the report task
+ * without a visible display hiccup.
+ */
+
+#include "bench.h"
+#include "profile.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kBlock = 256;
+constexpr uint32_t kIters = 256;
+
+alignas(4) uint8_t g_src[kBlock];
+alignas(4) uint8_t g_dst[kBlock];
+
+void memcpy_lib(bench::Result &r)
+{
+    memset(g_src, 0x5A, sizeof(g_src));
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        memcpy(g_dst, g_src, kBlock);
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * kBlock;
+}
+
+void memcpy_byte(bench::Result &r)
+{
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        volatile uint8_t *d = g_dst; // volatile keeps -O2 from folding the loop
+        const uint8_t *s = g_src;
+        for (uint32_t n = 0; n < kBlock; n++) {
+            d[n] = s[n];
+        }
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * kBlock;
+}
+
+void memcpy_word(bench::Result &r)
+{
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        volatile uint32_t *d = reinterpret_cast<uint32_t *>(g_dst);
+        const uint32_t *s = reinterpret_cast<const uint32_t *>(g_src);
+        for (uint32_t n = 0; n < kBlock / 4U; n++) {
+            d[n] = s[n];
+        }
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * kBlock;
+}
+
+void memset_lib(bench::Result &r)
+{
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        memset(g_dst, 0xA5, kBlock);
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * kBlock;
+}
+
+BENCH_REGISTER(memcpy_lib, memcpy_lib);
+BENCH_REGISTER(memcpy_byte, memcpy_byte);
+BENCH_REGISTER(memcpy_word, memcpy_word);
+BENCH_REGISTER(memset_lib, memset_lib);
+
+} // namespace
@@ -0,0 +1,240 @@
+#include "cfgstore.h"
+
+extern "C" {
+    #include "gd32vf103.h" // fmc_unlock/fmc_page_erase/fmc_word_program
+}
+
+// Region bounds provided by lib/system/GD32VF103xB.lds: two 1 KB erase
+// pages carved off the top of the code flash region.
+extern "C" const uint8_t _cfg_store[];
+extern "C" const uint8_t _ecfg_store[];
+
+namespace cfgstore {
+
+namespace {
+
+constexpr uint32_t PageBytes = 1024; // GD32VF103xB main-flash erase page
+constexpr uint32_t PageMagic = 0x31474643; // "CFG1"
+constexpr uint32_t HeaderBytes = 8;  // magic word + sequence word
+constexpr uint32_t RecordBytes = 8;
+
+// Record layout, two programming words. key_inv guards a record whose
+// first word programmed but whose second never did (power loss): the
+// complement cannot read 0xFF. check folds the value into 16 bits so a
+// bit rotted by a worn cell fails the read instead of loading quietly.
+struct Record {
+    uint8_t key;
+    uint8_t key_inv;
+    uint16_t check;
+    uint32_t value;
+};
+
+uint16_t record_check(uint8_t key, uint32_t value)
+{
+    return static_cast<uint16_t>(0xA5A5U ^ key ^ (value & 0xFFFFU)
+                                 ^ (value >> 16));
+}
+
+uintptr_t page_base(uint32_t n)
+{
+    return reinterpret_cast<uintptr_t>(_cfg_store) + n * PageBytes;
+}
+
+bool page_valid(uintptr_t base)
+{
+    const uint32_t *w = reinterpret_cast<const uint32_t *>(base);
+    return w[0] == PageMagic && w[1] != 0xFFFFFFFFU;
+}
+
+uint32_t page_seq(uintptr_t base)
+{
+    return reinterpret_cast<const uint32_t *>(base)[1];
+}
+
+// RAM cache: one word per key plus a presence bitmap, filled by the
+// boot scan and kept current by set(). get() never touches flash.
+uint32_t s_values[MaxKeys];
+uint32_t s_valid_mask = 0;
+
+uintptr_t s_active = 0;    // active page base, 0 until init() finds one
+uintptr_t s_frontier = 0;  // next record address in the active page
+uint32_t s_seq = 0;
+
+bool program_verified(uintptr_t addr, uint32_t word)
+{
+    fmc_word_program(addr, word);
+    return *reinterpret_cast<const uint32_t *>(addr) == word;
+}
+
+bool append_record(uint8_t key, uint32_t value)
+{
+    bool ok = program_verified(s_frontier,
+                  static_cast<uint32_t>(key)
+                  | (static_cast<uint32_t>(static_cast<uint8_t>(~key)) << 8)
+                  | (static_cast<uint32_t>(record_check(key, value)) << 16))
+           && program_verified(s_frontier + 4, value);
+    s_frontier += RecordBytes;
+    return ok;
+}
+
+// Scans one page's records into the cache; later records win. Returns
+// the append frontier (first erased/invalid record slot).
+uintptr_t scan_page(uintptr_t base)
+{
+    uintptr_t addr = base + HeaderBytes;
+    while (addr + RecordBytes <= base + PageBytes) {
+        const Record *r = reinterpret_cast<const Record *>(addr);
+        if (r->key == 0xFF) break; // erased: append frontier
+        if (static_cast<uint8_t>(~r->key) == r->key_inv
+            && r->key < MaxKeys
+            && r->check == record_check(r->key, r->value)) {
+            s_values[r->key] = r->value;
+            s_valid_mask |= (1U << r->key);
+        }
+        // A torn or corrupt record is skipped, not trusted as frontier:
+        // the slot is consumed either way.
+        addr += RecordBytes;
+    }
+    return addr;
+}
+
+// Copies the cache into the other page and retires the active one. The
+// header (sequence, then magic) is programmed after the records, so a
+// migration cut short by power loss never yields a valid-but-partial
+// page: init() keeps reading the old one.
+bool migrate()
+{
+    uintptr_t dst = (s_active == page_base(0)) ? page_base(1) : page_base(0);
+    fmc_unlock();
+    fmc_page_erase(dst);
+    uintptr_t addr = dst + HeaderBytes;
+    bool ok = true;
+    uintptr_t old_frontier = s_frontier;
+    s_frontier = addr;
+    for (uint8_t k = 0; k < MaxKeys; k++) {
+        if (s_valid_mask & (1U << k)) {
+            ok = append_record(k, s_values[k]) && ok;
+        }
+    }
+    if (ok) {
+        ok = program_verified(dst + 4, s_seq + 1)
+          && program_verified(dst, PageMagic);
+    }
+    if (ok) {
+        fmc_page_erase(s_active);
+        s_active = dst;
+        s_seq = s_seq + 1;
+    } else {
+        s_frontier = old_frontier; // stay on the old page, still intact
+    }
+    fmc_lock();
+    return ok;
+}
+
+// Erases page 0 and stamps it as the empty active page.
+bool format()
+{
+    fmc_unlock();
+    fmc_page_erase(page_base(0));
+    bool ok = program_verified(page_base(0) + 4, 1)
+           && program_verified(page_base(0), PageMagic);
+    fmc_lock();
+    s_active = page_base(0);
+    s_frontier = page_base(0) + HeaderBytes;
+    s_seq = 1;
+    return ok;
+}
+
+} // namespace
+
+void init()
+{
+    s_valid_mask = 0;
+    bool v0 = page_valid(page_base(0));
+    bool v1 = page_valid(page_base(1));
+    if (!v0 && !v1) {
+        // First boot or erased part: no page, every key absent. The
+        // first set() formats; boot stays a pure read.
+        s_active = 0;
+        return;
+    }
+    if (v0 && v1) {
+        // Both valid means a migration erased neither yet (it erases
+        // the source last) - the higher sequence is the destination
+        // and carries everything the source did.
+        s_active = (page_seq(page_base(1)) > page_seq(page_base(0)))
+                       ? page_base(1) : page_base(0);
+    } else {
+        s_active = v0 ? page_base(0) : page_base(1);
+    }
+    s_seq = page_seq(s_active);
+    s_frontier = scan_page(s_active);
+    if (v0 && v1) {
+        // Finish the interrupted rotation so the next one has a clean
+        // target.
+        uintptr_t stale = (s_active == page_base(0)) ? page_base(1)
+                                                    : page_base(0);
+        fmc_unlock();
+        fmc_page_erase(stale);
+        fmc_lock();
+    }
+}
+
+bool get(uint8_t key, uint32_t &value)
+{
+    if (key >= MaxKeys || !(s_valid_mask & (1U << key))) {
+        return false;
+    }
+    value = s_values[key];
+    return true;
+}
+
+uint32_t get_or(uint8_t key, uint32_t fallback)
+{
+    uint32_t v;
+    return get(key, v) ? v : fallback;
+}
+
+bool set(uint8_t key, uint32_t value)
+{
+    if (key >= MaxKeys) {
+        return false;
+    }
+    if ((s_valid_mask & (1U << key)) && s_values[key] == value) {
+        return true; // no flash traffic for a no-op set
+    }
+    if (s_active == 0 && !format()) {
+        return false;
+    }
+    // Update the cache first: a full page migrates the cache, which
+    // must already carry the new value.
+    s_values[key] = value;
+    s_valid_mask |= (1U << key);
+    if (s_frontier + RecordBytes > s_active + PageBytes) {
+        return migrate();
+    }
+    fmc_unlock();
+    bool ok = append_record(key, value);
+    fmc_lock();
+    return ok;
+}
+
+void wipe()
+{
+    fmc_unlock();
+    fmc_page_erase(page_base(0));
+    fmc_page_erase(page_base(1));
+    fmc_lock();
+    s_valid_mask = 0;
+    s_active = 0;
+    s_frontier = 0;
+    s_seq = 0;
+}
+
+uint32_t used()
+{
+    return (s_active == 0)
+               ? 0 : static_cast<uint32_t>(s_frontier - s_active - HeaderBytes);
+}
+
+} // namespace cfgstore
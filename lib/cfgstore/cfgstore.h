@@ -0,0 +1,59 @@
+#ifndef CFGSTORE_H
+#define CFGSTORE_H
+
+#include <cstdint>
+
+/**
+ * @brief Wear-leveled key-value store in two reserved flash pages.
+ *
+ * Runtime tunables set over the console used to vanish on reboot, so
+ * every per-unit adjustment meant a rebuild. The store keeps up to
+ * MaxKeys 32-bit values in the `cfg` flash region (two 1 KB erase
+ * pages, see GD32VF103xB.lds): writes append fixed 8-byte records to
+ * the active page, so a value change costs two FMC word programs and
+ * no erase until the page fills. On overflow the latest value of every
+ * key migrates to the other page and the old one is erased - the
+ * classic two-page EEPROM-emulation rotation, which spreads erase wear
+ * across both pages and survives power loss at any step (the new
+ * page's header is programmed last, so a torn migration leaves the old
+ * page authoritative).
+ *
+ * init() makes the one pass over the active page and fills a RAM
+ * cache; after that get() is an array read, cheap enough for ISR
+ * context, and boot configuration costs one flash scan and no SD
+ * traffic. Key meanings belong to the project (see src/tuning.h in
+ * prj_usb_composite); this layer only moves numbered words.
+ *
+ * Single-writer: set(), wipe() and init() run from main-loop context
+ * only. FMC programming stalls the bus for the duration of the word
+ * write, the same cost the asset store already pays.
+ */
+namespace cfgstore {
+
+constexpr uint8_t MaxKeys = 32; // valid keys are 0 .. MaxKeys-1
+
+// One pass over the active page into the RAM cache. Call once at boot,
+// before anything reads a tunable; finding no valid page (first boot,
+// erased part) leaves every key absent.
+void init();
+
+// Cached read; false when the key was never set.
+bool get(uint8_t key, uint32_t &value);
+
+// Cached read with a default for absent keys.
+uint32_t get_or(uint8_t key, uint32_t fallback);
+
+// Appends a record (no-op when the stored value already matches, so
+// repeated sets do not eat the page). False on a bad key or when the
+// FMC write failed verification.
+bool set(uint8_t key, uint32_t value);
+
+// Erases both pages and the cache - factory reset.
+void wipe();
+
+// Record bytes consumed in the active page, for wear visibility.
+uint32_t used();
+
+} // namespace cfgstore
+
+#endif /* CFGSTORE_H */
@@ -6,26 +6,130 @@ components = {
         "include_paths": [r"-Isdcard"],
         "enabled": True,
     },
+    "alloc": {
+        "c_sources": [r"alloc/alloc.c"],
+        "cpp_sources": [r"alloc/alloc_new.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Ialloc"],
+        "enabled": True,
+    },
+    "ring": {
+        "c_sources": [],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Iring"],
+        "enabled": True,
+    },
+    "coro": {
+        "c_sources": [],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Icoro", r"-Ialloc"],
+        "enabled": True,
+    },
+    "i2c": {
+        "c_sources": [r"i2c/i2c_master.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Ii2c"],
+        "enabled": True,
+    },
+    "fatfs": {
+        "c_sources": [r"fatfs/src/ff.c", r"fatfs/src/diskio.c", r"fatfs/src/ff_stream.c",
+                      r"fatfs/src/ff_cache.c", r"fatfs/src/ffsystem.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Ifatfs/inc"],
+        "enabled": True,
+    },
+    "cfgstore": {
+        "c_sources": [],
+        "cpp_sources": [r"cfgstore/cfgstore.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Icfgstore"],
+        "enabled": True,
+    },
+    "bench": {
+        "c_sources": [],
+        "cpp_sources": [r"bench/bench.cpp", r"bench/bench_mem.cpp",
+                        r"bench/bench_dma.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Ibench", r"-Isystem", r"-Idma", r"-Itinyfmt"],
+        "enabled": True,
+    },
+    "shell": {
+        "c_sources": [],
+        "cpp_sources": [r"shell/shell.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Ishell", r"-Iring"],
+        "enabled": True,
+    },
+    "overlay": {
+        "c_sources": [],
+        "cpp_sources": [r"overlay/overlay.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Ioverlay"],
+        "enabled": True,
+    },
+    "tinyfmt": {
+        "c_sources": [r"tinyfmt/tinyfmt.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Itinyfmt"],
+        "enabled": True,
+    },
+    "dma": {
+        "c_sources": [r"dma/dma_arbiter.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Idma"],
+        "enabled": True,
+    },
     "debug_uart0": {
         "c_sources": [],
         "cpp_sources": [],
         "asm_sources": [r"debug_uart0/debug_write.cpp"],
-        "include_paths": [],
+        "include_paths": [r"-Idebug_uart0", r"-Idma"],
         "enabled": True,
     },
     "system": {
         "c_sources": [r"system/system_gd32vf103.c", r"system/init.c",
-                       r"system/handlers.c", r"system/systick.c",],
+                       r"system/handlers.c", r"system/systick.c",
+                       r"system/vectors.c", r"system/irq_map.c",
+                       r"system/memops.c", r"system/deferred.c",
+                       r"system/memwatch.c", r"system/postmortem.c",
+                       r"system/bootmark.c",],
         "cpp_sources": [],
         "asm_sources": [r"system/entry.S", r"system/start.S"],
         "include_paths": [r"-Isystem"],
         "enabled": True,
     },
+    "fixtab": {
+        "c_sources": [],
+        "cpp_sources": [r"fixtab/fixtab_tables.cpp"],
+        "asm_sources": [],
+        "include_paths": [r"-Ifixtab"],
+        "enabled": True,
+    },
+    "lcd_font":{
+        "c_sources": [r"lcd_font/src/lcd_font.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Ilcd_font/include"],
+        "enabled": True,
+    },
+    "lcd_text":{
+        "c_sources": [r"lcd_text/src/lcd_text.c"],
+        "cpp_sources": [],
+        "asm_sources": [],
+        "include_paths": [r"-Ilcd_text/include"],
+        "enabled": True,
+    },
     "gd32_lcd":{
         "c_sources": [r"gd32v_lcd/src/lcd.c"],
         "cpp_sources": [],
         "asm_sources": [],
-        "include_paths": [r"-Igd32v_lcd/include"],
+        "include_paths": [r"-Igd32v_lcd/include", r"-Idma"],
         "enabled": True,
     },
 }
\ No newline at end of file
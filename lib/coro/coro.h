@@ -0,0 +1,111 @@
+#ifndef CORO_H
+#define CORO_H
+
+#include <coroutine>
+#include <cstdint>
+#include <cstddef>
+
+extern "C" {
+#include "alloc.h"
+#include "riscv_encoding.h"
+}
+
+/**
+ * @brief Heap-free coroutine primitives for DMA-overlapped sequences.
+ *
+ * Multi-step transfers in this tree chain completion callbacks: start a
+ * card read, hop to the DMA interrupt, start the next step from there,
+ * hop again. Each hop scatters one sequence across several functions
+ * plus the flags that glue them together, and every new step grows the
+ * state machine. A coroutine keeps the same interleaving - the code
+ * still parks at every transfer and resumes from the completion
+ * interrupt - but the sequence reads top to bottom in one function and
+ * its state lives in the frame instead of in hand-named statics.
+ *
+ * Frames come from the fixed block pools in lib/alloc (pool_alloc is
+ * ISR-safe and O(1)); there is never a heap allocation, and exhaustion
+ * surfaces as task::started == false so the caller can take its
+ * synchronous fallback. await_resume runs in the context that called
+ * signal() - for DMA events that is the transfer-complete interrupt, so
+ * code between awaits must stay as short as an ISR callback would be.
+ */
+namespace coro {
+
+/**
+ * Detached coroutine: runs eagerly until its first co_await, and the
+ * frame frees itself when the body returns. The handle is not kept -
+ * completion is reported the way the wrapped drivers already do it,
+ * through whatever callback or flag the body touches last.
+ */
+struct task {
+    struct promise_type {
+        static void *operator new(size_t size) noexcept { return pool_alloc(size); }
+        static void operator delete(void *p) noexcept { pool_free(p); }
+        // Pool exhausted: no frame, the body never runs.
+        static task get_return_object_on_allocation_failure() noexcept {
+            return task{false};
+        }
+        task get_return_object() noexcept { return task{true}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {} // -fno-exceptions build
+    };
+
+    // false when the frame pool could not serve the frame; the body has
+    // not started and never will, so take the non-coroutine path.
+    bool started;
+};
+
+/**
+ * Single-waiter completion event carrying an int32_t result (wide
+ * enough for DRESULT and the other driver status enums).
+ *
+ * The awaiting coroutine parks in await_suspend; signal() hands it the
+ * result and resumes it inline, in the caller's context. A signal with
+ * no waiter parked is latched, so the completion racing ahead of the
+ * co_await (DMA finishing before the starter returns) is not lost.
+ * One outstanding waiter at a time - matching the wrapped drivers,
+ * which allow one transfer in flight anyway.
+ */
+class event {
+public:
+    bool await_ready() noexcept { return false; } // race handled in suspend
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        uint32_t mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+        bool park = !m_signalled;
+        if (park) {
+            m_waiter = h;
+        }
+        m_signalled = false;
+        if (mie) set_csr(mstatus, MSTATUS_MIE);
+        return park; // false = already signalled, continue immediately
+    }
+    int32_t await_resume() noexcept { return m_value; }
+
+    /** Completion side; safe from interrupt context. Resumes a parked
+     *  waiter before returning, so everything the coroutine does up to
+     *  its next co_await runs on this call stack. */
+    void signal(int32_t value) {
+        uint32_t mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+        m_value = value;
+        std::coroutine_handle<> h = m_waiter;
+        m_waiter = nullptr;
+        if (!h) {
+            m_signalled = true; // latch: the co_await has not parked yet
+        }
+        if (mie) set_csr(mstatus, MSTATUS_MIE);
+        if (h) {
+            h.resume();
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_waiter = nullptr;
+    volatile bool m_signalled = false;
+    int32_t m_value = 0;
+};
+
+} // namespace coro
+
+#endif // CORO_H
@@ -0,0 +1,35 @@
+/*!
+    \file    debug_uart.h
+    \brief   Public interface of the asynchronous debug UART.
+
+    printf output is buffered in a ring and drained in the background by
+    the USART0 transmit interrupt, so logging no longer stalls the
+    caller for the wire time of the message. When the ring is full, new
+    bytes are dropped (never the backlog) and counted.
+*/
+
+#ifndef DEBUG_UART_H
+#define DEBUG_UART_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bring up USART0 and the background drain. Called from system init. */
+void initialise_debug_uart(void);
+
+/* Bytes discarded because the ring was full. Monotonic; a rising value
+   means logs are being produced faster than 115200 baud drains them. */
+uint32_t debug_uart_dropped(void);
+
+/* Blocking drain of everything queued, bypassing the interrupt. For
+   panic paths and the moment before a reset; safe with interrupts off. */
+void debug_uart_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEBUG_UART_H */
@@ -4,14 +4,49 @@ extern "C" {
 
 #include "gd32vf103.h"
 #include "systick.h"
+#include "n200_func.h"
+#include "riscv_encoding.h"
+#include "debug_uart.h"
 int _write(int file, char *ptr, int len);
-void initialise_debug_uart(void);
+void USART0_IRQHandler(void);
 }
 
+// Pulls in the compile-time DMA claim registry; this TU is built into
+// every project, so conflicting claims fail every build, not just the
+// project that happens to include the offending driver.
+#include "longan_nano_dma_alloc.h"
+
 void inline usart0_config(void);
 
+// --- Asynchronous transmit ring ---
+// _write() used to poll TBE for every byte, so one printf stalled the
+// caller for the full wire time of the message (~87 us per byte at
+// 115200 baud - milliseconds for a line). Output now lands in this ring
+// and the USART0 TBE interrupt drains it in the background.
+//
+// Note on DMA: USART0_TX's only DMA request line is DMA0 channel 3,
+// which the SD card driver owns for SPI1_RX, so the drain is interrupt
+// driven instead. At 115200 baud that is one short interrupt per ~87 us
+// while a message is in flight, which is noise next to the stall it
+// replaces.
+namespace {
+
+constexpr uint32_t TX_RING_SIZE = 1024; // power of two
+constexpr uint32_t TX_RING_MASK = TX_RING_SIZE - 1;
+
+char tx_ring[TX_RING_SIZE];
+volatile uint32_t tx_head = 0; // producer (only _write advances)
+volatile uint32_t tx_tail = 0; // consumer (only the ISR advances)
+volatile uint32_t tx_dropped = 0;
+
+} // End anonymous namespace
+
 void initialise_debug_uart(void) {
     usart0_config();
+    // The transmit interrupt is armed by _write whenever there is data
+    // to drain; here it only needs routing. Keep it below the SD DMA
+    // interrupts so logging never delays a transfer chain.
+    eclic_enable_interrupt(USART0_IRQn); // level/priority: lib/system/irq_map.c
 }
 
 /**
@@ -68,28 +103,63 @@ void inline usart0_config(void)
 
 /**
  * @brief      Retargets the C library `printf` function to USART0.
- * @details    This function is a standard C library hook. When `printf` is called,
- *             the C library eventually calls this `_write` function to output the
- *             formatted string. We implement it here to send the characters
- *             one by one over USART0.
+ * @details    Copies the message into the transmit ring and arms the TBE
+ *             interrupt to drain it; the call returns as soon as the
+ *             bytes are queued. printf is used from interrupt handlers
+ *             too, so the enqueue masks interrupts to keep concurrent
+ *             writers from interleaving their ring updates. If the ring
+ *             is full the excess bytes are dropped and counted - a
+ *             debug channel must never stall or wedge the device.
  * @param[in]  file: File descriptor (unused).
  * @param[in]  ptr: Pointer to the buffer of characters to write.
  * @param[in]  len: The number of characters to write.
- * @retval     The number of characters successfully written.
+ * @retval     The number of characters accepted (dropped bytes included,
+ *             so the C library does not retry them).
  */
 int _write(int file, char *ptr, int len)
 {
     (void)file; // Unused parameter, silence compiler warning
-    int i;
-    for (i = 0; i < len; i++) {
-        // Send the character.
-        usart_data_transmit(USART0, (uint8_t)ptr[i]);
-        // Wait until the data has been transmitted.
-        // The USART_FLAG_TBE (Transmit Buffer Empty) flag is set by hardware
-        // when the transmit shift register is empty and ready for new data.
-        // Polling this flag ensures we don't try to send a new character
-        // before the previous one has finished sending.
-        while (usart_flag_get(USART0, USART_FLAG_TBE) == RESET);
+    uint32_t mie = clear_csr(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+    for (int i = 0; i < len; i++) {
+        uint32_t next = (tx_head + 1) & TX_RING_MASK;
+        if (next == tx_tail) {
+            tx_dropped += (uint32_t)(len - i); // ring full: drop the rest
+            break;
+        }
+        tx_ring[tx_head] = ptr[i];
+        tx_head = next;
     }
+    if (mie) set_csr(mstatus, MSTATUS_MIE);
+    usart_interrupt_enable(USART0, USART_INT_TBE);
     return len;
-}
\ No newline at end of file
+}
+
+uint32_t debug_uart_dropped(void)
+{
+    return tx_dropped;
+}
+
+void debug_uart_flush(void)
+{
+    usart_interrupt_disable(USART0, USART_INT_TBE);
+    while (tx_tail != tx_head) {
+        while (usart_flag_get(USART0, USART_FLAG_TBE) == RESET);
+        usart_data_transmit(USART0, (uint8_t)tx_ring[tx_tail]);
+        tx_tail = (tx_tail + 1) & TX_RING_MASK;
+    }
+    // Let the last byte clear the shift register before e.g. a reset.
+    while (usart_flag_get(USART0, USART_FLAG_TC) == RESET);
+}
+
+void USART0_IRQHandler(void)
+{
+    if (usart_interrupt_flag_get(USART0, USART_INT_FLAG_TBE) != RESET) {
+        if (tx_tail == tx_head) {
+            // Ring drained; stop the interrupt until _write re-arms it.
+            usart_interrupt_disable(USART0, USART_INT_TBE);
+        } else {
+            usart_data_transmit(USART0, (uint8_t)tx_ring[tx_tail]);
+            tx_tail = (tx_tail + 1) & TX_RING_MASK;
+        }
+    }
+}
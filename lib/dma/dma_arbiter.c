@@ -0,0 +1,97 @@
+/*!
+    \file    dma_arbiter.c
+    \brief   central DMA channel priority policy and per-channel traffic counters
+*/
+
+#include "dma_arbiter.h"
+#include "longan_nano_dma_alloc.h"
+
+/* ------------------------------------------------------------------ */
+/* Priority policy                                                    */
+/* ------------------------------------------------------------------ */
+
+/* One row per channel whose level matters; everything else defaults to
+   DMA_PRIORITY_LOW. Rationale:
+
+   - SPI0_TX feeds the LCD pixel stream. A stall there is a visible
+     stutter, so it outranks everything.
+   - USART1_RX runs as a circular ring with no flow control; losing the
+     arbitration for too long is data loss (ORERR), not just latency.
+   - The SD card (SPI1) is throughput bound but fully handshaked, so it
+     only slows down when it loses - MEDIUM keeps MSC writes moving
+     without starving the display.
+   - At equal software priority the hardware prefers the lower channel
+     number, which also favours the LCD (CH2) over the SD card (CH3/4). */
+typedef struct {
+    uint32_t periph;            /* DMA0 or DMA1 */
+    dma_channel_enum channel;   /* request line, see longan_nano_dma_alloc.h */
+    uint32_t priority;          /* DMA_PRIORITY_* */
+} dma_policy_entry;
+
+static const dma_policy_entry g_policy[] = {
+    {DMA0, DMA0_SPI0_TX_CH,   DMA_PRIORITY_ULTRA_HIGH},  /* LCD stream   */
+    {DMA0, DMA0_SPI0_RX_CH,   DMA_PRIORITY_HIGH},        /* LCD readback */
+    {DMA0, DMA0_USART1_RX_CH, DMA_PRIORITY_HIGH},        /* loss-prone   */
+    {DMA0, DMA0_SPI1_RX_CH,   DMA_PRIORITY_MEDIUM},      /* SD card      */
+    {DMA0, DMA0_SPI1_TX_CH,   DMA_PRIORITY_MEDIUM},      /* SD card      */
+    {DMA0, DMA0_USART1_TX_CH, DMA_PRIORITY_LOW},         /* logging      */
+    {DMA0, DMA0_ADC0_CH,      DMA_PRIORITY_LOW},         /* telemetry    */
+};
+
+#define POLICY_COUNT (sizeof(g_policy) / sizeof(g_policy[0]))
+
+/* ------------------------------------------------------------------ */
+/* Traffic counters                                                   */
+/* ------------------------------------------------------------------ */
+
+#define ARBITER_DMA0_CHANNELS 7U
+#define ARBITER_DMA1_CHANNELS 5U
+#define ARBITER_SLOTS (ARBITER_DMA0_CHANNELS + ARBITER_DMA1_CHANNELS)
+
+static volatile uint32_t g_starts[ARBITER_SLOTS];
+static volatile uint32_t g_units[ARBITER_SLOTS];
+
+/* flat counter index for a controller/channel pair */
+static uint32_t slot_index(uint32_t dma_periph, dma_channel_enum channelx)
+{
+    if (dma_periph == DMA1) {
+        return ARBITER_DMA0_CHANNELS + (uint32_t)channelx;
+    }
+    return (uint32_t)channelx;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+uint32_t dma_arbiter_priority(uint32_t dma_periph, dma_channel_enum channelx)
+{
+    uint32_t i;
+
+    for (i = 0; i < POLICY_COUNT; i++) {
+        if ((g_policy[i].periph == dma_periph) &&
+            (g_policy[i].channel == channelx)) {
+            return g_policy[i].priority;
+        }
+    }
+    return DMA_PRIORITY_LOW;
+}
+
+void dma_arbiter_note_start(uint32_t dma_periph, dma_channel_enum channelx,
+                            uint32_t units)
+{
+    uint32_t slot = slot_index(dma_periph, channelx);
+
+    g_starts[slot]++;
+    g_units[slot] += units;
+}
+
+uint32_t dma_arbiter_starts(uint32_t dma_periph, dma_channel_enum channelx)
+{
+    return g_starts[slot_index(dma_periph, channelx)];
+}
+
+uint32_t dma_arbiter_units(uint32_t dma_periph, dma_channel_enum channelx)
+{
+    return g_units[slot_index(dma_periph, channelx)];
+}
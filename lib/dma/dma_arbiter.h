@@ -0,0 +1,47 @@
+/*!
+    \file    dma_arbiter.h
+    \brief   central DMA channel priority policy and per-channel traffic counters
+
+    Channel priorities used to be whatever each driver happened to pass to
+    dma_init(), so bus contention between the LCD stream (SPI0_TX), the SD
+    card (SPI1) and UART logging was unmanaged. Drivers now ask
+    dma_arbiter_priority() for their level - the policy lives in one table
+    in dma_arbiter.c - and report each transfer they start through
+    dma_arbiter_note_start(), so starvation shows up in the counters
+    instead of only as visible stutter.
+
+    See lib/dma/longan_nano_dma_alloc.h for who owns which channel.
+*/
+
+#ifndef DMA_ARBITER_H
+#define DMA_ARBITER_H
+
+#include "gd32vf103.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* priority level (DMA_PRIORITY_*) the policy table assigns to a channel;
+   unlisted channels get DMA_PRIORITY_LOW. Pass the result straight into
+   dma_parameter_struct.priority. */
+uint32_t dma_arbiter_priority(uint32_t dma_periph, dma_channel_enum channelx);
+
+/* record that a transfer of 'units' elements was started on a channel.
+   Call from wherever the driver enables the channel (ISR context is
+   fine - each channel has a single starting context). */
+void dma_arbiter_note_start(uint32_t dma_periph, dma_channel_enum channelx,
+                            uint32_t units);
+
+/* transfers started on a channel since boot */
+uint32_t dma_arbiter_starts(uint32_t dma_periph, dma_channel_enum channelx);
+
+/* elements moved by those transfers (bytes or halfwords, whatever the
+   channel's memory width is - comparable per channel, not across them) */
+uint32_t dma_arbiter_units(uint32_t dma_periph, dma_channel_enum channelx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_ARBITER_H */
@@ -9,10 +9,108 @@
 // Device and channel definitions. This cannot be changed. This is hardware limitation
 // Refere README.md for more information.
 
+// ADC0's request line is CH0, conveniently clear of every bus below.
+#define DMA0_ADC0_CH     DMA_CH0
+
 #define DMA0_SPI0_RX_CH  DMA_CH1
 #define DMA0_SPI0_TX_CH  DMA_CH2
 
 #define DMA0_SPI1_RX_CH  DMA_CH3
 #define DMA0_SPI1_TX_CH  DMA_CH4
 
-#endif // LONGAN_NANO_DMA_ALLOC_H
\ No newline at end of file
+// USART request lines on DMA0 (also fixed by hardware). USART0_TX would
+// be DMA_CH3, which SPI1_RX owns above - that is why the debug console
+// drains by interrupt instead (see lib/debug_uart0). USART1 is free of
+// conflicts and is what prj_uart_test drives.
+#define DMA0_USART1_RX_CH  DMA_CH5
+#define DMA0_USART1_TX_CH  DMA_CH6
+
+// DMA1 has no peripheral bound to CH0 in any project here, so the
+// micro-benchmark runner (lib/bench) uses it for mem-to-mem copy
+// timing. Mem-to-mem ignores request lines entirely; any free channel
+// works, this one is just reserved so a future driver cannot collide.
+#define DMA1_BENCH_M2M_CH  DMA_CH0
+
+#ifdef __cplusplus
+// ---------------------------------------------------------------------------
+// Compile-time claim registry.
+//
+// The defines above stay the interface the C drivers use; the registry
+// below is the safety rail behind them. Every driver that programs a DMA
+// channel gets a row here, and two rows naming the same controller/channel
+// pair fail the build with a static_assert instead of fighting over the
+// channel at runtime. Everything is constexpr, so C++ consumers reading a
+// channel through dma_alloc::claimed<>() still get a bare constant.
+//
+// The check runs in any C++ translation unit that includes this header;
+// lib/debug_uart0/debug_write.cpp is built into every project and includes
+// it so the table is always evaluated.
+namespace dma_alloc {
+
+struct claim {
+    uint32_t periph;           // DMA0 or DMA1
+    dma_channel_enum channel;  // hardware-fixed request line
+    const char *owner;         // driver that programs the channel
+};
+
+// One row per request line a driver actually programs. Add the row BEFORE
+// writing the driver - the asserts below are what catch a double booking.
+constexpr claim registry[] = {
+    {DMA0, DMA0_ADC0_CH,      "telemetry: ADC0 scan ring"},
+    {DMA0, DMA0_SPI0_RX_CH,   "gd32v_lcd: SPI0 RX"},
+    {DMA0, DMA0_SPI0_TX_CH,   "gd32v_lcd: SPI0 TX"},
+    {DMA0, DMA0_SPI1_RX_CH,   "sdcard: SPI1 RX (blocks USART0_TX DMA)"},
+    {DMA0, DMA0_SPI1_TX_CH,   "sdcard: SPI1 TX"},
+    {DMA0, DMA0_USART1_RX_CH, "prj_uart_test: USART1 RX"},
+    {DMA0, DMA0_USART1_TX_CH, "prj_uart_test: USART1 TX"},
+    {DMA1, DMA1_BENCH_M2M_CH, "bench: mem-to-mem copy timing"},
+};
+
+constexpr uint32_t registry_size = sizeof(registry) / sizeof(registry[0]);
+
+// index of the first registry row whose channel a later row claims again,
+// or registry_size when the table is conflict free
+constexpr uint32_t first_conflict()
+{
+    for (uint32_t i = 0; i < registry_size; i++) {
+        for (uint32_t j = i + 1; j < registry_size; j++) {
+            if ((registry[i].periph == registry[j].periph) &&
+                (registry[i].channel == registry[j].channel)) {
+                return i;
+            }
+        }
+    }
+    return registry_size;
+}
+
+static_assert(first_conflict() == registry_size,
+              "longan_nano_dma_alloc.h: two registry rows claim the same DMA "
+              "channel - compare the owner strings starting at the row "
+              "first_conflict() returns");
+
+// true when <periph, channel> has a row in the registry
+constexpr bool is_claimed(uint32_t periph, dma_channel_enum channel)
+{
+    for (uint32_t i = 0; i < registry_size; i++) {
+        if ((registry[i].periph == periph) && (registry[i].channel == channel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Channel accessor for C++ drivers: refuses to compile for a channel that
+// has no registry row, and folds to the bare enum constant otherwise.
+template <uint32_t Periph, dma_channel_enum Channel>
+constexpr dma_channel_enum claimed()
+{
+    static_assert(is_claimed(Periph, Channel),
+                  "DMA channel has no claim row in longan_nano_dma_alloc.h - "
+                  "register it before programming the channel");
+    return Channel;
+}
+
+} // namespace dma_alloc
+#endif // __cplusplus
+
+#endif // LONGAN_NANO_DMA_ALLOC_H
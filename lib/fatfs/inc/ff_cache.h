@@ -0,0 +1,71 @@
+/*!
+    \file    ff_cache.h
+    \brief   SRAM sector cache for FatFs metadata.
+
+    FatFs reads metadata - FAT sectors, directory sectors, the boot
+    sector - strictly one sector at a time through its window buffer,
+    and it re-reads them constantly: a directory enumeration revisits
+    the same directory sectors per f_readdir call, and resolving a path
+    on every log rotation walks the same FAT and directory chain again.
+    Each revisit used to be a full SD round trip.
+
+    This layer sits under diskio.c and keeps the most recently used
+    single-sector reads in SRAM (the SRAM_CACHE region, first thing to
+    shrink under pressure). Multi-sector transfers - file data moving
+    through the streaming path - bypass it untouched, so the held-open
+    CMD18/CMD25 sequential streams are unaffected. Writes go through to
+    the card and update or evict the cached copy, and disk_initialize
+    drops everything, so a hot-swapped card never serves stale sectors.
+
+    For cluster chains of individual hot files, FF_USE_FASTSEEK is also
+    enabled: point FIL::cltbl at a DWORD array and the first f_lseek
+    builds an in-RAM link map that removes FAT reads from later seeks.
+*/
+
+#ifndef FF_CACHE_H
+#define FF_CACHE_H
+
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cached sectors; 8 x FF_MAX_SS = 4 KB covers a FAT sector, a couple of
+   directory sectors and the boot sector with room to spare. */
+#ifndef FF_CACHE_SECTORS
+#define FF_CACHE_SECTORS 8
+#endif
+
+/* Copies a cached sector into buff. Returns 1 on a hit, 0 on a miss. */
+int  ff_cache_read (DWORD sector, BYTE *buff);
+
+/* Files a sector just read from the card, evicting the least recently
+   used entry. */
+void ff_cache_fill (DWORD sector, const BYTE *buff);
+
+/* Keeps a cached copy coherent with a write-through: updates the entry
+   if the sector is cached, otherwise does nothing (a written sector is
+   not worth caching until something reads it back). */
+void ff_cache_update (DWORD sector, const BYTE *buff);
+
+/* Drops any cached copies in [sector, sector + count). */
+void ff_cache_invalidate (DWORD sector, UINT count);
+
+/* Drops everything; called on media (re)initialization. */
+void ff_cache_invalidate_all (void);
+
+/* Free-running lookup/hit counters for the stats channel; monitoring
+   works on deltas, wrap is harmless. */
+typedef struct {
+    DWORD lookups;
+    DWORD hits;
+} ff_cache_stats_t;
+
+const ff_cache_stats_t *ff_cache_stats (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FF_CACHE_H */
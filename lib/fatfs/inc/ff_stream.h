@@ -0,0 +1,71 @@
+/*!
+    \file    ff_stream.h
+    \brief   Cluster-streaming file I/O on top of FatFs.
+
+    f_read_stream/f_write_stream move file data in whole clusters per
+    card command: FatFs already issues one disk_read/disk_write per
+    cluster when the caller's buffer can take it directly, and the
+    sd-backed disk layer keeps one multi-block card command open across
+    those calls for as long as the sectors stay sequential. The result
+    is that an unfragmented file streams at the SPI wire rate.
+*/
+
+#ifndef FF_STREAM_H
+#define FF_STREAM_H
+
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Read up to btr bytes into buff. For cluster-per-command transfers the
+   buffer should be at least one cluster and btr a multiple of the
+   sector size; misaligned head/tail bytes fall back to FatFs's
+   sector-buffered path automatically. */
+FRESULT f_read_stream (FIL* fp, void* buff, UINT btr, UINT* br);
+
+#if FF_FS_READONLY == 0
+/* Write counterpart; same alignment guidance as f_read_stream. */
+FRESULT f_write_stream (FIL* fp, const void* buff, UINT btw, UINT* bw);
+#endif
+
+#if FF_USE_EXPAND && !FF_FS_READONLY
+/* --- Contiguous append-log writer ---
+
+   Small-record appenders (the telemetry logger) pay a FAT-chain walk
+   and directory churn per f_write once a file grows past a cluster.
+   FLOG removes the file system from the hot path instead: f_log_open
+   preallocates a contiguous region with f_expand, so every sector of
+   the file follows from the start cluster alone, and f_log_append
+   writes completed sectors straight through disk_write -- sequential
+   batches continue the sd layer's held-open CMD25. Append cost is
+   O(data appended) regardless of file length.
+
+   Partial tail bytes stage in buf until their sector completes;
+   f_log_sync pushes the staged tail and commits the logical size and
+   directory entry through f_sync (one metadata write, no chain walk).
+   Appends beyond the preallocated region are refused with FR_DENIED:
+   size the region for the run and rotate files, which is also what
+   keeps the FAT itself nearly write-free for flash wear. */
+typedef struct {
+    FIL     fil;        /* underlying file, kept open for the metadata */
+    DWORD   start_sect; /* first sector of the preallocated region */
+    DWORD   next_sect;  /* sector the next completed sector lands in */
+    DWORD   end_sect;   /* one past the preallocated region */
+    FSIZE_t size;       /* logical bytes appended so far */
+    UINT    fill;       /* bytes staged in buf (partial tail sector) */
+    BYTE    buf[FF_MAX_SS];
+} FLOG;
+
+FRESULT f_log_open (FLOG* lp, const TCHAR* path, FSIZE_t prealloc);
+FRESULT f_log_append (FLOG* lp, const void* buff, UINT btw);
+FRESULT f_log_sync (FLOG* lp);
+FRESULT f_log_close (FLOG* lp);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FF_STREAM_H */
@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------------*/
+/* Low level disk I/O module for FatFs, backed by the sd_card driver     */
+/*-----------------------------------------------------------------------*/
+/* Glue between the FatFs disk interface and lib/sdcard. Reads and       */
+/* writes go through the driver's sequential streams, so FatFs's        */
+/* cluster-at-a-time disk_read/disk_write calls on an unfragmented file */
+/* continue one held-open CMD18/CMD25 instead of paying command latency */
+/* per cluster.                                                         */
+
+#include "ff.h"
+#include "diskio.h"
+#include "ff_cache.h"
+
+/* sd_card.h carries its own copies of the FatFs-compatible DSTATUS and
+   DRESULT types so the driver can stand alone; including it next to
+   diskio.h would redefine them. Declare the entry points with the FatFs
+   types instead - the two sets are layout-identical by design. */
+extern DSTATUS sd_init(void);
+extern DSTATUS sd_status(void);
+extern DRESULT sd_read_stream(BYTE *buff, DWORD sector, UINT count);
+extern void    sd_read_stream_stop(void);
+extern DRESULT sd_write_stream(const BYTE *buff, DWORD sector, UINT count);
+extern void    sd_write_stream_stop(void);
+extern DRESULT sd_ioctl(BYTE cmd, void *buff);
+
+DSTATUS disk_initialize (BYTE pdrv)
+{
+    if (pdrv != 0) return STA_NOINIT;
+    /* The card may have been swapped since the cache was filled. */
+    ff_cache_invalidate_all();
+    return sd_init();
+}
+
+DSTATUS disk_status (BYTE pdrv)
+{
+    if (pdrv != 0) return STA_NOINIT;
+    return sd_status();
+}
+
+DRESULT disk_read (BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+    if (pdrv != 0) return RES_PARERR;
+    /* FatFs fetches metadata (FAT, directory and boot sectors) strictly
+       one sector at a time through its window buffer; serve those from
+       the SRAM cache when possible. Multi-sector transfers are file
+       data on the streaming path and bypass the cache untouched. */
+    if (count == 1) {
+        if (ff_cache_read(sector, buff)) return RES_OK;
+        DRESULT res = sd_read_stream(buff, sector, count);
+        if (res == RES_OK) ff_cache_fill(sector, buff);
+        return res;
+    }
+    /* Multi-block read; sequential calls ride one held-open CMD18. A
+       non-sequential sector (or any write / ioctl) closes it first. */
+    return sd_read_stream(buff, sector, count);
+}
+
+#if FF_FS_READONLY == 0
+DRESULT disk_write (BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+    if (pdrv != 0) return RES_PARERR;
+    /* Multi-block write over a held-open CMD25; the stop-token/busy
+       cycle is paid once per sequential run instead of per call. */
+    DRESULT res = sd_write_stream(buff, sector, count);
+    if (res == RES_OK) {
+        /* Keep the cache coherent with the write-through: a flushed
+           metadata sector updates in place, bulk data just evicts. */
+        if (count == 1) ff_cache_update(sector, buff);
+        else            ff_cache_invalidate(sector, count);
+    }
+    return res;
+}
+#endif
+
+DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void *buff)
+{
+    if (pdrv != 0) return RES_PARERR;
+    /* The driver understands the generic FatFs command codes (and
+       returns RES_PARERR for the rest). It also finalizes any open
+       stream first, which is exactly what CTRL_SYNC requires. */
+    return sd_ioctl(cmd, buff);
+}
+
+void disk_stream_release (void)
+{
+    sd_read_stream_stop();
+    sd_write_stream_stop();
+}
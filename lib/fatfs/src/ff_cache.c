@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------------*/
+/* SRAM sector cache for FatFs metadata; see ff_cache.h                  */
+/*-----------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "ff.h"
+#include "ff_cache.h"
+#include "sram.h"
+
+#define INVALID_SECTOR 0xFFFFFFFFUL
+
+/* The payload lives in the named cache region so the linker script's
+   budget ASSERT accounts for it; the tags stay in ordinary .bss. */
+static BYTE cache_data[FF_CACHE_SECTORS][FF_MAX_SS] SRAM_CACHE;
+static DWORD cache_sector[FF_CACHE_SECTORS] = {
+    [0 ... FF_CACHE_SECTORS - 1] = INVALID_SECTOR
+};
+/* Last-touch stamps for LRU; a linear scan over 8 entries is cheaper
+   than list maintenance at this size. */
+static DWORD cache_stamp[FF_CACHE_SECTORS];
+static DWORD stamp_clock;
+
+static ff_cache_stats_t stats;
+
+static int find_slot (DWORD sector)
+{
+    for (int i = 0; i < FF_CACHE_SECTORS; i++) {
+        if (cache_sector[i] == sector) return i;
+    }
+    return -1;
+}
+
+int ff_cache_read (DWORD sector, BYTE *buff)
+{
+    stats.lookups++;
+    int slot = find_slot(sector);
+    if (slot < 0) return 0;
+    stats.hits++;
+    cache_stamp[slot] = ++stamp_clock;
+    memcpy(buff, cache_data[slot], FF_MAX_SS);
+    return 1;
+}
+
+void ff_cache_fill (DWORD sector, const BYTE *buff)
+{
+    int slot = find_slot(sector);
+    if (slot < 0) {
+        slot = 0;
+        for (int i = 1; i < FF_CACHE_SECTORS; i++) {
+            if (cache_stamp[i] < cache_stamp[slot]) slot = i;
+        }
+        cache_sector[slot] = sector;
+    }
+    cache_stamp[slot] = ++stamp_clock;
+    memcpy(cache_data[slot], buff, FF_MAX_SS);
+}
+
+void ff_cache_update (DWORD sector, const BYTE *buff)
+{
+    int slot = find_slot(sector);
+    if (slot < 0) return;
+    cache_stamp[slot] = ++stamp_clock;
+    memcpy(cache_data[slot], buff, FF_MAX_SS);
+}
+
+void ff_cache_invalidate (DWORD sector, UINT count)
+{
+    for (int i = 0; i < FF_CACHE_SECTORS; i++) {
+        if (cache_sector[i] - sector < count) {
+            cache_sector[i] = INVALID_SECTOR;
+        }
+    }
+}
+
+void ff_cache_invalidate_all (void)
+{
+    for (int i = 0; i < FF_CACHE_SECTORS; i++) {
+        cache_sector[i] = INVALID_SECTOR;
+    }
+}
+
+const ff_cache_stats_t *ff_cache_stats (void)
+{
+    return &stats;
+}
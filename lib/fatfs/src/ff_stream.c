@@ -0,0 +1,144 @@
+/*!
+    \file    ff_stream.c
+    \brief   Cluster-streaming file I/O on top of FatFs.
+*/
+
+#include "ff_stream.h"
+#include "diskio.h"
+#include <string.h>
+
+FRESULT f_read_stream (FIL* fp, void* buff, UINT btr, UINT* br)
+{
+    /* f_read moves every whole sector of the request directly between
+       the card and the caller's buffer, one cluster per disk_read call;
+       the sd-backed disk layer merges those sequential calls into one
+       held-open CMD18. This entry point pins that contract for call
+       sites (and gives the policy a place to change without touching
+       them); only misaligned head/tail bytes go through the FIL sector
+       buffer. */
+    return f_read(fp, buff, btr, br);
+}
+
+#if FF_FS_READONLY == 0
+FRESULT f_write_stream (FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+    /* Same shape as f_read_stream: whole sectors bypass the FIL buffer
+       and sequential clusters continue one held-open CMD25, so the
+       stop-token/busy cycle is paid once per run. */
+    return f_write(fp, buff, btw, bw);
+}
+#endif
+
+#if FF_USE_EXPAND && !FF_FS_READONLY
+/*-----------------------------------------------------------------------*/
+/* Contiguous append-log writer                                          */
+/*-----------------------------------------------------------------------*/
+
+/* Mirrors ff.c's internal FA_MODIFIED: f_sync only rewrites the
+   directory entry when this flag is set, and the appends here go
+   around the FIL entirely, so the flag has to be raised by hand
+   before committing the logical size. */
+#define FLOG_FA_MODIFIED    0x40
+
+#if FF_MAX_SS == FF_MIN_SS
+#define FLOG_SS(fs)         ((UINT)FF_MAX_SS)
+#else
+#define FLOG_SS(fs)         ((UINT)(fs)->ssize)
+#endif
+
+FRESULT f_log_open (FLOG* lp, const TCHAR* path, FSIZE_t prealloc)
+{
+    FRESULT res;
+    FATFS* fs;
+    UINT ss;
+    DWORD clsz, tcl;
+
+    if (prealloc == 0) return FR_INVALID_PARAMETER;
+    res = f_open(&lp->fil, path, FA_WRITE | FA_CREATE_ALWAYS);
+    if (res != FR_OK) return res;
+    res = f_expand(&lp->fil, prealloc, 1);  /* allocate the region now */
+    if (res != FR_OK) {
+        f_close(&lp->fil);
+        return res;
+    }
+    fs = lp->fil.obj.fs;
+    ss = FLOG_SS(fs);
+    clsz = (DWORD)fs->csize * ss;
+    tcl = (DWORD)(prealloc / clsz) + ((prealloc % clsz) ? 1 : 0);
+    /* Every sector of the region follows from the start cluster: the
+       FAT is never consulted again until close. */
+    lp->start_sect = fs->database + (DWORD)fs->csize * (lp->fil.obj.sclust - 2);
+    lp->next_sect  = lp->start_sect;
+    lp->end_sect   = lp->start_sect + tcl * fs->csize;
+    lp->size = 0;
+    lp->fill = 0;
+    return FR_OK;
+}
+
+FRESULT f_log_append (FLOG* lp, const void* buff, UINT btw)
+{
+    const BYTE* p = (const BYTE*)buff;
+    FATFS* fs = lp->fil.obj.fs;
+    UINT ss = FLOG_SS(fs);
+    UINT n;
+
+    if (lp->fil.obj.fs == 0) return FR_INVALID_OBJECT;
+    if (lp->size + btw > (FSIZE_t)(lp->end_sect - lp->start_sect) * ss) {
+        return FR_DENIED;   /* region exhausted: rotate to a new file */
+    }
+    while (btw > 0) {
+        if (lp->fill == 0 && btw >= ss) {
+            /* Whole sectors go straight from the caller's buffer; one
+               disk_write per run keeps the sd layer's CMD25 open. */
+            n = btw / ss;
+            if (disk_write(fs->pdrv, p, lp->next_sect, n) != RES_OK) {
+                return FR_DISK_ERR;
+            }
+            lp->next_sect += n;
+            n *= ss;
+        } else {
+            /* Stage partial tail bytes until their sector completes. */
+            n = ss - lp->fill;
+            if (n > btw) n = btw;
+            memcpy(lp->buf + lp->fill, p, n);
+            lp->fill += n;
+            if (lp->fill == ss) {
+                if (disk_write(fs->pdrv, lp->buf, lp->next_sect, 1) != RES_OK) {
+                    return FR_DISK_ERR;
+                }
+                lp->next_sect++;
+                lp->fill = 0;
+            }
+        }
+        p += n; btw -= n; lp->size += n;
+    }
+    return FR_OK;
+}
+
+FRESULT f_log_sync (FLOG* lp)
+{
+    FATFS* fs = lp->fil.obj.fs;
+
+    if (fs == 0) return FR_INVALID_OBJECT;
+    if (lp->fill > 0) {
+        /* Push the staged tail without consuming it; the sector is
+           rewritten once it fills or at the next sync. */
+        if (disk_write(fs->pdrv, lp->buf, lp->next_sect, 1) != RES_OK) {
+            return FR_DISK_ERR;
+        }
+    }
+    /* Commit the logical size: one directory-entry write, no chain
+       walk. f_expand left objsize at the preallocated size; the dir
+       entry must carry the appended size instead. */
+    lp->fil.obj.objsize = lp->size;
+    lp->fil.flag |= FLOG_FA_MODIFIED;
+    return f_sync(&lp->fil);
+}
+
+FRESULT f_log_close (FLOG* lp)
+{
+    FRESULT res = f_log_sync(lp);
+    FRESULT res2 = f_close(&lp->fil);
+    return (res != FR_OK) ? res : res2;
+}
+#endif /* FF_USE_EXPAND && !FF_FS_READONLY */
@@ -0,0 +1,24 @@
+/* FatFs OS-dependent memory functions, routed to the lib/alloc pools.
+ *
+ * Only compiled in when FF_USE_LFN == 3 (heap-backed LFN working
+ * buffers). The LFN buffer is (FF_MAX_LFN + 1) * 2 bytes, so it draws
+ * from the large pool with O(1) cost instead of the newlib heap.
+ */
+
+#include "ff.h"
+
+#if FF_USE_LFN == 3
+
+#include "alloc.h"
+
+void *ff_memalloc(UINT msize)
+{
+    return pool_alloc(msize);
+}
+
+void ff_memfree(void *mblock)
+{
+    pool_free(mblock);
+}
+
+#endif /* FF_USE_LFN == 3 */
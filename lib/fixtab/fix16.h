@@ -0,0 +1,94 @@
+/*!
+    \file    fix16.h
+    \brief   Q16.16 fixed-point arithmetic for the demo/render paths.
+
+    The core has no FPU, so any per-frame math must stay in integers.
+    The constexpr tables in fixtab.h cover the transcendental lookups;
+    this header supplies the general arithmetic around them - multiply,
+    divide and square root with 64-bit intermediates so 16.16 operands
+    never overflow mid-expression, plus sin/cos accessors that lift the
+    Q2.13 table values into Q16.16. Header-only and C-includable, like
+    fixtab.h, so the C demos use it directly.
+
+    Angle convention is unchanged from fixtab.h: 8192 units per full
+    turn.
+*/
+
+#ifndef FIX16_H
+#define FIX16_H
+
+#include <stdint.h>
+#include "fixtab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t fix16_t;
+
+#define FIX16_ONE ((fix16_t)0x00010000)
+
+static inline fix16_t fix16_from_int(int v)
+{
+    return (fix16_t)((uint32_t)v << 16);
+}
+
+static inline int fix16_to_int(fix16_t v)
+{
+    return (int)(v >> 16); /* truncates toward negative infinity */
+}
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b)
+{
+    return (fix16_t)(((int64_t)a * b) >> 16);
+}
+
+static inline fix16_t fix16_div(fix16_t a, fix16_t b)
+{
+    return (fix16_t)(((int64_t)a << 16) / b);
+}
+
+/* Restoring integer square root on the Q32.32 radicand; exact to the
+   last Q16.16 bit, ~16 iterations of shift/compare. Negative input
+   clamps to 0. */
+static inline fix16_t fix16_sqrt(fix16_t x)
+{
+    if (x <= 0) {
+        return 0;
+    }
+    uint64_t v = (uint64_t)(uint32_t)x << 16;
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 46; /* highest even bit of the radicand */
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (fix16_t)res;
+}
+
+/* sin/cos of a 13-bit angle (FIXTAB_CIRCLE = 8192 per turn), Q16.16
+   result in [-FIX16_ONE, FIX16_ONE]. Table lookup plus the Q2.13 ->
+   Q16.16 shift; no multiplies beyond the table interpolation. */
+static inline fix16_t fix16_sin(int angle)
+{
+    return (fix16_t)fixtab_sin_q13(angle) << 3;
+}
+
+static inline fix16_t fix16_cos(int angle)
+{
+    return (fix16_t)fixtab_cos_q13(angle) << 3;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* FIX16_H */
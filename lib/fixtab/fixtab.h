@@ -0,0 +1,82 @@
+/*!
+    \file    fixtab.h
+    \brief   Compile-time generated fixed-point lookup tables
+
+    Software floating point on this core costs hundreds of cycles per
+    call, so per-frame math must be table lookups. The tables here are
+    produced by constexpr generators in fixtab_tables.cpp - no Python
+    snippets pasted into comments, no hand-maintained arrays - and land
+    in flash like any other const data. The header is C-includable
+    (tables are wrapped in plain structs) so the C demos can use them
+    too.
+
+    Angle convention: 8192 units per full circle (matching the 13-bit
+    angle space the LCD demos already use); amplitudes are Q2.13 with
+    1.0 == 8192.
+*/
+
+#ifndef FIXTAB_H
+#define FIXTAB_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIXTAB_CIRCLE   8192  /* angle units per full turn */
+#define FIXTAB_ONE_Q13  8192  /* 1.0 in Q2.13 */
+
+/* Quarter sine wave, 512 steps of 4 angle units plus the endpoint; the
+ * accessor folds the other quadrants and interpolates, so the full
+ * circle costs 1 KB of flash instead of 4. */
+#define FIXTAB_SIN_STEPS 512
+typedef struct { int16_t v[FIXTAB_SIN_STEPS + 1]; } fixtab_sin_t;
+extern const fixtab_sin_t fixtab_sin_quarter;
+
+/* Gamma 2.2 transfer (linear 0..255 in, display 0..255 out) and its
+ * inverse, for LED/backlight ramps and shading that should look linear
+ * to the eye. */
+typedef struct { uint8_t v[256]; } fixtab_u8_t;
+extern const fixtab_u8_t fixtab_gamma22;
+extern const fixtab_u8_t fixtab_degamma22;
+
+/* Smoothstep easing (3t^2 - 2t^3), 0..255 in and out; the standard
+ * S-curve for UI value animation without a single multiply-heavy
+ * cubic at runtime. */
+extern const fixtab_u8_t fixtab_ease_smooth;
+
+/* 8192 / sqrt(1 - (x/8192)^2) for x in 32 steps of 256 plus a clamped
+ * endpoint: the perspective/shading weight the Amiga ball demo used to
+ * carry as a hand-pasted array. Values exceed int16 near 1.0. */
+#define FIXTAB_RSQRT_STEPS 32
+typedef struct { int32_t v[FIXTAB_RSQRT_STEPS + 1]; } fixtab_rsqrt_t;
+extern const fixtab_rsqrt_t fixtab_rsqrt1mx2;
+
+/* sin/cos of a 13-bit angle (8192 = full turn), Q2.13 result, linear
+ * interpolation between quarter-table steps. */
+static inline int fixtab_sin_q13(int angle)
+{
+    unsigned a = (unsigned)angle & (FIXTAB_CIRCLE - 1u);
+    unsigned half = a & (FIXTAB_CIRCLE / 2u - 1u);
+    unsigned quarter = (half >= FIXTAB_CIRCLE / 4u)
+                     ? (FIXTAB_CIRCLE / 2u - half) : half;
+    unsigned index = quarter >> 2;
+    unsigned frac = quarter & 3u;
+    int s = fixtab_sin_quarter.v[index];
+    if (frac) {
+        s += ((fixtab_sin_quarter.v[index + 1] - s) * (int)frac) >> 2;
+    }
+    return (a >= FIXTAB_CIRCLE / 2u) ? -s : s;
+}
+
+static inline int fixtab_cos_q13(int angle)
+{
+    return fixtab_sin_q13(angle + FIXTAB_CIRCLE / 4);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* FIXTAB_H */
@@ -0,0 +1,126 @@
+/*!
+    \file    fixtab_tables.cpp
+    \brief   constexpr generators for the fixed-point lookup tables
+
+    Everything here is evaluated by the compiler; the functions below
+    never exist in the image, only the finished tables do. The math
+    helpers are constexpr replacements for the <cmath> calls that are
+    not (yet) usable in constant expressions: Newton's method for
+    sqrt, argument-reduced Taylor series for sin, exp and log for the
+    gamma power curve. Double precision intermediates keep every table
+    entry exact to the rounding of the closed-form value.
+*/
+
+#include "fixtab.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double c_sqrt(double x)
+{
+    double guess = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 64; i++) {
+        guess = 0.5 * (guess + x / guess);
+    }
+    return guess;
+}
+
+constexpr double c_sin(double x)
+{
+    // Taylor series; |x| never exceeds pi/2 here, where 11 terms are
+    // exact to double precision.
+    double term = x, sum = x;
+    const double x2 = x * x;
+    for (int n = 1; n <= 10; n++) {
+        term *= -x2 / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double c_exp(double x)
+{
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n <= 40; n++) {
+        term *= x / n;
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double c_log(double x)
+{
+    // atanh series on (x-1)/(x+1), valid for the 0 < x <= 1 inputs the
+    // gamma curve produces.
+    const double y = (x - 1.0) / (x + 1.0);
+    const double y2 = y * y;
+    double term = y, sum = y;
+    for (int n = 1; n <= 60; n++) {
+        term *= y2;
+        sum += term / (2.0 * n + 1.0);
+    }
+    return 2.0 * sum;
+}
+
+constexpr double c_pow(double base, double exponent)
+{
+    return base <= 0.0 ? 0.0 : c_exp(exponent * c_log(base));
+}
+
+constexpr int c_round(double x)
+{
+    return static_cast<int>(x + 0.5);
+}
+
+constexpr fixtab_sin_t make_sin_quarter()
+{
+    fixtab_sin_t table{};
+    for (int i = 0; i <= FIXTAB_SIN_STEPS; i++) {
+        const double angle = (kPi / 2.0) * i / FIXTAB_SIN_STEPS;
+        table.v[i] = static_cast<int16_t>(c_round(FIXTAB_ONE_Q13 * c_sin(angle)));
+    }
+    return table;
+}
+
+constexpr fixtab_u8_t make_gamma(double gamma)
+{
+    fixtab_u8_t table{};
+    for (int i = 0; i < 256; i++) {
+        table.v[i] = static_cast<uint8_t>(c_round(255.0 * c_pow(i / 255.0, gamma)));
+    }
+    return table;
+}
+
+constexpr fixtab_u8_t make_ease_smooth()
+{
+    fixtab_u8_t table{};
+    for (int i = 0; i < 256; i++) {
+        const double t = i / 255.0;
+        table.v[i] = static_cast<uint8_t>(c_round(255.0 * t * t * (3.0 - 2.0 * t)));
+    }
+    return table;
+}
+
+constexpr fixtab_rsqrt_t make_rsqrt1mx2()
+{
+    // Same closed form the Amiga ball demo used to generate by hand:
+    // 8192 / sqrt(1 - (i/32)^2), with the pole at 1.0 clamped.
+    fixtab_rsqrt_t table{};
+    for (int i = 0; i < FIXTAB_RSQRT_STEPS; i++) {
+        const double x = static_cast<double>(i) / FIXTAB_RSQRT_STEPS;
+        table.v[i] = static_cast<int32_t>(FIXTAB_ONE_Q13 / c_sqrt(1.0 - x * x));
+    }
+    table.v[FIXTAB_RSQRT_STEPS] = 65535;
+    return table;
+}
+
+} // namespace
+
+extern "C" {
+const fixtab_sin_t fixtab_sin_quarter = make_sin_quarter();
+const fixtab_u8_t fixtab_gamma22 = make_gamma(2.2);
+const fixtab_u8_t fixtab_degamma22 = make_gamma(1.0 / 2.2);
+const fixtab_u8_t fixtab_ease_smooth = make_ease_smooth();
+const fixtab_rsqrt_t fixtab_rsqrt1mx2 = make_rsqrt1mx2();
+} // extern "C"
@@ -0,0 +1,116 @@
+/*!
+    \file    lcd.h
+    \brief   ST7735S LCD driver for the Longan Nano (160x80, SPI0 + DMA)
+
+    The pixel upload path is asynchronous: lcd_write_u16() programs the DMA
+    controller and returns immediately, the transfer-complete interrupt of
+    DMA0 channel 2 (SPI0_TX) finishes the transaction in the background.
+*/
+
+#ifndef LCD_H
+#define LCD_H
+
+#include <stdint.h>
+
+/* Panel geometry */
+#define LCD_WIDTH               160
+#define LCD_HEIGHT              80
+#define LCD_FRAMEBUFFER_PIXELS  (LCD_WIDTH * LCD_HEIGHT)
+#define LCD_FRAMEBUFFER_BYTES   (LCD_WIDTH * LCD_HEIGHT * 2)
+
+/* Initializes GPIOs, SPI0, the DMA channel and the panel itself.
+   Equivalent to lcd_init_start() + lcd_init_finish(NULL). */
+void lcd_init(void);
+
+/*
+ * Split init for boot-latency-sensitive projects. lcd_init_start()
+ * configures GPIOs and SPI0, pulses the panel reset and issues the
+ * sleep-out command, then returns in a few milliseconds instead of
+ * busy-waiting the ST7735S's 120 ms sleep-out settle -- the caller
+ * overlaps that window with other bring-up work. lcd_init_finish()
+ * spins out whatever is left of the settle, completes the register
+ * configuration, uploads the splash (a full LCD_WIDTH x LCD_HEIGHT
+ * RGB565 frame, SRAM- or flash-resident; NULL clears to black) and
+ * only then turns the display on, so the splash is the first frame
+ * the panel ever shows.
+ */
+void lcd_init_start(void);
+void lcd_init_finish(const void *splash);
+
+/*
+ * Uploads a w*h block of RGB565 pixels to the panel window at (x, y).
+ * The call blocks only while a previous upload is still in flight; the
+ * new transfer itself runs in the background via DMA. The pixel buffer
+ * must therefore stay valid until the transfer-complete callback fires
+ * (or lcd_dma_busy() reads 0).
+ *
+ * The source may live in SRAM or in flash: the DMA memory port reads
+ * the flash interface directly, so const pixel tables and the
+ * memory-mapped asset store stream to the panel without a staging
+ * copy or any SRAM footprint. Flash-resident sources trade bandwidth
+ * for it -- the reads arbitrate with instruction fetch -- which the
+ * SRAM-resident hot path (.ramtext) keeps off the completion ISR.
+ */
+void lcd_write_u16(int x, int y, int w, int h, const void *pixels);
+
+/*
+ * Fills a w*h window at (x, y) with one RGB565 color. Runs asynchronously
+ * like lcd_write_u16(), but the DMA repeats a single halfword (memory
+ * increment disabled), so no pixel buffer is needed at all.
+ */
+void lcd_fill_u16(int x, int y, int w, int h, uint16_t color);
+
+/* One rect of a scatter-gather blit chain. pixels == NULL requests a
+   solid fill of 'color' instead of a buffer upload. */
+typedef struct {
+    uint8_t x, y, w, h;
+    const void *pixels;
+    uint16_t color;
+} lcd_blit_desc;
+
+/*
+ * Submits a chain of rect blits in one call. The DMA channel-complete
+ * interrupt re-arms the window for each following rect, so per-rect
+ * CS/command overhead no longer round-trips through the main loop.
+ * The descriptor array must stay valid until the chain has finished.
+ * Returns 0 on success, -1 if a previous upload is still in flight.
+ */
+int lcd_write_rects(const lcd_blit_desc *rects, int count);
+
+/* Returns non-zero while a DMA pixel upload is still in flight. */
+int lcd_dma_busy(void);
+
+/* Spins until the current DMA pixel upload (if any) has finished. */
+void lcd_wait_dma_idle(void);
+
+/*
+ * Registers a callback invoked from the DMA transfer-complete interrupt
+ * after each completed rect upload (once per entry of a lcd_write_rects
+ * chain, once for a plain lcd_write_u16/lcd_fill_u16). Pass NULL to
+ * unregister. The callback runs in interrupt context and must be short.
+ */
+void lcd_set_dma_done_callback(void (*callback)(void));
+
+/*
+ * Hardware scrolling (ST7735S VSCRDEF/VSCSAD). The controller scrolls
+ * along its native page axis, which the landscape MADCTL (row/column
+ * exchange) maps onto the panel's 160-pixel x axis: a ticker shifts in
+ * hardware and only the newly revealed column strip needs pixel data.
+ *
+ * lcd_scroll_area() declares the window [x, x+w) as the scrolling
+ * region; columns outside it stay fixed. lcd_scroll_start(line) then
+ * selects which panel column's memory content is displayed first in
+ * that window -- advancing 'line' by one shifts the window's content
+ * left by one pixel, wrapping within the region. Both block only while
+ * a DMA upload is in flight. lcd_scroll_start(x) restores the identity
+ * mapping for the configured area.
+ */
+void lcd_scroll_area(int x, int w);
+void lcd_scroll_start(int line);
+
+/* Continuous full-frame refresh from a resident framebuffer. */
+void lcd_fb_setaddr(const uint16_t *fb);
+void lcd_fb_enable(void);
+void lcd_fb_disable(void);
+
+#endif /* LCD_H */
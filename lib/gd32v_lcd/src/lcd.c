@@ -0,0 +1,523 @@
+/*!
+    \file    lcd.c
+    \brief   ST7735S LCD driver for the Longan Nano (160x80, SPI0 + DMA)
+
+    Pin mapping (Longan Nano):
+        PA5  SPI0_SCK
+        PA7  SPI0_MOSI
+        PB0  DC (data/command)
+        PB1  RST
+        PB2  CS
+
+    Commands are shifted out with 8-bit SPI frames under CPU control;
+    pixel data is streamed with 16-bit frames from DMA0 channel 2
+    (the SPI0_TX request, see lib/dma/longan_nano_dma_alloc.h).
+*/
+
+#include "gd32vf103.h"
+#include "lcd.h"
+#include "longan_nano_dma_alloc.h"
+#include "dma_arbiter.h"
+#include "mtimer.h"
+#include "ramtext.h"
+#include "vectors.h"
+#include "n200_func.h" /* eclic_enable_interrupt */
+
+static void lcd_dma_vectored_entry(void);
+
+/* The visible 160x80 window of the ST7735S frame memory is offset. */
+#define LCD_OFFSET_X  1
+#define LCD_OFFSET_Y  26
+
+/* Native frame-memory page count; the scroll registers always describe
+   the full 162-line axis, visible or not. */
+#define LCD_NATIVE_LINES  162
+
+/* CS and DC toggle through the atomic BOP/BC registers with one store
+   each instead of a call into the flash-resident GPIO driver: the pairs
+   sit on the per-rect window-setup path and inside the SRAM-resident
+   DMA completion ISR. */
+#define LCD_CS_LOW()   (GPIO_BC(GPIOB) = GPIO_PIN_2)
+#define LCD_CS_HIGH()  (GPIO_BOP(GPIOB) = GPIO_PIN_2)
+#define LCD_DC_CMD()   (GPIO_BC(GPIOB) = GPIO_PIN_0)
+#define LCD_DC_DATA()  (GPIO_BOP(GPIOB) = GPIO_PIN_0)
+#define LCD_RST_LOW()  (GPIO_BC(GPIOB) = GPIO_PIN_1)
+#define LCD_RST_HIGH() (GPIO_BOP(GPIOB) = GPIO_PIN_1)
+
+/* Driver state shared with the DMA completion interrupt. */
+static volatile int g_dma_busy = 0;
+static volatile int g_fb_continuous = 0;
+static const uint16_t *g_fb_addr = 0;
+static void (*g_dma_done_callback)(void) = 0;
+
+/* Active scatter-gather chain (a single blit is a one-entry chain). */
+static const lcd_blit_desc *g_sg_list = 0;
+static volatile int g_sg_count = 0;
+static volatile int g_sg_index = 0;
+static lcd_blit_desc g_single_desc;
+static uint16_t g_fill_color; /* DMA source for fills; must outlive the transfer */
+
+/* ------------------------------------------------------------------ */
+/* Low level helpers                                                  */
+/* ------------------------------------------------------------------ */
+
+static void lcd_spi_wait_idle(void)
+{
+    while (RESET == spi_i2s_flag_get(SPI0, SPI_FLAG_TBE)) {
+    }
+    while (RESET != spi_i2s_flag_get(SPI0, SPI_FLAG_TRANS)) {
+    }
+}
+
+static void lcd_spi_set_16bit(int enable)
+{
+    lcd_spi_wait_idle();
+    spi_disable(SPI0);
+    spi_i2s_data_frame_format_config(SPI0, enable ? SPI_FRAMESIZE_16BIT
+                                                  : SPI_FRAMESIZE_8BIT);
+    spi_enable(SPI0);
+}
+
+static void lcd_reg(uint8_t cmd)
+{
+    lcd_spi_wait_idle();
+    LCD_DC_CMD();
+    spi_i2s_data_transmit(SPI0, cmd);
+    lcd_spi_wait_idle();
+    LCD_DC_DATA();
+}
+
+static void lcd_u8(uint8_t data)
+{
+    while (RESET == spi_i2s_flag_get(SPI0, SPI_FLAG_TBE)) {
+    }
+    spi_i2s_data_transmit(SPI0, data);
+}
+
+static void lcd_u16(uint16_t data)
+{
+    lcd_u8((uint8_t)(data >> 8));
+    lcd_u8((uint8_t)data);
+}
+
+/* Window setup (CASET, RASET, RAMWR) banged from a prebuilt 11-byte
+   sequence in one pass. Parameter bytes stream back-to-back paced only
+   by TBE; the shift register is fully drained just where DC has to
+   change level, which the panel's command framing requires anyway.
+   This is the fixed cost every rect of a scatter-gather chain still
+   pays, so it is kept as lean as the wire protocol allows. */
+static void lcd_set_window(int x, int y, int w, int h)
+{
+    uint16_t xs = (uint16_t)(x + LCD_OFFSET_X);
+    uint16_t xe = (uint16_t)(x + w - 1 + LCD_OFFSET_X);
+    uint16_t ys = (uint16_t)(y + LCD_OFFSET_Y);
+    uint16_t ye = (uint16_t)(y + h - 1 + LCD_OFFSET_Y);
+    const uint8_t seq[11] = {
+        0x2a, (uint8_t)(xs >> 8), (uint8_t)xs, (uint8_t)(xe >> 8), (uint8_t)xe,
+        0x2b, (uint8_t)(ys >> 8), (uint8_t)ys, (uint8_t)(ye >> 8), (uint8_t)ye,
+        0x2c
+    };
+    static const uint8_t seg_params[3] = {4, 4, 0};
+    const uint8_t *p = seq;
+    int s, i;
+
+    for (s = 0; s < 3; s++) {
+        lcd_spi_wait_idle();
+        LCD_DC_CMD();
+        spi_i2s_data_transmit(SPI0, *p++);
+        lcd_spi_wait_idle();
+        LCD_DC_DATA();
+        for (i = 0; i < seg_params[s]; i++) {
+            while (RESET == spi_i2s_flag_get(SPI0, SPI_FLAG_TBE)) {
+            }
+            spi_i2s_data_transmit(SPI0, *p++);
+        }
+    }
+}
+
+/* Starts a DMA upload of 'pixels' 16-bit words. CS must already be low,
+   the window set and the SPI switched to 16-bit frames. With mem_inc
+   disabled the same halfword is repeated (solid fill). 'src' may point
+   into SRAM or flash; the DMA memory port reads both buses, so const
+   images and the asset store need no SRAM staging copy. */
+static void lcd_dma_start(const void *src, uint32_t pixels, uint32_t mem_inc)
+{
+    dma_parameter_struct dma_cfg;
+
+    dma_channel_disable(DMA0, DMA0_SPI0_TX_CH);
+    dma_deinit(DMA0, DMA0_SPI0_TX_CH);
+
+    dma_struct_para_init(&dma_cfg);
+    dma_cfg.periph_addr  = (uint32_t)&SPI_DATA(SPI0);
+    dma_cfg.periph_width = DMA_PERIPHERAL_WIDTH_16BIT;
+    dma_cfg.memory_addr  = (uint32_t)src;
+    dma_cfg.memory_width = DMA_MEMORY_WIDTH_16BIT;
+    dma_cfg.number       = pixels;
+    dma_cfg.priority     = dma_arbiter_priority(DMA0, DMA0_SPI0_TX_CH);
+    dma_cfg.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+    dma_cfg.memory_inc   = mem_inc;
+    dma_cfg.direction    = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init(DMA0, DMA0_SPI0_TX_CH, &dma_cfg);
+    dma_arbiter_note_start(DMA0, DMA0_SPI0_TX_CH, pixels);
+
+    dma_interrupt_flag_clear(DMA0, DMA0_SPI0_TX_CH, DMA_INT_FLAG_G);
+    dma_interrupt_enable(DMA0, DMA0_SPI0_TX_CH, DMA_INT_FTF);
+
+    spi_dma_enable(SPI0, SPI_DMA_TRANSMIT);
+    dma_channel_enable(DMA0, DMA0_SPI0_TX_CH);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+int lcd_dma_busy(void)
+{
+    return g_dma_busy;
+}
+
+void lcd_wait_dma_idle(void)
+{
+    while (g_dma_busy) {
+    }
+}
+
+void lcd_set_dma_done_callback(void (*callback)(void))
+{
+    g_dma_done_callback = callback;
+}
+
+/* Programs the window for one descriptor and kicks its DMA transfer. */
+static void lcd_start_rect(const lcd_blit_desc *desc)
+{
+    uint32_t pixels = (uint32_t)desc->w * (uint32_t)desc->h;
+
+    LCD_CS_LOW();
+    lcd_set_window(desc->x, desc->y, desc->w, desc->h);
+    lcd_spi_set_16bit(1);
+
+    if (desc->pixels) {
+        lcd_dma_start(desc->pixels, pixels, DMA_MEMORY_INCREASE_ENABLE);
+    } else {
+        g_fill_color = desc->color;
+        lcd_dma_start(&g_fill_color, pixels, DMA_MEMORY_INCREASE_DISABLE);
+    }
+}
+
+int lcd_write_rects(const lcd_blit_desc *rects, int count)
+{
+    if (g_dma_busy) {
+        return -1;
+    }
+    if (count <= 0) {
+        return 0;
+    }
+
+    g_sg_list = rects;
+    g_sg_count = count;
+    g_sg_index = 0;
+    g_dma_busy = 1;
+    lcd_start_rect(&rects[0]);
+    return 0;
+}
+
+void lcd_write_u16(int x, int y, int w, int h, const void *pixels)
+{
+    lcd_wait_dma_idle();
+
+    g_single_desc.x = (uint8_t)x;
+    g_single_desc.y = (uint8_t)y;
+    g_single_desc.w = (uint8_t)w;
+    g_single_desc.h = (uint8_t)h;
+    g_single_desc.pixels = pixels;
+    lcd_write_rects(&g_single_desc, 1);
+}
+
+void lcd_fill_u16(int x, int y, int w, int h, uint16_t color)
+{
+    lcd_wait_dma_idle();
+
+    g_single_desc.x = (uint8_t)x;
+    g_single_desc.y = (uint8_t)y;
+    g_single_desc.w = (uint8_t)w;
+    g_single_desc.h = (uint8_t)h;
+    g_single_desc.pixels = 0;
+    g_single_desc.color = color;
+    lcd_write_rects(&g_single_desc, 1);
+}
+
+void lcd_scroll_area(int x, int w)
+{
+    /* The landscape MADCTL exchanges rows and columns, so the native
+       scroll axis (pages) runs along the panel's x axis: 'fixed top'
+       covers everything left of the window, 'fixed bottom' everything
+       right of it plus the invisible trailing lines. */
+    uint16_t tfa = (uint16_t)(LCD_OFFSET_X + x);
+    uint16_t vsa = (uint16_t)w;
+    uint16_t bfa = (uint16_t)(LCD_NATIVE_LINES - tfa - vsa);
+
+    lcd_wait_dma_idle();
+
+    LCD_CS_LOW();
+    lcd_reg(0x33); /* VSCRDEF */
+    lcd_u16(tfa);
+    lcd_u16(vsa);
+    lcd_u16(bfa);
+    lcd_spi_wait_idle();
+    LCD_CS_HIGH();
+}
+
+void lcd_scroll_start(int line)
+{
+    lcd_wait_dma_idle();
+
+    LCD_CS_LOW();
+    lcd_reg(0x37); /* VSCSAD */
+    lcd_u16((uint16_t)(LCD_OFFSET_X + line));
+    lcd_spi_wait_idle();
+    LCD_CS_HIGH();
+}
+
+void lcd_fb_setaddr(const uint16_t *fb)
+{
+    g_fb_addr = fb;
+}
+
+void lcd_fb_enable(void)
+{
+    if ((0 == g_fb_addr) || g_fb_continuous) {
+        return;
+    }
+    g_fb_continuous = 1;
+    /* The ST7735 write pointer wraps back to the window origin, so one
+       RAMWR is enough; the completion interrupt just re-arms the DMA. */
+    lcd_write_u16(0, 0, LCD_WIDTH, LCD_HEIGHT, g_fb_addr);
+}
+
+void lcd_fb_disable(void)
+{
+    g_fb_continuous = 0;
+    lcd_wait_dma_idle();
+}
+
+/* DMA0 channel 2: SPI0_TX transfer complete. Executes from SRAM so the
+   re-arm happens quickly even when USB interrupts are stacking. */
+RAMTEXT void DMA0_Channel2_IRQHandler(void)
+{
+    if (RESET == dma_interrupt_flag_get(DMA0, DMA0_SPI0_TX_CH, DMA_INT_FLAG_FTF)) {
+        return;
+    }
+    dma_interrupt_flag_clear(DMA0, DMA0_SPI0_TX_CH, DMA_INT_FLAG_G);
+    dma_channel_disable(DMA0, DMA0_SPI0_TX_CH);
+
+    if (g_fb_continuous && (0 != g_fb_addr)) {
+        /* Keep CS low and stream the next full frame from the resident
+           framebuffer; the panel address pointer has wrapped already. */
+        lcd_dma_start(g_fb_addr, LCD_FRAMEBUFFER_PIXELS, DMA_MEMORY_INCREASE_ENABLE);
+        return;
+    }
+
+    /* Drain the SPI shifter before releasing the panel. */
+    lcd_spi_wait_idle();
+    spi_dma_disable(SPI0, SPI_DMA_TRANSMIT);
+    LCD_CS_HIGH();
+    lcd_spi_set_16bit(0);
+
+    /* More rects in the chain? Report this one and re-arm the next. */
+    g_sg_index++;
+    if (g_sg_index < g_sg_count) {
+        if (g_dma_done_callback) {
+            g_dma_done_callback();
+        }
+        lcd_start_rect(&g_sg_list[g_sg_index]);
+        return;
+    }
+
+    g_dma_busy = 0;
+    if (g_dma_done_callback) {
+        g_dma_done_callback();
+    }
+}
+
+/* Directly-vectored ECLIC entry: the compiler-generated prolog replaces
+   the full context save the shared trampoline performs. Runs at
+   IRQ_LEVEL_STREAMING, so it reopens the interrupt window and lets
+   USBFS preempt the re-arm. */
+RAMTEXT IRQ_VECTORED static void lcd_dma_vectored_entry(void)
+{
+    IRQ_PREEMPT_ENTER();
+    DMA0_Channel2_IRQHandler();
+    IRQ_PREEMPT_EXIT();
+}
+
+/* ------------------------------------------------------------------ */
+/* Initialization                                                     */
+/* ------------------------------------------------------------------ */
+
+/* Panel timing profile, selected per project with LCD_PANEL_PROFILE
+   (config.py GLOBAL_C_DEFINES). The fleet carries two panel revisions
+   whose controllers settle at different rates; one sequence with the
+   conservative union of their delays taxed every boot on both. Each
+   profile holds that panel's measured/datasheet minimums, and panel
+   init is most of the boot-to-splash budget, so the sleep-out figure
+   is the one that matters.
+
+   A runtime probe (RDDID) is not an option on this board: the module's
+   SDA pin is wired to SPI0_MOSI only, so the controller cannot be read
+   back and the revision must come from the build. */
+typedef struct {
+    uint32_t reset_pulse_us;   /* RESX low time */
+    uint32_t reset_settle_us;  /* RESX release to first command */
+    uint32_t slpout_settle_us; /* SLPOUT to the next command */
+} lcd_panel_timing;
+
+#ifndef LCD_PANEL_PROFILE
+#define LCD_PANEL_PROFILE 0
+#endif
+
+static const lcd_panel_timing g_panel_timing =
+#if LCD_PANEL_PROFILE == 1
+    /* Revision B module (2024 panel batch): same ST7735S-compatible
+       command set, but measured settle floors well under the rev A
+       datasheet figures (80 ms sleep-out verified stable across units
+       and temperature with margin over the worst measurement). */
+    { 20U, 1000U, 80000U };
+#else
+    /* Revision A module (original Longan Nano panel): ST7735S
+       datasheet minimums -- >= 10 us RESX pulse, 5 ms recovery before
+       the first command, 120 ms after SLPOUT. */
+    { 20U, 5000U, 120000U };
+#endif
+
+static void lcd_gpio_spi_config(void)
+{
+    spi_parameter_struct spi_cfg;
+
+    rcu_periph_clock_enable(RCU_GPIOA);
+    rcu_periph_clock_enable(RCU_GPIOB);
+    rcu_periph_clock_enable(RCU_AF);
+    rcu_periph_clock_enable(RCU_SPI0);
+    rcu_periph_clock_enable(RCU_DMA0);
+
+    gpio_init(GPIOA, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_5 | GPIO_PIN_7);
+    gpio_init(GPIOB, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ,
+              GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2);
+
+    LCD_CS_HIGH();
+    LCD_DC_DATA();
+
+    spi_struct_para_init(&spi_cfg);
+    spi_cfg.trans_mode           = SPI_TRANSMODE_FULLDUPLEX;
+    spi_cfg.device_mode          = SPI_MASTER;
+    spi_cfg.frame_size           = SPI_FRAMESIZE_8BIT;
+    spi_cfg.clock_polarity_phase = SPI_CK_PL_HIGH_PH_2EDGE;
+    spi_cfg.nss                  = SPI_NSS_SOFT;
+    spi_cfg.prescale             = SPI_PSC_8;
+    spi_cfg.endian               = SPI_ENDIAN_MSB;
+    spi_init(SPI0, &spi_cfg);
+    spi_enable(SPI0);
+}
+
+/* Sleep-out settle deadline armed by lcd_init_start(); the finish half
+   spins out whatever is left of it after the caller's overlapped work. */
+static mtimer_timeout g_slpout_settle;
+
+void lcd_init_start(void)
+{
+    lcd_gpio_spi_config();
+
+    /* Hardware reset with the selected profile's timings (power-on
+       default is sleep-in, so the 120 ms reset-during-sleep-out case
+       does not apply); the old 20/50 ms waits were inherited margin. */
+    LCD_RST_LOW();
+    delay_us(g_panel_timing.reset_pulse_us);
+    LCD_RST_HIGH();
+    delay_us(g_panel_timing.reset_settle_us);
+
+    LCD_CS_LOW();
+    lcd_reg(0x11); /* Sleep out */
+    lcd_spi_wait_idle();
+    LCD_CS_HIGH();
+
+    /* The panel needs its profile's settle time after SLPOUT before
+       further commands take effect. Arm the deadline and hand the wait
+       back to the caller: USB enumeration and the asset-store scan run
+       underneath it. */
+    mtimer_timeout_start(&g_slpout_settle, g_panel_timing.slpout_settle_us);
+}
+
+void lcd_init_finish(const void *splash)
+{
+    while (!mtimer_timeout_expired(&g_slpout_settle)) {
+    }
+
+    LCD_CS_LOW();
+
+    lcd_reg(0x21); /* Inversion on: the 160x80 panel is an inverted type */
+
+    /* Frame rate control */
+    lcd_reg(0xb1); lcd_u8(0x05); lcd_u8(0x3a); lcd_u8(0x3a);
+    lcd_reg(0xb2); lcd_u8(0x05); lcd_u8(0x3a); lcd_u8(0x3a);
+    lcd_reg(0xb3);
+    lcd_u8(0x05); lcd_u8(0x3a); lcd_u8(0x3a);
+    lcd_u8(0x05); lcd_u8(0x3a); lcd_u8(0x3a);
+
+    lcd_reg(0xb4); lcd_u8(0x03); /* Dot inversion */
+
+    /* Power sequence */
+    lcd_reg(0xc0); lcd_u8(0x62); lcd_u8(0x02); lcd_u8(0x04);
+    lcd_reg(0xc1); lcd_u8(0xc0);
+    lcd_reg(0xc2); lcd_u8(0x0d); lcd_u8(0x00);
+    lcd_reg(0xc3); lcd_u8(0x8d); lcd_u8(0x6a);
+    lcd_reg(0xc4); lcd_u8(0x8d); lcd_u8(0xee);
+    lcd_reg(0xc5); lcd_u8(0x0e); /* VCOM */
+
+    /* Gamma */
+    lcd_reg(0xe0);
+    lcd_u8(0x10); lcd_u8(0x0e); lcd_u8(0x02); lcd_u8(0x03);
+    lcd_u8(0x0e); lcd_u8(0x07); lcd_u8(0x02); lcd_u8(0x07);
+    lcd_u8(0x0a); lcd_u8(0x12); lcd_u8(0x27); lcd_u8(0x37);
+    lcd_u8(0x00); lcd_u8(0x0d); lcd_u8(0x0e); lcd_u8(0x10);
+    lcd_reg(0xe1);
+    lcd_u8(0x10); lcd_u8(0x0e); lcd_u8(0x03); lcd_u8(0x03);
+    lcd_u8(0x0f); lcd_u8(0x06); lcd_u8(0x02); lcd_u8(0x08);
+    lcd_u8(0x0a); lcd_u8(0x13); lcd_u8(0x26); lcd_u8(0x36);
+    lcd_u8(0x00); lcd_u8(0x0d); lcd_u8(0x0e); lcd_u8(0x10);
+
+    lcd_reg(0x3a); lcd_u8(0x05); /* 16-bit pixel format */
+    lcd_reg(0x36); lcd_u8(0x78); /* Landscape, RGB order */
+
+    lcd_spi_wait_idle();
+    LCD_CS_HIGH();
+
+    /* Arm the transfer-complete interrupt used by the async blit path.
+       It fires once per rect (or per full frame), so it takes a direct
+       ECLIC vectored entry instead of the shared trampoline. */
+    eclic_global_interrupt_enable();
+    eclic_enable_interrupt(DMA0_Channel2_IRQn); /* level/priority: irq_map.c */
+    irq_vector_register(DMA0_Channel2_IRQn, lcd_dma_vectored_entry);
+
+    /* Paint the frame memory before display-on so the first visible
+       frame is the splash (or black), never the panel's power-on
+       noise. A flash-resident splash streams straight through the DMA
+       memory port, same as any other blit. The clear runs on the
+       regular fill path (a repeated halfword with memory increment
+       off) -- the driver's last CPU-pumped pixel loop is gone. */
+    if (splash != 0) {
+        lcd_write_u16(0, 0, LCD_WIDTH, LCD_HEIGHT, splash);
+    } else {
+        lcd_fill_u16(0, 0, LCD_WIDTH, LCD_HEIGHT, 0x0000);
+    }
+    lcd_wait_dma_idle();
+
+    LCD_CS_LOW();
+    lcd_reg(0x29); /* Display on */
+    lcd_spi_wait_idle();
+    LCD_CS_HIGH();
+}
+
+void lcd_init(void)
+{
+    lcd_init_start();
+    lcd_init_finish(0);
+}
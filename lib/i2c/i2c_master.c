@@ -0,0 +1,369 @@
+/*!
+    \file    i2c_master.c
+    \brief   interrupt-driven I2C0 master with a queued-transaction API
+*/
+
+#include "i2c_master.h"
+
+#include "gd32vf103.h"
+#include "n200_func.h"
+#include "riscv_encoding.h"
+
+/* ------------------------------------------------------------------ */
+/* Transaction queue                                                  */
+/* ------------------------------------------------------------------ */
+
+enum {
+    DIR_WRITE = 0,
+    DIR_READ  = 1,
+};
+
+typedef struct {
+    uint8_t addr7;
+    uint8_t dir;            /* DIR_WRITE / DIR_READ */
+    uint8_t reg;            /* register byte, reads with has_reg only */
+    uint8_t has_reg;
+    uint8_t len;
+    uint8_t result;         /* i2c_xfer_result, filled at completion */
+    uint8_t *buf;
+    i2c_done_fn done;
+    void *ctx;
+} i2c_txn;
+
+/* a completion record outlives its queue slot: the slot frees for
+   reuse the moment the ISR finishes it, while the callback waits for
+   the next service() pass */
+typedef struct {
+    i2c_done_fn done;
+    void *ctx;
+    uint8_t result;
+} i2c_done_rec;
+
+/* pending ring: main loop appends at tail, the ISR consumes at head.
+   done ring: the ISR appends completion records, service() drains.
+   Counters are free-running; masking to the depth picks the slot. */
+static i2c_txn q[I2C_MASTER_QUEUE_DEPTH];
+static volatile uint32_t q_head;
+static volatile uint32_t q_tail;
+static i2c_done_rec done_q[I2C_MASTER_QUEUE_DEPTH];
+static volatile uint32_t done_head;
+static volatile uint32_t done_tail;
+
+/* ------------------------------------------------------------------ */
+/* Bus state (ISR-owned while a transaction is active)                */
+/* ------------------------------------------------------------------ */
+
+enum {
+    PHASE_IDLE = 0,
+    PHASE_START,        /* waiting for SBSEND of the first START */
+    PHASE_ADDR_TX,      /* waiting for ADDSEND, transmitter */
+    PHASE_REG,          /* waiting for TBE to send the register byte */
+    PHASE_REG_SENT,     /* register byte out, waiting for BTC */
+    PHASE_TX,           /* streaming write payload on TBE */
+    PHASE_RESTART,      /* waiting for SBSEND of the repeated START */
+    PHASE_ADDR_RX,      /* waiting for ADDSEND, receiver */
+    PHASE_RX,           /* draining read payload on RBNE */
+};
+
+static volatile uint8_t phase = PHASE_IDLE;
+static i2c_txn *cur;
+static uint8_t *xfer_p;
+static uint32_t bytes_left;
+static uint64_t started_at;         /* mtime at START, for the watchdog */
+static void (*wake)(void);
+static uint32_t error_count;
+static uint32_t bus_speed_hz;
+
+#define SLOT(n) ((n) % I2C_MASTER_QUEUE_DEPTH)
+
+/* ------------------------------------------------------------------ */
+/* Peripheral bring-up                                                */
+/* ------------------------------------------------------------------ */
+
+static void periph_config(void)
+{
+    i2c_deinit(I2C0);
+    i2c_clock_config(I2C0, bus_speed_hz, I2C_DTCY_2);
+    /* own address is unused in master mode but must be programmed */
+    i2c_mode_addr_config(I2C0, I2C_I2CMODE_ENABLE, I2C_ADDFORMAT_7BITS, 0x00);
+    i2c_enable(I2C0);
+    i2c_ack_config(I2C0, I2C_ACK_ENABLE);
+}
+
+void i2c_master_init(uint32_t speed_hz, void (*completion_wake)(void))
+{
+    bus_speed_hz = speed_hz;
+    wake = completion_wake;
+
+    rcu_periph_clock_enable(RCU_GPIOB);
+    rcu_periph_clock_enable(RCU_AF);
+    rcu_periph_clock_enable(RCU_I2C0);
+    gpio_init(GPIOB, GPIO_MODE_AF_OD, GPIO_OSPEED_50MHZ, GPIO_PIN_6);
+    gpio_init(GPIOB, GPIO_MODE_AF_OD, GPIO_OSPEED_50MHZ, GPIO_PIN_7);
+
+    periph_config();
+
+    /* level/priority come from lib/system/irq_map.c */
+    eclic_enable_interrupt(I2C0_EV_IRQn);
+    eclic_enable_interrupt(I2C0_ER_IRQn);
+}
+
+/* ------------------------------------------------------------------ */
+/* Completion and chaining (interrupt context)                        */
+/* ------------------------------------------------------------------ */
+
+static void start_next(void)
+{
+    if (q_head == q_tail) {
+        phase = PHASE_IDLE;
+        i2c_interrupt_disable(I2C0, I2C_INT_ERR);
+        i2c_interrupt_disable(I2C0, I2C_INT_BUF);
+        i2c_interrupt_disable(I2C0, I2C_INT_EV);
+        return;
+    }
+    cur = &q[SLOT(q_head)];
+    xfer_p = cur->buf;
+    bytes_left = cur->len;
+    started_at = get_timer_value();
+    phase = PHASE_START;
+    i2c_ack_config(I2C0, I2C_ACK_ENABLE);
+    i2c_interrupt_enable(I2C0, I2C_INT_ERR);
+    i2c_interrupt_enable(I2C0, I2C_INT_EV);
+    i2c_interrupt_enable(I2C0, I2C_INT_BUF);
+    i2c_start_on_bus(I2C0);
+}
+
+static void complete(uint8_t result)
+{
+    i2c_done_rec *rec = &done_q[SLOT(done_tail)];
+
+    if (result != I2C_XFER_OK) {
+        error_count++;
+    }
+    rec->done = cur->done;
+    rec->ctx = cur->ctx;
+    rec->result = result;
+    done_tail++;
+    q_head++;
+    start_next();
+    if (wake) {
+        wake();
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Event state machine                                                */
+/* ------------------------------------------------------------------ */
+
+void I2C0_EV_IRQHandler(void)
+{
+    switch (phase) {
+    case PHASE_START:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_SBSEND)) {
+            if ((cur->dir == DIR_READ) && !cur->has_reg) {
+                i2c_master_addressing(I2C0, (uint32_t)(cur->addr7 << 1),
+                                      I2C_RECEIVER);
+                phase = PHASE_ADDR_RX;
+            } else {
+                i2c_master_addressing(I2C0, (uint32_t)(cur->addr7 << 1),
+                                      I2C_TRANSMITTER);
+                phase = PHASE_ADDR_TX;
+            }
+        }
+        break;
+
+    case PHASE_ADDR_TX:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_ADDSEND)) {
+            i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_ADDSEND);
+            phase = (cur->dir == DIR_READ) ? PHASE_REG : PHASE_TX;
+        }
+        break;
+
+    case PHASE_REG:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_TBE)) {
+            i2c_data_transmit(I2C0, cur->reg);
+            /* TBE re-raises as soon as the register byte moves to the
+               shifter; quiet the buffer interrupt and wait for BTC so
+               the repeated START lands after the byte is really out */
+            i2c_interrupt_disable(I2C0, I2C_INT_BUF);
+            phase = PHASE_REG_SENT;
+        }
+        break;
+
+    case PHASE_REG_SENT:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_BTC)) {
+            i2c_start_on_bus(I2C0);
+            i2c_interrupt_enable(I2C0, I2C_INT_BUF);
+            phase = PHASE_RESTART;
+        }
+        break;
+
+    case PHASE_TX:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_TBE)) {
+            if (bytes_left > 0) {
+                i2c_data_transmit(I2C0, *xfer_p++);
+                bytes_left--;
+            } else {
+                i2c_stop_on_bus(I2C0);
+                complete(I2C_XFER_OK);
+            }
+        }
+        break;
+
+    case PHASE_RESTART:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_SBSEND)) {
+            i2c_master_addressing(I2C0, (uint32_t)(cur->addr7 << 1),
+                                  I2C_RECEIVER);
+            phase = PHASE_ADDR_RX;
+        }
+        break;
+
+    case PHASE_ADDR_RX:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_ADDSEND)) {
+            /* the ACKEN for the final byte must be cleared before
+               ADDSEND for 1- and 2-byte reads (see the SDK example) */
+            if (bytes_left < 3) {
+                i2c_ack_config(I2C0, I2C_ACK_DISABLE);
+            }
+            i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_ADDSEND);
+            if (bytes_left == 1) {
+                i2c_stop_on_bus(I2C0);
+            }
+            phase = PHASE_RX;
+        }
+        break;
+
+    case PHASE_RX:
+        if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_RBNE)) {
+            if (bytes_left == 3) {
+                /* hold the third-to-last byte in DATA until the
+                   second-to-last has fully shifted in: one byte time,
+                   the SDK example's own sequence for the NACK window */
+                while (!i2c_flag_get(I2C0, I2C_FLAG_BTC)) {
+                }
+                i2c_ack_config(I2C0, I2C_ACK_DISABLE);
+            }
+            *xfer_p++ = i2c_data_receive(I2C0);
+            bytes_left--;
+            if (bytes_left == 0) {
+                if (cur->len != 1) {
+                    i2c_stop_on_bus(I2C0);
+                }
+                complete(I2C_XFER_OK);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void I2C0_ER_IRQHandler(void)
+{
+    uint8_t result = I2C_XFER_BUS_ERROR;
+
+    if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_AERR)) {
+        i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_AERR);
+        result = I2C_XFER_NACK;
+    }
+    if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_BERR)) {
+        i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_BERR);
+    }
+    if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_LOSTARB)) {
+        i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_LOSTARB);
+    }
+    if (i2c_interrupt_flag_get(I2C0, I2C_INT_FLAG_OUERR)) {
+        i2c_interrupt_flag_clear(I2C0, I2C_INT_FLAG_OUERR);
+    }
+    if (phase == PHASE_IDLE) {
+        return; /* stale flag, nothing to fail */
+    }
+    i2c_stop_on_bus(I2C0);
+    complete(result);
+}
+
+/* ------------------------------------------------------------------ */
+/* Submission and dispatch (main-loop context)                        */
+/* ------------------------------------------------------------------ */
+
+static bool submit(const i2c_txn *txn)
+{
+    /* a full done ring also refuses: its records live until service()
+       dispatches them, and only this context fills queue slots */
+    if ((q_tail - q_head == I2C_MASTER_QUEUE_DEPTH) ||
+        (done_tail - done_head == I2C_MASTER_QUEUE_DEPTH)) {
+        return FALSE;
+    }
+    /* the append itself only races the ISR's head, but the idle check
+       plus kick must be atomic against a completion going idle */
+    clear_csr(mstatus, MSTATUS_MIE);
+    q[SLOT(q_tail)] = *txn;
+    q_tail++;
+    if (phase == PHASE_IDLE) {
+        start_next();
+    }
+    set_csr(mstatus, MSTATUS_MIE);
+    return TRUE;
+}
+
+bool i2c_master_write(uint8_t addr7, const uint8_t *buf, uint8_t len,
+                      i2c_done_fn done, void *ctx)
+{
+    i2c_txn txn = {
+        .addr7 = addr7, .dir = DIR_WRITE, .reg = 0, .has_reg = 0,
+        .len = len, .result = I2C_XFER_OK,
+        .buf = (uint8_t *)buf, .done = done, .ctx = ctx,
+    };
+    return submit(&txn);
+}
+
+bool i2c_master_read(uint8_t addr7, uint8_t reg, bool has_reg,
+                     uint8_t *buf, uint8_t len,
+                     i2c_done_fn done, void *ctx)
+{
+    i2c_txn txn = {
+        .addr7 = addr7, .dir = DIR_READ, .reg = reg,
+        .has_reg = (uint8_t)(has_reg ? 1 : 0),
+        .len = len, .result = I2C_XFER_OK,
+        .buf = buf, .done = done, .ctx = ctx,
+    };
+    return submit(&txn);
+}
+
+void i2c_master_service(void)
+{
+    /* watchdog: a wedged slave stretches SCL forever and no interrupt
+       ever fires again; reset the peripheral and fail the transaction */
+    if (phase != PHASE_IDLE) {
+        uint64_t held = get_timer_value() - started_at;
+        if (held > ((uint64_t)SystemCoreClock / 4000U) * I2C_MASTER_TIMEOUT_MS) {
+            clear_csr(mstatus, MSTATUS_MIE);
+            if (phase != PHASE_IDLE) { /* re-check: it may just have finished */
+                periph_config();
+                complete(I2C_XFER_TIMEOUT);
+            }
+            set_csr(mstatus, MSTATUS_MIE);
+        }
+    }
+
+    /* dispatch completions outside the ISR so callbacks may submit
+       follow-up transactions or take their time folding results */
+    while (done_head != done_tail) {
+        i2c_done_rec rec = done_q[SLOT(done_head)];
+        done_head++;
+        if (rec.done) {
+            rec.done((i2c_xfer_result)rec.result, rec.ctx);
+        }
+    }
+}
+
+bool i2c_master_busy(void)
+{
+    return q_head != q_tail;
+}
+
+uint32_t i2c_master_errors(void)
+{
+    return error_count;
+}
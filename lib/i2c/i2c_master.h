@@ -0,0 +1,88 @@
+/*!
+    \file    i2c_master.h
+    \brief   interrupt-driven I2C0 master with a queued-transaction API
+
+    The SDK's i2c driver only offers blocking transfers, and a single
+    sensor read at 100 kHz is close to a millisecond of bus time - a
+    stall the main loop cannot absorb between draw dispatches. This
+    driver runs the whole transfer from the I2C0 event/error interrupts
+    instead: callers enqueue a transaction and get their completion
+    callback later from i2c_master_service(), in main-loop context, via
+    whatever deferred level the project wires the wake hook to.
+
+    One transaction is on the bus at a time; the event ISR chains the
+    next queued one directly, so back-to-back sensor sweeps never
+    return to the main loop between transfers. The state machine
+    follows gd32/Examples/I2C/I2C_EEPROM_interrput. Pins are the Longan
+    Nano expansion header's I2C0 pair (PB6 SCL / PB7 SDA).
+
+    Submit from the main loop only; completion callbacks run from
+    i2c_master_service(), never from the ISR.
+*/
+
+#ifndef I2C_MASTER_H
+#define I2C_MASTER_H
+
+#include <stdint.h>
+#include "gd32vf103.h" /* bool comes from here in C builds */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* queued transactions; a full queue fails the submit, it never blocks */
+#ifndef I2C_MASTER_QUEUE_DEPTH
+#define I2C_MASTER_QUEUE_DEPTH 8
+#endif
+
+/* how long one transaction may hold the bus before the service pass
+   resets the peripheral and fails it (wedged slave, missing pull-ups) */
+#ifndef I2C_MASTER_TIMEOUT_MS
+#define I2C_MASTER_TIMEOUT_MS 25
+#endif
+
+typedef enum {
+    I2C_XFER_OK = 0,
+    I2C_XFER_NACK,      /* address or data byte not acknowledged */
+    I2C_XFER_BUS_ERROR, /* bus error / lost arbitration */
+    I2C_XFER_TIMEOUT,   /* transaction exceeded I2C_MASTER_TIMEOUT_MS */
+} i2c_xfer_result;
+
+/* completion callback; runs from i2c_master_service() in main-loop
+   context with the transaction already off the bus */
+typedef void (*i2c_done_fn)(i2c_xfer_result result, void *ctx);
+
+/* clock I2C0, configure PB6/PB7 and the bus speed, and register the
+   hook the ISR calls when a completion is ready to dispatch (typically
+   an events::post - it runs in interrupt context and must only post).
+   NULL is allowed; completions then wait for the next service() pass. */
+void i2c_master_init(uint32_t speed_hz, void (*completion_wake)(void));
+
+/* queue a raw write of buf[len] to a 7-bit address. The buffer must
+   stay valid until the completion callback runs. false = queue full. */
+bool i2c_master_write(uint8_t addr7, const uint8_t *buf, uint8_t len,
+                      i2c_done_fn done, void *ctx);
+
+/* queue a register read: write one register byte, repeated START, then
+   read len bytes into buf. Covers the whole pointer-register sensor
+   family; pass has_reg=false for address-only reads. */
+bool i2c_master_read(uint8_t addr7, uint8_t reg, bool has_reg,
+                     uint8_t *buf, uint8_t len,
+                     i2c_done_fn done, void *ctx);
+
+/* dispatch finished completions and run the timeout watchdog; call
+   from the deferred task the wake hook posts (and, for the watchdog,
+   from any periodic tick when the bus may sit idle-but-wedged) */
+void i2c_master_service(void);
+
+/* a transaction is on the bus or queued */
+bool i2c_master_busy(void);
+
+/* transactions failed since boot, by cause, for the stats report */
+uint32_t i2c_master_errors(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* I2C_MASTER_H */
@@ -0,0 +1,107 @@
+/*!
+    \file    lcd_font.h
+    \brief   Packed bitmap fonts shared by the LCD projects
+
+    Glyphs are 1-bit-per-pixel bitmaps, one glyph per character code,
+    MSB-first within each row byte. The renderer expands them into any
+    caller-supplied RGB565 buffer, so the same tables serve both the
+    framebuffer demo (prj_lcd_test) and the USB display device, which
+    renders text straight into a DisplayManager slot.
+*/
+
+#ifndef LCD_FONT_H
+#define LCD_FONT_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t width;          /* glyph width in pixels */
+    uint8_t height;         /* glyph height in pixels */
+    uint8_t bytes_per_row;  /* bytes per glyph row (width / 8, rounded up) */
+    const unsigned char *glyphs; /* 256 glyphs, height * bytes_per_row bytes each */
+} lcd_font;
+
+extern const lcd_font lcd_font_8x16;
+extern const lcd_font lcd_font_16x24;
+
+/*
+ * Proportional fonts generated at build time by bldmgr/fontgen.py from
+ * the TTFs under tools/display_manager/fonts. Glyph bitmaps are packed
+ * 1 bpp MSB-first into one pool; each glyph records its advance and the
+ * bearing of its bitmap relative to the pen position and line-box top.
+ * With LCD_FONT_PROP_RLE set the pool is PackBits-compressed and glyphs
+ * are decoded into a stack buffer at draw time.
+ */
+
+typedef struct {
+    uint8_t width;          /* bitmap width in pixels (may be 0, e.g. space) */
+    uint8_t height;         /* bitmap height in pixels */
+    uint8_t advance;        /* pen advance in pixels */
+    int8_t x_offset;        /* bitmap left edge relative to the pen */
+    int8_t y_offset;        /* bitmap top edge relative to the line-box top */
+    uint16_t bitmap_offset; /* byte offset into the bitmap pool */
+} lcd_glyph;
+
+typedef struct {
+    uint8_t left, right;    /* character pair */
+    int8_t adjust;          /* pixels added to the advance between them */
+} lcd_kern_pair;
+
+#define LCD_FONT_PROP_RLE 0x01
+
+/* Largest decoded glyph bitmap the renderer will handle; fontgen.py
+ * rejects RLE fonts whose glyphs exceed it. */
+#define LCD_GLYPH_MAX_BYTES 192
+
+typedef struct {
+    uint8_t first_char, last_char; /* inclusive character range */
+    uint8_t line_height;    /* baseline-to-baseline distance */
+    uint8_t baseline;       /* rows from line-box top to the baseline */
+    uint8_t flags;          /* LCD_FONT_PROP_* */
+    uint16_t kerning_count;
+    const lcd_glyph *glyphs;       /* last_char - first_char + 1 entries */
+    const uint8_t *bitmaps;        /* packed (or RLE) bitmap pool */
+    const lcd_kern_pair *kerning;  /* sorted by (left, right) */
+} lcd_font_prop;
+
+/* Pixel width of 'len' characters of 'text', kerning included. */
+int lcd_font_prop_text_width(const lcd_font_prop *font, const char *text, int len);
+
+/* Glyph record for 'c'; characters outside the font's range map to the
+ * range start, so this never returns NULL. */
+const lcd_glyph *lcd_font_prop_glyph(const lcd_font_prop *font, char c);
+
+/* Kerning adjustment (usually negative) between 'left' and 'right', in
+ * pixels added to the advance of 'left'. 0 when the pair is not kerned. */
+int lcd_font_prop_kerning(const lcd_font_prop *font, char left, char right);
+
+/*
+ * Returns the 1-bpp bitmap of 'glyph' ready for row-by-row access. For a
+ * raw font this is a pointer into the bitmap pool; for an RLE font the
+ * glyph is PackBits-decoded into 'scratch' (LCD_GLYPH_MAX_BYTES) first.
+ */
+const uint8_t *lcd_font_prop_bitmap(const lcd_font_prop *font,
+                                    const lcd_glyph *glyph, uint8_t *scratch);
+
+/*
+ * Renders 'len' characters of 'text' into 'dst', which points at the
+ * top-left pixel of the line box. Only foreground pixels are written
+ * (kerned glyph boxes may overlap, so there is no opaque background);
+ * clear the destination first if needed. The caller sizes the
+ * destination from lcd_font_prop_text_width(); pixels left of 'dst'
+ * are clipped, nothing else is.
+ */
+void lcd_font_prop_render(const lcd_font_prop *font, uint8_t *dst, int stride_bytes,
+                          const char *text, int len, uint16_t fg);
+
+/*
+ * Renders 'len' characters of 'text' as one horizontal run into 'dst'.
+ * 'dst' points at the top-left pixel of the run; 'stride_bytes' is the
+ * distance between destination rows. Every pixel of the len*width x
+ * height block is written (foreground or background), and pixel bytes
+ * are stored little-endian, so 'dst' needs no particular alignment.
+ */
+void lcd_font_render(const lcd_font *font, uint8_t *dst, int stride_bytes,
+                     const char *text, int len, uint16_t fg, uint16_t bg);
+
+#endif /* LCD_FONT_H */
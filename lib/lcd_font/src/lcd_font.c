@@ -0,0 +1,317 @@
+/*!
+    \file    lcd_font.c
+    \brief   Packed bitmap fonts shared by the LCD projects
+
+    The glyph tables were lifted out of prj_lcd_test so that firmware
+    without a resident framebuffer (the USB display device) can render
+    text too. lcd_font_render() draws into any caller-supplied RGB565
+    buffer and writes the pixel bytes little-endian, so the destination
+    may be an unaligned byte buffer such as a DisplayManager slot.
+*/
+
+#include "lcd_font.h"
+
+/* 8x16 font data (one byte per row, MSB is the leftmost pixel) */
+static const unsigned char font8x16_data[256][16] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x00
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x01
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x02
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x03
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x04
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x05
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x06
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x07
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x08
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x09
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0a
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0b
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0c
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0d
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0e
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x0f
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x10
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x11
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x12
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x13
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x14
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x15
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x16
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x17
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x18
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x19
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1a
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1b
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1c
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1d
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1e
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 0x1f
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '!'
+    {0x66, 0x66, 0x66, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x6C, 0x6C, 0xFE, 0x6C, 0xFE, 0x6C, 0x6C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '#'
+    {0x38, 0x4C, 0x54, 0x28, 0x38, 0x54, 0x4A, 0x08, 0x1E, 0x28, 0x28, 0x1E, 0x00, 0x00, 0x00, 0x00}, // '$'
+    {0x62, 0x64, 0x08, 0x10, 0x20, 0x40, 0x42, 0x26, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '%'
+    {0x38, 0x44, 0x44, 0x38, 0x44, 0x44, 0x38, 0x00, 0x44, 0x28, 0x54, 0x44, 0x44, 0x00, 0x00, 0x00}, // '&'
+    {0x38, 0x38, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '''
+    {0x0C, 0x18, 0x30, 0x30, 0x30, 0x30, 0x18, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '('
+    {0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x0C, 0x18, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ')'
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '*'
+    {0x00, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ','
+    {0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '.'
+    {0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '/'
+    {0x7C, 0x82, 0x82, 0x82, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '0'
+    {0x18, 0x38, 0x18, 0x18, 0x18, 0x18, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '1'
+    {0x7C, 0x82, 0x02, 0x04, 0x18, 0x20, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '2'
+    {0x7C, 0x82, 0x02, 0x3C, 0x02, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '3'
+    {0x08, 0x18, 0x28, 0x48, 0xFE, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '4'
+    {0xFE, 0x80, 0x80, 0xFC, 0x02, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '5'
+    {0x7C, 0x82, 0x80, 0xFC, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '6'
+    {0xFE, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '7'
+    {0x7C, 0x82, 0x82, 0x7C, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '8'
+    {0x7C, 0x82, 0x82, 0x7E, 0x02, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '9'
+    {0x00, 0x30, 0x30, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ':'
+    {0x00, 0x30, 0x30, 0x00, 0x00, 0x30, 0x30, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ';'
+    {0x10, 0x28, 0x44, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '<'
+    {0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '='
+    {0x82, 0x44, 0x28, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '>'
+    {0x3C, 0x42, 0x82, 0x02, 0x04, 0x18, 0x18, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // '?'
+    {0x7C, 0x82, 0xBA, 0xAA, 0xAA, 0xB8, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '@'
+    {0x38, 0x44, 0x82, 0x82, 0xFC, 0x82, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'A'
+    {0xFC, 0x82, 0x82, 0xFC, 0x82, 0x82, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'B'
+    {0x7C, 0x82, 0x80, 0x80, 0x80, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'C'
+    {0xF8, 0x84, 0x82, 0x82, 0x82, 0x84, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'D'
+    {0xFE, 0x82, 0x80, 0xF8, 0x80, 0x82, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'E'
+    {0xFE, 0x82, 0x80, 0xF8, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'F'
+    {0x7C, 0x82, 0x80, 0x80, 0x8E, 0x82, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'G'
+    {0x82, 0x82, 0x82, 0xFE, 0x82, 0x82, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'H'
+    {0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'I'
+    {0x02, 0x02, 0x02, 0x02, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'J'
+    {0x82, 0x84, 0x88, 0xF0, 0x88, 0x84, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'K'
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x82, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'L'
+    {0x82, 0xC6, 0xAA, 0x92, 0x82, 0x82, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'M'
+    {0x82, 0xC2, 0xA2, 0x92, 0x8A, 0x86, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'N'
+    {0x7C, 0x82, 0x82, 0x82, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'O'
+    {0xFC, 0x82, 0x82, 0xFC, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'P'
+    {0x7C, 0x82, 0x82, 0x82, 0x8A, 0x84, 0x7A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'Q'
+    {0xFC, 0x82, 0x82, 0xFC, 0x88, 0x84, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'R'
+    {0x7C, 0x82, 0x80, 0x7C, 0x02, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'S'
+    {0xFE, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'T'
+    {0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x7C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'U'
+    {0x82, 0x82, 0x82, 0x44, 0x44, 0x28, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'V'
+    {0x82, 0x82, 0x82, 0x92, 0xAA, 0xC6, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'W'
+    {0x82, 0x82, 0x44, 0x38, 0x44, 0x82, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'X'
+    {0x82, 0x82, 0x44, 0x28, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'Y'
+    {0xFE, 0x04, 0x08, 0x10, 0x20, 0x40, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'Z'
+    {0x7E, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '['
+    {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '\'
+    {0x7E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ']'
+    {0x10, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00}, // '_'
+    {0x30, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '`'
+    {0x00, 0x00, 0x78, 0x84, 0x84, 0x78, 0x04, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'a'
+    {0x80, 0x80, 0xB8, 0xC4, 0xC4, 0xB8, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'b'
+    {0x00, 0x00, 0x78, 0x84, 0x80, 0x80, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'c'
+    {0x04, 0x04, 0x3C, 0x48, 0x48, 0x3C, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'd'
+    {0x00, 0x00, 0x78, 0x84, 0xF8, 0x80, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'e'
+    {0x38, 0x44, 0x40, 0xF0, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'f'
+    {0x00, 0x00, 0x78, 0x84, 0x84, 0x7C, 0x04, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'g'
+    {0x80, 0x80, 0xB8, 0xC4, 0xC4, 0xC4, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'h'
+    {0x30, 0x00, 0x70, 0x30, 0x30, 0x30, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'i'
+    {0x08, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x08, 0x88, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'j'
+    {0x80, 0x80, 0x88, 0x98, 0xE0, 0x98, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'k'
+    {0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'l'
+    {0x00, 0x00, 0xD8, 0xEC, 0xCC, 0xCC, 0xCC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'm'
+    {0x00, 0x00, 0xB8, 0xC4, 0xC4, 0xC4, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'n'
+    {0x00, 0x00, 0x78, 0x84, 0x84, 0x84, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'o'
+    {0x00, 0x00, 0xB8, 0xC4, 0xC4, 0xB8, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'p'
+    {0x00, 0x00, 0x78, 0x84, 0x84, 0x7C, 0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'q'
+    {0x00, 0x00, 0xB8, 0xC4, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'r'
+    {0x00, 0x00, 0x7C, 0x80, 0x78, 0x04, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 's'
+    {0x40, 0x40, 0xF8, 0x40, 0x40, 0x44, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 't'
+    {0x00, 0x00, 0xC4, 0xC4, 0xC4, 0xC4, 0xBC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'u'
+    {0x00, 0x00, 0x84, 0x84, 0x48, 0x48, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'v'
+    {0x00, 0x00, 0xC4, 0xC4, 0xC4, 0xD4, 0x68, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'w'
+    {0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'x'
+    {0x00, 0x00, 0x84, 0x84, 0x84, 0x7C, 0x04, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'y'
+    {0x00, 0x00, 0xF8, 0x08, 0x10, 0x20, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'z'
+    {0x0E, 0x18, 0x18, 0x70, 0x18, 0x18, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '{'
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '|'
+    {0x70, 0x18, 0x18, 0x0E, 0x18, 0x18, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '}'
+    {0x76, 0xDC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '~'
+};
+
+/* 16x24 font data (two bytes per row; a limited glyph set) */
+static const unsigned char font16x24_data[256][48] = {
+    [' '] = {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['!'] = {0x00,0x00,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x00,0x00,0x06,0x60,0x06,0x60,0x06,0x60,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['"'] = {0x19,0x80,0x19,0x80,0x19,0x80,0x19,0x80,0x0c,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['A'] = {0x00,0x00,0x01,0x80,0x03,0xc0,0x03,0xc0,0x06,0x60,0x0c,0x30,0x0c,0x30,0x18,0x18,0x18,0x18,0x3f,0xfc,0x3f,0xfc,0x30,0x0c,0x60,0x06,0x60,0x06,0xc0,0x03,0xc0,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['B'] = {0x00,0x00,0x3f,0xf0,0x3f,0xf0,0x30,0x60,0x30,0x60,0x30,0x60,0x30,0x60,0x3f,0xe0,0x3f,0xe0,0x30,0x60,0x30,0x60,0x30,0x60,0x30,0x60,0x3f,0xf0,0x3f,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['C'] = {0x00,0x00,0x0f,0xe0,0x1f,0xf0,0x30,0x60,0x60,0x30,0x60,0x00,0x60,0x00,0x60,0x00,0x60,0x00,0x60,0x00,0x60,0x30,0x30,0x60,0x1f,0xf0,0x0f,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['D'] = {0x00,0x00,0x3f,0xc0,0x3f,0xc0,0x30,0x60,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x60,0x3f,0xc0,0x3f,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['E'] = {0x00,0x00,0x3f,0xfc,0x3f,0xfc,0x30,0x00,0x30,0x00,0x30,0x00,0x3f,0xc0,0x3f,0xc0,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x3f,0xfc,0x3f,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['F'] = {0x00,0x00,0x3f,0xfc,0x3f,0xfc,0x30,0x00,0x30,0x00,0x30,0x00,0x3f,0xc0,0x3f,0xc0,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['G'] = {0x00,0x00,0x0f,0xe0,0x1f,0xf0,0x30,0x60,0x60,0x00,0x60,0x00,0x60,0x78,0x60,0x78,0x60,0x60,0x60,0x30,0x30,0x30,0x1f,0xf0,0x0f,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['H'] = {0x00,0x00,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x3f,0xfc,0x3f,0xfc,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['I'] = {0x00,0x00,0x0f,0xc0,0x0f,0xc0,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x0f,0xc0,0x0f,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['J'] = {0x00,0x00,0x00,0x78,0x00,0x78,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x30,0x30,0x30,0x30,0x3f,0xf0,0x1f,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['K'] = {0x00,0x00,0x30,0x18,0x30,0x30,0x30,0x60,0x30,0xc0,0x31,0x80,0x33,0x00,0x36,0x00,0x3c,0x00,0x36,0x00,0x33,0x00,0x31,0x80,0x30,0xc0,0x30,0x60,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['L'] = {0x00,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x3f,0xfc,0x3f,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['M'] = {0x00,0x00,0x60,0x06,0x60,0x06,0x63,0x86,0x63,0x86,0x67,0xc6,0x67,0xc6,0x6f,0xe6,0x6f,0xe6,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['N'] = {0x00,0x00,0x60,0x06,0x60,0x06,0x61,0x86,0x63,0x86,0x63,0xce,0x67,0xce,0x67,0xee,0x6f,0xee,0x6f,0x86,0x60,0x86,0x60,0x06,0x60,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['O'] = {0x00,0x00,0x0f,0xe0,0x1f,0xf0,0x30,0x30,0x60,0x18,0x60,0x18,0x60,0x18,0x60,0x18,0x60,0x18,0x30,0x30,0x1f,0xf0,0x0f,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['P'] = {0x00,0x00,0x3f,0xf0,0x3f,0xf0,0x30,0x60,0x30,0x60,0x30,0x60,0x3f,0xf0,0x3f,0xf0,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['Q'] = {0x00,0x00,0x0f,0xe0,0x1f,0xf0,0x30,0x30,0x60,0x18,0x60,0x18,0x60,0x18,0x60,0x18,0x60,0x18,0x30,0x30,0x1f,0xf0,0x0f,0xe0,0x00,0x30,0x00,0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['R'] = {0x00,0x00,0x3f,0xf0,0x3f,0xf0,0x30,0x60,0x30,0x60,0x30,0x60,0x3f,0xf0,0x3f,0xf0,0x33,0x00,0x31,0x80,0x30,0xc0,0x30,0x60,0x30,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['S'] = {0x00,0x00,0x0f,0xe0,0x1f,0xf0,0x30,0x60,0x30,0x00,0x1e,0x00,0x0f,0xc0,0x07,0x80,0x00,0x60,0x00,0x30,0x60,0x30,0x3f,0xf8,0x1f,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['T'] = {0x00,0x00,0x7f,0xfe,0x7f,0xfe,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['U'] = {0x00,0x00,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x60,0x06,0x30,0x30,0x1f,0xf0,0x0f,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['V'] = {0x00,0x00,0xc0,0x03,0xc0,0x03,0x60,0x06,0x60,0x06,0x30,0x0c,0x30,0x0c,0x18,0x18,0x18,0x18,0x0c,0x30,0x0c,0x30,0x06,0x60,0x03,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['W'] = {0x00,0x00,0xc0,0x03,0xc0,0x03,0xc0,0x03,0xc0,0x03,0x60,0x06,0x60,0x06,0x6f,0xe6,0x6f,0xe6,0x3f,0xfc,0x38,0x1c,0x38,0x1c,0x18,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['X'] = {0x00,0x00,0x60,0x06,0x30,0x0c,0x30,0x0c,0x18,0x18,0x0c,0x30,0x0c,0x30,0x07,0xe0,0x0c,0x30,0x0c,0x30,0x18,0x18,0x30,0x0c,0x60,0x06,0x60,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['Y'] = {0x00,0x00,0x60,0x06,0x60,0x06,0x30,0x0c,0x18,0x18,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x0c,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    ['Z'] = {0x00,0x00,0x7f,0xf8,0x7f,0xf8,0x00,0x60,0x00,0xc0,0x01,0x80,0x03,0x00,0x06,0x00,0x0c,0x00,0x18,0x00,0x30,0x00,0x60,0x00,0x7f,0xf8,0x7f,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+};
+
+const lcd_font lcd_font_8x16  = { 8, 16, 1, &font8x16_data[0][0] };
+const lcd_font lcd_font_16x24 = { 16, 24, 2, &font16x24_data[0][0] };
+
+void lcd_font_render(const lcd_font *font, uint8_t *dst, int stride_bytes,
+                     const char *text, int len, uint16_t fg, uint16_t bg)
+{
+    const uint8_t fg_lsb = (uint8_t)(fg & 0xFF), fg_msb = (uint8_t)(fg >> 8);
+    const uint8_t bg_lsb = (uint8_t)(bg & 0xFF), bg_msb = (uint8_t)(bg >> 8);
+
+    for (int n = 0; n < len; n++) {
+        const unsigned char *glyph = font->glyphs
+            + (unsigned)(unsigned char)text[n] * font->height * font->bytes_per_row;
+
+        for (int row = 0; row < font->height; row++) {
+            uint8_t *out = dst + row * stride_bytes + n * font->width * 2;
+            for (int col = 0; col < font->width; col++) {
+                unsigned char bits = glyph[row * font->bytes_per_row + (col >> 3)];
+                if ((bits >> (7 - (col & 7))) & 1) {
+                    out[0] = fg_lsb;
+                    out[1] = fg_msb;
+                } else {
+                    out[0] = bg_lsb;
+                    out[1] = bg_msb;
+                }
+                out += 2;
+            }
+        }
+    }
+}
+
+const lcd_glyph *lcd_font_prop_glyph(const lcd_font_prop *font, char c)
+{
+    unsigned code = (unsigned)(unsigned char)c;
+    if (code < font->first_char || code > font->last_char) {
+        code = font->first_char; /* render unknown characters as the range start */
+    }
+    return &font->glyphs[code - font->first_char];
+}
+
+int lcd_font_prop_kerning(const lcd_font_prop *font, char left, char right)
+{
+    /* The pair table is sorted by (left, right); binary search it. */
+    uint16_t key = (uint16_t)(((unsigned char)left << 8) | (unsigned char)right);
+    int lo = 0, hi = (int)font->kerning_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const lcd_kern_pair *pair = &font->kerning[mid];
+        uint16_t probe = (uint16_t)((pair->left << 8) | pair->right);
+        if (probe < key) {
+            lo = mid + 1;
+        } else if (probe > key) {
+            hi = mid - 1;
+        } else {
+            return pair->adjust;
+        }
+    }
+    return 0;
+}
+
+int lcd_font_prop_text_width(const lcd_font_prop *font, const char *text, int len)
+{
+    int width = 0;
+    for (int n = 0; n < len; n++) {
+        width += lcd_font_prop_glyph(font, text[n])->advance;
+        if (n + 1 < len) {
+            width += lcd_font_prop_kerning(font, text[n], text[n + 1]);
+        }
+    }
+    return width;
+}
+
+const uint8_t *lcd_font_prop_bitmap(const lcd_font_prop *font,
+                                    const lcd_glyph *glyph, uint8_t *scratch)
+{
+    const uint8_t *bitmap = font->bitmaps + glyph->bitmap_offset;
+
+    if (font->flags & LCD_FONT_PROP_RLE) {
+        /* PackBits: control 0..127 = N+1 literals, 129..255 = repeat 257-N. */
+        const uint8_t *in = bitmap;
+        int remaining = ((glyph->width + 7) / 8) * glyph->height;
+        uint8_t *out = scratch;
+        while (remaining > 0) {
+            uint8_t control = *in++;
+            if (control < 128) {
+                int count = control + 1;
+                remaining -= count;
+                while (count--) {
+                    *out++ = *in++;
+                }
+            } else {
+                int count = 257 - control;
+                uint8_t value = *in++;
+                remaining -= count;
+                while (count--) {
+                    *out++ = value;
+                }
+            }
+        }
+        bitmap = scratch;
+    }
+    return bitmap;
+}
+
+void lcd_font_prop_render(const lcd_font_prop *font, uint8_t *dst, int stride_bytes,
+                          const char *text, int len, uint16_t fg)
+{
+    const uint8_t fg_lsb = (uint8_t)(fg & 0xFF), fg_msb = (uint8_t)(fg >> 8);
+    uint8_t decoded[LCD_GLYPH_MAX_BYTES];
+    int pen = 0;
+
+    for (int n = 0; n < len; n++) {
+        const lcd_glyph *glyph = lcd_font_prop_glyph(font, text[n]);
+        int bytes_per_row = (glyph->width + 7) / 8;
+        const uint8_t *bitmap = lcd_font_prop_bitmap(font, glyph, decoded);
+
+        for (int row = 0; row < glyph->height; row++) {
+            int y = glyph->y_offset + row;
+            if (y < 0) {
+                continue;
+            }
+            uint8_t *out = dst + y * stride_bytes;
+            for (int col = 0; col < glyph->width; col++) {
+                int x = pen + glyph->x_offset + col;
+                if (x < 0) {
+                    continue;
+                }
+                uint8_t bits = bitmap[row * bytes_per_row + (col >> 3)];
+                if ((bits >> (7 - (col & 7))) & 1) {
+                    out[x * 2] = fg_lsb;
+                    out[x * 2 + 1] = fg_msb;
+                }
+            }
+        }
+
+        pen += glyph->advance;
+        if (n + 1 < len) {
+            pen += lcd_font_prop_kerning(font, text[n], text[n + 1]);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*!
+    \file    lcd_text.h
+    \brief   Cached RGB565 glyph cells over the lcd_font tables
+
+    Expanding a 1-bpp glyph into RGB565 costs a bit test plus a halfword
+    store per pixel — done per character per redraw it dominates the text
+    path. This module expands each (font, character, fg, bg) combination
+    once into an SRAM-resident "cell" covering the glyph's full advance
+    box, then reuses the cell: lcd_text_draw() chains the cells of a
+    string straight to the panel via lcd_write_rects(), lcd_text_render()
+    copies them row-by-row into a caller buffer (e.g. a DisplayManager
+    slot). Repeated label updates therefore reduce to DMA setup or
+    memcpy, with no per-pixel work at all.
+*/
+
+#ifndef LCD_TEXT_H
+#define LCD_TEXT_H
+
+#include <stdint.h>
+
+#include "lcd_font.h"
+
+/* Cache geometry. The defaults hold 16 cells of up to 320 pixels each
+ * (advance x line_height, e.g. 16x20 for the 16 px UI font), about 10 KB
+ * of SRAM. Projects can override them on the compiler command line. */
+#ifndef LCD_TEXT_CACHE_ENTRIES
+#define LCD_TEXT_CACHE_ENTRIES 16
+#endif
+#ifndef LCD_TEXT_CELL_BYTES
+#define LCD_TEXT_CELL_BYTES 640
+#endif
+
+/* Longest string lcd_text_draw() submits as one blit chain. */
+#ifndef LCD_TEXT_MAX_RUN
+#define LCD_TEXT_MAX_RUN 32
+#endif
+
+/* Drops every cached cell (e.g. after a theme/color change that would
+ * otherwise age out of the cache one miss at a time). */
+void lcd_text_cache_reset(void);
+
+/*
+ * Draws 'len' characters of 'text' at (x, y) on the panel, (x, y) being
+ * the top-left corner of the line box. The cells are submitted as one
+ * lcd_write_rects() chain, so the call returns while the DMA upload is
+ * still running; cached cells are stable storage, so no buffer lifetime
+ * management is needed. Waits for any previous upload first (a miss may
+ * evict a cell the in-flight chain is still reading). Characters that
+ * would cross the panel's right edge are dropped. Returns the advance
+ * width of what was drawn, in pixels.
+ */
+int lcd_text_draw(const lcd_font_prop *font, int x, int y,
+                  const char *text, int len, uint16_t fg, uint16_t bg);
+
+/*
+ * Renders 'len' characters of 'text' into 'dst' (top-left pixel of the
+ * line box, rows 'stride_bytes' apart) by copying cached cells, painting
+ * the full text_width x line_height block fg-over-bg. Pixel bytes are
+ * stored little-endian, so 'dst' needs no particular alignment. Returns
+ * the advance width in pixels.
+ */
+int lcd_text_render(const lcd_font_prop *font, uint8_t *dst, int stride_bytes,
+                    const char *text, int len, uint16_t fg, uint16_t bg);
+
+#endif /* LCD_TEXT_H */
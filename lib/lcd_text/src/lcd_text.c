@@ -0,0 +1,219 @@
+/*!
+    \file    lcd_text.c
+    \brief   Cached RGB565 glyph cells over the lcd_font tables
+
+    A cell is the fully expanded advance box of one glyph: advance x
+    line_height RGB565 pixels, background filled, glyph overlaid at its
+    bearing offsets. Cells live in a small direct-scan cache keyed by
+    (font, character, fg, bg) and evicted least-recently-used; UI text
+    reuses a few dozen characters in one or two color pairs, so steady
+    state is all hits. Because the cache is static storage, cells can be
+    handed to the scatter-gather DMA path as-is and stay valid for the
+    whole transfer.
+*/
+
+#include "lcd_text.h"
+
+#include <string.h>
+
+#include "lcd.h"
+
+typedef struct {
+    const lcd_font_prop *font;  /* NULL marks a free entry */
+    uint16_t fg, bg;
+    uint8_t ch;
+    uint8_t w, h;               /* cell size actually expanded */
+    uint32_t stamp;             /* last-use tick for LRU eviction */
+    uint16_t pixels[LCD_TEXT_CELL_BYTES / 2];
+} text_cell;
+
+static text_cell g_cells[LCD_TEXT_CACHE_ENTRIES];
+static uint32_t g_stamp;
+
+/* Descriptor chain handed to lcd_write_rects(); static because the DMA
+ * completion interrupt walks it after lcd_text_draw() has returned. */
+static lcd_blit_desc g_run[LCD_TEXT_MAX_RUN];
+
+void lcd_text_cache_reset(void)
+{
+    for (int n = 0; n < LCD_TEXT_CACHE_ENTRIES; n++) {
+        g_cells[n].font = 0;
+    }
+}
+
+static void expand_cell(text_cell *cell, const lcd_font_prop *font, char c,
+                        uint16_t fg, uint16_t bg)
+{
+    const lcd_glyph *glyph = lcd_font_prop_glyph(font, c);
+    uint8_t decoded[LCD_GLYPH_MAX_BYTES];
+    const uint8_t *bitmap = lcd_font_prop_bitmap(font, glyph, decoded);
+    int bytes_per_row = (glyph->width + 7) / 8;
+
+    /* Clamp oversized glyphs to what a cell can hold; fontgen output for
+     * the sizes we bake fits, this only guards hand-written tables. */
+    int h = font->line_height;
+    if (h > LCD_TEXT_CELL_BYTES / 2) {
+        h = LCD_TEXT_CELL_BYTES / 2;
+    }
+    int w = glyph->advance;
+    if (w > LCD_TEXT_CELL_BYTES / (2 * h)) {
+        w = LCD_TEXT_CELL_BYTES / (2 * h);
+    }
+
+    for (int n = 0; n < w * h; n++) {
+        cell->pixels[n] = bg;
+    }
+    for (int row = 0; row < glyph->height; row++) {
+        int y = glyph->y_offset + row;
+        if (y < 0 || y >= h) {
+            continue;
+        }
+        for (int col = 0; col < glyph->width; col++) {
+            int x = glyph->x_offset + col;
+            if (x < 0 || x >= w) {
+                continue;
+            }
+            uint8_t bits = bitmap[row * bytes_per_row + (col >> 3)];
+            if ((bits >> (7 - (col & 7))) & 1) {
+                cell->pixels[y * w + x] = fg;
+            }
+        }
+    }
+
+    cell->font = font;
+    cell->fg = fg;
+    cell->bg = bg;
+    cell->ch = (uint8_t)c;
+    cell->w = (uint8_t)w;
+    cell->h = (uint8_t)h;
+}
+
+static const text_cell *lookup_cell(const lcd_font_prop *font, char c,
+                                    uint16_t fg, uint16_t bg)
+{
+    text_cell *victim = &g_cells[0];
+
+    for (int n = 0; n < LCD_TEXT_CACHE_ENTRIES; n++) {
+        text_cell *cell = &g_cells[n];
+        if (cell->font == font && cell->ch == (uint8_t)c &&
+            cell->fg == fg && cell->bg == bg) {
+            cell->stamp = ++g_stamp;
+            return cell;
+        }
+        if (!cell->font) {
+            victim = cell; /* free entry beats any eviction */
+        } else if (victim->font && cell->stamp < victim->stamp) {
+            victim = cell;
+        }
+    }
+
+    expand_cell(victim, font, c, fg, bg);
+    victim->stamp = ++g_stamp;
+    return victim;
+}
+
+int lcd_text_draw(const lcd_font_prop *font, int x, int y,
+                  const char *text, int len, uint16_t fg, uint16_t bg)
+{
+    /* A cache miss below may evict a cell an in-flight chain is still
+     * reading, so drain the DMA channel before touching the cache. */
+    lcd_wait_dma_idle();
+
+    int pen = x;
+    int painted = (x < 0) ? 0 : x; /* right edge of the area covered so far */
+    int count = 0;
+
+    for (int n = 0; n < len && count < LCD_TEXT_MAX_RUN; n++) {
+        const lcd_glyph *glyph = lcd_font_prop_glyph(font, text[n]);
+        int advance = glyph->advance;
+        if (n + 1 < len) {
+            advance += lcd_font_prop_kerning(font, text[n], text[n + 1]);
+        }
+
+        if (glyph->advance && pen >= 0 && y >= 0 &&
+            y + font->line_height <= LCD_HEIGHT) {
+            const text_cell *cell = lookup_cell(font, text[n], fg, bg);
+            if (pen + cell->w > LCD_WIDTH) {
+                break;
+            }
+            /* Positive kerning (or a clamped cell) leaves a gap before
+             * this cell; cover it with a solid fill so stale pixels
+             * never show through between characters. */
+            if (pen > painted && count + 1 < LCD_TEXT_MAX_RUN) {
+                g_run[count].x = (uint8_t)painted;
+                g_run[count].y = (uint8_t)y;
+                g_run[count].w = (uint8_t)(pen - painted);
+                g_run[count].h = (uint8_t)cell->h;
+                g_run[count].pixels = 0;
+                g_run[count].color = bg;
+                count++;
+            }
+            g_run[count].x = (uint8_t)pen;
+            g_run[count].y = (uint8_t)y;
+            g_run[count].w = cell->w;
+            g_run[count].h = cell->h;
+            g_run[count].pixels = cell->pixels;
+            g_run[count].color = 0;
+            count++;
+            painted = pen + cell->w;
+        }
+        pen += advance;
+    }
+
+    if (count) {
+        lcd_write_rects(g_run, count);
+    }
+    return pen - x;
+}
+
+int lcd_text_render(const lcd_font_prop *font, uint8_t *dst, int stride_bytes,
+                    const char *text, int len, uint16_t fg, uint16_t bg)
+{
+    const uint8_t bg_lsb = (uint8_t)(bg & 0xFF), bg_msb = (uint8_t)(bg >> 8);
+    int pen = 0;
+    int painted = 0;
+
+    for (int n = 0; n < len; n++) {
+        const lcd_glyph *glyph = lcd_font_prop_glyph(font, text[n]);
+        int advance = glyph->advance;
+        if (n + 1 < len) {
+            advance += lcd_font_prop_kerning(font, text[n], text[n + 1]);
+        }
+
+        if (glyph->advance) {
+            const text_cell *cell = lookup_cell(font, text[n], fg, bg);
+            /* Backfill any gap left by positive kerning or clamping. */
+            for (int row = 0; row < cell->h; row++) {
+                uint8_t *out = dst + row * stride_bytes + painted * 2;
+                for (int col = painted; col < pen; col++) {
+                    *out++ = bg_lsb;
+                    *out++ = bg_msb;
+                }
+            }
+            for (int row = 0; row < cell->h; row++) {
+                memcpy(dst + row * stride_bytes + pen * 2,
+                       &cell->pixels[row * cell->w], cell->w * 2u);
+            }
+            if (pen + cell->w > painted) {
+                painted = pen + cell->w;
+            }
+        }
+        pen += advance;
+    }
+
+    /* Cover the tail if the last advance outran its cell. */
+    if (pen > painted) {
+        int h = font->line_height;
+        if (h > LCD_TEXT_CELL_BYTES / 2) {
+            h = LCD_TEXT_CELL_BYTES / 2;
+        }
+        for (int row = 0; row < h; row++) {
+            uint8_t *out = dst + row * stride_bytes + painted * 2;
+            for (int col = painted; col < pen; col++) {
+                *out++ = bg_lsb;
+                *out++ = bg_msb;
+            }
+        }
+    }
+    return pen;
+}
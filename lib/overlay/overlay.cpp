@@ -0,0 +1,97 @@
+/**
+ * @brief Overlay loader: inflates LZSS-packed cold code into the shared
+ * SRAM overlay region. See overlay.h for the scheme.
+ *
+ * The store layout is a private contract with bldmgr/ovlpack.py, which
+ * appends it to the flash image after the link: a header (magic "OVL1",
+ * overlay count), one directory entry per overlay (offset from the
+ * store base, compressed size, uncompressed size), then the blobs. An
+ * entry with csize == usize is stored raw.
+ */
+#include "overlay.h"
+
+#if defined(USE_CODE_OVERLAYS) && USE_CODE_OVERLAYS
+
+#include <stdio.h>
+#include <string.h>
+
+// Bounds from the generated overlay.ld fragment.
+extern "C" const uint8_t _ovl_lma[]; // packed store, in flash
+extern "C" uint8_t _ovl_ram[];       // shared execution region, in SRAM
+
+namespace {
+
+constexpr uint32_t STORE_MAGIC = 0x314C564FU; // "OVL1", little-endian
+
+struct StoreHeader {
+    uint32_t magic;
+    uint8_t  count;
+    uint8_t  reserved[3];
+};
+
+struct StoreEntry {
+    uint32_t offset; // blob position, from the store base
+    uint16_t csize;
+    uint16_t usize;
+};
+
+uint8_t loaded = 0xFF; // overlay resident in the region, 0xFF = none
+
+// Token stream: control bytes of eight LSB-first flags; 1 = literal
+// byte follows, 0 = back-reference pair [dist_lo, dist_hi:4|len-3:4]
+// with distances 1..4096 and lengths 3..18. Mirrors lzss_compress() in
+// bldmgr/ovlpack.py -- change the two together or not at all.
+void lzss_expand(const uint8_t *src, uint32_t csize, uint8_t *dst) {
+    const uint8_t *end = src + csize;
+    uint32_t ctrl = 1; // the set bit at position 0 marks "refill needed"
+    while (src < end) {
+        if (ctrl == 1) {
+            ctrl = 0x100U | *src++;
+            if (src >= end) break;
+        }
+        if (ctrl & 1) {
+            *dst++ = *src++;
+        } else {
+            uint8_t lo = *src++;
+            uint8_t hi = *src++;
+            const uint8_t *from = dst - ((((uint32_t)hi >> 4) << 8 | lo) + 1);
+            uint32_t len = (hi & 0x0F) + 3U;
+            // Byte-wise forward copy on purpose: overlapping references
+            // (run-length style matches) depend on it.
+            while (len--) *dst++ = *from++;
+        }
+        ctrl >>= 1;
+    }
+}
+
+} // namespace
+
+namespace ovl {
+
+bool load(uint8_t index) {
+    if (index == loaded) return true;
+    const StoreHeader *hdr = reinterpret_cast<const StoreHeader *>(_ovl_lma);
+    if (hdr->magic != STORE_MAGIC || index >= hdr->count) {
+        // The raw (unpacked) section images land here when the .elf was
+        // flashed directly; only the packed .bin/.hex carry the store.
+        printf("[ERROR] ovl: overlay store missing; flash the packed image.\n");
+        return false;
+    }
+    const StoreEntry *entry =
+        reinterpret_cast<const StoreEntry *>(_ovl_lma + sizeof(StoreHeader)) + index;
+    loaded = 0xFF; // the region holds nothing valid while the copy runs
+    if (entry->csize == entry->usize) {
+        memcpy(_ovl_ram, _ovl_lma + entry->offset, entry->usize);
+    } else {
+        lzss_expand(_ovl_lma + entry->offset, entry->csize, _ovl_ram);
+    }
+    // No instruction cache on this core, but drain the prefetch queue
+    // before anything jumps into the freshly written bytes.
+    asm volatile("fence.i");
+    loaded = index;
+    return true;
+}
+
+} // namespace ovl
+
+#endif /* USE_CODE_OVERLAYS */
@@ -0,0 +1,58 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <stdint.h>
+
+/**
+ * @brief On-demand code overlays: cold functions stored LZSS-compressed
+ * in flash and inflated into one shared SRAM region before they run.
+ *
+ * Flash is the scarce resource on the 128 KB part, and run-once code
+ * (init sequences, recovery paths) pays its full footprint forever.
+ * OVERLAY_TEXT(name) places a function in the .ovl.<name> section; the
+ * linker parks every overlay at the same RAM address (the OVERLAY
+ * directive in the build-generated overlay.ld fragment), and
+ * bldmgr/ovlpack.py replaces the raw section images in the .bin with a
+ * compressed store after the link. ovl::load() inflates one overlay
+ * into the region; reloading the resident one is free.
+ *
+ * Constraints: overlays must not call each other (NOCROSSREFS makes
+ * that a link error), must never be entered from interrupt context, and
+ * must only be reached through call sites that loaded them first. The
+ * RAM region comes out of the heap, bounded by the linker's
+ * __heap_floor assert.
+ *
+ * Projects without OVERLAYS in their config compile the same sources
+ * with the attribute expanding to nothing, so the code stays resident
+ * in flash exactly as before.
+ */
+#if defined(USE_CODE_OVERLAYS) && USE_CODE_OVERLAYS
+
+#define OVERLAY_TEXT(name) __attribute__((section(".ovl." #name), noinline))
+
+namespace ovl {
+
+/**
+ * @brief Inflates overlay `index` (its position in the project's
+ * OVERLAYS list) into the shared region.
+ *
+ * Returns false when the packed store is missing or the index is
+ * unknown -- typically an image flashed from the .elf instead of the
+ * packed .bin/.hex -- and the caller must then skip the overlaid
+ * feature rather than call into it.
+ */
+bool load(uint8_t index);
+
+} // namespace ovl
+
+#else /* !USE_CODE_OVERLAYS */
+
+#define OVERLAY_TEXT(name)
+
+namespace ovl {
+inline bool load(uint8_t) { return true; }
+} // namespace ovl
+
+#endif /* USE_CODE_OVERLAYS */
+
+#endif /* OVERLAY_H */
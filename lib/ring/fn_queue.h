@@ -0,0 +1,112 @@
+#ifndef FN_QUEUE_H
+#define FN_QUEUE_H
+
+#include "spsc_ring.h"
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+extern "C" {
+#include "deferred.h"
+}
+
+/**
+ * @brief Fixed-capacity queue of in-place callables: the standard
+ *        ISR-to-main-loop completion channel.
+ *
+ * spsc_ring ended the hand-rolled index pairs; this builds the next
+ * layer on it. Every async driver that finishes in an interrupt (card
+ * DMA, I2C events, USB transfers) needs to hand a completion to thread
+ * context, and each one has grown its own function pointer plus void*
+ * context plus volatile flag. A queued fnq::inplace_function replaces
+ * that trio: the ISR posts a small capturing lambda, the bound
+ * deferred level's task body calls service(), and the lambda runs in
+ * main-loop context with its status captured by value.
+ *
+ * No heap anywhere: the callable's capture is stored in the queue slot
+ * itself, so it must be trivially copyable and fit the byte budget -
+ * both checked at compile time. A full queue drops the post (counted,
+ * never blocking the ISR); producers pair the queue with a periodic
+ * pass that would pick up the lost work, the same fallback the polled
+ * flag designs already rely on.
+ *
+ * Single producer per queue, like the ring underneath. Subsystems
+ * whose completions fire from different interrupts share one queue
+ * only if those interrupts cannot preempt each other (see irq_map.h),
+ * otherwise they take a queue each.
+ */
+namespace fnq {
+
+/**
+ * Fixed-storage void() callable. Copying moves the capture bytes, so
+ * the queue can hold it by value; an empty one is falsy and must not
+ * be invoked.
+ */
+template <uint32_t Bytes = 16>
+class inplace_function {
+public:
+    inplace_function() = default;
+
+    template <typename F>
+    inplace_function(F f) {
+        static_assert(sizeof(F) <= Bytes,
+                      "capture exceeds the queue's storage budget");
+        static_assert(std::is_trivially_copyable<F>::value,
+                      "captures must be trivially copyable (slots are raw bytes)");
+        static_assert(alignof(F) <= alignof(uint64_t),
+                      "capture alignment exceeds the slot alignment");
+        ::new (static_cast<void *>(m_store)) F(f);
+        m_invoke = [](void *s) { (*static_cast<F *>(s))(); };
+    }
+
+    void operator()() { m_invoke(m_store); }
+    explicit operator bool() const { return m_invoke != nullptr; }
+
+private:
+    void (*m_invoke)(void *) = nullptr;
+    alignas(uint64_t) unsigned char m_store[Bytes];
+};
+
+template <uint32_t Depth, uint32_t Bytes = 16>
+class queue {
+public:
+    using fn = inplace_function<Bytes>;
+
+    /* The deferred level whose task body calls service(); posting a
+     * completion marks it ready, so dispatch latency is the scheduler's
+     * measured deferred_max_latency(level), not a polling interval. */
+    explicit queue(uint32_t level) : m_level(level) {}
+
+    /* Producer side, any ISR context. false = queue full: the callable
+     * was dropped and counted, never blocked on. */
+    bool post(const fn &f) {
+        if (!m_ring.push(f)) {
+            m_dropped++;
+            return false;
+        }
+        deferred_post(m_level);
+        return true;
+    }
+
+    /* Scheduler task body for the bound level: runs queued completions
+     * FIFO, to completion, with interrupts open. */
+    void service() {
+        fn f;
+        while (m_ring.pop(f)) {
+            f();
+        }
+    }
+
+    /* Posts refused on a full queue since boot (for the stats paths). */
+    uint32_t dropped() const { return m_dropped; }
+
+private:
+    spsc_ring<fn, Depth> m_ring;
+    uint32_t m_level;
+    volatile uint32_t m_dropped = 0;
+};
+
+} // namespace fnq
+
+#endif /* FN_QUEUE_H */
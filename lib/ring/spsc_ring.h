@@ -0,0 +1,71 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <cstdint>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * The ISR/main-loop handoff has been hand-rolled several times in this
+ * tree (the display slot indices, the debug UART TX ring, the encoder
+ * state), and index races in those copies have bitten us in the field.
+ * This is the shared primitive: the producer only writes m_head, the
+ * consumer only writes m_tail, and the indices are free-running so full
+ * and empty are never ambiguous.
+ *
+ * Memory-order notes for the single-core GD32VF103: an ISR and the code
+ * it interrupts always observe each other's stores in program order, so
+ * no AMO or fence instructions are needed (unlike the multi-context
+ * claim in evtrace.h). What must be pinned down is the compiler: the
+ * indices are volatile, and a compiler barrier keeps the element copy
+ * on the correct side of the index that publishes it.
+ *
+ * N must be a power of two; the indices are masked on use.
+ */
+template <typename T, uint32_t N>
+class spsc_ring {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    /* Producer side. Returns false (dropping `item`) when full, so an
+     * ISR producer never blocks. */
+    bool push(const T &item) {
+        uint32_t head = m_head;
+        if (head - m_tail == N) {
+            return false;
+        }
+        m_buf[head & (N - 1)] = item;
+        asm volatile("" ::: "memory"); // element lands before it is published
+        m_head = head + 1;
+        return true;
+    }
+
+    /* Consumer side. Returns false when empty. */
+    bool pop(T &item) {
+        uint32_t tail = m_tail;
+        if (m_head == tail) {
+            return false;
+        }
+        asm volatile("" ::: "memory"); // element is read after the index check
+        item = m_buf[tail & (N - 1)];
+        asm volatile("" ::: "memory"); // ... and before the slot is released
+        m_tail = tail + 1;
+        return true;
+    }
+
+    /* Snapshot; exact when called from either endpoint's own context. */
+    uint32_t size() const { return m_head - m_tail; }
+    bool empty() const { return m_head == m_tail; }
+    bool full() const { return size() == N; }
+    static constexpr uint32_t capacity() { return N; }
+
+    /* Consumer-side only: discards everything currently buffered. */
+    void clear() { m_tail = m_head; }
+
+private:
+    T m_buf[N];
+    volatile uint32_t m_head = 0;
+    volatile uint32_t m_tail = 0;
+};
+
+#endif /* SPSC_RING_H */
@@ -8,6 +8,21 @@
 #include "sd_card.h"
 #include "sd_spi_hal.h"
 #include <cstdio>
+#include <cstring>
+
+extern "C" {
+    #include "riscv_encoding.h" // read_csr(mcycle) for busy-wait accounting
+}
+
+// Cold-path placement: USE_CODE_OVERLAYS builds park the one-shot init
+// sequence in a compressed flash overlay loaded on demand (lib/overlay;
+// callers run ovl::load() first). Other builds keep it resident and the
+// macro expands to nothing.
+#if defined(USE_CODE_OVERLAYS) && USE_CODE_OVERLAYS
+#include "overlay.h"
+#else
+#define OVERLAY_TEXT(name)
+#endif
 
 // Use a namespace for all internal, file-local symbols and functions
 namespace {
@@ -20,9 +35,10 @@ using WORD  = uint16_t;
 
 // SD command definitions
 enum class SdCommand : uint8_t {
-    CMD0 = 0, CMD1 = 1, CMD8 = 8, CMD9 = 9, CMD12 = 12,
-    CMD16 = 16, CMD17 = 17, CMD18 = 18, CMD24 = 24, CMD25 = 25,
-    CMD55 = 55, CMD58 = 58, ACMD23 = 0x80 + 23, ACMD41 = 0x80 + 41
+    CMD0 = 0, CMD1 = 1, CMD8 = 8, CMD9 = 9, CMD10 = 10, CMD12 = 12,
+    CMD13 = 13, CMD16 = 16, CMD17 = 17, CMD18 = 18, CMD24 = 24,
+    CMD25 = 25, CMD55 = 55, CMD58 = 58, CMD59 = 59,
+    ACMD23 = 0x80 + 23, ACMD41 = 0x80 + 41
 };
 
 // Card type flags
@@ -36,17 +52,139 @@ constexpr BYTE CT_BLOCK = 0x08;
 volatile DSTATUS Stat = STA_NOINIT;
 BYTE CardType;
 
+// --- Hot-swap identity cache ---
+// The Longan Nano slot has no card-detect switch and SPI mode drives
+// DAT3 as chip select, so presence is sensed in-band (sd_card_present /
+// sd_card_detect) and a re-inserted card is recognized by its CID. For
+// the same physical card the clock governor's answer cannot change, so
+// sd_init re-applies the proven prescaler step and confirms it with one
+// CRC-checked read instead of re-running the whole step-down ladder.
+BYTE    known_cid[16];
+bool    have_known_card = false;
+uint8_t known_step = 0;
+
+// --- SD bus CRC (CRC7 for commands, CRC16-CCITT for data blocks) ---
+// SPI mode runs with CRC checking off by default, which has bitten us
+// with marginal cards silently corrupting data. The GD32VF103 CRC unit
+// only implements the fixed CRC-32 polynomial on 32-bit words, so it
+// cannot produce the SD bus CRCs; compile-time-generated lookup tables
+// are the next best thing (a few cycles per byte, well under the time
+// the same byte spends on the wire). CMD59 re-enables checking at init.
+bool crc_checking = false;
+
+// Data-phase failures since boot (sd_data_error_count()). Incremented
+// where the failure is detected, not where it is handled, so retried
+// blocks still count each attempt.
+static volatile uint32_t data_errors = 0;
+
+// Command-level counters (sd_cmd_stats()) and the optional observer
+// hook (sd_set_cmd_observer()). The counters are bumped where the
+// condition is detected -- send_cmd for issues and response timeouts,
+// wait_ready for busy time, the re-issue loops for retries -- so the
+// totals describe what actually went over the wire, including commands
+// issued from the DMA completion interrupt.
+sd_cmd_stats_t cmd_stats = {0, 0, 0, 0};
+void (*cmd_observer)(uint8_t, uint8_t) = nullptr;
+
+struct Crc7Table { BYTE t[256]; };
+constexpr Crc7Table crc7_make() {
+    // The register is kept pre-shifted (CRC7 in bits 7..1), so the
+    // polynomial x^7+x^3+1 (0x89) shifts up to 0x12 as well.
+    Crc7Table tbl{};
+    for (UINT i = 0; i < 256; i++) {
+        BYTE c = (BYTE)i;
+        for (UINT b = 0; b < 8; b++)
+            c = (c & 0x80) ? (BYTE)((c << 1) ^ 0x12) : (BYTE)(c << 1);
+        tbl.t[i] = c;
+    }
+    return tbl;
+}
+constexpr Crc7Table crc7_table = crc7_make();
+
+struct Crc16Table { WORD t[256]; };
+constexpr Crc16Table crc16_make() {
+    Crc16Table tbl{};
+    for (UINT i = 0; i < 256; i++) {
+        WORD c = (WORD)(i << 8);
+        for (UINT b = 0; b < 8; b++)
+            c = (c & 0x8000) ? (WORD)((c << 1) ^ 0x1021) : (WORD)(c << 1);
+        tbl.t[i] = c;
+    }
+    return tbl;
+}
+constexpr Crc16Table crc16_table = crc16_make();
+
+// CRC field of a 5-byte command frame: CRC7 shifted up with the end bit.
+BYTE crc7_field(const BYTE *p, UINT len) {
+    BYTE c = 0;
+    while (len--) c = crc7_table.t[c ^ *p++];
+    return (BYTE)(c | 1);
+}
+
+WORD crc16_block(const BYTE *p, UINT len) {
+    WORD c = 0;
+    while (len--) c = (WORD)((c << 8) ^ crc16_table.t[((c >> 8) ^ *p++) & 0xFF]);
+    return c;
+}
+
 // --- BUGFIX: Added separate flag for multi-block reads ---
 bool is_multi_block_write = false;
 bool is_multi_block_read = false;
 
+// Sequential read stream state: while a CMD18 is held open the card sits
+// selected in SEND_DATA state and the next data token arrives as soon as
+// we clock for it (the card is only clocked by us, so pausing between
+// calls is harmless).
+bool  stream_open = false;
+DWORD stream_next_sector = 0; // sector the open CMD18 delivers next
+
+// Sequential write stream state: while a CMD25 is held open each block is
+// programmed as it arrives and the stop-token/busy cycle is paid once at
+// the end of the run instead of per call.
+bool  wstream_open = false;
+DWORD wstream_next_sector = 0; // sector the open CMD25 programs next
+DWORD wstream_hint = 0;        // pending ACMD23 pre-erase length, in blocks
+
+// Asynchronous transfer engine. The command is issued in the caller's
+// context; after that one 512-byte block moves by DMA at a time and the
+// DMA completion interrupt handles the inter-block protocol bytes (CRC,
+// data tokens, write responses) and chains the next block, so the CPU is
+// free for USB and display work while the bus runs. Write-busy windows
+// are clocked by DMA dummy reads as well instead of spinning on MISO.
+enum class AsyncState : BYTE {
+    IDLE,
+    READ_DATA,      // a data block is streaming into the caller's buffer
+    WRITE_DATA,     // a data block is streaming out to the card
+    WRITE_BUSY,     // clocking dummy bytes while the card programs a block
+    WRITE_STOP_BUSY // same, after the final stop token of a CMD25 run
+};
+volatile AsyncState async_state = AsyncState::IDLE;
+BYTE       *async_rbuff;     // next read destination
+const BYTE *async_wbuff;     // next write source
+DWORD       async_remaining; // blocks not yet started
+bool        async_multi;
+sd_async_cb async_cb = nullptr;
+
+// Busy polling by DMA: 32 dummy clocks per completion interrupt keeps the
+// interrupt rate modest (one every ~20 us at full SPI speed) while the
+// card programs. The budget bounds the wait at roughly 500 ms.
+BYTE  async_busy_buf[32];
+DWORD async_busy_budget;
+constexpr DWORD ASYNC_BUSY_BUDGET = 25000;
+
 // --- SD Card Protocol Helper Functions (Internal to this file) ---
 
 int wait_ready(UINT wt) {
+    uint32_t start = read_csr(mcycle);
     hal_timer_start(wt);
     do {
-        if (hal_spi_xchg(0xFF) == 0xFF) return 1;
+        if (hal_spi_xchg(0xFF) == 0xFF) {
+            cmd_stats.busy_cycles += read_csr(mcycle) - start;
+            return 1;
+        }
     } while (!hal_timer_is_expired());
+    cmd_stats.busy_cycles += read_csr(mcycle) - start;
+    cmd_stats.timeouts++;
     return 0;
 }
 
@@ -74,19 +212,41 @@ BYTE send_cmd(SdCommand cmd, DWORD arg) {
         deselect();
         if (!_select()) return 0xFF;
     }
-    hal_spi_xchg(0x40 | static_cast<uint8_t>(cmd));
-    hal_spi_xchg((BYTE)(arg >> 24));
-    hal_spi_xchg((BYTE)(arg >> 16));
-    hal_spi_xchg((BYTE)(arg >> 8));
-    hal_spi_xchg((BYTE)arg);
-    n = (cmd == SdCommand::CMD0) ? 0x95 : ((cmd == SdCommand::CMD8) ? 0x87 : 0x01);
-    hal_spi_xchg(n);
+    BYTE frame[5] = {
+        (BYTE)(0x40 | static_cast<uint8_t>(cmd)),
+        (BYTE)(arg >> 24), (BYTE)(arg >> 16), (BYTE)(arg >> 8), (BYTE)arg,
+    };
+    for (n = 0; n < 5; n++) hal_spi_xchg(frame[n]);
+    hal_spi_xchg(crc7_field(frame, 5)); // always valid, CRC mode or not
     if (cmd == SdCommand::CMD12) hal_spi_xchg(0xFF);
     
     hal_timer_start(500);
     do {
         res = hal_spi_xchg(0xFF);
     } while ((res & 0x80) && !hal_timer_is_expired());
+    cmd_stats.commands++;
+    if (res & 0x80) cmd_stats.timeouts++; // response hunt expired
+    if (cmd_observer) cmd_observer(static_cast<uint8_t>(cmd), res);
+    return res;
+}
+
+// Bounded-response variant of send_cmd for the hot-swap probes: a
+// present card answers within NCR (8 bytes), while an empty slot reads
+// 0xFF forever, and the 500 ms response hunt in send_cmd would stall
+// the main loop for that long on every presence poll. The caller owns
+// select/deselect so the probes control exactly what touches the bus.
+BYTE send_cmd_quick(SdCommand cmd, DWORD arg) {
+    BYTE frame[5] = {
+        (BYTE)(0x40 | static_cast<uint8_t>(cmd)),
+        (BYTE)(arg >> 24), (BYTE)(arg >> 16), (BYTE)(arg >> 8), (BYTE)arg,
+    };
+    for (BYTE n = 0; n < 5; n++) hal_spi_xchg(frame[n]);
+    hal_spi_xchg(crc7_field(frame, 5));
+    BYTE res;
+    UINT n = 0;
+    do {
+        res = hal_spi_xchg(0xFF);
+    } while ((res & 0x80) && (++n < 16));
     return res;
 }
 
@@ -96,9 +256,14 @@ int rcvr_datablock_polling(BYTE *buff, UINT btr) {
     do {
         token = hal_spi_xchg(0xFF);
     } while ((token == 0xFF) && !hal_timer_is_expired());
-    if (token != 0xFE) return 0;
+    if (token != 0xFE) { data_errors++; return 0; }
     hal_spi_read_polling(buff, btr);
-    hal_spi_xchg(0xFF); hal_spi_xchg(0xFF);
+    BYTE crc_hi = hal_spi_xchg(0xFF);
+    BYTE crc_lo = hal_spi_xchg(0xFF);
+    if (crc_checking) {
+        WORD crc = (WORD)((crc_hi << 8) | crc_lo);
+        if (crc != crc16_block(buff, btr)) { data_errors++; return 0; }
+    }
     return 1;
 }
 
@@ -110,36 +275,241 @@ int xmit_datablock_polling(const BYTE *buff, BYTE token) {
     
     if (token != 0xFD) { // 0xFD is the "stop transaction" token, no data follows
         hal_spi_write_polling(buff, 512); // Use the new, clear function name
-        hal_spi_xchg(0xFF); // Dummy CRC
-        hal_spi_xchg(0xFF); // Dummy CRC
-        
+        WORD crc = crc_checking ? crc16_block(buff, 512) : 0xFFFF;
+        hal_spi_xchg((BYTE)(crc >> 8));
+        hal_spi_xchg((BYTE)crc);
+
         resp = hal_spi_xchg(0xFF); // Read response
         if ((resp & 0x1F) != 0x05) {
+            data_errors++;
             return 0; // Return 0 if write was not accepted
         }
     }
     return 1;
 }
 
+// --- SPI clock governor ---
+// The fast SPI clock used to be hardcoded to PCLK1/2, which fleet
+// experience says is both too timid for cards that run happily above
+// their 25 MHz rating and too brave for marginal ones. At init, read the
+// card's advertised limit from the CSD TRAN_SPEED field, start at the
+// fastest prescaler step that limit allows, and keep stepping down until
+// a CRC-verified read test passes.
+
+constexpr UINT GOVERNOR_PROBE_READS = 4;
+
+// Decode CSD TRAN_SPEED: bits 2..0 are the rate unit (100 kbit/s * 10^n)
+// and bits 6..3 the time value in tenths (0 is reserved).
+OVERLAY_TEXT(sd_init)
+DWORD csd_tran_speed_hz(const BYTE *csd) {
+    static const BYTE mant[16] = {0, 10, 12, 13, 15, 20, 25, 30,
+                                  35, 40, 45, 50, 55, 60, 70, 80};
+    DWORD rate = 10000U * mant[(csd[3] >> 3) & 0x0F];
+    for (BYTE n = csd[3] & 0x07; n; n--) rate *= 10;
+    return rate;
+}
+
+// One CMD17 of sector 0 at the current fast clock, with the data CRC
+// verified unconditionally: the card appends a valid CRC16 to read data
+// whether or not CMD59 enabled checking, so this works on cards where
+// crc_checking could not be turned on.
+OVERLAY_TEXT(sd_init)
+bool clock_probe_read(void) {
+    static BYTE buf[512];
+    if (send_cmd(SdCommand::CMD17, 0) != 0) {
+        deselect();
+        return false;
+    }
+    BYTE token;
+    hal_timer_start(200);
+    do {
+        token = hal_spi_xchg(0xFF);
+    } while ((token == 0xFF) && !hal_timer_is_expired());
+    if (token != 0xFE) {
+        deselect();
+        return false;
+    }
+    hal_spi_read_polling(buf, 512);
+    BYTE crc_hi = hal_spi_xchg(0xFF);
+    BYTE crc_lo = hal_spi_xchg(0xFF);
+    deselect();
+    return (WORD)((crc_hi << 8) | crc_lo) == crc16_block(buf, 512);
+}
+
+OVERLAY_TEXT(sd_init)
+void run_clock_governor(void) {
+    BYTE csd[16];
+    DWORD card_hz = 25000000; // Default Speed assumption if the CSD is unreadable
+    if ((send_cmd(SdCommand::CMD9, 0) == 0) && rcvr_datablock_polling(csd, 16)) {
+        card_hz = csd_tran_speed_hz(csd);
+    }
+    deselect();
+
+    // Pick the fastest step the card advertises it can take. The
+    // comparison gets 10% headroom so a 25 MHz TRAN_SPEED still admits
+    // the long-standing PCLK1/2 = 27 MHz setting; anything beyond that
+    // the probe below has to earn.
+    uint8_t step = 0;
+    while (step < HAL_SPI_PSC_STEP_MAX &&
+           hal_spi_clock_hz(step) > card_hz + card_hz / 10) {
+        step++;
+    }
+
+    for (; step <= HAL_SPI_PSC_STEP_MAX; step++) {
+        hal_spi_set_fast_prescaler(step);
+        hal_spi_set_speed(SdHalSpeed::HIGH);
+        UINT n;
+        for (n = 0; n < GOVERNOR_PROBE_READS; n++) {
+            if (!clock_probe_read()) break;
+        }
+        if (n == GOVERNOR_PROBE_READS) break; // this clock is stable
+        // A card that needs more ladder steps than it used to is a card
+        // on its way out; each step-down shows up in the fleet counters.
+        cmd_stats.retries++;
+    }
+    printf("[INFO] sd_init: SPI clock %lu kHz (CSD limit %lu kHz).\n",
+           (unsigned long)(hal_spi_clock_hz(hal_spi_get_fast_prescaler()) / 1000),
+           (unsigned long)(card_hz / 1000));
+}
+
+// --- Asynchronous engine steps (DMA completion interrupt context) ---
+
+void async_finish(DRESULT res) {
+    async_state = AsyncState::IDLE;
+    deselect();
+    if (async_cb) async_cb(res);
+}
+
+void async_read_step(void) {
+    BYTE crc_hi = hal_spi_xchg(0xFF); // CRC of the finished block
+    BYTE crc_lo = hal_spi_xchg(0xFF);
+    if (crc_checking) {
+        WORD crc = (WORD)((crc_hi << 8) | crc_lo);
+        if (crc != crc16_block(async_rbuff - 512, 512)) {
+            data_errors++;
+            if (async_multi) send_cmd(SdCommand::CMD12, 0);
+            async_finish(RES_ERROR);
+            return;
+        }
+    }
+    if (0 == async_remaining) {
+        if (async_multi) send_cmd(SdCommand::CMD12, 0);
+        async_finish(RES_OK);
+        return;
+    }
+    // Between CMD18 blocks the next data token normally follows within a
+    // byte or two; bound the hunt so a stalled card cannot wedge the ISR.
+    BYTE token;
+    UINT n = 0;
+    do {
+        token = hal_spi_xchg(0xFF);
+    } while ((token == 0xFF) && (++n < 512));
+    if (token != 0xFE) {
+        send_cmd(SdCommand::CMD12, 0);
+        async_finish(RES_ERROR);
+        return;
+    }
+    async_remaining--;
+    hal_spi_dma_read_start(async_rbuff, 512);
+    async_rbuff += 512;
+}
+
+void async_write_next_block(void) {
+    hal_spi_xchg(async_multi ? 0xFC : 0xFE); // data token
+    async_remaining--;
+    hal_spi_dma_write_start(async_wbuff, 512);
+    async_wbuff += 512;
+}
+
+void async_busy_start(AsyncState next) {
+    async_state = next;
+    async_busy_budget = ASYNC_BUSY_BUDGET;
+    hal_spi_dma_read_start(async_busy_buf, sizeof(async_busy_buf));
+}
+
+void async_write_step(void) {
+    WORD crc = crc_checking ? crc16_block(async_wbuff - 512, 512) : 0xFFFF;
+    hal_spi_xchg((BYTE)(crc >> 8)); // CRC of the block just sent
+    hal_spi_xchg((BYTE)crc);
+    BYTE resp = hal_spi_xchg(0xFF); // data response
+    if ((resp & 0x1F) != 0x05) {
+        async_finish(RES_ERROR);
+        return;
+    }
+    async_busy_start(AsyncState::WRITE_BUSY);
+}
+
+void async_busy_step(void) {
+    if (async_busy_buf[sizeof(async_busy_buf) - 1] != 0xFF) {
+        // Card still holds MISO low. Keep clocking, bounded by the budget.
+        if (0 == --async_busy_budget) {
+            async_finish(RES_ERROR);
+        } else {
+            hal_spi_dma_read_start(async_busy_buf, sizeof(async_busy_buf));
+        }
+        return;
+    }
+    if (AsyncState::WRITE_STOP_BUSY == async_state) {
+        async_finish(RES_OK);
+        return;
+    }
+    if (async_remaining) {
+        async_state = AsyncState::WRITE_DATA;
+        async_write_next_block();
+        return;
+    }
+    if (async_multi) {
+        hal_spi_xchg(0xFD); // stop transaction token
+        async_busy_start(AsyncState::WRITE_STOP_BUSY);
+    } else {
+        async_finish(RES_OK);
+    }
+}
+
+void async_dma_done(void) {
+    switch (async_state) {
+        case AsyncState::READ_DATA:       async_read_step();  break;
+        case AsyncState::WRITE_DATA:      async_write_step(); break;
+        case AsyncState::WRITE_BUSY:
+        case AsyncState::WRITE_STOP_BUSY: async_busy_step();  break;
+        case AsyncState::IDLE:            break; // legacy sd_*_dma_start path
+    }
+}
+
 } // End of anonymous namespace
 
 extern "C" {
 
+OVERLAY_TEXT(sd_init)
 DSTATUS sd_init(void) {
     BYTE n, cmd_int, ty, ocr[4];
+    stream_open = false; // any previous streams died with the old session
+    wstream_open = false;
+    async_state = AsyncState::IDLE;
+    crc_checking = false; // SPI mode comes up with CRC off until CMD59
     hal_spi_init();
+    hal_dma_set_callback(async_dma_done);
     hal_cs_high();
-    hal_delay_ms(10);
+    // The spec asks for 1 ms after the supply is stable before the
+    // dummy clocks; the old 10 ms padded a 10 ms-resolution tick timer
+    // and made every hot-swap insertion probe pay it.
+    hal_delay_us(1000);
     if (Stat & STA_NODISK) return Stat;
     hal_spi_set_speed(SdHalSpeed::LOW);
     for (n = 10; n; n--) hal_spi_xchg(0xFF);
     ty = 0;
-    if (send_cmd(SdCommand::CMD0, 0) == 1) {
+    // Bounded CMD0 instead of send_cmd: an empty slot never answers, and
+    // the 500 ms response hunt this used to spend on it would make the
+    // insertion poll (msc_mem_poll -> sd_card_detect -> here) unaffordable.
+    hal_cs_low();
+    hal_spi_flush_fifo();
+    BYTE r1 = send_cmd_quick(SdCommand::CMD0, 0);
+    if (r1 == 1) {
         hal_timer_start(1000);
         if (send_cmd(SdCommand::CMD8, 0x1AA) == 1) {
             for (n = 0; n < 4; n++) ocr[n] = hal_spi_xchg(0xFF);
             if (ocr[2] == 0x01 && ocr[3] == 0xAA) {
-                while (!hal_timer_is_expired() && send_cmd(SdCommand::ACMD41, 1UL << 30));
+                while (!hal_timer_is_expired() && send_cmd(SdCommand::ACMD41, 1UL << 30)) cmd_stats.retries++;
                 if (!hal_timer_is_expired() && send_cmd(SdCommand::CMD58, 0) == 0) {
                     for (n = 0; n < 4; n++) ocr[n] = hal_spi_xchg(0xFF);
                     ty = (ocr[0] & 0x40) ? CT_SD2 | CT_BLOCK : CT_SD2;
@@ -151,15 +521,44 @@ DSTATUS sd_init(void) {
             } else { 
                 ty = CT_MMC; cmd_int = static_cast<uint8_t>(SdCommand::CMD1); 
             }
-            while (!hal_timer_is_expired() && send_cmd(static_cast<SdCommand>(cmd_int), 0));
+            while (!hal_timer_is_expired() && send_cmd(static_cast<SdCommand>(cmd_int), 0)) cmd_stats.retries++;
             if (hal_timer_is_expired() || send_cmd(SdCommand::CMD16, 512) != 0) ty = 0;
         }
     }
     CardType = ty;
     deselect();
     if (ty) {
-        printf("[INFO] sd_init: Card type detected: 0x%02X. Initialization successful.\n", ty);
-        hal_spi_set_speed(SdHalSpeed::HIGH);
+        // SPI mode disables CRC checking by default; turn it back on so a
+        // marginal card fails loudly instead of handing over corrupt data.
+        crc_checking = (send_cmd(SdCommand::CMD59, 1) == 0);
+        deselect();
+        printf("[INFO] sd_init: Card type detected: 0x%02X. CRC checking %s.\n",
+               ty, crc_checking ? "enabled" : "unavailable");
+        // Re-identify the card for the hot-swap fast path: the same CID
+        // as the last successful init means the governor ladder would
+        // land on the same step, so re-apply it and prove it with one
+        // CRC-checked read. A different (or unreadable) CID runs the
+        // full governor as before.
+        BYTE cid[16];
+        bool cid_ok = (send_cmd(SdCommand::CMD10, 0) == 0) &&
+                      rcvr_datablock_polling(cid, 16);
+        deselect();
+        bool fast = false;
+        if (cid_ok && have_known_card && memcmp(cid, known_cid, 16) == 0) {
+            hal_spi_set_fast_prescaler(known_step);
+            hal_spi_set_speed(SdHalSpeed::HIGH);
+            fast = clock_probe_read();
+            if (fast) {
+                printf("[INFO] sd_init: known card, reusing SPI clock %lu kHz.\n",
+                       (unsigned long)(hal_spi_clock_hz(known_step) / 1000));
+            }
+        }
+        if (!fast) run_clock_governor(); // selects and applies the fast SPI clock
+        if (cid_ok) {
+            memcpy(known_cid, cid, 16);
+        }
+        have_known_card = cid_ok;
+        known_step = hal_spi_get_fast_prescaler();
         Stat &= static_cast<DSTATUS>(~STA_NOINIT);
     } else {
         printf("[ERROR] sd_init: Card initialization failed.\n");
@@ -170,7 +569,214 @@ DSTATUS sd_init(void) {
 
 DSTATUS sd_status(void) { return Stat; }
 
+uint32_t sd_data_error_count(void) { return data_errors; }
+
+const sd_cmd_stats_t *sd_cmd_stats(void) { return &cmd_stats; }
+
+void sd_set_cmd_observer(void (*fn)(uint8_t cmd, uint8_t response)) {
+    cmd_observer = fn;
+}
+
+// --- Hot-swap presence probes ---
+// No card-detect switch reaches the MCU and SPI mode owns DAT3 as chip
+// select, so presence is sensed in-band. Both probes are bounded to a
+// handful of SPI bytes; msc_mem_poll() calls them from the main loop.
+
+bool sd_card_present(void) {
+    if (Stat & STA_NOINIT) return false;
+    if (sd_async_busy()) return true; // a transfer is moving right now
+    // CMD13 needs the bus to itself; an idle open stream is closed and
+    // pays its reopen on the next sequential access -- once per poll
+    // interval at worst, noise against the blocks the stream moves.
+    sd_read_stream_stop();
+    sd_write_stream_stop();
+    hal_cs_low();
+    hal_spi_flush_fifo();
+    // A card still programming holds MISO low; an empty socket floats
+    // high. A ready timeout therefore means something is driving the
+    // line -- present, just busy -- while a missing card answers ready
+    // instantly and falls through to the unanswered-command check.
+    if (!wait_ready(50)) {
+        deselect();
+        return true;
+    }
+    BYTE res = send_cmd_quick(SdCommand::CMD13, 0);
+    if (res != 0xFF) hal_spi_xchg(0xFF); // consume the second R2 byte
+    deselect();
+    if (res == 0xFF) {
+        // Unanswered: the card is gone. Degrade immediately so every
+        // I/O entry point refuses with NOTRDY instead of timing out;
+        // the CID cache survives so the same card re-inits fast.
+        Stat = STA_NOINIT;
+        return false;
+    }
+    return true;
+}
+
+bool sd_card_detect(void) {
+    // Insertion probe for an empty slot. A freshly inserted card needs
+    // the 74-clock wake-up before it answers anything, and CMD0 doubles
+    // as the reset into SPI mode, so a hit here is expected to be
+    // followed by sd_init() right away.
+    if (!(Stat & STA_NOINIT)) return true;
+    hal_spi_set_speed(SdHalSpeed::LOW);
+    hal_cs_high();
+    for (BYTE n = 10; n; n--) hal_spi_xchg(0xFF);
+    hal_cs_low();
+    hal_spi_flush_fifo();
+    BYTE res = send_cmd_quick(SdCommand::CMD0, 0);
+    deselect();
+    return res == 0x01;
+}
+
+bool sd_async_busy(void) {
+    return async_state != AsyncState::IDLE;
+}
+
+DRESULT sd_read_blocks_async(uint8_t *buff, uint32_t sector, uint32_t count, sd_async_cb cb) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
+    if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
+    if (!(CardType & CT_BLOCK)) sector *= 512;
+
+    async_multi = (count > 1);
+    if (send_cmd(async_multi ? SdCommand::CMD18 : SdCommand::CMD17, sector) != 0) {
+        deselect();
+        return RES_ERROR;
+    }
+    // The first data token can take the card's full read access time, so
+    // wait for it here in the caller's context rather than in the ISR.
+    BYTE token;
+    hal_timer_start(200);
+    do {
+        token = hal_spi_xchg(0xFF);
+    } while ((token == 0xFF) && !hal_timer_is_expired());
+    if (token != 0xFE) {
+        if (async_multi) send_cmd(SdCommand::CMD12, 0);
+        deselect();
+        return RES_ERROR;
+    }
+
+    async_rbuff = buff + 512;
+    async_remaining = count - 1;
+    async_cb = cb;
+    async_state = AsyncState::READ_DATA;
+    hal_spi_dma_read_start(buff, 512);
+    return RES_OK;
+}
+
+DRESULT sd_write_blocks_async(const uint8_t *buff, uint32_t sector, uint32_t count, sd_async_cb cb) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
+    if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
+    if (Stat & STA_PROTECT) return RES_WRPRT;
+    if (!(CardType & CT_BLOCK)) sector *= 512;
+
+    async_multi = (count > 1);
+    if (async_multi && (CardType & CT_SDC)) send_cmd(SdCommand::ACMD23, count);
+    if (send_cmd(async_multi ? SdCommand::CMD25 : SdCommand::CMD24, sector) != 0) {
+        deselect();
+        return RES_ERROR;
+    }
+    if (!wait_ready(500)) {
+        deselect();
+        return RES_ERROR;
+    }
+
+    async_wbuff = buff;
+    async_remaining = count;
+    async_cb = cb;
+    async_state = AsyncState::WRITE_DATA;
+    async_write_next_block();
+    return RES_OK;
+}
+
+void sd_read_stream_stop(void) {
+    if (stream_open) {
+        send_cmd(SdCommand::CMD12, 0); // stop transmission
+        deselect();
+        stream_open = false;
+    }
+}
+
+void sd_write_stream_hint(uint32_t total_blocks) {
+    wstream_hint = total_blocks;
+}
+
+void sd_write_stream_stop(void) {
+    if (wstream_open) {
+        xmit_datablock_polling(nullptr, 0xFD); // stop token
+        deselect();
+        wstream_open = false;
+    }
+}
+
+DRESULT sd_write_stream(const uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
+    if (Stat & STA_PROTECT) return RES_WRPRT;
+    if (wstream_open && (sector != wstream_next_sector)) sd_write_stream_stop();
+    if (!wstream_open) {
+        sd_read_stream_stop();
+        // Pre-erase the whole announced run when the caller hinted one;
+        // otherwise fall back to the length of this call.
+        if (CardType & CT_SDC) {
+            DWORD hint = (wstream_hint > count) ? wstream_hint : count;
+            send_cmd(SdCommand::ACMD23, hint);
+        }
+        wstream_hint = 0;
+        DWORD addr = (CardType & CT_BLOCK) ? sector : sector * 512;
+        if (send_cmd(SdCommand::CMD25, addr) != 0) {
+            deselect();
+            return RES_ERROR;
+        }
+        wstream_open = true;
+    }
+    do {
+        if (!xmit_datablock_polling(buff, 0xFC)) {
+            sd_write_stream_stop();
+            return RES_ERROR;
+        }
+        buff += 512;
+        sector++;
+    } while (--count);
+    wstream_next_sector = sector;
+    // The stream stays open (card selected) for the next sequential call.
+    return RES_OK;
+}
+
+DRESULT sd_read_stream(uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
+    if (stream_open && (sector != stream_next_sector)) sd_read_stream_stop();
+    if (!stream_open) {
+        sd_write_stream_stop();
+        DWORD addr = (CardType & CT_BLOCK) ? sector : sector * 512;
+        if (send_cmd(SdCommand::CMD18, addr) != 0) {
+            deselect();
+            return RES_ERROR;
+        }
+        stream_open = true;
+    }
+    do {
+        if (!rcvr_datablock_polling(buff, 512)) {
+            sd_read_stream_stop();
+            return RES_ERROR;
+        }
+        buff += 512;
+        sector++;
+    } while (--count);
+    stream_next_sector = sector;
+    // The stream stays open (card selected) for the next sequential call.
+    return RES_OK;
+}
+
 DRESULT sd_read_blocks(uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
     if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
     if (!(CardType & CT_BLOCK)) sector *= 512;
     if (count == 1) {
@@ -189,6 +795,9 @@ DRESULT sd_read_blocks(uint8_t *buff, uint32_t sector, uint32_t count) {
 }
 
 DRESULT sd_write_blocks(const uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
     if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
     if (Stat & STA_PROTECT) return RES_WRPRT;
     if (!(CardType & CT_BLOCK)) sector *= 512;
@@ -209,6 +818,9 @@ DRESULT sd_write_blocks(const uint8_t *buff, uint32_t sector, uint32_t count) {
 }
 
 DRESULT sd_read_blocks_dma_start(uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
     if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
     if (!(CardType & CT_BLOCK)) sector *= 512;
     
@@ -224,6 +836,7 @@ DRESULT sd_read_blocks_dma_start(uint8_t *buff, uint32_t sector, uint32_t count)
         token = hal_spi_xchg(0xFF);
     } while ((token == 0xFF) && !hal_timer_is_expired());
     if (token != 0xFE) {
+        data_errors++;
         deselect();
         return RES_ERROR;
     }
@@ -233,6 +846,9 @@ DRESULT sd_read_blocks_dma_start(uint8_t *buff, uint32_t sector, uint32_t count)
 }
 
 DRESULT sd_write_blocks_dma_start(const uint8_t *buff, uint32_t sector, uint32_t count) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
     if (!count || (Stat & STA_NOINIT)) return RES_NOTRDY;
     if (Stat & STA_PROTECT) return RES_WRPRT;
     if (!(CardType & CT_BLOCK)) sector *= 512;
@@ -279,6 +895,9 @@ DRESULT sd_dma_transfer_status(void) {
 }
 
 DRESULT sd_ioctl(uint8_t cmd, void *buff) {
+    if (sd_async_busy()) return RES_NOTRDY;
+    sd_read_stream_stop();
+    sd_write_stream_stop();
     DRESULT res = RES_ERROR;
     BYTE n, csd[16];
     DWORD csize;
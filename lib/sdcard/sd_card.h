@@ -31,18 +31,92 @@ typedef enum {
 #define GET_BLOCK_SIZE		3
 
 /* --- Public API --- */
+// sd_init recognizes a card it has initialized before by its CID and
+// skips the SPI clock governor's step-down ladder for it (the proven
+// prescaler step is re-applied and confirmed with one CRC-checked
+// read), so a swapped-back card is ready again in well under a second.
+// USE_CODE_OVERLAYS builds store the whole sequence in a compressed
+// flash overlay: call ovl::load() for it before calling in (lib/overlay).
 DSTATUS sd_init(void);
 DSTATUS sd_status(void);
 
+// Hot-swap presence probes, bounded to a handful of SPI bytes so the
+// main loop can poll them. The slot has no card-detect switch and SPI
+// mode drives DAT3 as chip select, so presence is sensed in-band:
+// sd_card_present() asks an initialized card for its status (CMD13) and
+// degrades the driver to NOINIT when it no longer answers;
+// sd_card_detect() probes an empty slot with CMD0, which doubles as the
+// reset into SPI mode, so follow a hit with sd_init() immediately.
+bool sd_card_present(void);
+bool sd_card_detect(void);
+
 // Polling-based R/W functions (blocking)
 DRESULT sd_read_blocks(uint8_t *buff, uint32_t sector, uint32_t count);
 DRESULT sd_write_blocks(const uint8_t *buff, uint32_t sector, uint32_t count);
 
+// Data-phase failures since boot: read-token timeouts, CRC mismatches
+// and rejected write blocks, across the polling, stream and DMA paths.
+// A marginal card inflates this long before transfers fail outright,
+// so it is the health monitor's early-warning signal.
+uint32_t sd_data_error_count(void);
+
+// Command-level counters since boot (appended to the host stats report).
+// A degrading card shows up here as climbing retries/timeouts and a
+// growing busy share long before transfers fail outright -- the
+// complement to sd_data_error_count() on the command phase. Counters
+// are free-running u32s like the display pipeline's; monitoring works
+// on deltas, so wrap-around is harmless.
+typedef struct {
+    uint32_t commands;    /* command frames issued (CMD55 prefixes included) */
+    uint32_t retries;     /* re-issues after a failed or still-busy attempt  */
+    uint32_t timeouts;    /* response hunts and ready waits that expired     */
+    uint32_t busy_cycles; /* mcycle spent busy-polling the card (wait_ready) */
+} sd_cmd_stats_t;
+const sd_cmd_stats_t *sd_cmd_stats(void);
+
+// Optional command observer, called after every full-response command
+// frame with the command index and its R1 response; the application
+// typically points this at its binary trace ring (evtrace) to get a
+// command-level timeline next to the USB and blit events. The bounded
+// hot-swap probes are exempt: an empty slot answering 0xFF four times
+// a second would drown the window. NULL (the default) disables it.
+void sd_set_cmd_observer(void (*fn)(uint8_t cmd, uint8_t response));
+
+// Sequential read streaming: keeps one CMD18 multi-block read open across
+// calls, so a run of consecutive reads pays the command/response/token
+// latency once instead of per call. A call whose sector does not continue
+// the open run (or any other sd_* operation) closes the stream with
+// STOP_TRANSMISSION automatically; sd_read_stream_stop() closes it early.
+DRESULT sd_read_stream(uint8_t *buff, uint32_t sector, uint32_t count);
+void sd_read_stream_stop(void);
+
+// Sequential write streaming: the write-side counterpart. One CMD25 stays
+// open across consecutive calls, so the card programs a contiguous run
+// without a stop-token/busy cycle per call. sd_write_stream_hint()
+// announces the total length of the upcoming run so the ACMD23 pre-erase
+// covers the whole cluster range rather than one chunk. Any other sd_*
+// operation (including a read stream) finalizes the run automatically.
+DRESULT sd_write_stream(const uint8_t *buff, uint32_t sector, uint32_t count);
+void sd_write_stream_hint(uint32_t total_blocks);
+void sd_write_stream_stop(void);
+
 // DMA-based R/W functions (non-blocking)
 DRESULT sd_read_blocks_dma_start(uint8_t *buff, uint32_t sector, uint32_t count);
 DRESULT sd_write_blocks_dma_start(const uint8_t *buff, uint32_t sector, uint32_t count);
 DRESULT sd_dma_transfer_status(void);
 
+// Asynchronous R/W: the command is issued here, then each 512-byte block
+// moves by DMA and the completion interrupt handles the inter-block
+// protocol (CRC, data tokens, write-busy) and chains the next block. The
+// callback fires from the DMA interrupt once the whole transfer has
+// finished (including CMD12 / the stop token), so USB and display work
+// can overlap the card traffic. While a transfer is in flight every
+// other sd_* call returns RES_NOTRDY; check sd_async_busy() first.
+typedef void (*sd_async_cb)(DRESULT result);
+DRESULT sd_read_blocks_async(uint8_t *buff, uint32_t sector, uint32_t count, sd_async_cb cb);
+DRESULT sd_write_blocks_async(const uint8_t *buff, uint32_t sector, uint32_t count, sd_async_cb cb);
+bool sd_async_busy(void);
+
 DRESULT sd_ioctl(uint8_t cmd, void *buff);
 
 #ifdef __cplusplus
@@ -2,18 +2,25 @@
     \file    sd_spi_hal.cpp
     \brief   Implementation of the SD Card SPI Hardware Abstraction Layer for GD32VF103.
 
-    \version 2025-02-10, V1.7.0 (Heavy Debug Instrumentation)
+    \version 2025-02-10, V1.9.0 (Governed SPI clock)
 */
 
 #include "sd_spi_hal.h"
 #include "gd32vf103.h"
-#include <cstdio>
+#include "gpio.h"
+#include "mtimer.h"
+#include "ramtext.h"
+#include "trace.h"
+#include "vectors.h"
 
 extern "C" {
-    #include "systick.h"
     // This header contains the correct eclic_enable_interrupt function
-    #include "n200_func.h" 
-    void TIMER3_IRQHandler(void);
+    #include "n200_func.h"
+    #include "dma_arbiter.h"
+    void DMA0_Channel3_IRQHandler(void);
+    void DMA0_Channel4_IRQHandler(void);
+    void sd_dma_rx_vectored_entry(void);
+    void sd_dma_tx_vectored_entry(void);
 }
 
 // --- Hardware definitions for SPI1 remain the same ---
@@ -31,52 +38,68 @@ constexpr uint32_t SDCARD_DMA_PERIPH = DMA0;
 constexpr dma_channel_enum SDCARD_DMA_RX_CH = DMA_CH3;
 constexpr dma_channel_enum SDCARD_DMA_TX_CH = DMA_CH4;
 
-#define FCLK_SLOW() SPI_CTL0(SDCARD_SPI_PORT) = (SPI_CTL0(SDCARD_SPI_PORT) & ~SPI_CTL0_PSC) | SPI_PSC_256
-#define FCLK_FAST() SPI_CTL0(SDCARD_SPI_PORT) = (SPI_CTL0(SDCARD_SPI_PORT) & ~SPI_CTL0_PSC) | SPI_PSC_2
-#define CS_HIGH()   gpio_bit_set(SDCARD_GPIO_PORT, SDCARD_CS_PIN)
-#define CS_LOW()    gpio_bit_reset(SDCARD_GPIO_PORT, SDCARD_CS_PIN)
-
-// Definitions for debug printing
-#define ECLIC_INTIE_BASE (ECLIC_ADDR_BASE + 0x1000)
-#define ECLIC_INTIE_REG(irqn) (*(volatile uint32_t*)(ECLIC_INTIE_BASE + (irqn / 32) * 4))
-#define ECLIC_INTIE_BIT(irqn) (1U << (irqn % 32))
-
-// Debug function to print the status of critical registers
-void print_debug_regs(const char* stage) {
-    printf("\n--- DEBUG REG DUMP (%s) ---\n", stage);
-    printf("DMA_INTF: 0x%08lx\n", (unsigned long)DMA_INTF(SDCARD_DMA_PERIPH));
-    printf("RX (CH3) CTL: 0x%08lx (EN=%d, FTFIE=%d)\n",
-           (unsigned long)DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3),
-           (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3) & DMA_CHXCTL_CHEN) ? 1 : 0,
-           (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3) & DMA_CHXCTL_FTFIE) ? 1 : 0);
-    printf("TX (CH4) CTL: 0x%08lx (EN=%d, FTFIE=%d)\n",
-           (unsigned long)DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4),
-           (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4) & DMA_CHXCTL_CHEN) ? 1 : 0,
-           (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4) & DMA_CHXCTL_FTFIE) ? 1 : 0);
-    printf("SPI1_CTL1: 0x%08lx (DMATEN=%d, DMAREN=%d)\n",
-           (unsigned long)SPI_CTL1(SDCARD_SPI_PORT),
-           (SPI_CTL1(SDCARD_SPI_PORT) & SPI_CTL1_DMATEN) ? 1 : 0,
-           (SPI_CTL1(SDCARD_SPI_PORT) & SPI_CTL1_DMAREN) ? 1 : 0);
-    uint32_t irqn_rx = DMA0_Channel3_IRQn;
-    uint32_t irqn_tx = DMA0_Channel4_IRQn;
-    printf("ECLIC_INTIE: RX_IRQ_EN=%d, TX_IRQ_EN=%d\n",
-           (ECLIC_INTIE_REG(irqn_rx) & ECLIC_INTIE_BIT(irqn_rx)) ? 1 : 0,
-           (ECLIC_INTIE_REG(irqn_tx) & ECLIC_INTIE_BIT(irqn_tx)) ? 1 : 0);
-    printf("---------------------------------------\n");
-}
+// CS toggles bracket every SD command and every block transfer, so they
+// go through the typed compile-time pin (one BOP/BC store each) instead
+// of the SDK's runtime gpio_bit_* calls.
+using CsPin = Pin<SDCARD_GPIO_PORT, SDCARD_CS_PIN>;
+#define CS_HIGH()   CsPin::high()
+#define CS_LOW()    CsPin::low()
 
 namespace {
-volatile uint32_t Timeout_ms = 0;
+// Driver command/token timeout, polled by hal_timer_is_expired() between
+// useful work. An mtime deadline replaced the old TIMER3 10 ms tick: no
+// periodic interrupt, microsecond resolution, and the timeouts now mean
+// what the call sites say (the tick decremented once per 10 ms, so every
+// bound ran 10x long).
+mtimer_timeout cmd_timeout = {0};
 static uint8_t dummy_tx_ff = 0xFF;
 static uint8_t dummy_rx;
 volatile HalDmaStatus g_dma_status = HalDmaStatus::IDLE;
+// Prescaler step applied by hal_spi_set_speed(HIGH). Step 0 (PCLK1/2)
+// matches the old hardcoded fast clock; the SD driver's clock governor
+// moves it per card.
+uint8_t g_fast_psc_step = 0;
+// Completion hook invoked from the DMA interrupt; drives the SD driver's
+// asynchronous transfer engine.
+void (*g_dma_callback)(void) = nullptr;
+
+// Bring-up diagnostics: dump of the registers that decide whether a DMA
+// transfer can complete. Compiles to nothing below TRACE_LEVEL_DEBUG.
+void debug_dump_regs(const char *stage) {
+#if TRACE_MAX_LEVEL >= TRACE_LEVEL_DEBUG
+    #define ECLIC_INTIE_BASE (ECLIC_ADDR_BASE + 0x1000)
+    #define ECLIC_INTIE_REG(irqn) (*(volatile uint32_t*)(ECLIC_INTIE_BASE + (irqn / 32) * 4))
+    #define ECLIC_INTIE_BIT(irqn) (1U << (irqn % 32))
+    TRACE_DEBUG("\n--- DEBUG REG DUMP (%s) ---\n", stage);
+    TRACE_DEBUG("DMA_INTF: 0x%08lx\n", (unsigned long)DMA_INTF(SDCARD_DMA_PERIPH));
+    TRACE_DEBUG("RX (CH3) CTL: 0x%08lx (EN=%d, FTFIE=%d)\n",
+                (unsigned long)DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3),
+                (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3) & DMA_CHXCTL_CHEN) ? 1 : 0,
+                (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH3) & DMA_CHXCTL_FTFIE) ? 1 : 0);
+    TRACE_DEBUG("TX (CH4) CTL: 0x%08lx (EN=%d, FTFIE=%d)\n",
+                (unsigned long)DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4),
+                (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4) & DMA_CHXCTL_CHEN) ? 1 : 0,
+                (DMA_CHCTL(SDCARD_DMA_PERIPH, DMA_CH4) & DMA_CHXCTL_FTFIE) ? 1 : 0);
+    TRACE_DEBUG("SPI1_CTL1: 0x%08lx (DMATEN=%d, DMAREN=%d)\n",
+                (unsigned long)SPI_CTL1(SDCARD_SPI_PORT),
+                (SPI_CTL1(SDCARD_SPI_PORT) & SPI_CTL1_DMATEN) ? 1 : 0,
+                (SPI_CTL1(SDCARD_SPI_PORT) & SPI_CTL1_DMAREN) ? 1 : 0);
+    uint32_t irqn_rx = DMA0_Channel3_IRQn;
+    uint32_t irqn_tx = DMA0_Channel4_IRQn;
+    TRACE_DEBUG("ECLIC_INTIE: RX_IRQ_EN=%d, TX_IRQ_EN=%d\n",
+                (ECLIC_INTIE_REG(irqn_rx) & ECLIC_INTIE_BIT(irqn_rx)) ? 1 : 0,
+                (ECLIC_INTIE_REG(irqn_tx) & ECLIC_INTIE_BIT(irqn_tx)) ? 1 : 0);
+    TRACE_DEBUG("---------------------------------------\n");
+#else
+    (void)stage;
+#endif
+}
 
 
 static void configure_rcu(void) {
     rcu_periph_clock_enable(SDCARD_GPIO_CLK);
     rcu_periph_clock_enable(SDCARD_SPI_CLK);
     rcu_periph_clock_enable(RCU_DMA0);
-    rcu_periph_clock_enable(RCU_TIMER3);
 }
 
 static void configure_gpio(void) {
@@ -110,76 +133,56 @@ static void configure_dma(void) {
     dma_deinit(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
     dma_init_struct.direction    = DMA_MEMORY_TO_PERIPHERAL;
     dma_init_struct.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
-    dma_init_struct.priority     = DMA_PRIORITY_MEDIUM;
+    dma_init_struct.priority     = dma_arbiter_priority(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
     dma_circulation_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
     dma_init(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH, &dma_init_struct);
     dma_deinit(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH);
     dma_init_struct.direction    = DMA_PERIPHERAL_TO_MEMORY;
     dma_init_struct.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
-    dma_init_struct.priority     = DMA_PRIORITY_HIGH;
+    dma_init_struct.priority     = dma_arbiter_priority(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH);
     dma_circulation_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH);
     dma_init(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH, &dma_init_struct);
 }
 
-static void configure_timer(void) {
-    timer_parameter_struct timer_initpara;
-    
-    timer_deinit(TIMER3);
-    timer_initpara.prescaler         = static_cast<uint16_t>((rcu_clock_freq_get(CK_APB1) / 1000U) - 1U);
-    timer_initpara.period            = 9;
-    timer_initpara.alignedmode       = TIMER_COUNTER_EDGE;
-    timer_initpara.counterdirection  = TIMER_COUNTER_UP;
-    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
-    timer_initpara.repetitioncounter = 0;
-    timer_init(TIMER3, &timer_initpara);
-    
-    timer_update_event_enable(TIMER3);
-    timer_interrupt_enable(TIMER3,TIMER_INT_UP);
-    timer_flag_clear(TIMER3, TIMER_FLAG_UP);
-    timer_update_source_config(TIMER3, TIMER_UPDATE_SRC_GLOBAL);
-
-    timer_enable(TIMER3);
-}
-
 static void configure_driver_interrupts(void) {
     // This function only configures the interrupts needed by THIS driver.
     // It assumes the main ECLIC controller has already been initialized by the system startup code.
-    
-    eclic_enable_interrupt(TIMER3_IRQn);
 
     // Enable the specific interrupts we need for DMA
     eclic_enable_interrupt(DMA0_Channel3_IRQn);
     eclic_enable_interrupt(DMA0_Channel4_IRQn);
 
-    // Set priorities for these interrupts. Lower number is higher priority.
-    eclic_set_irq_priority(DMA0_Channel3_IRQn, 1);
-    eclic_set_irq_priority(DMA0_Channel4_IRQn, 1);
+    // Preemption levels and priorities come from the central map in
+    // lib/system/irq_map.c; only enable the sources here.
+
+    // The per-block DMA interrupts fire once per 512-byte sector during
+    // streamed transfers, so they bypass the shared trampoline: the ECLIC
+    // vectors straight into the RAM-resident entries (see vectors.h).
+    irq_vector_register(DMA0_Channel3_IRQn, sd_dma_rx_vectored_entry);
+    irq_vector_register(DMA0_Channel4_IRQn, sd_dma_tx_vectored_entry);
 }
 
 } // End anonymous namespace
 
 void hal_spi_init(void) {
+    g_fast_psc_step = 0; // re-init forgets the previous card's governed clock
     rcu_periph_reset_enable(SDCARD_SPI_RST);
     rcu_periph_reset_disable(SDCARD_SPI_RST);
     configure_rcu();
     configure_gpio();
     configure_spi();
     configure_dma();
-    configure_timer();
     configure_driver_interrupts(); // <-- Use the new, safer function
 }
 
 HalDmaStatus hal_dma_get_status(void) {
-    
-            printf("DMA Read Wait: INTF=0x%lx, TX_CNT=%lu, RX_CNT=%lu, SPI_STAT=0x%lx\n",
-                   (unsigned long)DMA_INTF(SDCARD_DMA_PERIPH),
-                   (unsigned long)dma_transfer_number_get(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH),
-                   (unsigned long)dma_transfer_number_get(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH),
-                   (unsigned long)SPI_STAT(SDCARD_SPI_PORT));
-
     return g_dma_status;
 }
 
+void hal_dma_set_callback(void (*cb)(void)) {
+    g_dma_callback = cb;
+}
+
 void hal_spi_dma_write_start(const uint8_t *buff, uint32_t count) {
     g_dma_status = HalDmaStatus::BUSY;
     
@@ -201,8 +204,9 @@ void hal_spi_dma_write_start(const uint8_t *buff, uint32_t count) {
     dma_channel_enable(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
     
     spi_dma_enable(SDCARD_SPI_PORT, SPI_DMA_TRANSMIT);
+    dma_arbiter_note_start(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH, count);
 
-    print_debug_regs("DMA Write Start");
+    debug_dump_regs("DMA Write Start");
 }
 
 void hal_spi_dma_read_start(uint8_t *buff, uint32_t count) {
@@ -227,11 +231,29 @@ void hal_spi_dma_read_start(uint8_t *buff, uint32_t count) {
     dma_channel_enable(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
     
     spi_dma_enable(SDCARD_SPI_PORT, SPI_DMA_RECEIVE);
+    dma_arbiter_note_start(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH, count);
+
+    debug_dump_regs("DMA Read Start");
+}
+
+void hal_spi_set_speed(SdHalSpeed speed) {
+    // The PSC field occupies CTL0 bits 5:3, so a step maps directly onto
+    // the register value (SPI_PSC_2 == 0 << 3 ... SPI_PSC_256 == 7 << 3).
+    uint32_t psc = (speed == SdHalSpeed::HIGH) ? ((uint32_t)g_fast_psc_step << 3)
+                                               : SPI_PSC_256;
+    SPI_CTL0(SDCARD_SPI_PORT) = (SPI_CTL0(SDCARD_SPI_PORT) & ~SPI_CTL0_PSC) | psc;
+}
+
+void hal_spi_set_fast_prescaler(uint8_t step) {
+    g_fast_psc_step = (step > HAL_SPI_PSC_STEP_MAX) ? HAL_SPI_PSC_STEP_MAX : step;
+}
+
+uint8_t hal_spi_get_fast_prescaler(void) { return g_fast_psc_step; }
 
-    print_debug_regs("DMA Read Start");
+uint32_t hal_spi_clock_hz(uint8_t step) {
+    return rcu_clock_freq_get(CK_APB1) >> (step + 1);
 }
 
-void hal_spi_set_speed(SdHalSpeed speed) { (speed == SdHalSpeed::HIGH) ? FCLK_FAST() : FCLK_SLOW(); }
 void hal_cs_high(void) { CS_HIGH(); }
 void hal_cs_low(void)  { CS_LOW(); }
 
@@ -256,29 +278,30 @@ void hal_spi_flush_fifo(void) {
     }
 }
 
-void hal_timer_start(uint32_t ms) { Timeout_ms = ms; }
-bool hal_timer_is_expired(void) { return (Timeout_ms == 0); }
-void hal_delay_ms(uint32_t ms) { delay_1ms(ms); }
+void hal_timer_start(uint32_t ms) { mtimer_timeout_start(&cmd_timeout, ms * 1000U); }
+bool hal_timer_is_expired(void) { return mtimer_timeout_expired(&cmd_timeout); }
+void hal_delay_ms(uint32_t ms) { delay_us(ms * 1000U); }
+void hal_delay_us(uint32_t us) { delay_us(us); }
 
 // --- Interrupt Service Routines ---
 extern "C" {
 
-void DMA0_Channel3_IRQHandler__(void) { // RX Channel for SPI1
-    print_debug_regs("DMA TX IRQ");
+RAMTEXT void DMA0_Channel3_IRQHandler(void) { // RX Channel for SPI1
     if(dma_interrupt_flag_get(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH, DMA_INT_FLAG_FTF)) {
         dma_interrupt_flag_clear(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH, DMA_INT_FLAG_G);
         dma_interrupt_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH, DMA_INT_FTF);
-        
+
         spi_dma_disable(SDCARD_SPI_PORT, SPI_DMA_RECEIVE | SPI_DMA_TRANSMIT);
         dma_channel_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_RX_CH);
         dma_channel_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH);
-        
+
         g_dma_status = HalDmaStatus::SUCCESS;
+        TRACE_DEBUG("SD DMA RX complete\n"); // bring-up builds only
+        if (g_dma_callback) g_dma_callback();
     }
 }
 
-void DMA0_Channel4_IRQHandler__(void) { // TX Channel for SPI1
-    print_debug_regs("DMA TX IRQ");
+RAMTEXT void DMA0_Channel4_IRQHandler(void) { // TX Channel for SPI1
     if(dma_interrupt_flag_get(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH, DMA_INT_FLAG_FTF)) {
         dma_interrupt_flag_clear(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH, DMA_INT_FLAG_G);
         dma_interrupt_disable(SDCARD_DMA_PERIPH, SDCARD_DMA_TX_CH, DMA_INT_FTF);
@@ -292,24 +315,25 @@ void DMA0_Channel4_IRQHandler__(void) { // TX Channel for SPI1
         hal_spi_flush_fifo();
 
         g_dma_status = HalDmaStatus::SUCCESS;
+        TRACE_DEBUG("SD DMA TX complete\n"); // bring-up builds only
+        if (g_dma_callback) g_dma_callback();
     }
 }
 
-void TIMER3_IRQHandler(void) {
-    {
-        static uint32_t my_counter_ms = 0; // Use a static variable to avoid reinitialization
-        my_counter_ms++;
-        if (my_counter_ms >= 1000) { // 1000 ms = 1 second
-            printf("TIMER3 IRQ: 1 second elapsed\n");
-            my_counter_ms = 0; // Reset the counter
-        }
-    }
-    if (RESET != timer_interrupt_flag_get(TIMER3, TIMER_INT_UP)) {
-        timer_interrupt_flag_clear(TIMER3, TIMER_INT_UP);
-        if (Timeout_ms > 0) {
-            Timeout_ms = Timeout_ms - 1; // Correct way to decrement volatile
-        }
-    }
+// Directly-vectored ECLIC entries for the two channels above. The
+// compiler-generated prolog/epilog replaces the full context save the
+// shared trampoline in entry.S performs for non-vectored interrupts.
+// These run at IRQ_LEVEL_STREAMING, so they reopen the interrupt window
+// and let USBFS preempt them.
+RAMTEXT IRQ_VECTORED void sd_dma_rx_vectored_entry(void) {
+    IRQ_PREEMPT_ENTER();
+    DMA0_Channel3_IRQHandler();
+    IRQ_PREEMPT_EXIT();
+}
+RAMTEXT IRQ_VECTORED void sd_dma_tx_vectored_entry(void) {
+    IRQ_PREEMPT_ENTER();
+    DMA0_Channel4_IRQHandler();
+    IRQ_PREEMPT_EXIT();
 }
 
 void hal_spi_write_polling(const uint8_t *buff, uint32_t count) {
@@ -2,7 +2,7 @@
     \file    sd_spi_hal.h
     \brief   Header for the SD Card SPI Hardware Abstraction Layer.
 
-    \version 2025-02-10, V1.3.1
+    \version 2025-02-10, V1.4.0 (Governed fast clock)
 */
 
 #ifndef SD_SPI_HAL_H
@@ -20,6 +20,16 @@ enum class HalDmaStatus { IDLE, BUSY, SUCCESS, ERROR };
 // --- HAL Public API ---
 void hal_spi_init(void);
 void hal_spi_set_speed(SdHalSpeed speed);
+
+// The HIGH speed is no longer a fixed prescaler: it is a governed step
+// chosen at init time. Step 0 is PCLK1/2 (27 MHz at the stock clock
+// tree); each step halves the clock down to step 7 (PCLK1/256, which is
+// also the identification speed used for LOW).
+constexpr uint8_t HAL_SPI_PSC_STEP_MAX = 7;
+void hal_spi_set_fast_prescaler(uint8_t step);
+uint8_t hal_spi_get_fast_prescaler(void);
+// SPI bit clock in Hz that a given prescaler step yields.
+uint32_t hal_spi_clock_hz(uint8_t step);
 void hal_cs_high(void);
 void hal_cs_low(void);
 uint8_t hal_spi_xchg(uint8_t data);
@@ -30,11 +40,18 @@ void hal_spi_dma_read_start(uint8_t *buff, uint32_t count);
 void hal_spi_dma_write_start(const uint8_t *buff, uint32_t count);
 void hal_spi_write_polling(const uint8_t *buff, uint32_t count);
 HalDmaStatus hal_dma_get_status(void);
+// Registers a hook invoked from the DMA completion interrupt once the
+// channel is torn down and the status is SUCCESS. Runs in ISR context.
+void hal_dma_set_callback(void (*cb)(void));
 
 void hal_spi_flush_fifo(void);
+// Non-blocking driver timeout: start a bound, then poll expiry between
+// useful work. mtime-based (see lib/system/mtimer.h), so the bound is
+// exact - the old TIMER3 tick expired these 10x late.
 void hal_timer_start(uint32_t ms);
 bool hal_timer_is_expired(void);
 void hal_delay_ms(uint32_t ms);
+void hal_delay_us(uint32_t us);
 
 #ifdef __cplusplus
 }
@@ -10,6 +10,71 @@
 #include <cstdio>      // For printf
 #include <cstring>     // For memset and memcmp
 
+extern "C" {
+    #include "gd32vf103.h"      // SystemCoreClock for cycle->us conversion
+    #include "riscv_encoding.h" // read_csr(mcycle) for benchmark timing
+}
+
+namespace {
+
+// Largest transfer a single benchmark command moves (buffer lives in
+// bench_pass so builds that never benchmark do not pay for it).
+constexpr uint32_t BENCH_BUF_BLOCKS = 8;
+constexpr uint32_t SECTOR_BYTES = 512;
+
+// Per-command latency histogram. Bucket bounds are in microseconds and
+// roughly decade-spaced; card stalls show up as a long tail here while
+// the averages still look fine.
+struct LatencyHist {
+    static constexpr uint32_t bounds_us[] =
+        {200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+    static constexpr uint32_t NUM_BUCKETS =
+        sizeof(bounds_us) / sizeof(bounds_us[0]) + 1; // + overflow bucket
+
+    uint32_t counts[NUM_BUCKETS] = {};
+    uint32_t min_us = 0xFFFFFFFF;
+    uint32_t max_us = 0;
+
+    void add(uint32_t us) {
+        if (us < min_us) min_us = us;
+        if (us > max_us) max_us = us;
+        uint32_t b = 0;
+        while ((b < NUM_BUCKETS - 1) && (us > bounds_us[b])) b++;
+        counts[b]++;
+    }
+
+    void print() const {
+        printf("     latency: min %lu us, max %lu us\n",
+               (unsigned long)min_us, (unsigned long)max_us);
+        for (uint32_t b = 0; b < NUM_BUCKETS; b++) {
+            if (0 == counts[b]) continue;
+            if (b < NUM_BUCKETS - 1) {
+                printf("       <= %5lu us: %lu\n",
+                       (unsigned long)bounds_us[b], (unsigned long)counts[b]);
+            } else {
+                printf("       >  %5lu us: %lu\n",
+                       (unsigned long)bounds_us[NUM_BUCKETS - 2],
+                       (unsigned long)counts[b]);
+            }
+        }
+    }
+};
+
+inline uint32_t cycles_to_us(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+// Small xorshift PRNG for the random-access passes; deterministic so two
+// runs on the same card are comparable.
+inline uint32_t rnd_next(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // anonymous namespace
+
 SdCardTest::SdCardTest(uint32_t test_sector)
     : _test_sector(test_sector), _is_initialized(false) {
     // Constructor initializes the test sector and state
@@ -111,6 +176,105 @@ bool SdCardTest::run_read_write_test() {
     return true;
 }
 
+bool SdCardTest::bench_pass(const char *name, bool is_write, bool is_random,
+                            uint32_t base_sector, uint32_t window_sectors,
+                            uint32_t blocks_per_cmd, uint32_t commands) {
+    // One buffer shared by every pass; static so it is not on the stack,
+    // function-local so --gc-sections drops it when nothing benchmarks.
+    static uint8_t bench_buf[BENCH_BUF_BLOCKS * SECTOR_BYTES];
+
+    if (blocks_per_cmd > BENCH_BUF_BLOCKS) return false;
+
+    // The write passes need recognizable data; reads just overwrite it.
+    if (is_write) {
+        for (uint32_t i = 0; i < blocks_per_cmd * SECTOR_BYTES; i++) {
+            bench_buf[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    LatencyHist hist;
+    uint64_t total_cycles = 0;
+    uint32_t rnd_state = 0xC0FFEE01;
+    uint32_t sector = base_sector;
+    bool ok = true;
+
+    for (uint32_t n = 0; n < commands; n++) {
+        if (is_random) {
+            sector = base_sector + (rnd_next(rnd_state) % (window_sectors - blocks_per_cmd));
+        }
+
+        uint32_t start = read_csr(mcycle);
+        DRESULT res = is_write
+            ? sd_write_blocks(bench_buf, sector, blocks_per_cmd)
+            : sd_read_blocks(bench_buf, sector, blocks_per_cmd);
+        uint32_t cycles = read_csr(mcycle) - start; // wrap-safe unsigned delta
+
+        if (res != RES_OK) {
+            printf("   %s: FAILED at sector %lu\n", name, (unsigned long)sector);
+            ok = false;
+            break;
+        }
+
+        hist.add(cycles_to_us(cycles));
+        total_cycles += cycles;
+        if (!is_random) sector += blocks_per_cmd;
+    }
+
+    if (ok && (total_cycles > 0)) {
+        uint64_t total_bytes = (uint64_t)commands * blocks_per_cmd * SECTOR_BYTES;
+        uint32_t kb_per_s = (uint32_t)(total_bytes * SystemCoreClock / total_cycles / 1024U);
+        printf("   %s: %lu.%03lu MB/s (%lu cmds x %lu blk)\n",
+               name,
+               (unsigned long)(kb_per_s / 1024U),
+               (unsigned long)(((kb_per_s % 1024U) * 1000U) / 1024U),
+               (unsigned long)commands, (unsigned long)blocks_per_cmd);
+        hist.print();
+    }
+    return ok;
+}
+
+bool SdCardTest::run_benchmarks() {
+    printf("\n--- SD Card Characterization Benchmarks ---\n");
+
+    if (!check_initialization()) {
+        printf("--- Benchmarks ABORTED ---\n");
+        return false;
+    }
+
+    uint32_t total_sectors = 0;
+    if (sd_ioctl(GET_SECTOR_COUNT, &total_sectors) != RES_OK || total_sectors < (1UL << 17)) {
+        printf("Card too small or capacity unknown; benchmarks skipped.\n");
+        return false;
+    }
+
+    // Reads are non-destructive and run in the middle of the card; the
+    // random pass jumps inside a 64K-sector (32 MB) window to make the
+    // card actually seek.
+    uint32_t read_base = total_sectors / 2;
+    uint32_t read_window = 1UL << 16;
+
+    // Writes are destructive: they use a scratch region covering the
+    // last 4096 sectors (2 MB) of the card.
+    uint32_t scratch_sectors = 4096;
+    uint32_t scratch_base = total_sectors - scratch_sectors;
+    printf("NOTE: write passes overwrite sectors %lu..%lu\n",
+           (unsigned long)scratch_base, (unsigned long)(total_sectors - 1));
+
+    bool ok = true;
+    ok &= bench_pass("seq read   1 blk", false, false, read_base, read_window, 1, 64);
+    ok &= bench_pass("seq read   4 blk", false, false, read_base, read_window, 4, 64);
+    ok &= bench_pass("seq read   8 blk", false, false, read_base, read_window, 8, 64);
+    ok &= bench_pass("rnd read   1 blk", false, true, read_base, read_window, 1, 128);
+
+    ok &= bench_pass("seq write  1 blk", true, false, scratch_base, scratch_sectors, 1, 32);
+    ok &= bench_pass("seq write  4 blk", true, false, scratch_base, scratch_sectors, 4, 32);
+    ok &= bench_pass("seq write  8 blk", true, false, scratch_base, scratch_sectors, 8, 32);
+    ok &= bench_pass("rnd write  1 blk", true, true, scratch_base, scratch_sectors, 1, 64);
+
+    printf("--- Benchmarks %s ---\n\n", ok ? "DONE" : "FAILED");
+    return ok;
+}
+
 #if 0
 // This file uses the C++ API, so it should call the C++ version of sd_ioctl
 // No dummy function is needed if we call the correct type.
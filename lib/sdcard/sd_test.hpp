@@ -35,6 +35,22 @@ public:
      */
     bool run_tests();
 
+    /**
+     * @brief Runs the card characterization benchmarks.
+     *
+     * Measures sequential and random read/write throughput at several
+     * block counts, timed with the mcycle counter, and prints MB/s plus
+     * a per-command latency histogram over the debug UART. Used to
+     * qualify cards for production units.
+     *
+     * WARNING: the write passes overwrite a scratch region at the end
+     * of the card (the last few MB). Run it on blank/qualification
+     * cards only.
+     *
+     * @return true if every benchmark command completed without error.
+     */
+    bool run_benchmarks();
+
 private:
     /**
      * @brief Verifies that the SD card is present and initialized.
@@ -48,6 +64,22 @@ private:
      */
     bool run_read_write_test();
 
+    /**
+     * @brief Runs one benchmark pass and prints its results.
+     * @param name Label printed in front of the results.
+     * @param is_write true to write, false to read.
+     * @param is_random true for a random sector per command, false for
+     *                  one sequential run.
+     * @param base_sector First sector of the region the pass may touch.
+     * @param window_sectors Size of that region.
+     * @param blocks_per_cmd Blocks moved by each command.
+     * @param commands Number of timed commands.
+     * @return true if every command completed without error.
+     */
+    bool bench_pass(const char *name, bool is_write, bool is_random,
+                    uint32_t base_sector, uint32_t window_sectors,
+                    uint32_t blocks_per_cmd, uint32_t commands);
+
     // Member variables
     uint32_t _test_sector;
     bool _is_initialized;
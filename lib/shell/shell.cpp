@@ -0,0 +1,148 @@
+#include "shell.h"
+#include "spsc_ring.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace shell {
+
+namespace {
+
+constexpr uint32_t LineMax = 96; // longest accepted command line
+constexpr int ArgvMax = 8;
+
+const Command *g_table = nullptr;
+uint32_t g_count = 0;
+
+// Transport ISR -> service(). 256 bytes rides out a pasted multi-line
+// script between SOF-paced service passes.
+spsc_ring<char, 256> g_rx;
+
+// Handlers -> transport drain. Sized so one `stats` worth of lines fits
+// without dropping; overflow drops the tail, never blocks the handler.
+spsc_ring<char, 1024> g_tx;
+
+char g_line[LineMax];
+uint32_t g_len = 0;
+bool g_discard = false; // overlong line: eat bytes until the newline
+
+// NUL-splits the accumulated line in place and runs the matching table
+// entry; argv[] points into g_line, so nothing is copied.
+void dispatch()
+{
+    char *argv[ArgvMax];
+    int argc = 0;
+    char *p = g_line;
+    while (*p != '\0') {
+        while (*p == ' ') {
+            *p++ = '\0';
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (argc < ArgvMax) {
+            argv[argc++] = p;
+        }
+        while (*p != '\0' && *p != ' ') {
+            p++;
+        }
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < g_count; i++) {
+        if (strcmp(argv[0], g_table[i].name) == 0) {
+            g_table[i].fn(argc, argv);
+            return;
+        }
+    }
+    if (strcmp(argv[0], "help") == 0) {
+        for (uint32_t i = 0; i < g_count; i++) {
+            printf("  %-8s %s\n", g_table[i].name, g_table[i].help);
+        }
+        return;
+    }
+    printf("unknown command '%s' (try `help`)\n", argv[0]);
+}
+
+} // namespace
+
+void init(const Command *table, uint32_t count)
+{
+    g_table = table;
+    g_count = count;
+}
+
+void rx(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        g_rx.push(static_cast<char>(data[i])); // full ring: byte dropped
+    }
+}
+
+void service()
+{
+    char c;
+    while (g_rx.pop(c)) {
+        if (c == '\r') {
+            continue; // terminal CRLF: the LF does the work
+        }
+        if (c == '\n') {
+            if (g_discard) {
+                printf("line too long (max %u), ignored\n",
+                       static_cast<unsigned>(LineMax - 1));
+                g_discard = false;
+            } else {
+                g_line[g_len] = '\0';
+                dispatch();
+            }
+            g_len = 0;
+            continue;
+        }
+        if (g_len >= LineMax - 1) {
+            g_discard = true;
+            continue;
+        }
+        if (!g_discard) {
+            g_line[g_len++] = c;
+        }
+    }
+}
+
+void put(const char *s, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (!g_tx.push(s[i])) {
+            return; // ring full: drop the tail, never block
+        }
+    }
+}
+
+void printf(const char *fmt, ...)
+{
+    char buf[128];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > static_cast<int>(sizeof(buf)) - 1) {
+        n = sizeof(buf) - 1;
+    }
+    if (n > 0) {
+        put(buf, static_cast<uint32_t>(n));
+    }
+}
+
+uint32_t drain(uint8_t *dst, uint32_t max)
+{
+    uint32_t n = 0;
+    char c;
+    while (n < max && g_tx.pop(c)) {
+        dst[n++] = static_cast<uint8_t>(c);
+    }
+    return n;
+}
+
+} // namespace shell
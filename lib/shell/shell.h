@@ -0,0 +1,60 @@
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <cstdint>
+
+/**
+ * @brief Transport-agnostic line console for runtime tuning.
+ *
+ * Reflashing to read a counter or try a different geometry is the
+ * slowest edit-compile cycle we have, so deployed builds carry a small
+ * command console instead: the transport ISR deposits received bytes,
+ * service() assembles them into lines from the main loop, and a
+ * caller-supplied command table decides what the lines mean.
+ *
+ * The byte handoff is the shared spsc_ring (transport ISR produces,
+ * service() consumes), and dispatch is zero-copy: the line is
+ * NUL-split in place and argv[] points straight into the line storage,
+ * so a command costs no allocation and no string copies. Output from
+ * handlers goes through shell::printf into a second ring that the
+ * transport drains at its own pace; when the ring is full the tail of
+ * the output is dropped rather than ever blocking the caller.
+ *
+ * The shell itself owns no I/O: prj_usb_composite feeds it from the
+ * display bulk interface (src/console.h), but a UART byte source would
+ * wire up the same way.
+ */
+namespace shell {
+
+struct Command {
+    const char *name;                 // first token that selects this command
+    const char *help;                 // one-line summary for `help`
+    void (*fn)(int argc, char **argv);
+};
+
+// Registers the command table; `table` must outlive the shell (a
+// static constexpr-initialized array, in practice). `help` is built in
+// and lists the table.
+void init(const Command *table, uint32_t count);
+
+// Producer side, any ISR context: deposits received console bytes.
+// Bytes beyond the RX ring's capacity are dropped; the reader will see
+// a truncated line, complain, and resynchronize at the next newline.
+void rx(const uint8_t *data, uint32_t len);
+
+// Main-loop pass: drains the RX ring, runs every completed line's
+// handler. Cheap early-out when nothing arrived.
+void service();
+
+// Output side, main-loop context only (handlers run there anyway).
+// The tinyfmt conversion subset applies.
+void printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void put(const char *s, uint32_t len);
+
+// Transport side: copies up to `max` buffered output bytes into `dst`
+// and returns how many were copied (0 = nothing pending).
+uint32_t drain(uint8_t *dst, uint32_t max);
+
+} // namespace shell
+
+#endif /* SHELL_H */
@@ -0,0 +1,18 @@
+/* see bootmark.h */
+
+#include "bootmark.h"
+#include "riscv_encoding.h" /* read_csr() */
+
+static uint32_t marks[BOOTMARK_SLOTS];
+
+void bootmark_note(uint32_t stage)
+{
+    if (stage < BOOTMARK_SLOTS) {
+        marks[stage] = (uint32_t)read_csr(mcycle);
+    }
+}
+
+uint32_t bootmark_cycles(uint32_t stage)
+{
+    return (stage < BOOTMARK_SLOTS) ? marks[stage] : 0U;
+}
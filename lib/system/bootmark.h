@@ -0,0 +1,40 @@
+/*!
+    \file    bootmark.h
+    \brief   boot-stage mcycle timestamps
+
+    From reset to a usable device the firmware walks through several
+    serial stages (runtime init, peripheral bring-up, USB enumeration),
+    and only a timestamp per stage says which one is eating the budget.
+    bootmark_note() stores the current mcycle value into a fixed slot;
+    mcycle counts from reset, so the first mark already includes the
+    start.S/SystemInit cost without instrumenting either. The stamps are
+    retained for the lifetime of the session so a host-side query (or a
+    debug print long after boot) can still read them.
+
+    Which slot means what belongs to the application; keep the stage
+    list next to the code that marks them.
+*/
+
+#ifndef BOOTMARK_H
+#define BOOTMARK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOTMARK_SLOTS 8U
+
+/* stamp the current mcycle into slot `stage`; out-of-range is ignored.
+   Re-marking a slot overwrites it (useful for retried stages). */
+void bootmark_note(uint32_t stage);
+
+/* mcycle value recorded for `stage`, 0 if never marked or out of range */
+uint32_t bootmark_cycles(uint32_t stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOTMARK_H */
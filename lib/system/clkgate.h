@@ -0,0 +1,75 @@
+#ifndef CLKGATE_H
+#define CLKGATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern "C" {
+#include "gd32vf103_rcu.h"
+}
+
+/**
+ * @brief Compile-time peripheral clock set, applied in one pass at boot.
+ *
+ * Companion to pinmux.h: where that folds the pin map into a minimal
+ * register sequence, this folds the set of peripherals a build actually
+ * uses into one mask per RCU enable register. A project declares the
+ * set once, with the same #if guards as the code that drives each
+ * peripheral:
+ *
+ *     constexpr rcu_periph_enum kTable[] = { RCU_SPI0, RCU_DMA0, ... };
+ *     constexpr clkgate::Masks kMasks = clkgate::fold(kTable);
+ *     ...
+ *     clkgate::apply(kMasks);
+ *
+ * apply() writes the enable registers exactly instead of OR-ing: a
+ * peripheral the registry does not list is gated off, including
+ * anything a warm reboot, the bootloader or an earlier firmware
+ * revision left running -- the surprise always-on clocks an idle
+ * current audit usually finds. Driver inits keep their own
+ * rcu_periph_clock_enable() calls (they stay self-contained for other
+ * projects); those land after apply() and OR bits the masks already
+ * hold, so the cost is nil and a peripheral enabled lazily at runtime
+ * still works.
+ */
+namespace clkgate {
+
+struct Masks {
+    uint32_t ahb;
+    uint32_t apb1;
+    uint32_t apb2;
+};
+
+/* rcu_periph_enum packs (register offset << 6) | bit position; unpack
+ * it the same way rcu_periph_clock_enable() does, at compile time. */
+template <size_t N>
+constexpr Masks fold(const rcu_periph_enum (&table)[N])
+{
+    Masks m = { 0U, 0U, 0U };
+    for (size_t i = 0; i < N; i++) {
+        const uint32_t reg = (uint32_t)table[i] >> 6;
+        const uint32_t bit = 1U << ((uint32_t)table[i] & 0x1FU);
+        if (reg == AHBEN_REG_OFFSET)  { m.ahb  |= bit; }
+        if (reg == APB1EN_REG_OFFSET) { m.apb1 |= bit; }
+        if (reg == APB2EN_REG_OFFSET) { m.apb2 |= bit; }
+    }
+    return m;
+}
+
+/* The AHB bits that are set out of reset and must stay set: SRAM and
+ * FMC keep their clocks in sleep mode through these, and the fetch
+ * path depends on them. Folded into every apply() and audit. */
+constexpr uint32_t kAhbFixed = RCU_AHBEN_SRAMSPEN | RCU_AHBEN_FMCSPEN;
+
+/* Exact writes, not ORs -- see the header comment. Run this before
+ * any driver init so the later per-driver enables are the no-op ORs. */
+inline void apply(const Masks &m)
+{
+    RCU_AHBEN  = m.ahb | kAhbFixed;
+    RCU_APB1EN = m.apb1;
+    RCU_APB2EN = m.apb2;
+}
+
+} // namespace clkgate
+
+#endif /* CLKGATE_H */
@@ -0,0 +1,72 @@
+/*!
+    \file    deferred.c
+    \brief   run-to-completion scheduler for ISR bottom halves; see deferred.h
+*/
+
+#include "deferred.h"
+#include "riscv_encoding.h"
+
+static deferred_fn g_tasks[DEFERRED_LEVELS];
+
+/* bit N set = level N ready. ISRs OR bits in with an AMO (handlers are
+   preemptible, see vectors.h), the drain loop clears them the same way. */
+static volatile uint32_t g_ready;
+
+static uint32_t g_post_cycle[DEFERRED_LEVELS];
+static uint32_t g_max_latency[DEFERRED_LEVELS];
+
+int deferred_register(uint32_t level, deferred_fn fn)
+{
+    if ((level >= DEFERRED_LEVELS) || (g_tasks[level] != 0)) {
+        return -1;
+    }
+    g_tasks[level] = fn;
+    return 0;
+}
+
+void deferred_post(uint32_t level)
+{
+    uint32_t bit = 1U << level;
+    uint32_t prev = __atomic_fetch_or((uint32_t *)&g_ready, bit, __ATOMIC_RELAXED);
+
+    /* stamp only the post that set the bit, so coalesced re-posts keep
+       the oldest pending time. The stamp lands just after the OR, so a
+       drain racing this post can read a stale stamp and under-report by
+       a few cycles - fine for a diagnostic counter. */
+    if (0U == (prev & bit)) {
+        g_post_cycle[level] = (uint32_t)read_csr(mcycle);
+    }
+}
+
+uint32_t deferred_pending(void)
+{
+    return g_ready;
+}
+
+void deferred_drain(void)
+{
+    for (;;) {
+        uint32_t ready = g_ready;
+        if (0U == ready) {
+            return;
+        }
+
+        /* lowest set bit = highest priority level */
+        uint32_t level = (uint32_t)__builtin_ctz(ready);
+        __atomic_fetch_and((uint32_t *)&g_ready, ~(1U << level), __ATOMIC_RELAXED);
+
+        uint32_t latency = (uint32_t)read_csr(mcycle) - g_post_cycle[level];
+        if (latency > g_max_latency[level]) {
+            g_max_latency[level] = latency;
+        }
+
+        if (g_tasks[level] != 0) {
+            g_tasks[level]();
+        }
+    }
+}
+
+uint32_t deferred_max_latency(uint32_t level)
+{
+    return (level < DEFERRED_LEVELS) ? g_max_latency[level] : 0U;
+}
@@ -0,0 +1,53 @@
+/*!
+    \file    deferred.h
+    \brief   run-to-completion scheduler for ISR bottom halves
+
+    ISRs used to either do their follow-up work in interrupt context or
+    set ad hoc volatile flags the main loop polled. A bottom half is now
+    a slot in a static task table: the ISR marks it ready with
+    deferred_post() (a single AMO instruction), and the WFI idle loop
+    calls deferred_drain(), which runs ready tasks highest priority
+    first, to completion, with interrupts open. Each slot tracks its
+    worst-case post-to-dispatch delay in mcycle ticks, so "runs
+    promptly" is a number, not an assumption.
+*/
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one task per priority level; level 0 is dispatched first */
+#define DEFERRED_LEVELS 32U
+
+typedef void (*deferred_fn)(void);
+
+/* claim priority level 'level' for 'fn'. Returns 0, or -1 when the
+   level is out of range or already taken - levels are a project-wide
+   budget, so keep the assignments in one place per project. */
+int deferred_register(uint32_t level, deferred_fn fn);
+
+/* mark a level ready to run. Safe from any interrupt context; posting
+   an already-ready level coalesces into one dispatch. */
+void deferred_post(uint32_t level);
+
+/* nonzero while any level is ready (the check-then-WFI predicate) */
+uint32_t deferred_pending(void);
+
+/* run ready tasks, lowest level first, until the bitmap is empty.
+   Levels posted while draining are picked up in the same call. */
+void deferred_drain(void);
+
+/* worst case mcycle ticks between deferred_post() and the task body
+   starting, since boot */
+uint32_t deferred_max_latency(uint32_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFERRED_H */
@@ -0,0 +1,103 @@
+/*!
+    \file    evtrace.h
+    \brief   Lock-free in-memory binary event trace.
+
+    UART logging - even asynchronous - is far too slow to observe ISR
+    timing: one printf outweighs the window being measured. This trace
+    costs one atomic add and four stores per event (well under a
+    microsecond), so it can sit inside the USBFS or DMA handlers without
+    moving what it measures. Events are 12 bytes - an id, two arguments
+    and an mcycle timestamp - written into a fixed SRAM ring that
+    overwrites the oldest entries; the newest window before a dump is
+    what survives, which is exactly the part that matters.
+
+    The writer index is advanced with an AMO add (the A in rv32imac), so
+    note() is safe from any context including nested interrupts; each
+    claimed slot is then filled without further coordination. Readers
+    (dump paths) should arm(false) first so the window keeps still.
+
+    Event ids and their meanings belong to the application; keep the id
+    list next to the code that emits them and mirror it in the host-side
+    decoder. Compiled out entirely with -DEVT_ENABLE=0.
+*/
+
+#ifndef EVTRACE_H
+#define EVTRACE_H
+
+#include <stdint.h>
+
+extern "C" {
+    #include "riscv_encoding.h" // read_csr()
+}
+
+#ifndef EVT_ENABLE
+#define EVT_ENABLE 1
+#endif
+
+/* Ring capacity in events (12 bytes each); must be a power of two.
+   The default spends 1.5 KB of SRAM. */
+#ifndef EVT_BUF_EVENTS
+#define EVT_BUF_EVENTS 128U
+#endif
+
+namespace evt {
+
+struct Event {
+    uint32_t cycles; // mcycle at note() time, low 32 bits
+    uint16_t id;
+    uint16_t arg16;
+    uint32_t arg32;
+};
+
+#if EVT_ENABLE
+
+constexpr uint32_t BUF_EVENTS = EVT_BUF_EVENTS;
+constexpr uint32_t BUF_MASK   = BUF_EVENTS - 1U;
+static_assert((BUF_EVENTS & BUF_MASK) == 0U, "EVT_BUF_EVENTS must be a power of two");
+
+inline Event g_buf[BUF_EVENTS];
+inline volatile uint32_t g_next = 0;  // events noted since reset, ever
+inline volatile bool     g_armed = true;
+
+/*!
+    \brief  Record one event. Lock-free and ISR-safe: the slot is
+            claimed atomically, then filled privately. A reader that
+            catches a slot mid-fill sees one garbled event, never a
+            corrupted ring.
+*/
+inline void note(uint16_t id, uint16_t arg16 = 0, uint32_t arg32 = 0) {
+    if (!g_armed) return;
+    uint32_t n = __atomic_fetch_add(const_cast<uint32_t *>(&g_next), 1U,
+                                    __ATOMIC_RELAXED);
+    Event &e = g_buf[n & BUF_MASK];
+    e.cycles = read_csr(mcycle);
+    e.id     = id;
+    e.arg16  = arg16;
+    e.arg32  = arg32;
+}
+
+/*! \brief Stop (false) or resume (true) event capture. Stop before
+           reading the ring out so the window holds still. */
+inline void arm(bool on) { g_armed = on; }
+
+/*! \brief Total events ever noted; count() - BUF_EVENTS (when positive)
+           is the index of the oldest event still stored. */
+inline uint32_t count(void) { return g_next; }
+
+/*! \brief Event by absolute index (as counted by count()). */
+inline const Event &at(uint32_t i) { return g_buf[i & BUF_MASK]; }
+
+#else // !EVT_ENABLE
+
+constexpr uint32_t BUF_EVENTS = 0U;
+
+inline void note(uint16_t, uint16_t = 0, uint32_t = 0) {}
+inline void arm(bool) {}
+inline uint32_t count(void) { return 0; }
+inline const Event &at(uint32_t) { static Event e{}; return e; }
+
+#endif // EVT_ENABLE
+
+} // namespace evt
+
+#endif // EVTRACE_H
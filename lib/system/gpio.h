@@ -81,6 +81,71 @@ class Gpio {
     uint16_t _pin;         ///< Stores the specific pin number.
 };
 
+/**
+ * @brief Compile-time typed GPIO pin: every operation resolves to a
+ * single store to the atomic BOP/BC registers.
+ *
+ * The Gpio class above carries its port and pin in members, so each
+ * set() is a call into the flash-resident SDK driver plus runtime mask
+ * arithmetic. For pins toggled per SPI command (chip selects, the LCD
+ * DC line) that cost brackets every transfer; with the port and mask
+ * as template parameters the compiler folds each operation to one
+ * immediate store, the same code the hand-written GPIO_BOP/GPIO_BC
+ * macros in lcd.c produce, but typed and reusable.
+ *
+ * Pins are types, not objects:
+ *
+ *     using Cs = Pin<GPIOB, GPIO_PIN_12>;
+ *     Cs::low();              // one str to GPIO_BC(GPIOB)
+ *
+ * init() still goes through gpio_init(); configuration is not a hot
+ * path and the SDK's mode plumbing is worth keeping there.
+ */
+template <uint32_t Port, uint32_t Mask>
+struct Pin {
+    static constexpr uint32_t port = Port;
+    static constexpr uint32_t mask = Mask;
+
+    static inline void high() { GPIO_BOP(Port) = Mask; }
+    static inline void low()  { GPIO_BC(Port) = Mask; }
+    static inline void set(bool state) { state ? high() : low(); }
+    static inline bool read() { return (GPIO_ISTAT(Port) & Mask) != 0U; }
+    static inline void toggle() { set((GPIO_OCTL(Port) & Mask) == 0U); }
+
+    static inline void init(uint32_t mode, uint32_t speed = GPIO_OSPEED_50MHZ) {
+        gpio_init(Port, mode, speed, Mask);
+    }
+};
+
+/**
+ * @brief Bulk commit for pins on one port: one BOP store drives the
+ * whole group, listed pins high and the rest low, atomically.
+ *
+ *     using Bus = PinGroup<Cs, Dc>;
+ *     Bus::commit<Dc>();      // DC high and CS low in a single store
+ *
+ * BOP takes set bits in [15:0] and clear bits in [31:16], so any
+ * high/low combination across the group is one write with no
+ * read-modify-write window for an ISR to slip into.
+ */
+template <typename... Pins>
+struct PinGroup {
+    static constexpr uint32_t port = (Pins::port, ...);
+    static_assert(((Pins::port == port) && ...),
+                  "a PinGroup commits one port register; split groups per port");
+    static constexpr uint32_t mask = (Pins::mask | ...);
+
+    static inline void high() { GPIO_BOP(port) = mask; }
+    static inline void low()  { GPIO_BC(port) = mask; }
+
+    template <typename... HighPins>
+    static inline void commit() {
+        constexpr uint32_t hi = (0U | ... | HighPins::mask);
+        static_assert((hi & ~mask) == 0U, "pin outside this group");
+        GPIO_BOP(port) = hi | ((mask & ~hi) << 16);
+    }
+};
+
 /**
  * @brief Led class provides a simplified interface for controlling an LED.
  * It encapsulates a Gpio object and handles the active-low/active-high logic internally.
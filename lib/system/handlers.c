@@ -24,9 +24,11 @@
 #include <unistd.h>
 #include "riscv_encoding.h"
 #include "n200_func.h"
+#include "postmortem.h"
 
 __attribute__((weak)) uintptr_t handle_nmi()
 {
+  postmortem_capture(0xFFF, read_csr(mepc), read_csr(mbadaddr), 0);
   write(1, "nmi\n", 5);
   _exit(1);
   return 0;
@@ -38,6 +40,10 @@ __attribute__((weak)) uintptr_t handle_trap(uintptr_t mcause, uintptr_t sp)
   if((mcause & 0xFFF) == 0xFFF) {
       handle_nmi();
   }
+  /* Freeze the fault context into the .noinit postmortem record before
+     anything else; it survives the reset and is retrieved after reboot. */
+  postmortem_capture((uint32_t)mcause, read_csr(mepc), read_csr(mbadaddr),
+                     (uint32_t)sp);
   write(1, "trap\n", 5);
   //printf("In trap handler, the mcause is %d\n", mcause);
   //printf("In trap handler, the mepc is 0x%x\n", read_csr(mepc));
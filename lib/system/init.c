@@ -9,6 +9,10 @@
 #include <unistd.h>
 #include "riscv_encoding.h"
 #include "n200_func.h"
+#include "vectors.h"
+#include "irq_map.h"
+#include "memwatch.h"
+#include "postmortem.h"
 
 extern uint32_t disable_mcycle_minstret(void);
 extern void initialise_debug_uart(void);
@@ -113,10 +117,22 @@ void USBFS_IRQHandler(void)         WEAK_ALIAS(USBFS_IRQHandler);
  */
 void _init(void)
 {
+	// Paint the free stack before anything runs deep, so the headroom
+	// watermark (memwatch_stack_headroom) covers the whole session.
+	memwatch_stack_paint();
+
 	// Initialize the Core-Local Interrupt Controller (ECLIC)
 	eclic_init(ECLIC_NUM_INTERRUPTS);
 	eclic_mode_enable();
 
+	// Move the interrupt vector table from flash to SRAM so handler
+	// lookups (and directly-vectored entries) fetch with zero wait states.
+	irq_vectors_relocate();
+
+	// Program the central preemption-level/priority map before any
+	// driver enables its interrupt sources.
+	irq_map_apply();
+
 	// NOTE: The following code is an example of how to configure the PMP
 	// (Physical Memory Protection) and switch to user mode. It is disabled
 	// by default for this application.
@@ -193,6 +209,10 @@ void __attribute__((interrupt)) _unassigned_interrupts_handler(void)
 	// The MSB being 1 indicates an interrupt. The lower bits are the interrupt ID.
 	uint32_t cause = read_csr(mcause);
 
+	// Freeze the context into the .noinit postmortem record so the event
+	// is still diagnosable after the inevitable watchdog/manual reset.
+	postmortem_capture(cause, read_csr(mepc), read_csr(mbadaddr), 0);
+
 	// Use our safe, polled printing functions to send a detailed message.
 	fault_puts("\n\n*** Unhandled Interrupt ***\nCause (mcause): ");
 	fault_puthex(cause);
@@ -0,0 +1,36 @@
+/* Central ECLIC level/priority map; see irq_map.h for the rationale. */
+
+#include <gd32vf103.h>
+#include <stdint.h>
+#include "n200_func.h"
+#include "irq_map.h"
+
+/* Every interrupt the firmware services, ordered by level. Sources not
+ * listed here stay at level 0 / priority 0. */
+static const irq_map_entry_t irq_map[] = {
+    { USBFS_IRQn,         IRQ_LEVEL_USB,        0 },
+    { USBFS_WKUP_IRQn,    IRQ_LEVEL_USB,        1 }, /* rare, but must not be held off */
+    { DMA0_Channel2_IRQn, IRQ_LEVEL_STREAMING,  1 }, /* LCD blit complete */
+    { DMA0_Channel3_IRQn, IRQ_LEVEL_STREAMING,  0 }, /* SD SPI DMA RX */
+    { DMA0_Channel4_IRQn, IRQ_LEVEL_STREAMING,  0 }, /* SD SPI DMA TX */
+    { TIMER2_IRQn,        IRQ_LEVEL_TICK,       0 }, /* USB delay timer */
+    { TIMER5_IRQn,        IRQ_LEVEL_TICK,       0 }, /* health-monitor heartbeat */
+    { EXTI5_9_IRQn,       IRQ_LEVEL_BACKGROUND, 1 }, /* user key */
+    { EXTI10_15_IRQn,     IRQ_LEVEL_BACKGROUND, 1 }, /* rotary encoder */
+    { TIMER1_IRQn,        IRQ_LEVEL_BACKGROUND, 1 }, /* encoder timer decode wake-up */
+    { TIMER4_IRQn,        IRQ_LEVEL_BACKGROUND, 0 }, /* user key debounce one-shot */
+    { USART0_IRQn,        IRQ_LEVEL_BACKGROUND, 0 }, /* debug UART TX drain */
+    { USART2_IRQn,        IRQ_LEVEL_BACKGROUND, 1 }, /* UART bridge IDLE-line framing */
+    { I2C0_EV_IRQn,       IRQ_LEVEL_BACKGROUND, 2 }, /* sensor bus byte pump (lib/i2c) */
+    { I2C0_ER_IRQn,       IRQ_LEVEL_BACKGROUND, 2 }, /* sensor bus fault unwinding */
+    { TIMER6_IRQn,        IRQ_LEVEL_BACKGROUND, 0 }, /* ISR hold-off audit sampler (ISR_AUDIT builds); must stay lowest */
+};
+
+void irq_map_apply(void)
+{
+    eclic_priority_group_set(ECLIC_PRIGROUP_LEVEL2_PRIO2);
+    for (uint32_t i = 0; i < sizeof(irq_map) / sizeof(irq_map[0]); i++) {
+        eclic_set_irq_lvl_abs(irq_map[i].irqn, (uint8_t)irq_map[i].level);
+        eclic_set_irq_priority(irq_map[i].irqn, irq_map[i].priority);
+    }
+}
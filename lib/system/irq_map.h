@@ -0,0 +1,47 @@
+#ifndef IRQ_MAP_H
+#define IRQ_MAP_H
+
+#include <stdint.h>
+
+/**
+ * @brief Central ECLIC preemption-level and priority assignment.
+ *
+ * Levels and priorities used to be set ad hoc at each driver's
+ * eclic_irq_enable() call, which quietly left the LCD blit-complete DMA
+ * outranking USBFS. This module is now the single place that decides who
+ * preempts whom; drivers only enable their own sources with
+ * eclic_enable_interrupt() and must not pass levels or priorities.
+ *
+ * Under ECLIC_PRIGROUP_LEVEL2_PRIO2 each source gets a 2-bit preemption
+ * level and a 2-bit priority. A pending interrupt with a HIGHER level
+ * preempts a running handler with a lower one (if that handler has
+ * re-enabled interrupts; see IRQ_PREEMPT_ENTER in vectors.h). Priority
+ * only arbitrates between pending sources of the same level and never
+ * causes preemption.
+ */
+typedef enum {
+    IRQ_LEVEL_BACKGROUND = 0, /* user input, debug UART drain */
+    IRQ_LEVEL_TICK       = 1, /* housekeeping timers */
+    IRQ_LEVEL_STREAMING  = 2, /* SD and LCD DMA completions */
+    IRQ_LEVEL_USB        = 3, /* USBFS: bounded FIFO service time */
+} irq_level_t;
+
+typedef struct {
+    uint8_t     irqn;     /* IRQn_Type value */
+    irq_level_t level;    /* preemption level; higher value preempts lower */
+    uint8_t     priority; /* same-level arbitration; higher value first */
+} irq_map_entry_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Programs the priority group and every entry of the map into the ECLIC.
+ * Called once from _init(), before any driver enables its sources. */
+void irq_map_apply(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_MAP_H */
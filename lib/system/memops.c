@@ -0,0 +1,103 @@
+/* Word-wise memcpy/memset for the RV32IMAC core.
+ *
+ * The newlib variants linked from the stubs environment fall back to
+ * byte loops for many alignment combinations, and the streaming path
+ * calls them for every USB packet and framebuffer operation. These
+ * replacements run a 4x-unrolled word loop whenever source and
+ * destination share alignment, with byte head/tail handling; a copy
+ * between mutually misaligned buffers stays bytewise (unrolled) since
+ * misaligned word accesses are not worth the trap risk on this core.
+ *
+ * Being object files in the link, they override the libc archive
+ * members without any linker tricks. Define MEMOPS_USE_NEWLIB in the
+ * build config to compile them out and fall back to newlib.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(MEMOPS_USE_NEWLIB)
+
+/* Keeps the optimizer from recognising the loop as a memcpy/memset
+ * pattern and emitting a recursive libc call. */
+#define MEMOPS_FN __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+MEMOPS_FN void *memcpy(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (n >= 8 && (((uintptr_t)d ^ (uintptr_t)s) & 3U) == 0) {
+        /* Shared alignment: step to a word boundary, then copy words. */
+        while ((uintptr_t)d & 3U) {
+            *d++ = *s++;
+            n--;
+        }
+        uint32_t *dw = (uint32_t *)d;
+        const uint32_t *sw = (const uint32_t *)s;
+        while (n >= 16) {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+            dw += 4;
+            sw += 4;
+            n -= 16;
+        }
+        while (n >= 4) {
+            *dw++ = *sw++;
+            n -= 4;
+        }
+        d = (uint8_t *)dw;
+        s = (const uint8_t *)sw;
+    } else {
+        /* Mutually misaligned: unrolled byte copy. */
+        while (n >= 4) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+            d[3] = s[3];
+            d += 4;
+            s += 4;
+            n -= 4;
+        }
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+MEMOPS_FN void *memset(void *dst, int value, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    uint8_t b = (uint8_t)value;
+
+    if (n >= 8) {
+        while ((uintptr_t)d & 3U) {
+            *d++ = b;
+            n--;
+        }
+        uint32_t word = 0x01010101UL * b;
+        uint32_t *dw = (uint32_t *)d;
+        while (n >= 16) {
+            dw[0] = word;
+            dw[1] = word;
+            dw[2] = word;
+            dw[3] = word;
+            dw += 4;
+            n -= 16;
+        }
+        while (n >= 4) {
+            *dw++ = word;
+            n -= 4;
+        }
+        d = (uint8_t *)dw;
+    }
+    while (n--) {
+        *d++ = b;
+    }
+    return dst;
+}
+
+#endif /* !MEMOPS_USE_NEWLIB */
@@ -0,0 +1,74 @@
+/*!
+    \file    memwatch.c
+    \brief   stack and heap high-water instrumentation; see memwatch.h
+*/
+
+#include "memwatch.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/* linker-script symbols (GD32VF103xB.lds): the stack runs from
+   _heap_end (floor) up to _sp (top); the heap arena from _end up to
+   _heap_end. */
+extern char _sp[];
+extern char _heap_end[];
+extern char _end[];
+
+/* highest break _sbrk() ever granted (gd32/Firmware/RISCV/stubs/sbrk.c) */
+extern char *_sbrk_high_water(void);
+
+/* painted into every free stack word; no plausible frame is all-A5 */
+#define MEMWATCH_PATTERN 0xA5A5A5A5U
+
+void memwatch_stack_paint(void)
+{
+    uintptr_t sp;
+    asm volatile("mv %0, sp" : "=r"(sp));
+
+    /* stop a margin below the live frame so the paint cannot touch
+       anything the compiler keeps below sp in this function */
+    uint32_t *p = (uint32_t *)_heap_end;
+    uint32_t *top = (uint32_t *)((sp - 64U) & ~3U);
+
+    while (p < top) {
+        *p++ = MEMWATCH_PATTERN;
+    }
+}
+
+uint32_t memwatch_stack_headroom(void)
+{
+    const uint32_t *p = (const uint32_t *)_heap_end;
+    const uint32_t *top = (const uint32_t *)_sp;
+    uint32_t bytes = 0;
+
+    while ((p < top) && (MEMWATCH_PATTERN == *p)) {
+        bytes += 4U;
+        p++;
+    }
+    return bytes;
+}
+
+uint32_t memwatch_stack_size(void)
+{
+    return (uint32_t)(_sp - _heap_end);
+}
+
+uint32_t memwatch_heap_used_max(void)
+{
+    return (uint32_t)(_sbrk_high_water() - _end);
+}
+
+uint32_t memwatch_heap_size(void)
+{
+    return (uint32_t)(_heap_end - _end);
+}
+
+void memwatch_report(void)
+{
+    uint32_t stack_size = memwatch_stack_size();
+    uint32_t stack_used = stack_size - memwatch_stack_headroom();
+
+    printf("memwatch: stack %u/%u heap %u/%u\n",
+           stack_used, stack_size,
+           memwatch_heap_used_max(), memwatch_heap_size());
+}
@@ -0,0 +1,49 @@
+/*!
+    \file    memwatch.h
+    \brief   stack and heap high-water instrumentation
+
+    The stack reservation in GD32VF103xB.lds is sized by guesswork, and
+    an overflow during a deep call chain (USB + FatFs) corrupts .bss
+    silently. memwatch paints the free stack with a known pattern at
+    startup and counts how much of the paint survives, and the sbrk stub
+    tracks the highest break it ever granted, so both watermarks are
+    real measurements. Query them ad hoc or let memwatch_report() print
+    a summary on the debug channel.
+*/
+
+#ifndef MEMWATCH_H
+#define MEMWATCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* paint the unused stack below the current frame. Call once, early -
+   _init() does it before main(), while only the startup frames are
+   live. */
+void memwatch_stack_paint(void);
+
+/* bytes of paint still intact above the stack floor = stack that has
+   never been touched. Scans from the floor up, so cost is proportional
+   to the headroom, not the stack size. */
+uint32_t memwatch_stack_headroom(void);
+
+/* total bytes reserved for the stack (_sp - _heap_end) */
+uint32_t memwatch_stack_size(void);
+
+/* deepest heap use ever granted by _sbrk(), in bytes */
+uint32_t memwatch_heap_used_max(void);
+
+/* total bytes in the heap arena (_heap_end - _end) */
+uint32_t memwatch_heap_size(void);
+
+/* print both watermarks through printf (debug UART) */
+void memwatch_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMWATCH_H */
@@ -0,0 +1,70 @@
+#ifndef MTIMER_H
+#define MTIMER_H
+
+/**
+ * @brief Microsecond delays and deadlines over the CLINT mtime counter.
+ *
+ * delay_1ms (lib/system/systick.c) is the only stock delay primitive,
+ * which left drivers burning a full millisecond on microsecond-scale
+ * waits or spinning on loops hand-calibrated against one clock profile.
+ * mtime already ticks at SystemCoreClock/4 (27 MHz at the 108 MHz
+ * profile), is 64-bit so deadlines never wrap, and costs nothing to
+ * read, so everything here is a thin inline layer over it:
+ *
+ *   delay_us(n)              blocking wait, accurate at any clock profile
+ *   mtimer_timeout           non-blocking deadline for driver state
+ *                            machines: start it, poll expired() between
+ *                            useful work. No interrupt, no shared tick
+ *                            variable, safe at any preemption level.
+ *
+ * C and C++ both include this; expiry returns int (1/0) because the SDK
+ * defines its own bool for C translation units.
+ */
+
+#include <stdint.h>
+#include "n200_timer.h"
+#include "system_gd32vf103.h"
+
+/* mtime is two 32-bit registers; reread the high word to defend the
+ * seam, exactly like the SDK's get_timer_value (out-of-line there). */
+static inline uint64_t mtimer_now(void)
+{
+    volatile uint32_t *lo = (volatile uint32_t *)(TIMER_CTRL_ADDR + TIMER_MTIME);
+    volatile uint32_t *hi = (volatile uint32_t *)(TIMER_CTRL_ADDR + TIMER_MTIME + 4);
+    uint32_t h, l;
+    do {
+        h = *hi;
+        l = *lo;
+    } while (h != *hi);
+    return ((uint64_t)h << 32) | l;
+}
+
+static inline uint32_t mtimer_ticks_per_us(void)
+{
+    /* 4 MHz granularity floor: every supported profile (8..108 MHz)
+     * divides to a whole tick count. */
+    return SystemCoreClock / 4000000U;
+}
+
+static inline void delay_us(uint32_t us)
+{
+    uint64_t deadline = mtimer_now() + (uint64_t)us * mtimer_ticks_per_us();
+    while (mtimer_now() < deadline) {
+    }
+}
+
+typedef struct {
+    uint64_t deadline;
+} mtimer_timeout;
+
+static inline void mtimer_timeout_start(mtimer_timeout *t, uint32_t us)
+{
+    t->deadline = mtimer_now() + (uint64_t)us * mtimer_ticks_per_us();
+}
+
+static inline int mtimer_timeout_expired(const mtimer_timeout *t)
+{
+    return mtimer_now() >= t->deadline;
+}
+
+#endif /* MTIMER_H */
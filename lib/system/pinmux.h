@@ -0,0 +1,126 @@
+#ifndef PINMUX_H
+#define PINMUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern "C" {
+#include "gd32vf103_gpio.h"
+#include "gd32vf103_rcu.h"
+}
+
+/**
+ * @brief Compile-time pin-mux table applied in one pass at startup.
+ *
+ * Peripheral pin setup used to be scattered: board code, the LCD and
+ * SD drivers and the debug UART each enable port clocks and call
+ * gpio_init() separately, re-touching the same CTL registers through
+ * the SDK's read-modify-write one pin at a time. A project instead
+ * declares its whole pin map as one constexpr table and applies it
+ * once, early in main():
+ *
+ *     constexpr pinmux::Entry kPins[] = {
+ *         { GPIOA, GPIO_PIN_1, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ,
+ *           pinmux::LEVEL_HIGH },   // green LED, off (common anode)
+ *         ...
+ *     };
+ *     static_assert(pinmux::distinct(kPins), "pin claimed twice");
+ *     ...
+ *     pinmux::apply(kPins);
+ *
+ * distinct() makes a double-claimed pin a compile-time error - the
+ * kind of conflict that otherwise surfaces as one subsystem silently
+ * reconfiguring another's line (SD CS and the encoder key both want
+ * PB12). apply() folds the table into a minimal register sequence:
+ * one RCU_APB2EN OR for every used port clock, one read-modify-write
+ * of CTL0/CTL1 per used port, and one BOP store per port for initial
+ * output levels and input pull directions.
+ *
+ * The nibble encoding mirrors the SDK's gpio_init() exactly, so table
+ * entries use the same GPIO_MODE_ / GPIO_OSPEED_ values, and a lib
+ * driver that re-runs gpio_init() on its own pins (they stay
+ * self-contained for projects without a table) rewrites the identical
+ * configuration.
+ */
+namespace pinmux {
+
+/* Initial state: output level for output modes; ignored for inputs
+ * (IPU/IPD pick the pull direction through OCTL themselves). */
+enum Level : int8_t { LEVEL_NONE = -1, LEVEL_LOW = 0, LEVEL_HIGH = 1 };
+
+struct Entry {
+    uint32_t port;   /* GPIOA..GPIOE */
+    uint32_t mask;   /* GPIO_PIN_x, may OR several pins of one mode */
+    uint32_t mode;   /* GPIO_MODE_* */
+    uint32_t speed;  /* GPIO_OSPEED_*; ignored for input modes */
+    int8_t   level;  /* LEVEL_* */
+};
+
+/* True when no pin is claimed by two entries; static_assert this on
+ * every table. */
+template <size_t N>
+constexpr bool distinct(const Entry (&table)[N])
+{
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (table[i].port == table[j].port &&
+                (table[i].mask & table[j].mask) != 0U) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* CTL/MD nibble for one pin, exactly as gpio_init() computes it. */
+constexpr uint32_t ctl_nibble(uint32_t mode, uint32_t speed)
+{
+    return (mode & 0x10U) ? ((mode & 0x0FU) | speed) : (mode & 0x0FU);
+}
+
+template <size_t N>
+inline void apply(const Entry (&table)[N])
+{
+    /* Port clocks (and AF, for EXTI source selects and remaps) in one
+     * APB2EN write. Port A..E enable bits sit at 2..6. */
+    uint32_t clocks = RCU_APB2EN_AFEN;
+    for (size_t i = 0; i < N; i++) {
+        clocks |= 1U << (2U + (table[i].port - GPIOA) / 0x400U);
+    }
+    RCU_APB2EN |= clocks;
+
+    for (uint32_t port = GPIOA; port <= GPIOE; port += 0x400U) {
+        uint32_t clr0 = 0, set0 = 0, clr1 = 0, set1 = 0, bop = 0;
+        for (size_t i = 0; i < N; i++) {
+            const Entry &e = table[i];
+            if (e.port != port) continue;
+            const uint32_t nibble = ctl_nibble(e.mode, e.speed);
+            for (uint32_t pin = 0; pin < 16; pin++) {
+                if (!(e.mask & (1U << pin))) continue;
+                const uint32_t shift = (pin & 7U) * 4U;
+                if (pin < 8) {
+                    clr0 |= 0xFU << shift;
+                    set0 |= nibble << shift;
+                } else {
+                    clr1 |= 0xFU << shift;
+                    set1 |= nibble << shift;
+                }
+            }
+            if (e.mode == GPIO_MODE_IPU || e.level == LEVEL_HIGH) {
+                bop |= e.mask;           /* BOP set half */
+            } else if (e.mode == GPIO_MODE_IPD || e.level == LEVEL_LOW) {
+                bop |= e.mask << 16;     /* BOP clear half */
+            }
+        }
+        /* Levels before modes: OCTL must hold the idle state when the
+         * pin switches to output, or an active-low line (a chip
+         * select) glitches low for the gap between the two writes. */
+        if (bop)  GPIO_BOP(port) = bop;
+        if (clr0) GPIO_CTL0(port) = (GPIO_CTL0(port) & ~clr0) | set0;
+        if (clr1) GPIO_CTL1(port) = (GPIO_CTL1(port) & ~clr1) | set1;
+    }
+}
+
+} // namespace pinmux
+
+#endif /* PINMUX_H */
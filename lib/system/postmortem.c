@@ -0,0 +1,96 @@
+/*!
+    \file    postmortem.c
+    \brief   crash record preserved across reset; see postmortem.h
+*/
+
+#include "postmortem.h"
+#include "riscv_encoding.h"
+#include <string.h>
+
+#define POSTMORTEM_MAGIC 0x504D5431U /* "PMT1" */
+
+/* lives in .noinit: random garbage after power-up, which the checksum
+   rejects; intact after any warm reset. */
+static postmortem_record g_record __attribute__((section(".noinit")));
+
+/* trace ring registration (postmortem_set_trace) */
+static const volatile uint8_t *g_trace_buf;
+static uint32_t g_trace_event_bytes;
+static uint32_t g_trace_ring_events;
+static const volatile uint32_t *g_trace_next;
+
+/* word sum over the record body, excluding the checksum field itself */
+static uint32_t record_checksum(const postmortem_record *rec)
+{
+    const uint32_t *words = (const uint32_t *)rec;
+    uint32_t n = (sizeof(*rec) - sizeof(rec->checksum)) / 4U;
+    uint32_t sum = 0;
+
+    while (n--) {
+        sum += *words++;
+    }
+    return sum;
+}
+
+void postmortem_set_trace(const volatile void *buf, uint32_t event_bytes,
+                          uint32_t ring_events,
+                          const volatile uint32_t *next)
+{
+    g_trace_buf = (const volatile uint8_t *)buf;
+    g_trace_event_bytes = event_bytes;
+    g_trace_ring_events = ring_events;
+    g_trace_next = next;
+}
+
+void postmortem_capture(uint32_t mcause, uint32_t mepc, uint32_t mtval,
+                        uint32_t sp)
+{
+    g_record.mcause = mcause;
+    g_record.mepc = mepc;
+    g_record.mtval = mtval;
+    g_record.sp = sp;
+    g_record.mstatus = (uint32_t)read_csr(mstatus);
+    g_record.mcycle = (uint32_t)read_csr(mcycle);
+    g_record.dma0_intf = *(volatile uint32_t *)0x40020000U; /* DMA0 INTF */
+    g_record.trace_count = 0;
+
+    /* copy the newest trace events, oldest of the window first. The
+       writer index counts events ever noted; ring slot = index mod
+       ring size. */
+    if ((g_trace_buf != 0) &&
+        (g_trace_event_bytes <= POSTMORTEM_EVENT_BYTES)) {
+        uint32_t total = *g_trace_next;
+        uint32_t want = (total < POSTMORTEM_TRACE_EVENTS)
+                            ? total : POSTMORTEM_TRACE_EVENTS;
+        uint32_t first = total - want;
+        uint32_t i;
+
+        for (i = 0; i < want; i++) {
+            uint32_t slot = (first + i) % g_trace_ring_events;
+            memcpy(&g_record.trace[i * POSTMORTEM_EVENT_BYTES],
+                   (const void *)(g_trace_buf + slot * g_trace_event_bytes),
+                   g_trace_event_bytes);
+        }
+        g_record.trace_count = want;
+    }
+
+    g_record.magic = POSTMORTEM_MAGIC;
+    g_record.checksum = record_checksum(&g_record);
+}
+
+int postmortem_pending(void)
+{
+    return (g_record.magic == POSTMORTEM_MAGIC) &&
+           (g_record.checksum == record_checksum(&g_record));
+}
+
+const postmortem_record *postmortem_get(void)
+{
+    return &g_record;
+}
+
+void postmortem_clear(void)
+{
+    g_record.magic = 0;
+    g_record.checksum = 0;
+}
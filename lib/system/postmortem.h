@@ -0,0 +1,66 @@
+/*!
+    \file    postmortem.h
+    \brief   crash record preserved across reset in the .noinit section
+
+    When a trap fires in the field the device just resets and the scene
+    is gone. postmortem_capture() freezes mcause/mepc/mtval/sp, the
+    mcycle timestamp and the newest window of the binary event trace
+    into a checksummed record in .noinit SRAM, which the startup code
+    deliberately does not clear. After the reboot the application checks
+    postmortem_pending() and ships the record out over whatever channel
+    it has (prj_usb_composite uses the custom HID report path).
+*/
+
+#ifndef POSTMORTEM_H
+#define POSTMORTEM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* newest trace events copied into the record (12 bytes each) */
+#define POSTMORTEM_TRACE_EVENTS 16U
+#define POSTMORTEM_EVENT_BYTES  12U
+
+typedef struct {
+    uint32_t magic;       /* POSTMORTEM_MAGIC when a capture is stored */
+    uint32_t mcause;
+    uint32_t mepc;
+    uint32_t mtval;
+    uint32_t sp;
+    uint32_t mstatus;
+    uint32_t mcycle;      /* low 32 bits at capture time */
+    uint32_t dma0_intf;   /* DMA0 interrupt flags - which channels were live */
+    uint32_t trace_count; /* valid events in trace[], newest last */
+    uint8_t  trace[POSTMORTEM_TRACE_EVENTS * POSTMORTEM_EVENT_BYTES];
+    uint32_t checksum;    /* word sum over everything above */
+} postmortem_record;
+
+/* tell postmortem where the event trace ring lives so capture can copy
+   the newest window. 'next' is the ever-incrementing writer index
+   (events noted since reset); pass NULL bufs to disable the copy. */
+void postmortem_set_trace(const volatile void *buf, uint32_t event_bytes,
+                          uint32_t ring_events,
+                          const volatile uint32_t *next);
+
+/* freeze the fault context into the .noinit record. Safe from trap
+   context: no printf, no interrupts, plain stores only. */
+void postmortem_capture(uint32_t mcause, uint32_t mepc, uint32_t mtval,
+                        uint32_t sp);
+
+/* nonzero when a valid record from a previous session is stored */
+int postmortem_pending(void);
+
+/* the stored record; meaningful only while postmortem_pending() */
+const postmortem_record *postmortem_get(void);
+
+/* invalidate the record once it has been retrieved */
+void postmortem_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POSTMORTEM_H */
@@ -0,0 +1,190 @@
+/*!
+    \file    profile.h
+    \brief   Cycle-accurate profiling on the RISC-V mcycle/minstret CSRs.
+
+    systick.c gives millisecond delays; this header gives the fine end of
+    the scale. It exposes raw cycle-counter reads, an RAII scope timer,
+    and named accumulators (count / total / min / max) that a call to
+    prof::dump() reports over the debug UART. Everything is header-only
+    and ISR-safe: adding a sample is a handful of integer operations with
+    no locking and no allocation, so scopes can sit inside interrupt
+    handlers.
+
+    Typical use:
+        void DMA0_Channel3_IRQHandler(void) {
+            PROF_SCOPE("sd dma isr");
+            ...
+        }
+    and, from the main loop at a convenient moment, prof::dump().
+
+    Compiled out entirely with -DPROF_ENABLE=0: the macros expand to
+    nothing and the accumulator names never reach flash. Note that
+    dump() reads accumulators without masking interrupts, so totals for
+    scopes that live in ISRs can be a sample stale - fine for a report,
+    not for lockstep bookkeeping.
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern "C" {
+    #include "gd32vf103.h"      // SystemCoreClock
+    #include "riscv_encoding.h" // read_csr()
+}
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 1
+#endif
+
+namespace prof {
+
+/*!
+    \brief  Current cycle counter, low 32 bits. Wraps every ~39 s at
+            108 MHz; fine for scope timing, use cycles64() for spans.
+*/
+inline uint32_t cycles(void) { return read_csr(mcycle); }
+
+/*!
+    \brief  Retired-instruction counter, low 32 bits. cycles()/instret()
+            deltas over the same span give CPI, which separates "code is
+            long" from "code is stalled" (flash wait states, bus
+            contention with DMA).
+*/
+inline uint32_t instret(void) { return read_csr(minstret); }
+
+/*!
+    \brief  Full 64-bit cycle counter. Rereads the high half to close
+            the carry race, so it is safe anywhere including ISRs.
+*/
+inline uint64_t cycles64(void) {
+    uint32_t hi, lo, hi2;
+    do {
+        hi  = read_csr(mcycleh);
+        lo  = read_csr(mcycle);
+        hi2 = read_csr(mcycleh);
+    } while (hi != hi2);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/*!
+    \brief  Convert a cycle count to microseconds at the current core clock.
+*/
+inline uint32_t cycles_to_us(uint32_t cycles) {
+    return (uint32_t)((uint64_t)cycles * 1000000U / SystemCoreClock);
+}
+
+} // namespace prof
+
+#if PROF_ENABLE
+
+namespace prof {
+
+/*!
+    \brief  A named running tally of samples. Registers itself on an
+            intrusive list at construction so dump() can find it; the
+            usual home is a function-local static created by PROF_SCOPE,
+            which constructs (and registers) on the first pass through
+            the scope.
+*/
+struct Accumulator {
+    const char  *name;
+    uint64_t     total_cycles = 0;
+    uint32_t     count        = 0;
+    uint32_t     min_cycles   = UINT32_MAX;
+    uint32_t     max_cycles   = 0;
+    Accumulator *next;
+
+    explicit Accumulator(const char *n) : name(n), next(registry()) {
+        registry() = this;
+    }
+
+    static Accumulator *&registry(void) {
+        static Accumulator *head = nullptr;
+        return head;
+    }
+
+    void add(uint32_t cycles) {
+        total_cycles += cycles;
+        count++;
+        if (cycles < min_cycles) min_cycles = cycles;
+        if (cycles > max_cycles) max_cycles = cycles;
+    }
+
+    void reset(void) {
+        total_cycles = 0;
+        count        = 0;
+        min_cycles   = UINT32_MAX;
+        max_cycles   = 0;
+    }
+};
+
+/*!
+    \brief  RAII timer: samples mcycle at construction and feeds the
+            delta into an accumulator at scope exit.
+*/
+class Scope {
+public:
+    explicit Scope(Accumulator &acc) : m_acc(acc), m_start(cycles()) {}
+    ~Scope() { m_acc.add(cycles() - m_start); }
+private:
+    Accumulator &m_acc;
+    uint32_t     m_start;
+};
+
+/*!
+    \brief  Print every registered accumulator over the debug UART,
+            newest registration first. Times are in microseconds; the
+            raw cycle total is included for spans too short for the
+            microsecond grid.
+    \param  reset: clear each accumulator after reporting it, so
+            successive dumps cover disjoint intervals.
+*/
+inline void dump(bool reset = false) {
+    printf("--- profile (core %lu MHz) ---\n",
+           (unsigned long)(SystemCoreClock / 1000000U));
+    for (Accumulator *a = Accumulator::registry(); a; a = a->next) {
+        if (0 == a->count) {
+            printf("%-24s        no samples\n", a->name);
+            continue;
+        }
+        uint32_t avg = (uint32_t)(a->total_cycles / a->count);
+        printf("%-24s n=%7lu  avg %7lu us  min %7lu  max %7lu  (%lu cyc total)\n",
+               a->name,
+               (unsigned long)a->count,
+               (unsigned long)cycles_to_us(avg),
+               (unsigned long)cycles_to_us(a->min_cycles),
+               (unsigned long)cycles_to_us(a->max_cycles),
+               (unsigned long)a->total_cycles);
+        if (reset) a->reset();
+    }
+    printf("------------------------------\n");
+}
+
+} // namespace prof
+
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b)  PROF_CONCAT2(a, b)
+
+/*!
+    \brief  Time the rest of the enclosing scope into a named
+            accumulator. One accumulator per macro site; the name is
+            what dump() prints.
+*/
+#define PROF_SCOPE(name_literal) \
+    static prof::Accumulator PROF_CONCAT(prof_acc_, __LINE__)(name_literal); \
+    prof::Scope PROF_CONCAT(prof_scope_, __LINE__)(PROF_CONCAT(prof_acc_, __LINE__))
+
+#else // !PROF_ENABLE
+
+namespace prof {
+inline void dump(bool = false) {}
+} // namespace prof
+
+#define PROF_SCOPE(name_literal) do {} while (0)
+
+#endif // PROF_ENABLE
+
+#endif // PROFILE_H
@@ -0,0 +1,19 @@
+#ifndef RAMTEXT_H
+#define RAMTEXT_H
+
+/**
+ * @brief Places a function in the .ramtext section, which start.S copies
+ * from flash to SRAM before main() runs.
+ *
+ * Flash fetches on the GD32VF103 carry wait states at 108 MHz while SRAM
+ * is zero-wait-state, so interrupt handlers that fire while USB, SPI0
+ * (LCD) and SPI1 (SD) traffic stack benefit from executing out of RAM.
+ * SRAM is only 32K; reserve this for ISRs and code on a measured hot
+ * path, not as a general speed-up.
+ *
+ * Usage:
+ *   RAMTEXT void DMA0_Channel2_IRQHandler(void) { ... }
+ */
+#define RAMTEXT __attribute__((section(".ramtext")))
+
+#endif /* RAMTEXT_H */
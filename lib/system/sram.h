@@ -0,0 +1,27 @@
+#ifndef SRAM_H
+#define SRAM_H
+
+/**
+ * @brief Placement macros for the named SRAM regions in GD32VF103xB.lds.
+ *
+ * 32K of SRAM goes fast once the framebuffers and SD caches grow, and a
+ * buffer that silently lands in anonymous .bss is invisible in the map
+ * file until something overflows at runtime. Objects tagged with these
+ * macros land in their named output section instead, where the linker
+ * script's per-region budget ASSERTs turn an overflow into a link
+ * error. Both regions are cleared at startup exactly like .bss.
+ *
+ * SRAM_DMA_BUFFER: buffers a DMA channel reads or writes. Also forces
+ * 8-byte alignment, which member layout inside a class never promises,
+ * so halfword/word transfers cannot straddle.
+ *
+ * SRAM_CACHE: rebuildable copies of data that lives elsewhere (SD
+ * sectors, flash assets) - the first thing to shrink under pressure.
+ *
+ * Usage:
+ *   static WbLine wb_lines[WB_LINES] SRAM_CACHE;
+ */
+#define SRAM_DMA_BUFFER __attribute__((section(".dma_buffers"), aligned(8)))
+#define SRAM_CACHE      __attribute__((section(".caches")))
+
+#endif /* SRAM_H */
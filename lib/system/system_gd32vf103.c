@@ -50,9 +50,32 @@
 //#define __SYSTEM_CLOCK_48M_PLL_HXTAL            (uint32_t)(48000000)
 //#define __SYSTEM_CLOCK_56M_PLL_HXTAL            (uint32_t)(56000000)
 //#define __SYSTEM_CLOCK_72M_PLL_HXTAL            (uint32_t)(72000000)
-#define __SYSTEM_CLOCK_96M_PLL_HXTAL            (uint32_t)(96000000)
 //#define __SYSTEM_CLOCK_108M_PLL_HXTAL           (uint32_t)(108000000)
 
+/* The profile can also be selected per project from the build
+   (config.py GLOBAL_C_DEFINES) without editing this file:
+
+     -DSYSTEM_CLOCK_PROFILE=96    96 MHz PLL from HXTAL (default).
+                                  CK_USBFS = CK_SYS / 2 = 48 MHz, so this
+                                  is the fastest profile USB projects can
+                                  use.
+     -DSYSTEM_CLOCK_PROFILE=108   108 MHz PLL from HXTAL. No USBFS
+                                  prescaler reaches 48 MHz from here;
+                                  only for projects without USB.
+
+   Whether 108 MHz actually out-executes 96 MHz from flash depends on
+   the wait states (see system_clock_config); prj_uart_test prints
+   effective MIPS for whichever profile it was built with. */
+#if defined(SYSTEM_CLOCK_PROFILE) && (108 == SYSTEM_CLOCK_PROFILE)
+#define __SYSTEM_CLOCK_108M_PLL_HXTAL           (uint32_t)(108000000)
+#elif !defined(__SYSTEM_CLOCK_HXTAL) && !defined(__SYSTEM_CLOCK_24M_PLL_HXTAL) && \
+      !defined(__SYSTEM_CLOCK_36M_PLL_HXTAL) && !defined(__SYSTEM_CLOCK_48M_PLL_HXTAL) && \
+      !defined(__SYSTEM_CLOCK_56M_PLL_HXTAL) && !defined(__SYSTEM_CLOCK_72M_PLL_HXTAL) && \
+      !defined(__SYSTEM_CLOCK_108M_PLL_HXTAL) && !defined(__SYSTEM_CLOCK_48M_PLL_IRC8M) && \
+      !defined(__SYSTEM_CLOCK_72M_PLL_IRC8M) && !defined(__SYSTEM_CLOCK_108M_PLL_IRC8M)
+#define __SYSTEM_CLOCK_96M_PLL_HXTAL            (uint32_t)(96000000)
+#endif
+
 /* The following is to prevent Vcore fluctuations caused by frequency switching. 
    It is strongly recommended to include it to avoid issues caused by self-removal. */
 #define RCU_MODIFY_DE_2(__delay)  do{                                     \
@@ -142,6 +165,22 @@ static void _soft_delay_(uint32_t time)
 */
 static void system_clock_config(void)
 {
+    /* Program the flash wait states for the target AHB clock before
+       switching to it (0 WS to 36 MHz, 1 WS to 72 MHz, 2 WS above; the
+       GD32VF103 FMC has no prefetch enable bit, so WSCNT is the only
+       flash-timing knob). The reset value is 0 WS, which is out of spec
+       for every PLL profile above 36 MHz. */
+#if defined(__SYSTEM_CLOCK_96M_PLL_HXTAL) || defined(__SYSTEM_CLOCK_108M_PLL_HXTAL) || \
+    defined(__SYSTEM_CLOCK_108M_PLL_IRC8M)
+    fmc_wscnt_set(WS_WSCNT_2);
+#elif defined(__SYSTEM_CLOCK_48M_PLL_HXTAL) || defined(__SYSTEM_CLOCK_56M_PLL_HXTAL) || \
+      defined(__SYSTEM_CLOCK_72M_PLL_HXTAL) || defined(__SYSTEM_CLOCK_48M_PLL_IRC8M) || \
+      defined(__SYSTEM_CLOCK_72M_PLL_IRC8M)
+    fmc_wscnt_set(WS_WSCNT_1);
+#else
+    fmc_wscnt_set(WS_WSCNT_0);
+#endif
+
 #ifdef __SYSTEM_CLOCK_HXTAL
     system_clock_hxtal();
 #elif defined (__SYSTEM_CLOCK_24M_PLL_HXTAL)
@@ -209,6 +248,43 @@ void SystemInit(void)
     system_clock_config();
 }
 
+/*!
+    \brief      restore the configured PLL profile after a DEEP_SLEEP wake-up
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void system_clock_resume(void)
+{
+    /* Leaving DEEP_SLEEP the hardware has switched CK_SYS to IRC8M and
+       stopped HXTAL and the PLLs; every RCU_CFG divider and multiplier
+       kept its value. Resume therefore only re-arms the oscillators the
+       configuration actually uses and switches back - none of the full
+       SystemInit reset walk with its settle delays. Wake-up latency is
+       dominated by the HXTAL startup (sub-millisecond with the board's
+       8 MHz crystal), which is what USB resume timing needs.
+
+       Only meaningful for the PLL profiles; the plain-HXTAL profile has
+       no USB and never sleeps through this path. */
+    if(RCU_CFG0 & RCU_CFG0_PLLSEL){
+        RCU_CTL |= RCU_CTL_HXTALEN;
+        while(0U == (RCU_CTL & RCU_CTL_HXTALSTB)){
+        }
+        if(RCU_CFG1 & RCU_CFG1_PREDV0SEL){
+            /* the 25 MHz crystal profiles feed PREDV0 from PLL1 */
+            RCU_CTL |= RCU_CTL_PLL1EN;
+            while(0U == (RCU_CTL & RCU_CTL_PLL1STB)){
+            }
+        }
+    }
+    RCU_CTL |= RCU_CTL_PLLEN;
+    while(0U == (RCU_CTL & RCU_CTL_PLLSTB)){
+    }
+    RCU_CFG0 = (RCU_CFG0 & ~RCU_CFG0_SCS) | RCU_CKSYSSRC_PLL;
+    while(RCU_SCSS_PLL != (RCU_CFG0 & RCU_CFG0_SCSS)){
+    }
+}
+
 /*!
     \brief      update the SystemCoreClock with current core clock retrieved from cpu registers
     \param[in]  none
@@ -52,6 +52,8 @@ extern uint32_t SystemCoreClock;
 extern void SystemInit(void);
 /* update the SystemCoreClock with current core clock retrieved from cpu registers */
 extern void SystemCoreClockUpdate(void);
+/* restore the configured PLL profile after a DEEP_SLEEP wake-up */
+extern void system_clock_resume(void);
 #ifdef __FIRMWARE_VERSION_DEFINE
 /* get firmware version */
 extern uint32_t gd32vf103_firmware_version_get(void);
@@ -0,0 +1,39 @@
+/*!
+    \file    trace.h
+    \brief   Compile-time leveled trace facility.
+
+    Trace calls above TRACE_MAX_LEVEL are discarded by constant folding:
+    no code is emitted and the format strings never reach flash, so a
+    release build carries zero instrumentation cost. The UART write
+    behind an enabled trace is blocking and distorts timing on hot
+    paths, so keep DEBUG-level traces out of measurement builds.
+
+    Override the limit per build, e.g.
+        -DTRACE_MAX_LEVEL=TRACE_LEVEL_DEBUG   (bring-up)
+        -DTRACE_MAX_LEVEL=TRACE_LEVEL_NONE    (measurement)
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+/* Trace levels, most severe first. */
+#define TRACE_LEVEL_NONE  0
+#define TRACE_LEVEL_ERROR 1
+#define TRACE_LEVEL_INFO  2
+#define TRACE_LEVEL_DEBUG 3
+
+/* Highest level compiled in. */
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL TRACE_LEVEL_ERROR
+#endif
+
+#define TRACE(level, ...) \
+    do { if ((level) <= TRACE_MAX_LEVEL) { printf(__VA_ARGS__); } } while (0)
+
+#define TRACE_ERROR(...) TRACE(TRACE_LEVEL_ERROR, __VA_ARGS__)
+#define TRACE_INFO(...)  TRACE(TRACE_LEVEL_INFO, __VA_ARGS__)
+#define TRACE_DEBUG(...) TRACE(TRACE_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* TRACE_H */
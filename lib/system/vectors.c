@@ -0,0 +1,30 @@
+/* SRAM-resident interrupt vector table; see vectors.h for the rationale. */
+
+#include <gd32vf103.h>
+#include <stdint.h>
+#include "riscv_encoding.h"
+#include "n200_func.h"
+#include "vectors.h"
+
+/* The flash vector table assembled in start.S. */
+extern uint32_t vector_base[];
+
+/* MTVT requires the table base to be aligned to its size rounded up to a
+ * power of two: 87 word entries round up to 512 bytes. */
+static uint32_t ram_vector_table[ECLIC_NUM_INTERRUPTS] __attribute__((aligned(512)));
+
+void irq_vectors_relocate(void)
+{
+    for (uint32_t i = 0; i < ECLIC_NUM_INTERRUPTS; i++) {
+        ram_vector_table[i] = vector_base[i];
+    }
+    /* CSR_MTVT (0x307) is a Nuclei CSR the toolchain only knows by number,
+     * so write_csr()'s register-name stringification cannot be used. */
+    asm volatile("csrw 0x307, %0" : : "r"(ram_vector_table));
+}
+
+void irq_vector_register(uint32_t source, void (*handler)(void))
+{
+    ram_vector_table[source] = (uint32_t)handler;
+    eclic_set_vmode(source);
+}
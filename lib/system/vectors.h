@@ -0,0 +1,68 @@
+#ifndef VECTORS_H
+#define VECTORS_H
+
+#include <stdint.h>
+#include "riscv_encoding.h"
+
+/**
+ * @brief SRAM-resident interrupt vector table with per-IRQ ECLIC vectoring.
+ *
+ * start.S assembles vector_base in flash and the shared irq_entry
+ * trampoline (entry.S) dispatches every interrupt through it in
+ * non-vectored mode. That path costs a full context save plus flash wait
+ * states on the table fetch. This module copies the table into a
+ * 512-byte-aligned SRAM mirror at boot and lets individual hot IRQs opt
+ * into ECLIC vectored mode, where the core jumps straight to the handler
+ * named in the table with no trampoline in between.
+ *
+ * A vectored handler receives none of the trampoline's context save: it
+ * must be declared with IRQ_VECTORED (and normally RAMTEXT) so the
+ * compiler emits the ISR prolog/epilog and returns with mret. This
+ * project assigns ECLIC priorities but keeps every interrupt at the same
+ * level, so vectored handlers cannot be preempted and need no manual
+ * mepc/mcause/msubm save.
+ */
+
+/* Generates the ISR prolog/epilog for a directly-vectored handler. */
+#define IRQ_VECTORED __attribute__((interrupt))
+
+/*
+ * A vectored entry runs with mstatus.MIE clear, so by default nothing --
+ * not even a higher ECLIC level -- preempts it. Handlers below
+ * IRQ_LEVEL_USB (see irq_map.h) bracket their body with these macros:
+ * they save the CSRs a preempting entry would clobber (the shared
+ * trampoline does the same with CSR_PUSHMCAUSE/PUSHMEPC/PUSHMSUBM) and
+ * then re-enable interrupts so higher-level sources get through.
+ * Top-level handlers skip them and keep interrupts off.
+ */
+#define IRQ_PREEMPT_ENTER() \
+    uint32_t irq_saved_mcause = read_csr(mcause); \
+    uint32_t irq_saved_mepc   = read_csr(mepc);   \
+    uint32_t irq_saved_msubm;                     \
+    asm volatile("csrr %0, 0x7c4" : "=r"(irq_saved_msubm)); /* CSR_MSUBM */ \
+    set_csr(mstatus, MSTATUS_MIE)
+
+#define IRQ_PREEMPT_EXIT() \
+    clear_csr(mstatus, MSTATUS_MIE);                         \
+    asm volatile("csrw 0x7c4, %0" : : "r"(irq_saved_msubm)); \
+    write_csr(mepc, irq_saved_mepc);                         \
+    write_csr(mcause, irq_saved_mcause)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Copies vector_base into the SRAM mirror and repoints MTVT at it.
+ * Called once from _init(); every interrupt, vectored or not, then
+ * resolves its handler through zero-wait-state SRAM. */
+void irq_vectors_relocate(void);
+
+/* Switches one interrupt source to vectored dispatch through `handler`.
+ * `source` is an IRQn_Type value (e.g. USBFS_IRQn). */
+void irq_vector_register(uint32_t source, void (*handler)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VECTORS_H */
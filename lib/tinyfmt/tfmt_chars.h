@@ -0,0 +1,212 @@
+/*!
+    \file    tfmt_chars.h
+    \brief   Bounded, allocation-free number-to-text conversion.
+
+    tinyfmt.c already keeps printf off newlib's vfprintf, but a printf
+    still parses its format string at runtime, walks varargs, and costs
+    a call into the formatter per line. The paths that format on a
+    deadline - the SOF-paced status assembly in report_service, the
+    stats volume render that runs inside an MSC read, the bench runner -
+    want the number-to-text step and nothing else. This header is that
+    step: to_chars() renders one integer into caller-owned storage and
+    returns the write cursor, and Writer strings conversions together
+    into a fixed buffer with truncate-and-flag overflow semantics.
+    Everything is inline integer arithmetic on the stack; nothing
+    allocates, nothing locks, so any of it can run in ISR context.
+
+    Buffers are sized at compile time instead of checked at runtime:
+    MaxU32Chars and friends give the worst-case width of each
+    conversion, TFMT_LIT_W() the width of a literal, and a static_assert
+    over their sum proves a line cannot truncate:
+
+        char line[TFMT_LIT_W("drops ") + tfmt::MaxU32Chars + 1];
+        static_assert(sizeof(line) >= ..., "...");
+
+    Truncation then only happens on a sizing bug, and Writer::ok()
+    reports it instead of writing past the buffer.
+*/
+
+#ifndef TFMT_CHARS_H
+#define TFMT_CHARS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Width of a string literal, for compile-time line budgets. */
+#define TFMT_LIT_W(s) (sizeof(s) - 1)
+
+namespace tfmt {
+
+/* Worst-case character counts per conversion (no terminator). */
+constexpr size_t MaxU32Chars = 10; // 4294967295
+constexpr size_t MaxI32Chars = 11; // -2147483648
+constexpr size_t MaxU64Chars = 20; // 18446744073709551615
+constexpr size_t MaxHex32Chars = 8;
+
+/* Decimal digits needed for values up to and including `max`, for
+   buffers bounded tighter than the full type range. */
+constexpr size_t dec_width(uint64_t max)
+{
+    size_t n = 1;
+    while (max >= 10) {
+        max /= 10;
+        n++;
+    }
+    return n;
+}
+
+/*!
+    \brief  Renders `v` in decimal at `dst` and returns one past the
+            last character written. No terminator; the caller owns at
+            least MaxU32Chars of room (or dec_width() of its bound).
+*/
+inline char *to_chars(char *dst, uint32_t v)
+{
+    char tmp[MaxU32Chars];
+    char *t = tmp;
+    do {
+        *t++ = static_cast<char>('0' + (v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+    while (t != tmp) {
+        *dst++ = *--t;
+    }
+    return dst;
+}
+
+inline char *to_chars(char *dst, int32_t v)
+{
+    uint32_t mag = static_cast<uint32_t>(v);
+    if (v < 0) {
+        *dst++ = '-';
+        mag = 0U - mag;
+    }
+    return to_chars(dst, mag);
+}
+
+inline char *to_chars(char *dst, uint64_t v)
+{
+    char tmp[MaxU64Chars];
+    char *t = tmp;
+    do {
+        *t++ = static_cast<char>('0' + static_cast<uint32_t>(v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+    while (t != tmp) {
+        *dst++ = *--t;
+    }
+    return dst;
+}
+
+/*!
+    \brief  Renders `v` in lowercase hex, minimal width (no 0x prefix,
+            no leading zeroes; "0" for zero).
+*/
+inline char *to_chars_hex(char *dst, uint32_t v)
+{
+    static const char digits[] = "0123456789abcdef";
+    char tmp[MaxHex32Chars];
+    char *t = tmp;
+    do {
+        *t++ = digits[v & 0xFU];
+        v >>= 4;
+    } while (v != 0U);
+    while (t != tmp) {
+        *dst++ = *--t;
+    }
+    return dst;
+}
+
+/*!
+    \brief  Fixed-buffer append cursor over the to_chars conversions.
+
+    Appends clamp at the buffer's end rather than overflow; ok() goes
+    false on the first clamped byte so a sizing bug is visible instead
+    of silent. terminate() NUL-terminates in place (reserving the last
+    byte) and returns the buffer, so a Writer line drops straight into
+    shell::put or a render buffer.
+*/
+class Writer {
+public:
+    Writer(char *buf, size_t cap) : m_buf(buf), m_cap(cap), m_len(0),
+                                    m_ok(cap != 0) {}
+
+    Writer &ch(char c)
+    {
+        if (m_len < m_cap) {
+            m_buf[m_len++] = c;
+        } else {
+            m_ok = false;
+        }
+        return *this;
+    }
+
+    Writer &str(const char *s)
+    {
+        while (*s) {
+            ch(*s++);
+        }
+        return *this;
+    }
+
+    /* Space-fill so the next append starts at column `col` (no-op if
+       already past it) - the "%-6s" of label columns. */
+    Writer &pad_to(size_t col)
+    {
+        while (m_len < col && m_len < m_cap) {
+            m_buf[m_len++] = ' ';
+        }
+        return *this;
+    }
+
+    Writer &dec(uint32_t v) { return num(v); }
+    Writer &dec(int32_t v) { return num(v); }
+    Writer &dec(uint64_t v) { return num(v); }
+
+    Writer &hex(uint32_t v)
+    {
+        char tmp[MaxHex32Chars];
+        return span(tmp, to_chars_hex(tmp, v));
+    }
+
+    size_t size() const { return m_len; }
+    bool ok() const { return m_ok; }
+
+    /* NUL-terminates (truncating the last byte if the buffer is brim
+       full) and returns the buffer. */
+    char *terminate()
+    {
+        if (m_len < m_cap) {
+            m_buf[m_len] = '\0';
+        } else {
+            m_buf[m_cap - 1] = '\0';
+            m_ok = false;
+        }
+        return m_buf;
+    }
+
+private:
+    template <typename T> Writer &num(T v)
+    {
+        char tmp[MaxU64Chars + 1]; // sign
+        return span(tmp, to_chars(tmp, v));
+    }
+
+    Writer &span(const char *first, const char *last)
+    {
+        while (first != last) {
+            ch(*first++);
+        }
+        return *this;
+    }
+
+    char *m_buf;
+    size_t m_cap;
+    size_t m_len;
+    bool m_ok;
+};
+
+} // namespace tfmt
+
+#endif /* TFMT_CHARS_H */
@@ -0,0 +1,297 @@
+/*!
+    \file    tinyfmt.c
+    \brief   Integer-only printf family; see tinyfmt.h.
+
+    These definitions win over newlib's at link time simply by being in
+    an object file (libraries are searched last), so no linker flags or
+    wrapping are needed. The formatter is a single pass over the format
+    string with a 20-byte digit buffer; no allocation, no tables, and
+    the stack cost is one small flush buffer.
+*/
+
+#include "tinyfmt.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Some newlib configurations make these macros over putc(); the real
+   symbols are defined below. */
+#undef putchar
+#undef puts
+
+/* The debug UART retarget (lib/debug_uart0/debug_write.cpp). */
+int _write(int file, char *ptr, int len);
+
+/* ------------------------------------------------------------------ */
+/* Output sink: either a bounded destination buffer (snprintf) or a    */
+/* small flush buffer drained through _write (printf). total always    */
+/* counts what would have been written, per the standard contract.     */
+/* ------------------------------------------------------------------ */
+typedef struct {
+    char *dst;          /* snprintf destination, NULL for printf */
+    size_t cap;         /* bytes usable in dst (excludes the NUL) */
+    size_t total;
+    char flush[64];
+    size_t buffered;
+} sink_t;
+
+static void sink_putc(sink_t *s, char c)
+{
+    if (NULL != s->dst) {
+        if (s->total < s->cap) {
+            s->dst[s->total] = c;
+        }
+    } else {
+        s->flush[s->buffered++] = c;
+        if (sizeof(s->flush) == s->buffered) {
+            _write(1, s->flush, (int)s->buffered);
+            s->buffered = 0;
+        }
+    }
+    s->total++;
+}
+
+static void sink_done(sink_t *s)
+{
+    if (NULL != s->dst) {
+        s->dst[(s->total < s->cap) ? s->total : s->cap] = '\0';
+    } else if (0 != s->buffered) {
+        _write(1, s->flush, (int)s->buffered);
+        s->buffered = 0;
+    }
+}
+
+/* Emits one converted field: the digits in tmp[0..len), padded to width
+   with ' ' or '0', left-justified on '-'. A sign or "0x" prefix must
+   already be in tmp so zero padding lands after it -- the callers below
+   place it there. */
+static void emit_field(sink_t *s, const char *tmp, size_t len,
+                       size_t width, int left, int zero)
+{
+    if (!left) {
+        while (len < width--) {
+            sink_putc(s, zero ? '0' : ' ');
+        }
+    }
+    for (size_t i = 0; i < len; i++) {
+        sink_putc(s, tmp[i]);
+    }
+    if (left) {
+        while (len++ < width) {
+            sink_putc(s, ' ');
+        }
+    }
+}
+
+/* Unsigned 64-bit to ASCII in the given base, returns the length.
+   tmp must hold 20 characters (2^64 in decimal). */
+static size_t utoa_rev(char *tmp, unsigned long long v,
+                       unsigned base, int upper)
+{
+    static const char lower_digits[] = "0123456789abcdef";
+    static const char upper_digits[] = "0123456789ABCDEF";
+    const char *digits = upper ? upper_digits : lower_digits;
+    char rev[20];
+    size_t n = 0;
+
+    do {
+        rev[n++] = digits[v % base];
+        v /= base;
+    } while (0 != v);
+    for (size_t i = 0; i < n; i++) {
+        tmp[i] = rev[n - 1 - i];
+    }
+    return n;
+}
+
+static void format(sink_t *s, const char *fmt, va_list ap)
+{
+    while ('\0' != *fmt) {
+        if ('%' != *fmt) {
+            sink_putc(s, *fmt++);
+            continue;
+        }
+        fmt++;
+        if ('%' == *fmt) {
+            sink_putc(s, '%');
+            fmt++;
+            continue;
+        }
+
+        int left = 0, zero = 0;
+        while ('-' == *fmt || '0' == *fmt) {
+            if ('-' == *fmt) {
+                left = 1;
+            } else {
+                zero = 1;
+            }
+            fmt++;
+        }
+        size_t width = 0;
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (size_t)(*fmt++ - '0');
+        }
+        int longs = 0;
+        while ('l' == *fmt) {
+            longs++;
+            fmt++;
+        }
+
+        char tmp[22]; /* sign + 20 digits, or "0x" + 16 digits */
+        size_t len;
+        unsigned long long uv;
+
+        switch (*fmt++) {
+        case 'd':
+        case 'i': {
+            long long v = (longs >= 2) ? va_arg(ap, long long)
+                        : (longs == 1) ? va_arg(ap, long)
+                                       : va_arg(ap, int);
+            len = 0;
+            if (v < 0) {
+                tmp[len++] = '-';
+                uv = (unsigned long long)(-(v + 1)) + 1U;
+            } else {
+                uv = (unsigned long long)v;
+            }
+            len += utoa_rev(&tmp[len], uv, 10, 0);
+            emit_field(s, tmp, len, width, left, zero);
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X': {
+            int hex = ('u' != fmt[-1]);
+            uv = (longs >= 2) ? va_arg(ap, unsigned long long)
+               : (longs == 1) ? va_arg(ap, unsigned long)
+                              : va_arg(ap, unsigned int);
+            len = utoa_rev(tmp, uv, hex ? 16U : 10U, 'X' == fmt[-1]);
+            emit_field(s, tmp, len, width, left, zero);
+            break;
+        }
+        case 'p':
+            tmp[0] = '0';
+            tmp[1] = 'x';
+            len = 2 + utoa_rev(&tmp[2], (uintptr_t)va_arg(ap, void *), 16, 0);
+            emit_field(s, tmp, len, width, left, zero);
+            break;
+        case 'c':
+            tmp[0] = (char)va_arg(ap, int);
+            emit_field(s, tmp, 1, width, left, 0);
+            break;
+        case 's': {
+            const char *str = va_arg(ap, const char *);
+            if (NULL == str) {
+                str = "(null)";
+            }
+            emit_field(s, str, strlen(str), width, left, 0);
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E':
+        case 'g': case 'G': case 'a': case 'A':
+            /* Not built in; keep the remaining varargs aligned. */
+            (void)va_arg(ap, double);
+            sink_putc(s, '?');
+            break;
+        default:
+            /* Unknown conversion: show it raw so the log exposes it. */
+            sink_putc(s, '%');
+            sink_putc(s, fmt[-1]);
+            break;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* The printf family itself.                                          */
+/* ------------------------------------------------------------------ */
+
+int vprintf(const char *fmt, va_list ap)
+{
+    sink_t s = { NULL, 0, 0, { 0 }, 0 };
+    format(&s, fmt, ap);
+    sink_done(&s);
+    return (int)s.total;
+}
+
+int printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int vsnprintf(char *dst, size_t size, const char *fmt, va_list ap)
+{
+    /* A NULL destination still needs dst != NULL in the sink so the
+       printf path is not taken; the zero cap keeps it write-free. */
+    char dummy;
+    sink_t s = { (NULL != dst) ? dst : &dummy,
+                 (NULL != dst && size > 0) ? size - 1 : 0, 0, { 0 }, 0 };
+    format(&s, fmt, ap);
+    if (NULL != dst && size > 0) {
+        sink_done(&s);
+    }
+    return (int)s.total;
+}
+
+int snprintf(char *dst, size_t size, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(dst, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/* GCC rewrites printf("...\n") into puts() and printf("%c") into
+   putchar(), so both must come from here too or newlib sneaks back. */
+int puts(const char *str)
+{
+    size_t len = strlen(str);
+    _write(1, (char *)str, (int)len);
+    _write(1, "\n", 1);
+    return (int)len + 1;
+}
+
+int putchar(int c)
+{
+    char ch = (char)c;
+    _write(1, &ch, 1);
+    return c;
+}
+
+int tfmt_fixed(char *dst, size_t size, int32_t value,
+               unsigned frac_bits, unsigned places)
+{
+    sink_t s = { dst, (size > 0) ? size - 1 : 0, 0, { 0 }, 0 };
+    char tmp[22];
+    size_t len = 0;
+
+    uint32_t mag;
+    if (value < 0) {
+        tmp[len++] = '-';
+        mag = (uint32_t)(-(value + 1)) + 1U;
+    } else {
+        mag = (uint32_t)value;
+    }
+    len += utoa_rev(&tmp[len], mag >> frac_bits, 10, 0);
+    emit_field(&s, tmp, len, 0, 0, 0);
+
+    if (places > 0) {
+        sink_putc(&s, '.');
+        uint32_t frac = mag & ((1UL << frac_bits) - 1U);
+        while (places-- > 0) {
+            frac *= 10U;
+            sink_putc(&s, (char)('0' + (frac >> frac_bits)));
+            frac &= (1UL << frac_bits) - 1U;
+        }
+    }
+    if (size > 0) {
+        sink_done(&s);
+    }
+    return (int)s.total;
+}
@@ -0,0 +1,105 @@
+/*!
+    \file    tinyfmt.h
+    \brief   Compact integer-only printf replacement.
+
+    Linking lib/tinyfmt gives the firmware its own printf / vprintf /
+    snprintf / vsnprintf / puts / putchar, so newlib's full vfprintf
+    (several KB of flash and slow table-driven formatting) is never
+    pulled in. Call sites do not change: output still goes through the
+    _write retarget in lib/debug_uart0, so everything printf'd lands in
+    the asynchronous debug UART ring as before.
+
+    Supported conversions: %d %i %u %x %X %p %c %s %%, the '-' and '0'
+    flags, a decimal field width, and the l / ll length modifiers
+    (l is a no-op on ilp32, ll selects 64-bit). Floating point is
+    deliberately absent; a float conversion consumes its argument (so
+    later arguments stay aligned) and prints '?'.
+
+    C++ call sites can opt into compile-time validation against exactly
+    this subset with TFMT_PRINTF(), which static_asserts on the format
+    string before forwarding to printf. A plain printf still gets the
+    compiler's -Wformat checking, which catches argument/specifier
+    mismatches but not the use of conversions tinyfmt does not build in.
+*/
+
+#ifndef TINYFMT_H
+#define TINYFMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Renders a signed fixed-point value as a decimal string, e.g. a Q16.16
+   value with places=3 becomes "-1.500". Replaces the %f nobody gets:
+   format the number with this, print it with %s. Returns the length
+   written (excluding the terminator), truncated to size-1. */
+int tfmt_fixed(char *dst, size_t size, int32_t value,
+               unsigned frac_bits, unsigned places);
+
+#ifdef __cplusplus
+}
+
+namespace tfmt {
+
+/*!
+    \brief  Compile-time check that a format string only uses the
+            conversions tinyfmt implements. constexpr so it can sit in a
+            static_assert; returns false on %f/%e/%g, unknown
+            conversions, or more than two 'l' modifiers.
+*/
+constexpr bool valid(const char *f)
+{
+    while (*f) {
+        if (*f++ != '%') {
+            continue;
+        }
+        if ('%' == *f) {
+            f++;
+            continue;
+        }
+        while ('-' == *f || '0' == *f) {
+            f++;
+        }
+        while (*f >= '0' && *f <= '9') {
+            f++;
+        }
+        int longs = 0;
+        while ('l' == *f) {
+            longs++;
+            f++;
+        }
+        if (longs > 2) {
+            return false;
+        }
+        switch (*f++) {
+        case 'd': case 'i': case 'u': case 'x': case 'X':
+            break;
+        case 'c': case 's': case 'p':
+            if (longs) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace tfmt
+
+/* printf with the format string vetted at compile time. The format must
+   be a string literal. */
+#define TFMT_PRINTF(fmt, ...)                                             \
+    do {                                                                  \
+        static_assert(tfmt::valid(fmt),                                   \
+                      "tinyfmt: format uses a conversion it does not implement"); \
+        printf(fmt, ##__VA_ARGS__);                                       \
+    } while (0)
+
+#endif /* __cplusplus */
+
+#endif /* TINYFMT_H */
@@ -38,6 +38,9 @@ GLOBAL_C_DEFINES = [
     "-D__NUCLEI_N200",
     "-DGD32VF103C_START",
     "-DUSE_SD_CARD_MSC=1",
+    # Panel revision timing profile for the LCD init sequence (lib/gd32v_lcd):
+    # 0 = rev A (ST7735S datasheet minimums), 1 = rev B (measured settle).
+    "-DLCD_PANEL_PROFILE=0",
 ]
 
 # --- CPU & ABI Flags ---
@@ -62,7 +65,7 @@ for component_name in ['riscv_drivers', 'syscall_stubs', 'gd32_std_peripheral_li
     gd32_components[component_name]['module'] = "gd32"
 
 lib_components = {}
-for component_name in ['debug_uart0', 'gd32_lcd', 'system',]:
+for component_name in ['debug_uart0', 'dma', 'fixtab', 'gd32_lcd', 'lcd_font', 'system', 'tinyfmt',]:
     lib_components[component_name] = lib[component_name].copy()
     lib_components[component_name]['module'] = 'lib'
 
@@ -90,6 +93,8 @@ NUCLEUS_OPENOCD_PATH = config.NUCLEUS_OPENOCD_PATH
 OPENOCD_PATH = config.OPENOCD_PATH
 DFU_UTIL_PATH = config.DFU_UTIL_PATH
 OPTIMIZATION = config.OPTIMIZATION
+BUILD_PROFILES = config.BUILD_PROFILES
+LTO_FLAGS = config.LTO_FLAGS
 C_STANDARD = config.C_STANDARD
 CPP_STANDARD = config.CPP_STANDARD
 COMMON_WARNING_FLAGS = config.COMMON_WARNING_FLAGS
@@ -2,19 +2,12 @@
 // Code for rendering the "Amiga ball".
 // ------------------------------------------------------------------------
 
+#include "fixtab.h"
+
 int w_approx(int x)
 {
-    // Generated in Python:
-    // for i in range(32):
-    //     print(int(8192 / ((1 - (i/32.0)**2)**0.5)))
-    // print(65535)
-    static const int s_lut[33] = {
-         8192,  8196,  8208,  8228,  8256,  8293,  8339,  8395,  8460,  8536,
-         8623,  8723,  8836,  8965,  9110,  9273,  9459,  9669,  9908, 10180,
-        10494, 10856, 11280, 11782, 12385, 13123, 14052, 15262, 16921, 19378,
-        23541, 33027, 65535
-    };
-
+    // 8192 / sqrt(1 - (x/8192)^2); the table is generated at compile
+    // time by lib/fixtab (see fixtab_tables.cpp).
     if (x < 0)
         x = -x;
     if (x > (32<<8) - 1)
@@ -22,8 +15,8 @@ int w_approx(int x)
 
     int m = x >> 8;
     int f = x & 0xff;
-    int v0 = s_lut[m];
-    int v1 = s_lut[m+1];
+    int v0 = fixtab_rsqrt1mx2.v[m];
+    int v1 = fixtab_rsqrt1mx2.v[m+1];
     return ((v0 * (0xff - f)) + (v1 * f)) >> 8;
 }
 
@@ -48,6 +41,11 @@ int c_remap(int x)
     return 256;
 }
 
+// Checker tilt of the ball, in 13-bit angle units (8192 = full turn,
+// ~11.5 degrees). The rotation coefficients come out of the sine table
+// instead of being hand-pasted Q2.13 constants.
+enum { BALL_TILT = 260 };
+
 int amigaBall(int x_, int y_, int ph_)
 {
     x_ >>= 1;
@@ -55,8 +53,10 @@ int amigaBall(int x_, int y_, int ph_)
     x_ -= 32 << 8;
     y_ -= 32 << 8;
 
-    int x = ( 8028 * x_ + 1627 * y_) >> 13;
-    int y = (-1627 * x_ + 8028 * y_) >> 13;
+    int sin_t = fixtab_sin_q13(BALL_TILT);
+    int cos_t = fixtab_cos_q13(BALL_TILT);
+    int x = ( cos_t * x_ + sin_t * y_) >> 13;
+    int y = (-sin_t * x_ + cos_t * y_) >> 13;
 
     int r = x*x+y*y;
     if (r > (1<<26))
@@ -27,6 +27,29 @@ uint16_t bgcol(int p)
 
 #include "amigaball.inl"
 #include "starfield.inl"
+#include "striprender.inl"
+
+// ------------------------------------------------------------------------
+// Amiga ball as a strip renderer (see striprender.inl).
+// ------------------------------------------------------------------------
+
+typedef struct
+{
+    int px, py, ph;
+} BallState;
+
+static void render_ball_strip(uint16_t* dst, int y0, int h, void* ctx)
+{
+    BallState* b = (BallState*)ctx;
+    for (int y = y0; y < y0 + h; y++)
+    for (int x = 0; x < LCD_WIDTH; x++)
+    {
+        int fx = (x << 8) - b->px;
+        int fy = (y << 8) - b->py;
+        int c = amigaBall(fx, fy, b->ph);
+        *dst++ = (c >= 0) ? (uint16_t)c : bgcolxy(x, y);
+    }
+}
 
 int main(void)
 {
@@ -55,52 +78,24 @@ int main(void)
     }
 
 #elif 1
-    // Example with framebuffer upload after each frame completion (Amiga ball).
+    // Strip-rendered Amiga ball: each 16-line strip is computed while the
+    // previous one ships over DMA (see striprender.inl), so the panel
+    // runs at the SPI rate instead of waiting for full-frame renders.
+    // An FPS counter is composited into the top-left of the frame.
 
-    int px = 0;
-    int py = 0;
+    BallState ball = { 0, 0, 0 };
     int dx = 1 << 8;
     int dy = 1 << 8;
-    int ph = 0;
     for(;;)
     {
-        // Render into framebuffer.
-        uint16_t* pfb = g_fb;
-        for (int y=0; y < LCD_HEIGHT; y++)
-        for (int x=0; x < LCD_WIDTH; x++)
-        {
-            int fx = (x << 8) - px;
-            int fy = (y << 8) - py;
-            int c = amigaBall(fx, fy, ph);
-            if (c >= 0)
-                *pfb++ = c;
-            else
-                *pfb++ = bgcolxy(x, y);
-        }
-
-            // Set text color
-    uint16_t textColor = 0xFFFF; // White
-
-    // Draw text on the screen
-    draw_string(10, 10, "Hello, Gemini!", textColor);
-    draw_string(10, 30, "This is a test.", textColor);
-
-    // Draw text on the screen using the big font
-    draw_string_big(8, 10, "HELLO!", textColor);
-    draw_string_big(8, 40, "GEMINI", textColor);
-
-        // Trigger framebuffer upload. We rely on the upload being faster than
-        // our framebuffer writes in the loop above so that we can render the
-        // next frame while this one is being uploaded asynchronously in the
-        // background.
-        lcd_write_u16(0, 0, LCD_WIDTH, LCD_HEIGHT, g_fb);
+        render_frame_strips(render_ball_strip, &ball);
 
         // Update ball position.
-        px += dx; py += dy;
-        if (dx > 0) ph += (1 << 8); else ph -= (1 << 8);         // Rotation.
-        if (py > (16<<8))    { py = (16<<9) - py;    dy = -dy; } // Floor.
-        if (px > (96<<8))    { px = (96<<9) - px;    dx = -dx; } // Right wall.
-        if (px < (-64 << 8)) { px = (-64 << 9) - px; dx = -dx; } // Left wall.
+        ball.px += dx; ball.py += dy;
+        if (dx > 0) ball.ph += (1 << 8); else ball.ph -= (1 << 8);           // Rotation.
+        if (ball.py > (16<<8))    { ball.py = (16<<9) - ball.py;    dy = -dy; } // Floor.
+        if (ball.px > (96<<8))    { ball.px = (96<<9) - ball.px;    dx = -dx; } // Right wall.
+        if (ball.px < (-64 << 8)) { ball.px = (-64 << 9) - ball.px; dx = -dx; } // Left wall.
         dy += 1 << 4; // Apply gravity.
     }
 
@@ -37,6 +37,8 @@ uint32_t rnd_u32(void)
 
 // ------------------------------------------------------------------------
 
+#include "fix16.h"
+
 typedef struct
 {
     int16_t x, y, z, p;
@@ -57,8 +59,11 @@ void update_star(Star* v, int delta)
         v->z = 0x7fff;
     }
 
-    int x = ((int)(v->x) << 16) / v->z;
-    int y = ((int)(v->y) << 16) / v->z;
+    // Perspective projection: x/z and y/z in Q16.16. fix16_div keeps
+    // the <<16 intermediate in 64 bits, so the widest star coordinates
+    // cannot wrap the way the open-coded shift could.
+    int x = fix16_div(fix16_from_int(v->x), fix16_from_int(v->z));
+    int y = fix16_div(fix16_from_int(v->y), fix16_from_int(v->z));
 
     x >>= 10;
     y >>= 10;
@@ -0,0 +1,89 @@
+// ------------------------------------------------------------------------
+// Strip-based double-buffered rendering.
+//
+// The demo renders strip N+1 into one buffer while the DMA ships strip N
+// from the other through lcd.c: lcd_write_u16() returns as soon as the
+// transfer is programmed and only blocks if the previous strip is still
+// in flight, so compute and upload overlap across the whole frame. This
+// is the reference pattern for application-side rendering - the full-
+// framebuffer paths below either serialize (render, then upload) or need
+// the whole 25.6 KB frame resident.
+//
+// An FPS counter is measured per full frame and composited into the
+// strips top-left, so the cost of the overlay itself is included in the
+// number it shows.
+// ------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "lcd_font.h"
+
+uint64_t get_timer_value(void); // n200_func.h (mtime)
+
+enum { STRIP_H = 16 }; // lines per strip; 5 strips per frame
+
+// The strip pair borrows the first 10 KB of the (otherwise idle) full
+// framebuffer: strip rendering never uses g_fb as a frame, and the two
+// cannot coexist in 32 KB of SRAM next to a 25.6 KB framebuffer.
+static uint16_t* const g_strip[2] = { g_fb, g_fb + LCD_WIDTH * STRIP_H };
+
+// Renders one strip of the frame into dst (LCD_WIDTH * h pixels),
+// covering panel lines [y0, y0+h).
+typedef void (*strip_render_fn)(uint16_t* dst, int y0, int h, void* ctx);
+
+// Draws a string into a strip buffer, clipping glyph rows to the strip;
+// text spanning a strip boundary is completed by the following strip.
+static void strip_draw_string(uint16_t* strip, int y0, int h,
+                              int x, int y, const char* s, uint16_t color)
+{
+    for (; *s; s++, x += 8)
+    {
+        if (x < 0 || x + 8 > LCD_WIDTH)
+            return;
+        const unsigned char* glyph =
+            lcd_font_8x16.glyphs + (unsigned)(unsigned char)*s * 16;
+        for (int row = 0; row < 16; row++)
+        {
+            int py = y + row - y0;
+            if (py < 0 || py >= h)
+                continue;
+            for (int col = 0; col < 8; col++)
+                if ((glyph[row] >> (7 - col)) & 1)
+                    strip[py * LCD_WIDTH + x + col] = color;
+        }
+    }
+}
+
+static uint32_t g_fps_frames = 0;
+static uint64_t g_fps_window_start = 0;
+static char g_fps_text[12] = "-- fps";
+
+// Renders and ships one full frame strip by strip, then folds the frame
+// into the FPS window (updated once per second; mtime runs at
+// SystemCoreClock / 4).
+void render_frame_strips(strip_render_fn render, void* ctx)
+{
+    int buf = 0;
+    for (int y0 = 0; y0 < LCD_HEIGHT; y0 += STRIP_H)
+    {
+        uint16_t* dst = g_strip[buf];
+        render(dst, y0, STRIP_H, ctx);
+        strip_draw_string(dst, y0, STRIP_H, 2, 2, g_fps_text, 0xFFFF);
+        // Blocks only while the PREVIOUS strip is still on the wire,
+        // i.e. exactly the overlap we want.
+        lcd_write_u16(0, y0, LCD_WIDTH, STRIP_H, dst);
+        buf ^= 1;
+    }
+
+    g_fps_frames++;
+    uint64_t now = get_timer_value();
+    uint64_t ticks_per_second = SystemCoreClock / 4;
+    if (0 == g_fps_window_start)
+        g_fps_window_start = now;
+    if ((now - g_fps_window_start) >= ticks_per_second)
+    {
+        snprintf(g_fps_text, sizeof(g_fps_text), "%u fps",
+                 (unsigned)g_fps_frames);
+        g_fps_frames = 0;
+        g_fps_window_start = now;
+    }
+}
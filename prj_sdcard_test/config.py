@@ -62,7 +62,7 @@ for component_name in ['riscv_drivers', 'syscall_stubs', 'gd32_std_peripheral_li
     gd32_components[component_name]['module'] = "gd32"
 
 lib_components = {}
-for component_name in ['debug_uart0', 'system',]:
+for component_name in ['debug_uart0', 'system', 'tinyfmt',]:
     lib_components[component_name] = lib[component_name].copy()
     lib_components[component_name]['module'] = 'lib'
 
@@ -90,6 +90,8 @@ NUCLEUS_OPENOCD_PATH = config.NUCLEUS_OPENOCD_PATH
 OPENOCD_PATH = config.OPENOCD_PATH
 DFU_UTIL_PATH = config.DFU_UTIL_PATH
 OPTIMIZATION = config.OPTIMIZATION
+BUILD_PROFILES = config.BUILD_PROFILES
+LTO_FLAGS = config.LTO_FLAGS
 C_STANDARD = config.C_STANDARD
 CPP_STANDARD = config.CPP_STANDARD
 COMMON_WARNING_FLAGS = config.COMMON_WARNING_FLAGS
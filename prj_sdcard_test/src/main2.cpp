@@ -112,7 +112,11 @@ int main(void)
         printf("ERROR: SD card failed diagnostic tests. Performance benchmark will not run.\n");
         while(1);
     }
-    
+
+    // Characterization suite: throughput at several block counts plus
+    // per-command latency histograms (see SdCardTest::run_benchmarks).
+    test_runner.run_benchmarks();
+
     // Run performance benchmark
     printf("\n--- Starting Performance Benchmark (%d blocks, %d KB) ---\n", PERF_TEST_BLOCKS, (PERF_TEST_BLOCKS * 512) / 1024);
     
@@ -38,6 +38,14 @@ GLOBAL_C_DEFINES = [
     "-D__NUCLEI_N200",
     "-DGD32VF103C_START",
     "-DUSE_SD_CARD_MSC=1",
+    # No USB in this project, so it can run the 108 MHz profile, which
+    # also puts APB1 at 54 MHz - the ceiling the USART1 baud sweep in
+    # main.c is sized against (see lib/system/system_gd32vf103.c).
+    "-DSYSTEM_CLOCK_PROFILE=108",
+    # Baud sweep knobs for main.c: UART_TEST_SWEEP=0 plus UART_TEST_BAUD
+    # pins a single rate for soak testing one cable configuration.
+    "-DUART_TEST_SWEEP=1",
+    "-DUART_TEST_DWELL_S=10",
 ]
 
 # --- CPU & ABI Flags ---
@@ -62,7 +70,7 @@ for component_name in ['riscv_drivers', 'syscall_stubs', 'gd32_std_peripheral_li
     gd32_components[component_name]['module'] = "gd32"
 
 lib_components = {}
-for component_name in ['debug_uart0', 'system',]:
+for component_name in ['debug_uart0', 'dma', 'system', 'tinyfmt',]:
     lib_components[component_name] = lib[component_name].copy()
     lib_components[component_name]['module'] = 'lib'
 
@@ -73,7 +81,9 @@ COMPONENTS = {
         "c_sources": [],
         "cpp_sources": [r"src/main.c"],
         "asm_sources": [],
-        "include_paths": [r"-Isrc"],
+        # lib/dma holds the board-wide DMA channel claims (main.c drives
+        # USART1 through DMA0_USART1_RX/TX_CH).
+        "include_paths": [r"-Isrc", r"-I../lib/dma"],
         "enabled": True
     },
 }
@@ -90,6 +100,8 @@ NUCLEUS_OPENOCD_PATH = config.NUCLEUS_OPENOCD_PATH
 OPENOCD_PATH = config.OPENOCD_PATH
 DFU_UTIL_PATH = config.DFU_UTIL_PATH
 OPTIMIZATION = config.OPTIMIZATION
+BUILD_PROFILES = config.BUILD_PROFILES
+LTO_FLAGS = config.LTO_FLAGS
 C_STANDARD = config.C_STANDARD
 CPP_STANDARD = config.CPP_STANDARD
 COMMON_WARNING_FLAGS = config.COMMON_WARNING_FLAGS
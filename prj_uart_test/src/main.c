@@ -1,10 +1,303 @@
 #include "gd32vf103.h"
+#include "riscv_encoding.h"
+#include "n200_func.h"
+#include "longan_nano_dma_alloc.h"
+#include "dma_arbiter.h"
 #include <stdio.h>
+#include <string.h>
+
+/* UART qualification target.
+
+   The old main was a blocking-poll echo: it dropped bytes well below
+   1 MBaud and produced no numbers. This build turns the project into a
+   measurement tool for cables and level shifters:
+
+   - USART1 (PA2 TX / PA3 RX, APB1) is the port under test. The debug
+     console stays on USART0/printf at 115200, so the report channel
+     never competes with the traffic being measured.
+   - RX runs as a circular DMA ring (DMA0_USART1_RX_CH); the main loop
+     drains it by polling the channel's remaining-transfer counter, so
+     no byte is ever serviced by a per-character interrupt.
+   - Everything received is echoed back through one-shot TX DMA bursts
+     (DMA0_USART1_TX_CH) out of two alternating bounce buffers, so the
+     next burst is staged while the previous one is still on the wire.
+   - Once per second the loop prints bytes in/out, hardware overrun /
+     framing / noise counts, and the echo turnaround (pending data seen
+     -> TX DMA armed) as min/avg/max microseconds.
+
+   With UART_TEST_SWEEP=1 (the default) the port steps through the baud
+   table below, dwelling UART_TEST_DWELL_S seconds at each entry, so a
+   host script can sweep a cable without any in-band control protocol.
+   The ring gives the loop 1024 bytes of slack - about 3 ms at the
+   3.375 MBaud maximum - so overruns in the report indict the wire, not
+   the firmware. */
+
+#ifndef UART_TEST_SWEEP
+#define UART_TEST_SWEEP 1
+#endif
+#ifndef UART_TEST_DWELL_S
+#define UART_TEST_DWELL_S 10U
+#endif
+#ifndef UART_TEST_BAUD
+#define UART_TEST_BAUD 115200U /* fixed baud when the sweep is off */
+#endif
+
+/* USART1 sits on APB1 (54 MHz with the 108 MHz profile), and 16x
+   oversampling caps it at 54 MHz / 16 = 3.375 MBaud. */
+static const uint32_t g_baud_table[] = {
+    115200U, 460800U, 921600U, 1500000U, 3375000U,
+};
+#define BAUD_COUNT (sizeof(g_baud_table) / sizeof(g_baud_table[0]))
+
+#define RX_RING_SIZE   1024U /* power of two */
+#define TX_BOUNCE_SIZE 512U
+
+static uint8_t rx_ring[RX_RING_SIZE];
+static uint8_t tx_bounce[2][TX_BOUNCE_SIZE];
+static uint32_t g_rx_read;       /* ring index the echo loop has consumed to */
+static int g_tx_buf;             /* bounce buffer the next burst stages into */
+static int g_tx_busy;
+static uint32_t g_pending_since; /* mcycle when pending data was first seen */
+
+/* Counters for the periodic report (reset each window). */
+static struct {
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    uint32_t overruns;      /* USART ORERR: the DMA ring stalled */
+    uint32_t frame_errors;  /* FERR + NERR: wire-quality problems */
+    uint32_t bursts;
+    uint32_t turn_min, turn_max;
+    uint64_t turn_sum;
+} g_stats;
+
+static void stats_reset(void)
+{
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.turn_min = 0xFFFFFFFFU;
+}
+
+/* Configures PA2/PA3 and USART1 at 'baud' with both DMA request lines
+   enabled, and (re)arms the circular RX ring. */
+static void uart1_config(uint32_t baud)
+{
+    rcu_periph_clock_enable(RCU_GPIOA);
+    rcu_periph_clock_enable(RCU_USART1);
+    rcu_periph_clock_enable(RCU_DMA0);
+
+    gpio_init(GPIOA, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_2);
+    gpio_init(GPIOA, GPIO_MODE_IN_FLOATING, GPIO_OSPEED_50MHZ, GPIO_PIN_3);
+
+    usart_deinit(USART1);
+    usart_baudrate_set(USART1, baud);
+    usart_word_length_set(USART1, USART_WL_8BIT);
+    usart_stop_bit_set(USART1, USART_STB_1BIT);
+    usart_parity_config(USART1, USART_PM_NONE);
+    usart_hardware_flow_rts_config(USART1, USART_RTS_DISABLE);
+    usart_hardware_flow_cts_config(USART1, USART_CTS_DISABLE);
+    usart_dma_receive_config(USART1, USART_RECEIVE_DMA_ENABLE);
+    usart_dma_transmit_config(USART1, USART_TRANSMIT_DMA_ENABLE);
+    usart_receive_config(USART1, USART_RECEIVE_ENABLE);
+    usart_transmit_config(USART1, USART_TRANSMIT_ENABLE);
+    usart_enable(USART1);
+
+    /* RX ring: circular, peripheral-to-memory, runs forever. */
+    dma_parameter_struct dma_cfg;
+    dma_channel_disable(DMA0, DMA0_USART1_RX_CH);
+    dma_deinit(DMA0, DMA0_USART1_RX_CH);
+    dma_struct_para_init(&dma_cfg);
+    dma_cfg.periph_addr  = (uint32_t)&USART_DATA(USART1);
+    dma_cfg.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_cfg.memory_addr  = (uint32_t)rx_ring;
+    dma_cfg.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_cfg.number       = RX_RING_SIZE;
+    dma_cfg.priority     = dma_arbiter_priority(DMA0, DMA0_USART1_RX_CH);
+    dma_cfg.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+    dma_cfg.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+    dma_cfg.direction    = DMA_PERIPHERAL_TO_MEMORY;
+    dma_init(DMA0, DMA0_USART1_RX_CH, &dma_cfg);
+    dma_circulation_enable(DMA0, DMA0_USART1_RX_CH);
+    dma_channel_enable(DMA0, DMA0_USART1_RX_CH);
+
+    g_rx_read = 0;
+    g_tx_busy = 0;
+    g_pending_since = 0;
+}
+
+/* Ring index the DMA will write next, derived from the remaining-count
+   register (it counts down from RX_RING_SIZE and reloads). */
+static uint32_t rx_write_index(void)
+{
+    return (RX_RING_SIZE - dma_transfer_number_get(DMA0, DMA0_USART1_RX_CH))
+           & (RX_RING_SIZE - 1U);
+}
+
+/* Starts a one-shot TX DMA burst of 'len' bytes from 'src'. */
+static void tx_start(const uint8_t *src, uint32_t len)
+{
+    dma_parameter_struct dma_cfg;
+    dma_channel_disable(DMA0, DMA0_USART1_TX_CH);
+    dma_deinit(DMA0, DMA0_USART1_TX_CH);
+    dma_struct_para_init(&dma_cfg);
+    dma_cfg.periph_addr  = (uint32_t)&USART_DATA(USART1);
+    dma_cfg.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_cfg.memory_addr  = (uint32_t)src;
+    dma_cfg.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_cfg.number       = len;
+    dma_cfg.priority     = dma_arbiter_priority(DMA0, DMA0_USART1_TX_CH);
+    dma_cfg.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+    dma_cfg.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+    dma_cfg.direction    = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init(DMA0, DMA0_USART1_TX_CH, &dma_cfg);
+    dma_flag_clear(DMA0, DMA0_USART1_TX_CH, DMA_FLAG_G);
+    dma_channel_enable(DMA0, DMA0_USART1_TX_CH);
+    dma_arbiter_note_start(DMA0, DMA0_USART1_TX_CH, len);
+    g_tx_busy = 1;
+}
+
+/* Folds USART error flags into the counters. Clearing ORERR/FERR/NERR
+   takes a STAT read (the flag_get above) followed by a DATA read. */
+static void poll_errors(void)
+{
+    int clear = 0;
+    if (usart_flag_get(USART1, USART_FLAG_ORERR) != RESET) {
+        g_stats.overruns++;
+        clear = 1;
+    }
+    if (usart_flag_get(USART1, USART_FLAG_FERR) != RESET ||
+        usart_flag_get(USART1, USART_FLAG_NERR) != RESET) {
+        g_stats.frame_errors++;
+        clear = 1;
+    }
+    if (clear) {
+        (void)usart_data_receive(USART1);
+    }
+}
+
+/* Moves newly received bytes into a bounce buffer and echoes them. One
+   call ships at most one burst; backpressure (a burst still in flight)
+   simply leaves the bytes in the ring, where 1024 bytes of slack cover
+   the wait even at the top baud rate. */
+static void echo_pump(void)
+{
+    if (g_tx_busy) {
+        if (dma_flag_get(DMA0, DMA0_USART1_TX_CH, DMA_FLAG_FTF) == RESET) {
+            return;
+        }
+        dma_flag_clear(DMA0, DMA0_USART1_TX_CH, DMA_FLAG_FTF);
+        g_tx_busy = 0;
+    }
+
+    uint32_t write = rx_write_index();
+    uint32_t pending = (write - g_rx_read) & (RX_RING_SIZE - 1U);
+    if (0U == pending) {
+        g_pending_since = 0;
+        return;
+    }
+    if (0U == g_pending_since) {
+        g_pending_since = (uint32_t)read_csr(mcycle);
+    }
+
+    uint32_t len = pending;
+    if (len > TX_BOUNCE_SIZE) {
+        len = TX_BOUNCE_SIZE;
+    }
+    uint8_t *buf = tx_bounce[g_tx_buf];
+    uint32_t first = RX_RING_SIZE - g_rx_read; /* bytes until the wrap */
+    if (first > len) {
+        first = len;
+    }
+    memcpy(buf, &rx_ring[g_rx_read], first);
+    memcpy(buf + first, &rx_ring[0], len - first);
+    g_rx_read = (g_rx_read + len) & (RX_RING_SIZE - 1U);
+    g_tx_buf ^= 1;
+
+    tx_start(buf, len);
+
+    uint32_t turn = (uint32_t)read_csr(mcycle) - g_pending_since;
+    g_pending_since = 0;
+    g_stats.rx_bytes += len;
+    g_stats.tx_bytes += len;
+    g_stats.bursts++;
+    g_stats.turn_sum += turn;
+    if (turn < g_stats.turn_min) g_stats.turn_min = turn;
+    if (turn > g_stats.turn_max) g_stats.turn_max = turn;
+}
+
+static void print_report(uint32_t baud)
+{
+    uint32_t cyc_per_us = SystemCoreClock / 1000000U;
+    uint32_t avg = g_stats.bursts
+        ? (uint32_t)(g_stats.turn_sum / g_stats.bursts) : 0U;
+    printf("%u baud: rx %u tx %u B/s, %u bursts, ovr %u, frame %u",
+           (unsigned)baud, (unsigned)g_stats.rx_bytes,
+           (unsigned)g_stats.tx_bytes, (unsigned)g_stats.bursts,
+           (unsigned)g_stats.overruns, (unsigned)g_stats.frame_errors);
+    if (g_stats.bursts) {
+        printf(", turn %u/%u/%u us",
+               (unsigned)(g_stats.turn_min / cyc_per_us),
+               (unsigned)(avg / cyc_per_us),
+               (unsigned)(g_stats.turn_max / cyc_per_us));
+    }
+    printf("\n");
+}
+
+/* Waits for the echo path to drain before a baud change: TX burst done,
+   then the shift register empty, so no byte straddles the switch. */
+static void drain_tx(void)
+{
+    if (g_tx_busy) {
+        while (dma_flag_get(DMA0, DMA0_USART1_TX_CH, DMA_FLAG_FTF) == RESET);
+        dma_flag_clear(DMA0, DMA0_USART1_TX_CH, DMA_FLAG_FTF);
+        g_tx_busy = 0;
+    }
+    while (usart_flag_get(USART1, USART_FLAG_TC) == RESET);
+}
 
 int main(void)
 {
-    // Uart initialization is called before main loop.
-    // Hence, we can use printf and other UART functions here.
-    printf("Hello, Longan Nano!\n");
-    while (1);
+    printf("uart test: clock %u Hz, console USART0, test port USART1 PA2/PA3\n",
+           (unsigned)SystemCoreClock);
+#if UART_TEST_SWEEP
+    printf("sweep: %u bauds, %u s dwell each\n",
+           (unsigned)BAUD_COUNT, (unsigned)UART_TEST_DWELL_S);
+#else
+    printf("fixed baud %u\n", (unsigned)UART_TEST_BAUD);
+#endif
+
+    uint32_t baud_idx = 0;
+    uint32_t baud = UART_TEST_SWEEP ? g_baud_table[0] : UART_TEST_BAUD;
+    uart1_config(baud);
+    stats_reset();
+
+    const uint64_t ticks_per_second = SystemCoreClock / 4; /* mtime rate */
+    uint64_t window_start = get_timer_value();
+    uint32_t dwell_elapsed = 0;
+
+    while (1) {
+        echo_pump();
+        poll_errors();
+
+        uint64_t now = get_timer_value();
+        if ((now - window_start) < ticks_per_second) {
+            continue;
+        }
+        window_start = now;
+        print_report(baud);
+        stats_reset();
+
+#if UART_TEST_SWEEP
+        if (++dwell_elapsed >= UART_TEST_DWELL_S) {
+            dwell_elapsed = 0;
+            baud_idx = (baud_idx + 1U) % BAUD_COUNT;
+            baud = g_baud_table[baud_idx];
+            drain_tx();
+            printf("-> switching to %u baud\n", (unsigned)baud);
+            uart1_config(baud);
+            stats_reset();
+            window_start = get_timer_value();
+        }
+#else
+        (void)baud_idx;
+#endif
+    }
 }
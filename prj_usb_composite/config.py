@@ -38,6 +38,71 @@ GLOBAL_C_DEFINES = [
     "-D__NUCLEI_N200",
     "-DGD32VF103C_START",
     "-DUSE_SD_CARD_MSC=0",
+    # USB needs CK_USBFS = 48 MHz = CK_SYS / 2, so 96 is the ceiling here
+    # (see lib/system/system_gd32vf103.c for the profiles).
+    "-DSYSTEM_CLOCK_PROFILE=96",
+    # 1 = keep the whole 160x80 frame resident in SRAM and apply host deltas
+    # in place (replaces the four 4 KB slot buffers; they cannot coexist).
+    "-DDISPLAY_FULL_FRAME=0",
+    # Draw-slot ring geometry. Many small rects favour more, smaller slots
+    # (e.g. 8 x 2048); the total must stay inside the .dma_buffers SRAM
+    # budget (lib/system/GD32VF103xB.lds) and the peak-slots counter in
+    # GET_STATS says whether a workload actually fills the ring.
+    "-DDISPLAY_NUM_BUFFERS=4",
+    "-DDISPLAY_BUFFER_SIZE=4096",
+    # 1 = enable the USB transport benchmark (CMD_BENCH echo/sink/source on
+    # the display bulk endpoints; see `display_manager.py benchmark`).
+    "-DUSB_BENCH_MODE=0",
+    # 1 = poll the standard HID (mouse/keyboard/consumer) endpoint every
+    # frame (bInterval=1) instead of every 10 ms, bounding input-to-host
+    # latency at 1 ms when scrubbing the encoder. The SOF handler already
+    # coalesces to at most one report per frame, and an interrupt endpoint
+    # with nothing queued just NAKs its poll, so idle bus cost is nil.
+    "-DHID_LOW_LATENCY=0",
+    # 1 = a sustained counter anomaly (see src/health.h) stops feeding the
+    # free watchdog, so the unit resets itself instead of limping until a
+    # manual power cycle. 0 = the health monitor only logs.
+    "-DHEALTH_WDG_RESET=0",
+    # 1 = store cold, run-once code (the SD init sequence) compressed in
+    # flash and inflate it into a shared SRAM region on demand, freeing
+    # flash for the hot paths. See lib/overlay/overlay.h and OVERLAYS below.
+    "-DUSE_CODE_OVERLAYS=1",
+    # 1 = battery deployment: enter DEEP_SLEEP (SRAM retained) on USB bus
+    # suspend and restore the PLL + USB clocks from the wakeup interrupt
+    # fast enough that the host resumes instead of re-enumerating. Mains
+    # builds keep 0 so suspend never freezes the debug UART mid-session.
+    # Incompatible with HEALTH_WDG_RESET=1 (the watchdog ticks through
+    # deep sleep; usb_conf.h rejects the combination).
+    "-DUSB_DEEP_SLEEP=0",
+    # 1 = the expansion-header sensor board is fitted: bring up the
+    # interrupt-driven I2C master (lib/i2c, PB6/PB7) and poll the external
+    # temperature sensor from the telemetry heartbeat. 0 = bus untouched.
+    "-DI2C_SENSORS=0",
+    # 1 = sample worst-case interrupt hold-off with TIMER6 at the bottom of
+    # the ECLIC map and report a latency histogram on the debug UART (see
+    # src/isr_audit.h). Audit builds only; off in the shipping image.
+    "-DISR_AUDIT=0",
+    # 1 = run the lib/bench micro-benchmark table once at boot and dump the
+    # results on the debug UART (characterization builds; the `bench`
+    # console command runs the same table on demand).
+    "-DBENCH_AUTORUN=0",
+    # Panel revision timing profile for the LCD init sequence (lib/gd32v_lcd):
+    # 0 = original rev A module, ST7735S datasheet minimums; 1 = rev B batch,
+    # faster settle times measured on the bench. Build-time because the panel
+    # has no readback path to probe at runtime (SDA is wired to MOSI only).
+    "-DLCD_PANEL_PROFILE=0",
+    # USB interface composition (see usbd_conf.h). USB_STD_HID=0 drops the
+    # mouse/keyboard/consumer interface; USB_MSC=0 drops mass storage and
+    # returns its 48-word TX FIFO to the shared RX FIFO (usb_conf.h), so a
+    # display-only image also gets deeper bulk OUT buffering. Interface
+    # numbers compact automatically; the display interface is always in.
+    "-DUSB_STD_HID=1",
+    "-DUSB_MSC=1",
+    # Rotary bursts leave as one relative-delta record (REPORT_ENCODER,
+    # signed net detent count) instead of a consumer-key press/release
+    # pair per detent. 0 restores the volume-key synthesis for use as a
+    # plain media knob without the display tools running.
+    "-DENCODER_HID_DELTA=1",
 ]
 
 # --- CPU & ABI Flags ---
@@ -51,6 +116,31 @@ CPU_FLAGS = [
 # Path to the linker script specific to this MCU's memory layout.
 LINKER_SCRIPT = r"lib/system/GD32VF103xB.lds"
 
+# --- Generated Fonts ---
+# Compiled from TTF into packed 1-bpp C arrays by bldmgr/fontgen.py and
+# linked into flash; headers land in build/<prj>/generated. Used by the
+# on-device text drawing path. RLE only pays above ~20 px, so the UI
+# font stays raw.
+GENERATED_FONTS = [
+    {"name": "ubuntu_16", "ttf": r"tools/display_manager/fonts/Ubuntu-L.ttf", "size": 16},
+]
+
+# --- Code Overlays ---
+# Overlay names, in ovl::load() index order. Each becomes a .ovl.<name>
+# linker section sharing one RAM address (fragment written into the build
+# directory) and a compressed blob in the store bldmgr/ovlpack.py packs
+# into the .bin after the link.
+OVERLAYS = ["sd_init"]
+
+# --- Generated Protocol ---
+# One declarative description of the host<->device display protocol
+# (command ids, report ids, flag bits, shared sizes), rendered by
+# bldmgr/protogen.py into the firmware's display_protocol.h (in
+# build/<prj>/generated) and the host tools' display_protocol.py. Edit
+# protocol.py, never the outputs.
+PROTOCOL_DEF = r"prj_usb_composite/protocol.py"
+PROTOCOL_HOST_OUT = r"tools/display_manager/display_protocol.py"
+
 # ==============================================================================
 # Project Components
 # ==============================================================================
@@ -64,7 +154,7 @@ for component_name in ['riscv_drivers', 'syscall_stubs', 'gd32_std_peripheral_li
     gd32_components[component_name]['module'] = "gd32"
 
 lib_components = {}
-for component_name in ['sdcard', 'system', 'debug_uart0', 'gd32_lcd']:
+for component_name in ['sdcard', 'system', 'debug_uart0', 'dma', 'gd32_lcd', 'lcd_font', 'lcd_text', 'tinyfmt', 'overlay', 'alloc', 'coro', 'i2c', 'shell', 'bench', 'cfgstore']:
     lib_components[component_name] = lib[component_name].copy()
     lib_components[component_name]['module'] = 'lib'
 
@@ -75,20 +165,59 @@ COMPONENTS = {
         "c_sources": [],
         "cpp_sources": [r"src/usb_composite/gd32vf103_it.cpp",
                         r"src/usb_composite/usb_device.cpp",
-                        r"src/usb_composite/usbd_descriptors.cpp",],
+                        r"src/usb_composite/usbd_descriptors.cpp",
+                        r"src/usb_composite/vendor_ctl.cpp",],
         "asm_sources": [],
         "include_paths": [r"-Isrc/usb_composite"],
         "enabled": True,
     },
     "application": {
         "c_sources": [r"src/gd32vf103_hw.c",],
-        "cpp_sources": [r"src/main.cpp", r"src/board.cpp", r"src/rotary_encoder.cpp", r"src/display_manager.cpp"],
+        "cpp_sources": [r"src/main.cpp", r"src/board.cpp", r"src/rotary_encoder.cpp", r"src/display_manager.cpp",
+                        r"src/asset_store.cpp", r"src/events.cpp", r"src/input_events.cpp",
+                        r"src/health.cpp", r"src/isr_audit.cpp", r"src/telemetry.cpp",
+                        r"src/console.cpp", r"src/usbd_msc_mem.cpp",
+                        r"src/ramdisk.cpp", r"src/benchmarks.cpp",
+                        r"src/fwup.cpp", r"src/perflog.cpp"],
         "asm_sources": [],
         "include_paths": [r"-Isrc"],
         "enabled": True
     },
 }
 
+# ==============================================================================
+# Host Benchmarks
+# ==============================================================================
+# Pure-logic modules compiled natively against the stubs in
+# tools/hostbench/stubs and run with 'python bldmgr/build.py
+# prj_usb_composite bench'. Paths are relative to the repository root.
+HOST_BENCH = {
+    "sources": [
+        r"prj_usb_composite/src/display_manager.cpp",
+        r"prj_usb_composite/hostbench/bench_display.cpp",
+        r"tools/hostbench/stubs/lcd_stub.cpp",
+        r"tools/hostbench/stubs/asset_store_stub.cpp",
+        r"tools/hostbench/stubs/fwup_stub.cpp",
+        r"lib/lcd_font/src/lcd_font.c",
+        r"lib/lcd_text/src/lcd_text.c",
+    ],
+    "include_paths": [
+        r"-Itools/hostbench/stubs",  # must come first: shadows the device CSR header
+        r"-Itools/hostbench",
+        r"-Iprj_usb_composite/src",
+        r"-Ilib/gd32v_lcd/include",
+        r"-Ilib/lcd_font/include",
+        r"-Ilib/lcd_text/include",
+        r"-Ilib/ring",
+        r"-Ilib/system",
+    ],
+    "defines": [
+        r"-DGD32VF103",
+        r"-DDISPLAY_FULL_FRAME=0",
+        r"-DEVT_ENABLE=0",  # the trace ring uses RV32 AMO asm; compile it out
+    ],
+}
+
 # ==============================================================================
 # Expose Tool Config to Build Logic
 # ==============================================================================
@@ -101,6 +230,8 @@ NUCLEUS_OPENOCD_PATH = config.NUCLEUS_OPENOCD_PATH
 OPENOCD_PATH = config.OPENOCD_PATH
 DFU_UTIL_PATH = config.DFU_UTIL_PATH
 OPTIMIZATION = config.OPTIMIZATION
+BUILD_PROFILES = config.BUILD_PROFILES
+LTO_FLAGS = config.LTO_FLAGS
 C_STANDARD = config.C_STANDARD
 CPP_STANDARD = config.CPP_STANDARD
 COMMON_WARNING_FLAGS = config.COMMON_WARNING_FLAGS
@@ -0,0 +1,332 @@
+/*!
+    \file    bench_display.cpp
+    \brief   Host benchmarks for the display pipeline and ring buffer
+
+    Exercises DisplayManager::handleUsbPacket() with the same packet
+    shapes display_manager.py emits - raw streams, RLE runs, palettized
+    streams, fills - plus the spsc_ring used by the streaming paths.
+    Built for the host via 'python bldmgr/build.py prj_usb_composite
+    bench' against the stubs in tools/hostbench/stubs; the LCD stub
+    retires each blit synchronously so the slot pipeline never stalls.
+
+    Host numbers track regressions between commits; they say nothing
+    absolute about the RV32 core.
+*/
+
+#include "bench.h"
+#include "display_manager.h"
+#include "events.h"
+#include "lcd_stub.h"
+#include "spsc_ring.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// The firmware's events.cpp toggles MIE around the pending mask, so the
+// host build carries this trivial single-threaded replacement instead.
+namespace events {
+static uint32_t g_pending = 0;
+void post(uint32_t mask) { g_pending |= mask; }
+uint32_t take() { uint32_t taken = g_pending; g_pending = 0; return taken; }
+void wait() {}
+} // namespace events
+
+using display::DisplayManager;
+using display::HostCommand;
+
+namespace {
+
+uint16_t g_sequence = 0;
+
+// [CMD, x, y, w, h, seq_lsb, seq_msb, encoding]
+void send_draw_rect(DisplayManager& dm, uint8_t w, uint8_t h, uint8_t encoding)
+{
+    uint8_t packet[8] = {static_cast<uint8_t>(HostCommand::DRAW_RECT),
+                         0, 0, w, h,
+                         static_cast<uint8_t>(g_sequence & 0xFF),
+                         static_cast<uint8_t>(g_sequence >> 8),
+                         encoding};
+    g_sequence++;
+    dm.handleUsbPacket(packet, sizeof packet);
+}
+
+} // namespace
+
+// Full-size raw stream: one DRAW_RECT header, then headerless 64-byte
+// pixel packets straight into the slot, drained after each rect. This is
+// the bulk of the USB OUT traffic in normal operation.
+static void bm_raw_stream_40x40(bench::State& state)
+{
+    DisplayManager& dm = DisplayManager::getInstance();
+    uint8_t payload[64];
+    std::memset(payload, 0x5A, sizeof payload);
+
+    while (state.KeepRunning()) {
+        send_draw_rect(dm, 40, 40, 0);
+        for (int n = 0; n < 50; n++) { // 40*40*2 = 3200 bytes = 50 packets
+            dm.handleUsbPacket(payload, sizeof payload);
+        }
+        dm.processDrawTasks();
+    }
+    state.SetBytesProcessed(state.iterations() * (40 * 40 * 2));
+}
+
+// RLE stream: 3-byte [count, lsb, msb] runs, 21 runs per 64-byte packet.
+static void bm_rle_stream_40x40(bench::State& state)
+{
+    DisplayManager& dm = DisplayManager::getInstance();
+    uint8_t packet[64];
+    packet[0] = static_cast<uint8_t>(HostCommand::IMAGE_DATA_RLE);
+    for (int run = 0; run < 21; run++) {
+        packet[1 + run * 3] = 100; // 100 pixels
+        packet[2 + run * 3] = 0x34;
+        packet[3 + run * 3] = 0x12;
+    }
+
+    while (state.KeepRunning()) {
+        send_draw_rect(dm, 40, 40, 1);
+        dm.handleUsbPacket(packet, sizeof packet); // 2100 px >= 1600 needed
+        dm.processDrawTasks();
+    }
+    state.SetBytesProcessed(state.iterations() * (40 * 40 * 2));
+}
+
+// Palettized stream: one index byte per pixel, expanded through the
+// 256-entry palette while copying into the slot.
+static void bm_palette_stream_40x40(bench::State& state)
+{
+    DisplayManager& dm = DisplayManager::getInstance();
+
+    uint8_t palette[3 + 2 * 16];
+    palette[0] = static_cast<uint8_t>(HostCommand::SET_PALETTE);
+    palette[1] = 0;
+    palette[2] = 16;
+    for (int i = 0; i < 16; i++) {
+        palette[3 + i * 2] = static_cast<uint8_t>(i * 16);
+        palette[4 + i * 2] = static_cast<uint8_t>(i);
+    }
+    dm.handleUsbPacket(palette, sizeof palette);
+
+    uint8_t packet[64];
+    packet[0] = static_cast<uint8_t>(HostCommand::IMAGE_DATA_IDX);
+    for (int i = 1; i < 64; i++) {
+        packet[i] = static_cast<uint8_t>(i & 0x0F);
+    }
+
+    while (state.KeepRunning()) {
+        send_draw_rect(dm, 40, 40, 1); // header stream, not raw zero-copy
+        for (int n = 0; n < 26; n++) { // 26 * 63 indices >= 1600 pixels
+            dm.handleUsbPacket(packet, sizeof packet);
+        }
+        dm.processDrawTasks();
+    }
+    state.SetBytesProcessed(state.iterations() * (40 * 40 * 2));
+}
+
+// Solid fill: metadata only, the stub "DMA" does the pixels.
+static void bm_fill_rect(bench::State& state)
+{
+    DisplayManager& dm = DisplayManager::getInstance();
+
+    while (state.KeepRunning()) {
+        uint8_t packet[9] = {static_cast<uint8_t>(HostCommand::FILL_RECT),
+                             0, 0, 160, 80,
+                             static_cast<uint8_t>(g_sequence & 0xFF),
+                             static_cast<uint8_t>(g_sequence >> 8),
+                             0x00, 0xF8};
+        g_sequence++;
+        dm.handleUsbPacket(packet, sizeof packet);
+        dm.processDrawTasks();
+    }
+    state.SetBytesProcessed(state.iterations() * (160 * 80 * 2));
+}
+
+// The ISR-to-main-loop ring the streaming paths are built on.
+static void bm_spsc_ring(bench::State& state)
+{
+    static spsc_ring<uint32_t, 64> ring;
+    uint32_t value = 0;
+
+    while (state.KeepRunning()) {
+        for (uint32_t i = 0; i < 32; i++) {
+            ring.push(i);
+        }
+        while (ring.pop(value)) {
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * 32 * sizeof(uint32_t));
+}
+
+// ---------------------------------------------------------------------
+// Corpus replay: the synthetic cases above measure each decoder on ideal
+// input; real dashboards mix short RLE runs, palette misses and tiny
+// rects. Set config.CAPTURE_CORPUS_PATH in display_manager.py to record
+// a session's wire bursts ([u32 LE length][burst] records), then run
+// 'HOSTBENCH_CORPUS=<file> build/hostbench/bench corpus' to replay them
+// through the real decode paths, bucketed per encoding. Cases whose
+// bucket is empty (e.g. delta on a DISPLAY_FULL_FRAME=0 capture) report
+// zero work. Capture with a single panel; interleaved devices would
+// shuffle payload packets between transactions.
+namespace corpus {
+
+enum Class { RAW = 0, RLE, INDEXED, DELTA, FILL, CLASS_COUNT };
+
+// One rect transaction: the packets [first, first+count), with the
+// sequence-carrying header at index 'header' so each replay pass can
+// renumber it and sidestep the firmware's NACK-on-gap logic.
+struct Txn {
+    size_t first;
+    size_t count;
+    size_t header;
+    uint32_t pixels;
+};
+
+std::vector<std::vector<uint8_t>> g_packets;
+std::vector<Txn> g_txns[CLASS_COUNT];
+
+bool load()
+{
+    static int state = -1; // -1 not tried, 0 unavailable, 1 loaded
+    if (state >= 0) return state == 1;
+    state = 0;
+
+    const char* path = std::getenv("HOSTBENCH_CORPUS");
+    if (!path) return false;
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "corpus: cannot open %s\n", path);
+        return false;
+    }
+
+    uint8_t lenb[4];
+    std::vector<uint8_t> burst;
+    while (std::fread(lenb, 1, sizeof lenb, f) == sizeof lenb) {
+        uint32_t len = static_cast<uint32_t>(lenb[0]) | (lenb[1] << 8) |
+                       (lenb[2] << 16) | (uint32_t(lenb[3]) << 24);
+        burst.resize(len);
+        if (len && std::fread(burst.data(), 1, len, f) != len) break;
+        for (uint32_t off = 0; off < len; off += 64) {
+            uint32_t n = (len - off < 64) ? len - off : 64;
+            g_packets.emplace_back(burst.begin() + off,
+                                   burst.begin() + off + n);
+        }
+    }
+    std::fclose(f);
+
+    // Group packets into transactions. The capturing host is caps-aware
+    // and runs single-header streams, so every encoded rect announces
+    // its payload length in the header and the payload packets are
+    // headerless - that announced length is what stops a pixel packet
+    // starting with 0x06 from being misread as a new header.
+    size_t i = 0;
+    size_t prefix = SIZE_MAX; // first unclaimed control packet, if any
+    while (i < g_packets.size()) {
+        const std::vector<uint8_t>& p = g_packets[i];
+        uint8_t cmd = p.empty() ? 0 : p[0];
+
+        if (cmd == static_cast<uint8_t>(HostCommand::DRAW_RECT) &&
+            p.size() >= 10) {
+            Txn t;
+            t.first = (prefix != SIZE_MAX) ? prefix : i;
+            t.header = i;
+            prefix = SIZE_MAX;
+            t.pixels = uint32_t(p[3]) * p[4];
+            uint8_t encoding = p[7];
+            uint32_t payload = (encoding == 0)
+                ? t.pixels * 2
+                : uint32_t(p[8]) | (uint32_t(p[9]) << 8);
+            size_t pkts = (payload + 63) / 64;
+            t.count = (i - t.first) + 1 + pkts;
+            if (t.first + t.count > g_packets.size()) break; // truncated
+            Class cls = (encoding <= 3) ? static_cast<Class>(encoding) : RAW;
+            g_txns[cls].push_back(t);
+            i += 1 + pkts;
+        } else if (cmd == static_cast<uint8_t>(HostCommand::FILL_RECT) ||
+                   cmd == static_cast<uint8_t>(HostCommand::MULTI_FILL)) {
+            Txn t;
+            t.first = (prefix != SIZE_MAX) ? prefix : i;
+            t.header = i;
+            prefix = SIZE_MAX;
+            if (cmd == static_cast<uint8_t>(HostCommand::FILL_RECT)) {
+                t.pixels = uint32_t(p[3]) * p[4];
+            } else {
+                t.pixels = 0;
+                for (uint8_t r = 0; r < p[1]; r++) { // 6-byte records at [4]
+                    size_t rec = 4 + size_t(r) * 6;
+                    if (rec + 4 > p.size()) break;
+                    t.pixels += uint32_t(p[rec + 2]) * p[rec + 3];
+                }
+            }
+            t.count = (i - t.first) + 1;
+            g_txns[FILL].push_back(t);
+            i++;
+        } else {
+            // SET_PALETTE, DRAW_TEXT, markers: replay them ahead of the
+            // rect they preceded so palette state matches the capture.
+            if (prefix == SIZE_MAX) prefix = i;
+            i++;
+        }
+    }
+
+    state = g_packets.empty() ? 0 : 1;
+    return state == 1;
+}
+
+void replay(bench::State& state, Class cls)
+{
+    if (!load() || g_txns[cls].empty()) return;
+
+    DisplayManager& dm = DisplayManager::getInstance();
+    int64_t bytes = 0;
+    for (const Txn& t : g_txns[cls]) {
+        bytes += int64_t(t.pixels) * 2;
+    }
+
+    uint8_t scratch[64];
+    while (state.KeepRunning()) {
+        for (const Txn& t : g_txns[cls]) {
+            for (size_t k = 0; k < t.count; k++) {
+                const std::vector<uint8_t>& p = g_packets[t.first + k];
+                std::memcpy(scratch, p.data(), p.size());
+                if (t.first + k == t.header) {
+                    uint8_t cmd = scratch[0];
+                    size_t seq_at =
+                        (cmd == static_cast<uint8_t>(HostCommand::MULTI_FILL))
+                            ? 2 : 5;
+                    scratch[seq_at] = static_cast<uint8_t>(g_sequence & 0xFF);
+                    scratch[seq_at + 1] = static_cast<uint8_t>(g_sequence >> 8);
+                    g_sequence += (cmd ==
+                        static_cast<uint8_t>(HostCommand::MULTI_FILL))
+                            ? scratch[1] : 1;
+                }
+                dm.handleUsbPacket(scratch,
+                                   static_cast<uint32_t>(p.size()));
+            }
+            dm.processDrawTasks();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+} // namespace corpus
+
+// One case per encoding so the MB/s column reads as decoded pixel
+// throughput per decoder on the captured workload.
+static void bm_corpus_raw(bench::State& state)     { corpus::replay(state, corpus::RAW); }
+static void bm_corpus_rle(bench::State& state)     { corpus::replay(state, corpus::RLE); }
+static void bm_corpus_indexed(bench::State& state) { corpus::replay(state, corpus::INDEXED); }
+static void bm_corpus_delta(bench::State& state)   { corpus::replay(state, corpus::DELTA); }
+static void bm_corpus_fill(bench::State& state)    { corpus::replay(state, corpus::FILL); }
+
+BENCHMARK(bm_raw_stream_40x40);
+BENCHMARK(bm_rle_stream_40x40);
+BENCHMARK(bm_palette_stream_40x40);
+BENCHMARK(bm_fill_rect);
+BENCHMARK(bm_spsc_ring);
+BENCHMARK(bm_corpus_raw);
+BENCHMARK(bm_corpus_rle);
+BENCHMARK(bm_corpus_indexed);
+BENCHMARK(bm_corpus_delta);
+BENCHMARK(bm_corpus_fill);
+
+BENCHMARK_MAIN();
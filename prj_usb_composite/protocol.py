@@ -0,0 +1,352 @@
+# Single source of truth for the host <-> device display protocol.
+#
+# bldmgr/protogen.py compiles this description into both sides' constant
+# definitions:
+#
+#   build/<prj>/generated/display_protocol.h   (firmware, C++)
+#   tools/display_manager/display_protocol.py  (host tools)
+#
+# Every id, flag bit and shared size lives here exactly once; the two
+# outputs are regenerated by the build whenever this file changes. Edit
+# this file, never the outputs. Doc strings attached to entries are
+# emitted as comments into both outputs, so the wire-layout notes stay
+# next to the ids on whichever side you are reading.
+#
+# Entries are (NAME, value) or (NAME, value, doc) where doc is a list of
+# comment lines. Names are the shared ALL_CAPS spelling; the generator
+# derives each side's surface from them (enum class HostCommand on the
+# firmware side, CMD_*/REPORT_* module constants on the host side).
+
+# Bumped when the GET_CAPS reply layout itself changes; feature presence
+# within a version is negotiated through the flag bits below.
+CAPS_VERSION = 1
+
+# Shared wire geometry. REPORT_LENGTH is the bulk/HID packet size every
+# command header is padded to; the panel dimensions are the defaults the
+# GET_CAPS handshake confirms (or corrects) at connect time.
+WIRE = [
+    ("REPORT_LENGTH", 64),
+    ("LCD_WIDTH", 160),
+    ("LCD_HEIGHT", 80),
+    ("OVERLAY_MAX_W", 16, [
+        "Largest cursor/overlay bitmap the device stages (CAPS_OVERLAY).",
+    ]),
+    ("OVERLAY_MAX_H", 16),
+]
+
+# Host -> device commands (first byte of a bulk OUT packet).
+COMMANDS = [
+    ("IMAGE_DATA", 0x02),
+    ("IMAGE_DATA_RLE", 0x03),
+    ("DRAW_RECT", 0x06, [
+        "[CMD, x, y, w, h, seq_lsb, seq_msb, encoding, (len_lsb, len_msb),",
+        "(flags), (crc32 LE)]; optional fields are negotiated via GET_CAPS",
+        "flag bits. Payload follows in REPORT_LENGTH packets.",
+    ]),
+    ("FILL_RECT", 0x07),
+    ("DRAW_TEXT", 0x08),
+    ("GET_STATS", 0x09, [
+        "Answered with a REPORT_STATS IN report of u32 LE pipeline counters.",
+    ]),
+    ("SET_PALETTE", 0x0A, [
+        "Loads the 256-entry RGB565 palette ENC_INDEXED streams index into.",
+    ]),
+    ("IMAGE_DATA_IDX", 0x0B),
+    ("GET_TRACE", 0x0C, [
+        "Binary trace-ring readout (tools/decode_trace.py). USB_BENCH_MODE=1",
+        "builds repurpose this id as CMD_BENCH; the two never coexist.",
+    ]),
+    ("MULTI_FILL", 0x0D, [
+        "[CMD, count, seq_lsb, seq_msb] plus count 6-byte rect records.",
+    ]),
+    ("LATENCY_PROBE", 0x0E),
+    ("GET_CRASH", 0x0F),
+    ("GET_CAPS", 0x10, [
+        "Capability handshake; answered with a REPORT_CAPS IN report.",
+    ]),
+    ("SET_SCROLL", 0x11, [
+        "Hardware scroll (ST7735S scroll registers): [CMD, x, w, offset,",
+        "seq_lsb, seq_msb] shifts the displayed window without touching",
+        "frame memory.",
+    ]),
+    ("GET_ASSETS", 0x12, [
+        "Flash asset store directory/progress; answered with REPORT_ASSETS.",
+    ]),
+    ("ASSET_BEGIN", 0x13, [
+        "[CMD, flags(bit0=wipe), id, ver_lsb, ver_msb, w, h]",
+    ]),
+    ("ASSET_DATA", 0x14, [
+        "[CMD, count, payload...]",
+    ]),
+    ("DRAW_ASSET", 0x15, [
+        "[CMD, id, x, y, seq_lsb, seq_msb]",
+    ]),
+    ("IDLE_HINT", 0x16, [
+        "[CMD, idle]: parks/unparks the device pipeline between updates.",
+    ]),
+    ("LIST_BEGIN", 0x17, [
+        "Display lists (CAPS_DISPLAY_LISTS): slot-consuming commands until",
+        "LIST_COMMIT are held on the device and released as one atomic batch.",
+    ]),
+    ("LIST_COMMIT", 0x18),
+    ("GET_BOOT", 0x19, [
+        "Boot-stage mcycle timestamps; answered with a REPORT_BOOT IN report.",
+    ]),
+    ("OVERLAY_SET", 0x1A, [
+        "[CMD, w, h, key_lsb, key_msb] followed by w*h RGB565 pixels in",
+        "headerless REPORT_LENGTH packets (CAPS_OVERLAY builds). Pixels",
+        "equal to the key color are transparent; w = 0 drops the plane.",
+    ]),
+    ("OVERLAY_POS", 0x1B, [
+        "[CMD, x, y, visible, seq_lsb, seq_msb]: moves/hides the overlay",
+        "plane; the device restores the pixels underneath itself.",
+    ]),
+    ("CONSOLE", 0x1C, [
+        "[CMD, count, count text bytes]: keystrokes for the runtime",
+        "tuning console (lib/shell); output returns as REPORT_CONSOLE",
+        "packets. See tools/display_manager/console.py.",
+    ]),
+    ("GET_FWINFO", 0x1D, [
+        "Firmware image identity and delta-update progress; answered",
+        "with a REPORT_FW_INFO IN report. The image CRC it carries is",
+        "what a delta patch declares as its base.",
+    ]),
+    ("FW_BEGIN", 0x1E, [
+        "[CMD, base_crc (u32 LE), target_crc (u32 LE)]: opens a delta",
+        "update (tools/display_manager/fw_update.py). Refused (state",
+        "FW_STATE_BASE_MISMATCH) unless base_crc matches the running",
+        "image, so a diff can never land on the wrong version.",
+    ]),
+    ("FW_DATA", 0x1F, [
+        "[CMD, count, payload...]: delta-stream bytes, a concatenation",
+        "of [offset u32 LE, len u16 LE, len bytes] records sorted by",
+        "offset. Offsets are from the flash base; only touched pages",
+        "are erased and reprogrammed.",
+    ]),
+    ("FW_APPLY", 0x20, [
+        "Flushes the last patched page and verifies the whole image",
+        "against target_crc; the result lands in GET_FWINFO's state.",
+    ]),
+    ("GET_BUILD", 0x21, [
+        "Build identity embedded at compile time (generated buildinfo.h);",
+        "answered with a REPORT_BUILD IN report.",
+    ]),
+    ("ANIM_PLAY", 0x22, [
+        "[CMD, first_id, count, x, y, period_lsb, period_msb, seq_lsb,",
+        "seq_msb]: cycle the stored assets first_id..first_id+count-1 at",
+        "the given period (ms, floor 16) from (x, y), on-device, until a",
+        "count of 0 stops playback. Frames must share one geometry and",
+        "all exist (uploaded via ASSET_BEGIN/ASSET_DATA); a wiped store",
+        "ends playback on its own. A spinner thus costs zero bus after",
+        "its one-time upload instead of a continuous frame stream.",
+    ]),
+    ("VERIFY_MODE", 0x23, [
+        "[CMD, enable]: golden-image verification for regression rigs.",
+        "While enabled, every pixel-carrying rect is checksummed on the",
+        "hardware CRC unit over its decoded region once decode completes",
+        "(the integrity trailer covers the encoded wire bytes; this",
+        "covers what the decoder actually produced) and echoed as a",
+        "REPORT_RECT_CRC record, so a throughput run doubles as a",
+        "correctness test. Fills and asset blits have no decode step",
+        "and are skipped. Costs CRC time per rect; off outside rigs.",
+    ]),
+]
+
+# Device -> host status reports (first byte of a bulk IN packet).
+REPORTS = [
+    ("BUTTON_EVENT", 0x01),
+    ("SEQ_NACK", 0x02, [
+        "[0x02, first_lsb, first_msb, last_lsb, last_msb]: resend range.",
+    ]),
+    ("STATS", 0x03, [
+        "u32 LE pipeline counters in PipelineStats order.",
+    ]),
+    ("RECT_LATENCY", 0x05, [
+        "[0x05, seq_lsb, seq_msb, cycles (u32 LE)], sent when the rect's",
+        "blit reaches the panel (see latency_probe.py).",
+    ]),
+    ("CAPS", 0x07, [
+        "[0x07, version, width, height, num_buffers, buffer_size (u16 LE),",
+        "full_frame_bytes (u32 LE), flags, pixel_format]. Flag bits are the",
+        "CAPS_* masks; pixel_format names the device's native wire format.",
+    ]),
+    ("CREDITS", 0x08, [
+        "[0x08, free_slots, total_slots], sent whenever draw-slot occupancy",
+        "changes; the host stops slot-consuming commands at zero credits.",
+    ]),
+    ("ASSETS", 0x09, [
+        "[0x09, state, bytes_received (u32 LE), count, count * (id, ver_lsb,",
+        "ver_msb)]. state is one of the ASSET_STATE_* values.",
+    ]),
+    ("BOOT", 0x0A, [
+        "[0x0A, count, count * u32 LE], absolute mcycle offsets from reset.",
+    ]),
+    ("STATUS", 0x0B, [
+        "SOF-paced status push (CAPS_STATUS_PUSH): [0x0B, free_slots,",
+        "total_slots, health_tripped, rects_drawn (u16 LE), slots_dropped",
+        "(u16 LE), draw_cycles_last (u32 LE), supply_mv (u16 LE),",
+        "die_temp (i16 LE, tenths of a degC)], sent every few frames while",
+        "the pipeline is unparked, so flow control and latency tracking",
+        "ride on fresh device state instead of polling round trips. The",
+        "telemetry tail comes from the free-running ADC scan (src/telemetry.h)",
+        "and is zero until the first heartbeat fold after boot.",
+    ]),
+    ("CONSOLE", 0x0C, [
+        "[0x0C, count, count text bytes]: console output, drained from",
+        "the shell's TX ring at IN-report pace.",
+    ]),
+    ("FW_INFO", 0x0D, [
+        "[0x0D, state, pages_written (u16 LE), bytes_received (u32 LE),",
+        "image_crc (u32 LE), image_len (u32 LE)]. state is one of the",
+        "FW_STATE_* values; image_crc is zlib CRC32 over the whole code",
+        "flash region. The host paces FW_DATA against bytes_received,",
+        "exactly as asset uploads pace against REPORT_ASSETS.",
+    ]),
+    ("BUILD", 0x0E, [
+        "[0x0E, fingerprint (u32 LE), count, count text bytes], where the",
+        "text is \"<git revision> <profile>\" from the generated",
+        "buildinfo.h. The fingerprint is a CRC32 over the build",
+        "configuration (profile, feature defines, component set), so host",
+        "tools can match stored benchmark results to the configuration",
+        "that produced them without parsing the text.",
+    ]),
+    ("ENCODER", 0x0F, [
+        "[0x0F, delta (i8)]: net rotary detents since the previous report,",
+        "positive clockwise. The firmware's input drain coalesces a fast",
+        "spin into one report (ENCODER_HID_DELTA builds) instead of a",
+        "consumer-key press/release pair per detent.",
+    ]),
+    ("RECT_CRC", 0x10, [
+        "[0x10, seq_lsb, seq_msb, crc32 (u32 LE)], sent per completed",
+        "pixel-carrying rect while VERIFY_MODE is armed. The CRC is the",
+        "hardware-unit variant (see framecodec.crc32) over the decoded",
+        "region pixels, little-endian RGB565 in row-major order, so the",
+        "host compares it against the pre-encoding payload it sent.",
+    ]),
+]
+
+# GET_CAPS reply flag bits (masks, not bit indices).
+CAPS_FLAGS = [
+    ("SINGLE_HEADER", 0, [
+        "DRAW_RECT may announce the encoded length; payload packets then",
+        "go headerless.",
+    ]),
+    ("FULL_FRAME", 1, [
+        "Whole-frame-resident build; a rect may span the frame.",
+    ]),
+    ("DELTA", 2, [
+        "ENC_DELTA streams are patched against the resident frame.",
+    ]),
+    ("DISPLAY_LISTS", 3, [
+        "LIST_BEGIN/LIST_COMMIT batch commits.",
+    ]),
+    ("INTEGRITY_CRC", 4, [
+        "DRAW_RECT CRC32 trailer, verified on the hardware CRC unit;",
+        "mismatches join the NACK path.",
+    ]),
+    ("PIXEL_DOUBLE", 5, [
+        "Pixel-doubled rects (RECT_FLAG_SCALE2X): quarter-resolution",
+        "payload expands 2x2 on reception.",
+    ]),
+    ("STATUS_PUSH", 6, [
+        "Unsolicited REPORT_STATUS records, SOF-paced; the host may stop",
+        "polling GET_STATS for flow-control purposes.",
+    ]),
+    ("OVERLAY", 7, [
+        "Device-composited cursor plane (OVERLAY_SET/OVERLAY_POS). Needs",
+        "the resident frame to restore occluded pixels, so it travels",
+        "with the FULL_FRAME bit.",
+    ]),
+]
+
+# DRAW_RECT header flag byte bits (masks). Note "CRC" alone would collide
+# with the peripheral-library CRC register macro on the firmware side.
+RECT_FLAGS = [
+    ("CRC_TRAILER", 0, ["CRC32 trailer present after the (optional) length field."]),
+    ("SCALE2X", 1, ["Payload is half-size in both axes; expand 2x2."]),
+]
+
+# DRAW_RECT payload encodings. Raw streams are sent headerless so the
+# firmware can receive them directly into a framebuffer slot; RLE keeps
+# a per-packet command byte.
+ENCODINGS = [
+    ("RAW", 0x00),
+    ("RLE", 0x01),
+    ("INDEXED", 0x02),
+    ("DELTA", 0x03, [
+        "[skip, copy] pixel-count span headers against the resident frame,",
+        "each followed by the copy pixels (whole-frame builds only).",
+    ]),
+]
+
+# Native wire pixel formats announced in the CAPS reply. New panels get
+# the next id rather than a changed meaning for an existing one.
+PIXEL_FORMATS = [
+    ("RGB565", 0, ["RGB565, little-endian on the wire."]),
+]
+NATIVE_PIXEL_FORMAT = "RGB565"
+
+# On-device font atlases selectable in the DRAW_TEXT packet.
+FONTS = [
+    ("8X16", 0x00),
+    ("16X24", 0x01),
+    ("UBUNTU_16", 0x02, ["Proportional; baked by fontgen.py (GENERATED_FONTS)."]),
+]
+
+# Flash asset store agreement (see prj_usb_composite/src/asset_store.h).
+ASSET_STATES = [
+    ("IDLE", 0),
+    ("ERASING", 1),
+    ("WRITING", 2),
+    ("ERROR", 3),
+]
+ASSETS = [
+    ("ASSET_ID_BACKGROUND", 1, [
+        "Well-known id for the theme's gradient background, the largest",
+        "re-streamed payload without the store.",
+    ]),
+    ("ASSET_STAGING_BYTES", 512, [
+        "Firmware-side upload staging ring; the host never runs more than",
+        "this past the acknowledged byte count (polled via GET_ASSETS).",
+    ]),
+]
+
+# Delta firmware update agreement (see prj_usb_composite/src/fwup.h).
+FW_STATES = [
+    ("IDLE", 0),
+    ("BASE_MISMATCH", 1, [
+        "FW_BEGIN's base CRC did not match the running image; nothing",
+        "was erased.",
+    ]),
+    ("RECEIVING", 2),
+    ("DONE", 3, [
+        "Patch applied and target CRC verified; power cycle to run it.",
+    ]),
+    ("ERROR", 4),
+]
+
+# Transport benchmark sub-ops (USB_BENCH_MODE=1 builds only; the command
+# id is GET_TRACE's, see above).
+BENCH_OPS = [
+    ("ECHO", 0x00),
+    ("SINK", 0x01),
+    ("SOURCE", 0x02),
+]
+
+# Host-only derived layout constants (the firmware parses count fields
+# instead of assuming these).
+HOST_DERIVED = [
+    ("ASSET_DATA_BYTES_PER_PACKET", 64 - 2, [
+        "ASSET_DATA payload per REPORT_LENGTH packet.",
+    ]),
+    ("MULTI_FILL_MAX_RECTS", (64 - 4) // 6, [
+        "Rect records that fit one MULTI_FILL packet.",
+    ]),
+    ("PALETTE_SIZE", 256),
+    ("PALETTE_ENTRIES_PER_PACKET", 30, [
+        "SET_PALETTE entries per packet: (64 - 4) // 2.",
+    ]),
+    ("FW_DATA_BYTES_PER_PACKET", 64 - 2, [
+        "FW_DATA payload per REPORT_LENGTH packet.",
+    ]),
+]
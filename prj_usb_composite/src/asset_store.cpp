@@ -0,0 +1,227 @@
+#include "asset_store.h"
+#include <cstring>
+
+extern "C" {
+    #include "gd32vf103.h" // fmc_unlock/fmc_page_erase/fmc_word_program
+}
+
+// Region bounds provided by lib/system/GD32VF103xB.lds: the last 32 KB
+// of flash, excluded from the firmware image.
+extern "C" const uint8_t _asset_store[];
+extern "C" const uint8_t _easset_store[];
+
+namespace assets {
+
+namespace {
+
+constexpr uint32_t PageBytes = 1024; // GD32VF103xB main-flash erase page
+
+// Upload staging ring: the USB ISR produces ASSET_DATA payload bytes,
+// poll() drains them into the FMC. 512 bytes holds eight packets; the
+// host polls the byte counter and never runs further ahead than that,
+// so a full ring means a protocol violation and the excess is dropped.
+uint8_t s_ring[512];
+volatile uint16_t s_ring_head = 0;
+volatile uint16_t s_ring_tail = 0;
+
+volatile StoreState s_state = StoreState::IDLE;
+volatile uint32_t s_bytes_received = 0;
+volatile bool s_info_requested = false;
+
+// Latched ASSET_BEGIN parameters, consumed by poll().
+volatile bool s_begin_pending = false;
+bool s_begin_wipe = false;
+uint8_t s_begin_id = 0;
+uint8_t s_begin_w = 0;
+uint8_t s_begin_h = 0;
+uint16_t s_begin_version = 0;
+
+uint32_t s_write_addr = 0;     // next flash byte to program
+uint32_t s_erase_addr = 0;     // next page during a wipe
+uint32_t s_data_remaining = 0; // pixel bytes the active upload still owes
+uint32_t s_word = 0;           // partial FMC programming word
+uint32_t s_word_len = 0;
+
+uint32_t store_base() { return reinterpret_cast<uint32_t>(_asset_store); }
+uint32_t store_end()  { return reinterpret_cast<uint32_t>(_easset_store); }
+
+// Header plus pixel bytes, rounded up to the 4-byte programming unit so
+// the next asset's header starts word-aligned.
+uint32_t asset_span(const AssetHeader* h) {
+    return sizeof(AssetHeader) + ((static_cast<uint32_t>(h->length) + 3u) & ~3u);
+}
+
+void program_word(uint32_t word) {
+    fmc_word_program(s_write_addr, word);
+    s_write_addr += 4;
+}
+
+} // namespace
+
+void init() {
+    // Find the append frontier: assets are packed back to back from the
+    // region base, so the first address without a valid header is where
+    // the next upload lands. Erased flash reads 0xFFFFFFFF, never magic.
+    uint32_t addr = store_base();
+    while ((addr + sizeof(AssetHeader)) <= store_end()) {
+        const AssetHeader* h = reinterpret_cast<const AssetHeader*>(addr);
+        if (h->magic != AssetMagic) break;
+        if (h->length == 0 || (addr + asset_span(h)) > store_end()) break;
+        addr += asset_span(h);
+    }
+    s_write_addr = addr;
+}
+
+const AssetHeader* find(uint8_t id) {
+    uint32_t addr = store_base();
+    while ((addr + sizeof(AssetHeader)) <= s_write_addr) {
+        const AssetHeader* h = reinterpret_cast<const AssetHeader*>(addr);
+        if (h->magic != AssetMagic) break;
+        if (h->id == id) return h;
+        addr += asset_span(h);
+    }
+    return nullptr;
+}
+
+const uint8_t* pixels(const AssetHeader* header) {
+    return reinterpret_cast<const uint8_t*>(header) + sizeof(AssetHeader);
+}
+
+uint32_t directory(const AssetHeader** out, uint32_t max) {
+    uint32_t count = 0;
+    uint32_t addr = store_base();
+    while (count < max && (addr + sizeof(AssetHeader)) <= s_write_addr) {
+        const AssetHeader* h = reinterpret_cast<const AssetHeader*>(addr);
+        if (h->magic != AssetMagic) break;
+        out[count++] = h;
+        addr += asset_span(h);
+    }
+    return count;
+}
+
+void beginUpload(uint8_t id, uint16_t version, uint8_t w, uint8_t h, bool wipe) {
+    // The host polls the store state and only begins when it is settled;
+    // a begin that races an active upload is a protocol violation and is
+    // dropped rather than corrupting the append frontier.
+    if (s_state == StoreState::ERASING || s_state == StoreState::WRITING) return;
+    s_begin_id = id;
+    s_begin_version = version;
+    s_begin_w = w;
+    s_begin_h = h;
+    s_begin_wipe = wipe;
+    s_bytes_received = 0;
+    s_ring_head = 0;
+    s_ring_tail = 0;
+    s_begin_pending = true;
+}
+
+void stageData(const uint8_t* data, uint32_t len) {
+    if (s_state != StoreState::WRITING) return;
+    uint16_t used = static_cast<uint16_t>(s_ring_head - s_ring_tail);
+    uint32_t room = sizeof(s_ring) - used;
+    if (len > room) len = room; // host outran its polling; the tail is lost
+    for (uint32_t i = 0; i < len; i++) {
+        s_ring[s_ring_head % sizeof(s_ring)] = data[i];
+        s_ring_head = static_cast<uint16_t>(s_ring_head + 1);
+    }
+}
+
+void requestInfo()     { s_info_requested = true; }
+bool infoRequested()   { return s_info_requested; }
+void clearInfoRequest(){ s_info_requested = false; }
+StoreState state()     { return s_state; }
+uint32_t bytesReceived(){ return s_bytes_received; }
+
+void poll() {
+    if (s_state == StoreState::ERASING) {
+        // One page per pass: a page erase stalls flash instruction fetch
+        // for its full duration, so spreading the wipe across SOF-paced
+        // calls keeps the stalls at page granularity instead of freezing
+        // the device for the whole region.
+        fmc_unlock();
+        fmc_page_erase(s_erase_addr);
+        fmc_lock();
+        s_erase_addr += PageBytes;
+        if (s_erase_addr >= store_end()) {
+            s_write_addr = store_base();
+            s_state = StoreState::IDLE;
+        }
+        return;
+    }
+
+    if (s_begin_pending && s_state != StoreState::ERASING) {
+        if (s_begin_wipe) {
+            // Erase the whole region first; the begin stays latched and
+            // programs its header once the wipe completes.
+            s_begin_wipe = false;
+            s_erase_addr = store_base();
+            s_state = StoreState::ERASING;
+            return;
+        }
+        s_begin_pending = false;
+
+        uint32_t length = static_cast<uint32_t>(s_begin_w)
+                        * static_cast<uint32_t>(s_begin_h) * 2u;
+        AssetHeader header = {AssetMagic, s_begin_id, s_begin_w, s_begin_h,
+                              0, s_begin_version,
+                              static_cast<uint16_t>(length)};
+        if (length == 0 ||
+            (s_write_addr + asset_span(&header)) > store_end()) {
+            s_state = StoreState::ERROR; // host wipes and retries, or gives up
+            return;
+        }
+        // The header goes in up front so the append frontier is known. A
+        // power loss mid-upload leaves a header over garbage pixels; the
+        // host's version check at connect time cannot see that, so it
+        // confirms the store state returned to IDLE before trusting an
+        // upload -- and re-wipes if it never did.
+        uint32_t words[sizeof(AssetHeader) / 4];
+        memcpy(words, &header, sizeof(header));
+        fmc_unlock();
+        for (uint32_t i = 0; i < (sizeof(header) / 4); i++) {
+            program_word(words[i]);
+        }
+        fmc_lock();
+        s_data_remaining = length;
+        s_word = 0;
+        s_word_len = 0;
+        s_state = StoreState::WRITING;
+        return;
+    }
+
+    if (s_state == StoreState::WRITING) {
+        if (s_ring_tail == s_ring_head && s_data_remaining != 0) return;
+        fmc_unlock();
+        while (s_ring_tail != s_ring_head && s_data_remaining != 0) {
+            uint8_t b = s_ring[s_ring_tail % sizeof(s_ring)];
+            s_ring_tail = static_cast<uint16_t>(s_ring_tail + 1);
+            s_word |= static_cast<uint32_t>(b) << (8 * s_word_len);
+            s_word_len++;
+            s_bytes_received = s_bytes_received + 1;
+            s_data_remaining--;
+            if (s_word_len == 4) {
+                program_word(s_word);
+                s_word = 0;
+                s_word_len = 0;
+            }
+        }
+        if (s_data_remaining == 0) {
+            // Flush the final partial word, padding with erased-state 0xFF,
+            // and skip the alignment tail so the next header starts on a
+            // word boundary (asset_span rounds the same way).
+            if (s_word_len != 0) {
+                while (s_word_len < 4) {
+                    s_word |= 0xFFu << (8 * s_word_len);
+                    s_word_len++;
+                }
+                program_word(s_word);
+                s_word = 0;
+                s_word_len = 0;
+            }
+            s_state = StoreState::IDLE;
+        }
+        fmc_lock();
+    }
+}
+
+} // namespace assets
@@ -0,0 +1,74 @@
+#ifndef ASSET_STORE_H
+#define ASSET_STORE_H
+
+#include <cstdint>
+
+namespace assets {
+
+/**
+ * @brief Persistent asset store in the spare flash pages.
+ *
+ * The linker script (lib/system/GD32VF103xB.lds) keeps the last 32 KB of
+ * flash out of the firmware image; the host uploads static UI assets
+ * (icons, backgrounds) there once, versioned, and from then on a session
+ * draws them with a 6-byte DRAW_ASSET packet instead of re-streaming
+ * kilobytes of pixels. Blits read the pixels memory-mapped, directly
+ * through the LCD DMA path -- no SRAM staging at any point.
+ *
+ * Assets are packed back to back from the region base, each behind its
+ * header; the first missing magic is the append frontier. There is no
+ * in-place update: the host wipes the whole store and re-uploads when
+ * any version is stale (uploads are rare and the region is small).
+ */
+struct AssetHeader {
+    uint32_t magic;    // AssetMagic; anything else ends the directory walk
+    uint8_t  id;       // host-assigned asset identifier
+    uint8_t  width;    // pixels
+    uint8_t  height;   // pixels
+    uint8_t  reserved;
+    uint16_t version;  // bumped by the host when the asset content changes
+    uint16_t length;   // pixel bytes (width * height * 2)
+};
+
+constexpr uint32_t AssetMagic = 0x30545341u; // "AST0", little-endian
+
+// Reported in the ASSET store status report (first byte 0x09); the host
+// polls this to pace an upload, since every flash operation runs from
+// the main loop (see poll()).
+enum class StoreState : uint8_t {
+    IDLE = 0,    // no upload in progress; directory is consistent
+    ERASING = 1, // wipe in progress, one page per poll() pass
+    WRITING = 2, // header programmed; staged bytes flow into flash
+    ERROR = 3,   // last ASSET_BEGIN did not fit the region
+};
+
+// Called once at startup: walks the directory to find the append frontier.
+void init();
+
+// Directory access (valid between uploads; blit paths use these).
+const AssetHeader* find(uint8_t id);
+const uint8_t* pixels(const AssetHeader* header);
+uint32_t directory(const AssetHeader** out, uint32_t max);
+
+// Upload entry points, called from the USB ISR: they only latch a request
+// or stage bytes into a small ring. All FMC work -- page erases and word
+// programming -- happens in poll() on the main loop, because both stall
+// instruction fetch from flash for their full duration.
+void beginUpload(uint8_t id, uint16_t version, uint8_t w, uint8_t h, bool wipe);
+void stageData(const uint8_t* data, uint32_t len);
+
+// GET_ASSETS latch; the main loop answers with the directory, the store
+// state and the upload byte count (status report 0x09).
+void requestInfo();
+bool infoRequested();
+void clearInfoRequest();
+StoreState state();
+uint32_t bytesReceived();
+
+// Main-loop pump: advances a wipe one page at a time and programs staged
+// upload bytes. Cheap when the store is idle.
+void poll();
+
+} // namespace assets
+
+#endif // ASSET_STORE_H
@@ -0,0 +1,58 @@
+/*
+ * Project-local benchmarks for the lib/bench registry: timings that need
+ * this project's hardware bring-up (the LCD bus) rather than bare SRAM.
+ *
+ * The window benchmarks answer how much of a small blit is SPI command
+ * overhead: lcd_window1 pays a full CASET/RASET/RAMWR setup per pixel,
+ * lcd_window64 amortizes one setup over a 64-pixel row, so the per-iter
+ * difference is the pure window cost that decides when merging adjacent
+ * dirty rects beats blitting them separately. Both run synchronously
+ * (fill + wait) and repaint the bottom-right corner row; run them from
+ * the console while the host is not streaming rects - the initial
+ * lcd_wait_dma_idle() keeps them off an in-flight blit chain, but a
+ * concurrent stream would interleave its own windows into the timing.
+ */
+
+#include "bench.h"
+#include "profile.h"
+
+extern "C" {
+    #include "lcd.h"
+}
+
+namespace {
+
+constexpr uint32_t kIters = 64;
+constexpr int kRowX = LCD_WIDTH - 64;
+constexpr int kRowY = LCD_HEIGHT - 1;
+
+void lcd_window1(bench::Result &r)
+{
+    lcd_wait_dma_idle();
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        lcd_fill_u16(kRowX + (int)i, kRowY, 1, 1, 0x0000);
+        lcd_wait_dma_idle();
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * 2U;
+}
+
+void lcd_window64(bench::Result &r)
+{
+    lcd_wait_dma_idle();
+    uint32_t t0 = prof::cycles();
+    for (uint32_t i = 0; i < kIters; i++) {
+        lcd_fill_u16(kRowX, kRowY, 64, 1, 0x0000);
+        lcd_wait_dma_idle();
+    }
+    r.cycles = prof::cycles() - t0;
+    r.iters = kIters;
+    r.bytes = kIters * 64U * 2U;
+}
+
+BENCH_REGISTER(lcd_window1, lcd_window1);
+BENCH_REGISTER(lcd_window64, lcd_window64);
+
+} // namespace
@@ -6,8 +6,11 @@
 */
 
 #include "board.h"
-
-volatile bool user_key_pressed = false; // Flag to indicate key press to the application
+#include "events.h"
+#include "input_events.h"
+extern "C" {
+#include "n200_func.h" // eclic_enable_interrupt
+}
 
 /*!
     \brief      efficiently toggles the specified GPIO pin
@@ -28,18 +31,9 @@ void gpio_bit_toggle(uint32_t gpio_periph, uint32_t pin)
 }
 
 void board_led_init(void) {
-    rcu_periph_clock_enable(LED_R_GPIO_CLK);
-    rcu_periph_clock_enable(LED_G_GPIO_CLK);
-    rcu_periph_clock_enable(LED_B_GPIO_CLK);
-    
-    gpio_init(LED_R_GPIO_PORT, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, LED_R_PIN);
-    gpio_init(LED_G_GPIO_PORT, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, LED_G_PIN);
-    gpio_init(LED_B_GPIO_PORT, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, LED_B_PIN);
-
-    // LEDs on Longan Nano are common anode, so set high to turn off
-    gpio_bit_set(LED_R_GPIO_PORT, LED_R_PIN);
-    gpio_bit_set(LED_G_GPIO_PORT, LED_G_PIN);
-    gpio_bit_set(LED_B_GPIO_PORT, LED_B_PIN);
+    // Pin modes, port clocks and the off state (common anode: high)
+    // come from the one-pass table in board_pins.h; nothing to do
+    // until an LED is driven.
 }
 
 void board_led_on(void) {
@@ -55,29 +49,58 @@ void board_led_toggle(void) {
     gpio_bit_toggle(LED_G_GPIO_PORT, LED_G_PIN);
 }
 
-void board_key_init(void) {
-    rcu_periph_clock_enable(USER_KEY_GPIO_CLK);
-    rcu_periph_clock_enable(RCU_AF);
+// Debounce window between the key edge and the settled-level sample.
+static const uint32_t KEY_DEBOUNCE_MS = 50;
 
+void board_key_init(void) {
+    // Pin mode and the port/AF clocks come from board_pins.h; only the
+    // EXTI routing and the debounce timer are set up here.
     gpio_exti_source_select(USER_KEY_EXTI_PORT_SOURCE, USER_KEY_EXTI_PIN_SOURCE);
 
     exti_init(USER_KEY_EXTI_LINE, EXTI_INTERRUPT, EXTI_TRIG_FALLING);
     exti_interrupt_flag_clear(USER_KEY_EXTI_LINE);
 
-    eclic_irq_enable(USER_KEY_EXTI_IRQn, 1, 0);
+    eclic_enable_interrupt(USER_KEY_EXTI_IRQn); // level/priority: irq_map.c
+
+    // One-shot debounce timer: started by the EXTI edge, fires once
+    // after the bounce has settled, then stops on its own (single
+    // pulse mode). A 10 kHz tick keeps the prescaler in 16 bits.
+    rcu_periph_clock_enable(RCU_TIMER4);
+    timer_deinit(TIMER4);
+    timer_parameter_struct timer_initpara;
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = (uint16_t)(SystemCoreClock / 10000U - 1U);
+    timer_initpara.period    = (uint16_t)(KEY_DEBOUNCE_MS * 10U - 1U);
+    timer_init(TIMER4, &timer_initpara);
+    timer_single_pulse_mode_config(TIMER4, TIMER_SP_MODE_SINGLE);
+    // timer_init generated an update event to load the prescaler; clear
+    // it so enabling the interrupt does not fire immediately.
+    timer_interrupt_flag_clear(TIMER4, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(TIMER4, TIMER_INT_UP);
+    eclic_enable_interrupt(TIMER4_IRQn); // level/priority: irq_map.c
 }
 
 void board_key_isr(void) {
-    // Perform software debouncing using a static timer.
-    static volatile uint64_t last_key_press_time = 0;
-    const uint32_t DEBOUNCE_TIME_MS = 50;
-    uint64_t now = get_timer_value();
-
-    // Only execute the action if the debounce time has passed.
-    if ((now - last_key_press_time) > DEBOUNCE_TIME_MS) {
-        last_key_press_time = now; // Update the timer for the *next* valid press
-        user_key_pressed = true;   // Set the application flag
+    // First edge only: disarm the line so bounce edges stop interrupting,
+    // and let the one-shot timer take over. The line is re-armed once
+    // the debounce window expires (board_key_timer_isr).
+    exti_interrupt_disable(USER_KEY_EXTI_LINE);
+    exti_interrupt_flag_clear(USER_KEY_EXTI_LINE);
+    timer_counter_value_config(TIMER4, 0);
+    timer_enable(TIMER4);
+}
+
+void board_key_timer_isr(void) {
+    timer_interrupt_flag_clear(TIMER4, TIMER_INT_FLAG_UP);
+
+    // Accept the press only if the key still reads pressed after the
+    // window -- a glitch that bounced back up is discarded here.
+    if (gpio_input_bit_get(USER_KEY_GPIO_PORT, USER_KEY_PIN) == RESET) {
+        input::post(input::Type::USER_KEY, 1);
     }
 
+    // Re-arm the edge interrupt, discarding any edges the bounce left
+    // latched while the line was disarmed.
     exti_interrupt_flag_clear(USER_KEY_EXTI_LINE);
+    exti_interrupt_enable(USER_KEY_EXTI_LINE);
 }
\ No newline at end of file
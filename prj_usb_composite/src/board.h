@@ -36,8 +36,14 @@ void board_led_init(void);
 void board_led_on(void);
 void board_led_off(void);
 void board_led_toggle(void);
+// Key press path: the EXTI edge disarms itself and starts a one-shot
+// debounce timer (TIMER4); the timer ISR samples the settled level,
+// queues the press and re-arms the EXTI line. No polling, no repeated
+// bounce interrupts -- idle cost is zero and press latency is bounded
+// by the debounce window.
 void board_key_init(void);
 void board_key_isr(void);
+void board_key_timer_isr(void);
 
 // New helper function for toggling a GPIO pin
 void gpio_bit_toggle(uint32_t gpio_periph, uint32_t pin);
@@ -0,0 +1,59 @@
+#ifndef BOARD_PINS_H
+#define BOARD_PINS_H
+
+#include "pinmux.h"
+
+/**
+ * @brief The project's complete pin map, applied in one pass at boot.
+ *
+ * One table instead of gpio_init() calls scattered across board.cpp,
+ * rotary_encoder.cpp and the lib drivers. The lib drivers (LCD, SD,
+ * debug UART, I2C) still run their own gpio_init() so they stay usable
+ * from projects without a table; those rewrites are identical nibbles
+ * and cost nothing - but their pins are listed here too, so a new
+ * claim that collides with any of them fails the distinct() check at
+ * compile time instead of silently reconfiguring a live line.
+ */
+namespace board_pins {
+
+constexpr pinmux::Entry kTable[] = {
+    /* LEDs, common anode: high = off. */
+    { GPIOC, GPIO_PIN_13, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_HIGH },
+    { GPIOA, GPIO_PIN_1 | GPIO_PIN_2, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_HIGH },
+    /* User key, externally pulled; EXTI setup stays in board.cpp. */
+    { GPIOA, GPIO_PIN_8, GPIO_MODE_IN_FLOATING, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+    /* Rotary encoder phases (EXTI variant; the TIMER1 decode variant
+     * would claim PA0/PA1 and collide with the green LED - exactly the
+     * conflict this table exists to catch). */
+    { GPIOB, GPIO_PIN_10 | GPIO_PIN_11, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+#if !defined(USE_SD_CARD_MSC) || (USE_SD_CARD_MSC == 0)
+    /* Encoder shaft press. In MSC builds SD chip select owns PB12 and
+     * the encoder key is unavailable; listing both would (rightly)
+     * fail distinct(). */
+    { GPIOB, GPIO_PIN_12, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+#else
+    /* SD card on SPI1: CS idles high, MISO floats (card drives it). */
+    { GPIOB, GPIO_PIN_12, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_HIGH },
+    { GPIOB, GPIO_PIN_13 | GPIO_PIN_15, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+    { GPIOB, GPIO_PIN_14, GPIO_MODE_IN_FLOATING, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+#endif
+    /* LCD on SPI0: SCK/MOSI, then DC / RST / CS (CS idles high). */
+    { GPIOA, GPIO_PIN_5 | GPIO_PIN_7, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+    { GPIOB, GPIO_PIN_0 | GPIO_PIN_1, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+    { GPIOB, GPIO_PIN_2, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_HIGH },
+    /* Debug UART0: TX push-pull, RX floating. */
+    { GPIOA, GPIO_PIN_9, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+    { GPIOA, GPIO_PIN_10, GPIO_MODE_IN_FLOATING, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+#if defined(I2C_SENSORS) && (I2C_SENSORS == 1)
+    /* Sensor bus on I2C0, open drain per the spec. */
+    { GPIOB, GPIO_PIN_6 | GPIO_PIN_7, GPIO_MODE_AF_OD, GPIO_OSPEED_50MHZ, pinmux::LEVEL_NONE },
+#endif
+};
+
+static_assert(pinmux::distinct(kTable), "a pin is claimed by two table entries");
+
+inline void apply(void) { pinmux::apply(kTable); }
+
+} // namespace board_pins
+
+#endif // BOARD_PINS_H
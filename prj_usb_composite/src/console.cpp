@@ -0,0 +1,329 @@
+#include "console.h"
+#include "shell.h"
+#include "display_manager.h"
+#include "usb.hpp"
+#include "health.h"
+#include "telemetry.h"
+#include "evtrace.h"
+#include "profile.h"
+#include "bench.h"
+#include "tfmt_chars.h"
+#include "cfgstore.h"
+#include "buildinfo.h"
+#include "board_clocks.h"
+#include "perflog.h"
+
+#include <cstring>
+
+extern "C" {
+    #include "bootmark.h"
+    #include "systick.h"
+    #include "memwatch.h"
+}
+
+namespace console {
+
+namespace {
+
+// --- Command handlers -------------------------------------------------
+// Main-loop context (report_service), so every stats surface the HID
+// report paths read is safe to read here too.
+
+// The two polled-in-a-loop responses build their lines with the
+// tfmt::Writer conversions instead of shell::printf: same bytes on the
+// wire, no per-field format parsing. Buffers are budgeted from the
+// worst-case conversion widths, so the static_assert below is the
+// truncation check.
+void cmd_stats(int, char **)
+{
+    const display::PipelineStats &st =
+        display::DisplayManager::getInstance().stats();
+    char line[TFMT_LIT_W("packets  rects  drops  peak /") +
+              5 * tfmt::MaxU32Chars + 2];
+    static_assert(sizeof(line) >= TFMT_LIT_W("draw  cyc  dma-busy  cyc  crc-fail ") +
+                  3 * tfmt::MaxU32Chars + 2, "stats line budget");
+    tfmt::Writer w(line, sizeof(line));
+    w.str("packets ").dec(st.packets_received)
+     .str("  rects ").dec(st.rects_drawn)
+     .str("  drops ").dec(st.slots_dropped)
+     .str("  peak ").dec((uint32_t)st.slots_peak).ch('/')
+     .dec((uint32_t)display::constants::NumBuffers).ch('\n');
+    shell::put(line, w.size());
+
+    tfmt::Writer w2(line, sizeof(line));
+    w2.str("draw ").dec(st.draw_cycles_last)
+      .str(" cyc  dma-busy ").dec(st.dma_busy_cycles)
+      .str(" cyc  crc-fail ").dec(st.crc_failures).ch('\n');
+    shell::put(line, w2.size());
+}
+
+void cmd_health(int, char **)
+{
+    uint32_t mask = health::tripped();
+    int16_t t = telemetry::die_temp_dc();
+    char line[TFMT_LIT_W("tripped 0x draw-latency drop-rate sd-errors") +
+              tfmt::MaxHex32Chars + 2];
+    static_assert(sizeof(line) >= TFMT_LIT_W("supply  mV  die . C") +
+                  3 * tfmt::MaxU32Chars + 2, "health line budget");
+    tfmt::Writer w(line, sizeof(line));
+    w.str("tripped 0x").hex(mask);
+    if (mask & health::SIG_DRAW_LATENCY) w.str(" draw-latency");
+    if (mask & health::SIG_DROP_RATE) w.str(" drop-rate");
+    if (mask & health::SIG_SD_ERRORS) w.str(" sd-errors");
+    w.ch('\n');
+    shell::put(line, w.size());
+
+    tfmt::Writer w2(line, sizeof(line));
+    w2.str("supply ").dec((uint32_t)telemetry::supply_mv())
+      .str(" mV  die ").dec((int32_t)(t / 10)).ch('.')
+      .dec((uint32_t)((t < 0 ? -t : t) % 10)).str(" C\n");
+    shell::put(line, w2.size());
+}
+
+void cmd_clk(int, char **)
+{
+    // Read-only by design: the clock profile is a build-time choice
+    // (SYSTEM_CLOCK_PROFILE), and any CK_SYS repoke would also repoke
+    // CK_USBFS and drop the link this console arrives on.
+    shell::printf("CK_SYS %u Hz (profile fixed at build time)\n",
+                  (unsigned)SystemCoreClock);
+}
+
+void cmd_clocks(int, char **)
+{
+    // Live RCU enables against the compile-time registry. An extra bit
+    // outside the registry and its dynamic allowance (CRC, bench DMA --
+    // see board_clocks.h) is a surprise always-on clock: some driver
+    // enabling what the build was not supposed to use.
+    const struct { const char *name; uint32_t live, want, dyn; } regs[] = {
+        { "ahb ", RCU_AHBEN,  board_clocks::kMasks.ahb | clkgate::kAhbFixed,
+          board_clocks::kDynamicAhb },
+        { "apb1", RCU_APB1EN, board_clocks::kMasks.apb1, 0U },
+        { "apb2", RCU_APB2EN, board_clocks::kMasks.apb2, 0U },
+    };
+    for (const auto &r : regs) {
+        uint32_t extra = r.live & ~(r.want | r.dyn);
+        shell::printf("%s %08x  registry %08x%s%08x\n",
+                      r.name, (unsigned)r.live, (unsigned)r.want,
+                      extra ? "  EXTRA " : "  extra ", (unsigned)extra);
+    }
+}
+
+void cmd_hist(int, char **)
+{
+    // Boot-over-boot aggregates (perflog.h): same view HISTORY.TXT on
+    // the stats RAM disk serves. Compare a counter's per-boot average
+    // against the stats command's current-boot value to tell aging
+    // hardware from a fleet-wide firmware regression.
+    static const char *const label[perflog::NumCounters] = {
+        "rects", "drops", "crc-fail", "sd-retry", "stall-dfr",
+    };
+    perflog::Totals t = perflog::totals();
+    uint32_t boots = (t.boots != 0U) ? t.boots : 1U;
+    shell::printf("boots %u\n", (unsigned)t.boots);
+    for (uint32_t i = 0; i < perflog::NumCounters; i++) {
+        shell::printf("%-10s %u (%u/boot)\n", label[i],
+                      (unsigned)t.counter[i],
+                      (unsigned)(t.counter[i] / boots));
+    }
+}
+
+void cmd_build(int, char **)
+{
+    // Compile-time identity from the generated buildinfo.h. The
+    // fingerprint line matches what REPORT_BUILD carries, so a console
+    // reading can be checked against host-side benchmark records; the
+    // flags line is the feature-define set the fingerprint covers.
+    shell::printf("%s  profile %s  fingerprint 0x%08x\n",
+                  BUILDINFO_GIT, BUILDINFO_PROFILE,
+                  (unsigned)BUILDINFO_FINGERPRINT);
+    // Literal concatenation through put(): the define list can exceed
+    // shell::printf's line buffer, and it never needs formatting.
+    static const char flags_line[] = "flags " BUILDINFO_FLAGS "\n";
+    shell::put(flags_line, sizeof(flags_line) - 1);
+}
+
+void cmd_uptime(int, char **)
+{
+    // mtime ticks at CK_SYS/4 from reset.
+    uint64_t secs = get_timer_value() / (SystemCoreClock / 4U);
+    shell::printf("up %u s\n", (unsigned)secs);
+}
+
+void cmd_boot(int, char **)
+{
+    // Slot order is the BootStage enum in main.cpp.
+    static const char *const stage[] = {
+        "main", "usb", "lcd", "assets", "sd", "cfg",
+    };
+    for (uint32_t i = 0; i < sizeof(stage) / sizeof(stage[0]); i++) {
+        shell::printf("%-6s %u cyc\n", stage[i],
+                      (unsigned)bootmark_cycles(i));
+    }
+}
+
+void cmd_trace(int argc, char **argv)
+{
+    if (argc < 2 || (strcmp(argv[1], "on") != 0 &&
+                     strcmp(argv[1], "off") != 0)) {
+        shell::printf("usage: trace on|off\n");
+        return;
+    }
+    evt::arm(argv[1][1] == 'n');
+    shell::printf("trace %s (GET_TRACE dumps the ring)\n", argv[1]);
+}
+
+void cmd_prof(int, char **)
+{
+    // The accumulator report is printf-based and can run long, so it
+    // stays on the debug UART rather than the console TX ring.
+    prof::dump(true);
+    shell::printf("profile accumulators dumped to debug UART and reset\n");
+}
+
+void cmd_mem(int, char **)
+{
+    shell::printf("stack %u/%u free (low-water)  heap %u/%u used (peak)\n",
+                  (unsigned)memwatch_stack_headroom(),
+                  (unsigned)memwatch_stack_size(),
+                  (unsigned)memwatch_heap_used_max(),
+                  (unsigned)memwatch_heap_size());
+}
+
+// Decimal argv parsing for the cfg command; false on empty or
+// non-digit input (tinyfmt is output-only, and strtoul drags in more
+// newlib than one command justifies).
+bool parse_u32(const char *s, uint32_t &out)
+{
+    if (*s == '\0') return false;
+    uint32_t v = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9') return false;
+        v = v * 10U + static_cast<uint32_t>(*s - '0');
+    }
+    out = v;
+    return true;
+}
+
+void cmd_cfg(int argc, char **argv)
+{
+    // Front end for the flash parameter store (lib/cfgstore; key
+    // meanings in tuning.h). Values written here survive reboot and
+    // reflash; most consumers snapshot at boot, so a set usually takes
+    // effect on the next power cycle.
+    uint32_t key, value;
+    if (argc >= 2 && strcmp(argv[1], "list") == 0) {
+        for (uint8_t k = 0; k < cfgstore::MaxKeys; k++) {
+            if (cfgstore::get(k, value)) {
+                shell::printf("%u = %u\n", (unsigned)k, (unsigned)value);
+            }
+        }
+        shell::printf("page used %u B\n", (unsigned)cfgstore::used());
+        return;
+    }
+    if (argc == 3 && strcmp(argv[1], "get") == 0 && parse_u32(argv[2], key)) {
+        if (cfgstore::get(static_cast<uint8_t>(key), value)) {
+            shell::printf("%u\n", (unsigned)value);
+        } else {
+            shell::printf("unset\n");
+        }
+        return;
+    }
+    if (argc == 4 && strcmp(argv[1], "set") == 0 && parse_u32(argv[2], key)
+        && parse_u32(argv[3], value)) {
+        shell::printf(cfgstore::set(static_cast<uint8_t>(key), value)
+                          ? "ok (applies at next boot)\n"
+                          : "write failed\n");
+        return;
+    }
+    if (argc >= 2 && strcmp(argv[1], "wipe") == 0) {
+        cfgstore::wipe();
+        shell::printf("store erased\n");
+        return;
+    }
+    shell::printf("usage: cfg list | get <k> | set <k> <v> | wipe\n");
+}
+
+void bench_sink(const char *line)
+{
+    shell::printf("%s\n", line);
+}
+
+void cmd_bench(int argc, char **argv)
+{
+    // Drives the lib/bench registry (the SRAM bandwidth test that used
+    // to live inline here is now bench_mem.cpp's memcpy_lib/memset_lib).
+    // No argument runs the whole table; the LCD window benchmarks paint
+    // over the corner row, so run those while the host is not streaming.
+    if (argc >= 2 && strcmp(argv[1], "list") == 0) {
+        bench::list(bench_sink);
+        return;
+    }
+    if (argc >= 2) {
+        if (!bench::run_one(argv[1], bench_sink)) {
+            shell::printf("no benchmark '%s' (try: bench list)\n", argv[1]);
+        }
+        return;
+    }
+    bench::run_all(bench_sink);
+}
+
+constexpr shell::Command kCommands[] = {
+    { "stats",  "display pipeline counters",             cmd_stats },
+    { "health", "anomaly mask + supply/die telemetry",   cmd_health },
+    { "clk",    "core clock (read-only; see src)",       cmd_clk },
+    { "clocks", "RCU enables vs the board registry",     cmd_clocks },
+    { "uptime", "seconds since reset",                   cmd_uptime },
+    { "build",  "firmware build identity (buildinfo.h)", cmd_build },
+    { "boot",   "bring-up stage timestamps",             cmd_boot },
+    { "hist",   "boot-over-boot counter history",        cmd_hist },
+    { "mem",    "stack/heap watermarks",                 cmd_mem },
+    { "trace",  "arm/disarm the event trace ring",       cmd_trace },
+    { "prof",   "dump PROF_SCOPE accumulators (UART)",   cmd_prof },
+    { "bench",  "micro-benchmarks [list|<name>]",        cmd_bench },
+    { "cfg",    "flash tunables (see src/tuning.h)",     cmd_cfg },
+};
+
+} // namespace
+
+void init()
+{
+    shell::init(kCommands, sizeof(kCommands) / sizeof(kCommands[0]));
+}
+
+void rxFromIsr(const uint8_t *data, uint32_t len)
+{
+    // Packet format received: [CMD, count, count text bytes].
+    if (len < 2) return;
+    uint32_t n = data[1];
+    if (n > len - 2) n = len - 2;
+    shell::rx(data + 2, n);
+}
+
+void service()
+{
+    shell::service();
+
+    // Latched-retry flush, like every other IN report path in this
+    // project: a chunk pulled out of the TX ring stays here until the
+    // endpoint queue accepts it.
+    static uint8_t pkt[display::wire::ReportLength];
+    static uint32_t pending = 0;
+    for (;;) {
+        if (pending == 0) {
+            uint32_t n = shell::drain(&pkt[2], sizeof(pkt) - 2);
+            if (n == 0) {
+                return;
+            }
+            pkt[0] = display::report::Console;
+            pkt[1] = static_cast<uint8_t>(n);
+            pending = 2 + n;
+        }
+        if (!usb::send_custom_hid_report(pkt, pending)) {
+            return; // IN queue full; retry on the next pass
+        }
+        pending = 0;
+    }
+}
+
+} // namespace console
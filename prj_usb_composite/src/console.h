@@ -0,0 +1,41 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <cstdint>
+
+/**
+ * @brief Runtime tuning console, carried on the display bulk interface.
+ *
+ * The field workflow this serves: attach a terminal, read the pipeline
+ * and health counters, run a quick on-device benchmark, all without
+ * reflashing. The line discipline and command dispatch live in
+ * lib/shell; this file is the project glue that defines the command
+ * table and moves bytes.
+ *
+ * Transport: a dedicated CDC function was the obvious shape, but the
+ * USBFS core has four endpoint pairs and EP0 + standard HID + display
+ * bulk + MSC already claim all of them, so the console rides the
+ * existing display interface instead. CMD_CONSOLE packets carry
+ * keystrokes in, REPORT_CONSOLE packets carry output back, and
+ * tools/display_manager/console.py is the terminal. Cost when no
+ * console is attached: one ring-empty check per SOF-paced report pass.
+ */
+namespace console {
+
+// Registers the command table with lib/shell. Call once before the
+// main loop starts draining.
+void init();
+
+// USB OUT ISR: deposits a CMD_CONSOLE packet's text bytes into the
+// shell's RX ring (usb_device.cpp intercepts the command before the
+// DisplayManager sees it).
+void rxFromIsr(const uint8_t *data, uint32_t len);
+
+// Main-loop pump (report_service): runs completed lines and flushes
+// shell output as REPORT_CONSOLE packets, latched-retry style, so a
+// full IN queue delays output instead of dropping it.
+void service();
+
+} // namespace console
+
+#endif // CONSOLE_H
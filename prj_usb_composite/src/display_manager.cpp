@@ -1,53 +1,867 @@
 #include "display_manager.h"
+#include "asset_store.h"
+#include "fwup.h"
+#include "mtimer.h"
+#include "events.h"
+#include "evtrace.h"
+#include "trace_ids.h"
 #include <cstdio>
 #include <cstring>
 
 // This block correctly links the C functions from the LCD library.
 extern "C" {
     #include "lcd.h"
+    #include "lcd_font.h"
+    #include "lcd_text.h"
+    #include "font_ubuntu_16.h" // baked by bldmgr/fontgen.py (GENERATED_FONTS)
+    #include "riscv_encoding.h" // read_csr(mcycle) for the pipeline counters
+    #include "gd32vf103_crc.h"  // hardware CRC unit for integrity streams
+    #include "gd32vf103_rcu.h"
+    #include "sram.h"           // named-region placement (framebuffers)
 }
 
 namespace display {
 
-// Singleton instance getter
+// True when two panel rects share at least one pixel. Drives the
+// out-of-order dispatch scan in processDrawTasks: only overlapping
+// rects have to keep their sequence order on the panel.
+static bool rects_overlap(const Rect& a, const Rect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Singleton instance getter. The instance is dominated by its
+// framebuffers (all DMA-fed), so the whole object lives in the named
+// .dma_buffers region: the map file shows what display buffering
+// actually costs, and outgrowing the region's budget fails the link
+// (lib/system/sram.h).
 DisplayManager& DisplayManager::getInstance() {
-    static DisplayManager instance;
+    static DisplayManager instance SRAM_DMA_BUFFER;
     return instance;
 }
 
+DisplayManager::DisplayManager() {
+    // The LCD driver calls us back from the DMA transfer-complete ISR so the
+    // next READY_TO_DRAW slot can be decoded while the panel is still busy.
+    lcd_set_dma_done_callback(&DisplayManager::onBlitCompleteISR);
+}
+
+void DisplayManager::onBlitCompleteISR() {
+    getInstance().completeDrawTask();
+    events::post(events::DRAW); // wake the loop to dispatch the next slot
+}
+
+void DisplayManager::completeDrawTask() {
+    // Per-rect timing: the chain start (or previous rect completion) is in
+    // m_blit_start_cycles, so the delta is the cost of this rect alone.
+    uint32_t now = read_csr(mcycle);
+    m_stats.draw_cycles_last = now - m_blit_start_cycles;
+    m_stats.dma_busy_cycles += m_stats.draw_cycles_last;
+    m_blit_start_cycles = now;
+    m_stats.rects_drawn++;
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    evt::note(TRACE_BLIT_DONE, 0);
+    // Nothing to retire: the resident frame stays valid and can simply be
+    // streamed again on the next refresh. Every rect merged before this
+    // blit was submitted has now reached the panel; echo them.
+    while (m_inflight_tail != m_inflight_mark) {
+        const LatencyEcho& entry = m_inflight[m_inflight_tail % m_inflight.size()];
+        pushLatencyEcho(entry.seq, now - entry.cycles);
+        m_inflight_tail = static_cast<uint8_t>(m_inflight_tail + 1);
+    }
+#else
+    // Chain entries complete in dispatch order, which may differ from
+    // ring order (out-of-order dispatch; see processDrawTasks).
+    if (m_chain_next < m_chain_count) {
+        const uint8_t slot = m_chain_slots[m_chain_next];
+        m_chain_next = static_cast<uint8_t>(m_chain_next + 1);
+        evt::note(TRACE_BLIT_DONE, slot);
+        DrawTask& task = m_draw_tasks[slot];
+        if (m_latency_probe) {
+            pushLatencyEcho(task.sequence_number, now - task.enqueue_cycles);
+        }
+        task.ext_pixels = nullptr; // a reused slot must not blit stale flash
+        task.state = BufferState::EMPTY;
+        // Credits retire in ring order: a slot freed ahead of a still-
+        // pending neighbour becomes allocatable only once the tail can
+        // sweep over it, so freeSlots() keeps mirroring the admission
+        // check in DRAW_RECT.
+        while (m_dma_tail_idx != m_usb_head_idx &&
+               m_draw_tasks[m_dma_tail_idx].state == BufferState::EMPTY) {
+            m_dma_tail_idx = (m_dma_tail_idx + 1) % constants::NumBuffers;
+        }
+    }
+#endif
+}
+
+void DisplayManager::pushLatencyEcho(uint16_t seq, uint32_t cycles) {
+    // Ring is drained by the main loop; drop echoes when it falls behind
+    // (the probe measures latency, it must never add backpressure).
+    if (static_cast<uint8_t>(m_echo_head - m_echo_tail) >= m_echo_ring.size()) return;
+    m_echo_ring[m_echo_head % m_echo_ring.size()] = {seq, cycles};
+    m_echo_head = static_cast<uint8_t>(m_echo_head + 1);
+}
+
+bool DisplayManager::latencyEchoPending(uint16_t& seq, uint32_t& cycles) {
+    if (m_echo_tail == m_echo_head) return false;
+    const LatencyEcho& entry = m_echo_ring[m_echo_tail % m_echo_ring.size()];
+    seq = entry.seq;
+    cycles = entry.cycles;
+    return true;
+}
+
+void DisplayManager::popLatencyEcho() {
+    if (m_echo_tail != m_echo_head) {
+        m_echo_tail = static_cast<uint8_t>(m_echo_tail + 1);
+    }
+}
+
+// Word-wise feed for the verification pass: the same little-endian word
+// assembly as crcFeed, but with caller-held state so one pass can walk
+// non-contiguous rows of the resident frame.
+static void verifyFeed(uint32_t& word, uint8_t& word_len,
+                       const uint8_t* src, uint32_t len) {
+    while (len--) {
+        word |= static_cast<uint32_t>(*src++) << (8U * word_len);
+        if (++word_len == 4U) {
+            crc_single_data_calculate(word);
+            word = 0;
+            word_len = 0;
+        }
+    }
+}
+
+void DisplayManager::pushVerifyEcho(const DrawTask& task) {
+    // Golden-image verification (VERIFY_MODE): hardware-unit CRC32 over
+    // the decoded region pixels, the value the host's framecodec.crc32
+    // computes over the payload it encoded. Runs at finalize in the USB
+    // ISR, after any integrity check has consumed the unit for this rect
+    // and before the next header resets it, so the two users never
+    // interleave. A 4 KB region costs ~1k unit writes; acceptable for a
+    // rig mode that is off in normal operation.
+    crc_data_register_reset();
+    const Rect& r = task.region;
+    uint32_t word = 0;
+    uint8_t word_len = 0;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    for (uint32_t row = 0; row < r.h; row++) {
+        verifyFeed(word, word_len,
+                   m_full_framebuffer.data() +
+                       (((r.y + row) * constants::LcdWidth) + r.x) * 2,
+                   static_cast<uint32_t>(r.w) * 2);
+    }
+#else
+    verifyFeed(word, word_len, m_framebuffers[m_usb_head_idx].data(),
+               static_cast<uint32_t>(r.w) * static_cast<uint32_t>(r.h) * 2);
+#endif
+    // Region byte counts are even, so at most a half word remains; the
+    // zero upper bytes match the host's padding.
+    if (word_len != 0) {
+        crc_single_data_calculate(word);
+    }
+    // Drained by the main loop; drop records when it falls behind, like
+    // the latency echoes (verification must never add backpressure).
+    if (static_cast<uint8_t>(m_verify_head - m_verify_tail) >= m_verify_ring.size()) return;
+    m_verify_ring[m_verify_head % m_verify_ring.size()] =
+        {task.sequence_number, crc_data_register_read()};
+    m_verify_head = static_cast<uint8_t>(m_verify_head + 1);
+}
+
+bool DisplayManager::verifyEchoPending(uint16_t& seq, uint32_t& crc) {
+    if (m_verify_tail == m_verify_head) return false;
+    const VerifyEcho& entry = m_verify_ring[m_verify_tail % m_verify_ring.size()];
+    seq = entry.seq;
+    crc = entry.crc;
+    return true;
+}
+
+void DisplayManager::popVerifyEcho() {
+    if (m_verify_tail != m_verify_head) {
+        m_verify_tail = static_cast<uint8_t>(m_verify_tail + 1);
+    }
+}
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+
+void DisplayManager::writeTaskData(DrawTask& task, const uint8_t* src, uint32_t len) {
+    // Scatter the linear rect payload into the resident frame, row by row.
+    // Packet boundaries may split a pixel, so offsets are tracked in bytes.
+    const Rect& r = task.region;
+    uint32_t offset = task.bytes_received;
+    task.bytes_received += len;
+
+    if (task.scale2x) {
+        // Pixel-doubled rect: each source byte lands in four panel pixels
+        // (a 2x2 block, same byte lane). Byte-wise like the linear path
+        // below, so split pixels at packet boundaries need no carry.
+        uint32_t src_w = r.w >> 1;
+        while (len-- > 0) {
+            uint32_t pixel = offset >> 1;
+            uint32_t row = pixel / src_w;
+            uint32_t col = pixel % src_w;
+            uint8_t* dest = m_full_framebuffer.data()
+                          + (((r.y + row * 2) * constants::LcdWidth) + r.x + col * 2) * 2
+                          + (offset & 1);
+            uint8_t v = *src++;
+            dest[0] = v;
+            dest[2] = v;
+            dest[constants::LcdWidth * 2] = v;
+            dest[constants::LcdWidth * 2 + 2] = v;
+            offset++;
+        }
+        return;
+    }
+
+    while (len > 0) {
+        uint32_t pixel = offset >> 1;
+        uint32_t row = pixel / r.w;
+        uint32_t col = pixel % r.w;
+        uint8_t* dest = m_full_framebuffer.data()
+                      + (((r.y + row) * constants::LcdWidth) + r.x + col) * 2
+                      + (offset & 1);
+
+        uint32_t row_bytes = (r.w - col) * 2 - (offset & 1);
+        if (row_bytes > len) row_bytes = len;
+
+        memcpy(dest, src, row_bytes);
+        src += row_bytes;
+        offset += row_bytes;
+        len -= row_bytes;
+    }
+}
+
+void DisplayManager::fillTaskData(DrawTask& task, uint8_t pixel_lsb, uint8_t pixel_msb, uint32_t len) {
+    const Rect& r = task.region;
+    uint32_t offset = task.bytes_received;
+    task.bytes_received += len;
+
+    if (task.scale2x) {
+        uint32_t src_w = r.w >> 1;
+        while (len-- > 0) {
+            uint32_t pixel = offset >> 1;
+            uint32_t row = pixel / src_w;
+            uint32_t col = pixel % src_w;
+            uint8_t* dest = m_full_framebuffer.data()
+                          + (((r.y + row * 2) * constants::LcdWidth) + r.x + col * 2) * 2
+                          + (offset & 1);
+            uint8_t v = (offset & 1) ? pixel_msb : pixel_lsb;
+            dest[0] = v;
+            dest[2] = v;
+            dest[constants::LcdWidth * 2] = v;
+            dest[constants::LcdWidth * 2 + 2] = v;
+            offset++;
+        }
+        return;
+    }
+
+    while (len > 0) {
+        uint32_t pixel = offset >> 1;
+        uint32_t row = pixel / r.w;
+        uint32_t col = pixel % r.w;
+        uint8_t* dest = m_full_framebuffer.data()
+                      + (((r.y + row) * constants::LcdWidth) + r.x + col) * 2
+                      + (offset & 1);
+
+        uint32_t row_bytes = (r.w - col) * 2 - (offset & 1);
+        if (row_bytes > len) row_bytes = len;
+
+        for (uint32_t i = 0; i < row_bytes; i++) {
+            dest[i] = ((offset + i) & 1) ? pixel_msb : pixel_lsb;
+        }
+        offset += row_bytes;
+        len -= row_bytes;
+    }
+}
+
+void DisplayManager::finalizeTask(DrawTask& task) {
+    // Corrupted payload bytes are already merged into the resident frame
+    // by this point; the retransmitted rect the NACK provokes overwrites
+    // exactly those pixels, so nothing stale survives past one round trip.
+    if (task.crc_check && !crcPassed(task)) {
+        failIntegrity(task);
+        return;
+    }
+    // Verification pass (VERIFY_MODE): checksum the region as it now
+    // stands in the resident frame, i.e. exactly what the decoder
+    // produced. Fills are skipped; they have no decode to verify.
+    if (m_verify_mode && !task.is_fill) {
+        pushVerifyEcho(task);
+    }
+    // The delta is already merged into the resident frame; the slot can be
+    // reused immediately and the next refresh pass streams the whole frame.
+    // For the latency probe, the rect only reaches the panel with the next
+    // frame blit, so park it until that blit's completion ISR.
+    if (m_latency_probe &&
+        static_cast<uint8_t>(m_inflight_head - m_inflight_tail) < m_inflight.size()) {
+        m_inflight[m_inflight_head % m_inflight.size()] =
+            {task.sequence_number, task.enqueue_cycles};
+        m_inflight_head = static_cast<uint8_t>(m_inflight_head + 1);
+    }
+    task.state = BufferState::EMPTY;
+    m_frame_dirty = true;
+    m_expected_sequence_num++;
+}
+
+void DisplayManager::stageOverlayBlit() {
+    // One pass of the RESTORE -> DRAW chain; the caller holds off while
+    // a blit is in flight, so each pass owns the SPI bus. RESTORE
+    // repaints the previously painted cursor rect straight from the
+    // resident frame (which never contains the cursor); DRAW composites
+    // the bitmap over the frame pixels at the current position, treating
+    // key-colored pixels as transparent. A move is thus two small blits
+    // and zero USB payload.
+    const bool restore = (m_overlay_stage == OverlayStage::RESTORE);
+    const Rect r = restore
+        ? m_overlay_prev
+        : Rect{m_overlay_x, m_overlay_y, m_overlay_w, m_overlay_h};
+    // Advance the chain before the early-outs so a clipped-away pass
+    // still hands over to the next one. DRAW waits for a complete
+    // bitmap: compositing a half-uploaded one would paint garbage.
+    m_overlay_stage = (restore && m_overlay_visible &&
+                       m_overlay_upload_expected == 0)
+        ? OverlayStage::DRAW : OverlayStage::NONE;
+
+    uint32_t w = r.w;
+    uint32_t h = r.h;
+    if (r.x + w > constants::LcdWidth)  w = constants::LcdWidth - r.x;
+    if (r.y + h > constants::LcdHeight) h = constants::LcdHeight - r.y;
+    if (w == 0 || h == 0) return;
+
+    uint8_t* dst = m_overlay_scratch.data();
+    for (uint32_t row = 0; row < h; row++) {
+        const uint8_t* fb = m_full_framebuffer.data()
+                          + (((r.y + row) * constants::LcdWidth) + r.x) * 2;
+        if (restore) {
+            memcpy(dst, fb, w * 2);
+            dst += w * 2;
+            continue;
+        }
+        const uint8_t* ovl = m_overlay_pixels.data()
+                           + row * static_cast<uint32_t>(m_overlay_w) * 2;
+        for (uint32_t col = 0; col < w; col++) {
+            uint16_t pixel = static_cast<uint16_t>(ovl[col * 2] |
+                                                   (ovl[col * 2 + 1] << 8));
+            const uint8_t* src = (pixel == m_overlay_key) ? &fb[col * 2]
+                                                          : &ovl[col * 2];
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst += 2;
+        }
+    }
+    if (!restore) {
+        m_overlay_prev = {r.x, r.y, static_cast<uint8_t>(w),
+                          static_cast<uint8_t>(h)};
+    }
+    lcd_write_u16(r.x, r.y, w, h, m_overlay_scratch.data());
+}
+
+#else
+
+void DisplayManager::writeTaskData(DrawTask& task, const uint8_t* src, uint32_t len) {
+    if (task.scale2x) {
+        // Pixel-doubled rect: expand into the slot at panel scale as the
+        // quarter-resolution payload arrives, so the blit path sees an
+        // ordinary region.w x region.h rect. Byte-wise, since packet
+        // boundaries may split a pixel.
+        const Rect& r = task.region;
+        uint32_t src_w = r.w >> 1;
+        uint32_t stride = static_cast<uint32_t>(r.w) * 2;
+        uint32_t offset = task.bytes_received;
+        task.bytes_received += len;
+        uint8_t* fb = m_framebuffers[m_usb_head_idx].data();
+        while (len-- > 0) {
+            uint32_t pixel = offset >> 1;
+            uint32_t row = pixel / src_w;
+            uint32_t col = pixel % src_w;
+            uint8_t* dest = fb + (row * 2) * stride + col * 4 + (offset & 1);
+            uint8_t v = *src++;
+            dest[0] = v;
+            dest[2] = v;
+            dest[stride] = v;
+            dest[stride + 2] = v;
+            offset++;
+        }
+        return;
+    }
+    memcpy(m_framebuffers[m_usb_head_idx].data() + task.bytes_received, src, len);
+    task.bytes_received += len;
+}
+
+void DisplayManager::fillTaskData(DrawTask& task, uint8_t pixel_lsb, uint8_t pixel_msb, uint32_t len) {
+    if (task.scale2x) {
+        const Rect& r = task.region;
+        uint32_t src_w = r.w >> 1;
+        uint32_t stride = static_cast<uint32_t>(r.w) * 2;
+        uint32_t offset = task.bytes_received;
+        task.bytes_received += len;
+        uint8_t* fb = m_framebuffers[m_usb_head_idx].data();
+        while (len-- > 0) {
+            uint32_t pixel = offset >> 1;
+            uint32_t row = pixel / src_w;
+            uint32_t col = pixel % src_w;
+            uint8_t* dest = fb + (row * 2) * stride + col * 4 + (offset & 1);
+            uint8_t v = (offset & 1) ? pixel_msb : pixel_lsb;
+            dest[0] = v;
+            dest[2] = v;
+            dest[stride] = v;
+            dest[stride + 2] = v;
+            offset++;
+        }
+        return;
+    }
+    uint8_t* dest = m_framebuffers[m_usb_head_idx].data() + task.bytes_received;
+    for (uint32_t i = 0; i < len; i += 2) {
+        dest[i]     = pixel_lsb;
+        dest[i + 1] = pixel_msb;
+    }
+    task.bytes_received += len;
+}
+
+void DisplayManager::finalizeTask(DrawTask& task) {
+    // Drop the slot before it becomes visible to the DMA side; the NACK
+    // latched here gets the host to resend the rect.
+    if (task.crc_check && !crcPassed(task)) {
+        failIntegrity(task);
+        return;
+    }
+    // Verification pass (VERIFY_MODE): checksum the decoded slot contents
+    // while m_usb_head_idx still names this slot. Fills carry no pixels
+    // and flash-direct asset blits never decoded anything; skip both.
+    if (m_verify_mode && !task.is_fill && task.ext_pixels == nullptr) {
+        pushVerifyEcho(task);
+    }
+    const uint8_t slot = m_usb_head_idx;
+    if (m_list_open) m_held_mask |= (1U << slot);
+    task.state = BufferState::READY_TO_DRAW;
+    m_usb_head_idx = (m_usb_head_idx + 1) % constants::NumBuffers;
+    m_expected_sequence_num++;
+    // Ring-occupancy high water, for tuning the DISPLAY_NUM_BUFFERS /
+    // DISPLAY_BUFFER_SIZE geometry against a real workload.
+    uint8_t used = static_cast<uint8_t>(
+        (m_usb_head_idx + constants::NumBuffers - m_dma_tail_idx) % constants::NumBuffers);
+    if (used > m_stats.slots_peak) m_stats.slots_peak = used;
+    // A list that outgrows the ring would deadlock it: held slots never
+    // drain, so no slot ever frees for the rest of the list. Commit what
+    // fit instead -- partial atomicity beats a stalled pipeline -- and
+    // let the host learn the real limit from GET_CAPS (NumBuffers).
+    if (((m_held_mask >> slot) & 1U) != 0U &&
+        ((m_usb_head_idx + 1) % constants::NumBuffers) == m_dma_tail_idx) {
+        commitDisplayList();
+    }
+}
+
+#endif // DISPLAY_FULL_FRAME
+
+bool DisplayManager::queueFillRect(const Rect& r, uint16_t seq, uint8_t color_lsb, uint8_t color_msb) {
+    uint8_t next_head = (m_usb_head_idx + 1) % constants::NumBuffers;
+    if (next_head == m_dma_tail_idx) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, static_cast<uint8_t>(HostCommand::FILL_RECT)); return false; } // Buffers are full
+
+    DrawTask& task = m_draw_tasks[m_usb_head_idx];
+    if (task.state != BufferState::EMPTY) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, static_cast<uint8_t>(HostCommand::FILL_RECT)); return false; } // Head not ready
+
+    noteSequence(seq);
+
+    // Invalid geometry consumes the sequence number but queues nothing.
+    if (r.w == 0 || r.h == 0) return true;
+    if ((r.x + r.w) > constants::LcdWidth || (r.y + r.h) > constants::LcdHeight) return true;
+
+    task.region = r;
+    task.sequence_number = seq;
+    task.enqueue_cycles = read_csr(mcycle);
+    task.crc_check = false;
+    task.scale2x = false;
+    task.bytes_received = 0;
+    task.total_bytes_expected = static_cast<uint32_t>(r.w) * static_cast<uint32_t>(r.h) * 2;
+    task.is_fill = true; // no decode step: the verification pass skips fills
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Merge the fill into the resident frame right away.
+    fillTaskData(task, color_lsb, color_msb, task.total_bytes_expected);
+#else
+    // No framebuffer slot is consumed: the fill is executed by a
+    // repeated-halfword DMA straight from the task metadata.
+    task.fill_color = static_cast<uint16_t>(color_lsb | (color_msb << 8));
+#endif
+    finalizeTask(task);
+    return true;
+}
+
+void DisplayManager::noteSequence(uint16_t seq) {
+    if (seq == m_expected_sequence_num) return;
+
+    // A forward jump means the updates in between never arrived (USB FS
+    // drops the odd packet under MSC load). Latch the lost range so the
+    // host can retransmit just those updates instead of restarting the
+    // stream; a second gap before the report goes out widens the range.
+    // A backward jump is the host itself resyncing and is not an error.
+    uint16_t gap = static_cast<uint16_t>(seq - m_expected_sequence_num);
+    if (gap < 0x8000) {
+        if (!m_nack_pending) {
+            m_nack_first = m_expected_sequence_num;
+        }
+        m_nack_last = static_cast<uint16_t>(seq - 1);
+        m_nack_pending = true;
+    }
+    m_expected_sequence_num = seq; // Resync
+}
+
+void DisplayManager::crcFeed(DrawTask& task, const uint8_t* src, uint32_t len) {
+    // Feed the hardware CRC unit during reception. Words are assembled
+    // little-endian byte by byte (RV32 traps on misaligned loads, and
+    // packet boundaries need not be word-aligned); the unit itself
+    // digests each word in a few cycles, so the whole pass costs a
+    // fraction of the memcpy it rides behind.
+    uint32_t word = task.crc_word;
+    uint8_t word_len = task.crc_word_len;
+    while (len--) {
+        word |= static_cast<uint32_t>(*src++) << (8U * word_len);
+        if (++word_len == 4U) {
+            crc_single_data_calculate(word);
+            word = 0;
+            word_len = 0;
+        }
+    }
+    task.crc_word = word;
+    task.crc_word_len = word_len;
+}
+
+bool DisplayManager::crcPassed(DrawTask& task) {
+    // A payload that is not a word multiple is zero-padded, exactly as
+    // the host pads before computing the announced value.
+    if (task.crc_word_len != 0) {
+        crc_single_data_calculate(task.crc_word);
+    }
+    task.crc_check = false;
+    return crc_data_register_read() == task.crc_expected;
+}
+
+void DisplayManager::failIntegrity(DrawTask& task) {
+    // Retire the corrupted rect into the NACK path: the host retransmits
+    // it like a lost sequence. crc_failures vs. a clean NACK is the
+    // corruption-vs-drop distinction this feature exists for.
+    m_stats.crc_failures++;
+    evt::note(TRACE_DISP_CRC_FAIL, task.sequence_number);
+    if (!m_nack_pending) {
+        m_nack_first = task.sequence_number;
+    }
+    m_nack_last = task.sequence_number;
+    m_nack_pending = true;
+    task.state = BufferState::EMPTY;
+    task.ext_pixels = nullptr;
+    m_expected_sequence_num++;
+}
+
+uint8_t DisplayManager::freeSlots() const {
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Updates merge into the resident frame on arrival and free their
+    // slot immediately; the ring only blocks while the head task is
+    // mid-stream.
+    return (m_draw_tasks[m_usb_head_idx].state == BufferState::EMPTY)
+               ? static_cast<uint8_t>(constants::NumBuffers - 1) : 0;
+#else
+    // Mirrors the admission check in DRAW_RECT: the head may advance
+    // until next_head == tail, so one ring slot is always unusable.
+    uint8_t used = static_cast<uint8_t>(
+        (m_usb_head_idx + constants::NumBuffers - m_dma_tail_idx) % constants::NumBuffers);
+    return static_cast<uint8_t>(constants::NumBuffers - 1 - used);
+#endif
+}
+
+void DisplayManager::commitDisplayList() {
+    // Runs in ISR context (LIST_COMMIT, or the ring-full guard). Only
+    // flags move here; the DRAW event the command packet already posted
+    // gets processDrawTasks to pick the released list up.
+    m_list_open = false;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Nothing per-slot to release: list elements merged into the resident
+    // frame on arrival and only the repaint was being deferred.
+#else
+    m_held_mask = 0;
+#endif
+}
+
+bool DisplayManager::sequenceNackPending(uint16_t& first, uint16_t& last) {
+    if (!m_nack_pending) return false;
+    first = m_nack_first;
+    last = m_nack_last;
+    return true;
+}
+
+void DisplayManager::clearSequenceNack() {
+    m_nack_pending = false;
+}
+
 void DisplayManager::handleUsbPacket(const uint8_t* data, uint32_t len) {
     if (len < 1) return; // Must have at least a command byte
+    m_stats.packets_received++;
+    events::post(events::DRAW);
+
+    // Any traffic that is not a heartbeat unparks an idle pipeline
+    // (IDLE_HINT below), so wake latency is bounded by the one packet
+    // that carried the work.
+    if (m_idle_parked &&
+        data[0] != static_cast<uint8_t>(HostCommand::IDLE_HINT)) {
+        m_idle_parked = false;
+        events::post(events::USB);
+    }
+
+    // While a raw stream is active every OUT packet is headerless pixel
+    // payload (this is what allows zero-copy reception; see
+    // zeroCopyRxTarget). Packets that still arrive through the bounce
+    // buffer, e.g. the tail of a slot, are copied here.
+    DrawTask& head_task = m_draw_tasks[m_usb_head_idx];
+    if (head_task.state == BufferState::RECEIVING && head_task.raw_stream) {
+        uint32_t data_len = len;
+        if ((head_task.bytes_received + data_len) > head_task.total_bytes_expected) {
+            data_len = head_task.total_bytes_expected - head_task.bytes_received;
+        }
+        writeTaskData(head_task, data, data_len);
+        if (head_task.crc_check) crcFeed(head_task, data, data_len);
+        if (head_task.bytes_received >= head_task.total_bytes_expected) {
+            finalizeTask(head_task);
+        }
+        return;
+    }
+
+    // Single-header encoded streams: the DRAW_RECT header announced the
+    // encoded wire length, so these packets are headerless too and get
+    // decoded here instead of through a per-packet command byte.
+    if (head_task.state == BufferState::RECEIVING &&
+        head_task.stream_bytes_expected != 0) {
+        consumeStreamPacket(head_task, data, len);
+        return;
+    }
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Overlay bitmap upload in progress (OVERLAY_SET): headerless pixel
+    // payload, like the streams above but into the plane's own buffer.
+    if (m_overlay_upload_expected != 0) {
+        uint32_t take = len;
+        if ((m_overlay_upload_bytes + take) > m_overlay_upload_expected) {
+            take = m_overlay_upload_expected - m_overlay_upload_bytes;
+        }
+        memcpy(m_overlay_pixels.data() + m_overlay_upload_bytes, data, take);
+        m_overlay_upload_bytes += take;
+        if (m_overlay_upload_bytes >= m_overlay_upload_expected) {
+            m_overlay_upload_expected = 0;
+            // A replaced bitmap under a visible cursor repaints in place.
+            if (m_overlay_visible && m_overlay_stage == OverlayStage::NONE) {
+                m_overlay_stage = OverlayStage::DRAW;
+            }
+        }
+        return;
+    }
+#endif
 
     // The data buffer STARTS with the command byte (data[0]).
     const auto command = static_cast<HostCommand>(data[0]);
 
     switch (command) {
         case HostCommand::DRAW_RECT: {
-            // Packet format received: [CMD, x, y, w, h, seq_lsb, seq_msb]
+            // Packet format received: [CMD, x, y, w, h, seq_lsb, seq_msb, encoding]
             if (len < 7) return;
 
             uint8_t next_head = (m_usb_head_idx + 1) % constants::NumBuffers;
-            if (next_head == m_dma_tail_idx) return; // Buffers are full
+            if (next_head == m_dma_tail_idx) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Buffers are full
 
             DrawTask& task = m_draw_tasks[m_usb_head_idx];
-            if (task.state != BufferState::EMPTY) return; // Head not ready
+            if (task.state != BufferState::EMPTY) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Head not ready
 
             // Parameters start at index 1, immediately after the command.
             Rect r = {data[1], data[2], data[3], data[4]};
             uint16_t seq = data[5] | (data[6] << 8);
 
-            if (seq != m_expected_sequence_num) {
-                m_expected_sequence_num = seq; // Resync
-            }
+            noteSequence(seq);
 
             uint32_t total_bytes = static_cast<uint32_t>(r.w) * static_cast<uint32_t>(r.h) * 2;
-            if (total_bytes > constants::BufferSizeBytes || total_bytes == 0) return;
+
+            // Header flags byte (padding reads as 0 on older hosts). Bit 1
+            // marks a pixel-doubled rect: the header geometry and payload
+            // are quarter-resolution, the panel rect is twice as large in
+            // both axes, and each source pixel lands as a 2x2 block.
+            const uint8_t flags = (len >= 11) ? data[10] : 0;
+            const bool scale2x = (flags & 0x02) != 0;
+            if (scale2x) {
+                // Bounds-check the source geometry before doubling it --
+                // a hostile rect would wrap the uint8_t fields otherwise.
+                if ((static_cast<uint32_t>(r.x) + r.w) * 2 > constants::LcdWidth ||
+                    (static_cast<uint32_t>(r.y) + r.h) * 2 > constants::LcdHeight) return;
+                r = {static_cast<uint8_t>(r.x * 2), static_cast<uint8_t>(r.y * 2),
+                     static_cast<uint8_t>(r.w * 2), static_cast<uint8_t>(r.h * 2)};
+            }
+            // Staging capacity is paid at panel scale: a doubled rect
+            // expands fourfold on its way into the frame or slot.
+            uint32_t staged_bytes = scale2x ? total_bytes * 4 : total_bytes;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+            // Deltas are applied in place, so a rect may cover the whole
+            // frame -- but it must lie entirely inside it.
+            if (staged_bytes > constants::FullFrameBytes || total_bytes == 0) return;
+            if ((r.x + r.w) > constants::LcdWidth || (r.y + r.h) > constants::LcdHeight) return;
+#else
+            if (staged_bytes > constants::BufferSizeBytes || total_bytes == 0) return;
+#endif
 
             task.state = BufferState::RECEIVING;
+            task.scale2x = scale2x;
             task.region = r;
             task.bytes_received = 0;
             task.total_bytes_expected = total_bytes;
             task.sequence_number = seq;
+            task.enqueue_cycles = read_csr(mcycle);
+            task.is_fill = false;
+            // Encoding byte: 0 = raw headerless stream, 1 = RLE records,
+            // 2 = palette indices, 3 = delta spans against the resident
+            // frame (full-frame builds only; advertised via GET_CAPS).
+            task.encoding = (len < 8) ? 0 : data[7];
+            task.raw_stream = (task.encoding == 0);
+            // A caps-aware host (see GET_CAPS) announces the encoded wire
+            // length of the whole payload here; the following packets are
+            // then headerless for every encoding, not just raw streams, so
+            // no payload byte is lost to per-packet command bytes.
+            task.stream_bytes_expected =
+                (len < 10) ? 0 : static_cast<uint32_t>(data[8] | (data[9] << 8));
+            task.stream_bytes_received = 0;
+            task.carry_len = 0;
+            task.delta_run_bytes = 0;
+            // Optional integrity trailer (GET_CAPS bit 4): flags byte at
+            // [10], bit 0 marks a CRC32 over the headerless payload at
+            // [11..14]. Only streamed payloads carry one -- per-packet
+            // command-byte encodings have no exact payload byte count to
+            // close the digest over.
+            task.crc_check = false;
+            if (len >= 15 && (flags & 0x01) &&
+                (task.raw_stream || task.stream_bytes_expected != 0)) {
+                task.crc_check = true;
+                task.crc_expected = static_cast<uint32_t>(data[11]) |
+                                    (static_cast<uint32_t>(data[12]) << 8) |
+                                    (static_cast<uint32_t>(data[13]) << 16) |
+                                    (static_cast<uint32_t>(data[14]) << 24);
+                task.crc_word = 0;
+                task.crc_word_len = 0;
+                rcu_periph_clock_enable(RCU_CRC);
+                crc_data_register_reset();
+            }
+            // Delta streams patch pixels the host skipped, so they need a
+            // resident frame underneath and the announced stream length.
+            // A caps-aware host never sends them otherwise; drop the rect
+            // defensively if one does.
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+            if (task.encoding == 3 && task.stream_bytes_expected == 0) {
+                task.state = BufferState::EMPTY;
+            }
+#else
+            if (task.encoding == 3) {
+                task.state = BufferState::EMPTY;
+            }
+#endif
+            break;
+        }
+
+        case HostCommand::FILL_RECT: {
+            // Packet format received: [CMD, x, y, w, h, seq_lsb, seq_msb, color_lsb, color_msb]
+            if (len < 9) return;
+
+            Rect r = {data[1], data[2], data[3], data[4]};
+            uint16_t seq = static_cast<uint16_t>(data[5] | (data[6] << 8));
+            queueFillRect(r, seq, data[7], data[8]);
+            break;
+        }
+
+        case HostCommand::MULTI_FILL: {
+            // Packet format received: [CMD, count, seq_lsb, seq_msb] followed
+            // by count 6-byte records [x, y, w, h, color_lsb, color_msb].
+            // Sequence numbers are consecutive from seq; the host packs runs
+            // of small solid rects this way so a widget-heavy frame costs one
+            // wire packet instead of one per rect.
+            if (len < 4) return;
+            uint32_t count = data[1];
+            if (len < 4 + count * 6) return;
+            uint16_t seq = static_cast<uint16_t>(data[2] | (data[3] << 8));
+
+            const uint8_t* rec = data + 4;
+            for (uint32_t i = 0; i < count; i++, rec += 6) {
+                Rect r = {rec[0], rec[1], rec[2], rec[3]};
+                if (!queueFillRect(r, static_cast<uint16_t>(seq + i), rec[4], rec[5])) {
+                    // Out of slots: stop here and let the sequence gap NACK
+                    // the remainder of the batch back to the host.
+                    break;
+                }
+            }
+            break;
+        }
+
+        case HostCommand::DRAW_TEXT: {
+            // Packet format received:
+            // [CMD, x, y, font, fg_lsb, fg_msb, bg_lsb, bg_msb, seq_lsb, seq_msb, count, chars...]
+            // The text is rendered on-device from the baked lcd_font tables,
+            // so a label update costs one packet instead of kilobytes of
+            // pixel data.
+            if (len < 12) return;
+
+            uint8_t next_head = (m_usb_head_idx + 1) % constants::NumBuffers;
+            if (next_head == m_dma_tail_idx) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Buffers are full
+
+            DrawTask& task = m_draw_tasks[m_usb_head_idx];
+            if (task.state != BufferState::EMPTY) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Head not ready
+
+            uint16_t fg = static_cast<uint16_t>(data[4] | (data[5] << 8));
+            uint16_t bg = static_cast<uint16_t>(data[6] | (data[7] << 8));
+            uint16_t seq = data[8] | (data[9] << 8);
+            uint32_t count = data[10];
+            if (count == 0 || count > (len - 11)) return;
+
+            noteSequence(seq);
+
+            const char* text = reinterpret_cast<const char*>(&data[11]);
+
+            // Font id 2 selects the proportional UI font; it goes through
+            // the lcd_text glyph cache, so repeated label redraws skip the
+            // 1-bpp expansion entirely. Ids 0/1 stay on the fixed-cell fonts.
+            const bool proportional = (data[3] == 2);
+            const lcd_font* font = (data[3] == 1) ? &lcd_font_16x24 : &lcd_font_8x16;
+            uint32_t text_w, text_h;
+            if (proportional) {
+                text_w = lcd_font_prop_text_width(&font_ubuntu_16, text, count);
+                text_h = font_ubuntu_16.line_height;
+            } else {
+                text_w = count * font->width;
+                text_h = font->height;
+            }
+            if (text_w == 0) return;
+
+            uint32_t total_bytes = text_w * text_h * 2;
+            if ((data[1] + text_w) > constants::LcdWidth ||
+                (data[2] + text_h) > constants::LcdHeight) return;
+
+            task.region = {data[1], data[2],
+                           static_cast<uint8_t>(text_w),
+                           static_cast<uint8_t>(text_h)};
+            task.sequence_number = seq;
+            task.enqueue_cycles = read_csr(mcycle);
+            task.bytes_received = total_bytes;
+            task.total_bytes_expected = total_bytes;
+            task.is_fill = false;
+            task.crc_check = false;
+            task.scale2x = false;
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+            // Render straight into the resident frame at the target position.
+            uint8_t* dst = m_full_framebuffer.data()
+                + ((data[2] * constants::LcdWidth) + data[1]) * 2;
+            int stride = constants::LcdWidth * 2;
+#else
+            if (total_bytes > constants::BufferSizeBytes) return;
+            // Render into the head slot; it then flows through the normal
+            // scatter-gather blit path like any received rect.
+            uint8_t* dst = m_framebuffers[m_usb_head_idx].data();
+            int stride = text_w * 2;
+#endif
+            if (proportional) {
+                lcd_text_render(&font_ubuntu_16, dst, stride, text, count, fg, bg);
+            } else {
+                lcd_font_render(font, dst, stride, text, count, fg, bg);
+            }
+            finalizeTask(task);
             break;
         }
 
@@ -63,36 +877,688 @@ void DisplayManager::handleUsbPacket(const uint8_t* data, uint32_t len) {
             }
 
             // Pixel data starts at index 1, after the command.
-            uint8_t* dest_ptr = m_framebuffers[m_usb_head_idx].data() + task.bytes_received;
-            memcpy(dest_ptr, &data[1], data_len);
-            task.bytes_received += data_len;
+            writeTaskData(task, &data[1], data_len);
+
+            if (task.bytes_received >= task.total_bytes_expected) {
+                finalizeTask(task);
+            }
+            break;
+        }
+
+        case HostCommand::IMAGE_DATA_RLE: {
+            DrawTask& task = m_draw_tasks[m_usb_head_idx];
+            if (task.state != BufferState::RECEIVING) return;
+
+            // Payload is a list of 3-byte runs: [count, pixel_lsb, pixel_msb].
+            // Runs are never split across packets; a count of 0 marks padding.
+            const uint8_t* run_ptr = &data[1];
+            uint32_t remaining = len - 1;
+
+            while (remaining >= 3) {
+                uint32_t run_pixels = run_ptr[0];
+                if (run_pixels == 0) break; // End-of-packet padding
+
+                uint32_t run_bytes = run_pixels * 2;
+                if ((task.bytes_received + run_bytes) > task.total_bytes_expected) {
+                    run_bytes = task.total_bytes_expected - task.bytes_received;
+                }
+
+                fillTaskData(task, run_ptr[1], run_ptr[2], run_bytes);
+
+                run_ptr += 3;
+                remaining -= 3;
+            }
 
             if (task.bytes_received >= task.total_bytes_expected) {
-                task.state = BufferState::READY_TO_DRAW;
-                m_usb_head_idx = (m_usb_head_idx + 1) % constants::NumBuffers;
-                m_expected_sequence_num++;
+                finalizeTask(task);
             }
             break;
         }
+        case HostCommand::SET_PALETTE: {
+            // Packet format received: [CMD, start, count, count * (lsb, msb)]
+            // The palette persists across rects, so the host only uploads
+            // entries it has not used before.
+            if (len < 3) return;
+            uint32_t start = data[1];
+            uint32_t count = data[2];
+            if ((start + count) > m_palette.size() || len < (3 + count * 2)) return;
+
+            for (uint32_t i = 0; i < count; i++) {
+                m_palette[start + i] =
+                    static_cast<uint16_t>(data[3 + i * 2] | (data[4 + i * 2] << 8));
+            }
+            break;
+        }
+
+        case HostCommand::IMAGE_DATA_IDX: {
+            DrawTask& task = m_draw_tasks[m_usb_head_idx];
+            if (task.state != BufferState::RECEIVING) return;
+
+            // Each payload byte is a palette index. Expand to RGB565 into a
+            // scratch buffer first so the normal payload writer handles the
+            // destination (slot or resident frame) uniformly.
+            uint32_t count = len - 1;
+            uint32_t room = (task.total_bytes_expected - task.bytes_received) / 2;
+            if (count > room) count = room;
+
+            uint8_t expanded[2 * 63];
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t pixel = m_palette[data[1 + i]];
+                expanded[i * 2]     = static_cast<uint8_t>(pixel & 0xFF);
+                expanded[i * 2 + 1] = static_cast<uint8_t>(pixel >> 8);
+            }
+            writeTaskData(task, expanded, count * 2);
+
+            if (task.bytes_received >= task.total_bytes_expected) {
+                finalizeTask(task);
+            }
+            break;
+        }
+
+        case HostCommand::GET_STATS:
+            // The counters are sent from the main loop (see main.cpp); the
+            // IN report path must not be driven from the USB ISR.
+            m_stats_requested = true;
+            break;
+
+        case HostCommand::GET_TRACE:
+            // Like GET_STATS: only latch here; the main loop owns the IN
+            // report path and drains the trace ring from there.
+            m_trace_requested = true;
+            break;
+
+        case HostCommand::GET_CRASH:
+            // Like GET_STATS: latch only; the main loop streams the
+            // postmortem record from the previous session, if any.
+            m_crash_requested = true;
+            break;
+
+        case HostCommand::SET_SCROLL: {
+            // Packet format received: [CMD, x, w, offset, seq_lsb, seq_msb].
+            // Declares [x, x+w) as the hardware scroll window and shifts
+            // its displayed content by offset pixels (ST7735S VSCSAD);
+            // frame memory is untouched, so a ticker step costs this one
+            // packet plus the newly revealed column strip. Applied from
+            // the main loop: the scroll registers share the SPI bus with
+            // the blit DMA.
+            if (len < 6) return;
+            uint8_t x = data[1];
+            uint8_t w = data[2];
+            uint8_t offset = data[3];
+            uint16_t seq = static_cast<uint16_t>(data[4] | (data[5] << 8));
+
+            noteSequence(seq);
+
+            if (w == 0 || (x + w) > constants::LcdWidth || offset >= w) return;
+            m_scroll_x = x;
+            m_scroll_w = w;
+            m_scroll_offset = offset;
+            m_scroll_pending = true;
+            break;
+        }
+
+        case HostCommand::GET_CAPS:
+            // Like GET_STATS: latch only; the main loop reports the buffer
+            // geometry so the host sizes transfers to what this build has.
+            m_caps_requested = true;
+            break;
+
+        case HostCommand::GET_BOOT:
+            // Like GET_STATS: latch only; the main loop reports the boot
+            // stage timestamps retained by bootmark.
+            m_boot_requested = true;
+            break;
+
+        case HostCommand::GET_BUILD:
+            // Like GET_STATS: latch only; the main loop reports the
+            // compile-time identity from the generated buildinfo.h.
+            m_build_requested = true;
+            break;
+
+        case HostCommand::GET_ASSETS:
+            // Like GET_STATS: latch only; the main loop answers with the
+            // asset-store directory and upload state (status report 0x09).
+            assets::requestInfo();
+            break;
+
+        case HostCommand::ASSET_BEGIN: {
+            // Packet format received: [CMD, flags, id, ver_lsb, ver_msb, w, h].
+            // flags bit0 wipes the whole store first. Only latched here:
+            // page erases and word programming stall instruction fetch
+            // from flash, so all FMC work runs from the main loop
+            // (assets::poll) and the host paces itself via GET_ASSETS.
+            if (len < 7) return;
+            assets::beginUpload(data[2],
+                                static_cast<uint16_t>(data[3] | (data[4] << 8)),
+                                data[5], data[6], (data[1] & 0x01) != 0);
+            break;
+        }
+
+        case HostCommand::ASSET_DATA: {
+            // Packet format received: [CMD, count, payload...]. The bytes
+            // stage in a small ring that assets::poll programs into flash.
+            if (len < 2) return;
+            uint32_t count = data[1];
+            if (count > (len - 2)) count = len - 2;
+            assets::stageData(&data[2], count);
+            break;
+        }
+
+        case HostCommand::GET_FWINFO:
+            // Like GET_ASSETS: latch only; the main loop answers with the
+            // image CRC and delta-update state (status report 0x0D).
+            fwup::requestInfo();
+            break;
+
+        case HostCommand::FW_BEGIN: {
+            // Packet format received: [CMD, base_crc u32 LE, target_crc
+            // u32 LE]. Only latched here: the base-CRC check and every
+            // FMC operation run from the main loop (fwup::poll), for the
+            // same fetch-stall reason as the asset store.
+            if (len < 9) return;
+            fwup::begin(static_cast<uint32_t>(data[1]) | (static_cast<uint32_t>(data[2]) << 8)
+                            | (static_cast<uint32_t>(data[3]) << 16) | (static_cast<uint32_t>(data[4]) << 24),
+                        static_cast<uint32_t>(data[5]) | (static_cast<uint32_t>(data[6]) << 8)
+                            | (static_cast<uint32_t>(data[7]) << 16) | (static_cast<uint32_t>(data[8]) << 24));
+            break;
+        }
+
+        case HostCommand::FW_DATA: {
+            // Packet format received: [CMD, count, payload...]. The bytes
+            // stage in a small ring that fwup::poll patches into flash.
+            if (len < 2) return;
+            uint32_t count = data[1];
+            if (count > (len - 2)) count = len - 2;
+            fwup::stageData(&data[2], count);
+            break;
+        }
+
+        case HostCommand::FW_APPLY:
+            // Latch only: the final page flush and target-CRC pass run
+            // from fwup::poll once the staging ring drains.
+            fwup::apply();
+            break;
+
+        case HostCommand::DRAW_ASSET: {
+            // Packet format received: [CMD, id, x, y, seq_lsb, seq_msb].
+            // Blits a stored asset (see asset_store.h): slot builds point
+            // the scatter-gather DMA straight at the memory-mapped flash
+            // pixels -- no SRAM copy exists anywhere on that path -- and
+            // full-frame builds merge them into the resident frame like
+            // any received payload.
+            if (len < 6) return;
+
+            uint8_t next_head = (m_usb_head_idx + 1) % constants::NumBuffers;
+            if (next_head == m_dma_tail_idx) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Buffers are full
+
+            DrawTask& task = m_draw_tasks[m_usb_head_idx];
+            if (task.state != BufferState::EMPTY) { m_stats.slots_dropped++; evt::note(TRACE_DISP_SLOT_DROP, data[0]); return; } // Head not ready
+
+            uint16_t seq = static_cast<uint16_t>(data[4] | (data[5] << 8));
+            noteSequence(seq);
+
+            // An unknown id or off-panel placement consumes the sequence
+            // number but queues nothing, like invalid fill geometry.
+            const assets::AssetHeader* asset = assets::find(data[1]);
+            if (asset == nullptr) return;
+            Rect r = {data[2], data[3], asset->width, asset->height};
+            if ((r.x + r.w) > constants::LcdWidth || (r.y + r.h) > constants::LcdHeight) return;
+
+            task.region = r;
+            task.sequence_number = seq;
+            task.enqueue_cycles = read_csr(mcycle);
+            task.total_bytes_expected = asset->length;
+            task.is_fill = false;
+            task.crc_check = false;
+            task.scale2x = false;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+            task.bytes_received = 0;
+            writeTaskData(task, assets::pixels(asset), asset->length);
+#else
+            task.bytes_received = asset->length;
+            task.ext_pixels = assets::pixels(asset);
+#endif
+            finalizeTask(task);
+            break;
+        }
+
+        case HostCommand::ANIM_PLAY: {
+            // Packet format received: [CMD, first_id, count, x, y,
+            // period_lsb, period_msb, seq_lsb, seq_msb]. Starts (or, with
+            // count = 0, stops) autonomous playback of the stored assets
+            // first_id..first_id+count-1; see serviceAnimation().
+            if (len < 9) return;
+            uint16_t seq = static_cast<uint16_t>(data[7] | (data[8] << 8));
+            noteSequence(seq);
+
+            uint8_t count = data[2];
+            if (count == 0) { m_anim_count = 0; return; }
+
+            // Every frame must exist with one shared geometry, placed
+            // on-panel; anything else consumes the sequence number but
+            // starts nothing, like invalid fill geometry.
+            const assets::AssetHeader* first = assets::find(data[1]);
+            if (first == nullptr) return;
+            for (uint8_t i = 1; i < count; i++) {
+                const assets::AssetHeader* f =
+                    assets::find(static_cast<uint8_t>(data[1] + i));
+                if (f == nullptr || f->width != first->width ||
+                    f->height != first->height) return;
+            }
+            if ((data[3] + first->width) > constants::LcdWidth ||
+                (data[4] + first->height) > constants::LcdHeight) return;
+
+            uint32_t period_ms = static_cast<uint32_t>(data[5] | (data[6] << 8));
+            if (period_ms < 16) period_ms = 16; // floor: the panel blit itself
+            m_anim_first = data[1];
+            m_anim_index = 0;
+            m_anim_x = data[3];
+            m_anim_y = data[4];
+            m_anim_period = static_cast<uint64_t>(period_ms) * 1000U *
+                            mtimer_ticks_per_us();
+            m_anim_deadline = 0; // first frame paints on the next pass
+            m_anim_count = count;
+            break;
+        }
+
+        case HostCommand::IDLE_HINT:
+            // Packet format received: [CMD, idle]. The host heartbeats
+            // this while its screen is static. Parked, the USBFS ISR
+            // stops fanning the 1 kHz SOF tick out to the deferred loop
+            // (gd32vf103_it.cpp), so the core stays in WFI between real
+            // events; HID input still flushes from the SOF ISR itself.
+            if (len >= 2) m_idle_parked = (data[1] != 0);
+            break;
+
+        case HostCommand::LIST_BEGIN:
+            // Packet format received: [CMD]. Opens a display list: every
+            // slot-consuming command that follows (fills, image and text
+            // rects, asset blits) finalizes held, and LIST_COMMIT
+            // releases the whole batch at once, so a multi-element update
+            // never reaches the panel half-drawn. The held list occupies
+            // ring slots while the previous list is still executing, so
+            // upload and execution overlap just like single rects do. A
+            // begin while a list is already open commits it first: the
+            // host lost the commit packet, and holding its elements any
+            // longer only delays them behind the new list.
+            if (m_list_open) commitDisplayList();
+            m_list_open = true;
+            break;
+
+        case HostCommand::LIST_COMMIT:
+            // Packet format received: [CMD]. See LIST_BEGIN.
+            commitDisplayList();
+            break;
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+        case HostCommand::OVERLAY_SET: {
+            // Packet format received: [CMD, w, h, key_lsb, key_msb],
+            // followed by w*h RGB565 pixels in headerless packets (see
+            // the upload branch above). Pixels equal to the key color
+            // composite as transparent; w = 0 drops the plane. Slot
+            // builds have no resident frame to restore occluded pixels
+            // from, so the command (and caps bit 7) exists only here.
+            if (len < 5) return;
+            uint8_t w = data[1];
+            uint8_t h = data[2];
+            if (w == 0 || h == 0) {
+                if (m_overlay_visible) {
+                    m_overlay_visible = false;
+                    m_overlay_stage = OverlayStage::RESTORE;
+                }
+                m_overlay_w = 0;
+                m_overlay_h = 0;
+                m_overlay_upload_expected = 0;
+                return;
+            }
+            if (w > wire::OverlayMaxW || h > wire::OverlayMaxH) return;
+            // Erase the old cursor while the new bitmap streams in; the
+            // chain holds DRAW back until the upload completes.
+            if (m_overlay_visible && m_overlay_stage == OverlayStage::NONE) {
+                m_overlay_stage = OverlayStage::RESTORE;
+            }
+            m_overlay_w = w;
+            m_overlay_h = h;
+            m_overlay_key = static_cast<uint16_t>(data[3] | (data[4] << 8));
+            m_overlay_upload_bytes = 0;
+            m_overlay_upload_expected =
+                static_cast<uint32_t>(w) * static_cast<uint32_t>(h) * 2;
+            break;
+        }
+
+        case HostCommand::OVERLAY_POS: {
+            // Packet format received: [CMD, x, y, visible, seq_lsb,
+            // seq_msb]. The whole point of the plane: a focus-highlight
+            // move is this one packet, and the device restores the
+            // pixels under the old position from the resident frame.
+            if (len < 6) return;
+            uint16_t seq = static_cast<uint16_t>(data[4] | (data[5] << 8));
+            noteSequence(seq);
+
+            // Off-panel placement consumes the sequence number but moves
+            // nothing, like invalid fill geometry.
+            if (data[1] >= constants::LcdWidth ||
+                data[2] >= constants::LcdHeight) return;
+            bool was_visible = m_overlay_visible;
+            m_overlay_x = data[1];
+            m_overlay_y = data[2];
+            m_overlay_visible = (data[3] != 0) && (m_overlay_w != 0);
+            if (was_visible) {
+                m_overlay_stage = OverlayStage::RESTORE; // chains to DRAW
+            } else if (m_overlay_visible) {
+                m_overlay_stage = OverlayStage::DRAW;
+            }
+            break;
+        }
+#endif
+
+        case HostCommand::LATENCY_PROBE:
+            // Packet format received: [CMD, enable]. Toggles per-rect
+            // completion echoes; enabling resets the echo ring so stale
+            // records cannot pair with a new run's sequence numbers.
+            if (len < 2) return;
+            m_echo_tail = m_echo_head;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+            m_inflight_tail = m_inflight_head;
+            m_inflight_mark = m_inflight_head;
+#endif
+            m_latency_probe = (data[1] != 0);
+            break;
+
+        case HostCommand::VERIFY_MODE:
+            // Packet format received: [CMD, enable]. Golden-image
+            // verification for regression rigs: toggles the per-rect
+            // decoded-region CRC echoes (see pushVerifyEcho); enabling
+            // resets the ring so stale records cannot pair with a new
+            // run's sequence numbers, like the latency probe above.
+            if (len < 2) return;
+            m_verify_tail = m_verify_head;
+            m_verify_mode = (data[1] != 0);
+            break;
+
         default:
             // This case handles any garbage data if synchronization is lost.
             break;
     }
 }
 
+void DisplayManager::consumeStreamPacket(DrawTask& task, const uint8_t* data, uint32_t len) {
+    // Anything past the announced encoded length is wire-packet padding.
+    if ((task.stream_bytes_received + len) > task.stream_bytes_expected) {
+        len = task.stream_bytes_expected - task.stream_bytes_received;
+    }
+    task.stream_bytes_received += len;
+    // The digest runs over the encoded wire bytes, before decode, so a
+    // corrupted record can't smear pixels first and pass afterwards.
+    if (task.crc_check) crcFeed(task, data, len);
+
+    if (task.encoding == 1) {
+        // RLE: 3-byte [count, pixel_lsb, pixel_msb] records. With no
+        // command byte re-framing each packet, records may straddle
+        // packet boundaries; partial ones wait in the carry buffer.
+        for (uint32_t i = 0; i < len; i++) {
+            if (task.carry_len < 2) {
+                task.carry[task.carry_len++] = data[i];
+                continue;
+            }
+            uint32_t run_bytes = static_cast<uint32_t>(task.carry[0]) * 2;
+            if ((task.bytes_received + run_bytes) > task.total_bytes_expected) {
+                run_bytes = task.total_bytes_expected - task.bytes_received;
+            }
+            fillTaskData(task, task.carry[1], data[i], run_bytes);
+            task.carry_len = 0;
+        }
+    } else if (task.encoding == 3) {
+        // Delta spans: repeated 2-byte [skip, copy] pixel-count headers,
+        // each followed by copy*2 bytes of pixels. Skipped pixels keep
+        // their value in the resident frame -- between consecutive frames
+        // most of a scanline is unchanged, so advancing the write offset
+        // past them is the whole trick. Headers straddle packets through
+        // the carry buffer like RLE records do.
+        uint32_t i = 0;
+        while (i < len) {
+            if (task.delta_run_bytes > 0) {
+                uint32_t chunk = len - i;
+                if (chunk > task.delta_run_bytes) chunk = task.delta_run_bytes;
+                uint32_t room = task.total_bytes_expected - task.bytes_received;
+                writeTaskData(task, &data[i], (chunk > room) ? room : chunk);
+                task.delta_run_bytes = static_cast<uint16_t>(task.delta_run_bytes - chunk);
+                i += chunk;
+                continue;
+            }
+            if (task.carry_len < 1) {
+                task.carry[task.carry_len++] = data[i++];
+                continue;
+            }
+            uint32_t skip_bytes = static_cast<uint32_t>(task.carry[0]) * 2;
+            uint32_t room = task.total_bytes_expected - task.bytes_received;
+            task.bytes_received += (skip_bytes > room) ? room : skip_bytes;
+            task.delta_run_bytes = static_cast<uint16_t>(data[i]) * 2;
+            task.carry_len = 0;
+            i++;
+        }
+    } else if (task.encoding == 2) {
+        // Palette indices: expand through the normal payload writer just
+        // like the per-packet path, only with the full packet as payload.
+        uint32_t count = len;
+        uint32_t room = (task.total_bytes_expected - task.bytes_received) / 2;
+        if (count > room) count = room;
+
+        uint8_t expanded[2 * 64];
+        for (uint32_t i = 0; i < count; i++) {
+            uint16_t pixel = m_palette[data[i]];
+            expanded[i * 2]     = static_cast<uint8_t>(pixel & 0xFF);
+            expanded[i * 2 + 1] = static_cast<uint8_t>(pixel >> 8);
+        }
+        writeTaskData(task, expanded, count * 2);
+    } else {
+        // Raw streams normally take the dedicated path above; this only
+        // runs for a raw stream that also announced its length.
+        if ((task.bytes_received + len) > task.total_bytes_expected) {
+            len = task.total_bytes_expected - task.bytes_received;
+        }
+        writeTaskData(task, data, len);
+    }
+
+    if (task.bytes_received >= task.total_bytes_expected) {
+        finalizeTask(task);
+    }
+}
+
+uint8_t* DisplayManager::zeroCopyRxTarget(uint32_t max_len) {
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Deltas are scattered row-wise into the resident frame, so the linear
+    // endpoint write cannot land in place; keep the bounce buffer.
+    (void)max_len;
+    return nullptr;
+#else
+    DrawTask& task = m_draw_tasks[m_usb_head_idx];
+    if (task.state != BufferState::RECEIVING || !task.raw_stream) return nullptr;
+    // Pixel-doubled payloads expand as they are written, so the endpoint
+    // cannot land them in place; they take the bounce buffer.
+    if (task.scale2x) return nullptr;
+    // The slot tail goes through the bounce buffer so a full-size packet
+    // can never write past the end of the framebuffer.
+    if ((constants::BufferSizeBytes - task.bytes_received) < max_len) return nullptr;
+    return m_framebuffers[m_usb_head_idx].data() + task.bytes_received;
+#endif
+}
+
+void DisplayManager::commitZeroCopyRx(uint32_t len) {
+    m_stats.packets_received++;
+    DrawTask& task = m_draw_tasks[m_usb_head_idx];
+    if (task.state != BufferState::RECEIVING) return;
+
+    // The payload is already in place; only account for it.
+    if ((task.bytes_received + len) > task.total_bytes_expected) {
+        len = task.total_bytes_expected - task.bytes_received;
+    }
+#if !defined(DISPLAY_FULL_FRAME) || (DISPLAY_FULL_FRAME == 0)
+    if (task.crc_check) {
+        crcFeed(task, m_framebuffers[m_usb_head_idx].data() + task.bytes_received, len);
+    }
+#endif
+    task.bytes_received += len;
+    if (task.bytes_received >= task.total_bytes_expected) {
+        finalizeTask(task);
+    }
+}
+
+void DisplayManager::serviceAnimation() {
+    // One frame advance per due period, painted only when the LCD path
+    // is otherwise idle: host rects always win, and a stall just slips
+    // the animation a tick instead of queueing frames. Re-looking the
+    // asset up each advance costs a short directory walk over
+    // memory-mapped flash and means a wiped store ends playback on its
+    // own instead of blitting freed pages.
+    if (m_anim_count == 0 || m_list_open || lcd_dma_busy()) return;
+    if (mtimer_now() < m_anim_deadline) return;
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    if (m_frame_dirty) return;
+#else
+    if (m_dma_tail_idx != m_usb_head_idx) return;
+#endif
+
+    const assets::AssetHeader* frame =
+        assets::find(static_cast<uint8_t>(m_anim_first + m_anim_index));
+    if (frame == nullptr) {
+        m_anim_count = 0;
+        return;
+    }
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Merge the frame into the resident buffer like any received
+    // payload; the ordinary repaint carries it to the panel (and the
+    // cursor plane re-composites on top, as after every repaint).
+    const uint8_t* src = assets::pixels(frame);
+    for (uint32_t row = 0; row < frame->height; row++) {
+        memcpy(m_full_framebuffer.data() +
+                   (((m_anim_y + row) * constants::LcdWidth) + m_anim_x) * 2,
+               src + row * static_cast<uint32_t>(frame->width) * 2,
+               static_cast<uint32_t>(frame->width) * 2);
+    }
+    m_frame_dirty = true;
+#else
+    // The ring is empty and the bus idle: blit straight from the
+    // memory-mapped flash pixels, exactly like a DRAW_ASSET slot does.
+    lcd_write_u16(m_anim_x, m_anim_y, frame->width, frame->height,
+                  assets::pixels(frame));
+#endif
+    m_anim_index = static_cast<uint8_t>((m_anim_index + 1) % m_anim_count);
+    m_anim_deadline = mtimer_now() + m_anim_period;
+}
+
 void DisplayManager::processDrawTasks() {
-    // This function is correct and does not need changes.
+    // Apply a pending scroll while the panel is idle. The registers only
+    // remap what the controller displays -- frame memory and therefore
+    // every queued rect stay valid -- so this never has to wait for the
+    // task ring to drain.
+    if (m_scroll_pending && !lcd_dma_busy()) {
+        m_scroll_pending = false;
+        if (m_scroll_x != m_scroll_area_x || m_scroll_w != m_scroll_area_w) {
+            lcd_scroll_area(m_scroll_x, m_scroll_w);
+            m_scroll_area_x = m_scroll_x;
+            m_scroll_area_w = m_scroll_w;
+        }
+        lcd_scroll_start(m_scroll_x + m_scroll_offset);
+    }
+
+    // Advance a running asset animation (ANIM_PLAY) while the panel is
+    // between host work; see serviceAnimation() for the yield rules.
+    serviceAnimation();
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // One large DMA transfer repaints the whole panel from the resident
+    // frame: no per-rect window-address setup, and the screen can be
+    // repainted after a USB stall without any retransmission. An open
+    // display list defers the repaint so the panel never shows a
+    // half-merged batch (LIST_BEGIN releases nothing until commit).
+    if (m_frame_dirty && !m_list_open && !lcd_dma_busy()) {
+        m_frame_dirty = false;
+        m_inflight_mark = m_inflight_head; // rects this blit carries to the panel
+        m_blit_start_cycles = read_csr(mcycle);
+        evt::note(TRACE_BLIT_START, 0);
+        lcd_write_u16(0, 0, constants::LcdWidth, constants::LcdHeight,
+                      m_full_framebuffer.data());
+        // The repaint just covered the cursor with frame content, which
+        // also restores whatever a pending RESTORE pass owed; only the
+        // repaint itself is needed on top, once this blit retires.
+        m_overlay_stage = m_overlay_visible ? OverlayStage::DRAW
+                                            : OverlayStage::NONE;
+    }
+
+    // Cursor plane passes run between blits like the scroll registers
+    // do: the frame repaint above has priority, so a dirty frame never
+    // waits behind cursor cosmetics. An open display list also holds
+    // them off -- the frame may contain half-merged list content the
+    // composite would leak onto the panel early.
+    if (m_overlay_stage != OverlayStage::NONE && !m_frame_dirty &&
+        !m_list_open && !lcd_dma_busy()) {
+        stageOverlayBlit();
+    }
+#else
     if (m_dma_tail_idx == m_usb_head_idx) return;
+    if (lcd_dma_busy()) return;
 
-    DrawTask& task = m_draw_tasks[m_dma_tail_idx];
+    // Submit every dispatchable READY_TO_DRAW slot as one scatter-gather
+    // chain; the DMA completion interrupt re-arms each following window
+    // and retires the slots one by one through completeDrawTask(), so
+    // per-rect CS/command overhead never round-trips the main loop.
+    //
+    // The scan does not stop at the first busy slot: a slot that is
+    // still receiving (or held by an open display list) only blocks the
+    // later slots whose regions overlap it -- drawing those early would
+    // invert what ends up on the panel -- while disjoint rects jump
+    // ahead. A large background upload therefore no longer head-of-line-
+    // blocks the small widget updates queued behind it. Chain order
+    // follows ring order, so rects that overlap within one chain still
+    // land in sequence order.
+    static lcd_blit_desc blit_descs[constants::NumBuffers];
+    const Rect* blockers[constants::NumBuffers];
+    int blocker_count = 0;
+    int count = 0;
+    uint8_t idx = m_dma_tail_idx;
 
-    if (task.state == BufferState::READY_TO_DRAW) {
-        const Rect& r = task.region;
-        lcd_write_u16(r.x, r.y, r.w, r.h, m_framebuffers[m_dma_tail_idx].data());
-        
-        task.state = BufferState::EMPTY;
-        m_dma_tail_idx = (m_dma_tail_idx + 1) % constants::NumBuffers;
+    while (idx != m_usb_head_idx) {
+        DrawTask& task = m_draw_tasks[idx];
+        if (task.state == BufferState::EMPTY) {
+            // Retired out of order; the tail sweeps it once its earlier
+            // neighbours drain (completeDrawTask).
+            idx = (idx + 1) % constants::NumBuffers;
+            continue;
+        }
+        bool blocked = task.state != BufferState::READY_TO_DRAW ||
+                       ((m_held_mask >> idx) & 1U) != 0U;
+        for (int i = 0; !blocked && i < blocker_count; i++) {
+            blocked = rects_overlap(*blockers[i], task.region);
+        }
+        if (blocked) {
+            // Every slot left pending protects its region: nothing that
+            // overlaps it may reach the panel before it does.
+            blockers[blocker_count++] = &task.region;
+        } else {
+            task.state = BufferState::DRAWING;
+            m_chain_slots[count] = idx;
+            blit_descs[count].x = task.region.x;
+            blit_descs[count].y = task.region.y;
+            blit_descs[count].w = task.region.w;
+            blit_descs[count].h = task.region.h;
+            blit_descs[count].pixels = task.is_fill ? nullptr
+                                     : (task.ext_pixels != nullptr) ? task.ext_pixels
+                                     : m_framebuffers[idx].data();
+            blit_descs[count].color = task.fill_color;
+            count++;
+        }
+        idx = (idx + 1) % constants::NumBuffers;
+    }
+
+    if (count > 0) {
+        m_chain_next = 0;
+        m_chain_count = static_cast<uint8_t>(count);
+        m_blit_start_cycles = read_csr(mcycle);
+        evt::note(TRACE_BLIT_START, m_chain_slots[0]);
+        lcd_write_rects(blit_descs, count);
     }
+#endif
 }
 
 } // namespace display
\ No newline at end of file
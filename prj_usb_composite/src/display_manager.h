@@ -6,28 +6,75 @@
 #include <variant>
 #include <cstddef>
 
+// Command ids, report ids, flag bits and shared wire sizes are generated
+// from the declarative description in prj_usb_composite/protocol.py (the
+// host tools consume the same description), including enum HostCommand.
+#include "display_protocol.h"
+
 namespace display {
 
 /**
  * @brief Contains compile-time constants for the display and buffer management.
  */
 namespace constants {
-    constexpr size_t LcdWidth = 160;
-    constexpr size_t LcdHeight = 80;
+    constexpr size_t LcdWidth = wire::LcdWidth;
+    constexpr size_t LcdHeight = wire::LcdHeight;
 
     // Buffer configuration ---
+    // Draw-slot ring geometry. The ideal split differs by workload --
+    // many small rects favour more, smaller slots; full-frame deltas
+    // fewer, larger ones -- so the project config may override the
+    // defaults per build (DISPLAY_NUM_BUFFERS / DISPLAY_BUFFER_SIZE).
+    // The ring indices wrap with % NumBuffers, so any count works; the
+    // asserts below pin the contracts a new geometry must still honour.
+#if defined(DISPLAY_NUM_BUFFERS)
+    constexpr size_t NumBuffers = DISPLAY_NUM_BUFFERS;
+#else
     constexpr size_t NumBuffers = 4;
+#endif
+#if defined(DISPLAY_BUFFER_SIZE)
+    constexpr size_t BufferSizeBytes = DISPLAY_BUFFER_SIZE;
+#else
     constexpr size_t BufferSizeBytes = 4096;
-    constexpr size_t MaxPixelsPerBuffer = BufferSizeBytes / 2; // Each pixel is 2 bytes (RGB555)
+#endif
+    constexpr size_t MaxPixelsPerBuffer = BufferSizeBytes / 2; // Each pixel is 2 bytes (RGB565)
+
+    // One slot always stays unusable (the head may advance only until
+    // next == tail) and free-slot counts travel in single report bytes.
+    static_assert(NumBuffers >= 2 && NumBuffers <= 32,
+                  "NumBuffers must fit the ring's spare-slot scheme and a credits byte");
+    // The GET_CAPS reply announces the slot size in a u16 field, and the
+    // copy paths move whole RGB565 pixels.
+    static_assert(BufferSizeBytes % 2 == 0 && BufferSizeBytes <= 0xFFFF,
+                  "BufferSizeBytes must be even and fit the u16 CAPS field");
+
+    // Whole-frame-resident mode (DISPLAY_FULL_FRAME=1) ---
+    constexpr size_t FullFrameBytes = LcdWidth * LcdHeight * 2; // 25.6 KB of the 32 KB SRAM
+
+    // Cursor/overlay plane (full-frame builds): the largest bitmap the
+    // device will stage, shared with the host through the wire constants.
+    constexpr size_t OverlayMaxPixels = wire::OverlayMaxW * wire::OverlayMaxH;
+
+    // Native wire pixel format, announced in the GET_CAPS handshake so
+    // the host converts exactly once into what lcd_write_u16 consumes
+    // instead of assuming it.
+    constexpr uint8_t PixelFormatRgb565 = wire::PixelFormatRgb565;
+    constexpr uint8_t NativePixelFormat = wire::NativePixelFormat;
 }
 
 /**
- * @brief Type-safe enumeration for commands received from the host.
- *        CMD_START_QUADRANT_TRANSFER has been removed.
+ * @brief Pipeline instrumentation counters, sampled with the mcycle CSR.
+ *        Read back over the custom HID report path (HostCommand::GET_STATS);
+ *        used to tune constants::NumBuffers and spot where latency goes.
  */
-enum class HostCommand : uint8_t {
-    IMAGE_DATA = 0x02,
-    DRAW_RECT = 0x06,
+struct PipelineStats {
+    uint32_t packets_received = 0; // OUT packets that reached the display path
+    uint32_t slots_dropped = 0;    // updates rejected because every DrawTask was busy
+    uint32_t rects_drawn = 0;      // rects fully blitted to the panel
+    uint32_t dma_busy_cycles = 0;  // accumulated mcycle with a blit in flight
+    uint32_t draw_cycles_last = 0; // mcycle the most recent rect blit took
+    uint32_t crc_failures = 0;     // integrity CRC mismatches (rect dropped + NACKed)
+    uint32_t slots_peak = 0;       // most slots occupied at once (slot builds; 0 when full-frame)
 };
 
 /**
@@ -41,16 +88,88 @@ struct Rect {
 enum class BufferState {
     EMPTY,
     RECEIVING,
-    READY_TO_DRAW
+    READY_TO_DRAW,
+    DRAWING          // DMA transfer to the panel is in flight
 };
 
 // Structure to hold all metadata for a single draw task ---
+// Field order is deliberate: the members the per-packet USB ISR path
+// touches on every payload packet sit first, packed by size so the
+// whole hot group fits the first few words of the struct (small base
+// offsets, no padding holes); header-arrival/finalize state follows,
+// and the conditional integrity-CRC group brings up the rear. The
+// display-list "held" flag is not here at all -- it lives in the
+// manager's m_held_mask bitmap, where one word load answers "may this
+// slot dispatch" for the whole ring (see commitDisplayList).
 struct DrawTask {
-    BufferState state = BufferState::EMPTY;
-    Rect region = {0, 0, 0, 0};
+    // --- Per-packet hot path: touched on every payload packet ---
     uint32_t bytes_received = 0;
     uint32_t total_bytes_expected = 0;
+    // Single-header streams (GET_CAPS flag bit 0): when the DRAW_RECT
+    // header announced the encoded wire length, every following packet
+    // is headerless payload regardless of encoding, and records may
+    // straddle packet boundaries (partial RLE records wait in carry).
+    uint32_t stream_bytes_expected = 0; // encoded wire bytes announced up front
+    uint32_t stream_bytes_received = 0;
+    // Delta streams (full-frame builds only): pixel bytes still owed by
+    // the copy span whose [skip, copy] header has been consumed.
+    uint16_t delta_run_bytes = 0;
+    BufferState state = BufferState::EMPTY;
+    uint8_t encoding = 0;               // 0 raw, 1 RLE, 2 indices, 3 delta spans
+    uint8_t carry[2] = {0, 0};
+    uint8_t carry_len = 0;
+    // Raw streams arrive headerless so packets can land directly in the
+    // framebuffer slot; RLE streams keep their per-packet command byte.
+    bool raw_stream = true;
+
+    // --- Header arrival / finalize / dispatch ---
+    Rect region = {0, 0, 0, 0};
     uint16_t sequence_number = 0;
+    // Solid-fill tasks carry only a color; no framebuffer slot is touched.
+    uint16_t fill_color = 0;
+    bool is_fill = false;
+    // Pixel-doubled rect (DRAW_RECT header flags bit 1): the payload is
+    // quarter-resolution and each source pixel expands to a 2x2 block as
+    // it is written, so a chunky 80x40 UI streams a quarter of the
+    // bytes. 'region' holds the doubled panel rect; bytes_received and
+    // total_bytes_expected count source bytes.
+    bool scale2x = false;
+    // mcycle when the command header arrived; the latency probe reports
+    // the delta to blit completion (see HostCommand::LATENCY_PROBE).
+    uint32_t enqueue_cycles = 0;
+    // Flash-resident blits (DRAW_ASSET): when set, the blit DMA streams
+    // pixels from this memory-mapped address instead of the slot
+    // framebuffer, so a stored asset reaches the panel with zero SRAM
+    // staging. Cleared when the slot retires.
+    const uint8_t* ext_pixels = nullptr;
+
+    // --- End-to-end integrity (GET_CAPS flag bit 4), off by default ---
+    // The DRAW_RECT header may announce a CRC32 of the encoded payload,
+    // computed by the host with the same fixed polynomial the hardware
+    // CRC unit implements. Payload bytes are fed to the unit word-wise
+    // as they land (packet boundaries need not be word-aligned, so a
+    // partial word carries here) and the result is compared at
+    // finalize; a mismatch drops the rect and latches its sequence for
+    // NACK retransmission, which finally separates USB corruption from
+    // framebuffer races.
+    uint32_t crc_expected = 0;
+    uint32_t crc_word = 0;
+    uint8_t crc_word_len = 0;
+    bool crc_check = false;
+};
+
+// One latency-probe record: a rect's sequence number and its mcycle count
+// from command reception to blit completion (see HostCommand::LATENCY_PROBE).
+struct LatencyEcho {
+    uint16_t seq = 0;
+    uint32_t cycles = 0;
+};
+
+// One verification record: a rect's sequence number and the hardware-unit
+// CRC32 of its decoded region pixels (see HostCommand::VERIFY_MODE).
+struct VerifyEcho {
+    uint16_t seq = 0;
+    uint32_t crc = 0;
 };
 
 /**
@@ -66,23 +185,265 @@ public:
     void handleUsbPacket(const uint8_t* data, uint32_t len);
     void processDrawTasks();
 
+    // Sequence-gap NACK: a forward jump in sequence numbers latches the
+    // lost range here. The main loop reports it to the host in a status
+    // IN report so only the missing updates are retransmitted.
+    bool sequenceNackPending(uint16_t& first, uint16_t& last);
+    void clearSequenceNack();
+
+    // Pipeline instrumentation: a GET_STATS command latches a request here;
+    // the main loop reads the counters and sends them in a status IN report.
+    bool statsReportPending() const { return m_stats_requested; }
+    void clearStatsRequest() { m_stats_requested = false; }
+    const PipelineStats& stats() const { return m_stats; }
+
+    // Binary event trace: a GET_TRACE command latches a request here; the
+    // main loop freezes the trace ring and streams it out (see main.cpp).
+    bool traceDumpPending() const { return m_trace_requested; }
+    void clearTraceRequest() { m_trace_requested = false; }
+
+    // GET_CRASH latch; the main loop streams the postmortem record.
+    bool crashReportPending() const { return m_crash_requested; }
+    void clearCrashRequest() { m_crash_requested = false; }
+
+    // GET_CAPS latch; the main loop answers with the buffer geometry
+    // from constants so the host sizes transfers to this build.
+    bool capsReportPending() const { return m_caps_requested; }
+    void clearCapsRequest() { m_caps_requested = false; }
+
+    // GET_BOOT latch; the main loop answers with the bootmark stage
+    // timestamps (lib/system/bootmark.h) recorded during bring-up.
+    bool bootReportPending() const { return m_boot_requested; }
+    void clearBootRequest() { m_boot_requested = false; }
+
+    // GET_BUILD latch; the main loop answers with the compile-time
+    // identity from the generated buildinfo.h (git revision, profile,
+    // configuration fingerprint).
+    bool buildReportPending() const { return m_build_requested; }
+    void clearBuildRequest() { m_build_requested = false; }
+
+    // SOF-paced status push (caps::StatusPush): the USB SOF handler
+    // latches a push every few frames and report_service sends the
+    // compact REPORT_STATUS record, so the host's flow control sees
+    // fresh credits and counters without a polling round trip. A parked
+    // pipeline suppresses the latch: the host is idle and the pushes
+    // would only keep waking the drain loop.
+    void requestStatusPush() { if (!m_idle_parked) m_status_push_due = true; }
+    bool statusPushPending() const { return m_status_push_due; }
+    void clearStatusPush() { m_status_push_due = false; }
+
+    // Idle park (IDLE_HINT): while the host reports a static screen the
+    // USB ISR skips the per-interrupt task fan-out, so the 1 kHz SOF
+    // tick no longer wakes the main loop out of WFI (gd32vf103_it.cpp).
+    // The first packet that is not a heartbeat unparks.
+    bool idleParked() const { return m_idle_parked; }
+
+    // Credit-based flow control: how many more slot-consuming commands
+    // the task ring can admit right now. The main loop reports changes
+    // to the host (status report 0x08), which suspends its stream at
+    // zero instead of pushing rects into drops and NACK recovery.
+    uint8_t freeSlots() const;
+
+    // Latency probe: while enabled, every completed rect queues an echo of
+    // its sequence number plus its receive-to-panel mcycle delta. The main
+    // loop drains these into status IN reports; popLatencyEcho() is called
+    // only once a report was actually accepted by the endpoint.
+    bool latencyEchoPending(uint16_t& seq, uint32_t& cycles);
+    void popLatencyEcho();
+
+    // Golden-image verification (VERIFY_MODE): while armed, every
+    // pixel-carrying rect queues the hardware-unit CRC32 of its decoded
+    // region pixels once decode completes, so a regression rig's
+    // throughput run doubles as a correctness check of the decoder and
+    // DMA paths. Drained like the latency echoes above.
+    bool verifyEchoPending(uint16_t& seq, uint32_t& crc);
+    void popVerifyEcho();
+
+    // Zero-copy RX support: returns where the next OUT packet should be
+    // received (directly inside the RECEIVING framebuffer slot), or nullptr
+    // if the packet must go through the endpoint bounce buffer instead.
+    uint8_t* zeroCopyRxTarget(uint32_t max_len);
+    // Accounts for a packet that the USB core already placed in the slot.
+    void commitZeroCopyRx(uint32_t len);
+
 private:
-    DisplayManager() = default;
+    DisplayManager();
+
+    // Invoked from the SPI0_TX DMA transfer-complete interrupt once a blit
+    // has fully reached the panel; retires the slot at m_dma_tail_idx.
+    static void onBlitCompleteISR();
+    void completeDrawTask();
+
+    // Queues one solid-color rect (shared by FILL_RECT and MULTI_FILL).
+    // Returns false only when no task slot was free, so a MULTI_FILL batch
+    // can stop early and let the sequence gap trigger a NACK.
+    bool queueFillRect(const Rect& r, uint16_t seq, uint8_t color_lsb, uint8_t color_msb);
+
+    // Payload writers: copy/fill into the current destination (either the
+    // active slot or the resident frame, depending on the build mode).
+    void writeTaskData(DrawTask& task, const uint8_t* src, uint32_t len);
+    void fillTaskData(DrawTask& task, uint8_t pixel_lsb, uint8_t pixel_msb, uint32_t len);
+    void finalizeTask(DrawTask& task);
+
+    // Decodes one headerless packet of a single-header stream (the
+    // DRAW_RECT header announced the encoded length; see DrawTask).
+    void consumeStreamPacket(DrawTask& task, const uint8_t* data, uint32_t len);
+
+    // Validates an incoming sequence number, latching any lost range.
+    void noteSequence(uint16_t seq);
+
+    // Integrity CRC (see the crc_* fields in DrawTask): feeds payload
+    // bytes to the hardware CRC unit, checks the result at finalize,
+    // and retires a corrupted rect into the NACK path.
+    void crcFeed(DrawTask& task, const uint8_t* src, uint32_t len);
+    bool crcPassed(DrawTask& task);
+    void failIntegrity(DrawTask& task);
+
+    // Releases the open display list for dispatch (LIST_COMMIT, or the
+    // ring-full guard in finalizeTask when a list outgrows the slots).
+    void commitDisplayList();
 
     // Replaced single task with a circular buffer of tasks and framebuffers ---
-    
+
     // An array of tasks, one for each buffer slot
     std::array<DrawTask, constants::NumBuffers> m_draw_tasks;
 
-    // The framebuffers, one for each task slot
-    std::array<std::array<uint8_t, constants::BufferSizeBytes>, constants::NumBuffers> m_framebuffers;
+    // Autonomous asset animation (ANIM_PLAY): the device cycles a run of
+    // consecutive flash assets through the LCD path on its own timing,
+    // so a spinner costs zero bus after its one-time upload. Frames are
+    // re-looked-up per advance, so a store wipe ends playback cleanly.
+    // m_anim_count is the start/stop gate: the USB ISR writes it last
+    // when starting, so the main loop never sees half-set parameters.
+    uint8_t  m_anim_first = 0;   // asset id of frame 0
+    volatile uint8_t m_anim_count = 0; // 0 = no animation playing
+    uint8_t  m_anim_index = 0;   // next frame to paint
+    uint8_t  m_anim_x = 0;
+    uint8_t  m_anim_y = 0;
+    uint64_t m_anim_period = 0;  // mtime ticks between frames
+    uint64_t m_anim_deadline = 0;
+    void serviceAnimation();
+
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    // Whole frame resident in SRAM: host deltas are applied in place and the
+    // panel is refreshed by one large DMA transfer from this buffer.
+    // alignas: member layout only promises byte alignment for uint8_t
+    // arrays; the blit DMA reads halfwords.
+    alignas(4) std::array<uint8_t, constants::FullFrameBytes> m_full_framebuffer;
+    volatile bool m_frame_dirty = false;
+    // Rects merged into the resident frame but not yet on the panel; the
+    // blit submission snapshots m_inflight_head into m_inflight_mark and
+    // the completion ISR echoes everything up to that mark.
+    std::array<LatencyEcho, 16> m_inflight;
+    volatile uint8_t m_inflight_head = 0;
+    volatile uint8_t m_inflight_tail = 0;
+    volatile uint8_t m_inflight_mark = 0;
+
+    // Cursor/overlay plane (OVERLAY_SET / OVERLAY_POS, caps bit 7): a
+    // small host-uploaded bitmap composited over the resident frame on
+    // its way to the panel, so a moving focus highlight costs one
+    // position packet instead of re-streaming the pixels underneath.
+    // The frame itself never contains the cursor -- RESTORE repaints the
+    // previous cursor rect from it, DRAW paints the current rect with
+    // the bitmap keyed over it, each as one small blit from the scratch
+    // buffer (see stageOverlayBlit).
+    enum class OverlayStage : uint8_t { NONE, RESTORE, DRAW };
+    alignas(4) std::array<uint8_t, constants::OverlayMaxPixels * 2> m_overlay_pixels;
+    alignas(4) std::array<uint8_t, constants::OverlayMaxPixels * 2> m_overlay_scratch;
+    volatile OverlayStage m_overlay_stage = OverlayStage::NONE;
+    uint8_t m_overlay_w = 0;
+    uint8_t m_overlay_h = 0;
+    uint16_t m_overlay_key = 0;      // transparent color on the wire
+    uint8_t m_overlay_x = 0;
+    uint8_t m_overlay_y = 0;
+    bool m_overlay_visible = false;
+    Rect m_overlay_prev = {0, 0, 0, 0}; // last rect painted on the panel
+    volatile uint32_t m_overlay_upload_expected = 0; // headerless bytes still owed
+    uint32_t m_overlay_upload_bytes = 0;
+    void stageOverlayBlit();
+#else
+    // The framebuffers, one for each task slot. alignas: the slot DMA
+    // reads halfwords, and member layout alone only promises bytes.
+    alignas(4) std::array<std::array<uint8_t, constants::BufferSizeBytes>, constants::NumBuffers> m_framebuffers;
+
+    // Slot indices of the blit chain in flight, in dispatch order. The
+    // scan in processDrawTasks may pull READY_TO_DRAW slots past a
+    // still-receiving neighbour when their regions do not overlap, so
+    // the completion ISR retires slots through this queue instead of
+    // assuming ring order. Written only while the DMA is idle; the ISR
+    // only reads.
+    std::array<uint8_t, constants::NumBuffers> m_chain_slots{};
+    volatile uint8_t m_chain_next = 0;
+    uint8_t m_chain_count = 0;
+#endif
 
     // Volatile indices for safe ISR/main-loop interaction
     volatile uint8_t m_usb_head_idx = 0; // Index for the ISR to write to
     volatile uint8_t m_dma_tail_idx = 0; // Index for the main loop to draw from
-    
+
     // Sequence number tracking ---
     uint16_t m_expected_sequence_num = 0;
+
+    // Latched lost-sequence range awaiting a NACK report to the host.
+    volatile bool m_nack_pending = false;
+    uint16_t m_nack_first = 0;
+    uint16_t m_nack_last = 0;
+
+    // Host-loaded color palette for IMAGE_DATA_IDX streams: indices are
+    // expanded to RGB565 while the payload is copied into the slot, so a
+    // palettized rect costs one bulk OUT byte per pixel instead of two.
+    std::array<uint16_t, 256> m_palette{};
+
+    // Latency probe state: echoes are produced from the DMA completion ISR
+    // and drained by the main loop, so the ring uses the same free-running
+    // head/tail index pattern as the task slots (size is a power of two).
+    volatile bool m_latency_probe = false;
+    std::array<LatencyEcho, 8> m_echo_ring;
+    volatile uint8_t m_echo_head = 0;
+    volatile uint8_t m_echo_tail = 0;
+    void pushLatencyEcho(uint16_t seq, uint32_t cycles);
+
+    // Verification state (VERIFY_MODE): records are produced at finalize
+    // (USB ISR context, where the CRC unit is already serialized with the
+    // integrity feed) and drained by the main loop, same ring discipline
+    // as the latency echoes.
+    volatile bool m_verify_mode = false;
+    std::array<VerifyEcho, 8> m_verify_ring;
+    volatile uint8_t m_verify_head = 0;
+    volatile uint8_t m_verify_tail = 0;
+    void pushVerifyEcho(const DrawTask& task);
+
+    // Instrumentation counters and the mcycle timestamp of the blit that
+    // is currently in flight (updated per rect from the DMA ISR).
+    // Latched SET_SCROLL request: the scroll registers share the SPI bus
+    // with pixel uploads, so the main loop applies them between blits.
+    // The area cache avoids re-sending VSCRDEF for every offset step.
+    volatile bool m_scroll_pending = false;
+    uint8_t m_scroll_x = 0;
+    uint8_t m_scroll_w = 0;
+    uint8_t m_scroll_offset = 0;
+    uint8_t m_scroll_area_x = 0;
+    uint8_t m_scroll_area_w = 0;
+
+    PipelineStats m_stats;
+    volatile bool m_stats_requested = false;
+    volatile bool m_trace_requested = false;
+    volatile bool m_crash_requested = false;
+    volatile bool m_caps_requested = false;
+    volatile bool m_boot_requested = false;
+    volatile bool m_build_requested = false;
+    volatile bool m_status_push_due = false; // SOF-latched (see requestStatusPush)
+    volatile bool m_idle_parked = false; // IDLE_HINT park state (see idleParked)
+    // Display list in progress: slot builds finalize tasks as held and
+    // full-frame builds defer the repaint until the list commits, so
+    // list N executes from its slots while list N+1 uploads.
+    volatile bool m_list_open = false;
+    // Held-slot bitmap, bit n = ring slot n belongs to the open display
+    // list (NumBuffers <= 32 is static_asserted above). One word load
+    // answers "may this slot dispatch" for the whole ring, and
+    // commitDisplayList releases every held slot with a single store
+    // instead of walking the task array.
+    uint32_t m_held_mask = 0;
+    uint32_t m_blit_start_cycles = 0;
 };
 
 } // namespace display
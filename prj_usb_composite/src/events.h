@@ -0,0 +1,60 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <cstdint>
+
+#include "fn_queue.h"
+
+/**
+ * @brief ISR-to-main-loop event posting, backed by the deferred-work
+ *        scheduler (lib/system/deferred.h).
+ *
+ * The loop used to take a flag word and walk if-chains over it; the
+ * flags now map onto scheduler levels, so each subsystem is a
+ * registered task with a defined priority and a measured worst-case
+ * dispatch latency (deferred_max_latency). ISRs keep the same post()
+ * call they always had; main() registers the task bodies and drains
+ * the scheduler between WFI sleeps.
+ *
+ * While the device is configured the USB SOF interrupt posts USB every
+ * millisecond, which bounds how long any latched report or cache flush
+ * can wait even when no other event arrives.
+ */
+namespace events {
+
+enum : uint32_t {
+    USB    = 1u << 0, // any USBFS interrupt (includes the 1 ms SOF)
+    DRAW   = 1u << 1, // display packet landed or a blit completed
+    INPUT  = 1u << 2, // encoder edge or user key press
+    HEALTH = 1u << 3, // TIMER5 heartbeat for the health monitor
+};
+
+// Scheduler levels, highest priority first. USB wakeups also post DRAW
+// and REPORT: draw slots land via USB transfers, and the report pumps
+// retry latched host reports at SOF pace.
+enum : uint32_t {
+    PRIO_USB    = 0, // usb::poll + MSC cache flush
+    PRIO_DRAW   = 1, // display pipeline dispatch
+    PRIO_INPUT  = 2, // encoder / key queue drain
+    PRIO_REPORT = 3, // latched HID status reports, trace dump
+    PRIO_HEALTH = 4, // watchdog feed + counter anomaly windows
+    PRIO_COMPLETION = 5, // cross-context completion queue (events::completions)
+};
+
+// ISR side: marks `mask` pending. Safe from any interrupt context.
+void post(uint32_t mask);
+
+// The project's standard completion channel (lib/ring/fn_queue.h):
+// ISRs post small capturing lambdas here instead of growing another
+// function-pointer-plus-flag pair, and the PRIO_COMPLETION task runs
+// them in main-loop context. Single producer rules apply: posters must
+// not preempt each other (see irq_map.h).
+using CompletionQueue = fnq::queue<8, 16>;
+CompletionQueue& completions();
+
+// Sleeps in WFI until the scheduler has at least one ready task.
+void wait();
+
+} // namespace events
+
+#endif // EVENTS_H
@@ -0,0 +1,245 @@
+#include "fwup.h"
+#include "display_protocol.h"
+#include "sram.h"
+#include <cstring>
+
+extern "C" {
+    #include "gd32vf103.h" // fmc_unlock/fmc_page_erase/fmc_word_program
+}
+
+// The patchable region is the code flash MEMORY region: from the flash
+// base up to where the cfg store begins (lib/system/GD32VF103xB.lds).
+// The asset region beyond it has its own upload path and is never part
+// of a firmware diff.
+extern "C" const uint8_t _cfg_store[];
+
+namespace fwup {
+
+namespace {
+
+constexpr uintptr_t FlashBase = 0x08000000u;
+constexpr uint32_t PageBytes = 1024; // GD32VF103xB main-flash erase page
+
+// Delta staging ring, same shape as the asset store's: the USB ISR
+// produces FW_DATA payload bytes, poll() drains them. The host paces
+// itself by polling GET_FWINFO, so a full ring is a protocol violation
+// and the excess is dropped.
+uint8_t s_ring[512];
+volatile uint16_t s_ring_head = 0;
+volatile uint16_t s_ring_tail = 0;
+
+volatile uint8_t s_state = display::wire::FwStateIdle;
+volatile bool s_info_requested = false;
+
+// Latched FW_BEGIN / FW_APPLY, consumed by poll().
+volatile bool s_begin_pending = false;
+volatile bool s_apply_pending = false;
+uint32_t s_base_crc = 0;
+uint32_t s_target_crc = 0;
+
+uint32_t s_image_crc = 0;
+bool s_crc_known = false; // distinguishes "never computed" from a real 0
+uint16_t s_pages_written = 0;
+volatile uint32_t s_bytes_received = 0; // delta bytes drained from the ring
+
+// Record parser: [offset u32 LE, len u16 LE, data] records back to
+// back across FW_DATA packet boundaries.
+uint8_t s_hdr[6];
+uint8_t s_hdr_len = 0;
+uint32_t s_rec_off = 0;       // next image offset the active record patches
+uint32_t s_rec_remaining = 0; // data bytes the active record still owes
+
+// Read-modify-write buffer for the page under patch. Records sorted by
+// offset touch each page's bytes together, so a page loads and flushes
+// once per update.
+alignas(4) uint8_t s_page[PageBytes] SRAM_CACHE;
+int32_t s_page_index = -1; // image page loaded in s_page, -1 for none
+bool s_page_dirty = false;
+
+uintptr_t code_end() { return reinterpret_cast<uintptr_t>(_cfg_store); }
+uint32_t code_len()  { return static_cast<uint32_t>(code_end() - FlashBase); }
+
+// zlib CRC32 (poly 0xEDB88320, reflected) with a nibble table: 64 bytes
+// of table instead of 1 KB, two lookups per byte. Matches Python's
+// binascii.crc32, which the host tool runs over the padded image.
+constexpr uint32_t kCrcNibble[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+    0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+    0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+uint32_t crc32_region(uintptr_t addr, uint32_t len)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(addr);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ kCrcNibble[crc & 0xFu];
+        crc = (crc >> 4) ^ kCrcNibble[crc & 0xFu];
+    }
+    return ~crc;
+}
+
+// Erases and reprograms the loaded page from s_page, then verifies the
+// readback. Both FMC operations stall instruction fetch until done, so
+// executing from the page being rewritten is safe -- the core simply
+// pauses; that stall property is what makes in-place patching viable on
+// a single-bank part.
+bool flush_page()
+{
+    if (s_page_index < 0 || !s_page_dirty) return true;
+    uintptr_t base = FlashBase
+                   + static_cast<uint32_t>(s_page_index) * PageBytes;
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(s_page);
+    fmc_unlock();
+    fmc_page_erase(base);
+    for (uint32_t i = 0; i < PageBytes / 4; i++) {
+        fmc_word_program(base + 4 * i, words[i]);
+    }
+    fmc_lock();
+    if (memcmp(reinterpret_cast<const void*>(base), s_page, PageBytes) != 0) {
+        s_state = display::wire::FwStateError;
+        return false;
+    }
+    s_page_dirty = false;
+    s_pages_written++;
+    return true;
+}
+
+bool load_page(uint32_t index)
+{
+    if (!flush_page()) return false;
+    memcpy(s_page,
+           reinterpret_cast<const void*>(FlashBase + index * PageBytes),
+           PageBytes);
+    s_page_index = static_cast<int32_t>(index);
+    s_page_dirty = false;
+    return true;
+}
+
+// Drains staged bytes through the record parser into the page buffer.
+void drain()
+{
+    while (s_ring_tail != s_ring_head) {
+        uint8_t b = s_ring[s_ring_tail % sizeof(s_ring)];
+        s_ring_tail = static_cast<uint16_t>(s_ring_tail + 1);
+        s_bytes_received = s_bytes_received + 1;
+        if (s_rec_remaining == 0) {
+            s_hdr[s_hdr_len++] = b;
+            if (s_hdr_len == sizeof(s_hdr)) {
+                s_hdr_len = 0;
+                uint32_t off = static_cast<uint32_t>(s_hdr[0])
+                             | (static_cast<uint32_t>(s_hdr[1]) << 8)
+                             | (static_cast<uint32_t>(s_hdr[2]) << 16)
+                             | (static_cast<uint32_t>(s_hdr[3]) << 24);
+                uint32_t len = static_cast<uint32_t>(s_hdr[4])
+                             | (static_cast<uint32_t>(s_hdr[5]) << 8);
+                if (len == 0 || off + len > code_len()) {
+                    s_state = display::wire::FwStateError;
+                    return;
+                }
+                s_rec_off = off;
+                s_rec_remaining = len;
+            }
+        } else {
+            uint32_t page = s_rec_off / PageBytes;
+            if (static_cast<int32_t>(page) != s_page_index
+                && !load_page(page)) {
+                return;
+            }
+            s_page[s_rec_off % PageBytes] = b;
+            s_page_dirty = true;
+            s_rec_off++;
+            s_rec_remaining--;
+        }
+    }
+}
+
+} // namespace
+
+void begin(uint32_t base_crc, uint32_t target_crc)
+{
+    // An update in flight keeps the frontier; a racing begin is dropped
+    // rather than restarting the parser under a half-patched image.
+    if (s_state == display::wire::FwStateReceiving) return;
+    s_base_crc = base_crc;
+    s_target_crc = target_crc;
+    s_ring_head = 0;
+    s_ring_tail = 0;
+    s_bytes_received = 0;
+    s_apply_pending = false;
+    s_begin_pending = true;
+}
+
+void stageData(const uint8_t* data, uint32_t len)
+{
+    if (s_state != display::wire::FwStateReceiving) return;
+    uint16_t used = static_cast<uint16_t>(s_ring_head - s_ring_tail);
+    uint32_t room = sizeof(s_ring) - used;
+    if (len > room) len = room; // host outran its polling; the tail is lost
+    for (uint32_t i = 0; i < len; i++) {
+        s_ring[s_ring_head % sizeof(s_ring)] = data[i];
+        s_ring_head = static_cast<uint16_t>(s_ring_head + 1);
+    }
+}
+
+void apply()
+{
+    if (s_state == display::wire::FwStateReceiving) s_apply_pending = true;
+}
+
+void requestInfo()      { s_info_requested = true; }
+bool infoRequested()    { return s_info_requested; }
+void clearInfoRequest() { s_info_requested = false; }
+uint8_t state()         { return s_state; }
+uint16_t pagesWritten() { return s_pages_written; }
+uint32_t bytesReceived(){ return s_bytes_received; }
+uint32_t imageCrc()     { return s_crc_known ? s_image_crc : 0; }
+uint32_t imageLen()     { return code_len(); }
+
+void poll()
+{
+    if (s_begin_pending) {
+        s_begin_pending = false;
+        // ~94 KB through the nibble loop is a handful of milliseconds;
+        // it runs once per update attempt, before anything is erased.
+        s_image_crc = crc32_region(FlashBase, code_len());
+        s_crc_known = true;
+        if (s_image_crc != s_base_crc) {
+            s_state = display::wire::FwStateBaseMismatch;
+            return;
+        }
+        s_hdr_len = 0;
+        s_rec_remaining = 0;
+        s_page_index = -1;
+        s_page_dirty = false;
+        s_pages_written = 0;
+        s_state = display::wire::FwStateReceiving;
+        return;
+    }
+
+    if (s_state == display::wire::FwStateReceiving) {
+        drain();
+        if (s_apply_pending && s_ring_tail == s_ring_head
+            && s_state == display::wire::FwStateReceiving) {
+            s_apply_pending = false;
+            bool ok = (s_rec_remaining == 0 && s_hdr_len == 0)
+                   && flush_page();
+            s_image_crc = crc32_region(FlashBase, code_len());
+            s_state = (ok && s_image_crc == s_target_crc)
+                          ? display::wire::FwStateDone
+                          : display::wire::FwStateError;
+        }
+        return;
+    }
+
+    // GET_FWINFO before any update: compute the identity CRC once so
+    // the host can pick the right diff base.
+    if (s_info_requested && !s_crc_known) {
+        s_image_crc = crc32_region(FlashBase, code_len());
+        s_crc_known = true;
+    }
+}
+
+} // namespace fwup
@@ -0,0 +1,60 @@
+#ifndef FWUP_H
+#define FWUP_H
+
+#include <cstdint>
+
+namespace fwup {
+
+/**
+ * @brief Delta firmware update over the vendor bulk interface.
+ *
+ * Reflashing over the serial bootloader re-sends the whole image and
+ * needs the BOOT0 strap; between two builds of this project the binary
+ * usually differs in a few kilobytes. The host diffs the new image
+ * against the one it knows is running (tools/display_manager/
+ * fw_update.py) and streams only the changed spans as
+ * [offset u32 LE, len u16 LE, data] records, sorted by offset; the
+ * device patches the touched 1 KB pages in place through a SRAM
+ * read-modify-write buffer, so an unchanged page is never erased.
+ *
+ * The part has a single flash bank, so there is no staging area to
+ * verify before switching: the update rewrites the running image.
+ * Two guards keep that honest. FW_BEGIN carries the CRC32 of the image
+ * the diff was computed against, and nothing is erased unless the
+ * running flash matches it -- a diff can never land on the wrong
+ * version. FW_APPLY re-runs the CRC over the patched region and only
+ * then reports DONE. Power loss between the first page erase and a
+ * verified DONE leaves a mixed image that needs the serial bootloader;
+ * that window is the price of fitting an updater in a single bank, and
+ * the host tool says so before it starts.
+ *
+ * Patching live code is safe on this part because every FMC erase and
+ * program stalls instruction fetch until it completes -- the core
+ * cannot execute a half-written word. All FMC work runs from poll() on
+ * the main loop, like the asset store; the USB ISR only latches
+ * commands and stages bytes.
+ */
+
+// Called from the USB ISR: latch a begin request / stage delta bytes.
+void begin(uint32_t base_crc, uint32_t target_crc);
+void stageData(const uint8_t* data, uint32_t len);
+void apply();
+
+// GET_FWINFO latch; the main loop answers with report::FwInfo carrying
+// the wire::FwState* state, pages written and the image CRC.
+void requestInfo();
+bool infoRequested();
+void clearInfoRequest();
+uint8_t state();
+uint16_t pagesWritten();
+uint32_t bytesReceived();
+uint32_t imageCrc(); // CRC32 of the code region; 0 until first computed
+uint32_t imageLen();
+
+// Main-loop pump: verifies the base CRC, drains staged records into the
+// page buffer and programs dirty pages. Cheap when idle.
+void poll();
+
+} // namespace fwup
+
+#endif // FWUP_H
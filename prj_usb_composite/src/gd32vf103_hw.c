@@ -33,6 +33,11 @@ OF SUCH DAMAGE.
 */
 
 #include "drv_usb_hw.h"
+#include "n200_func.h"
+#include "vectors.h"
+
+/* Vectored USBFS entry defined alongside USBFS_IRQHandler in gd32vf103_it.cpp. */
+void usbfs_vectored_entry(void);
 
 #define TIM_MSEC_DELAY                          0x01
 #define TIM_USEC_DELAY                          0x02
@@ -80,7 +85,12 @@ void usb_rcu_config(void)
 */
 void usb_intr_config(void)
 {
-    eclic_irq_enable((uint8_t)USBFS_IRQn, 1, 0);
+    /* Level and priority come from lib/system/irq_map.c (IRQ_LEVEL_USB). */
+    eclic_enable_interrupt((uint8_t)USBFS_IRQn);
+
+    /* USBFS fires per packet and per frame: give it a direct ECLIC
+       vectored entry in SRAM instead of the shared trampoline. */
+    irq_vector_register(USBFS_IRQn, usbfs_vectored_entry);
 
     /* enable the power module clock */
     rcu_periph_clock_enable(RCU_PMU);
@@ -90,7 +100,7 @@ void usb_intr_config(void)
     exti_init(EXTI_18, EXTI_INTERRUPT, EXTI_TRIG_RISING);
     exti_interrupt_enable(EXTI_18);
 
-    eclic_irq_enable((uint8_t)USBFS_WKUP_IRQn, 3, 0);
+    eclic_enable_interrupt((uint8_t)USBFS_WKUP_IRQn);
 }
 
 /*!
@@ -103,7 +113,7 @@ void usb_timer_init (void)
 {
     rcu_periph_clock_enable(RCU_TIMER2);
 
-    eclic_irq_enable(TIMER2_IRQn, 2, 0);
+    eclic_enable_interrupt(TIMER2_IRQn); /* level/priority: irq_map.c */
 }
 
 /*!
@@ -0,0 +1,148 @@
+// Performance-degradation health monitor; see health.h.
+
+extern "C" {
+#include "gd32vf103.h"
+#include "n200_func.h"
+}
+#include "health.h"
+#include "events.h"
+#include "display_manager.h"
+#include "profile.h"
+#include <cstdio>
+
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+extern "C" {
+#include "sd_card.h"
+}
+#endif
+
+#ifndef HEALTH_WDG_RESET
+#define HEALTH_WDG_RESET 0
+#endif
+
+namespace health {
+namespace {
+
+// Evaluation window and how many consecutive bad windows make a
+// sustained anomaly. One transient spike (a card re-init, a host-side
+// stall) must never reset a unit.
+constexpr uint32_t WindowMs       = 1000;
+constexpr uint32_t SustainWindows = 3;
+
+// Per-window thresholds. A healthy blit finishes in well under a
+// millisecond; 10 ms means the DMA pipeline is fighting something.
+// Occasional drops are the credit scheme's job to prevent, so a
+// steady stream of them per window is a real regression, as is any
+// sustained rate of SD data-phase errors (token timeouts, CRC
+// mismatches, rejected writes).
+inline uint32_t draw_cycles_budget() { return SystemCoreClock / 100U; }
+constexpr uint32_t DropsPerWindow    = 32;
+constexpr uint32_t SdErrorsPerWindow = 8;
+
+// Heartbeat pace; also the watchdog feed interval, so it must stay
+// well inside the FWDGT timeout below.
+constexpr uint32_t HeartbeatMs = 250;
+
+// FWDGT timeout: IRC40K / 64 = 625 Hz, 2500 counts = 4 s. Four missed
+// windows after the trip (or a genuinely hung scheduler) and the
+// hardware pulls the plug.
+constexpr uint16_t WdgReload = 2500;
+
+uint32_t last_window_cycles = 0;
+uint32_t prev_drops = 0;
+uint32_t prev_sd_errors = 0;
+uint32_t bad_windows[3] = {0, 0, 0};
+uint32_t tripped_mask = 0;
+
+void note_signal(uint32_t idx, bool bad, uint32_t sig,
+                 const char* what, uint32_t value)
+{
+    if (!bad) {
+        bad_windows[idx] = 0;
+        return;
+    }
+    if (++bad_windows[idx] < SustainWindows || (tripped_mask & sig)) {
+        return;
+    }
+    tripped_mask |= sig;
+    // Asynchronous debug UART; one line per signal per session.
+    printf("health: sustained %s (%u for %u windows)%s\n",
+           what, (unsigned)value, (unsigned)SustainWindows,
+           HEALTH_WDG_RESET ? ", withholding watchdog feed" : "");
+}
+
+} // namespace
+
+void init()
+{
+    if (RESET != rcu_flag_get(RCU_FLAG_FWDGTRST)) {
+        // Distinguish a health reset from a cold boot in the field log.
+        printf("health: prior reset was the watchdog\n");
+        rcu_all_reset_flag_clear();
+    }
+
+    // 4 Hz heartbeat on TIMER5; a 10 kHz tick keeps the prescaler in
+    // 16 bits (same scheme as the TIMER4 debounce one-shot).
+    rcu_periph_clock_enable(RCU_TIMER5);
+    timer_deinit(TIMER5);
+    timer_parameter_struct timer_initpara;
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = (uint16_t)(SystemCoreClock / 10000U - 1U);
+    timer_initpara.period    = (uint16_t)(HeartbeatMs * 10U - 1U);
+    timer_init(TIMER5, &timer_initpara);
+    timer_interrupt_flag_clear(TIMER5, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(TIMER5, TIMER_INT_UP);
+    eclic_enable_interrupt(TIMER5_IRQn); // level/priority: irq_map.c
+    timer_enable(TIMER5);
+
+#if HEALTH_WDG_RESET
+    // IRC40K-clocked, so the counter runs regardless of core state;
+    // from here on only service() keeps the unit alive.
+    fwdgt_config(WdgReload, FWDGT_PSC_DIV64);
+    fwdgt_enable();
+#endif
+
+    last_window_cycles = prof::cycles();
+}
+
+void service()
+{
+#if HEALTH_WDG_RESET
+    if (tripped_mask == 0) {
+        fwdgt_counter_reload();
+    }
+#endif
+
+    // Wrap-safe mcycle delta; between windows this is the whole task.
+    uint32_t now = prof::cycles();
+    if (now - last_window_cycles < (SystemCoreClock / 1000U) * WindowMs) {
+        return;
+    }
+    last_window_cycles = now;
+
+    const display::PipelineStats& st =
+        display::DisplayManager::getInstance().stats();
+
+    uint32_t drops = st.slots_dropped - prev_drops;
+    prev_drops = st.slots_dropped;
+    note_signal(0, st.draw_cycles_last > draw_cycles_budget(),
+                SIG_DRAW_LATENCY, "draw latency", st.draw_cycles_last);
+    note_signal(1, drops >= DropsPerWindow,
+                SIG_DROP_RATE, "slot drop rate", drops);
+
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    uint32_t sd_errors = sd_data_error_count() - prev_sd_errors;
+    prev_sd_errors += sd_errors;
+    note_signal(2, sd_errors >= SdErrorsPerWindow,
+                SIG_SD_ERRORS, "SD data-phase error rate", sd_errors);
+#else
+    (void)prev_sd_errors;
+#endif
+}
+
+uint32_t tripped()
+{
+    return tripped_mask;
+}
+
+} // namespace health
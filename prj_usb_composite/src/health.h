@@ -0,0 +1,51 @@
+#ifndef HEALTH_H
+#define HEALTH_H
+
+#include <cstdint>
+
+/**
+ * @brief Watchdog-supervised detection of slow performance failures.
+ *
+ * The free watchdog catches a hung loop, but the failure modes the
+ * fleet actually reports are slower: SD data-phase errors inflating
+ * MSC latency, a saturated ring dropping every other rect, a blit
+ * taking ten times its budget. None of them stop the loop, so nothing
+ * trips, and the unit limps until someone power-cycles it.
+ *
+ * The health task samples the existing instrumentation counters once
+ * per window (1 s) from the deferred-work scheduler, paced by its own
+ * TIMER5 heartbeat so the pacing survives a dead USB connection. A
+ * signal that stays beyond its threshold for consecutive windows is a
+ * sustained anomaly: it is always logged with its counter deltas, and
+ * when the build sets HEALTH_WDG_RESET=1 the task also stops feeding
+ * the FWDGT it armed at init, so the hardware resets the unit a few
+ * seconds later (the IRC40K keeps the watchdog running no matter what
+ * state the core is in). Feeding happens from the task body, so a
+ * starved scheduler or dead interrupt path times out the same way.
+ */
+namespace health {
+
+// Arms the TIMER5 heartbeat (and the FWDGT when HEALTH_WDG_RESET=1).
+// Call only once the main loop is about to start draining: anything
+// that blocks for seconds before the first service() pass would be
+// indistinguishable from a hang.
+void init();
+
+// Scheduler task body (events::PRIO_HEALTH): feeds the watchdog and,
+// once per window, evaluates the counters. Cheap early-out between
+// windows.
+void service();
+
+// Nonzero once a sustained anomaly has been declared this session
+// (bitmask of the Signal values below, for the HID stats path).
+uint32_t tripped();
+
+enum Signal : uint32_t {
+    SIG_DRAW_LATENCY = 1u << 0, // blit cycles over budget
+    SIG_DROP_RATE    = 1u << 1, // draw-slot drops per window
+    SIG_SD_ERRORS    = 1u << 2, // SD data-phase errors per window
+};
+
+} // namespace health
+
+#endif // HEALTH_H
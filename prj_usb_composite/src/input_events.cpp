@@ -0,0 +1,35 @@
+/* Timestamped input event queue; see input_events.h. */
+
+#include "input_events.h"
+#include "events.h"
+#include "spsc_ring.h"
+
+extern "C" {
+#include "riscv_encoding.h" // read_csr(mcycle) for the capture timestamp
+}
+
+namespace input {
+
+namespace {
+    // 16 events rides out the worst realistic burst (a fast spin is
+    // ~10 detents per 100 ms and the loop drains at least once per
+    // 1 ms SOF); a full queue drops the newest event instead of
+    // blocking the ISR.
+    spsc_ring<Event, 16> g_queue;
+}
+
+bool post(Type type, int8_t delta) {
+    Event ev;
+    ev.type = type;
+    ev.delta = delta;
+    ev.cycles = read_csr(mcycle);
+    bool queued = g_queue.push(ev);
+    events::post(events::INPUT);
+    return queued;
+}
+
+bool pop(Event& ev) {
+    return g_queue.pop(ev);
+}
+
+} // namespace input
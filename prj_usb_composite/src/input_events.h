@@ -0,0 +1,50 @@
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <cstdint>
+
+/**
+ * @brief Timestamped input event queue between the input ISRs and the
+ *        HID sender in the main loop.
+ *
+ * Encoder detents and key presses used to be collapsed into flags and a
+ * single signed counter that the main loop sampled once per pass: a
+ * burst of detents during a long display transfer reached the host as
+ * one volume step. ISRs now deposit one event per detent/press here
+ * (lib/ring spsc_ring, so a full queue drops rather than blocks), and
+ * the main loop drains the queue into coalesced HID reports -- every
+ * detent still produces its own press/release sequence, paced by the
+ * SOF handler, no matter how late the loop gets to them.
+ *
+ * Producer note: all depositing ISRs (EXTI5_9, EXTI10_15) run at the
+ * same ECLIC level (irq_map.c), so they cannot preempt each other and
+ * the single-producer contract of the ring holds.
+ */
+namespace input {
+
+enum class Type : uint8_t {
+    ROTATION,    // delta = signed step count, > 0 clockwise; one detent
+                 // yields more than one step under velocity acceleration
+                 // (see rotary_encoder.cpp)
+    ENCODER_KEY, // encoder shaft press (debounced in the ISR)
+    USER_KEY,    // board user key press (debounced in the ISR)
+};
+
+struct Event {
+    Type type = Type::ROTATION;
+    int8_t delta = 0;
+    // mcycle at capture; the drain path traces the capture-to-dispatch
+    // delay with it (TRACE_INPUT_EVENT).
+    uint32_t cycles = 0;
+};
+
+// ISR side: stamps mcycle, queues the event and posts events::INPUT.
+// Returns false if the queue was full and the event was dropped.
+bool post(Type type, int8_t delta);
+
+// Main-loop side: dequeues the oldest event. Returns false when empty.
+bool pop(Event& ev);
+
+} // namespace input
+
+#endif // INPUT_EVENTS_H
@@ -0,0 +1,109 @@
+// ISR hold-off sampling audit; see isr_audit.h.
+
+#include "isr_audit.h"
+
+#if ISR_AUDIT
+
+extern "C" {
+#include "gd32vf103.h"
+#include "n200_func.h"
+}
+#include "profile.h"
+#include "trace_ids.h"
+#include "evtrace.h"
+#include <cstdio>
+
+namespace isr_audit {
+namespace {
+
+// Prime sample period so the sampler never phase-locks with the 1 kHz
+// SOF interrupt (or anything else periodic) and keeps landing in the
+// same quiet - or busy - spot of the frame.
+constexpr uint32_t SamplePeriodUs = 997;
+
+// log2 buckets: [0] = 0-1 us, [1] = 2-3 us, ... [10] = >= 1024 us.
+// The top bucket also catches wrapped (under-read) samples; if it
+// fills, the worst case is beyond what one period can measure.
+constexpr uint32_t HistBuckets = 11;
+
+// Report pace. Slow on purpose: one line every 10 s is enough to watch
+// a soak run without the UART traffic perturbing what it measures.
+constexpr uint32_t WindowMs = 10000;
+
+// Written from the TIMER6 ISR, read from the service task; aligned
+// 32-bit loads, so no masking needed on the reader side.
+volatile uint32_t hist[HistBuckets];
+volatile uint32_t worst_us = 0;
+volatile uint32_t samples = 0;
+uint32_t last_window_cycles = 0;
+
+} // namespace
+
+void init()
+{
+    // 1 MHz tick keeps the prescaler in 16 bits up to 65 MHz over the
+    // 96 MHz profile's headroom and makes the counter read out directly
+    // in microseconds.
+    rcu_periph_clock_enable(RCU_TIMER6);
+    timer_deinit(TIMER6);
+    timer_parameter_struct timer_initpara;
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = (uint16_t)(SystemCoreClock / 1000000U - 1U);
+    timer_initpara.period    = (uint16_t)(SamplePeriodUs - 1U);
+    timer_init(TIMER6, &timer_initpara);
+    timer_interrupt_flag_clear(TIMER6, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(TIMER6, TIMER_INT_UP);
+    eclic_enable_interrupt(TIMER6_IRQn); // level/priority: irq_map.c
+    timer_enable(TIMER6);
+
+    last_window_cycles = prof::cycles();
+    printf("isr_audit: sampling hold-off every %u us\n",
+           (unsigned)SamplePeriodUs);
+}
+
+void sample_isr()
+{
+    // Counter restarted from zero at the update event that pended us,
+    // so this read is the pending-to-entry delay in microseconds. Read
+    // before anything else in the handler inflates it.
+    uint32_t lat = timer_counter_read(TIMER6);
+    timer_interrupt_flag_clear(TIMER6, TIMER_INT_FLAG_UP);
+
+    uint32_t idx = 0;
+    for (uint32_t v = lat >> 1; v != 0; v >>= 1) {
+        idx++;
+    }
+    if (idx >= HistBuckets) {
+        idx = HistBuckets - 1;
+    }
+    hist[idx] = hist[idx] + 1;
+    samples = samples + 1;
+
+    if (lat > worst_us) {
+        worst_us = lat;
+        // Sample index as arg32 so the decoded trace shows what the
+        // neighbouring events were when the record was set.
+        evt::note(TRACE_ISR_LATENCY, (uint16_t)lat, samples);
+    }
+}
+
+void service()
+{
+    // Wrap-safe mcycle delta, same pacing scheme as the health windows.
+    uint32_t now = prof::cycles();
+    if (now - last_window_cycles < (SystemCoreClock / 1000U) * WindowMs) {
+        return;
+    }
+    last_window_cycles = now;
+
+    printf("isr_audit: worst %u us over %u samples, hist",
+           (unsigned)worst_us, (unsigned)samples);
+    for (uint32_t i = 0; i < HistBuckets; i++) {
+        printf(" %u", (unsigned)hist[i]);
+    }
+    printf("\n");
+}
+
+} // namespace isr_audit
+
+#endif // ISR_AUDIT
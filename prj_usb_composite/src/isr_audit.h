@@ -0,0 +1,66 @@
+#ifndef ISR_AUDIT_H
+#define ISR_AUDIT_H
+
+#include <cstdint>
+
+#ifndef ISR_AUDIT
+#define ISR_AUDIT 0
+#endif
+
+/**
+ * @brief Sampling audit of worst-case interrupt hold-off (ISR_AUDIT=1).
+ *
+ * We suspect occasional long critical sections (printf on the SD error
+ * paths runs uncomfortably close to IRQ context) but cannot prove them:
+ * the ECLIC does not expose a per-vector pending timestamp, so the
+ * delay between an interrupt pending and its handler entering is not
+ * directly observable in software.
+ *
+ * What IS observable is how long the lowest-priority interrupt in the
+ * system gets held off. The audit arms TIMER6 (the last free basic
+ * timer) with a 1 MHz tick at the bottom of the ECLIC map, so every
+ * other handler and every interrupts-disabled section preempts or
+ * defers it. Its counter keeps running after the update event, so the
+ * counter value read at handler entry is the pending-to-entry delay in
+ * microseconds - no capture hardware needed. That one number bounds
+ * the hold-off every vector in the map can experience from code below
+ * its own level, which is the figure the zero-copy endpoint work needs.
+ *
+ * The sample period (997 us) is prime so the sampler cannot phase-lock
+ * with the 1 kHz SOF interrupt and keep measuring the same quiet spot.
+ * A hold-off longer than one period wraps the counter and under-reads;
+ * the top histogram bucket saturating is the signal to distrust the
+ * absolute worst-case number and widen the period.
+ *
+ * Each sample lands in a log2-bucketed histogram; a new worst case is
+ * recorded in the trace buffer (TRACE_ISR_LATENCY) with its sample
+ * index, so the decoded trace shows what the system was doing around
+ * it. service() prints the histogram once per window on the debug UART.
+ */
+namespace isr_audit {
+
+#if ISR_AUDIT
+
+// Arms the TIMER6 sampler. Call alongside health::init(), once the
+// main loop is about to start: the boot path's long masked sections
+// (flash asset scan, USB enumeration waits) are not what we're hunting.
+void init();
+
+// TIMER6 ISR body: reads the counter (microseconds since the update
+// event pended), clears the flag, and folds the sample in.
+void sample_isr();
+
+// Periodic report (piggybacks on the health heartbeat): one histogram
+// line per window, plus the running worst case. Cheap between windows.
+void service();
+
+#else
+
+inline void init() {}
+inline void service() {}
+
+#endif // ISR_AUDIT
+
+} // namespace isr_audit
+
+#endif // ISR_AUDIT_H
@@ -7,16 +7,39 @@ extern "C" {
 #include "gd32vf103.h"
 #include "systick.h"
 #include "lcd.h"
+#include "deferred.h"
+#include "memwatch.h"
+#include "postmortem.h"
+#include "n200_func.h"
 }
 #include "usb_device.h"
 #include <stdio.h>
 // gpio.h is no longer needed
 #include "usb.hpp"
 #include "board.h"
+#include "board_pins.h"
+#include "board_clocks.h"
 #include "rotary_encoder.h"
-#include <math.h>
-#include "shared_defs.h" 
+#include <string.h>
 #include "display_manager.h"
+#include "asset_store.h"
+#include "fwup.h"
+#include "events.h"
+#include "health.h"
+#include "console.h"
+#include "isr_audit.h"
+#include "telemetry.h"
+#include "input_events.h"
+#include "evtrace.h"
+#include "trace_ids.h"
+#include "profile.h"
+#include "bench.h"
+#include "cfgstore.h"
+#include "perflog.h"
+extern "C" {
+#include "bootmark.h"
+}
+#include "buildinfo.h"
 
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
     #include "sd_card.h"
@@ -24,6 +47,19 @@ extern "C" {
     #include "usbd_msc_mem.h"
 #endif
 
+// Boot-stage slots for bootmark (lib/system/bootmark.h). mcycle counts
+// from reset, so slot 0 already covers start.S and SystemInit, and every
+// stamp is an absolute offset into the boot. Queried via GET_BOOT.
+enum BootStage : uint32_t {
+    BOOT_MAIN_ENTRY = 0,  // C runtime up, clocks configured
+    BOOT_USB_STARTED,     // usb::init returned; enumeration runs from the ISR
+    BOOT_LCD_READY,       // panel initialized
+    BOOT_ASSETS_READY,    // flash asset-store frontier scan done
+    BOOT_SD_PROBED,       // MSC media probe finished (zero when built out)
+    BOOT_USB_CONFIGURED,  // host set a configuration: device is usable
+    BOOT_STAGE_COUNT,
+};
+
 // Define some helpful consumer control usage codes
 namespace hid_consumer {
     constexpr uint16_t VOLUME_UP   = 0x00E9;
@@ -33,14 +69,532 @@ namespace hid_consumer {
     constexpr uint16_t NO_KEY      = 0x0000;
 }
 
-// --- State machine for sending HID actions ---
-enum class HidActionState {
-    IDLE,
-    WAITING_FOR_PRESS_CONFIRM,
-    WAITING_FOR_RELEASE_CONFIRM
-};
-static HidActionState hid_state = HidActionState::IDLE;
+// --- Scheduler task bodies -------------------------------------------
+// Bottom halves the ISRs schedule via events::post; priorities are the
+// PRIO_* levels in events.h. Each runs to completion from the drain
+// loop in main() with interrupts open.
+
+static void usb_service(void)
+{
+    usb::poll();
+
+    // Pump any in-progress asset upload: page erases and word programming
+    // run here, SOF-paced, so their flash-fetch stalls stay bounded and
+    // never happen inside an ISR (see asset_store.h).
+    assets::poll();
+
+    // Likewise for a delta firmware update: the base-CRC pass, page
+    // patching and the final verify all run here (see fwup.h).
+    fwup::poll();
+
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    // Flush write-back cache lines once the host stops rewriting them.
+    msc_mem_poll();
+#endif
+}
+
+static void draw_service(void)
+{
+    display::DisplayManager::getInstance().processDrawTasks();
+}
+
+// Latched host-bound HID reports. Anything the IN queue refuses stays
+// latched in the DisplayManager and is retried on the next SOF-paced
+// post, so nothing here busy-waits.
+static void report_service(void)
+{
+    // Report any lost display sequence range so the host retransmits
+    // only the missing updates. The range stays latched until the IN
+    // endpoint actually accepts the report.
+    uint16_t nack_first, nack_last;
+    if (display::DisplayManager::getInstance().sequenceNackPending(nack_first, nack_last)) {
+        uint8_t nack_report[5] = {
+            display::report::SeqNack,
+            static_cast<uint8_t>(nack_first & 0xFF), static_cast<uint8_t>(nack_first >> 8),
+            static_cast<uint8_t>(nack_last & 0xFF), static_cast<uint8_t>(nack_last >> 8),
+        };
+        if (usb::send_custom_hid_report(nack_report, sizeof(nack_report))) {
+            display::DisplayManager::getInstance().clearSequenceNack();
+        }
+    }
+
+    // Answer a host GET_STATS request with the pipeline counters.
+    if (display::DisplayManager::getInstance().statsReportPending()) {
+        const display::PipelineStats& st = display::DisplayManager::getInstance().stats();
+        const uint32_t counters[15] = {
+            st.packets_received, st.slots_dropped, st.rects_drawn,
+            st.dma_busy_cycles, st.draw_cycles_last, st.crc_failures,
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+            msc_mem_write_skips(), // byte-identical sector writes skipped
+#else
+            0U,
+#endif
+            st.slots_peak, // ring-occupancy high water (geometry tuning)
+            // SD command-level health (sd_cmd_stats): climbing retries,
+            // timeouts or busy share flag a dying card from the fleet
+            // side long before users notice the MSC slowdown.
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+            sd_cmd_stats()->commands, sd_cmd_stats()->retries,
+            sd_cmd_stats()->timeouts, sd_cmd_stats()->busy_cycles,
+#else
+            0U, 0U, 0U, 0U,
+#endif
+            // USB NAK pressure (usb::nak_stats): poll intervals spent
+            // NAKing each MSC endpoint, and re-arms withheld during card
+            // stalls. A climbing out-NAK share with deferrals means the
+            // card, not the bus, is pacing host copies.
+            usb::nak_stats().msc_in_polls,
+            usb::nak_stats().msc_out_polls,
+            usb::nak_stats().stall_deferrals,
+        };
+        uint8_t stats_report[1 + sizeof(counters)];
+        stats_report[0] = display::report::Stats;
+        for (unsigned i = 0; i < 15; i++) {
+            stats_report[1 + i * 4 + 0] = static_cast<uint8_t>(counters[i]);
+            stats_report[1 + i * 4 + 1] = static_cast<uint8_t>(counters[i] >> 8);
+            stats_report[1 + i * 4 + 2] = static_cast<uint8_t>(counters[i] >> 16);
+            stats_report[1 + i * 4 + 3] = static_cast<uint8_t>(counters[i] >> 24);
+        }
+        if (usb::send_custom_hid_report(stats_report, sizeof(stats_report))) {
+            display::DisplayManager::getInstance().clearStatsRequest();
+            // The same request triggers the per-interface ISR cycle
+            // accounting (PROF_SCOPE tags in usb_device.cpp) over the
+            // debug UART; reset so successive polls cover disjoint
+            // intervals.
+            prof::dump(true);
+        }
+    }
+
+    // Answer a GET_CAPS handshake with the buffer geometry of this build,
+    // so the host sizes and frames its transfers from what the device
+    // actually has instead of hardcoded copies of these constants.
+    if (display::DisplayManager::getInstance().capsReportPending()) {
+        using namespace display;
+        uint8_t caps_report[13] = {
+            report::Caps,
+            caps::Version,
+            static_cast<uint8_t>(constants::LcdWidth),
+            static_cast<uint8_t>(constants::LcdHeight),
+            static_cast<uint8_t>(constants::NumBuffers),
+            static_cast<uint8_t>(constants::BufferSizeBytes & 0xFF),
+            static_cast<uint8_t>(constants::BufferSizeBytes >> 8),
+            static_cast<uint8_t>(constants::FullFrameBytes & 0xFF),
+            static_cast<uint8_t>((constants::FullFrameBytes >> 8) & 0xFF),
+            static_cast<uint8_t>((constants::FullFrameBytes >> 16) & 0xFF),
+            static_cast<uint8_t>((constants::FullFrameBytes >> 24) & 0xFF),
+            // Delta-span streams need the resident frame, so those two
+            // bits travel together (bit meanings: display_protocol.h).
+            caps::SingleHeader | caps::DisplayLists | caps::IntegrityCrc
+                | caps::PixelDouble | caps::StatusPush
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+                | caps::FullFrame | caps::Delta | caps::Overlay
+#endif
+            ,
+            // Native pixel format id; the host refuses to stream rather
+            // than guess when it does not recognize the value.
+            constants::NativePixelFormat,
+        };
+        if (usb::send_custom_hid_report(caps_report, sizeof(caps_report))) {
+            display::DisplayManager::getInstance().clearCapsRequest();
+        }
+    }
+
+    // Answer a GET_BOOT query with the bring-up stage timestamps, as
+    // absolute mcycle offsets from reset (the host divides by the core
+    // clock; stage meanings are the BootStage slots above).
+    if (display::DisplayManager::getInstance().bootReportPending()) {
+        uint8_t boot_report[2 + BOOT_STAGE_COUNT * 4];
+        boot_report[0] = display::report::Boot;
+        boot_report[1] = BOOT_STAGE_COUNT;
+        for (uint32_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+            uint32_t c = bootmark_cycles(i);
+            boot_report[2 + i * 4 + 0] = static_cast<uint8_t>(c);
+            boot_report[2 + i * 4 + 1] = static_cast<uint8_t>(c >> 8);
+            boot_report[2 + i * 4 + 2] = static_cast<uint8_t>(c >> 16);
+            boot_report[2 + i * 4 + 3] = static_cast<uint8_t>(c >> 24);
+        }
+        if (usb::send_custom_hid_report(boot_report, sizeof(boot_report))) {
+            display::DisplayManager::getInstance().clearBootRequest();
+        }
+    }
+
+    // Answer a GET_BUILD query with the compile-time identity from the
+    // generated buildinfo.h: the configuration fingerprint as one
+    // comparable word, plus "<git revision> <profile>" as text, so the
+    // host can tag its measurements with the exact build that produced
+    // them without a console round trip.
+    if (display::DisplayManager::getInstance().buildReportPending()) {
+        static const char text[] = BUILDINFO_GIT " " BUILDINFO_PROFILE;
+        uint8_t build_report[6 + sizeof(text) - 1];
+        static_assert(sizeof(build_report) <= display::wire::ReportLength,
+                      "build identity text must fit one IN report");
+        build_report[0] = display::report::Build;
+        build_report[1] = static_cast<uint8_t>(BUILDINFO_FINGERPRINT);
+        build_report[2] = static_cast<uint8_t>(BUILDINFO_FINGERPRINT >> 8);
+        build_report[3] = static_cast<uint8_t>(BUILDINFO_FINGERPRINT >> 16);
+        build_report[4] = static_cast<uint8_t>(BUILDINFO_FINGERPRINT >> 24);
+        build_report[5] = sizeof(text) - 1;
+        memcpy(&build_report[6], text, sizeof(text) - 1);
+        if (usb::send_custom_hid_report(build_report, sizeof(build_report))) {
+            display::DisplayManager::getInstance().clearBuildRequest();
+        }
+    }
+
+    // Answer a GET_ASSETS request with the flash asset-store directory.
+    // The host checks versions here at connect time to skip re-uploading
+    // unchanged assets, and polls the state/byte-count fields to pace an
+    // upload against the main-loop flash programming (see asset_store.h).
+    if (assets::infoRequested()) {
+        const assets::AssetHeader* dir[16];
+        uint32_t n = assets::directory(dir, 16);
+        uint32_t rx = assets::bytesReceived();
+        uint8_t asset_report[7 + 16 * 3];
+        asset_report[0] = display::report::Assets;
+        asset_report[1] = static_cast<uint8_t>(assets::state());
+        asset_report[2] = static_cast<uint8_t>(rx);
+        asset_report[3] = static_cast<uint8_t>(rx >> 8);
+        asset_report[4] = static_cast<uint8_t>(rx >> 16);
+        asset_report[5] = static_cast<uint8_t>(rx >> 24);
+        asset_report[6] = static_cast<uint8_t>(n);
+        for (uint32_t i = 0; i < n; i++) {
+            asset_report[7 + i * 3] = dir[i]->id;
+            asset_report[8 + i * 3] = static_cast<uint8_t>(dir[i]->version & 0xFF);
+            asset_report[9 + i * 3] = static_cast<uint8_t>(dir[i]->version >> 8);
+        }
+        if (usb::send_custom_hid_report(asset_report, 7 + n * 3)) {
+            assets::clearInfoRequest();
+        }
+    }
+
+    // Answer a GET_FWINFO request with the running image's CRC and the
+    // delta-update state. The host reads the CRC at connect time to pick
+    // the right diff base, and polls the state to pace an update (see
+    // fwup.h).
+    if (fwup::infoRequested()) {
+        uint32_t rx = fwup::bytesReceived();
+        uint32_t crc = fwup::imageCrc();
+        uint32_t len = fwup::imageLen();
+        uint16_t pages = fwup::pagesWritten();
+        uint8_t fw_report[16];
+        fw_report[0] = display::report::FwInfo;
+        fw_report[1] = fwup::state();
+        fw_report[2] = static_cast<uint8_t>(pages);
+        fw_report[3] = static_cast<uint8_t>(pages >> 8);
+        fw_report[4] = static_cast<uint8_t>(rx);
+        fw_report[5] = static_cast<uint8_t>(rx >> 8);
+        fw_report[6] = static_cast<uint8_t>(rx >> 16);
+        fw_report[7] = static_cast<uint8_t>(rx >> 24);
+        fw_report[8] = static_cast<uint8_t>(crc);
+        fw_report[9] = static_cast<uint8_t>(crc >> 8);
+        fw_report[10] = static_cast<uint8_t>(crc >> 16);
+        fw_report[11] = static_cast<uint8_t>(crc >> 24);
+        fw_report[12] = static_cast<uint8_t>(len);
+        fw_report[13] = static_cast<uint8_t>(len >> 8);
+        fw_report[14] = static_cast<uint8_t>(len >> 16);
+        fw_report[15] = static_cast<uint8_t>(len >> 24);
+        if (usb::send_custom_hid_report(fw_report, sizeof(fw_report))) {
+            fwup::clearInfoRequest();
+        }
+    }
+
+    // Publish free-slot credits whenever the ring occupancy changed. The
+    // host suspends new slot-consuming commands at zero credits, so a
+    // burst queues host-side instead of overrunning the ring and paying
+    // for drops with NACK recovery.
+    static uint8_t last_credits = 0xFF;
+    uint8_t credits = display::DisplayManager::getInstance().freeSlots();
+    if (credits != last_credits) {
+        uint8_t credit_report[3] = {
+            display::report::Credits,
+            credits,
+            static_cast<uint8_t>(display::constants::NumBuffers),
+        };
+        if (usb::send_custom_hid_report(credit_report, sizeof(credit_report))) {
+            last_credits = credits;
+        }
+    }
+
+    // SOF-paced status push (caps::StatusPush): the compact record the
+    // host's flow control rides on instead of GET_STATS round trips.
+    // Dropped silently when the IN queue is full - the next latch is at
+    // most STATUS_PUSH_FRAMES away and carries fresher numbers anyway.
+    if (display::DisplayManager::getInstance().statusPushPending()) {
+        const display::PipelineStats& st = display::DisplayManager::getInstance().stats();
+        const uint16_t mv = telemetry::supply_mv();
+        const uint16_t dc = static_cast<uint16_t>(telemetry::die_temp_dc());
+        uint8_t status_report[16] = {
+            display::report::Status,
+            display::DisplayManager::getInstance().freeSlots(),
+            static_cast<uint8_t>(display::constants::NumBuffers),
+            static_cast<uint8_t>(health::tripped()),
+            static_cast<uint8_t>(st.rects_drawn & 0xFF),
+            static_cast<uint8_t>((st.rects_drawn >> 8) & 0xFF),
+            static_cast<uint8_t>(st.slots_dropped & 0xFF),
+            static_cast<uint8_t>((st.slots_dropped >> 8) & 0xFF),
+            static_cast<uint8_t>(st.draw_cycles_last),
+            static_cast<uint8_t>(st.draw_cycles_last >> 8),
+            static_cast<uint8_t>(st.draw_cycles_last >> 16),
+            static_cast<uint8_t>(st.draw_cycles_last >> 24),
+            static_cast<uint8_t>(mv & 0xFF),
+            static_cast<uint8_t>(mv >> 8),
+            static_cast<uint8_t>(dc & 0xFF),
+            static_cast<uint8_t>(dc >> 8),
+        };
+        display::DisplayManager::getInstance().clearStatusPush();
+        usb::send_custom_hid_report(status_report, sizeof(status_report));
+    }
+
+    // Echo completed rects while the latency probe is armed: sequence
+    // number plus the receive-to-panel mcycle delta. The host pairs the
+    // echo with its send timestamp for end-to-end percentiles (see
+    // tools/display_manager/latency_probe.py).
+    uint16_t echo_seq;
+    uint32_t echo_cycles;
+    while (display::DisplayManager::getInstance().latencyEchoPending(echo_seq, echo_cycles)) {
+        uint8_t echo_report[7] = {
+            display::report::RectLatency,
+            static_cast<uint8_t>(echo_seq & 0xFF), static_cast<uint8_t>(echo_seq >> 8),
+            static_cast<uint8_t>(echo_cycles), static_cast<uint8_t>(echo_cycles >> 8),
+            static_cast<uint8_t>(echo_cycles >> 16), static_cast<uint8_t>(echo_cycles >> 24),
+        };
+        if (!usb::send_custom_hid_report(echo_report, sizeof(echo_report))) {
+            break; // IN queue full; retry on the next pass
+        }
+        display::DisplayManager::getInstance().popLatencyEcho();
+    }
+
+    // Golden-image verification echoes (VERIFY_MODE): the hardware-unit
+    // CRC of each decoded rect region, which the rig's host compares
+    // against the value it computed over the payload it sent.
+    uint16_t verify_seq;
+    uint32_t verify_crc;
+    while (display::DisplayManager::getInstance().verifyEchoPending(verify_seq, verify_crc)) {
+        uint8_t crc_report[7] = {
+            display::report::RectCrc,
+            static_cast<uint8_t>(verify_seq & 0xFF), static_cast<uint8_t>(verify_seq >> 8),
+            static_cast<uint8_t>(verify_crc), static_cast<uint8_t>(verify_crc >> 8),
+            static_cast<uint8_t>(verify_crc >> 16), static_cast<uint8_t>(verify_crc >> 24),
+        };
+        if (!usb::send_custom_hid_report(crc_report, sizeof(crc_report))) {
+            break; // IN queue full; retry on the next pass
+        }
+        display::DisplayManager::getInstance().popVerifyEcho();
+    }
+
+    // Stream the binary event trace when a GET_TRACE command asked for
+    // it. Capture is frozen while the ring drains; the IN-report queue
+    // paces the dump, so a full ring takes a few passes.
+    static bool trace_active = false;
+    static bool trace_header_sent = false;
+    static uint32_t trace_first = 0, trace_count = 0, trace_sent = 0;
+
+    if (!trace_active && display::DisplayManager::getInstance().traceDumpPending()) {
+        evt::arm(false);
+        uint32_t total = evt::count();
+        trace_count = (total < evt::BUF_EVENTS) ? total : evt::BUF_EVENTS;
+        trace_first = total - trace_count;
+        trace_sent = 0;
+        trace_header_sent = false;
+        trace_active = true;
+    }
+    if (trace_active && !trace_header_sent) {
+        uint8_t hdr[5] = {
+            0x04, 0xFF, // Status report: trace dump, header chunk
+            static_cast<uint8_t>(trace_count), static_cast<uint8_t>(trace_count >> 8),
+            static_cast<uint8_t>((trace_first != 0U) ? 1U : 0U), // ring wrapped: older events lost
+        };
+        trace_header_sent = usb::send_custom_hid_report(hdr, sizeof(hdr));
+    }
+    // Event chunks go out as one scatter-gather burst per pass: up to
+    // eight wire packets are staged into a static buffer and posted as
+    // a single TX descriptor, which the driver streams as back-to-back
+    // IN packets from the FIFO -- one transfer setup instead of eight.
+    // The buffer belongs to the endpoint until the burst drains, so a
+    // new one is staged only once custom_hid_burst_busy() clears.
+    static uint8_t trace_burst[8 * 64];
+    if (trace_active && trace_header_sent && (trace_sent < trace_count) &&
+        !usb::custom_hid_burst_busy()) {
+        uint32_t filled = 0;
+        uint32_t staged_events = 0;
+        while ((trace_sent < trace_count) && (filled < sizeof(trace_burst))) {
+            uint32_t n = trace_count - trace_sent;
+            if (n > 5U) n = 5U; // 5 x 12-byte events fit one 64-byte report
+            uint8_t *pkt = &trace_burst[filled];
+            memset(pkt, 0, 64);
+            pkt[0] = 0x04;
+            pkt[1] = static_cast<uint8_t>(trace_sent / 5U); // chunk sequence
+            pkt[2] = static_cast<uint8_t>(n);
+            pkt[3] = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                memcpy(&pkt[4 + i * sizeof(evt::Event)],
+                       &evt::at(trace_first + trace_sent + i), sizeof(evt::Event));
+            }
+            trace_sent += n;
+            staged_events += n;
+            filled += 64;
+        }
+        if (!usb::send_custom_hid_burst(trace_burst, filled)) {
+            trace_sent -= staged_events; // queue full: retry next pass
+        }
+    }
+    if (trace_active && trace_header_sent && (trace_sent == trace_count)) {
+        display::DisplayManager::getInstance().clearTraceRequest();
+        trace_active = false;
+        evt::arm(true);
+    }
+
+    // Stream the previous session's crash record when a GET_CRASH
+    // command asked for it: a header chunk announcing length and
+    // validity, then raw postmortem_record bytes in 56-byte chunks.
+    // The record is invalidated only after the last chunk is accepted.
+    if (display::DisplayManager::getInstance().crashReportPending()) {
+        static uint32_t crash_sent = 0;
+        static bool crash_hdr_sent = false;
+        const bool valid = postmortem_pending();
+        const uint8_t *rec = reinterpret_cast<const uint8_t *>(postmortem_get());
+        const uint32_t total = valid ? sizeof(postmortem_record) : 0;
+
+        if (!crash_hdr_sent) {
+            uint8_t hdr[5] = {
+                0x06, 0xFF, // Status report: crash record, header chunk
+                static_cast<uint8_t>(total), static_cast<uint8_t>(total >> 8),
+                static_cast<uint8_t>(valid ? 1U : 0U),
+            };
+            crash_hdr_sent = usb::send_custom_hid_report(hdr, sizeof(hdr));
+            crash_sent = 0;
+        }
+        while (crash_hdr_sent && (crash_sent < total)) {
+            uint32_t n = total - crash_sent;
+            if (n > 56U) n = 56U;
+            uint8_t pkt[4 + 56];
+            pkt[0] = 0x06;
+            pkt[1] = static_cast<uint8_t>(crash_sent / 56U); // chunk sequence
+            pkt[2] = static_cast<uint8_t>(n);
+            pkt[3] = 0;
+            memcpy(&pkt[4], rec + crash_sent, n);
+            if (!usb::send_custom_hid_report(pkt, 4 + n)) {
+                break; // queue full; resume on the next pass
+            }
+            crash_sent += n;
+        }
+        if (crash_hdr_sent && (crash_sent == total)) {
+            display::DisplayManager::getInstance().clearCrashRequest();
+            postmortem_clear();
+            crash_hdr_sent = false;
+        }
+    }
+
+    // Runtime tuning console: run completed command lines and flush
+    // their output as REPORT_CONSOLE packets (see src/console.h). One
+    // ring-empty check per pass when no console is attached.
+    console::service();
+
+    // Stack/heap watermarks every ~30 s. This task is SOF-paced, so the
+    // mtime check costs a comparison per millisecond; the report itself
+    // is a single printf line on the debug UART.
+    static uint64_t next_mem_report = 0;
+    uint64_t now = get_timer_value();
+    if (now >= next_mem_report) {
+        memwatch_report();
+        next_mem_report = now + 30ULL * (SystemCoreClock / 4); // mtime rate
+    }
+}
+
+// Drain the input event queue. Rotation events coalesce into a net
+// detent count; ENCODER_HID_DELTA builds send that count as one
+// relative REPORT_ENCODER record, while legacy builds expand it into a
+// consumer-key press/release sequence per detent (the SOF interrupt
+// flushes those at one report per frame). Either way a burst captured
+// while the loop was busy with display traffic still reaches the host
+// as the right number of steps. Hardware-decoded detents
+// (init_timer_decode()) come from the TIMER1 counter instead of the
+// queue.
+static void input_service(void)
+{
+    int16_t net_rotation = encoder::get_rotation();
+    bool mute_requested = false;
+
+    input::Event in_ev;
+    while (input::pop(in_ev)) {
+        evt::note(TRACE_INPUT_EVENT, static_cast<uint16_t>(in_ev.type),
+                  read_csr(mcycle) - in_ev.cycles);
+        switch (in_ev.type) {
+        case input::Type::ROTATION:
+            net_rotation = static_cast<int16_t>(net_rotation + in_ev.delta);
+            break;
+        case input::Type::ENCODER_KEY:
+            mute_requested = true;
+            break;
+        case input::Type::USER_KEY: {
+            printf("User button pressed!\n");
+            board_led_toggle();
+            uint8_t report_payload[2] = {display::report::ButtonEvent, 0x01};
+            usb::send_custom_hid_report(report_payload, sizeof(report_payload));
+            break;
+        }
+        }
+    }
+
+#if defined(ENCODER_HID_DELTA) && (ENCODER_HID_DELTA == 1)
+    // Whole burst in one relative report: the host applies the signed
+    // detent count at once instead of replaying a press/release pair
+    // per detent (each pair is two SOF-paced IN reports, which is what
+    // made fast scrubbing feel rubbery). Clamped to i8; a spin between
+    // drains is tens of detents at most.
+    if (net_rotation != 0) {
+        if (net_rotation > 127) net_rotation = 127;
+        if (net_rotation < -127) net_rotation = -127;
+        printf("Action: Encoder delta %d\n", net_rotation);
+        uint8_t report_payload[2] = {display::report::Encoder,
+                                     static_cast<uint8_t>(net_rotation)};
+        usb::send_custom_hid_report(report_payload, sizeof(report_payload));
+    }
+#else
+    if (net_rotation != 0) {
+        printf("Action: Sending Volume %s x%d...\n",
+               (net_rotation > 0) ? "Up" : "Down",
+               (net_rotation > 0) ? net_rotation : -net_rotation);
+    }
+    while (net_rotation > 0) {
+        usb::press_consumer(hid_consumer::VOLUME_UP);
+        net_rotation--;
+    }
+    while (net_rotation < 0) {
+        usb::press_consumer(hid_consumer::VOLUME_DOWN);
+        net_rotation++;
+    }
+#endif
+    if (mute_requested) {
+        printf("Action: Sending Mute...\n");
+        usb::press_consumer(hid_consumer::MUTE);
+    }
+}
+
+// Watchdog feed and degradation windows, paced by the TIMER5 heartbeat
+// (see health.h).
+static void health_service(void)
+{
+    health::service();
+    // Hold-off audit report rides the same heartbeat; no-op unless the
+    // build sets ISR_AUDIT=1.
+    isr_audit::service();
+    // Fold the ADC telemetry ring at the same 4 Hz; the sampling itself
+    // is all-hardware (scan mode + circular DMA, see telemetry.h).
+    telemetry::service();
+    // Boot-over-boot counter persist; internally rate-limited to
+    // KeyPerfPersistMin, so the heartbeat just gives it a pulse.
+    perflog::service();
+}
 
+// Standard completion channel (lib/ring/fn_queue.h): ISRs post small
+// capturing lambdas via events::completions() and they run here, in
+// main-loop context, FIFO. The sensor-bus completion dispatch was the
+// first producer to move over; new async drivers start here instead of
+// growing another function-pointer-plus-flag pair.
+static void completion_service(void)
+{
+    events::completions().service();
+}
 
 /*!
     \brief      main function
@@ -50,105 +604,140 @@ static HidActionState hid_state = HidActionState::IDLE;
 */
 int main(void)
 {
+    bootmark_note(BOOT_MAIN_ENTRY);
+    // Exact clock-enable writes from the compile-time registry (see
+    // board_clocks.h): only what this build uses clocks at all, and
+    // anything a warm reboot or the bootloader left running is gated
+    // back off. Must come first so every later driver enable is a
+    // no-op OR into these masks.
+    board_clocks::apply();
+    // Whole pin map in one pass (see board_pins.h); the board and
+    // driver inits below no longer touch GPIO modes one pin at a time.
+    board_pins::apply();
     board_led_init();
     board_key_init();
+
+    // Kick the panel first: lcd_init_start() pulses the reset and
+    // issues sleep-out in a few milliseconds, then the 120 ms settle
+    // the ST7735S demands runs underneath the USB and asset bring-up
+    // below instead of being busy-waited. lcd_init_finish() picks the
+    // sequence back up once there is a splash to show.
+    lcd_init_start();
+
+    // Parameter store before USB: one scan of the active cfg flash
+    // page fills the RAM cache, so everything after this point (the
+    // SOF status pacing snapshot included) reads tunables from SRAM.
+    cfgstore::init();
+    // Boot-over-boot history: load the lifetime baseline and log this
+    // reset (one 8-byte cfgstore append; see perflog.h).
+    perflog::init();
+
+    // USB before everything that doesn't feed it: enumeration is driven
+    // entirely by the USBFS interrupt, so the host's bus resets and
+    // descriptor exchanges overlap the panel and asset-store bring-up
+    // below instead of queueing behind them. Time-to-enumeration is
+    // what the kiosk watchdog recovery measures, and it used to carry
+    // the whole serial init cost.
+    // MSC is carried even on SD-less builds: LUN 1 is the synthesized
+    // stats RAM disk (ramdisk.h), so instrumentation dumps mount as
+    // files regardless of the card slot.
+    usb::init(true);
+    bootmark_note(BOOT_USB_STARTED);
+
     encoder::init();
-    lcd_init();
+    assets::init(); // find the append frontier in the flash asset store
+    bootmark_note(BOOT_ASSETS_READY);
+
+    // Finish the panel bring-up with the stored background as the
+    // splash: it is blitted into frame memory straight from flash
+    // before display-on, so the first frame the panel shows is the
+    // dashboard background rather than a black flash followed by
+    // nothing until a host connects. No stored (or wrong-sized)
+    // asset degrades to the old clear-to-black.
+    const assets::AssetHeader* bg =
+        assets::find(static_cast<uint8_t>(display::wire::AssetIdBackground));
+    const void* splash = nullptr;
+    if (bg != nullptr && bg->width == LCD_WIDTH && bg->height == LCD_HEIGHT) {
+        splash = assets::pixels(bg);
+    }
+    lcd_init_finish(splash);
+    bootmark_note(BOOT_LCD_READY);
+
+#if EVT_ENABLE
+    // Let a trap capture snapshot the newest trace window into the
+    // .noinit postmortem record (lib/system/postmortem.h).
+    postmortem_set_trace(evt::g_buf, sizeof(evt::Event), evt::BUF_EVENTS,
+                         &evt::g_next);
+#endif
 
     delay_1ms(100);
     printf("\n\n--- System Initialized with Polling Architecture ---\n");
 
-    bool sd_card_is_ok = false;
+    if (postmortem_pending()) {
+        const postmortem_record *pm = postmortem_get();
+        printf("postmortem: prior crash mcause=%x mepc=%x mtval=%x"
+               " (GET_CRASH retrieves the full record)\n",
+               (unsigned)pm->mcause, (unsigned)pm->mepc, (unsigned)pm->mtval);
+    }
 
 // The preprocessor will now skip this whole block
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
-    printf("Attempting to initialize SD Card...\n");
-    if (!(sd_init() & STA_NOINIT)) {
-        printf("INFO: SD Card initialized successfully.\n");
-        sd_card_is_ok = true;
-    } else {
-        printf("WARN: SD Card initialization failed or card not present.\n");
-    }
-    
-    if (sd_card_is_ok) {
-        msc_mem_pre_init();
-    }
+    // Probe the card only after USB is live: enumeration runs from the
+    // USBFS interrupt and answers media-not-present meanwhile, and the
+    // card's arrival is reported via UNIT ATTENTION (usbd_msc_mem.cpp),
+    // so a slow or absent card no longer costs seconds of enumeration.
+    msc_mem_probe();
+    bootmark_note(BOOT_SD_PROBED);
 #else
     printf("INFO: SD Card MSC feature is disabled in this build.\n");
 #endif
 
-    printf("Proceeding with USB initialization...\n");
-    usb::init(false); // MSC is disabled
-    printf("USB initialization complete.\n");
-    
     printf("Waiting for USB configuration from host...\n");
     while (!usb::is_configured()) {
         board_led_toggle();
         delay_1ms(200);
     }
+    bootmark_note(BOOT_USB_CONFIGURED);
     printf("USB device configured successfully!\n");
+    printf("boot: usb %u lcd %u assets %u configured %u cycles\n",
+           (unsigned)bootmark_cycles(BOOT_USB_STARTED),
+           (unsigned)bootmark_cycles(BOOT_LCD_READY),
+           (unsigned)bootmark_cycles(BOOT_ASSETS_READY),
+           (unsigned)bootmark_cycles(BOOT_USB_CONFIGURED));
     board_led_on(); // Turn on Green LED to indicate ready state
 
-    // 6. Main application loop with non-blocking state machine
-    while(1){
-        usb::poll();
-
-        display::DisplayManager::getInstance().processDrawTasks();
-
-        // Step 1: Check for new user input only when idle.
-        if (hid_state == HidActionState::IDLE) {
-            int8_t rotation = encoder::get_rotation();
-            uint16_t action_key = hid_consumer::NO_KEY;
-
-            if (rotation > 0) {
-                printf("Action: Sending Volume Up...\n");
-                action_key = hid_consumer::VOLUME_UP;
-            } else if (rotation < 0) {
-                printf("Action: Sending Volume Down...\n");
-                action_key = hid_consumer::VOLUME_DOWN;
-            } else if (encoder::is_pressed()) {
-                printf("Action: Sending Mute...\n");
-                action_key = hid_consumer::MUTE;
-            }
-
-            // If an action was detected, send it and change state.
-            if (action_key != hid_consumer::NO_KEY) {
-                usb::send_consumer_report(action_key);
-                hid_state = HidActionState::WAITING_FOR_PRESS_CONFIRM;
-            }
-        }
-        
-        // Step 2: If we sent a "press", wait for it to complete before sending the "release".
-        else if (hid_state == HidActionState::WAITING_FOR_PRESS_CONFIRM) {
-            if (usb::is_std_hid_transfer_complete()) {
-                printf("Action: Press confirmed. Sending Release.\n");
-                usb::send_consumer_report(hid_consumer::NO_KEY);
-                hid_state = HidActionState::WAITING_FOR_RELEASE_CONFIRM; // Now wait for the release to complete
-            }
-        }
+    // 6. Event-driven main loop over the deferred-work scheduler: ISRs
+    //    post priority levels via events::post (one AMO each), and the
+    //    loop drains ready tasks highest priority first, then sleeps in
+    //    WFI. While configured, the 1 ms SOF interrupt posts USB, which
+    //    paces the latched-report and cache-flush tasks.
+    deferred_register(events::PRIO_USB, usb_service);
+    deferred_register(events::PRIO_DRAW, draw_service);
+    deferred_register(events::PRIO_INPUT, input_service);
+    deferred_register(events::PRIO_REPORT, report_service);
+    deferred_register(events::PRIO_HEALTH, health_service);
+    deferred_register(events::PRIO_COMPLETION, completion_service);
 
-        // Step 3: If we sent a "release", wait for it to complete before returning to idle.
-        else if (hid_state == HidActionState::WAITING_FOR_RELEASE_CONFIRM) {
-            if (usb::is_std_hid_transfer_complete()) {
-                printf("Action: Release confirmed. Returning to Idle.\n");
-                hid_state = HidActionState::IDLE; // Ready for new input
-            }
-        }
+    // Armed last: from here the health task must keep being dispatched
+    // (it feeds the watchdog in the HEALTH_WDG_RESET=1 build), which is
+    // exactly the supervision we want over the loop below.
+    health::init();
+    isr_audit::init(); // no-op unless ISR_AUDIT=1
+    telemetry::init();
+    console::init();   // command table for the runtime tuning console
 
-        extern volatile bool user_key_pressed;
-        if(user_key_pressed) {
-            printf("User button pressed!\n");
-            board_led_toggle();
-            // 1. Create the data payload you want to send.
-            uint8_t report_payload[2] = {0x01, 0x01};
+#if BENCH_AUTORUN
+    // Characterization builds: run the registered micro-benchmarks once
+    // at boot and dump them on the debug UART, so a flash-and-capture
+    // cycle needs no console round trip. The LCD benchmarks run before
+    // any host stream can start, which is the quiet bus they want.
+    bench::run_all([](const char *line) { printf("%s\n", line); });
+#endif
 
-            // 2. Send it using the new, correct function.
-            usb::send_custom_hid_report(report_payload, sizeof(report_payload));
-            
-            user_key_pressed = false;
-        }
+    while(1){
+        deferred_drain();
 
-        // A minimal, non-blocking delay is still good practice to yield CPU time.
-        delay_1ms(1);
+        // Idle in WFI until an ISR posts the next task.
+        events::wait();
     }
 }
\ No newline at end of file
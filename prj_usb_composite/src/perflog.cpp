@@ -0,0 +1,100 @@
+/*!
+    \file    perflog.cpp
+    \brief   Boot-over-boot counter aggregation (see perflog.h)
+*/
+#include "perflog.h"
+#include "display_manager.h"
+#include "cfgstore.h"
+#include "tuning.h"
+#include "usb_device.h"
+#include "mtimer.h"
+
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+extern "C" {
+    #include "sd_card.h"
+}
+#endif
+
+namespace perflog {
+namespace {
+
+// Flash baseline loaded at boot: lifetime totals as of the last
+// persist of the previous boots. This boot's live counters are added
+// on top at read and persist time.
+uint32_t s_base[NumCounters];
+uint32_t s_boots;
+
+// Lifetime floor for the persisted value of each counter: flash only
+// moves forward, so a glitched live read can never shrink history.
+uint32_t s_written[NumCounters];
+
+uint64_t s_next_persist;
+
+// This boot's contribution, in the fixed perflog counter order.
+void sample(uint32_t out[NumCounters])
+{
+    const display::PipelineStats &st =
+        display::DisplayManager::getInstance().stats();
+    out[0] = st.rects_drawn;
+    out[1] = st.slots_dropped;
+    out[2] = st.crc_failures;
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    out[3] = sd_cmd_stats()->retries + sd_cmd_stats()->timeouts;
+#else
+    out[3] = 0U;
+#endif
+    out[4] = usb::nak_stats().stall_deferrals;
+}
+
+uint64_t persist_ticks()
+{
+    uint32_t min = cfgstore::get_or(tuning::KeyPerfPersistMin, 15U);
+    min = (min < 1U || min > 1440U) ? 15U : min;
+    return (uint64_t)min * 60U * 1000000U * mtimer_ticks_per_us();
+}
+
+} // namespace
+
+void init()
+{
+    for (uint32_t i = 0; i < NumCounters; i++) {
+        s_base[i] = cfgstore::get_or(
+            static_cast<uint8_t>(tuning::KeyPerfCounterBase + i), 0U);
+        s_written[i] = s_base[i];
+    }
+    s_boots = cfgstore::get_or(tuning::KeyPerfBoots, 0U) + 1U;
+    cfgstore::set(tuning::KeyPerfBoots, s_boots);
+    s_next_persist = mtimer_now() + persist_ticks();
+}
+
+void service()
+{
+    uint64_t now = mtimer_now();
+    if (now < s_next_persist) return;
+    s_next_persist = now + persist_ticks();
+
+    uint32_t live[NumCounters];
+    sample(live);
+    for (uint32_t i = 0; i < NumCounters; i++) {
+        uint32_t total = s_base[i] + live[i];
+        if (total <= s_written[i]) continue; // unchanged (or wrapped)
+        if (cfgstore::set(static_cast<uint8_t>(tuning::KeyPerfCounterBase + i),
+                          total)) {
+            s_written[i] = total;
+        }
+    }
+}
+
+Totals totals()
+{
+    Totals t;
+    uint32_t live[NumCounters];
+    sample(live);
+    t.boots = s_boots;
+    for (uint32_t i = 0; i < NumCounters; i++) {
+        t.counter[i] = s_base[i] + live[i];
+    }
+    return t;
+}
+
+} // namespace perflog
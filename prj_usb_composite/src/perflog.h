@@ -0,0 +1,57 @@
+#ifndef PERFLOG_H
+#define PERFLOG_H
+
+#include <cstdint>
+
+/**
+ * @brief Boot-over-boot aggregation of the key health counters.
+ *
+ * Every instrumentation counter resets at reset, so slow degradation
+ * -- an SD card whose retry rate doubles over months, a connector
+ * whose wear shows up as CRC failures -- is invisible: each boot
+ * looks like the first. This module folds the handful of counters
+ * that matter for that question into the flash parameter store
+ * (lib/cfgstore, keys in tuning.h) so they accumulate across boots.
+ *
+ * The device has no shutdown to hook, so persistence is periodic:
+ * service() rides the 4 Hz health heartbeat and appends at most one
+ * record per changed counter every KeyPerfPersistMin minutes
+ * (default 15). At ~6 records per persist that is well under one
+ * cfgstore page migration per day, two orders of magnitude inside
+ * FMC endurance, and a power cut costs at most one interval of
+ * history. cfgstore::set skips unchanged values, so idle units write
+ * nothing at all.
+ *
+ * What a trend reader gets: the boot count, lifetime totals, and
+ * (computed at render time) the per-boot average to hold this boot
+ * against. Surfaces: HISTORY.TXT on the stats RAM disk (ramdisk.h)
+ * and the console's hist command. A unit whose current-boot error
+ * rate sits above its own lifetime average is aging hardware; a whole
+ * fleet shifting together after an update is our regression.
+ */
+namespace perflog {
+
+// Lifetime totals (flash baseline plus this boot), in the fixed order
+// rects, drops, crc failures, sd retries, stall deferrals.
+constexpr uint32_t NumCounters = 5;
+struct Totals {
+    uint32_t boots;      // this boot included
+    uint32_t counter[NumCounters];
+};
+
+// Loads the flash baseline and appends the boot-count record. Call
+// once after cfgstore::init(), before the first heartbeat.
+void init();
+
+// Rate-limited fold into the parameter store; heartbeat-paced,
+// main-loop context (FMC programming stalls the bus like any other
+// cfgstore write).
+void service();
+
+// Lifetime view for the render surfaces; a plain RAM sum, safe
+// anywhere the pipeline counters themselves are safe.
+Totals totals();
+
+} // namespace perflog
+
+#endif // PERFLOG_H
@@ -0,0 +1,261 @@
+/*!
+    \file    ramdisk.cpp
+    \brief   Synthesized read-only FAT12 stats volume (see ramdisk.h)
+*/
+#include "ramdisk.h"
+#include "display_manager.h"
+#include "usbd_msc_mem.h"
+#include "health.h"
+#include "telemetry.h"
+#include "perflog.h"
+
+#include <cstring>
+
+#include "tfmt_chars.h"
+
+extern "C" {
+    #include "bootmark.h"
+    #include "systick.h"
+    #include "memwatch.h"
+    #include "sram.h"
+}
+
+namespace ramdisk {
+namespace {
+
+// --- Volume geometry --------------------------------------------------
+// One reserved sector, one FAT copy of one sector, one root-directory
+// sector, then data clusters of one sector each. Cluster N lives at
+// sector SecData + (N - 2), the usual FAT arithmetic.
+constexpr uint32_t SecBoot = 0;
+constexpr uint32_t SecFat  = 1;
+constexpr uint32_t SecRoot = 2;
+constexpr uint32_t SecData = 3;
+
+// File sizes are fixed (the directory entry is generated once per read,
+// not updated), so the rendered text is padded out to the full size.
+constexpr uint32_t StatsBytes   = 2048; // clusters 2..5
+constexpr uint32_t ConfigBytes  = 512;  // cluster 6
+constexpr uint32_t HistoryBytes = 512;  // cluster 7
+constexpr uint32_t StatsFirstCluster   = 2;
+constexpr uint32_t ConfigFirstCluster  = 6;
+constexpr uint32_t HistoryFirstCluster = 7;
+
+// Render buffers. Re-rendered whenever the host reads the file's first
+// sector, served from the snapshot for the rest of the (sequential)
+// read; .caches placement because the content is rebuildable on demand.
+char stats_text[StatsBytes] SRAM_CACHE;
+char config_text[ConfigBytes] SRAM_CACHE;
+char history_text[HistoryBytes] SRAM_CACHE;
+
+void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, static_cast<uint16_t>(v));
+    put_u16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+void build_boot_sector(uint8_t *s) {
+    memset(s, 0, BlockSize);
+    s[0] = 0xEB; s[1] = 0x3C; s[2] = 0x90;            // jump stub
+    memcpy(&s[3], "MSDOS5.0", 8);                     // OEM name
+    put_u16(&s[11], BlockSize);                       // bytes per sector
+    s[13] = 1;                                        // sectors per cluster
+    put_u16(&s[14], 1);                               // reserved sectors
+    s[16] = 1;                                        // FAT copies
+    put_u16(&s[17], 16);                              // root entries (1 sector)
+    put_u16(&s[19], BlockCount);                      // total sectors
+    s[21] = 0xF8;                                     // media descriptor
+    put_u16(&s[22], 1);                               // sectors per FAT
+    put_u16(&s[24], 1);                               // sectors per track
+    put_u16(&s[26], 1);                               // heads
+    s[38] = 0x29;                                     // extended boot signature
+    put_u32(&s[39], 0x32334447);                      // volume serial "GD32"
+    memcpy(&s[43], "GD32 STATS ", 11);                // volume label
+    memcpy(&s[54], "FAT12   ", 8);                    // FS type hint
+    s[510] = 0x55; s[511] = 0xAA;
+}
+
+// 12-bit FAT entry packing: entry i straddles bytes at offset i*1.5.
+void fat_set12(uint8_t *s, uint32_t idx, uint32_t val) {
+    uint32_t off = idx + (idx >> 1);
+    if (idx & 1U) {
+        s[off] = static_cast<uint8_t>((s[off] & 0x0F) | ((val & 0x0F) << 4));
+        s[off + 1] = static_cast<uint8_t>(val >> 4);
+    } else {
+        s[off] = static_cast<uint8_t>(val);
+        s[off + 1] = static_cast<uint8_t>((s[off + 1] & 0xF0) | ((val >> 8) & 0x0F));
+    }
+}
+
+void build_fat_sector(uint8_t *s) {
+    memset(s, 0, BlockSize);
+    fat_set12(s, 0, 0xFF8); // media descriptor
+    fat_set12(s, 1, 0xFFF);
+    fat_set12(s, 2, 3);     // STATS.TXT: 2 -> 3 -> 4 -> 5 -> EOF
+    fat_set12(s, 3, 4);
+    fat_set12(s, 4, 5);
+    fat_set12(s, 5, 0xFFF);
+    fat_set12(s, 6, 0xFFF); // CONFIG.TXT: single cluster
+    fat_set12(s, 7, 0xFFF); // HISTORY.TXT: single cluster
+}
+
+void dir_entry(uint8_t *e, const char *name83, uint8_t attr,
+               uint32_t cluster, uint32_t size) {
+    memset(e, 0, 32);
+    memcpy(e, name83, 11);
+    e[11] = attr;
+    put_u16(&e[26], static_cast<uint16_t>(cluster));
+    put_u32(&e[28], size);
+}
+
+void build_root_sector(uint8_t *s) {
+    memset(s, 0, BlockSize);
+    dir_entry(&s[0],  "GD32 STATS ", 0x08, 0, 0);          // volume label
+    dir_entry(&s[32], "STATS   TXT", 0x01, StatsFirstCluster, StatsBytes);
+    dir_entry(&s[64], "CONFIG  TXT", 0x01, ConfigFirstCluster, ConfigBytes);
+    dir_entry(&s[96], "HISTORY TXT", 0x01, HistoryFirstCluster, HistoryBytes);
+}
+
+// Space-pad the render buffer past the cursor so the fixed file size
+// always carries printable content.
+void pad(char *buf, uint32_t size, size_t cursor) {
+    uint32_t used = (cursor > size) ? size : static_cast<uint32_t>(cursor);
+    memset(buf + used, ' ', size - used);
+    buf[size - 1] = '\n';
+}
+
+// Rendering runs inside the MSC read that fetches the file's first
+// sector, so both renders use the tfmt::Writer conversions instead of
+// snprintf: straight digit emission, no format parsing on that path.
+
+// One "label value\n" counter line with the label padded to column 12.
+void stat_line(tfmt::Writer &w, const char *label, uint32_t v,
+               const char *unit = "") {
+    size_t start = w.size();
+    w.str(label).pad_to(start + 12).dec(v).str(unit).ch('\n');
+}
+
+void render_stats() {
+    const display::PipelineStats &st =
+        display::DisplayManager::getInstance().stats();
+    uint32_t mask = health::tripped();
+    int16_t t = telemetry::die_temp_dc();
+    static const char *const stage[] = {
+        "main", "usb", "lcd", "assets", "sd", "cfg",
+    };
+    tfmt::Writer w(stats_text, sizeof(stats_text));
+    stat_line(w, "uptime",
+              (uint32_t)(get_timer_value() / (SystemCoreClock / 4U)), " s");
+    stat_line(w, "packets", st.packets_received);
+    stat_line(w, "rects", st.rects_drawn);
+    stat_line(w, "drops", st.slots_dropped);
+    w.str("slots-peak  ").dec((uint32_t)st.slots_peak).ch('/')
+     .dec((uint32_t)display::constants::NumBuffers).ch('\n');
+    stat_line(w, "draw-last", st.draw_cycles_last, " cyc");
+    stat_line(w, "dma-busy", st.dma_busy_cycles, " cyc");
+    stat_line(w, "crc-fail", st.crc_failures);
+    stat_line(w, "wr-skips", msc_mem_write_skips());
+    w.str("health      0x").hex(mask);
+    if (mask & health::SIG_DRAW_LATENCY) w.str(" draw-latency");
+    if (mask & health::SIG_DROP_RATE) w.str(" drop-rate");
+    if (mask & health::SIG_SD_ERRORS) w.str(" sd-errors");
+    w.ch('\n');
+    stat_line(w, "supply", (uint32_t)telemetry::supply_mv(), " mV");
+    w.str("die-temp    ").dec((int32_t)(t / 10)).ch('.')
+     .dec((uint32_t)((t < 0 ? -t : t) % 10)).str(" C\n");
+    w.str("stack-free  ").dec(memwatch_stack_headroom()).ch('/')
+     .dec(memwatch_stack_size()).ch('\n');
+    w.str("heap-peak   ").dec(memwatch_heap_used_max()).ch('/')
+     .dec(memwatch_heap_size()).ch('\n');
+    for (uint32_t i = 0; i < sizeof(stage) / sizeof(stage[0]); i++) {
+        size_t start = w.size();
+        w.str("boot-").str(stage[i]).pad_to(start + 12)
+         .dec(bootmark_cycles(i)).str(" cyc\n");
+    }
+    pad(stats_text, sizeof(stats_text), w.size());
+}
+
+void render_config() {
+    tfmt::Writer w(config_text, sizeof(config_text));
+    w.str("ck-sys        ").dec(SystemCoreClock).str(" Hz\n");
+    w.str("lcd           ").dec((uint32_t)display::constants::LcdWidth)
+     .ch('x').dec((uint32_t)display::constants::LcdHeight).ch('\n');
+    w.str("report-len    ").dec((uint32_t)display::wire::ReportLength)
+     .ch('\n');
+    w.str("draw-slots    ").dec((uint32_t)display::constants::NumBuffers)
+     .ch('x').dec((uint32_t)display::constants::BufferSizeBytes).ch('\n');
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    w.str("sd-msc        1\n");
+#else
+    w.str("sd-msc        0\n");
+#endif
+#if defined(DISPLAY_FULL_FRAME) && (DISPLAY_FULL_FRAME == 1)
+    w.str("full-frame    1\n");
+#else
+    w.str("full-frame    0\n");
+#endif
+    pad(config_text, sizeof(config_text), w.size());
+}
+
+void render_history() {
+    // Boot-over-boot aggregates (perflog.h): lifetime totals and the
+    // per-boot average to hold this boot's STATS.TXT numbers against.
+    static const char *const label[perflog::NumCounters] = {
+        "rects", "drops", "crc-fail", "sd-retry", "stall-dfr",
+    };
+    perflog::Totals t = perflog::totals();
+    uint32_t boots = (t.boots != 0U) ? t.boots : 1U;
+    tfmt::Writer w(history_text, sizeof(history_text));
+    w.str("boots       ").dec(t.boots).ch('\n');
+    w.str("            lifetime    /boot\n");
+    for (uint32_t i = 0; i < perflog::NumCounters; i++) {
+        size_t start = w.size();
+        w.str(label[i]).pad_to(start + 12).dec(t.counter[i]);
+        w.pad_to(start + 24).dec(t.counter[i] / boots).ch('\n');
+    }
+    pad(history_text, sizeof(history_text), w.size());
+}
+
+// Synthesizes one sector. Data sectors outside the files read as
+// zeroes -- the FAT marks them free, so the host never asks anyway.
+void read_sector(uint8_t *buf, uint32_t sector) {
+    if (sector == SecBoot) { build_boot_sector(buf); return; }
+    if (sector == SecFat)  { build_fat_sector(buf);  return; }
+    if (sector == SecRoot) { build_root_sector(buf); return; }
+
+    uint32_t cluster = (sector - SecData) + 2;
+    if (cluster >= StatsFirstCluster
+        && cluster < StatsFirstCluster + StatsBytes / BlockSize) {
+        if (cluster == StatsFirstCluster) render_stats();
+        memcpy(buf, stats_text + (cluster - StatsFirstCluster) * BlockSize,
+               BlockSize);
+        return;
+    }
+    if (cluster == ConfigFirstCluster) {
+        render_config();
+        memcpy(buf, config_text, BlockSize);
+        return;
+    }
+    if (cluster == HistoryFirstCluster) {
+        render_history();
+        memcpy(buf, history_text, BlockSize);
+        return;
+    }
+    memset(buf, 0, BlockSize);
+}
+
+} // namespace
+
+int8_t read(uint8_t *buf, uint32_t sector, uint16_t count) {
+    if (sector + count > BlockCount) return -1;
+    for (uint16_t i = 0; i < count; i++) {
+        read_sector(buf + static_cast<uint32_t>(i) * BlockSize, sector + i);
+    }
+    return 0;
+}
+
+} // namespace ramdisk
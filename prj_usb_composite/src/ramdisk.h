@@ -0,0 +1,44 @@
+#ifndef RAMDISK_H
+#define RAMDISK_H
+
+#include <cstdint>
+
+/**
+ * @brief Read-only virtual FAT12 volume serving device stats as files.
+ *
+ * The second MSC LUN (see usbd_msc_mem.cpp) exposes a tiny "drive"
+ * whose sectors are synthesized on demand: boot sector, FAT and root
+ * directory are generated into the caller's buffer per read, and the
+ * files render their text from the live instrumentation counters
+ * the moment the host reads them. Nothing but the render buffers is
+ * stored, so a 32 KB-class volume costs ~2.5 KB of SRAM, serves at
+ * memory speed, and works with no SD card inserted.
+ *
+ *   STATS.TXT   pipeline/health/memory/boot counters, the same
+ *               surfaces the console's stats/health/mem/boot commands
+ *               print, re-rendered on every read of its first sector
+ *   CONFIG.TXT  build-time configuration: clock profile, feature
+ *               flags, geometry, wire sizes
+ *   HISTORY.TXT boot-over-boot aggregates from the flash parameter
+ *               store (perflog.h): boot count, lifetime error totals
+ *               and their per-boot averages, for trend reading
+ *
+ * Pulling a dump is then just copying a file off the drive -- no host
+ * tool, no report-sized chunking, no SD dependency. The volume is
+ * write-protected: file sizes are fixed (text is padded), and the host
+ * never learns anything it could corrupt.
+ */
+namespace ramdisk {
+
+constexpr uint32_t BlockSize = 512;
+constexpr uint32_t BlockCount = 64;
+
+// Synthesizes `count` sectors starting at `sector` into buf. Runs in
+// the USBFS interrupt (the MSC data stage); everything it reads is a
+// plain counter load, and a full stats render is a few microseconds of
+// tinyfmt. Returns 0, or -1 for an out-of-range sector.
+int8_t read(uint8_t *buf, uint32_t sector, uint16_t count);
+
+} // namespace ramdisk
+
+#endif // RAMDISK_H
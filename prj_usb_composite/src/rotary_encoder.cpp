@@ -1,5 +1,11 @@
 #include "rotary_encoder.h"
 #include "systick.h" // For the millisecond timer
+#include "events.h"
+#include "input_events.h"
+extern "C" {
+#include "n200_func.h" // eclic_enable_interrupt
+#include "fix16.h"     // Q16.16 velocity math (lib/fixtab)
+}
 
 // Pin Definitions (These are correct and stay the same)
 #define ENCODER_S1_PIN      GPIO_PIN_10
@@ -18,13 +24,80 @@
 #define ENCODER_KEY_EXTI    EXTI_12
 #define ENCODER_KEY_IRQn    EXTI10_15_IRQn
 
+// Timer-decode variant: TIMER1's encoder interface on PA0/PA1
+#define ENCODER_TIMER       TIMER1
+#define ENCODER_TIMER_CLK   RCU_TIMER1
+#define ENCODER_TIMER_IRQn  TIMER1_IRQn
+#define ENCODER_TIMER_PORT  GPIOA
+#define ENCODER_TIMER_CLKP  RCU_GPIOA
+#define ENCODER_TIMER_PINS  (GPIO_PIN_0 | GPIO_PIN_1)
+
 // Internal state variables
-static volatile int8_t rotation_count = 0;
-static volatile bool key_pressed_flag = false;
 static volatile uint64_t last_interrupt_time = 0;
 const uint32_t DEBOUNCE_TIME_MS = 50;
 const uint32_t ROTATION_DEBOUNCE_MS = 2; // Debounce for rotation interrupts
 
+// Timer-decode state: counter value at the last get_rotation() read plus
+// leftover edge counts that did not yet make a whole detent. EC11-style
+// encoders produce one full quadrature cycle (4 counted edges in decoder
+// mode 2) per detent.
+static bool timer_decode_active = false;
+static uint16_t last_timer_counter = 0;
+static int16_t edge_residual = 0;
+const int16_t EDGES_PER_DETENT = 4;
+
+// --- Detent-velocity acceleration ------------------------------------
+// One detent maps to one step at adjustment speed, but a flick should
+// move the volume in chunks: velocity is estimated per detent from
+// mtime deltas in Q16.16 detents/second (no FPU, so no floats) and a
+// small gain table scales the step count. The scaled count rides the
+// normal event-queue/report path, so a big move also costs fewer HID
+// IN reports than the detents it replaced.
+static uint64_t last_detent_mtime = 0;
+static fix16_t detent_velocity = 0; // Q16.16 detents/second, EWMA
+
+// Gain bands, fastest first. An EC11 yields ~2 detents/s when adjusting
+// by feel and 20+ on a flick across the knob.
+struct AccelBand {
+    fix16_t min_velocity; // Q16.16 detents/second
+    int8_t multiplier;
+};
+static constexpr AccelBand ACCEL_CURVE[] = {
+    { 20 * FIX16_ONE, 8 },
+    { 10 * FIX16_ONE, 4 },
+    {  5 * FIX16_ONE, 2 },
+};
+
+// A pause this long ends the gesture: the estimate restarts from zero,
+// so a careful adjustment never inherits the gain of an earlier flick.
+const uint32_t GESTURE_GAP_MS = 300;
+
+// Updates the velocity estimate with `detents` movements ending at
+// mtime `now` and returns the step multiplier to apply to them.
+static int8_t accel_multiplier(int16_t detents, uint64_t now) {
+    const uint64_t ticks_per_sec = SystemCoreClock / 4; // mtime rate
+    uint64_t elapsed = now - last_detent_mtime;
+    last_detent_mtime = now;
+
+    if (elapsed == 0 || elapsed > (GESTURE_GAP_MS * ticks_per_sec) / 1000U) {
+        detent_velocity = 0;
+        return 1;
+    }
+
+    // Instantaneous velocity of this batch; clamped well above the top
+    // band so the EWMA arithmetic stays in range.
+    uint64_t v = (((uint64_t)detents * ticks_per_sec) << 16) / elapsed;
+    if (v > (uint64_t)(100 * FIX16_ONE)) v = (uint64_t)(100 * FIX16_ONE);
+    // EWMA, alpha = 1/4: the gain follows a sustained spin within a few
+    // detents but one fast pair does not spike it.
+    detent_velocity += ((fix16_t)v - detent_velocity) >> 2;
+
+    for (const AccelBand& band : ACCEL_CURVE) {
+        if (detent_velocity >= band.min_velocity) return band.multiplier;
+    }
+    return 1;
+}
+
 // Update the rotation ISR to include a micro-debounce
 void encoder::rotation_isr() {
 
@@ -34,16 +107,17 @@ void encoder::rotation_isr() {
         return;
     }
 
-    // Use a temporary variable to modify the count, then write back to volatile.
-    // This avoids the deprecated read-modify-write operation on a volatile.
-    int8_t current_count = rotation_count;
+    // One queued event per detent, scaled by the velocity gain;
+    // direction from the S2 phase. The queue preserves bursts that land
+    // while the main loop is busy with display traffic (input_events.h),
+    // where the old shared counter collapsed them into a single report.
+    int8_t steps = accel_multiplier(1, now);
     if (gpio_input_bit_get(ENCODER_S2_PORT, ENCODER_S2_PIN) == RESET) {
-        current_count--; // This reports counter-clockwise / left turn
+        input::post(input::Type::ROTATION, (int8_t)-steps); // counter-clockwise / left turn
     } else {
-        current_count++; // This reports clockwise / right turn
+        input::post(input::Type::ROTATION, steps); // clockwise / right turn
     }
-    rotation_count = current_count;
-    
+
     last_interrupt_time = now;
     exti_interrupt_flag_clear(ENCODER_S1_EXTI);
 }
@@ -52,54 +126,117 @@ void encoder::rotation_isr() {
 void encoder::key_isr() {
     uint64_t now = get_timer_value();
     if ((now - last_interrupt_time) > DEBOUNCE_TIME_MS) {
-        key_pressed_flag = true;
+        input::post(input::Type::ENCODER_KEY, 1);
         last_interrupt_time = now;
     }
     exti_interrupt_flag_clear(ENCODER_KEY_EXTI);
 }
 
+// Configures KEY (PB12) for button press; shared by both init variants.
+static void key_init() {
+    // Pull-up input mode and clocks come from board_pins.h (which also
+    // documents the PB12 clash with SD chip select in MSC builds).
+    gpio_exti_source_select(GPIO_PORT_SOURCE_GPIOB, GPIO_PIN_SOURCE_12);
+    exti_init(ENCODER_KEY_EXTI, EXTI_INTERRUPT, EXTI_TRIG_FALLING);
+    exti_interrupt_flag_clear(ENCODER_KEY_EXTI);
+    eclic_enable_interrupt(ENCODER_KEY_IRQn); // level/priority: irq_map.c
+}
+
 // Public function to initialize the hardware
 void encoder::init() {
-    rcu_periph_clock_enable(ENCODER_S1_CLK);
-    rcu_periph_clock_enable(RCU_AF);
-
-    // Configure S1 (PB10) as interrupt source, S2 (PB11) as simple input
-    gpio_init(ENCODER_S1_PORT, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, ENCODER_S1_PIN);
-    gpio_init(ENCODER_S2_PORT, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, ENCODER_S2_PIN);
+    // S1/S2 pull-up input modes and clocks come from board_pins.h;
+    // S1 (PB10) is the interrupt source, S2 (PB11) a simple input.
 
     // *** CRITICAL CHANGE: Trigger only on FALLING edge, not BOTH ***
     gpio_exti_source_select(GPIO_PORT_SOURCE_GPIOB, GPIO_PIN_SOURCE_10);
-    exti_init(ENCODER_S1_EXTI, EXTI_INTERRUPT, EXTI_TRIG_FALLING); 
+    exti_init(ENCODER_S1_EXTI, EXTI_INTERRUPT, EXTI_TRIG_FALLING);
     exti_interrupt_flag_clear(ENCODER_S1_EXTI);
-    eclic_irq_enable(ENCODER_S1_IRQn, 1, 0);
+    eclic_enable_interrupt(ENCODER_S1_IRQn); // level/priority: irq_map.c
 
-    // Configure KEY (PB12) for button press
-    gpio_init(ENCODER_KEY_PORT, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, ENCODER_KEY_PIN);
-    
-    gpio_exti_source_select(GPIO_PORT_SOURCE_GPIOB, GPIO_PIN_SOURCE_12);
-    exti_init(ENCODER_KEY_EXTI, EXTI_INTERRUPT, EXTI_TRIG_FALLING);
-    exti_interrupt_flag_clear(ENCODER_KEY_EXTI);
-    eclic_irq_enable(ENCODER_KEY_IRQn, 1, 0);
+    key_init();
 }
 
-// Public function to check for a button press
-bool encoder::is_pressed() {
-    if (key_pressed_flag) {
-        key_pressed_flag = false; // Clear the flag after reading
-        return true;
-    }
-    return false;
+// Hardware quadrature decoding (see rotary_encoder.h for the wiring
+// requirement). TIMER1 tracks the phase signals entirely in silicon:
+// decoder mode 2 counts every edge of both phases, so the counter is
+// exact no matter how long the main loop is held off by display traffic.
+// The CH0 capture interrupt only wakes the event loop -- even if it is
+// starved, counts accumulate in hardware and nothing is lost.
+void encoder::init_timer_decode() {
+    rcu_periph_clock_enable(ENCODER_TIMER_CLKP);
+    rcu_periph_clock_enable(ENCODER_TIMER_CLK);
+
+    // Phase inputs with pull-ups, same as the EXTI variant.
+    gpio_init(ENCODER_TIMER_PORT, GPIO_MODE_IPU, GPIO_OSPEED_50MHZ, ENCODER_TIMER_PINS);
+
+    timer_deinit(ENCODER_TIMER);
+    timer_parameter_struct timer_initpara;
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = 0;       // count raw quadrature edges
+    timer_initpara.period    = 0xFFFF;  // free-running; deltas wrap in 16 bits
+    timer_init(ENCODER_TIMER, &timer_initpara);
+
+    // Both channels sample their own pin directly; the capture filter
+    // replaces the EXTI variant's ROTATION_DEBOUNCE_MS software debounce.
+    timer_ic_parameter_struct ic_initpara;
+    timer_channel_input_struct_para_init(&ic_initpara);
+    ic_initpara.icpolarity  = TIMER_IC_POLARITY_RISING;
+    ic_initpara.icselection = TIMER_IC_SELECTION_DIRECTTI;
+    ic_initpara.icprescaler = TIMER_IC_PSC_DIV1;
+    ic_initpara.icfilter    = 0x0A; // ~1.3 us of agreement before an edge counts
+    timer_input_capture_config(ENCODER_TIMER, TIMER_CH_0, &ic_initpara);
+    timer_input_capture_config(ENCODER_TIMER, TIMER_CH_1, &ic_initpara);
+
+    timer_quadrature_decoder_mode_config(ENCODER_TIMER, TIMER_QUAD_DECODER_MODE2,
+                                         TIMER_IC_POLARITY_RISING, TIMER_IC_POLARITY_RISING);
+    timer_counter_value_config(ENCODER_TIMER, 0);
+    last_timer_counter = 0;
+    edge_residual = 0;
+    timer_decode_active = true;
+
+    // CH0 captures just post INPUT so the WFI loop wakes per movement.
+    timer_interrupt_flag_clear(ENCODER_TIMER, TIMER_INT_FLAG_CH0);
+    timer_interrupt_enable(ENCODER_TIMER, TIMER_INT_CH0);
+    eclic_enable_interrupt(ENCODER_TIMER_IRQn); // level/priority: irq_map.c
+    timer_enable(ENCODER_TIMER);
+
+    key_init();
+}
+
+// Wake-up only: the count itself lives in the TIMER1 counter register.
+void encoder::timer_decode_isr() {
+    timer_interrupt_flag_clear(ENCODER_TIMER, TIMER_INT_FLAG_CH0);
+    events::post(events::INPUT);
 }
 
 // Public function to get the net rotation count
 int8_t encoder::get_rotation() {
-    int8_t count = 0;
-    if (rotation_count != 0) {
-        // Atomically read and reset the count
-        eclic_global_interrupt_disable();
-        count = rotation_count;
-        rotation_count = 0;
-        eclic_global_interrupt_enable();
+    if (timer_decode_active) {
+        // The 16-bit counter read is atomic and the subtraction handles
+        // wrap, so no interrupt masking is needed on this path. Edges that
+        // do not yet complete a detent are carried to the next call.
+        uint16_t counter = (uint16_t)timer_counter_read(ENCODER_TIMER);
+        int16_t delta = (int16_t)(counter - last_timer_counter);
+        last_timer_counter = counter;
+
+        edge_residual = (int16_t)(edge_residual + delta);
+        int16_t detents = (int16_t)(edge_residual / EDGES_PER_DETENT);
+        edge_residual = (int16_t)(edge_residual - detents * EDGES_PER_DETENT);
+
+        // Scale the batch by the velocity gain. The hardware counter
+        // carries no timestamps, so the batch end time stands in for
+        // each detent's; at the speeds where the gain engages, the CH0
+        // wake keeps polls far denser than detents anyway.
+        if (detents != 0) {
+            int16_t mag = (int16_t)((detents < 0) ? -detents : detents);
+            int32_t scaled = mag * accel_multiplier(mag, get_timer_value());
+            if (scaled > INT8_MAX) scaled = INT8_MAX;
+            detents = (int16_t)((detents < 0) ? -scaled : scaled);
+        }
+        return (int8_t)detents;
     }
-    return count;
+
+    // EXTI-decoded detents arrive through the input event queue
+    // (input_events.h); only the hardware decoder is polled here.
+    return 0;
 }
\ No newline at end of file
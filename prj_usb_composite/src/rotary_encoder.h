@@ -9,18 +9,28 @@ namespace encoder {
     // Initializes GPIOs and interrupts for the encoder
     void init();
 
-    // Checks if the encoder button has been pressed since the last check.
-    // This function is "destructive" - it clears the pressed flag.
-    bool is_pressed();
-
-    // Gets the rotation delta since the last check.
-    // Returns > 0 for clockwise, < 0 for counter-clockwise, 0 for no rotation.
+    // Alternative init: hardware quadrature decoding via TIMER1's encoder
+    // interface. The timer counts both edges of both phases in silicon, so
+    // fast spins never alias no matter how busy the CPU is. Requires the
+    // encoder's S1/S2 to be wired to PA0/PA1 (TIMER1_CH0/CH1) -- the stock
+    // PB10/PB11 wiring only reaches TIMER1 as CH2/CH3, which the encoder
+    // interface cannot use, hence the EXTI-based init() above stays the
+    // default. The key on PB12 is configured identically in both variants.
+    void init_timer_decode();
+
+    // Gets the rotation step count since the last check from the
+    // hardware decoder (init_timer_decode() only; always 0 in EXTI mode,
+    // where detents and key presses are queued via input_events.h
+    // instead). Returns > 0 for clockwise, < 0 for counter-clockwise;
+    // fast spins return more steps per detent through the velocity
+    // acceleration curve (see rotary_encoder.cpp).
     // This function is "destructive" - it resets the internal counter.
     int8_t get_rotation();
 
     // --- Functions below are for internal use by ISRs ---
     void key_isr();
     void rotation_isr();
+    void timer_decode_isr();
 
 } // namespace encoder
 
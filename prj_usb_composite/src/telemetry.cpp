@@ -0,0 +1,160 @@
+/*!
+    \file    telemetry.cpp
+    \brief   ADC0 scan-mode telemetry over circular DMA (see telemetry.h)
+*/
+#include "telemetry.h"
+
+extern "C" {
+#include "gd32vf103.h"
+#include "systick.h"
+#include "dma_arbiter.h"
+#include "sram.h"
+}
+
+// Outside the extern "C" block: carries the C++ claim registry.
+#include "longan_nano_dma_alloc.h"
+
+#if I2C_SENSORS
+#include "i2c_master.h"
+#include "events.h"
+#endif
+
+namespace telemetry {
+namespace {
+
+// Conversion ring: RingPairs (temperature, Vrefint) scan sweeps, kept
+// full forever by circular DMA. The DMA count is a whole number of
+// sweeps, so slot parity is stable: even = channel 16, odd = channel 17.
+constexpr uint32_t RingPairs = 16;
+volatile uint16_t ring[RingPairs * 2] SRAM_DMA_BUFFER;
+
+uint16_t latest_mv = 0;
+int16_t latest_dc = 0;
+int16_t latest_ext_dc = INT16_MIN;
+
+// GD32VF103 datasheet figures: Vrefint 1.2 V typical; temperature
+// sensor V25 = 1.45 V with a -4.1 mV/degC slope.
+constexpr uint32_t VrefintMv = 1200;
+constexpr int32_t V25Mv = 1450;
+constexpr int32_t SlopeUvPerC = 4100;
+
+#if I2C_SENSORS
+// The sensor board's TMP102-class part on the expansion header: 12-bit
+// temperature register at pointer 0, 0.0625 degC per LSB.
+constexpr uint8_t SensorAddr7 = 0x48;
+uint8_t sensor_raw[2];
+bool sensor_inflight = false;
+
+void sensor_done(i2c_xfer_result result, void *) {
+    sensor_inflight = false;
+    if (result != I2C_XFER_OK) {
+        return; // keep the last good reading; errors show in GET_STATS
+    }
+    int16_t raw12 = static_cast<int16_t>(
+        (sensor_raw[0] << 4) | (sensor_raw[1] >> 4));
+    if (raw12 & 0x800) {
+        raw12 = static_cast<int16_t>(raw12 | 0xF000); // sign-extend
+    }
+    latest_ext_dc = static_cast<int16_t>((raw12 * 625) / 1000);
+}
+
+// Runs from the I2C event ISR: queue the dispatch as a completion. A
+// full queue just drops the wake; service() below runs
+// i2c_master_service() every heartbeat anyway.
+void i2c_wake() { events::completions().post([] { i2c_master_service(); }); }
+#endif
+
+} // namespace
+
+void init() {
+    rcu_periph_clock_enable(RCU_ADC0);
+    rcu_periph_clock_enable(RCU_DMA0);
+    // APB2 / 8 keeps CK_ADC inside the 14 MHz limit at every supported
+    // SYSTEM_CLOCK_PROFILE.
+    rcu_adc_clock_config(RCU_CKADC_CKAPB2_DIV8);
+
+    dma_parameter_struct cfg;
+    dma_deinit(DMA0, DMA0_ADC0_CH);
+    cfg.periph_addr  = (uint32_t)(&ADC_RDATA(ADC0));
+    cfg.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+    cfg.memory_addr  = (uint32_t)ring;
+    cfg.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+    cfg.periph_width = DMA_PERIPHERAL_WIDTH_16BIT;
+    cfg.memory_width = DMA_MEMORY_WIDTH_16BIT;
+    cfg.direction    = DMA_PERIPHERAL_TO_MEMORY;
+    cfg.number       = RingPairs * 2;
+    cfg.priority     = dma_arbiter_priority(DMA0, DMA0_ADC0_CH);
+    dma_init(DMA0, DMA0_ADC0_CH, &cfg);
+    dma_circulation_enable(DMA0, DMA0_ADC0_CH);
+    dma_channel_enable(DMA0, DMA0_ADC0_CH);
+    dma_arbiter_note_start(DMA0, DMA0_ADC0_CH, RingPairs * 2);
+
+    adc_deinit(ADC0);
+    adc_mode_config(ADC_MODE_FREE);
+    adc_special_function_config(ADC0, ADC_SCAN_MODE, ENABLE);
+    adc_special_function_config(ADC0, ADC_CONTINUOUS_MODE, ENABLE);
+    adc_data_alignment_config(ADC0, ADC_DATAALIGN_RIGHT);
+    adc_tempsensor_vrefint_enable();
+    adc_channel_length_config(ADC0, ADC_REGULAR_CHANNEL, 2);
+    // The internal channels want the longest sample time (>= 17.1 us);
+    // a full sweep is then ~42 us at 12 MHz CK_ADC, ~48 KB/s of DMA
+    // halfwords -- noise next to the SPI streams on this controller.
+    adc_regular_channel_config(ADC0, 0, ADC_CHANNEL_16, ADC_SAMPLETIME_239POINT5);
+    adc_regular_channel_config(ADC0, 1, ADC_CHANNEL_17, ADC_SAMPLETIME_239POINT5);
+    adc_external_trigger_source_config(ADC0, ADC_REGULAR_CHANNEL,
+                                       ADC0_1_EXTTRIG_REGULAR_NONE);
+    adc_external_trigger_config(ADC0, ADC_REGULAR_CHANNEL, ENABLE);
+    adc_dma_mode_enable(ADC0);
+    adc_enable(ADC0);
+    delay_1ms(1); // tSTAB before calibration
+    adc_calibration_enable(ADC0);
+    // One software trigger; continuous mode chains every sweep after it.
+    adc_software_trigger_enable(ADC0, ADC_REGULAR_CHANNEL);
+
+#if I2C_SENSORS
+    // 100 kHz: the sensor board has no fast-mode parts, and standard
+    // mode is the tolerant choice for header wiring.
+    i2c_master_init(100000, i2c_wake);
+#endif
+}
+
+void service() {
+    // Average a snapshot of the ring. The DMA keeps writing underneath;
+    // halfword reads are atomic and the window only has to be recent,
+    // not coherent, so no masking is needed.
+    uint32_t temp_sum = 0;
+    uint32_t vref_sum = 0;
+    for (uint32_t i = 0; i < RingPairs; i++) {
+        temp_sum += ring[i * 2];
+        vref_sum += ring[i * 2 + 1];
+    }
+    uint32_t vref_raw = vref_sum / RingPairs;
+    if (vref_raw == 0) {
+        return; // no conversion has landed yet
+    }
+    // Vdd from the known 1.2 V reference, then the sensor voltage
+    // against that Vdd -- the readings self-correct for supply droop.
+    uint32_t vdd_mv = (VrefintMv * 4095U) / vref_raw;
+    uint32_t vtemp_mv = ((temp_sum / RingPairs) * vdd_mv) / 4095U;
+    latest_mv = static_cast<uint16_t>(vdd_mv);
+    latest_dc = static_cast<int16_t>(
+        250 + ((V25Mv - static_cast<int32_t>(vtemp_mv)) * 10000) / SlopeUvPerC);
+
+#if I2C_SENSORS
+    // One sensor sweep per heartbeat; the completion comes back through
+    // the completion queue. The service pass doubles as the bus watchdog,
+    // so a wedged sensor is timed out here even with no wake pending.
+    i2c_master_service();
+    if (!sensor_inflight) {
+        sensor_inflight = i2c_master_read(SensorAddr7, 0x00, true,
+                                          sensor_raw, sizeof(sensor_raw),
+                                          sensor_done, nullptr);
+    }
+#endif
+}
+
+uint16_t supply_mv() { return latest_mv; }
+int16_t die_temp_dc() { return latest_dc; }
+int16_t ext_temp_dc() { return latest_ext_dc; }
+
+} // namespace telemetry
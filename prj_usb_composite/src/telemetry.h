@@ -0,0 +1,46 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstdint>
+
+/**
+ * @brief Supply-voltage and die-temperature telemetry with zero-CPU
+ *        sampling.
+ *
+ * ADC0 free-runs in scan mode over its two internal channels (the
+ * temperature sensor and Vrefint) and DMA0 CH0 circles the conversions
+ * into a small SRAM ring: no interrupt fires and no code touches the
+ * ADC after init. The heartbeat-paced service() pass averages the ring
+ * and folds the result into millivolts and tenths of a degree; the
+ * SOF-paced REPORT_STATUS push carries both to the host dashboard.
+ *
+ * Polled ADC reads from the main loop would have been simpler, but the
+ * internal channels need their longest sample time (~17 us each), and
+ * that wait would land as jitter exactly where the draw dispatch
+ * cannot afford it.
+ *
+ * I2C_SENSORS=1 builds (the expansion-header sensor board) add an
+ * external temperature reading over the interrupt-driven I2C master
+ * (lib/i2c): service() queues one register read per heartbeat and the
+ * completion lands via the PRIO_COMPLETION queue, so the bus never
+ * blocks the loop.
+ */
+namespace telemetry {
+
+// Clocks ADC0 plus its DMA channel and starts the free-running scan.
+void init();
+
+// Decimation pass, riding the TIMER5 health heartbeat (health_service).
+void service();
+
+// Latest folded readings; zero until the first service() pass.
+uint16_t supply_mv();
+int16_t die_temp_dc(); // tenths of a degree Celsius
+
+// Latest external-sensor reading, tenths of a degree Celsius.
+// INT16_MIN until one lands (always, on I2C_SENSORS=0 builds).
+int16_t ext_temp_dc();
+
+} // namespace telemetry
+
+#endif // TELEMETRY_H
@@ -0,0 +1,23 @@
+#ifndef TRACE_IDS_H
+#define TRACE_IDS_H
+
+#include <cstdint>
+
+// Event ids for the binary trace (lib/system/evtrace.h). Mirrored in
+// tools/decode_trace.py - keep the two lists in step. Argument meanings
+// are noted per id; unused arguments are zero.
+enum TraceId : uint16_t {
+    TRACE_USB_OUT_PKT    = 0x0001, // custom HID OUT packet serviced   (arg16 = bytes)
+    TRACE_DISP_SLOT_DROP = 0x0002, // update dropped, all slots busy   (arg16 = command byte)
+    TRACE_BLIT_START     = 0x0003, // panel DMA blit started           (arg16 = slot index)
+    TRACE_BLIT_DONE      = 0x0004, // blit-complete ISR ran            (arg16 = slot index)
+    TRACE_MSC_FETCH      = 0x0005, // SD chunk fetch issued            (arg16 = bytes, arg32 = byte address)
+    TRACE_MSC_IN_SEND    = 0x0006, // MSC chunk armed on IN endpoint   (arg16 = bytes)
+    TRACE_MSC_CSW        = 0x0007, // MSC command status sent          (arg16 = CSW status)
+    TRACE_INPUT_EVENT    = 0x0008, // input event dispatched           (arg16 = input::Type, arg32 = capture-to-dispatch cycles)
+    TRACE_DISP_CRC_FAIL  = 0x0009, // integrity CRC mismatch, rect dropped (arg16 = sequence number)
+    TRACE_ISR_LATENCY    = 0x000A, // new worst-case ISR hold-off (arg16 = microseconds, arg32 = sample index)
+    TRACE_SD_CMD         = 0x000B, // SD command frame completed (arg16 = command index, arg32 = R1 response)
+};
+
+#endif // TRACE_IDS_H
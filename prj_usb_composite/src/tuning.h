@@ -0,0 +1,47 @@
+/*!
+    \file    tuning.h
+    \brief   cfgstore key assignments for this project
+
+    lib/cfgstore moves numbered 32-bit words; what the numbers mean is
+    decided here, in one place, so the console, the consumers, and the
+    host tooling agree. Keys are append-only: never renumber a shipped
+    key, retire it and take the next id, or a fleet unit with old values
+    stored reads them as something else after an update.
+
+    Every key has a build-time default and the stored value overrides
+    it at boot, so a wiped store is always a working configuration.
+*/
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <cstdint>
+
+namespace tuning {
+
+// SOF frames (ms) between unsolicited status pushes. Default 32; lower
+// tightens host flow control at the cost of IN bandwidth.
+constexpr uint8_t KeyStatusPushFrames = 0;
+
+// Microseconds an MSC card write may stay busy before the device calls
+// it a stall and stops re-arming bulk reception until it completes
+// (see _msc_write_pipe_service). Default 20000; clamped to 1000..250000
+// (the SD busy ceiling).
+constexpr uint8_t KeyMscStallUs = 1;
+
+// Minutes between boot-over-boot counter persists (perflog.h).
+// Default 15; clamped to 1..1440. A lower value tightens the history
+// a power cut can lose at the cost of cfgstore page wear.
+constexpr uint8_t KeyPerfPersistMin = 2;
+
+// Lifetime aggregates owned by perflog.cpp -- telemetry, not
+// tunables; setting them over the console just corrupts the history.
+// KeyPerfBoots counts resets; the next five follow the perflog
+// counter order (rects, drops, crc failures, sd retries, stall
+// deferrals) and must stay contiguous.
+constexpr uint8_t KeyPerfBoots = 3;
+constexpr uint8_t KeyPerfCounterBase = 4; // .. KeyPerfCounterBase+4
+
+} // namespace tuning
+
+#endif /* TUNING_H */
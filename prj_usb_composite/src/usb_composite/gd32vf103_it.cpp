@@ -8,15 +8,37 @@
 #include "usb_device.h"
 #include "board.h"
 #include "rotary_encoder.h"
+#include "display_manager.h"
+#include "events.h"
+#include "isr_audit.h"
 #include <cstdio>
 extern "C" {
 #include "systick.h" // For delay_1ms
+#include "ramtext.h"
+#include "vectors.h"
 }
 
 extern "C" {
 
-void USBFS_IRQHandler(void) {
+// Runs from SRAM: USB interrupts fire per packet and per frame, and
+// flash wait states on the entry path add up (see ramtext.h).
+RAMTEXT void USBFS_IRQHandler(void) {
     UsbDevice::getInstance().isr();
+    // A parked display pipeline (IDLE_HINT) keeps the 1 kHz SOF tick
+    // from waking the deferred loop; packets unpark inside isr().
+    if (!display::DisplayManager::getInstance().idleParked()) {
+        events::post(events::USB);
+    }
+}
+
+// Directly-vectored ECLIC entry, registered by usb_intr_config(): the
+// compiler-generated prolog replaces the full context save the shared
+// trampoline in entry.S performs for non-vectored interrupts.
+RAMTEXT IRQ_VECTORED void usbfs_vectored_entry(void) {
+    UsbDevice::getInstance().isr();
+    if (!display::DisplayManager::getInstance().idleParked()) {
+        events::post(events::USB);
+    }
 }
 
 void USBFS_WKUP_IRQHandler(void) {
@@ -27,14 +49,40 @@ void TIMER2_IRQHandler(void) {
     UsbDevice::getInstance().timer_isr();
 }
 
+// Hardware quadrature decode (encoder::init_timer_decode()): TIMER1 counts
+// the phases itself; this interrupt only wakes the event loop.
+void TIMER1_IRQHandler(void) {
+    encoder::timer_decode_isr();
+}
+
 // This ISR now handles the single user key on the Longan Nano (PA8)
 void EXTI5_9_IRQHandler(void) {
     if (RESET != exti_interrupt_flag_get(USER_KEY_EXTI_LINE)) {
-        board_key_isr(); // Call the debounced key handler
+        board_key_isr(); // Disarms the line and starts the debounce timer
         exti_interrupt_flag_clear(USER_KEY_EXTI_LINE);
     }
 }
 
+// One-shot key debounce window expired (see board_key_init()).
+void TIMER4_IRQHandler(void) {
+    board_key_timer_isr();
+}
+
+// Health-monitor heartbeat (health::init()): wakes the watchdog-feed /
+// anomaly-window task independently of USB traffic.
+void TIMER5_IRQHandler(void) {
+    timer_interrupt_flag_clear(TIMER5, TIMER_INT_FLAG_UP);
+    events::post(events::HEALTH);
+}
+
+#if ISR_AUDIT
+// Hold-off audit sampler (isr_audit::init()): lowest interrupt in the
+// ECLIC map, so its entry delay bounds everyone else's hold-off.
+void TIMER6_IRQHandler(void) {
+    isr_audit::sample_isr();
+}
+#endif
+
 void EXTI10_15_IRQHandler(void) {
     // Check if the rotation pin (PB10) triggered the interrupt
     if (RESET != exti_interrupt_flag_get(EXTI_10)) {
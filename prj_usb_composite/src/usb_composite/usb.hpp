@@ -58,6 +58,26 @@ namespace usb {
     */
     bool send_custom_hid_report(const uint8_t* buffer, size_t length);
 
+    /*!
+        \brief      Posts a scatter-gather TX descriptor on the display IN endpoint.
+                    The buffer holds a whole number of concatenated 64-byte wire
+                    packets; the data-IN ISR hands it to the driver as one
+                    multi-packet transfer, so the packets stream back to back
+                    from the TX FIFO with no per-packet setup between them.
+                    The buffer must stay untouched until custom_hid_burst_busy()
+                    reads false.
+        \param[in]  buffer: concatenated wire packets (length % 64 == 0)
+        \param[in]  length: total byte count
+        \retval     false if the queue is full or the length is malformed.
+    */
+    bool send_custom_hid_burst(const uint8_t* buffer, size_t length);
+
+    /*!
+        \brief      True while any posted burst descriptor is queued or on the
+                    wire (its buffer is still owned by the endpoint).
+    */
+    bool custom_hid_burst_busy();
+
 } // namespace usb
 
 #endif // USB_HPP
\ No newline at end of file
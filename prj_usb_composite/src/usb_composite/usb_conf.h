@@ -22,7 +22,23 @@ extern "C" {
 
 /* USB Core and Driver Config */
 #define USB_SOF_OUTPUT              1U
-#define USB_LOW_POWER               0U
+
+/* Battery builds set USB_DEEP_SLEEP=1 (config.py): bus suspend then
+   parks the MCU in DEEP_SLEEP with SRAM retained (the suspend interrupt
+   gates the USB core clocks and issues the PMU entry), and the USBFS
+   wakeup EXTI line brings it back - see UsbDevice::wakeup_isr for the
+   clock restore. With the flag off, suspend only changes device state
+   and the core keeps running. */
+#ifndef USB_DEEP_SLEEP
+#define USB_DEEP_SLEEP              0U
+#endif
+#define USB_LOW_POWER               USB_DEEP_SLEEP
+
+#if USB_DEEP_SLEEP && defined(HEALTH_WDG_RESET) && HEALTH_WDG_RESET
+/* The free watchdog runs from IRC40K straight through DEEP_SLEEP, and
+   nothing feeds it while the bus is suspended. */
+#error "USB_DEEP_SLEEP and HEALTH_WDG_RESET cannot be combined"
+#endif
 
 /* Select USB Core */
 #define USE_USB_FS
@@ -36,30 +52,68 @@ extern "C" {
     #endif
 #endif
 
+/* Compile-time interface composition flags; defaulted here because
+   the FIFO budget below depends on them. The full story -- interface
+   numbering, what each flag removes -- is with the interface map in
+   usbd_conf.h. */
+#ifndef USB_STD_HID
+#define USB_STD_HID                 1
+#endif
+#ifndef USB_MSC
+#define USB_MSC                     1
+#endif
+
 /* USB FIFO Size Configuration */
 /*
  * Total available FIFO size for the GD32VF103 is 1.25KB (1280 bytes or 320 words).
  * RX FIFO is shared for all OUT endpoints.
  * TX FIFOs are dedicated for each IN endpoint.
- * The sum of all FIFO sizes must not exceed the total available size.
  * Sizes are in 32-bit words (4 bytes).
+ *
+ * Each TX FIFO is sized against its endpoint's wMaxPacketSize in
+ * usbd_conf.h; the RX FIFO is whatever remains, which gives the
+ * dominant traffic of this device - display payload and MSC writes on
+ * the shared OUT path - every word the IN endpoints don't need. An
+ * undersized RX FIFO never corrupts data, it just NAKs the host and
+ * quietly caps bulk OUT throughput.
 */
+#define USB_FIFO_TOTAL_WORDS        320U  // 1280 bytes of shared FIFO RAM
+
+// TX FIFO for Control Endpoint 0 IN (64-byte max packet; control IN
+// stages are short descriptor replies, two packets of slack is plenty)
+#define TX0_FIFO_FS_SIZE            32U   // 128 bytes
+
+// TX FIFO for Standard HID IN Endpoint 1 (8-byte reports; 16 words is
+// the hardware minimum for a TX FIFO, so a USB_STD_HID=0 build cannot
+// shrink it further -- the register field floor applies even idle)
+#define TX1_FIFO_FS_SIZE            16U   // 64 bytes
+
+// TX FIFO for Custom HID IN Endpoint 2 (64-byte status/trace reports;
+// two packets so a report can be loaded while the previous one drains)
+#define TX2_FIFO_FS_SIZE            32U   // 128 bytes
+
+// TX FIFO for MSC IN Endpoint 3 (64-byte bulk packets; four packets
+// keeps the read pipeline ahead of the host during sustained reads).
+// With the MSC interface compiled out (USB_MSC=0, usbd_conf.h) the
+// endpoint never transmits, so the FIFO drops to the register-floor
+// minimum and its other 48 words deepen the RX FIFO below -- bulk OUT
+// display throughput headroom for free on display-only builds.
+#if USB_MSC
+#define TX3_FIFO_FS_SIZE            64U   // 256 bytes
+#else
+#define TX3_FIFO_FS_SIZE            16U   // 64 bytes (unused; hw minimum)
+#endif
 
-// RX FIFO for all OUT endpoints (Custom HID OUT, MSC OUT)
-#define RX_FIFO_FS_SIZE             128U  // 512 bytes
-
-// TX FIFO for Control Endpoint 0 IN
-#define TX0_FIFO_FS_SIZE            64U   // 256 bytes
-
-// TX FIFO for Standard HID IN Endpoint 1
-#define TX1_FIFO_FS_SIZE            16U   // 64 bytes (Packet size is 8 bytes)
-
-// TX FIFO for Custom HID IN Endpoint 2
-#define TX2_FIFO_FS_SIZE            16U   // 64 bytes (Packet size is 2 bytes)
-
-// TX FIFO for MSC IN Endpoint 3
-#define TX3_FIFO_FS_SIZE            64U   // 256 bytes (Packet size is 64 bytes)
+// RX FIFO for all OUT endpoints (Custom HID OUT, MSC OUT): everything
+// the TX FIFOs leave over. 176 words = 704 bytes on the full
+// composite, i.e. around ten 64-byte bulk OUT packets plus their
+// status-queue words; 224 words on a USB_MSC=0 build.
+#define RX_FIFO_FS_SIZE             (USB_FIFO_TOTAL_WORDS - \
+                                     TX0_FIFO_FS_SIZE - TX1_FIFO_FS_SIZE - \
+                                     TX2_FIFO_FS_SIZE - TX3_FIFO_FS_SIZE)
 
-/* Total allocated: 128 + 64 + 16 + 16 + 64 = 288 words. This is less than the 320-word limit. */
+#if (TX0_FIFO_FS_SIZE + TX1_FIFO_FS_SIZE + TX2_FIFO_FS_SIZE + TX3_FIFO_FS_SIZE) >= USB_FIFO_TOTAL_WORDS
+#error "TX FIFO allocations leave no room for the RX FIFO"
+#endif
 
 #endif /* USB_CONF_H */
\ No newline at end of file
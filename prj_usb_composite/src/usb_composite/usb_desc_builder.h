@@ -0,0 +1,118 @@
+/*!
+    \file    usb_desc_builder.h
+    \brief   constexpr builders for USB descriptor structures
+
+    \version 2025-02-10, firmware for GD32VF103
+*/
+
+#ifndef USB_DESC_BUILDER_H
+#define USB_DESC_BUILDER_H
+
+extern "C" {
+    #include "usbd_core.h"
+}
+
+#include "usb_types.h"
+
+// The descriptor sets used to be hand-maintained byte-for-byte, and the
+// lengths and wTotalLength offsets were a recurring source of bugs when
+// interfaces were added or removed. These constexpr factories build each
+// descriptor with its bLength derived from the type, and the
+// configuration total is taken from sizeof() of the complete packed set,
+// so every size is computed -- and checked -- at compile time. The
+// resulting objects are constant-initialized and live in flash.
+
+namespace usb {
+namespace desc {
+
+// The structs are declared with #pragma pack(1); if a toolchain change
+// ever reintroduced padding, every length below would silently be wrong.
+static_assert(sizeof(usb_desc_dev)    == 18U, "device descriptor must be packed");
+static_assert(sizeof(usb_desc_config) ==  9U, "configuration descriptor must be packed");
+static_assert(sizeof(usb_desc_itf)    ==  9U, "interface descriptor must be packed");
+static_assert(sizeof(usb_desc_ep)     ==  7U, "endpoint descriptor must be packed");
+static_assert(sizeof(usb::hid::DescHid) == 9U, "HID descriptor must be packed");
+
+/*!
+    \brief  build a configuration descriptor whose wTotalLength is the
+            size of the complete packed descriptor-set struct
+*/
+template <typename ConfigSet>
+constexpr usb_desc_config configuration(uint8_t num_interfaces, uint8_t max_power_2ma)
+{
+    static_assert(sizeof(ConfigSet) <= 0xFFFFU, "configuration set too large");
+    return {
+        .header = {
+            .bLength         = sizeof(usb_desc_config),
+            .bDescriptorType = USB_DESCTYPE_CONFIG
+        },
+        .wTotalLength         = sizeof(ConfigSet),
+        .bNumInterfaces       = num_interfaces,
+        .bConfigurationValue  = 1U,
+        .iConfiguration       = 0U,
+        .bmAttributes         = 0x80, // Bus-powered
+        .bMaxPower            = max_power_2ma
+    };
+}
+
+/*!
+    \brief  build an interface descriptor
+*/
+constexpr usb_desc_itf interface(uint8_t number, uint8_t num_endpoints,
+                                 uint8_t itf_class, uint8_t subclass, uint8_t protocol)
+{
+    return {
+        .header = {
+            .bLength         = sizeof(usb_desc_itf),
+            .bDescriptorType = USB_DESCTYPE_ITF
+        },
+        .bInterfaceNumber     = number,
+        .bAlternateSetting    = 0x00,
+        .bNumEndpoints        = num_endpoints,
+        .bInterfaceClass      = itf_class,
+        .bInterfaceSubClass   = subclass,
+        .bInterfaceProtocol   = protocol,
+        .iInterface           = 0x00
+    };
+}
+
+/*!
+    \brief  build an endpoint descriptor
+*/
+constexpr usb_desc_ep endpoint(uint8_t address, uint8_t attributes,
+                               uint16_t max_packet, uint8_t interval)
+{
+    return {
+        .header = {
+            .bLength         = sizeof(usb_desc_ep),
+            .bDescriptorType = USB_DESCTYPE_EP
+        },
+        .bEndpointAddress     = address,
+        .bmAttributes         = attributes,
+        .wMaxPacketSize       = max_packet,
+        .bInterval            = interval
+    };
+}
+
+/*!
+    \brief  build a class HID descriptor referencing one report descriptor
+*/
+constexpr usb::hid::DescHid hid(uint16_t report_desc_len)
+{
+    return {
+        .header = {
+            .bLength         = sizeof(usb::hid::DescHid),
+            .bDescriptorType = usb::hid::DESC_TYPE_HID
+        },
+        .bcdHID               = 0x0111,
+        .bCountryCode         = 0x00,
+        .bNumDescriptors      = 1U,
+        .bDescriptorType      = usb::hid::DESC_TYPE_REPORT,
+        .wDescriptorLength    = report_desc_len,
+    };
+}
+
+} // namespace desc
+} // namespace usb
+
+#endif /* USB_DESC_BUILDER_H */
@@ -12,15 +12,21 @@
 #include <cstring>
 #include <cstdio>
 #include "lcd.h"
-#include "shared_defs.h"
 #include "display_manager.h"
+#include "console.h"
+#include "evtrace.h"
+#include "trace_ids.h"
+#include "profile.h"
+#include "cfgstore.h"
+#include "tuning.h"
+#include "mtimer.h"
 
 // Forward declare C functions from the library that we will call
 extern "C" {
     #include "usbd_transc.h"
     void usbd_isr(usb_core_driver *udev);
     void usb_timer_irq(void);
-    void serial_string_get(uint16_t *unicode_str);
+    void system_clock_resume(void); // lib/system, DEEP_SLEEP wake-up path
 }
 
 // ===================================================================
@@ -33,181 +39,378 @@ bool usb::is_configured() { return UsbDevice::getInstance().is_configured(); }
 void usb::send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons) { UsbDevice::getInstance().send_mouse_report(x, y, wheel, buttons); }
 void usb::send_keyboard_report(uint8_t modifier, uint8_t key) { UsbDevice::getInstance().send_keyboard_report(modifier, key); }
 void usb::send_consumer_report(uint16_t usage_code) { UsbDevice::getInstance().send_consumer_report(usage_code); }
-bool usb::send_custom_hid_report(const uint8_t* buffer, size_t length) { UsbDevice::getInstance().send_custom_hid_report(buffer, length); }
+void usb::press_consumer(uint16_t usage_code) { UsbDevice::getInstance().press_consumer(usage_code); }
+bool usb::send_custom_hid_report(const uint8_t* buffer, size_t length) { return UsbDevice::getInstance().send_custom_hid_report(buffer, length); }
+bool usb::send_custom_hid_burst(const uint8_t* buffer, size_t length) { return UsbDevice::getInstance().send_custom_hid_burst(buffer, length); }
+bool usb::custom_hid_burst_busy() { return UsbDevice::getInstance().custom_hid_burst_busy(); }
 bool usb::is_std_hid_transfer_complete() { return UsbDevice::getInstance().is_in_transfer_complete(); }
+const usb::NakStats& usb::nak_stats() { return UsbDevice::getInstance().m_nak_stats; }
 // ===================================================================
 // UsbDevice Class Implementation
 // ===================================================================
 
-#if not defined(USE_SD_CARD_MSC) || (USE_SD_CARD_MSC == 0)
-usbd_mem_cb& get_msc_mem_fops() {
-    return *(usbd_mem_cb*)(0);
-}
-#endif
-
 UsbDevice& UsbDevice::getInstance() {
     static UsbDevice instance; // Guaranteed to be destroyed, instantiated on first use
     return instance;
 }
 
-UsbDevice::UsbDevice() : m_msc_enabled(false), m_in_transfer_complete(true) {
+UsbDevice::UsbDevice() : m_msc_enabled(false) {
     memset(&m_core_driver, 0, sizeof(usb_core_driver));
     memset(&m_class_core, 0, sizeof(usb_class_core));
     memset(&m_descriptors, 0, sizeof(usb_desc));
+#if USB_STD_HID
     memset(&m_std_hid_handler, 0, sizeof(usb::hid::StandardHidHandler));
+#endif
     memset(&m_custom_hid_handler, 0, sizeof(usb::hid::CustomHidHandler));
+#if USB_MSC
     memset(&m_msc_handler, 0, sizeof(usb::msc::MscHandler));
+#endif
 
     m_class_core.init = _init_cb;
     m_class_core.deinit = _deinit_cb;
     m_class_core.req_proc = _req_handler_cb;
     m_class_core.data_in = _data_in_cb;
     m_class_core.data_out = _data_out_cb;
+    m_class_core.SOF = _sof_cb;
 
     m_descriptors.dev_desc = (uint8_t *)&composite_dev_desc;
+#if USB_MSC
     m_descriptors.config_desc = (uint8_t *)&composite_config_desc;
+#else
+    m_descriptors.config_desc = (uint8_t *)&hid_only_config_desc;
+#endif
+    m_descriptors.bos_desc = (uint8_t *)composite_bos_desc;
     m_descriptors.strings = usbd_composite_strings;
 
-    serial_string_get((uint16_t*)m_descriptors.strings[usb::STR_IDX_SERIAL]);
+    // The serial string (UTF-16 conversion of the device unique ID) is
+    // filled in by the enum layer on the first host request for it, not
+    // here: our hosts rarely ask, and after a watchdog reset every cycle
+    // before usbd_connect() extends the bus blackout.
 }
 
 bool UsbDevice::is_in_transfer_complete() {
-    return m_in_transfer_complete;
+#if USB_STD_HID
+    // "Complete" now means every queued standard HID report has been
+    // transmitted, not merely that the last usbd_ep_send returned.
+    return !m_std_hid_in_queue.busy &&
+           (m_std_hid_in_queue.head == m_std_hid_in_queue.tail);
+#else
+    return true; // no standard HID queue to drain on this build
+#endif
 }
 
 void UsbDevice::init(bool enable_msc) {
+#if USB_MSC
     m_msc_enabled = enable_msc;
 
-    // --- Dynamic Descriptor Modification ---
+    // Both configuration variants are built at compile time and live in
+    // flash; just point the core at the one matching the MSC setting.
+    // The host never sees the MSC interface when it is disabled.
     if (!m_msc_enabled) {
-        // If MSC is disabled, modify the descriptor before initializing the core.
-        // The host will never see the MSC interface.
-        composite_config_desc.config.bNumInterfaces = 2; // Only HID interfaces
-        composite_config_desc.config.wTotalLength = HID_ONLY_CONFIG_DESC_SIZE;
+        m_descriptors.config_desc = (uint8_t *)&hid_only_config_desc;
     }
-    
+#else
+    // The MSC interface is compiled out: the HID-only configuration set
+    // is the only one in the image and the constructor already picked it.
+    (void)enable_msc;
+#endif
+
     eclic_global_interrupt_enable();
-    eclic_priority_group_set(ECLIC_PRIGROUP_LEVEL2_PRIO2);
+    // The priority group and all level assignments are programmed by
+    // irq_map_apply() in _init(), before any driver runs.
     usb_rcu_config();
     usb_timer_init();
     usb_intr_config();
     usbd_init(&m_core_driver, &m_descriptors, &m_class_core);
 }
 
-void UsbDevice::poll() { /* For non-interrupt driven logic */ }
+void UsbDevice::poll() {
+#if USB_MSC
+    // MSC read pipeline: start the next card fetch here in the main
+    // loop. The transfer itself is SPI DMA straight into the media
+    // buffer, so this returns immediately and the USB interrupt keeps
+    // streaming the previous chunk to the host in parallel.
+    if (m_msc_handler.read_active) {
+        if (m_msc_handler.read_error) {
+            _msc_read_pipe_fail();
+        } else {
+            _msc_read_pipe_fetch();
+            if (m_msc_handler.read_ready && m_msc_handler.read_in_idle) {
+                _msc_read_pipe_send();
+            }
+        }
+        // NAK pressure sample (see usb::NakStats): the IN endpoint is
+        // idle with no chunk ready, so every host IN token gets a NAK.
+        if (m_msc_handler.read_in_idle && !m_msc_handler.read_ready) {
+            m_nak_stats.msc_in_polls++;
+        }
+    }
+
+    // MSC write pipeline: start the card program for latched OUT chunks
+    // and re-arm reception as buffers free up. The card transfer is SPI
+    // DMA started here in the main loop, so the USB interrupt only ever
+    // latches chunks and LCD blits keep dispatching on the other bus.
+    if (m_msc_handler.write_active) {
+        _msc_write_pipe_service();
+        // NAK pressure sample: the host still has chunks to send and the
+        // OUT endpoint is unarmed, so its retries are being NAKed.
+        if (!m_msc_handler.write_rx_armed && (0U != m_msc_handler.scsi_blk_len)) {
+            m_nak_stats.msc_out_polls++;
+        }
+    }
+#endif /* USB_MSC */
+
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+    // Benchmark replies are produced in the OUT ISR but sent from here so
+    // the IN-report queue keeps a single producer (the main loop).
+    if (m_bench_echo_pending) {
+        if (send_custom_hid_report(m_bench_echo, CUSTOM_HID_IN_PACKET)) {
+            m_bench_echo_pending = false;
+        }
+    }
+    if (m_bench_sink_done) {
+        uint8_t report[6] = {
+            usb::bench::CMD_BENCH, usb::bench::SINK,
+            static_cast<uint8_t>(m_bench_sink_count),
+            static_cast<uint8_t>(m_bench_sink_count >> 8),
+            static_cast<uint8_t>(m_bench_sink_count >> 16),
+            static_cast<uint8_t>(m_bench_sink_count >> 24)
+        };
+        if (send_custom_hid_report(report, sizeof(report))) {
+            m_bench_sink_done = false;
+        }
+    }
+    // Source mode claims the IN endpoint once the report queue has fully
+    // drained; the data-IN ISR then chains pattern packets with no copies
+    // until the requested count is exhausted.
+    if ((m_bench_source_remaining != 0U) && !m_custom_hid_in_queue.busy &&
+        (m_custom_hid_in_queue.head == m_custom_hid_in_queue.tail)) {
+        m_custom_hid_in_queue.busy = true;
+        usbd_ep_send(&m_core_driver, CUSTOM_HID_IN_EP, m_bench_pattern, CUSTOM_HID_IN_PACKET);
+    }
+#endif
+}
 bool UsbDevice::is_configured() { return m_core_driver.dev.cur_status == USBD_CONFIGURED; }
 
 // --- ISR Handlers ---
 void UsbDevice::isr() { usbd_isr(&m_core_driver); }
 void UsbDevice::wakeup_isr() {
-    if (m_core_driver.bp.low_power) { /* Resume MCU clock logic here if needed */ }
+    if (m_core_driver.bp.low_power) {
+        // DEEP_SLEEP left CK_SYS on IRC8M. Restore the PLL profile first
+        // so the rest of resume runs at full speed, then ungate the USB
+        // core clocks the suspend handler switched off. Everything the
+        // host negotiated (address, configuration, endpoint state) sat in
+        // retained SRAM and registers, so no re-enumeration follows -- the
+        // device answers traffic as soon as resume signalling ends.
+        system_clock_resume();
+        usb_clock_active(&m_core_driver);
+    }
     exti_interrupt_flag_clear(EXTI_18);
 }
 void UsbDevice::timer_isr() { usb_timer_irq(); }
 
-// --- Report Sending Methods ---
-void UsbDevice::send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons) {
-    uint8_t report[5] = {REPORT_ID_MOUSE, buttons, (uint8_t)x, (uint8_t)y, (uint8_t)wheel};
-    if (m_in_transfer_complete) {
-        m_in_transfer_complete = false;
-        
-        // Flush and re-arm the Custom HID OUT endpoint to kick the driver
-        // out of its unstable idle state before starting a new IN transfer.
-        usbd_fifo_flush(&m_core_driver, CUSTOM_HID_OUT_EP);
-        usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
+// --- IN-Report Queue ---
+void UsbDevice::_start_in_entry(InReportQueue& q, uint8_t ep) {
+    InReportQueue::Entry& entry = q.entries[q.tail];
+    q.busy = true;
+
+    // Flush and re-arm the Custom HID OUT endpoint to kick the driver
+    // out of its unstable idle state before starting a new IN transfer.
+    usbd_fifo_flush(&m_core_driver, CUSTOM_HID_OUT_EP);
+    _rearm_custom_hid_out();
+
+    if (entry.ext != nullptr) {
+        // Scatter-gather descriptor: one transfer spanning several
+        // packets. The driver's TXFE path refills the FIFO back to back,
+        // so the packets go out with no per-packet setup between them.
+        usbd_ep_send(&m_core_driver, ep, const_cast<uint8_t*>(entry.ext),
+                     entry.ext_len);
+    } else {
+        usbd_ep_send(&m_core_driver, ep, entry.data, entry.len);
+    }
+}
+
+bool UsbDevice::_queue_in_report(InReportQueue& q, uint8_t ep,
+                                 const uint8_t* data, uint8_t len, uint8_t pad_to) {
+    uint8_t next = (uint8_t)((q.head + 1U) & (InReportQueue::Depth - 1U));
+    if (next == q.tail) {
+        return false; // queue full, report dropped
+    }
 
-        usbd_ep_send(&m_core_driver, STD_HID_IN_EP, report, 5);
+    InReportQueue::Entry& entry = q.entries[q.head];
+    entry.ext = nullptr;
+    memcpy(entry.data, data, len);
+    if (pad_to > len) {
+        memset(entry.data + len, 0, (size_t)(pad_to - len));
+        len = pad_to;
+    }
+    entry.len = len;
+    q.head = next;
+
+    // If the endpoint is idle there is no transfer in flight, so the
+    // data-IN ISR cannot race us here; otherwise that ISR chains the
+    // next entry when the current transfer completes.
+    if (!q.busy) {
+        _start_in_entry(q, ep);
     }
+    return true;
 }
 
-void UsbDevice::send_keyboard_report(uint8_t modifier, uint8_t key) {
-    uint8_t report[9] = {REPORT_ID_KEYBOARD, modifier, 0, key, 0, 0, 0, 0, 0};
-    if (m_in_transfer_complete) {
-        m_in_transfer_complete = false;
+bool UsbDevice::_queue_in_burst(InReportQueue& q, uint8_t ep,
+                                const uint8_t* data, uint16_t len) {
+    uint8_t next = (uint8_t)((q.head + 1U) & (InReportQueue::Depth - 1U));
+    if (next == q.tail) {
+        return false; // queue full
+    }
+
+    InReportQueue::Entry& entry = q.entries[q.head];
+    entry.ext = data;
+    entry.ext_len = len;
+    entry.len = 0;
+    q.head = next;
 
-        // Flush and re-arm the Custom HID OUT endpoint to kick the driver
-        // out of its unstable idle state before starting a new IN transfer.
-        usbd_fifo_flush(&m_core_driver, CUSTOM_HID_OUT_EP);
-        usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
-        
-        usbd_ep_send(&m_core_driver, STD_HID_IN_EP, report, 9);
+    if (!q.busy) {
+        _start_in_entry(q, ep);
     }
+    return true;
 }
 
-void UsbDevice::send_consumer_report(uint16_t usage_code) {
-    uint8_t report[3] = {REPORT_ID_CONSUMER, (uint8_t)(usage_code & 0xFF), (uint8_t)(usage_code >> 8)};
-    if (m_in_transfer_complete) {
-        m_in_transfer_complete = false;
+bool UsbDevice::_burst_busy(const InReportQueue& q) {
+    // Walk tail..head: while busy the tail entry is the one on the wire,
+    // so the scan covers in-flight descriptors too. Conservative against
+    // the ISR retiring entries underneath us -- stale true, never stale
+    // false.
+    for (uint8_t i = q.tail; i != q.head;
+         i = (uint8_t)((i + 1U) & (InReportQueue::Depth - 1U))) {
+        if (q.entries[i].ext != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
 
-        // Flush and re-arm the Custom HID OUT endpoint to kick the driver
-        // out of its unstable idle state before starting a new IN transfer.
-        usbd_fifo_flush(&m_core_driver, CUSTOM_HID_OUT_EP);
-        usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
-        
-        usbd_ep_send(&m_core_driver, STD_HID_IN_EP, report, 3);
+void UsbDevice::_in_transfer_done(InReportQueue& q, uint8_t ep) {
+    // The entry at tail has just finished transmitting; retire it and
+    // start the next one, if any, without ever leaving the ISR.
+    q.tail = (uint8_t)((q.tail + 1U) & (InReportQueue::Depth - 1U));
+    if (q.tail != q.head) {
+        _start_in_entry(q, ep);
+    } else {
+        q.busy = false;
     }
 }
 
+// --- Report Sending Methods ---
+// Standard HID senders only deposit state; _sof() turns it into wire
+// traffic at one report per frame. Relative motion and wheel deltas
+// accumulate, so a fast encoder burst becomes a few large reports
+// instead of a backlog.
+#if USB_STD_HID
+void UsbDevice::send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons) {
+    m_mouse_x_noted = (int16_t)(m_mouse_x_noted + x);
+    m_mouse_y_noted = (int16_t)(m_mouse_y_noted + y);
+    m_wheel_noted = (int16_t)(m_wheel_noted + wheel);
+    m_mouse_buttons = buttons;
+}
+
+void UsbDevice::send_keyboard_report(uint8_t modifier, uint8_t key) {
+    m_kbd_modifier = modifier;
+    m_kbd_key = key;
+    m_kbd_noted++;
+}
+
+void UsbDevice::send_consumer_report(uint16_t usage_code) {
+    m_consumer_usage = usage_code;
+    m_consumer_state_noted++;
+}
+
+void UsbDevice::press_consumer(uint16_t usage_code) {
+    // One full press-then-release sequence; the SOF handler spends two
+    // consecutive frames on it, so every queued detent produces a
+    // distinct key event even if the caller fires faster than 2 ms.
+    m_consumer_key = usage_code;
+    m_consumer_noted++;
+}
+#else
+// Input API kept callable so the encoder and UI code need no guards of
+// their own; without the standard HID interface the events have nowhere
+// to go and are dropped here.
+void UsbDevice::send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons) {
+    (void)x; (void)y; (void)wheel; (void)buttons;
+}
+void UsbDevice::send_keyboard_report(uint8_t modifier, uint8_t key) {
+    (void)modifier; (void)key;
+}
+void UsbDevice::send_consumer_report(uint16_t usage_code) { (void)usage_code; }
+void UsbDevice::press_consumer(uint16_t usage_code) { (void)usage_code; }
+#endif /* USB_STD_HID */
+
 bool UsbDevice::send_custom_hid_report(const uint8_t* buffer, size_t length) {
-    // 1. Prevent sending a packet that is too large
+    // Prevent sending a packet that is too large
     if (length > CUSTOM_HID_IN_PACKET) {
         return false;
     }
 
-    // 2. Check if the USB endpoint is ready for another transfer
-    if (m_in_transfer_complete) {
-        m_in_transfer_complete = false; // Mark transfer busy
-
-        // 3. Prepare the full 64-byte report buffer
-        // The low-level driver expects a buffer of the exact endpoint packet size.
-        static uint8_t report_buffer[CUSTOM_HID_IN_PACKET] = {0};
-        
-        // Copy the user's data into the buffer. Unused bytes will be zero.
-        memcpy(report_buffer, buffer, length);
-        
-        // Flush and re-arm the Custom HID OUT endpoint to kick the driver
-        // out of its unstable idle state before starting a new IN transfer.
-        usbd_fifo_flush(&m_core_driver, CUSTOM_HID_OUT_EP);
-        usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
+    // The low-level driver expects a buffer of the exact endpoint packet
+    // size, so the queue pads the report out to a full 64 bytes.
+    return _queue_in_report(m_custom_hid_in_queue, CUSTOM_HID_IN_EP,
+                            buffer, (uint8_t)length, CUSTOM_HID_IN_PACKET);
+}
 
-        // 4. Send the entire 64-byte buffer.
-        usbd_ep_send(&m_core_driver, CUSTOM_HID_IN_EP, report_buffer, CUSTOM_HID_IN_PACKET);
-        return true; // Send initiated successfully
+bool UsbDevice::send_custom_hid_burst(const uint8_t* buffer, size_t length) {
+    // Descriptors carry concatenated full wire packets: every report the
+    // host parses is 64 bytes on this interface, so a burst is on-the-
+    // wire identical to queueing its packets one by one -- minus the
+    // per-packet transfer setup and completion interrupts in between.
+    if ((length == 0U) || (length > 0xFFFFU) ||
+        ((length % CUSTOM_HID_IN_PACKET) != 0U)) {
+        return false;
     }
+    return _queue_in_burst(m_custom_hid_in_queue, CUSTOM_HID_IN_EP,
+                           buffer, (uint16_t)length);
+}
 
-    return false; // Endpoint was not ready
+bool UsbDevice::custom_hid_burst_busy() {
+    return _burst_busy(m_custom_hid_in_queue);
 }
 
 bool UsbDevice::is_std_hid_transfer_complete() {
-    return m_in_transfer_complete;
+    return is_in_transfer_complete();
 }
 
 
 // --- Composite Dispatcher Methods ---
 uint8_t UsbDevice::_init_composite(uint8_t config_index) {
     (void)config_index;
+#if USB_STD_HID
     m_core_driver.dev.class_data[STD_HID_INTERFACE]    = &m_std_hid_handler;
-    m_core_driver.dev.class_data[CUSTOM_HID_INTERFACE] = &m_custom_hid_handler;
-    
     _std_hid_init();
+#endif
+    m_core_driver.dev.class_data[CUSTOM_HID_INTERFACE] = &m_custom_hid_handler;
     _custom_hid_init();
 
+#if USB_MSC
     if (m_msc_enabled) {
         m_core_driver.dev.class_data[MSC_INTERFACE] = &m_msc_handler;
         _msc_init();
     }
-    
+#endif
+
     return USBD_OK;
 }
 
 uint8_t UsbDevice::_deinit_composite(uint8_t config_index) {
     (void)config_index;
+#if USB_STD_HID
     _std_hid_deinit();
+#endif
     _custom_hid_deinit();
 
+#if USB_MSC
     if (m_msc_enabled) {
         _msc_deinit();
     }
+#endif
 
     return USBD_OK;
 }
@@ -219,51 +422,162 @@ uint8_t UsbDevice::_req_handler(usb::UsbRequest *req) {
      * SET_CONFIGURATION, etc.) *before* calling this function. We only need to
      * route the request to the correct interface handler based on wIndex.
      */
+    PROF_SCOPE("usb ctl: setup");
     uint8_t interface = static_cast<uint8_t>(req->wIndex & 0xFF);
 
     switch (interface) {
+#if USB_STD_HID
         case STD_HID_INTERFACE:    return _std_hid_req_handler(req);
+#endif
         case CUSTOM_HID_INTERFACE: return _custom_hid_req_handler(req);
+#if USB_MSC
         case MSC_INTERFACE:
             if (m_msc_enabled) {
                 return _msc_req_handler(req);
             }
             break; // Fall through to fail if MSC is not enabled
+#endif
         default:
             break;
     }
     return USBD_FAIL;
 }
 
+// The per-interface PROF_SCOPE tags below attribute ISR time to the
+// interface being serviced (prof::dump reports them alongside the other
+// counters). One shared usbd_isr serves HID, MSC and the display stream,
+// so when the frame rate drops under e.g. MSC activity, these say which
+// interface ate the budget instead of leaving the whole ISR a blur.
 uint8_t UsbDevice::_data_in(uint8_t ep_num) {
-    bool processed = false;
-    if (ep_num == (STD_HID_IN_EP & 0x7F)) { 
-        // This endpoint completion signifies a transfer is done
-        processed = true;
+#if USB_STD_HID
+    if (ep_num == (STD_HID_IN_EP & 0x7F)) {
+        PROF_SCOPE("usb in: std hid");
+        _in_transfer_done(m_std_hid_in_queue, STD_HID_IN_EP);
+        return USBD_OK;
     }
+#endif
     if (ep_num == (CUSTOM_HID_IN_EP & 0x7F)) {
-        // This endpoint completion also signifies a transfer is done
-        processed = true;
+        PROF_SCOPE("usb in: display");
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+        if (m_bench_source_remaining != 0U) {
+            // Source mode: chain the next pattern packet straight from the
+            // ISR; the report queue is empty for the whole stream.
+            if (--m_bench_source_remaining != 0U) {
+                usbd_ep_send(&m_core_driver, CUSTOM_HID_IN_EP,
+                             m_bench_pattern, CUSTOM_HID_IN_PACKET);
+            } else if (m_custom_hid_in_queue.tail != m_custom_hid_in_queue.head) {
+                _start_in_entry(m_custom_hid_in_queue, CUSTOM_HID_IN_EP);
+            } else {
+                m_custom_hid_in_queue.busy = false;
+            }
+            return USBD_OK;
+        }
+#endif
+        _in_transfer_done(m_custom_hid_in_queue, CUSTOM_HID_IN_EP);
+        return USBD_OK;
     }
+#if USB_MSC
     if (m_msc_enabled && (ep_num == (MSC_IN_EP & 0x7F))) {
+        PROF_SCOPE("usb in: msc");
         _msc_data_in();
         return USBD_OK; // MSC has its own complex state machine
     }
+#endif
 
-    if (processed) {
-        m_in_transfer_complete = 1U; // Release the global mutex
-        return USBD_OK;
-    }
-    
     return USBD_FAIL;
 }
 
+void UsbDevice::_sof() {
+    PROF_SCOPE("usb sof: hid flush");
+    // Pace the unsolicited status record (caps::StatusPush). A dedicated
+    // interrupt IN endpoint would be the textbook transport, but USBFS
+    // has four endpoints and the composite build uses all of them, so
+    // the record rides the display IN queue instead; the latch keeps
+    // this ISR down to a counter and report_service does the assembly.
+    // 32 frames = 32 ms, comfortably fresher than the stats poll and a
+    // fraction of a packet per second of IN bandwidth.
+    // Period from the parameter store (tuning.h), snapshotted on first
+    // use - cfgstore::init() ran long before the bus came up, and the
+    // cached read is a couple of loads, fine at SOF rate. Clamped so a
+    // stored 0 cannot turn every frame into a push.
+    static uint16_t status_push_frames = 0;
+    if (status_push_frames == 0) {
+        uint32_t v = cfgstore::get_or(tuning::KeyStatusPushFrames, 32);
+        status_push_frames = static_cast<uint16_t>((v < 4 || v > 1000) ? 32 : v);
+    }
+    static uint16_t status_frames = 0;
+    if (++status_frames >= status_push_frames) {
+        status_frames = 0;
+        display::DisplayManager::getInstance().requestStatusPush();
+    }
+#if USB_STD_HID
+    // Flush at most one standard HID report per frame. Priority order:
+    // an in-flight press/release sequence, new sequences, direct
+    // consumer state, keyboard, then merged mouse motion.
+    if (m_consumer_phase == 1U) {
+        uint8_t report[3] = {REPORT_ID_CONSUMER, 0, 0};
+        _queue_in_report(m_std_hid_in_queue, STD_HID_IN_EP, report, 3, 0);
+        m_consumer_phase = 0U;
+        m_consumer_done++;
+        return;
+    }
+    if (m_consumer_done != m_consumer_noted) {
+        uint16_t key = m_consumer_key;
+        uint8_t report[3] = {REPORT_ID_CONSUMER, (uint8_t)(key & 0xFF), (uint8_t)(key >> 8)};
+        _queue_in_report(m_std_hid_in_queue, STD_HID_IN_EP, report, 3, 0);
+        m_consumer_phase = 1U;
+        return;
+    }
+    if (m_consumer_state_sent != m_consumer_state_noted) {
+        // Catch up to the latest noted state in one report: intermediate
+        // values were superseded before they ever reached the wire.
+        uint16_t usage = m_consumer_usage;
+        uint8_t report[3] = {REPORT_ID_CONSUMER, (uint8_t)(usage & 0xFF), (uint8_t)(usage >> 8)};
+        _queue_in_report(m_std_hid_in_queue, STD_HID_IN_EP, report, 3, 0);
+        m_consumer_state_sent = m_consumer_state_noted;
+        return;
+    }
+    if (m_kbd_sent != m_kbd_noted) {
+        uint8_t report[9] = {REPORT_ID_KEYBOARD, m_kbd_modifier, 0, m_kbd_key, 0, 0, 0, 0, 0};
+        _queue_in_report(m_std_hid_in_queue, STD_HID_IN_EP, report, 9, 0);
+        m_kbd_sent = m_kbd_noted;
+        return;
+    }
+    int16_t dx = (int16_t)(m_mouse_x_noted - m_mouse_x_sent);
+    int16_t dy = (int16_t)(m_mouse_y_noted - m_mouse_y_sent);
+    int16_t dw = (int16_t)(m_wheel_noted - m_wheel_sent);
+    uint8_t buttons = m_mouse_buttons;
+    if ((0 != dx) || (0 != dy) || (0 != dw) || (buttons != m_mouse_buttons_sent)) {
+        // Clamp each axis to what one report can carry; any residue goes
+        // out on the following frames.
+        int16_t sx = (dx > 127) ? 127 : ((dx < -127) ? -127 : dx);
+        int16_t sy = (dy > 127) ? 127 : ((dy < -127) ? -127 : dy);
+        int16_t sw = (dw > 127) ? 127 : ((dw < -127) ? -127 : dw);
+        uint8_t report[5] = {REPORT_ID_MOUSE, buttons,
+                             (uint8_t)(int8_t)sx, (uint8_t)(int8_t)sy, (uint8_t)(int8_t)sw};
+        if (_queue_in_report(m_std_hid_in_queue, STD_HID_IN_EP, report, 5, 0)) {
+            m_mouse_x_sent = (int16_t)(m_mouse_x_sent + sx);
+            m_mouse_y_sent = (int16_t)(m_mouse_y_sent + sy);
+            m_wheel_sent = (int16_t)(m_wheel_sent + sw);
+            m_mouse_buttons_sent = buttons;
+        }
+    }
+#endif /* USB_STD_HID */
+}
+
 uint8_t UsbDevice::_data_out(uint8_t ep_num) {
-    if (ep_num == (CUSTOM_HID_OUT_EP & 0x7F)) { _custom_hid_data_out(); return USBD_OK; }
+    if (ep_num == (CUSTOM_HID_OUT_EP & 0x7F)) {
+        PROF_SCOPE("usb out: display");
+        _custom_hid_data_out();
+        return USBD_OK;
+    }
+#if USB_MSC
     if (m_msc_enabled && (ep_num == (MSC_OUT_EP & 0x7F))) {
+        PROF_SCOPE("usb out: msc");
         _msc_data_out();
         return USBD_OK;
     }
+#endif
     return USBD_FAIL;
 }
 
@@ -273,14 +587,19 @@ uint8_t UsbDevice::_deinit_cb(usb_dev *udev, uint8_t config_index) { (void)udev;
 uint8_t UsbDevice::_req_handler_cb(usb_dev *udev, usb_req *req) { (void)udev; return getInstance()._req_handler(reinterpret_cast<usb::UsbRequest*>(req)); }
 uint8_t UsbDevice::_data_in_cb(usb_dev *udev, uint8_t ep_num) { (void)udev; return getInstance()._data_in(ep_num); }
 uint8_t UsbDevice::_data_out_cb(usb_dev *udev, uint8_t ep_num) { (void)udev; return getInstance()._data_out(ep_num); }
+uint8_t UsbDevice::_sof_cb(usb_dev *udev) { (void)udev; getInstance()._sof(); return USBD_OK; }
 
 // ===================================================================
 // Localized Class Implementations
 // ===================================================================
 
 // --- Standard HID Implementation ---
+#if USB_STD_HID
 void UsbDevice::_std_hid_init() {
-    usbd_ep_setup(&m_core_driver, &(composite_config_desc.std_hid_epin));
+    // The HID/display endpoint descriptors are identical in every
+    // configuration set, so ep_setup reads the set that exists on all
+    // builds rather than the one currently served.
+    usbd_ep_setup(&m_core_driver, &(hid_only_config_desc.std_hid_epin));
 }
 
 void UsbDevice::_std_hid_deinit() {
@@ -334,12 +653,23 @@ uint8_t UsbDevice::_std_hid_req_handler(usb::UsbRequest *req) {
     }
     return USBD_OK;
 }
+#endif /* USB_STD_HID */
 
 // --- Custom HID Implementation ---
 void UsbDevice::_custom_hid_init() {
-    usbd_ep_setup(&m_core_driver, &(composite_config_desc.custom_hid_epin));
-    usbd_ep_setup(&m_core_driver, &(composite_config_desc.custom_hid_epout));
-    usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
+    usbd_ep_setup(&m_core_driver, &(hid_only_config_desc.display_epin));
+    usbd_ep_setup(&m_core_driver, &(hid_only_config_desc.display_epout));
+    _rearm_custom_hid_out();
+}
+
+void UsbDevice::_rearm_custom_hid_out() {
+    // When the DisplayManager is in the middle of a raw pixel stream the
+    // endpoint is pointed straight at the RECEIVING framebuffer slot, so
+    // the usbfs core's FIFO drain is the only copy that happens.
+    uint8_t* target = display::DisplayManager::getInstance().zeroCopyRxTarget(64U);
+    m_display_rx_zero_copy = (target != nullptr);
+    usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP,
+                  (target != nullptr) ? target : m_display_bounce[m_display_bounce_sel], 64U);
 }
 
 void UsbDevice::_custom_hid_deinit() {
@@ -348,68 +678,118 @@ void UsbDevice::_custom_hid_deinit() {
 }
 
 uint8_t UsbDevice::_custom_hid_req_handler(usb::UsbRequest *req) {
-    // Get the pointer to the control IN transaction state
-    usb_transc *transc = &m_core_driver.dev.transc_in[0];
-
-    switch(static_cast<usb::hid::HidReq>(req->bRequest)) {
-        case usb::hid::HidReq::GET_REPORT: 
-            break;
+    // The display interface is a vendor-specific bulk class now: there is
+    // no report descriptor to serve and no HID class requests to answer.
+    (void)req;
+    return USBD_FAIL;
+}
 
-        case usb::hid::HidReq::GET_IDLE:
-            transc->xfer_buf = (uint8_t *)&m_custom_hid_handler.idlestate;
-            transc->remain_len = 1U;
-            usbd_ctl_send(&m_core_driver);
-            break;
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+bool UsbDevice::_bench_handle_packet(const uint8_t* pkt, uint32_t len) {
+    // Sink mode swallows everything, including what would otherwise be
+    // display commands, until the announced packet count has arrived.
+    if (m_bench_sink_remaining != 0U) {
+        m_bench_sink_count++;
+        if (--m_bench_sink_remaining == 0U) {
+            m_bench_sink_done = true;
+        }
+        return true;
+    }
 
-        case usb::hid::HidReq::GET_PROTOCOL:
-            transc->xfer_buf = (uint8_t *)&m_custom_hid_handler.protocol;
-            transc->remain_len = 1U;
-            usbd_ctl_send(&m_core_driver);
-            break;
+    if ((len < 2U) || (pkt[0] != usb::bench::CMD_BENCH)) {
+        return false;
+    }
 
-        case usb::hid::HidReq::SET_REPORT: 
-            m_custom_hid_handler.reportID = (uint8_t)(req->wValue); 
+    switch (pkt[1]) {
+        case usb::bench::ECHO:
+            memcpy(m_bench_echo, pkt, len);
+            memset(m_bench_echo + len, 0, CUSTOM_HID_IN_PACKET - len);
+            m_bench_echo_pending = true;
             break;
 
-        case usb::hid::HidReq::SET_IDLE: 
-            m_custom_hid_handler.idlestate = (uint8_t)(req->wValue >> 8); 
+        case usb::bench::SINK:
+            m_bench_sink_count = 0;
+            m_bench_sink_remaining = (uint32_t)pkt[2] | ((uint32_t)pkt[3] << 8) |
+                                     ((uint32_t)pkt[4] << 16) | ((uint32_t)pkt[5] << 24);
+            m_bench_sink_done = (m_bench_sink_remaining == 0U);
             break;
 
-        case usb::hid::HidReq::SET_PROTOCOL: 
-            m_custom_hid_handler.protocol = (uint8_t)(req->wValue); 
+        case usb::bench::SOURCE:
+            // Fill the pattern lazily so the ramp survives any earlier use
+            // of the buffer; poll() kicks the first transmission.
+            for (uint32_t i = 0; i < CUSTOM_HID_IN_PACKET; i++) {
+                m_bench_pattern[i] = (uint8_t)i;
+            }
+            m_bench_source_remaining = (uint32_t)pkt[2] | ((uint32_t)pkt[3] << 8) |
+                                       ((uint32_t)pkt[4] << 16) | ((uint32_t)pkt[5] << 24);
             break;
 
         default:
-            if (req->bRequest == static_cast<uint8_t>(usb::StdReq::GET_DESCRIPTOR)) {
-                if(usb::hid::DESC_TYPE_REPORT == (req->wValue >> 8)) {
-                    transc->remain_len = USB_MIN(CUSTOM_HID_REPORT_DESC_LEN, req->wLength);
-                    transc->xfer_buf = (uint8_t *)custom_hid_report_descriptor;
-                    usbd_ctl_send(&m_core_driver);
-                }
-            } else {
-                return USBD_FAIL;
-            }
-            break;
+            break; // Unknown benchmark op: swallow it.
     }
-    return USBD_OK;
+    return true;
 }
+#endif
 
 void UsbDevice::_custom_hid_data_out() {
     uint32_t received_count = usbd_rxcount_get(&m_core_driver, CUSTOM_HID_OUT_EP);
+    evt::note(TRACE_USB_OUT_PKT, (uint16_t)received_count);
 
     // This debug print is okay for now, but in production, even this should be removed from the ISR.
     // printf("DEBUG RX: size=%lu, data[0]=0x%02X, data[1]=0x%02X\n", ...);
 
     if (received_count == 0) {
-        usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
+        _rearm_custom_hid_out();
+        return;
+    }
+
+    if (m_display_rx_zero_copy) {
+        // The packet already sits inside the framebuffer slot; only the
+        // bookkeeping is left to do, then arm the next reception.
+        display::DisplayManager::getInstance().commitZeroCopyRx(received_count);
+        _rearm_custom_hid_out();
+        return;
+    }
+
+    uint8_t* pkt = m_display_bounce[m_display_bounce_sel];
+
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+    if (_bench_handle_packet(pkt, received_count)) {
+        // Benchmark traffic never retains the bounce buffer: re-arm it
+        // immediately so sink mode measures the bare transport.
+        _rearm_custom_hid_out();
+        return;
+    }
+#endif
+
+    // Console keystrokes go straight to the shell's RX ring; the
+    // DisplayManager never sees them (and the main-loop pump answers
+    // with REPORT_CONSOLE packets, see src/console.h).
+    if (pkt[0] == static_cast<uint8_t>(display::HostCommand::CONSOLE)) {
+        console::rxFromIsr(pkt, received_count);
+        m_display_bounce_sel ^= 1U;
+        _rearm_custom_hid_out();
         return;
     }
 
+    // Ping-pong: flip to the alternate bounce buffer and re-arm before the
+    // packet is parsed, so the host's next packet is accepted while this one
+    // is still being processed. The one exception is a command that starts a
+    // raw stream -- it must be parsed first so the following reception lands
+    // zero-copy in the framebuffer slot rather than in the bounce buffer.
+    bool starts_raw_stream =
+        (pkt[0] == static_cast<uint8_t>(display::HostCommand::DRAW_RECT)) &&
+        ((received_count < 8U) || (pkt[7] == 0U));
+    if (!starts_raw_stream) {
+        m_display_bounce_sel ^= 1U;
+        _rearm_custom_hid_out();
+    }
+
     // We pass the raw data directly to the DisplayManager.
-    display::DisplayManager::getInstance().handleUsbPacket(m_custom_hid_handler.data, received_count);
+    display::DisplayManager::getInstance().handleUsbPacket(pkt, received_count);
 
-    uint8_t command = m_custom_hid_handler.data[0];
-    uint8_t value   = m_custom_hid_handler.data[1];
+    uint8_t command = pkt[0];
+    uint8_t value   = pkt[1];
 
     switch (command) {
         // LED control logic uses 'value' which is data[1]
@@ -430,11 +810,16 @@ void UsbDevice::_custom_hid_data_out() {
         }
     }
 
-    // Re-arm the OUT endpoint to receive the next report from the host.
-    usbd_ep_recev(&m_core_driver, CUSTOM_HID_OUT_EP, m_custom_hid_handler.data, 64U);
+    // A raw-stream start was parsed above; arm the first payload reception
+    // now that the zero-copy target is known. All other packets were
+    // re-armed before parsing.
+    if (starts_raw_stream) {
+        _rearm_custom_hid_out();
+    }
 }
 
 // --- MSC Implementation ---
+#if USB_MSC
 void UsbDevice::_msc_init() {
     usbd_ep_setup(&m_core_driver, &(composite_config_desc.msc_epin));
     usbd_ep_setup(&m_core_driver, &(composite_config_desc.msc_epout));
@@ -488,6 +873,8 @@ void UsbDevice::_msc_data_out() { _msc_bbb_data_out(); }
 void UsbDevice::_msc_bbb_init() {
     m_msc_handler.bbb_state = usb::msc::BbbState::BBB_IDLE;
     m_msc_handler.bbb_status = usb::msc::BbbStatus::BBB_STATUS_NORMAL;
+    m_msc_handler.read_active = false;
+    m_msc_handler.write_active = false;
     for(uint8_t lun_num = 0U; lun_num < MEM_LUN_NUM; lun_num++) {
         get_msc_mem_fops().mem_init(lun_num);
     }
@@ -499,6 +886,8 @@ void UsbDevice::_msc_bbb_init() {
 void UsbDevice::_msc_bbb_reset() {
     m_msc_handler.bbb_state = usb::msc::BbbState::BBB_IDLE;
     m_msc_handler.bbb_status = usb::msc::BbbStatus::BBB_STATUS_RECOVERY;
+    m_msc_handler.read_active = false;
+    m_msc_handler.write_active = false;
     usbd_ep_recev(&m_core_driver, MSC_OUT_EP, (uint8_t *)&m_msc_handler.bbb_cbw, usb::msc::BBB_CBW_LENGTH);
 }
 
@@ -509,9 +898,7 @@ void UsbDevice::_msc_bbb_deinit() {
 void UsbDevice::_msc_bbb_data_in() {
     switch(m_msc_handler.bbb_state) {
         case usb::msc::BbbState::BBB_DATA_IN:
-            if(_scsi_process_cmd(m_msc_handler.bbb_cbw.bCBWLUN, &m_msc_handler.bbb_cbw.CBWCB[0]) < 0) {
-                _msc_bbb_csw_send(usb::msc::CswStatus::CMD_FAILED);
-            }
+            _msc_read_pipe_advance();
             break;
         case usb::msc::BbbState::BBB_SEND_DATA:
         case usb::msc::BbbState::BBB_LAST_DATA_IN:
@@ -568,6 +955,9 @@ void UsbDevice::_msc_bbb_csw_send(usb::msc::CswStatus csw_status) {
     m_msc_handler.bbb_csw.dCSWSignature = usb::msc::BBB_CSW_SIGNATURE;
     m_msc_handler.bbb_csw.bCSWStatus = static_cast<uint8_t>(csw_status);
     m_msc_handler.bbb_state = usb::msc::BbbState::BBB_IDLE;
+    m_msc_handler.read_active = false;  // ends any in-flight read pipeline
+    m_msc_handler.write_active = false; // likewise for the write pipeline
+    evt::note(TRACE_MSC_CSW, (uint16_t)csw_status);
 
     usbd_ep_send(&m_core_driver, MSC_IN_EP, (uint8_t *)&m_msc_handler.bbb_csw, usb::msc::BBB_CSW_LENGTH);
     usbd_ep_recev(&m_core_driver, MSC_OUT_EP, (uint8_t *)&m_msc_handler.bbb_cbw, usb::msc::BBB_CBW_LENGTH);
@@ -591,6 +981,8 @@ void UsbDevice::_msc_bbb_data_send(uint8_t *pbuf, uint32_t len) {
 }
 
 void UsbDevice::_msc_bbb_abort() {
+    m_msc_handler.read_active = false;
+    m_msc_handler.write_active = false;
     if((0U == m_msc_handler.bbb_cbw.bmCBWFlags) && 
        (0U != m_msc_handler.bbb_cbw.dCBWDataTransferLength) && 
        (usb::msc::BbbStatus::BBB_STATUS_NORMAL == m_msc_handler.bbb_status)) {
@@ -645,6 +1037,14 @@ int8_t UsbDevice::_scsi_test_unit_ready(uint8_t lun) {
         _scsi_sense_code(lun, usb::msc::scsi::SenseKey::NOT_READY, usb::msc::scsi::Asc::MEDIUM_NOT_PRESENT);
         return -1;
     }
+    // Media arrived since the last command (the background probe in
+    // usbd_msc_mem.cpp finished): answer one CHECK CONDITION with UNIT
+    // ATTENTION / MEDIUM_CHANGED so the host re-reads the capacity and
+    // mounts the volume, then report ready from the next poll on.
+    if(msc_mem_media_changed()) {
+        _scsi_sense_code(lun, usb::msc::scsi::SenseKey::UNIT_ATTENTION, usb::msc::scsi::Asc::MEDIUM_CHANGED);
+        return -1;
+    }
     m_msc_handler.bbb_datalen = 0U;
     return 0;
 }
@@ -698,9 +1098,12 @@ int8_t UsbDevice::_scsi_read10(uint8_t lun, uint8_t *params) {
             _scsi_sense_code(m_msc_handler.bbb_cbw.bCBWLUN, usb::msc::scsi::SenseKey::ILLEGAL_REQUEST, usb::msc::scsi::Asc::INVALID_CDB);
             return -1;
         }
+        m_msc_handler.bbb_datalen = m_msc_handler.scsi_blk_len;
+        // The data phase is produced by the read pipeline: poll() fetches
+        // the first chunk from the main loop and arms the IN endpoint.
+        _msc_read_pipe_start(lun);
     }
-    m_msc_handler.bbb_datalen = MSC_MEDIA_PACKET_SIZE;
-    return _scsi_process_read(lun);
+    return 0;
 }
 
 int8_t UsbDevice::_scsi_write10(uint8_t lun, uint8_t *params) {
@@ -729,44 +1132,283 @@ int8_t UsbDevice::_scsi_write10(uint8_t lun, uint8_t *params) {
             return -1;
         }
         m_msc_handler.bbb_state = usb::msc::BbbState::BBB_DATA_OUT;
-        usbd_ep_recev(&m_core_driver, MSC_OUT_EP, m_msc_handler.bbb_data, USB_MIN(m_msc_handler.scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
+        // Announce the full run so the medium can prepare for it (SD
+        // ACMD23 pre-erase across the whole range).
+        get_msc_mem_fops().mem_write_hint(lun, m_msc_handler.scsi_blk_len);
+        // Deferred write pipeline: chunks latch in the OUT interrupt and
+        // the card programs from poll() (see _msc_write_pipe_service).
+        m_msc_handler.write_q_head = 0U;
+        m_msc_handler.write_q_tail = 0U;
+        m_msc_handler.write_busy = false;
+        m_msc_handler.write_error = false;
+        m_msc_handler.write_stalled = false;
+        m_msc_handler.write_lun = lun;
+        m_msc_handler.write_active = true;
+        if(m_msc_handler.scsi_blk_len >= (2U * MSC_MEDIA_PACKET_SIZE)) {
+            // At least the first two chunks are full-size: double-buffer the
+            // data stage so the host streams the next chunk while the
+            // previous one is written to the card.
+            m_msc_handler.write_rx_sel = 0U; // explicit arms resume with bbb_data
+            m_msc_handler.write_rx_armed = true;
+            usbd_ep_recev_pingpong(&m_core_driver, MSC_OUT_EP,
+                                   m_msc_handler.bbb_data, m_msc_handler.bbb_data_alt,
+                                   MSC_MEDIA_PACKET_SIZE);
+        } else {
+            m_msc_handler.write_rx_buf = m_msc_handler.bbb_data;
+            m_msc_handler.write_rx_sel = 1U; // a possible tail lands in _alt
+            m_msc_handler.write_rx_armed = true;
+            usbd_ep_recev(&m_core_driver, MSC_OUT_EP, m_msc_handler.bbb_data, USB_MIN(m_msc_handler.scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
+        }
     } else {
         return _scsi_process_write(lun);
     }
     return 0;
 }
 
-int8_t UsbDevice::_scsi_process_read(uint8_t lun) {
-    uint32_t len = USB_MIN(m_msc_handler.scsi_blk_len, MSC_MEDIA_PACKET_SIZE);
-    if(get_msc_mem_fops().mem_read(lun, m_msc_handler.bbb_data, m_msc_handler.scsi_blk_addr, (uint16_t)(len / m_msc_handler.scsi_blk_size[lun])) < 0) {
-        _scsi_sense_code(lun, usb::msc::scsi::SenseKey::HARDWARE_ERROR, usb::msc::scsi::Asc::UNRECOVERED_READ_ERROR);
-        return -1;
+// --- MSC Read Pipeline ---
+// READ_10 used to fetch every chunk from the card inside the USB ISR and
+// only then start the USB transfer, so the bus idled during each SPI read
+// and the card idled during each USB send. The data phase is now pipelined
+// over the bbb_data/bbb_data_alt pair: poll() starts an asynchronous card
+// DMA straight into one buffer while the IN endpoint streams the other,
+// and the data-IN ISR chains a prefetched chunk the moment the previous
+// one completes. Card and bus run concurrently instead of taking turns,
+// and the main loop is free during the fetch as well.
+
+void UsbDevice::_msc_read_pipe_start(uint8_t lun) {
+    m_msc_handler.read_lun = lun;
+    m_msc_handler.read_fetch_addr = m_msc_handler.scsi_blk_addr;
+    m_msc_handler.read_fetch_len = m_msc_handler.scsi_blk_len;
+    m_msc_handler.read_sel = 0U;
+    m_msc_handler.read_ready = false;
+    m_msc_handler.read_in_idle = true;
+    m_msc_handler.read_fetching = false;
+    m_msc_handler.read_error = false;
+    m_msc_handler.read_active = true;
+}
+
+void UsbDevice::_msc_read_fetch_done(int8_t status) {
+    usb::msc::MscHandler &h = getInstance().m_msc_handler;
+    h.read_fetching = false;
+    if(status < 0) {
+        h.read_error = true; // poll() turns this into sense + failed CSW
+        return;
+    }
+    h.read_ready = true; // written last: the chunk is complete
+}
+
+void UsbDevice::_msc_read_pipe_fetch() {
+    if(m_msc_handler.read_ready || m_msc_handler.read_fetching ||
+       (0U == m_msc_handler.read_fetch_len)) {
+        return;
+    }
+    uint8_t lun = m_msc_handler.read_lun;
+    uint32_t len = USB_MIN(m_msc_handler.read_fetch_len, MSC_MEDIA_PACKET_SIZE);
+    uint8_t *buf = m_msc_handler.read_sel ? m_msc_handler.bbb_data_alt : m_msc_handler.bbb_data;
+    uint16_t blocks = (uint16_t)(len / m_msc_handler.scsi_blk_size[lun]);
+    evt::note(TRACE_MSC_FETCH, (uint16_t)len, m_msc_handler.read_fetch_addr);
+
+    // Stream the chunk from the card directly into the media buffer.
+    // Claim the chunk before starting: the completion interrupt may fire
+    // before mem_read_async even returns.
+    uint32_t addr = m_msc_handler.read_fetch_addr;
+    m_msc_handler.read_fetch_addr += len;
+    m_msc_handler.read_fetch_len  -= len;
+    m_msc_handler.read_ready_len = len;
+    m_msc_handler.read_fetching = true;
+    if(0 == get_msc_mem_fops().mem_read_async(lun, buf, addr, blocks, &UsbDevice::_msc_read_fetch_done)) {
+        return;
+    }
+
+    // Async start refused (engine busy, or a backend without it): fall
+    // back to the synchronous read right here in the main loop; the USB
+    // interrupt still streams the previous chunk over it.
+    m_msc_handler.read_fetching = false;
+    if(get_msc_mem_fops().mem_read(lun, buf, addr, blocks) < 0) {
+        m_msc_handler.read_error = true;
+        return;
     }
-    usbd_ep_send(&m_core_driver, MSC_IN_EP, m_msc_handler.bbb_data, len);
+    m_msc_handler.read_ready = true; // written last: the chunk is complete
+}
+
+void UsbDevice::_msc_read_pipe_fail() {
+    uint8_t lun = m_msc_handler.read_lun;
+    m_msc_handler.read_error = false;
+    m_msc_handler.read_active = false;
+    _scsi_sense_code(lun, usb::msc::scsi::SenseKey::HARDWARE_ERROR, usb::msc::scsi::Asc::UNRECOVERED_READ_ERROR);
+    _msc_bbb_csw_send(usb::msc::CswStatus::CMD_FAILED);
+}
+
+void UsbDevice::_msc_read_pipe_send() {
+    uint32_t len = m_msc_handler.read_ready_len;
+    uint8_t *buf = m_msc_handler.read_sel ? m_msc_handler.bbb_data_alt : m_msc_handler.bbb_data;
+
+    // Claim the endpoint and flip the pair before arming the transfer;
+    // its completion interrupt may fire at any point afterwards.
+    m_msc_handler.read_ready = false;
+    m_msc_handler.read_in_idle = false;
+    m_msc_handler.read_sel ^= 1U;
     m_msc_handler.scsi_blk_addr += len;
     m_msc_handler.scsi_blk_len  -= len;
     m_msc_handler.bbb_csw.dCSWDataResidue -= len;
     if(0U == m_msc_handler.scsi_blk_len) {
         m_msc_handler.bbb_state = usb::msc::BbbState::BBB_LAST_DATA_IN;
+        m_msc_handler.read_active = false;
     }
-    return 0;
+    evt::note(TRACE_MSC_IN_SEND, (uint16_t)len);
+    usbd_ep_send(&m_core_driver, MSC_IN_EP, buf, len);
 }
 
+void UsbDevice::_msc_read_pipe_advance() {
+    if(!m_msc_handler.read_active) {
+        return;
+    }
+    if(m_msc_handler.read_ready) {
+        // Fast path: the next chunk landed while the previous one was on
+        // the wire; chain it without a round trip through the main loop.
+        _msc_read_pipe_send();
+    } else {
+        // The card is still fetching; poll() sends once the chunk lands.
+        m_msc_handler.read_in_idle = true;
+    }
+}
+
+// --- MSC Write Pipeline ---
+// WRITE_10 used to program the card synchronously inside the USB OUT
+// interrupt: the CPU sat in the SD driver for milliseconds per chunk, the
+// main loop never ran, and the LCD's SPI idled for the whole copy even
+// though it is a separate bus with its own DMA channels. Completed
+// chunks now latch in a two-entry queue and poll() starts an
+// asynchronous card DMA from the main loop, re-arming reception as
+// buffers retire. Card, USB and LCD traffic overlap instead of taking
+// turns, with the USB interrupt reduced to pointer bookkeeping.
+
+// Data-phase OUT completion (USB interrupt context): latch only.
 int8_t UsbDevice::_scsi_process_write(uint8_t lun) {
+    (void)lun;
     uint32_t len = USB_MIN(m_msc_handler.scsi_blk_len, MSC_MEDIA_PACKET_SIZE);
-    if(get_msc_mem_fops().mem_write(lun, m_msc_handler.bbb_data, m_msc_handler.scsi_blk_addr, (uint16_t)(len / m_msc_handler.scsi_blk_size[lun])) < 0) {
-        _scsi_sense_code(lun, usb::msc::scsi::SenseKey::HARDWARE_ERROR, usb::msc::scsi::Asc::WRITE_FAULT);
-        return -1;
+
+    // With ping-pong reception the completed chunk sits in whichever buffer
+    // the core just handed over; one-shot receptions (armed at the data
+    // phase start, or by poll()) leave the rxbuf pointer NULL.
+    uint8_t *chunk = usbd_ep_pingpong_rxbuf(&m_core_driver, MSC_OUT_EP, NULL);
+    if(NULL == chunk) {
+        chunk = m_msc_handler.write_rx_buf;
     }
+
+    uint8_t slot = m_msc_handler.write_q_head & 1U;
+    m_msc_handler.write_q_buf[slot] = chunk;
+    m_msc_handler.write_q_addr[slot] = m_msc_handler.scsi_blk_addr;
+    m_msc_handler.write_q_len[slot] = len;
+    m_msc_handler.write_q_head++;
     m_msc_handler.scsi_blk_addr += len;
     m_msc_handler.scsi_blk_len  -= len;
     m_msc_handler.bbb_csw.dCSWDataResidue -= len;
-    if(0U == m_msc_handler.scsi_blk_len) {
+
+    // The ping-pong start auto-armed the alternate buffer for the chunk
+    // after this one; hold it there. Past this point every re-arm comes
+    // from poll(), which alternates the pair as card writes retire, so
+    // the core never receives into a buffer the SPI DMA is still reading.
+    usbd_ep_pingpong_hold(&m_core_driver, MSC_OUT_EP);
+    m_msc_handler.write_rx_armed =
+        (0U != m_core_driver.dev.transc_out[MSC_OUT_EP & 0x7FU].pp_enabled);
+    return 0;
+}
+
+void UsbDevice::_msc_write_pipe_done(int8_t status) {
+    usb::msc::MscHandler &h = getInstance().m_msc_handler;
+    if(status < 0) {
+        h.write_error = true; // poll() turns this into sense + failed CSW
+    }
+    h.write_stalled = false; // retries cleared: resume normal arming
+    h.write_busy = false; // written last: the chunk's buffer is free
+}
+
+void UsbDevice::_msc_write_pipe_fail() {
+    uint8_t lun = m_msc_handler.write_lun;
+    m_msc_handler.write_error = false;
+    m_msc_handler.write_active = false;
+    _scsi_sense_code(lun, usb::msc::scsi::SenseKey::HARDWARE_ERROR, usb::msc::scsi::Asc::WRITE_FAULT);
+    _msc_bbb_csw_send(usb::msc::CswStatus::CMD_FAILED);
+}
+
+void UsbDevice::_msc_write_pipe_service() {
+    usb::msc::MscHandler &h = m_msc_handler;
+    if(h.write_error) {
+        _msc_write_pipe_fail();
+        return;
+    }
+
+    // Start the oldest latched chunk on the card. The async start returns
+    // once the SPI DMA owns the transfer; a backend without an async path
+    // falls back to the synchronous write right here in the main loop --
+    // still off the USB interrupt, which keeps receiving over it.
+    if(!h.write_busy && (h.write_q_tail != h.write_q_head)) {
+        uint8_t slot = h.write_q_tail & 1U;
+        uint8_t lun = h.write_lun;
+        const uint8_t *buf = h.write_q_buf[slot];
+        uint32_t addr = h.write_q_addr[slot];
+        uint16_t blocks = (uint16_t)(h.write_q_len[slot] / h.scsi_blk_size[lun]);
+        h.write_q_tail++;
+        h.write_busy = true;
+        h.write_start = mtimer_now();
+        if(0 != get_msc_mem_fops().mem_write_async(lun, buf, addr, blocks, &UsbDevice::_msc_write_pipe_done)) {
+            _msc_write_pipe_done(get_msc_mem_fops().mem_write(lun, buf, addr, blocks));
+        }
+        if(h.write_error) {
+            _msc_write_pipe_fail();
+            return;
+        }
+    }
+
+    // Card stall detection: a healthy chunk program finishes in a few
+    // milliseconds; the SD spec allows 250 ms of busy, and a wear-leveling
+    // pause or a dying card can take all of it. Threshold from the
+    // parameter store (tuning.h), snapshotted on first use and clamped
+    // into the sane range.
+    if(h.write_busy && !h.write_stalled) {
+        static uint64_t stall_ticks = 0;
+        if(0U == stall_ticks) {
+            uint32_t us = cfgstore::get_or(tuning::KeyMscStallUs, 20000U);
+            us = (us < 1000U || us > 250000U) ? 20000U : us;
+            stall_ticks = (uint64_t)us * mtimer_ticks_per_us();
+        }
+        if((mtimer_now() - h.write_start) >= stall_ticks) {
+            h.write_stalled = true;
+        }
+    }
+
+    // Re-arm reception once a buffer is free: occupancy is the queued
+    // chunks plus the one on the card, bounded by the buffer pair.
+    if(!h.write_rx_armed && (0U != h.scsi_blk_len)) {
+        uint8_t in_use = (uint8_t)(h.write_q_head - h.write_q_tail)
+                       + (h.write_busy ? 1U : 0U);
+        if(in_use < 2U) {
+            if(h.write_stalled) {
+                // The card is stalling: leave the endpoint unarmed even
+                // though a buffer is free. Accepting another 4 KiB chunk
+                // now costs ~64 RXFLVL interrupts and FIFO copies for
+                // data that cannot go anywhere, stolen from the display
+                // path in the main loop; the held endpoint NAKs in pure
+                // hardware at zero CPU cost. _msc_write_pipe_done()
+                // clears the stall and the next poll re-arms.
+                m_nak_stats.stall_deferrals++;
+            } else {
+                uint8_t *buf = h.write_rx_sel ? h.bbb_data_alt : h.bbb_data;
+                h.write_rx_sel ^= 1U;
+                h.write_rx_buf = buf;
+                h.write_rx_armed = true;
+                usbd_ep_recev(&m_core_driver, MSC_OUT_EP, buf,
+                              USB_MIN(h.scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
+            }
+        }
+    }
+
+    // Everything received and on the card: close the command.
+    if((0U == h.scsi_blk_len) && (h.write_q_tail == h.write_q_head) && !h.write_busy) {
+        h.write_active = false;
         _msc_bbb_csw_send(usb::msc::CswStatus::CMD_PASSED);
-    } else {
-        usbd_ep_recev(&m_core_driver, MSC_OUT_EP, m_msc_handler.bbb_data, USB_MIN(m_msc_handler.scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
     }
-    return 0;
 }
 
 int8_t UsbDevice::_scsi_check_address_range(uint8_t lun, uint32_t blk_offset, uint16_t blk_nbr) {
@@ -781,5 +1423,30 @@ int8_t UsbDevice::_scsi_check_address_range(uint8_t lun, uint32_t blk_offset, ui
 int8_t UsbDevice::_scsi_read_format_capacity(uint8_t lun) { (void)lun; m_msc_handler.bbb_datalen = 0U; return 0; }
 int8_t UsbDevice::_scsi_mode_sense6(uint8_t lun) { (void)lun; m_msc_handler.bbb_datalen = 0U; return 0; }
 int8_t UsbDevice::_scsi_mode_sense10(uint8_t lun) { (void)lun; m_msc_handler.bbb_datalen = 0U; return 0; }
-int8_t UsbDevice::_scsi_request_sense(uint8_t lun, uint8_t *params) { (void)lun; (void)params; m_msc_handler.bbb_datalen = 0U; return 0; }
-int8_t UsbDevice::_scsi_verify10(uint8_t lun) { (void)lun; m_msc_handler.bbb_datalen = 0U; return 0; }
\ No newline at end of file
+// Fixed-format sense data (SPC-3). Returning real sense matters for the
+// media-change path: the host only reacts to the UNIT ATTENTION queued
+// by TEST UNIT READY if this command delivers it.
+int8_t UsbDevice::_scsi_request_sense(uint8_t lun, uint8_t *params) {
+    (void)lun;
+    constexpr uint8_t SENSE_DATA_LEN = 18U;
+    memset(m_msc_handler.bbb_data, 0, SENSE_DATA_LEN);
+    m_msc_handler.bbb_data[0] = 0x70U;                 /* current, fixed format */
+    m_msc_handler.bbb_data[7] = SENSE_DATA_LEN - 8U;   /* additional length */
+    if(m_msc_handler.scsi_sense_head != m_msc_handler.scsi_sense_tail) {
+        m_msc_handler.bbb_data[2]  = static_cast<uint8_t>(m_msc_handler.scsi_sense[m_msc_handler.scsi_sense_head].key);
+        m_msc_handler.bbb_data[12] = m_msc_handler.scsi_sense[m_msc_handler.scsi_sense_head].ASC;
+        m_msc_handler.scsi_sense_head++;
+        if(usb::msc::scsi::SENSE_LIST_DEEPTH == m_msc_handler.scsi_sense_head) {
+            m_msc_handler.scsi_sense_head = 0U;
+        }
+    }
+    uint8_t len = SENSE_DATA_LEN;
+    if(params[4] < len) {
+        len = params[4];   /* allocation length from the CDB */
+    }
+    m_msc_handler.bbb_datalen = len;
+    return 0;
+}
+int8_t UsbDevice::_scsi_verify10(uint8_t lun) { (void)lun; m_msc_handler.bbb_datalen = 0U; return 0; }
+#endif /* USB_MSC */
+
@@ -21,18 +21,60 @@ extern "C" {
 // Forward declaration
 class UsbDevice;
 
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+namespace usb {
+namespace bench {
+    // Transport-level benchmark protocol on the display bulk endpoints,
+    // intercepted before the DisplayManager sees the packet. Mirrored in
+    // tools/display_manager/config.py.
+    constexpr uint8_t CMD_BENCH = 0x0C;
+    enum Op : uint8_t {
+        ECHO   = 0x00, // reply with the same packet (round-trip latency)
+        SINK   = 0x01, // swallow the next N OUT packets, then report the count
+        SOURCE = 0x02  // stream N pattern packets on the IN endpoint
+    };
+} // namespace bench
+} // namespace usb
+#endif
+
 namespace usb {
     void init(bool);
     void poll();
     bool is_configured();
 
-    // Public API for sending reports
+    // Public API for sending reports. Standard HID input is coalesced:
+    // callers deposit state, and the SOF interrupt flushes at most one
+    // report per 1 ms frame (wheel deltas merge, repeated key calls
+    // collapse to the latest values).
     bool is_std_hid_transfer_complete();
     void send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons);
     void send_keyboard_report(uint8_t modifier, uint8_t key);
     void send_consumer_report(uint16_t usage_code);
+    // Queues one full press-then-release sequence of a consumer key;
+    // the two reports go out on consecutive frames.
+    void press_consumer(uint16_t usage_code);
     bool send_custom_hid_report(const uint8_t* buffer, size_t length);
-    bool is_in_transfer_complete(); 
+    // Scatter-gather burst on the display IN endpoint: posts one
+    // (buffer, length) descriptor the data-IN ISR feeds to the FIFO as
+    // a single multi-packet transfer. length must be a whole number of
+    // 64-byte wire packets and the buffer must stay untouched until
+    // custom_hid_burst_busy() reads false.
+    bool send_custom_hid_burst(const uint8_t* buffer, size_t length);
+    bool custom_hid_burst_busy();
+    bool is_in_transfer_complete();
+
+    // NAK-pressure counters, sampled once per main-loop poll(). This core
+    // raises no interrupt for a NAKed OUT packet (and a per-NAK IN
+    // interrupt would trade a NAK storm for an interrupt storm), so the
+    // device counts the poll intervals during which it was holding an MSC
+    // endpoint the host had data or tokens for -- a rate proxy, useful as
+    // a trend, not an absolute handshake count. GET_STATS counters 13-15.
+    struct NakStats {
+        uint32_t msc_in_polls;    // MSC IN held while the read pipe had no chunk
+        uint32_t msc_out_polls;   // MSC OUT unarmed while the host had chunks left
+        uint32_t stall_deferrals; // re-arms withheld during a card stall
+    };
+    const NakStats& nak_stats();
 }
 
 class UsbDevice {
@@ -49,7 +91,10 @@ public:
     void send_mouse_report(int8_t x, int8_t y, int8_t wheel, uint8_t buttons);
     void send_keyboard_report(uint8_t modifier, uint8_t key);
     void send_consumer_report(uint16_t usage_code);
+    void press_consumer(uint16_t usage_code);
     bool send_custom_hid_report(const uint8_t* buffer, size_t length);
+    bool send_custom_hid_burst(const uint8_t* buffer, size_t length);
+    bool custom_hid_burst_busy();
     bool is_in_transfer_complete();
 
 private:
@@ -68,12 +113,17 @@ private:
     uint8_t _req_handler(usb::UsbRequest *req);
     uint8_t _data_in(uint8_t ep_num);
     uint8_t _data_out(uint8_t ep_num);
+    // Start-of-frame handler: flushes the coalesced input state as at
+    // most one standard HID report per 1 ms frame.
+    void _sof();
 
+#if USB_STD_HID
     // --- Standard HID Implementation ---
     void _std_hid_init();
     void _std_hid_deinit();
     uint8_t _std_hid_req_handler(usb::UsbRequest *req);
     void _std_hid_data_in();
+#endif
 
     // --- Custom HID Implementation ---
     void _custom_hid_init();
@@ -81,7 +131,12 @@ private:
     uint8_t _custom_hid_req_handler(usb::UsbRequest *req);
     void _custom_hid_data_in();
     void _custom_hid_data_out();
+    // Re-arms the Custom HID OUT endpoint, pointing it directly at the
+    // DisplayManager's RECEIVING framebuffer slot when a raw pixel stream
+    // is active (zero-copy), or at the bounce buffer otherwise.
+    void _rearm_custom_hid_out();
 
+#if USB_MSC
     // --- MSC & BBB & SCSI Implementation ---
     void _msc_init();
     void _msc_deinit();
@@ -110,9 +165,29 @@ private:
     int8_t _scsi_read10(uint8_t lun, uint8_t *params);
     int8_t _scsi_write10(uint8_t lun, uint8_t *params);
     int8_t _scsi_verify10(uint8_t lun);
-    int8_t _scsi_process_read(uint8_t lun);
     int8_t _scsi_process_write(uint8_t lun);
+    // --- MSC read pipeline ---
+    // The READ_10 data phase overlaps the SD fetch with the USB transfer:
+    // poll() fetches chunk N+1 from the card while the IN endpoint streams
+    // chunk N out of the alternate buffer.
+    void _msc_read_pipe_start(uint8_t lun);
+    void _msc_read_pipe_fetch();   // main-loop context: start the next fetch
+    void _msc_read_pipe_send();    // arm the IN endpoint with the ready chunk
+    void _msc_read_pipe_advance(); // data-IN ISR: previous chunk completed
+    void _msc_read_pipe_fail();    // main-loop context: sense + failed CSW
+    // Card DMA completion for the async fetch (interrupt context).
+    static void _msc_read_fetch_done(int8_t status);
+    // --- MSC write pipeline ---
+    // The WRITE_10 data phase no longer programs the card inside the USB
+    // interrupt: completed OUT chunks queue for poll(), which starts an
+    // asynchronous card transfer and re-arms reception, so the card, the
+    // bus and the LCD's SPI all run concurrently.
+    void _msc_write_pipe_service(); // main-loop context: start/close chunks
+    void _msc_write_pipe_fail();    // main-loop context: sense + failed CSW
+    // Card DMA completion for the async write (interrupt context).
+    static void _msc_write_pipe_done(int8_t status);
     int8_t _scsi_check_address_range(uint8_t lun, uint32_t blk_offset, uint16_t blk_nbr);
+#endif /* USB_MSC */
 
     // Static C-style callbacks that bridge to the C++ class
     static uint8_t _init_cb(usb_dev *udev, uint8_t config_index);
@@ -120,11 +195,112 @@ private:
     static uint8_t _req_handler_cb(usb_dev *udev, usb_req *req);
     static uint8_t _data_in_cb(usb_dev *udev, uint8_t ep_num);
     static uint8_t _data_out_cb(usb_dev *udev, uint8_t ep_num);
+    static uint8_t _sof_cb(usb_dev *udev);
 
     static UsbDevice* s_instance;
 
-    // A single, global flag to prevent concurrent IN transfers
-    volatile bool m_in_transfer_complete;
+    // Lock-free single-producer/single-consumer queue of pending IN
+    // reports for one endpoint. The main loop enqueues at head, the
+    // data-IN ISR retires at tail, so neither index needs a critical
+    // section. A report stays in its slot until its transfer completes,
+    // because usbd_ep_send transmits straight from the slot memory.
+    //
+    // An entry is either an inline copy (ext == nullptr: the report was
+    // memcpy'd into data[]) or a scatter-gather descriptor (ext points
+    // at a caller-owned buffer of ext_len bytes, a whole number of
+    // 64-byte packets). A descriptor goes to the driver as ONE transfer,
+    // so the TXFE interrupt streams its packets back to back from the
+    // FIFO with no per-packet transfer setup in between -- the caller's
+    // buffer must stay untouched until burst_busy() reads false.
+    struct InReportQueue {
+        static constexpr uint8_t Depth = 8; // must be a power of two
+        struct Entry {
+            const uint8_t* ext;  // nullptr: inline report in data[]
+            uint16_t ext_len;
+            uint8_t len;
+            uint8_t data[CUSTOM_HID_IN_PACKET];
+        };
+        Entry entries[Depth];
+        volatile uint8_t head = 0;   // written by the main loop only
+        volatile uint8_t tail = 0;   // written by the ISR only
+        volatile bool    busy = false; // an entry is on the wire
+    };
+
+    // Enqueue a report for ep and start it immediately if the endpoint
+    // is idle; pad_to > len zero-extends the packet (Custom HID always
+    // sends full 64-byte reports). Returns false if the queue is full.
+    bool _queue_in_report(InReportQueue& q, uint8_t ep,
+                          const uint8_t* data, uint8_t len, uint8_t pad_to);
+    // Enqueue a scatter-gather descriptor: data must hold a whole number
+    // of full 64-byte wire packets and stay valid until the queue has
+    // retired the entry (see burst_busy). Returns false if the queue is
+    // full.
+    bool _queue_in_burst(InReportQueue& q, uint8_t ep,
+                         const uint8_t* data, uint16_t len);
+    // True while any descriptor entry is queued or on the wire.
+    static bool _burst_busy(const InReportQueue& q);
+    // Begin transmitting the entry at q.tail.
+    void _start_in_entry(InReportQueue& q, uint8_t ep);
+    // Called from the data-IN ISR: retire the finished entry and chain
+    // the next queued report, if any.
+    void _in_transfer_done(InReportQueue& q, uint8_t ep);
+
+#if defined(USB_BENCH_MODE) && (USB_BENCH_MODE == 1)
+    // --- USB Transport Benchmark ---
+    // Consumes CMD_BENCH packets in the OUT ISR; returns true if the
+    // packet belonged to the benchmark (including sink-mode swallows).
+    bool _bench_handle_packet(const uint8_t* pkt, uint32_t len);
+    volatile uint32_t m_bench_sink_remaining = 0;
+    volatile uint32_t m_bench_source_remaining = 0;
+    volatile bool     m_bench_sink_done = false;
+    volatile bool     m_bench_echo_pending = false;
+    uint32_t          m_bench_sink_count = 0;
+    uint8_t           m_bench_echo[CUSTOM_HID_IN_PACKET];
+    uint8_t           m_bench_pattern[CUSTOM_HID_IN_PACKET];
+#endif
+
+    // One queue per IN endpoint so a backlog of display status reports
+    // never delays a mouse/keyboard/consumer report, and vice versa.
+#if USB_STD_HID
+    InReportQueue m_std_hid_in_queue;
+#endif
+    InReportQueue m_custom_hid_in_queue;
+
+#if USB_STD_HID
+    // --- Coalesced input state, flushed from the SOF interrupt ---
+    // Main loop and ISR never share a read-modify-write: each counter
+    // pair has exactly one writer (the main loop "notes", the SOF ISR
+    // "sends"), and the pending amount is the difference of the two.
+    volatile int16_t  m_mouse_x_noted = 0;     // accumulated relative motion
+    int16_t           m_mouse_x_sent = 0;      // SOF ISR only
+    volatile int16_t  m_mouse_y_noted = 0;
+    int16_t           m_mouse_y_sent = 0;
+    volatile int16_t  m_wheel_noted = 0;       // accumulated wheel detents
+    int16_t           m_wheel_sent = 0;        // SOF ISR only
+    volatile uint8_t  m_mouse_buttons = 0;     // latest button state
+    uint8_t           m_mouse_buttons_sent = 0;
+    volatile uint16_t m_kbd_noted = 0;         // keyboard report generation
+    uint16_t          m_kbd_sent = 0;
+    volatile uint8_t  m_kbd_modifier = 0;
+    volatile uint8_t  m_kbd_key = 0;
+    volatile uint16_t m_consumer_noted = 0;    // press/release sequences asked
+    uint16_t          m_consumer_done = 0;     // sequences completed (SOF ISR)
+    volatile uint16_t m_consumer_key = 0;      // key for press_consumer runs
+    uint8_t           m_consumer_phase = 0;    // 1 = press sent, release due
+    volatile uint16_t m_consumer_state_noted = 0; // direct consumer reports
+    uint16_t          m_consumer_state_sent = 0;
+    volatile uint16_t m_consumer_usage = 0;    // latest direct consumer state
+#endif /* USB_STD_HID */
+
+    // True while the Custom HID OUT endpoint is armed with a framebuffer
+    // slot address instead of the bounce buffer
+    volatile bool m_display_rx_zero_copy = false;
+
+    // Ping-pong bounce buffers for display command/RLE packets: the OUT
+    // endpoint is re-armed with the alternate buffer before a packet is
+    // parsed, so the bus never idles while the ISR is still working.
+    uint8_t m_display_bounce[2][64];
+    uint8_t m_display_bounce_sel = 0;
 
     usb_core_driver m_core_driver;
     usb_class_core  m_class_core;
@@ -132,9 +308,16 @@ private:
     bool            m_msc_enabled;
 
     // State handlers for each class using correct C++ types
+#if USB_STD_HID
     usb::hid::StandardHidHandler m_std_hid_handler;
+#endif
     usb::hid::CustomHidHandler   m_custom_hid_handler;
+#if USB_MSC
     usb::msc::MscHandler         m_msc_handler;
+#endif
+
+    // Sampled from poll(); see usb::NakStats.
+    usb::NakStats m_nak_stats = {};
 
     // --- Friend Declarations ---
     // Befriend the public namespace functions so they can call the private methods.
@@ -146,6 +329,7 @@ private:
     friend void usb::send_consumer_report(uint16_t);
     friend bool usb::send_custom_hid_report(const uint8_t*, size_t);
     friend bool usb::is_std_hid_transfer_complete();
+    friend const usb::NakStats& usb::nak_stats();
 };
 
 #endif // USB_DEVICE_H
\ No newline at end of file
@@ -194,6 +194,7 @@ namespace msc {
             INVALID_FIELD_IN_COMMAND    = 0x24,
             ADDRESS_OUT_OF_RANGE        = 0x21,
             MEDIUM_NOT_PRESENT          = 0x3A,
+            MEDIUM_CHANGED              = 0x28, /* not-ready-to-ready change */
             WRITE_PROTECTED             = 0x27,
             UNRECOVERED_READ_ERROR      = 0x11,
             WRITE_FAULT                 = 0x03
@@ -207,7 +208,11 @@ namespace msc {
     } // namespace scsi
 
     struct MscHandler {
-        uint8_t bbb_data[MSC_MEDIA_PACKET_SIZE];
+        // Scalar state sits ahead of the two MSC_MEDIA_PACKET_SIZE data
+        // buffers so every field the BBB state machine touches per packet
+        // stays within the RV32 imm12 reach (+/-2047) of the struct base;
+        // behind a 4 KiB buffer each access would pay an extra address-
+        // materialization instruction in the bulk ISR path.
         uint8_t max_lun;
         BbbState bbb_state;
         BbbStatus bbb_status;
@@ -221,6 +226,51 @@ namespace msc {
         uint32_t scsi_blk_addr;
         uint32_t scsi_blk_len;
         scsi::SenseData scsi_sense[scsi::SENSE_LIST_DEEPTH];
+
+        // Read-side pipeline (see _msc_read_pipe_* in usb_device.cpp): the
+        // card streams the next chunk into the ping-pong pair (SPI DMA,
+        // started from the main loop) while the IN endpoint transmits the
+        // previous one.
+        uint32_t read_fetch_addr;    // byte address of the next fetch
+        uint32_t read_fetch_len;     // bytes still to fetch from the card
+        uint32_t read_ready_len;     // length of the prefetched chunk
+        uint8_t  read_lun;
+        uint8_t  read_sel;           // chunk buffer the next fetch fills
+        volatile bool read_active;   // a READ_10 data phase is in progress
+        volatile bool read_ready;    // buf[read_sel] holds an unsent chunk
+        volatile bool read_in_idle;  // IN endpoint is waiting for a chunk
+        volatile bool read_fetching; // async card transfer in flight
+        volatile bool read_error;    // a fetch failed; poll() sends the CSW
+
+        // Write-side pipeline (see _msc_write_pipe_* in usb_device.cpp):
+        // completed OUT chunks are latched in this two-entry queue and
+        // the card program starts from poll() as an asynchronous SPI
+        // transfer, so the USB interrupt returns immediately and the
+        // main loop stays free to dispatch LCD blits over the other SPI
+        // bus while the card programs. The buffer pair bounds the
+        // pipeline -- one chunk on the card while the next is received;
+        // reception is re-armed only once a buffer frees, so a fast
+        // host throttles against the card through NAKs.
+        uint8_t *write_q_buf[2];     // latched chunks awaiting the card
+        uint32_t write_q_addr[2];    // their byte addresses on the medium
+        uint32_t write_q_len[2];     // their byte counts
+        volatile uint8_t write_q_head; // OUT ISR produces (free-running)
+        volatile uint8_t write_q_tail; // poll() consumes
+        uint8_t *write_rx_buf;       // buffer of the armed one-shot recev
+        uint8_t  write_rx_sel;       // next buffer to arm (0 = bbb_data)
+        uint8_t  write_lun;
+        uint64_t write_start;        // mtime when the in-flight chunk started
+        volatile bool write_active;  // a WRITE_10 data phase is in progress
+        volatile bool write_busy;    // card transfer in flight
+        volatile bool write_rx_armed; // OUT endpoint has a reception armed
+        volatile bool write_error;   // a card write failed; poll() ends it
+        volatile bool write_stalled; // busy past the stall threshold; re-arms
+                                     // are deferred until the card recovers
+
+        uint8_t bbb_data[MSC_MEDIA_PACKET_SIZE];
+        // Second data-stage buffer for ping-pong reception on bulk writes:
+        // the host streams the next chunk while this one goes to the card.
+        uint8_t bbb_data_alt[MSC_MEDIA_PACKET_SIZE];
     };
 
 } // namespace msc
@@ -10,8 +10,20 @@
 
 #include "usb_conf.h"
 
+/*
+ * Compile-time interface composition (config.py: -DUSB_STD_HID,
+ * -DUSB_MSC). The display bulk interface is always present; the
+ * standard HID input interface and the MSC interface are composable,
+ * so a deployment that only streams the display builds neither --
+ * no descriptor space, no ISR dispatch branches, no class code in
+ * flash, and their TX FIFO words fall to the shared RX FIFO
+ * (usb_conf.h). Interface numbers compact automatically below so the
+ * set the host sees is always contiguous from zero. The flags default
+ * on in usb_conf.h, which the FIFO budget shares.
+ */
+
 #define USBD_CFG_MAX_NUM                   1
-#define USBD_ITF_MAX_NUM                   3 // Total number of interfaces
+#define USBD_ITF_MAX_NUM                   (1 + USB_STD_HID + USB_MSC)
 
 #define USB_STR_DESC_MAX_SIZE              64
 #define USB_STRING_COUNT                   4U
@@ -30,14 +42,26 @@
  * to our new composite interface numbers.
 */
 
-/* Step 1: Define our composite interface numbers */
+/* Step 1: Define our composite interface numbers. Numbering follows
+ * the composition flags so the included interfaces stay contiguous
+ * from zero, as the standard requires. */
+#if USB_STD_HID
 #define STD_HID_INTERFACE                  0x00U
 #define CUSTOM_HID_INTERFACE               0x01U
-#define MSC_INTERFACE                      0x02U
+#else
+#define CUSTOM_HID_INTERFACE               0x00U
+#endif
+#if USB_MSC
+#define MSC_INTERFACE                      (CUSTOM_HID_INTERFACE + 1U)
+#endif
 
 /* Step 2: Create compatibility macros for the original library files */
+#if USB_STD_HID
 #define USBD_HID_INTERFACE                 STD_HID_INTERFACE
+#endif
+#if USB_MSC
 #define USBD_MSC_INTERFACE                 MSC_INTERFACE
+#endif
 /* CUSTOM_HID_INTERFACE is already used by the custom hid core, so no new define is needed. */
 
 /* Step 3: Define endpoints for each interface */
@@ -46,12 +70,21 @@
 #define STD_HID_IN_EP                      EP_IN(1U)
 #define STD_HID_IN_PACKET                  8U
 
-/* Custom HID Class Endpoints */
+/* Display (vendor bulk) Interface Endpoints.
+ * The macros keep their historical CUSTOM_HID_ names because they are
+ * referenced throughout the device and display code; since the interface
+ * moved from HID to a vendor-specific bulk class the endpoints carry the
+ * same 64-byte packets without report framing or a polling interval. */
 #define CUSTOM_HID_IN_EP                   EP_IN(2U)
 #define CUSTOM_HID_OUT_EP                  EP_OUT(2U)
 #define CUSTOM_HID_IN_PACKET               64U
 #define CUSTOM_HID_OUT_PACKET              64U
 
+/* Enable the usbd_enum.c hook that forwards device-level vendor requests
+ * to usbd_OEM_req; we use it to serve the Microsoft OS 2.0 descriptor set
+ * so Windows binds WinUSB to the display interface automatically. */
+#define WINUSB_EXEMPT_DRIVER
+
 /* Mass Storage Class Endpoints & Configuration */
 #define MSC_IN_EP                          EP_IN(3U)
 #define MSC_OUT_EP                         EP_OUT(3U)
@@ -64,9 +97,27 @@
  * ===================================================================
 */
 
-/* These macros are required by the standalone MSC library files */
-#define MSC_MEDIA_PACKET_SIZE              2048U /* Buffer size for media access, must be >= block size */
-#define MEM_LUN_NUM                        1U    /* Number of Logical Units (drives), e.g., 1 for one SD card */
+/* Media transfer unit for the MSC data stage. Every READ(10)/WRITE(10)
+ * pass of the bbb state machine moves this many bytes, double-buffered
+ * (bbb_data/bbb_data_alt), so the SRAM cost is twice this value and the
+ * per-megabyte pass count -- and the ISR overhead that goes with it --
+ * is inversely proportional to it. 4 KB is the ceiling that still fits
+ * the 32 KB SRAM next to the four 4 KB display slots; 8 KB units do
+ * not. Builds without SD media shrink the pair to one card block: the
+ * buffers then only ever carry SCSI reply payloads (inquiry, sense,
+ * capacity), never a data stage. Override per build with
+ * -DMSC_MEDIA_PACKET_SIZE; must be a multiple of the 512-byte block. */
+#ifndef MSC_MEDIA_PACKET_SIZE
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+#define MSC_MEDIA_PACKET_SIZE              4096U
+#else
+#define MSC_MEDIA_PACKET_SIZE              512U
+#endif
+#endif
+/* Logical units: LUN 0 is the SD card (no media while absent or built
+ * out), LUN 1 the synthesized stats RAM disk (usbd_msc_mem.cpp), which
+ * is always ready and serves at memory speed. */
+#define MEM_LUN_NUM                        2U
 #define MSC_DATA_PACKET_SIZE               MSC_IN_PACKET /* Compatibility for usbd_msc_core.h */
 
 #endif /* USBD_CONF_H */
\ No newline at end of file
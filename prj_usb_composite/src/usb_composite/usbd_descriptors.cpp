@@ -6,18 +6,49 @@
 */
 
 #include "usbd_descriptors.h"
+#include "usb_desc_builder.h"
+#include "vendor_ctl.h"
 #include <cstring>
 
 #define USBD_VID                     0x28E9
 #define USBD_PID                     0xABCD // New PID for the composite device
 
+/* Standard HID endpoint polling rate. Low-latency builds ask for every
+ * frame: the SOF handler coalesces input to at most one report per 1 ms
+ * frame anyway, so the faster polling only removes the wait for the next
+ * poll slot -- an armed report goes out on the very next frame instead
+ * of up to 10 ms later. Idle polls of an empty endpoint are NAKed by
+ * hardware and cost no CPU. */
+#ifndef HID_LOW_LATENCY
+#define HID_LOW_LATENCY 0
+#endif
+#if HID_LOW_LATENCY
+#define STD_HID_EP_INTERVAL 0x01 /* 1ms */
+#else
+#define STD_HID_EP_INTERVAL 0x0A /* 10ms */
+#endif
+
+/* Every length below is derived from the packed descriptor types, so a
+ * hand-counting mistake cannot creep back in; these asserts pin the
+ * on-wire totals as a second, independent check. Per-interface block
+ * sizes: config 9, std HID 25 (itf 9 + hid 9 + ep 7), display 23
+ * (itf 9 + ep 7 + ep 7), MSC 23 -- scaled by the composition flags. */
+#if USB_MSC
+static_assert(sizeof(usb_composite_desc_config_set) ==
+              9U + (USB_STD_HID ? 25U : 0U) + 23U + 23U,
+              "composite configuration set size changed unexpectedly");
+#endif
+static_assert(sizeof(usb_hid_only_desc_config_set) ==
+              9U + (USB_STD_HID ? 25U : 0U) + 23U,
+              "HID-only configuration set size changed unexpectedly");
+
 /* USB standard device descriptor */
-usb_desc_dev composite_dev_desc = {
+constexpr usb_desc_dev composite_dev_desc = {
     .header = {
-        .bLength          = USB_DEV_DESC_LEN, 
+        .bLength          = USB_DEV_DESC_LEN,
         .bDescriptorType  = USB_DESCTYPE_DEV
     },
-    .bcdUSB                = 0x0200,
+    .bcdUSB                = 0x0210, // USB 2.1: the host may request the BOS descriptor
     .bDeviceClass          = 0x00, // Class defined in interface
     .bDeviceSubClass       = 0x00,
     .bDeviceProtocol       = 0x00,
@@ -31,108 +62,127 @@ usb_desc_dev composite_dev_desc = {
     .bNumberConfigurations = USBD_CFG_MAX_NUM,
 };
 
-/* USB composite configuration descriptor */
-usb_composite_desc_config_set composite_config_desc = {
-    .config = {
-        .header = {
-            .bLength         = sizeof(usb_desc_config), 
-            .bDescriptorType = USB_DESCTYPE_CONFIG
-        },
-        .wTotalLength         = COMPOSITE_CONFIG_DESC_SIZE,
-        .bNumInterfaces       = 3U, // We have 3 interfaces
-        .bConfigurationValue  = 1U,
-        .iConfiguration       = 0U,
-        .bmAttributes         = 0x80, // Bus-powered
-        .bMaxPower            = 0xFA  // 500mA
-    },
+/* USB composite configuration descriptor, computed at compile time and
+ * served straight out of flash. bNumInterfaces comes from the
+ * composition flags (usbd_conf.h). */
+#if USB_MSC
+constexpr usb_composite_desc_config_set composite_config_desc = {
+    .config = usb::desc::configuration<usb_composite_desc_config_set>(USBD_ITF_MAX_NUM, 0xFA /* 500mA */),
 
-    /******************** Standard HID Interface (Interface 0) ********************/
-    .std_hid_itf = {
-        .header = { .bLength = sizeof(usb_desc_itf), .bDescriptorType = USB_DESCTYPE_ITF },
-        .bInterfaceNumber     = STD_HID_INTERFACE,
-        .bAlternateSetting    = 0x00,
-        .bNumEndpoints        = 1U,
-        .bInterfaceClass      = usb::hid::HID_CLASS,
-        .bInterfaceSubClass   = 0x00, // No Subclass
-        .bInterfaceProtocol   = 0x00, // No Protocol
-        .iInterface           = 0x00
-    },
-    .std_hid_desc = {
-        .header = { .bLength = sizeof(usb::hid::DescHid), .bDescriptorType = usb::hid::DESC_TYPE_HID },
-        .bcdHID               = 0x0111,
-        .bCountryCode         = 0x00,
-        .bNumDescriptors      = 1U,
-        .bDescriptorType      = usb::hid::DESC_TYPE_REPORT,
-        .wDescriptorLength    = STD_HID_REPORT_DESC_LEN,
-    },
-    .std_hid_epin = {
-        .header = { .bLength = sizeof(usb_desc_ep), .bDescriptorType = USB_DESCTYPE_EP },
-        .bEndpointAddress     = STD_HID_IN_EP,
-        .bmAttributes         = USB_EP_ATTR_INT,
-        .wMaxPacketSize       = STD_HID_IN_PACKET,
-        .bInterval            = 0x0A // 10ms
-    },
+#if USB_STD_HID
+    /******************** Standard HID Interface ********************/
+    .std_hid_itf  = usb::desc::interface(STD_HID_INTERFACE, 1U, usb::hid::HID_CLASS, 0x00, 0x00),
+    .std_hid_desc = usb::desc::hid(STD_HID_REPORT_DESC_LEN),
+    .std_hid_epin = usb::desc::endpoint(STD_HID_IN_EP, USB_EP_ATTR_INT, STD_HID_IN_PACKET, STD_HID_EP_INTERVAL),
+#endif
 
-    /******************** Custom HID Interface (Interface 1) ********************/
-    .custom_hid_itf = {
-        .header = { .bLength = sizeof(usb_desc_itf), .bDescriptorType = USB_DESCTYPE_ITF },
-        .bInterfaceNumber     = CUSTOM_HID_INTERFACE,
-        .bAlternateSetting    = 0x00,
-        .bNumEndpoints        = 2U,
-        .bInterfaceClass      = usb::hid::HID_CLASS,
-        .bInterfaceSubClass   = 0x00,
-        .bInterfaceProtocol   = 0x00,
-        .iInterface           = 0x00
-    },
-    .custom_hid_desc = {
-        .header = { .bLength = sizeof(usb::hid::DescHid), .bDescriptorType = usb::hid::DESC_TYPE_HID },
-        .bcdHID               = 0x0111,
-        .bCountryCode         = 0x00,
-        .bNumDescriptors      = 1U,
-        .bDescriptorType      = usb::hid::DESC_TYPE_REPORT,
-        .wDescriptorLength    = CUSTOM_HID_REPORT_DESC_LEN,
-    },
-    .custom_hid_epin = {
-        .header = { .bLength = sizeof(usb_desc_ep), .bDescriptorType = USB_DESCTYPE_EP },
-        .bEndpointAddress     = CUSTOM_HID_IN_EP,
-        .bmAttributes         = USB_EP_ATTR_INT,
-        .wMaxPacketSize       = CUSTOM_HID_IN_PACKET,
-        .bInterval            = 0x20
-    },
-    .custom_hid_epout = {
-        .header = { .bLength = sizeof(usb_desc_ep), .bDescriptorType = USB_DESCTYPE_EP },
-        .bEndpointAddress     = CUSTOM_HID_OUT_EP,
-        .bmAttributes         = USB_EP_ATTR_INT,
-        .wMaxPacketSize       = CUSTOM_HID_OUT_PACKET,
-        .bInterval            = 0x20
-    },
+    /******************** Display Vendor Bulk Interface ********************/
+    .display_itf   = usb::desc::interface(CUSTOM_HID_INTERFACE, 2U, DISPLAY_ITF_CLASS,
+                                          DISPLAY_ITF_SUBCLASS, DISPLAY_ITF_PROTOCOL),
+    .display_epin  = usb::desc::endpoint(CUSTOM_HID_IN_EP, USB_EP_ATTR_BULK, CUSTOM_HID_IN_PACKET, 0x00),
+    .display_epout = usb::desc::endpoint(CUSTOM_HID_OUT_EP, USB_EP_ATTR_BULK, CUSTOM_HID_OUT_PACKET, 0x00),
 
-    /******************** MSC Interface (Interface 2) ********************/
-    .msc_itf = {
-        .header = { .bLength = sizeof(usb_desc_itf), .bDescriptorType = USB_DESCTYPE_ITF },
-        .bInterfaceNumber    = MSC_INTERFACE,
-        .bAlternateSetting   = 0x00,
-        .bNumEndpoints       = 2U,
-        .bInterfaceClass     = usb::msc::MSC_CLASS,
-        .bInterfaceSubClass  = usb::msc::MSC_SUBCLASS_SCSI,
-        .bInterfaceProtocol  = usb::msc::MSC_PROTOCOL_BBB,
-        .iInterface          = 0x00
-    },
-    .msc_epout = {
-        .header = { .bLength = sizeof(usb_desc_ep), .bDescriptorType = USB_DESCTYPE_EP },
-        .bEndpointAddress    = MSC_OUT_EP,
-        .bmAttributes        = USB_EP_ATTR_BULK,
-        .wMaxPacketSize      = MSC_OUT_PACKET,
-        .bInterval           = 0x00
-    },
-    .msc_epin = {
-        .header = { .bLength = sizeof(usb_desc_ep), .bDescriptorType = USB_DESCTYPE_EP },
-        .bEndpointAddress    = MSC_IN_EP,
-        .bmAttributes        = USB_EP_ATTR_BULK,
-        .wMaxPacketSize      = MSC_IN_PACKET,
-        .bInterval           = 0x00
-    }
+    /******************** MSC Interface ********************/
+    .msc_itf   = usb::desc::interface(MSC_INTERFACE, 2U, usb::msc::MSC_CLASS,
+                                      usb::msc::MSC_SUBCLASS_SCSI, usb::msc::MSC_PROTOCOL_BBB),
+    .msc_epout = usb::desc::endpoint(MSC_OUT_EP, USB_EP_ATTR_BULK, MSC_OUT_PACKET, 0x00),
+    .msc_epin  = usb::desc::endpoint(MSC_IN_EP, USB_EP_ATTR_BULK, MSC_IN_PACKET, 0x00)
 };
+#endif /* USB_MSC */
+
+/* The same configuration without the MSC interface, selected by init()
+ * when no SD card is present (and the only set on USB_MSC=0 builds).
+ * wTotalLength is recomputed from its own set type, so the variants
+ * can never disagree about their sizes. */
+constexpr usb_hid_only_desc_config_set hid_only_config_desc = {
+    .config = usb::desc::configuration<usb_hid_only_desc_config_set>(1U + USB_STD_HID, 0xFA /* 500mA */),
+
+#if USB_STD_HID
+    .std_hid_itf  = usb::desc::interface(STD_HID_INTERFACE, 1U, usb::hid::HID_CLASS, 0x00, 0x00),
+    .std_hid_desc = usb::desc::hid(STD_HID_REPORT_DESC_LEN),
+    .std_hid_epin = usb::desc::endpoint(STD_HID_IN_EP, USB_EP_ATTR_INT, STD_HID_IN_PACKET, STD_HID_EP_INTERVAL),
+#endif
+
+    .display_itf   = usb::desc::interface(CUSTOM_HID_INTERFACE, 2U, DISPLAY_ITF_CLASS,
+                                          DISPLAY_ITF_SUBCLASS, DISPLAY_ITF_PROTOCOL),
+    .display_epin  = usb::desc::endpoint(CUSTOM_HID_IN_EP, USB_EP_ATTR_BULK, CUSTOM_HID_IN_PACKET, 0x00),
+    .display_epout = usb::desc::endpoint(CUSTOM_HID_OUT_EP, USB_EP_ATTR_BULK, CUSTOM_HID_OUT_PACKET, 0x00)
+};
+
+/* Microsoft OS 2.0 descriptor set: tells Windows to bind WinUSB to the
+ * display interface so the host tool can open it with libusb without a
+ * driver installation step. Served by usbd_OEM_req below when the host
+ * issues the MSOS20_VENDOR_CODE request advertised in the BOS descriptor. */
+static const uint8_t msos20_desc_set[] = {
+    /* Set header */
+    0x0A, 0x00,             /* wLength */
+    0x00, 0x00,             /* MS_OS_20_SET_HEADER_DESCRIPTOR */
+    0x00, 0x00, 0x03, 0x06, /* dwWindowsVersion (Windows 8.1+) */
+    0x2E, 0x00,             /* wTotalLength (46) */
+
+    /* Configuration subset header */
+    0x08, 0x00,             /* wLength */
+    0x01, 0x00,             /* MS_OS_20_SUBSET_HEADER_CONFIGURATION */
+    0x00,                   /* bConfigurationValue (index 0) */
+    0x00,                   /* bReserved */
+    0x24, 0x00,             /* wTotalLength (36) */
+
+    /* Function subset header: the display interface only */
+    0x08, 0x00,             /* wLength */
+    0x02, 0x00,             /* MS_OS_20_SUBSET_HEADER_FUNCTION */
+    CUSTOM_HID_INTERFACE,   /* bFirstInterface */
+    0x00,                   /* bReserved */
+    0x1C, 0x00,             /* wSubsetLength (28) */
+
+    /* Compatible ID feature descriptor */
+    0x14, 0x00,             /* wLength */
+    0x03, 0x00,             /* MS_OS_20_FEATURE_COMPATIBLE_ID */
+    'W', 'I', 'N', 'U', 'S', 'B', 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* USB BOS descriptor with the Microsoft OS 2.0 platform capability */
+const uint8_t composite_bos_desc[] = {
+    /* BOS descriptor header */
+    0x05,                   /* bLength */
+    0x0F,                   /* USB_DESCTYPE_BOS */
+    0x21, 0x00,             /* wTotalLength (33) */
+    0x01,                   /* bNumDeviceCaps */
+
+    /* Microsoft OS 2.0 platform capability descriptor */
+    0x1C,                   /* bLength */
+    0x10,                   /* USB_DESCTYPE_DEV_CAPABILITY */
+    0x05,                   /* PLATFORM capability */
+    0x00,                   /* bReserved */
+    /* MS OS 2.0 platform capability UUID
+     * {D8DD60DF-4589-4CC7-9CD2-659D9E648A9F} */
+    0xDF, 0x60, 0xDD, 0xD8, 0x89, 0x45, 0xC7, 0x4C,
+    0x9C, 0xD2, 0x65, 0x9D, 0x9E, 0x64, 0x8A, 0x9F,
+    0x00, 0x00, 0x03, 0x06, /* dwWindowsVersion (Windows 8.1+) */
+    0x2E, 0x00,             /* wMSOSDescriptorSetTotalLength (46) */
+    MSOS20_VENDOR_CODE,     /* bMS_VendorCode */
+    0x00                    /* bAltEnumCode */
+};
+
+/* Device-level vendor request hook (called from usbd_enum.c when
+ * WINUSB_EXEMPT_DRIVER is defined): the vendor_ctl query table first
+ * (one bRequest lookup; see vendor_ctl.h), then the MS OS 2.0
+ * descriptor set Windows asks for during enumeration. */
+extern "C" usbd_status usbd_OEM_req(usb_dev *udev, usb_req *req)
+{
+    usb_transc *transc = &udev->dev.transc_in[0];
+
+    if(vendor_ctl::handle(udev, req)) {
+        return USBD_OK;
+    }
+
+    if((MSOS20_VENDOR_CODE == req->bRequest) && (0x07U == req->wIndex)) {
+        transc->xfer_buf = (uint8_t *)msos20_desc_set;
+        transc->remain_len = USB_MIN((uint16_t)sizeof(msos20_desc_set), req->wLength);
+    }
+
+    return USBD_OK;
+}
 
 /* USB language ID Descriptor */
 static const usb_desc_LANGID usbd_language_id_desc = {
@@ -23,6 +23,7 @@ extern "C" {
  * 2. Report ID 2: A standard 6-key rollover keyboard.
  * 3. Report ID 3: A consumer control device for media keys (e.g., volume, play/pause).
  */
+#if USB_STD_HID
 const uint8_t std_hid_report_descriptor[] = {
     //
     // ------------- Part 1: Mouse Definition -------------
@@ -107,72 +108,81 @@ const uint8_t std_hid_report_descriptor[] = {
     0xC0              // END_COLLECTION
 };
 
-/* Custom HID Report Descriptor */
-const uint8_t custom_hid_report_descriptor[] = {
-    0x06, 0x00, 0xFF,  // Usage Page (Vendor-Defined)
-    0x09, 0x01,        // Usage (Vendor-Defined)
-    0xA1, 0x01,        // Collection (Application)
-    
-    // OUTPUT Report (Host -> Device) for image data
-    0x09, 0x02,        //   Usage (Vendor-Defined 2)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x26, 0xFF, 0x00,  //   Logical Maximum (255)
-    0x75, 0x08,        //   Report Size (8 bits)
-    0x95, 0x40,        //   Report Count (64 bytes)
-    0x91, 0x02,        //   Output (Data, Var, Abs)
-    
-    // INPUT Report (Device -> Host), optional but good practice
-    0x09, 0x03,        //   Usage (Vendor-Defined 3)
-    0x95, 0x40,        //   Report Count (64 bytes)
-    0x81, 0x02,        //   Input (Data, Var, Abs)
-    
-    0xC0               // End Collection
-};
-
 /* Report descriptor lengths */
 #define STD_HID_REPORT_DESC_LEN       sizeof(std_hid_report_descriptor)
-#define CUSTOM_HID_REPORT_DESC_LEN    sizeof(custom_hid_report_descriptor)
+#endif /* USB_STD_HID */
 
-/* Define a size for the configuration when MSC is disabled */
-#define HID_ONLY_CONFIG_DESC_SIZE     (sizeof(usb_desc_config) + \
-                                       sizeof(usb_desc_itf) + sizeof(usb::hid::DescHid) + sizeof(usb_desc_ep) + \
-                                       sizeof(usb_desc_itf) + sizeof(usb::hid::DescHid) + sizeof(usb_desc_ep) * 2)
+/* Vendor-specific class for the display bulk interface. The display
+ * stream used to ride on a second HID interface, but HID framing capped
+ * throughput at one interrupt report per interval; bulk endpoints let the
+ * host queue arbitrarily large transfers (WinUSB/libusb on the host). */
+#define DISPLAY_ITF_CLASS             0xFFU
+#define DISPLAY_ITF_SUBCLASS          0x00U
+#define DISPLAY_ITF_PROTOCOL          0x00U
 
-/* Total size of the full composite descriptor (remains the same) */
-#define COMPOSITE_CONFIG_DESC_SIZE    (sizeof(usb_desc_config) + \
-                                       sizeof(usb_desc_itf) + sizeof(usb::hid::DescHid) + sizeof(usb_desc_ep) + \
-                                       sizeof(usb_desc_itf) + sizeof(usb::hid::DescHid) + sizeof(usb_desc_ep) * 2 + \
-                                       sizeof(usb_desc_itf) + sizeof(usb_desc_ep) * 2)
+/* Vendor request code the host uses to fetch the Microsoft OS 2.0
+ * descriptor set (advertised in the BOS platform capability). */
+#define MSOS20_VENDOR_CODE            0x20U
 
 /* Report IDs */
 #define REPORT_ID_MOUSE             1U
 #define REPORT_ID_KEYBOARD          2U
 #define REPORT_ID_CONSUMER          3U
 
-/* Composite descriptor structure */
+/* Composite descriptor structure. The standard HID and MSC members
+ * follow the interface composition flags (usbd_conf.h): a build that
+ * excludes an interface never carries its descriptors either. */
+#if USB_MSC
 typedef struct
 {
     usb_desc_config         config;
 
+#if USB_STD_HID
     /* Standard HID (Mouse, Keyboard, Consumer) Interface */
     usb_desc_itf            std_hid_itf;
     usb::hid::DescHid       std_hid_desc;
     usb_desc_ep             std_hid_epin;
+#endif
 
-    /* Custom HID Interface */
-    usb_desc_itf            custom_hid_itf;
-    usb::hid::DescHid       custom_hid_desc;
-    usb_desc_ep             custom_hid_epin;
-    usb_desc_ep             custom_hid_epout;
+    /* Display (vendor bulk) Interface */
+    usb_desc_itf            display_itf;
+    usb_desc_ep             display_epin;
+    usb_desc_ep             display_epout;
 
     /* MSC Interface */
     usb_desc_itf            msc_itf;
     usb_desc_ep             msc_epout;
     usb_desc_ep             msc_epin;
 } usb_composite_desc_config_set;
+#endif /* USB_MSC */
+
+/* The same configuration without the MSC interface. Both sets are built
+ * at compile time and live in flash; init() selects which one the host
+ * is served instead of patching a RAM copy at startup. On USB_MSC=0
+ * builds this is the only set. */
+typedef struct
+{
+    usb_desc_config         config;
 
-extern usb_desc_dev composite_dev_desc;
-extern usb_composite_desc_config_set composite_config_desc;
+#if USB_STD_HID
+    /* Standard HID (Mouse, Keyboard, Consumer) Interface */
+    usb_desc_itf            std_hid_itf;
+    usb::hid::DescHid       std_hid_desc;
+    usb_desc_ep             std_hid_epin;
+#endif
+
+    /* Display (vendor bulk) Interface */
+    usb_desc_itf            display_itf;
+    usb_desc_ep             display_epin;
+    usb_desc_ep             display_epout;
+} usb_hid_only_desc_config_set;
+
+extern const usb_desc_dev composite_dev_desc;
+#if USB_MSC
+extern const usb_composite_desc_config_set composite_config_desc;
+#endif
+extern const usb_hid_only_desc_config_set hid_only_config_desc;
+extern const uint8_t composite_bos_desc[];
 extern void *const usbd_composite_strings[];
 
 #endif /* USBD_DESCRIPTORS_H */
\ No newline at end of file
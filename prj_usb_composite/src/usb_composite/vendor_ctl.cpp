@@ -0,0 +1,113 @@
+/*!
+    \file    vendor_ctl.cpp
+    \brief   EP0 vendor-request fast path for small device queries
+
+    \version 2025-02-10, firmware for GD32VF103
+*/
+
+#include "vendor_ctl.h"
+#include "display_manager.h"
+#include "health.h"
+#include "telemetry.h"
+#include "cfgstore.h"
+#include "buildinfo.h"
+#include "mtimer.h"
+
+namespace vendor_ctl {
+
+namespace {
+
+// One reply buffer is enough: EP0 is half-duplex and a new SETUP
+// packet aborts whatever data stage was using the previous contents.
+uint8_t reply[16];
+
+void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+// Fill handlers run in the SETUP ISR; everything they read is a
+// cached value some service pass already folded. Each returns the
+// reply length.
+
+uint16_t fill_status(const usb_req *)
+{
+    const display::PipelineStats &st =
+        display::DisplayManager::getInstance().stats();
+    const uint16_t mv = telemetry::supply_mv();
+    const uint16_t dc = static_cast<uint16_t>(telemetry::die_temp_dc());
+    reply[0] = display::DisplayManager::getInstance().freeSlots();
+    reply[1] = static_cast<uint8_t>(display::constants::NumBuffers);
+    reply[2] = static_cast<uint8_t>(health::tripped());
+    reply[3] = static_cast<uint8_t>(st.rects_drawn);
+    reply[4] = static_cast<uint8_t>(st.rects_drawn >> 8);
+    reply[5] = static_cast<uint8_t>(st.slots_dropped);
+    reply[6] = static_cast<uint8_t>(st.slots_dropped >> 8);
+    put32(&reply[7], st.draw_cycles_last);
+    reply[11] = static_cast<uint8_t>(mv);
+    reply[12] = static_cast<uint8_t>(mv >> 8);
+    reply[13] = static_cast<uint8_t>(dc);
+    reply[14] = static_cast<uint8_t>(dc >> 8);
+    reply[15] = 0U;
+    return 16U;
+}
+
+uint16_t fill_build(const usb_req *)
+{
+    put32(&reply[0], BUILDINFO_FINGERPRINT);
+    return 4U;
+}
+
+uint16_t fill_uptime(const usb_req *)
+{
+    uint64_t now = mtimer_now();
+    put32(&reply[0], static_cast<uint32_t>(now));
+    put32(&reply[4], static_cast<uint32_t>(now >> 32));
+    return 8U;
+}
+
+uint16_t fill_cfg_get(const usb_req *req)
+{
+    uint32_t value = 0xFFFFFFFFu;
+    (void)cfgstore::get(static_cast<uint8_t>(req->wValue), value);
+    put32(&reply[0], value);
+    return 4U;
+}
+
+struct Entry {
+    uint8_t request;
+    uint16_t (*fill)(const usb_req *req);
+};
+
+constexpr Entry kTable[] = {
+    { ReqStatus, fill_status },
+    { ReqBuild,  fill_build },
+    { ReqUptime, fill_uptime },
+    { ReqCfgGet, fill_cfg_get },
+};
+
+} // namespace
+
+bool handle(usb_dev *udev, usb_req *req)
+{
+    // Device-to-host only: every entry is a read, and the shared hook
+    // has no OUT data-stage plumbing anyway.
+    if (0U == (req->bmRequestType & 0x80U)) {
+        return false;
+    }
+    for (const Entry &e : kTable) {
+        if (e.request == req->bRequest) {
+            uint16_t len = e.fill(req);
+            usb_transc *transc = &udev->dev.transc_in[0];
+            transc->xfer_buf = reply;
+            transc->remain_len = USB_MIN(len, req->wLength);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace vendor_ctl
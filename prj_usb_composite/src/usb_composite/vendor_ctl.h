@@ -0,0 +1,54 @@
+/*!
+    \file    vendor_ctl.h
+    \brief   EP0 vendor-request fast path for small device queries
+
+    \version 2025-02-10, firmware for GD32VF103
+*/
+
+#ifndef VENDOR_CTL_H
+#define VENDOR_CTL_H
+
+extern "C" {
+    #include "usbd_core.h"
+}
+
+/*
+ * Small read-only device queries answered straight from the SETUP
+ * stage: one bRequest table lookup in usbd_OEM_req, no class routing
+ * by wIndex, no report queue, no main-loop round trip. A host polling
+ * health or credits gets its answer in the control transfer it asked
+ * with, instead of a GET_STATS command packet plus a REPORT_STATS read
+ * that has to win the IN queue against the display stream.
+ *
+ * Everything served here is a cached scalar the main loop or a timer
+ * already maintains (telemetry folds, health mask, mtime), so filling
+ * the reply in ISR context is a handful of loads. Codes sit in the
+ * 0xA0 range, clear of MSOS20_VENDOR_CODE (0x20), which shares the
+ * vendor-request hook.
+ */
+namespace vendor_ctl {
+
+// IN, 16 bytes: the REPORT_STATUS record without its report id byte
+// (free slots, total slots, health mask, rects, drops, draw cycles,
+// supply mV, die temp). Same layout so host parsers are shared.
+constexpr uint8_t ReqStatus = 0xA1;
+
+// IN, 4 bytes: BUILDINFO_FINGERPRINT, for pairing a measurement with
+// the exact firmware without waiting for a REPORT_BUILD slot.
+constexpr uint8_t ReqBuild = 0xA2;
+
+// IN, 8 bytes: raw 64-bit mtime (CK_SYS/4 ticks since reset).
+constexpr uint8_t ReqUptime = 0xA3;
+
+// IN, 4 bytes, wValue = key: flash parameter store value, or
+// 0xFFFFFFFF when the key is unset (stored values are clamped well
+// below that by every consumer, so the sentinel is unambiguous).
+constexpr uint8_t ReqCfgGet = 0xA4;
+
+// SETUP-stage dispatch; true when bRequest matched the table (the
+// EP0 IN transaction is then primed with the reply).
+bool handle(usb_dev *udev, usb_req *req);
+
+} // namespace vendor_ctl
+
+#endif // VENDOR_CTL_H
@@ -7,24 +7,170 @@
 
 #include "usbd_conf.h"
 #include "usbd_msc_mem.h"
-#include <cstdio> // For printf
+#include "ramdisk.h"
+#include <cstdio>  // For printf
+#include <cstring> // For memcpy
 
 // Conditionally include the SD card driver
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
     #include "sd_card.h"
+    #include "overlay.h" // sd_init lives in a code overlay; load before use
+    #include "coro.h"    // awaitable card transfers in the read pipeline
+    #include "evtrace.h" // SD command timeline next to the MSC events
+    #include "trace_ids.h"
+    extern "C" {
+        #include "systick.h"   // get_timer_value() for the flush deadline
+        #include "sram.h"      // named-region placement for the sector cache
+    }
 #endif
 
+// --- Logical units ---
+// LUN 0 is the SD card (media-not-present while absent or built out);
+// LUN 1 is the synthesized stats RAM disk (lib-free, always ready), so
+// instrumentation dumps mount as files even with no card in the slot.
+static constexpr uint8_t LUN_SD  = 0;
+static constexpr uint8_t LUN_RAM = 1;
+
 // --- State and Storage Properties ---
 static bool is_media_present = false;
+// Latched when the background probe finds a card; consumed by the SCSI
+// layer to raise one UNIT ATTENTION so the host re-reads the capacity.
+static volatile bool media_changed = false;
 static uint32_t card_block_size = 512;
 static uint32_t card_block_count = 0;
 
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+// --- Streaming read engine ---
+// mem_read_async starts a card transfer (SPI DMA) directly into the
+// caller's media buffer -- the MSC read pipeline's bbb_data pair. The
+// former sector read-ahead cache bounced every chunk through its own
+// buffer plus a memcpy; with the enlarged MSC_MEDIA_PACKET_SIZE units
+// the pipeline overlaps card and USB by itself, so the data streams
+// card -> media buffer -> bus with no staging copy at all.
+//
+// The multi-step sequence behind one chunk (flush overlapping dirty
+// cache lines, then stream the read, then report) is a coroutine: each
+// transfer is awaited, so the steps read in order in msc_read_task while
+// the SPI DMA completion interrupt drives them. The driver allows one
+// transfer in flight, so one event carries every completion.
+static coro::event sd_done;
+
+// DMA completion interrupt context.
+static void sd_done_signal(DRESULT res) {
+    sd_done.signal(static_cast<int32_t>(res));
+}
+
+// --- Write-back sector cache ---
+// FAT and directory sectors are rewritten dozens of times during a host
+// file copy, and each rewrite used to pay full card program latency.
+// Single-sector writes land in these lines instead; a line goes to the
+// card once the host has left it alone past the flush deadline, when its
+// line is evicted, or when a read needs the sector. Bulk data writes
+// (multi-sector chunks) bypass the cache and keep streaming.
+static constexpr uint32_t WB_LINES = 4;
+struct WbLine {
+    uint32_t sector;
+    bool     valid;
+    bool     dirty;
+    uint8_t  data[512];
+};
+// Named .caches region (lib/system/sram.h): rebuildable sector copies,
+// first in line to shrink when SRAM gets tight, and counted against the
+// region's link-time budget instead of hiding in .bss.
+static WbLine  wb_lines[WB_LINES] SRAM_CACHE;
+static uint32_t wb_victim = 0;          // round-robin eviction cursor
+static volatile bool wb_dirty_any = false;
+static uint64_t wb_deadline;            // mtime value to flush at
+// Quiet time after the last cached write before flushing. mtime runs at
+// SystemCoreClock / 4.
+static constexpr uint32_t WB_FLUSH_DELAY_MS = 20;
+
+// Read-compare-skip: FAT metadata refreshes often rewrite a sector with
+// byte-identical content. Single-sector writes are compared against the
+// cached copy (loaded from the card on a cache miss) and an unchanged
+// sector never reaches the program path at all. A one-block card read
+// costs a fraction of a program cycle, so the trade wins even when only
+// a minority of the writes turn out to be no-ops -- and every skip is
+// one erase/program cycle the card never ages through.
+static constexpr bool WB_COMPARE_SKIP = true;
+static uint32_t wb_write_skips = 0;
+
+// --- Hot-swap polling ---
+// No card-detect line exists, so presence is polled in-band from the
+// main loop (see sd_card_present/sd_card_detect). Removal raises UNIT
+// ATTENTION through media_changed exactly like the boot-time probe;
+// insertion re-runs msc_mem_probe, whose sd_init takes the CID fast
+// path for a card it has seen before, so swap-to-available stays within
+// one poll interval plus the fast init. mtime runs at SystemCoreClock/4.
+static uint64_t hotswap_next_poll = 0;
+static constexpr uint32_t HOTSWAP_POLL_MS = 250;
+
+// Index of the sd_init overlay, in OVERLAYS (config.py) order.
+static constexpr uint8_t OVL_SD_INIT = 0;
+
+// Driver command observer (sd_set_cmd_observer): every SD command frame
+// lands in the binary trace ring between the MSC_FETCH/MSC_IN_SEND
+// events it serves, so a GET_TRACE dump shows which command a slow
+// chunk was waiting on. evt::note costs well under a microsecond, so
+// this rides along even on the per-block CMD17/CMD24 traffic.
+static void sd_cmd_trace(uint8_t cmd, uint8_t response) {
+    evt::note(TRACE_SD_CMD, cmd, response);
+}
+
+static bool wb_flush_line(WbLine &line) {
+    if (sd_write_stream(line.data, line.sector, 1) != RES_OK) return false;
+    line.dirty = false;
+    return true;
+}
+
+static bool wb_flush_all(void) {
+    bool ok = true;
+    for (uint32_t i = 0; i < WB_LINES; i++) {
+        if (wb_lines[i].valid && wb_lines[i].dirty) {
+            if (!wb_flush_line(wb_lines[i])) ok = false;
+        }
+    }
+    if (ok) wb_dirty_any = false;
+    return ok;
+}
+
+// Push any dirty lines inside [sector, sector+count) to the card so a
+// following card read (or prefetch) of that range sees current data.
+static bool wb_flush_range(uint32_t sector, uint32_t count) {
+    bool ok = true;
+    for (uint32_t i = 0; i < WB_LINES; i++) {
+        WbLine &line = wb_lines[i];
+        if (line.valid && line.dirty &&
+            (line.sector >= sector) && (line.sector < (sector + count))) {
+            if (!wb_flush_line(line)) ok = false;
+        }
+    }
+    return ok;
+}
+
+// A multi-sector write supersedes any cached copies inside its range;
+// drop them without flushing.
+static void wb_discard_range(uint32_t sector, uint32_t count) {
+    for (uint32_t i = 0; i < WB_LINES; i++) {
+        WbLine &line = wb_lines[i];
+        if (line.valid && (line.sector >= sector) && (line.sector < (sector + count))) {
+            line.valid = false;
+            line.dirty = false;
+        }
+    }
+}
+
+#endif
+
 // --- Forward Declarations ---
 static int8_t mem_init (uint8_t lun);
 static int8_t mem_ready (uint8_t lun);
 static int8_t mem_protected (uint8_t lun);
 static int8_t mem_read (uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len);
+static int8_t mem_read_async (uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len, void (*done)(int8_t status));
 static int8_t mem_write (uint8_t lun, const uint8_t *buf, uint32_t block_addr, uint16_t block_len);
+static int8_t mem_write_async (uint8_t lun, const uint8_t *buf, uint32_t block_addr, uint16_t block_len, void (*done)(int8_t status));
+static void   mem_write_hint (uint8_t lun, uint32_t byte_len);
 static int8_t mem_maxlun (void);
 
 /* USB mass storage inquiry data (remains the same) */
@@ -40,17 +186,33 @@ const uint8_t msc_inquiry_data[] = {
     '1', '.', '0', '0',                     /* Version: 4 bytes */
 };
 
+const uint8_t msc_inquiry_data_ram[] = {
+    0x00, /* Direct-access device */
+    0x80, /* Removable media */
+    0x02, /* ISO/ECMA, ANSI version */
+    0x02, /* Response data format */
+    (USBD_STD_INQUIRY_LENGTH - 5),
+    0x00, 0x00, 0x00,
+    'G', 'D', '3', '2', ' ', ' ', ' ', ' ', /* Manufacturer: 8 bytes */
+    'S', 't', 'a', 't', 's', ' ', 'R', 'A', /* Product: 16 bytes */
+    'M', 'D', 'i', 's', 'k', ' ', ' ', ' ',
+    '1', '.', '0', '0',                     /* Version: 4 bytes */
+};
+
 // This structure is now populated by msc_mem_pre_init()
 usbd_mem_cb usbd_storage_fops = {
     .mem_init      = mem_init,
     .mem_ready     = mem_ready,
     .mem_protected = mem_protected,
     .mem_read      = mem_read,
+    .mem_read_async = mem_read_async,
     .mem_write     = (int8_t (*)(uint8_t, const uint8_t*, uint32_t, uint16_t))mem_write,
+    .mem_write_async = mem_write_async,
+    .mem_write_hint = mem_write_hint,
     .mem_maxlun    = mem_maxlun,
-    .mem_inquiry_data = {(uint8_t*)msc_inquiry_data},
-    .mem_block_size   = {card_block_size},
-    .mem_block_len    = {card_block_count}
+    .mem_inquiry_data = {(uint8_t*)msc_inquiry_data, (uint8_t*)msc_inquiry_data_ram},
+    .mem_block_size   = {card_block_size, ramdisk::BlockSize},
+    .mem_block_len    = {card_block_count, ramdisk::BlockCount}
 };
 
 usbd_mem_cb& get_msc_mem_fops() {
@@ -59,12 +221,20 @@ usbd_mem_cb& get_msc_mem_fops() {
 
 // --- Public Initialization Function ---
 
-void msc_mem_pre_init() {
+void msc_mem_probe() {
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
-    printf("Pre-caching MSC drive properties...\n");
-    // This is called once from main() before USB starts.
-    if ((sd_status() & STA_NOINIT) || (sd_status() & STA_NODISK)) {
-        printf("WARN: SD Card not ready for MSC.\n");
+    // Runs from main() while the host already enumerates the device (the
+    // USB stack lives in the USBFS interrupt); until this completes every
+    // MSC command is answered with media-not-present, so the seconds a
+    // slow or absent card can cost here never delay enumeration.
+    printf("Probing SD card for MSC...\n");
+    sd_set_cmd_observer(sd_cmd_trace);
+    if (!ovl::load(OVL_SD_INIT)) {
+        is_media_present = false;
+        return;
+    }
+    if (sd_init() & STA_NOINIT) {
+        printf("WARN: SD Card initialization failed or card not present.\n");
         is_media_present = false;
         return;
     }
@@ -74,13 +244,16 @@ void msc_mem_pre_init() {
         is_media_present = false;
         return;
     }
-    
+
     sd_ioctl(GET_SECTOR_SIZE, &card_block_size);
 
-    // Success! Update the fops structure with the correct, pre-cached values.
+    // Success! Update the fops structure with the correct values, then
+    // make the media visible and latch the change: the next TEST UNIT
+    // READY reports UNIT ATTENTION and the host re-reads the capacity.
     usbd_storage_fops.mem_block_len[0] = card_block_count;
     usbd_storage_fops.mem_block_size[0] = card_block_size;
     is_media_present = true;
+    media_changed = true;
     printf("INFO: MSC properties cached successfully. Block count: %lu\n", card_block_count);
 #else
     // If SD card is disabled in the build, ensure we always report no media.
@@ -89,6 +262,71 @@ void msc_mem_pre_init() {
 #endif
 }
 
+bool msc_mem_media_changed() {
+    if (!media_changed) {
+        return false;
+    }
+    media_changed = false;
+    return true;
+}
+
+void msc_mem_poll() {
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    if (wb_dirty_any && (get_timer_value() >= wb_deadline)) {
+        // Data-phase writes now run from the main loop (the deferred
+        // write pipeline in usb_device.cpp), so the flush no longer
+        // races an interrupt-context mem_write; it only has to stay off
+        // the bus while the async engine owns it. A busy engine just
+        // retries on the next pass -- the deadline only fires after the
+        // host has gone quiet.
+        if (!sd_async_busy()) {
+            wb_flush_all();
+        }
+    }
+
+    uint64_t now = get_timer_value();
+    if (now >= hotswap_next_poll) {
+        hotswap_next_poll = now
+                          + (uint64_t)HOTSWAP_POLL_MS * (SystemCoreClock / 4000U);
+        if (is_media_present) {
+            // The probe shares the SPI bus with the read/write pipelines,
+            // but both start their transfers from this same main loop;
+            // the only conflict left is an async transfer still in
+            // flight, so skip this interval while the engine owns the bus.
+            if (!sd_async_busy()) {
+                bool present = sd_card_present();
+                if (!present) {
+                    // The card is gone and any cached sectors went with it:
+                    // drop the write-back lines unflushed and let the host
+                    // learn of the removal through UNIT ATTENTION.
+                    for (uint32_t i = 0; i < WB_LINES; i++) {
+                        wb_lines[i].valid = false;
+                        wb_lines[i].dirty = false;
+                    }
+                    wb_dirty_any = false;
+                    is_media_present = false;
+                    media_changed = true;
+                    printf("INFO: SD card removed.\n");
+                }
+            }
+        } else if (sd_card_detect()) {
+            // Something answered in the slot; bring it up. Every MSC
+            // callback reports no media until the probe completes, so
+            // the init itself can run with USB interrupts live.
+            msc_mem_probe();
+        }
+    }
+#endif
+}
+
+uint32_t msc_mem_write_skips() {
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    return wb_write_skips;
+#else
+    return 0;
+#endif
+}
+
 // --- IMPLEMENTATION OF THE CALLBACKS ---
 
 /*!
@@ -98,7 +336,7 @@ void msc_mem_pre_init() {
     \retval     status (0 for OK, -1 for fail)
 */
 static int8_t mem_init (uint8_t lun) {
-    (void)lun;
+    if (LUN_RAM == lun) return 0; // synthesized, nothing to bring up
     return is_media_present ? 0 : -1;
 }
 
@@ -109,7 +347,7 @@ static int8_t mem_init (uint8_t lun) {
     \retval     status (0 for OK, -1 for not ready)
 */
 static int8_t mem_ready (uint8_t lun) {
-    (void)lun;
+    if (LUN_RAM == lun) return 0;
     return is_media_present ? 0 : -1;
 }
 
@@ -120,7 +358,10 @@ static int8_t mem_ready (uint8_t lun) {
     \retval     status (0 for not protected, 1 for protected)
 */
 static int8_t mem_protected (uint8_t lun) {
-    (void)lun;
+    // The RAM disk is read-only by design: file sizes are fixed and the
+    // content is synthesized, so there is nothing a host write could
+    // coherently update.
+    if (LUN_RAM == lun) return 1;
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
     if (!is_media_present) return 1;
     return (sd_status() & STA_PROTECT) ? 1 : 0;
@@ -139,16 +380,85 @@ static int8_t mem_protected (uint8_t lun) {
     \retval     status (0 for OK, -1 for fail)
 */
 static int8_t mem_read (uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len) {
-    (void)lun;
+    if (LUN_RAM == lun) {
+        return ramdisk::read(buf, block_addr / ramdisk::BlockSize, block_len);
+    }
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
     if (!is_media_present) return -1;
-    return (sd_read_blocks(buf, block_addr, block_len) == RES_OK) ? 0 : -1;
+    // The SCSI layer passes a byte address; the SD driver takes sectors.
+    uint32_t sector = block_addr / card_block_size;
+
+    // Synchronous fallback (the pipeline prefers mem_read_async). The
+    // sequential stream keeps one CMD18 open across consecutive calls,
+    // so a run of chunks still clocks out back to back. Any dirty
+    // write-back lines in the range go to the card first so the stream
+    // sees current data.
+    if (!wb_flush_range(sector, block_len)) return -1;
+    return (sd_read_stream(buf, sector, block_len) == RES_OK) ? 0 : -1;
 #else
     (void)buf; (void)block_addr; (void)block_len;
     return -1;
 #endif
 }
 
+/*!
+    \brief      start an asynchronous read straight into the caller's buffer
+    \param[in]  lun: logical unit number
+    \param[in]  buf: destination; the SPI DMA writes it directly
+    \param[in]  block_addr: byte address of the first block
+    \param[in]  block_len: number of blocks to read
+    \param[in]  done: called with 0/-1 from the transfer-complete interrupt
+    \param[out] none
+    \retval     status (0 for started, -1 if the transfer cannot start)
+*/
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+// The read pipeline for one chunk, straight line: any dirty write-back
+// line in the range goes to the card first (the stream must see current
+// data), then the chunk itself streams into the caller's buffer. Every
+// co_await parks this function while the SPI DMA runs and resumes it
+// from the transfer-complete interrupt, so the steps chain with zero
+// main-loop involvement -- what used to take one callback per step and
+// a flag per edge. Frame comes from the lib/alloc block pools.
+static coro::task msc_read_task(uint8_t *buf, uint32_t sector, uint16_t count,
+                                void (*done)(int8_t status)) {
+    for (uint32_t i = 0; i < WB_LINES; i++) {
+        WbLine &line = wb_lines[i];
+        if (!line.valid || !line.dirty) continue;
+        if ((line.sector < sector) || (line.sector >= sector + count)) continue;
+        if (sd_write_blocks_async(line.data, line.sector, 1, sd_done_signal) != RES_OK
+            || co_await sd_done != RES_OK) {
+            done(-1);
+            co_return;
+        }
+        line.dirty = false;
+    }
+    if (sd_read_blocks_async(buf, sector, count, sd_done_signal) != RES_OK) {
+        done(-1);
+        co_return;
+    }
+    done((co_await sd_done == RES_OK) ? 0 : -1);
+}
+#endif
+
+static int8_t mem_read_async (uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len, void (*done)(int8_t status)) {
+    // The RAM disk synthesizes at memory speed; the caller's synchronous
+    // fallback is already the fast path, so there is nothing to overlap.
+    if (LUN_RAM == lun) return -1;
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    if (!is_media_present) return -1;
+    if (sd_async_busy()) return -1; // engine busy: caller's sync fallback
+    uint32_t sector = block_addr / card_block_size;
+    // The task starts its first transfer before returning; done() fires
+    // from the completion interrupt (or inline, when a start fails
+    // before the first suspend -- the pipeline tolerates both).
+    coro::task t = msc_read_task(buf, sector, block_len, done);
+    return t.started ? 0 : -1; // !started: frame pool dry, nothing ran
+#else
+    (void)buf; (void)block_addr; (void)block_len; (void)done;
+    return -1;
+#endif
+}
+
 /*!
     \brief      write data to the memory media
     \param[in]  lun: logical unit number
@@ -159,16 +469,143 @@ static int8_t mem_read (uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t
     \retval     status (0 for OK, -1 for fail)
 */
 static int8_t mem_write (uint8_t lun, const uint8_t *buf, uint32_t block_addr, uint16_t block_len) {
-    (void)lun;
+    if (LUN_RAM == lun) return -1; // write-protected; belt and braces
 #if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
     if (!is_media_present) return -1;
-    return (sd_write_blocks(buf, block_addr, block_len) == RES_OK) ? 0 : -1;
+    // The SCSI layer passes a byte address; the SD driver takes sectors.
+    uint32_t sector = block_addr / card_block_size;
+
+    // Single-sector writes are the FAT/directory pattern: the host
+    // rewrites the same hot sectors over and over. Coalesce them in the
+    // write-back cache and program the card once, after the deadline.
+    if (1 == block_len) {
+        WbLine *line = nullptr;
+        for (uint32_t i = 0; i < WB_LINES; i++) {
+            if (wb_lines[i].valid && (wb_lines[i].sector == sector)) {
+                line = &wb_lines[i];
+                break;
+            }
+        }
+        if (nullptr != line) {
+            // Hot sector: the cached copy is what the card holds (clean)
+            // or what the deadline flush will program (dirty); either way
+            // an identical rewrite changes nothing.
+            if (WB_COMPARE_SKIP &&
+                (0 == memcmp(line->data, buf, card_block_size))) {
+                wb_write_skips++;
+                return 0;
+            }
+        } else {
+            line = &wb_lines[wb_victim];
+            wb_victim = (wb_victim + 1U) % WB_LINES;
+            if (line->valid && line->dirty && !wb_flush_line(*line)) return -1;
+            line->valid = false;
+            line->sector = sector;
+            if (WB_COMPARE_SKIP &&
+                (sd_read_stream(line->data, sector, 1) == RES_OK)) {
+                // The line now caches the card's copy; a matching write
+                // leaves it clean and skips the program outright.
+                line->valid = true;
+                line->dirty = false;
+                if (0 == memcmp(line->data, buf, card_block_size)) {
+                    wb_write_skips++;
+                    return 0;
+                }
+            } else {
+                // Compare disabled or the read failed: fall back to the
+                // plain fill-and-dirty path below.
+                line->valid = true;
+            }
+        }
+        memcpy(line->data, buf, card_block_size);
+        line->dirty = true;
+        wb_dirty_any = true;
+        wb_deadline = get_timer_value()
+                    + (uint64_t)WB_FLUSH_DELAY_MS * (SystemCoreClock / 4000U);
+        return 0;
+    }
+
+    // Bulk data: it supersedes any cached copies in its range, then goes
+    // through the sequential stream as before (one CMD25 stays open
+    // across consecutive chunks, so the card programs the run
+    // continuously).
+    wb_discard_range(sector, block_len);
+    return (sd_write_stream(buf, sector, block_len) == RES_OK) ? 0 : -1;
 #else
     (void)buf; (void)block_addr; (void)block_len;
     return -1;
 #endif
 }
 
+/*!
+    \brief      start an asynchronous write from the caller's buffer
+    \param[in]  lun: logical unit number
+    \param[in]  buf: source; the SPI DMA reads it directly
+    \param[in]  block_addr: byte address of the first block
+    \param[in]  block_len: number of blocks to write
+    \param[in]  done: called with 0/-1 from the transfer-complete interrupt
+    \param[out] none
+    \retval     status (0 for started or completed inline, -1 otherwise)
+*/
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+// The write pipeline for one bulk chunk, same shape as msc_read_task:
+// cached copies in the range are superseded (dropped, never flushed),
+// then the chunk streams from the caller's buffer while the co_await
+// parks this function until the transfer-complete interrupt.
+static coro::task msc_write_task(const uint8_t *buf, uint32_t sector, uint16_t count,
+                                 void (*done)(int8_t status)) {
+    if (sd_write_blocks_async(buf, sector, count, sd_done_signal) != RES_OK) {
+        done(-1);
+        co_return;
+    }
+    done((co_await sd_done == RES_OK) ? 0 : -1);
+}
+#endif
+
+static int8_t mem_write_async (uint8_t lun, const uint8_t *buf, uint32_t block_addr, uint16_t block_len, void (*done)(int8_t status)) {
+    if (LUN_RAM == lun) return -1; // write-protected; belt and braces
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    if (!is_media_present) return -1;
+    // Single-sector writes are the FAT/directory pattern; they land in
+    // the write-back cache at memory speed, so there is no card wait
+    // worth overlapping. Run the synchronous path inline (now in
+    // main-loop context, where a cache-miss compare read is harmless)
+    // and report completion immediately.
+    if (1 == block_len) {
+        if (mem_write(lun, buf, block_addr, block_len) < 0) return -1;
+        done(0);
+        return 0;
+    }
+    if (sd_async_busy()) return -1; // engine busy: caller's sync fallback
+    uint32_t sector = block_addr / card_block_size;
+    wb_discard_range(sector, block_len);
+    // The task starts its transfer before returning; done() fires from
+    // the completion interrupt (or inline when the start fails before
+    // the first suspend -- the pipeline tolerates both).
+    coro::task t = msc_write_task(buf, sector, block_len, done);
+    return t.started ? 0 : -1; // !started: frame pool dry, nothing ran
+#else
+    (void)buf; (void)block_addr; (void)block_len; (void)done;
+    return -1;
+#endif
+}
+
+/*!
+    \brief      announce the total length of an upcoming sequential write
+    \param[in]  lun: logical unit number
+    \param[in]  byte_len: total data-phase length in bytes
+    \param[out] none
+    \retval     none
+*/
+static void mem_write_hint (uint8_t lun, uint32_t byte_len) {
+    if (LUN_RAM == lun) return;
+#if defined(USE_SD_CARD_MSC) && (USE_SD_CARD_MSC == 1)
+    sd_write_stream_hint(byte_len / card_block_size);
+#else
+    (void)byte_len;
+#endif
+}
+
 /*!
     \brief      get number of supported logical unit
     \param[in]  none
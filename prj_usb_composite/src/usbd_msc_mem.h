@@ -19,7 +19,27 @@ typedef struct {
     int8_t (*mem_ready)(uint8_t lun);
     int8_t (*mem_protected)(uint8_t lun);
     int8_t (*mem_read)(uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len);
+    // Streaming read: starts an asynchronous card transfer (SPI DMA)
+    // directly into buf and returns immediately; done(status) fires from
+    // the transfer-complete interrupt. Returns -1 without calling done
+    // when the transfer cannot start (no media, engine busy); the caller
+    // then falls back to the synchronous mem_read.
+    int8_t (*mem_read_async)(uint8_t lun, uint8_t *buf, uint32_t block_addr,
+                             uint16_t block_len, void (*done)(int8_t status));
     int8_t (*mem_write)(uint8_t lun, const uint8_t *buf, uint32_t block_addr, uint16_t block_len);
+    // Streaming write: starts an asynchronous card transfer (SPI DMA)
+    // from buf and returns immediately; done(status) fires from the
+    // transfer-complete interrupt. Single-sector writes may instead
+    // complete through the metadata cache before returning, with done
+    // firing inline. Returns -1 without calling done when the transfer
+    // cannot start; the caller then falls back to the synchronous
+    // mem_write.
+    int8_t (*mem_write_async)(uint8_t lun, const uint8_t *buf, uint32_t block_addr,
+                              uint16_t block_len, void (*done)(int8_t status));
+    // Announces the total byte length of an upcoming sequential write run
+    // (from the SCSI CBW) so the medium can prepare, e.g. SD ACMD23
+    // pre-erase across the whole range instead of one chunk.
+    void   (*mem_write_hint)(uint8_t lun, uint32_t byte_len);
     int8_t (*mem_maxlun)(void);
 
     // Pointers to constant data describing the storage medium
@@ -32,10 +52,42 @@ typedef struct {
 usbd_mem_cb& get_msc_mem_fops();
 
 /**
- * @brief Performs the one-time, slow initialization of the SD card properties.
- * This must be called from main() before the USB stack is initialized.
+ * @brief Probes the SD card and caches the MSC drive properties.
+ * Called from main() AFTER the USB stack is started: enumeration runs
+ * from the USBFS interrupt and reports media-not-present while this
+ * executes, so a slow (or absent) card no longer delays the whole
+ * composite device. When the card turns out to be usable, the media
+ * arrival is latched and reported to the host through a SCSI UNIT
+ * ATTENTION on the next TEST UNIT READY (see msc_mem_media_changed).
  * @return void
  */
-void msc_mem_pre_init();
+void msc_mem_probe();
+
+/**
+ * @brief Returns (and clears) the latched media-change flag.
+ * Consumed by the SCSI layer: one TEST UNIT READY after the probe
+ * succeeds fails with UNIT ATTENTION / MEDIUM_CHANGED, which makes the
+ * host re-read capacity and mount the volume.
+ * @return true exactly once per media arrival.
+ */
+bool msc_mem_media_changed();
+
+/**
+ * @brief Pumps the MSC memory layer from the main loop.
+ * Flushes write-back cache lines whose deadline has passed, so repeated
+ * host writes to hot FAT/directory sectors coalesce into one card
+ * program operation.
+ * @return void
+ */
+void msc_mem_poll();
+
+/**
+ * @brief Number of host sector writes skipped as byte-identical.
+ * The write path compares single-sector writes against the cached copy
+ * of the target sector (read-compare-skip) and drops the card program
+ * when nothing changed. Reported as the seventh GET_STATS counter.
+ * @return running skip count since boot (0 when MSC is built out).
+ */
+uint32_t msc_mem_write_skips();
 
 #endif /* USBD_MSC_MEM_H */
\ No newline at end of file
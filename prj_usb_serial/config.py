@@ -37,6 +37,14 @@ GLOBAL_C_DEFINES = [
     "-DGD32VF103",
     "-D__NUCLEI_N200",
     "-DGD32VF103C_START",
+    # USB needs CK_USBFS = 48 MHz = CK_SYS / 2, so 96 is the ceiling here
+    # (see lib/system/system_gd32vf103.c for the profiles).
+    "-DSYSTEM_CLOCK_PROFILE=96",
+    # Set to 1 to replace the UART bridge with a zero-copy CDC loopback
+    # (bulk OUT queued straight back on bulk IN). Benchmark build for
+    # tools/cdc_loopback_bench.py; isolates USB stack throughput from
+    # the UART path.
+    "-DCDC_LOOPBACK=0",
 ]
 
 # --- CPU & ABI Flags ---
@@ -63,7 +71,7 @@ for component_name in ['riscv_drivers', 'syscall_stubs', 'gd32_std_peripheral_li
     gd32_components[component_name]['module'] = "gd32"
 
 lib_components = {}
-for component_name in ['sdcard', 'system', 'debug_uart0',]:
+for component_name in ['sdcard', 'system', 'debug_uart0', 'dma', 'ring', 'tinyfmt',]:
     lib_components[component_name] = lib[component_name].copy()
     lib_components[component_name]['module'] = 'lib'
 
@@ -88,7 +96,7 @@ COMPONENTS = {
     },
     "application": {
         "c_sources": [r"src/gd32vf103_hw.c",],
-        "cpp_sources": [r"src/main.cpp",],
+        "cpp_sources": [r"src/main.cpp", r"src/uart_bridge.cpp",],
         "asm_sources": [],
         "include_paths": [r"-Isrc"],
         "enabled": True
@@ -107,6 +115,8 @@ NUCLEUS_OPENOCD_PATH = config.NUCLEUS_OPENOCD_PATH
 OPENOCD_PATH = config.OPENOCD_PATH
 DFU_UTIL_PATH = config.DFU_UTIL_PATH
 OPTIMIZATION = config.OPTIMIZATION
+BUILD_PROFILES = config.BUILD_PROFILES
+LTO_FLAGS = config.LTO_FLAGS
 C_STANDARD = config.C_STANDARD
 CPP_STANDARD = config.CPP_STANDARD
 COMMON_WARNING_FLAGS = config.COMMON_WARNING_FLAGS
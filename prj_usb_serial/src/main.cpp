@@ -38,6 +38,7 @@ extern "C" {
 #include <stdio.h>
 #include "gpio.h"
 #include "usb.hpp"
+#include "uart_bridge.h"
 
 
 // Create instances of the Led class for the onboard LEDs
@@ -68,30 +69,27 @@ int main(void)
 
     // Initialize the USB device with a single call
     usb::init();
-    
-    uint32_t counter = 0;
-    while(1){
-        // Print a message with a counter to show the program is running.
-        printf("Counter value: %lu\n", counter++);    
-        /* turn on LED1, turn off LED4 */
-        led_red.on();
-        led_green.on();
-        led_blue.off();
-        
-        delay_1ms(100);
+#if !CDC_LOOPBACK
+    // Bridge USART2 (TX=PB10, RX=PB11) to the CDC port. Wire RX is
+    // gathered by a circular DMA; the loop below only moves whole
+    // chunks, so high baud rates never translate into per-byte work.
+    bridge::init(115200U);
 
-        // Handle periodic USB tasks
-        usb::poll();
+    printf("USB <-> USART2 bridge running\n");
+#endif
 
-        /* turn off LED1, turn on LED4 */
-        led_red.off();
-        led_green.off();
-        led_blue.off();
-        delay_1ms(100);
+    uint32_t loops = 0;
+    while(1){
+#if !CDC_LOOPBACK
+        // Move wire RX chunks into the CDC TX ring, then run the USB
+        // side (packet batching, OUT re-arm). Neither call blocks.
+        bridge::poll();
+#endif
+        usb::poll();
 
-        led_red.on();
-        led_green.off();
-        led_blue.on();
-        delay_1ms(100);
+        // Slow green heartbeat so a stuck loop is visible on the board.
+        if (0 == (++loops & 0x3FFFF)) {
+            led_green.toggle();
+        }
     }
 }
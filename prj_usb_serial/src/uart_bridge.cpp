@@ -0,0 +1,175 @@
+/* DMA-driven USART2 <-> CDC bridge; see uart_bridge.h. */
+
+#include "uart_bridge.h"
+#include "usb.hpp"
+
+extern "C" {
+#include "gd32vf103.h"
+#include "n200_func.h" // eclic_enable_interrupt
+}
+
+namespace {
+
+// USART2 DMA request lines on DMA0.
+constexpr dma_channel_enum RX_DMA_CH = DMA_CH2;
+constexpr dma_channel_enum TX_DMA_CH = DMA_CH1;
+
+// Wire RX circular buffer. The DMA wraps on its own; poll() chases the
+// hardware write position. 512 bytes is ~4.4 ms of headroom at 921600
+// baud between poll() calls before the oldest bytes are overwritten.
+constexpr uint32_t RX_BUF_SIZE = 512;
+uint8_t g_rx_buf[RX_BUF_SIZE];
+uint32_t g_rx_tail = 0; // next byte poll() has not yet consumed
+
+// Host-to-wire packet buffers, lent to the CDC OUT endpoint. Packets
+// complete directly in these and the TX DMA transmits from the same
+// memory - the old staging copy is gone, which is a full packet-time
+// of CPU work saved per packet at high baud rates. A buffer is only
+// re-lent once the wire DMA is done with it, so at most one packet is
+// in flight and one more buffered; beyond that the host is NAK-held,
+// same flow control as before.
+constexpr uint32_t WIRE_TX_BUFS = 2;
+uint8_t g_pkt_buf[WIRE_TX_BUFS][64];
+uint8_t* g_wire_active = nullptr;  // buffer currently on the TX DMA
+uint8_t* g_wire_pending = nullptr; // filled buffer waiting for the DMA
+uint32_t g_wire_pending_len = 0;
+
+// Set by the IDLE-line interrupt; purely a wake-up/diagnostic marker,
+// the data itself is found by reading the DMA position in poll().
+volatile bool g_rx_idle_seen = false;
+
+// Where the RX DMA will write next, derived from the remaining-count
+// register of the circular channel.
+uint32_t rx_dma_head() {
+    return RX_BUF_SIZE - dma_transfer_number_get(DMA0, RX_DMA_CH);
+}
+
+void start_wire_tx(uint8_t* buf, uint32_t len) {
+    dma_memory_address_config(DMA0, TX_DMA_CH, (uint32_t)(uintptr_t)buf);
+    dma_transfer_number_config(DMA0, TX_DMA_CH, len);
+    dma_channel_enable(DMA0, TX_DMA_CH);
+    g_wire_active = buf;
+}
+
+// Retire a finished wire transmission: return its buffer to the OUT
+// endpoint descriptor ring and start the waiting packet, if any.
+void wire_tx_service() {
+    if (g_wire_active != nullptr &&
+        SET == dma_flag_get(DMA0, TX_DMA_CH, DMA_FLAG_FTF)) {
+        dma_channel_disable(DMA0, TX_DMA_CH);
+        dma_flag_clear(DMA0, TX_DMA_CH, DMA_FLAG_FTF);
+        usb::lend_rx_buffer(g_wire_active, 64);
+        g_wire_active = nullptr;
+        if (g_wire_pending != nullptr) {
+            start_wire_tx(g_wire_pending, g_wire_pending_len);
+            g_wire_pending = nullptr;
+        }
+    }
+}
+
+// Filled-buffer notification from the zero-copy CDC RX path: the
+// packet is already in one of g_pkt_buf, so it goes straight onto the
+// wire DMA (or waits its turn - with both buffers out, the endpoint
+// has nothing lent and the host is NAK-held).
+void host_pkt_filled(uint8_t* data, uint32_t len) {
+    wire_tx_service();
+    if (g_wire_active == nullptr) {
+        start_wire_tx(data, len);
+    } else {
+        g_wire_pending = data;
+        g_wire_pending_len = len;
+    }
+}
+
+} // namespace
+
+namespace bridge {
+
+void init(uint32_t baudrate) {
+    rcu_periph_clock_enable(RCU_GPIOB);
+    rcu_periph_clock_enable(RCU_USART2);
+    rcu_periph_clock_enable(RCU_DMA0);
+
+    // TX=PB10, RX=PB11
+    gpio_init(GPIOB, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, GPIO_PIN_10);
+    gpio_init(GPIOB, GPIO_MODE_IN_FLOATING, GPIO_OSPEED_50MHZ, GPIO_PIN_11);
+
+    usart_deinit(USART2);
+    usart_baudrate_set(USART2, baudrate);
+    usart_receive_config(USART2, USART_RECEIVE_ENABLE);
+    usart_transmit_config(USART2, USART_TRANSMIT_ENABLE);
+    usart_dma_receive_config(USART2, USART_RECEIVE_DMA_ENABLE);
+    usart_dma_transmit_config(USART2, USART_TRANSMIT_DMA_ENABLE);
+
+    // Wire RX: circular DMA, runs forever without CPU involvement.
+    dma_parameter_struct dma_init_struct;
+    dma_struct_para_init(&dma_init_struct);
+    dma_deinit(DMA0, RX_DMA_CH);
+    dma_init_struct.direction = DMA_PERIPHERAL_TO_MEMORY;
+    dma_init_struct.memory_addr = (uint32_t)(uintptr_t)g_rx_buf;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.number = RX_BUF_SIZE;
+    dma_init_struct.periph_addr = (uint32_t)(uintptr_t)&USART_DATA(USART2);
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.priority = DMA_PRIORITY_ULTRA_HIGH;
+    dma_init(DMA0, RX_DMA_CH, &dma_init_struct);
+    dma_circulation_enable(DMA0, RX_DMA_CH);
+    dma_channel_enable(DMA0, RX_DMA_CH);
+
+    // Host-to-wire TX: one-shot transfers, re-armed per CDC packet.
+    dma_deinit(DMA0, TX_DMA_CH);
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.memory_addr = (uint32_t)(uintptr_t)g_pkt_buf[0];
+    dma_init_struct.number = 0;
+    dma_init(DMA0, TX_DMA_CH, &dma_init_struct);
+    dma_circulation_disable(DMA0, TX_DMA_CH);
+
+    // IDLE-line detection frames wire bursts without per-byte work.
+    usart_interrupt_enable(USART2, USART_INT_IDLE);
+    eclic_enable_interrupt(USART2_IRQn); // level/priority: lib/system/irq_map.c
+
+    usart_enable(USART2);
+
+    // Zero-copy host-to-wire: lend both packet buffers to the OUT
+    // endpoint and take them back through the filled handler.
+    usb::set_rx_filled_handler(host_pkt_filled);
+    for (uint32_t i = 0; i < WIRE_TX_BUFS; i++) {
+        usb::lend_rx_buffer(g_pkt_buf[i], sizeof(g_pkt_buf[i]));
+    }
+}
+
+void poll() {
+    // Retire any finished host-to-wire DMA so its buffer goes back to
+    // the OUT endpoint even when no new packet has arrived.
+    wire_tx_service();
+
+    // Chase the DMA write position; wrap yields two contiguous runs.
+    uint32_t head = rx_dma_head();
+    while (g_rx_tail != head) {
+        uint32_t run = (head > g_rx_tail) ? (head - g_rx_tail)
+                                          : (RX_BUF_SIZE - g_rx_tail);
+        uint32_t accepted = usb::write(&g_rx_buf[g_rx_tail], run);
+        g_rx_tail = (g_rx_tail + accepted) & (RX_BUF_SIZE - 1);
+        if (accepted < run) {
+            // CDC TX ring full; the rest stays in the DMA buffer for
+            // the next pass. If the host stalls long enough for the
+            // circular DMA to lap the tail, the oldest bytes are lost,
+            // which is the usual bridge failure mode at that point.
+            break;
+        }
+    }
+    g_rx_idle_seen = false;
+}
+
+} // namespace bridge
+
+extern "C" void uart_bridge_usart_isr(void) {
+    if (usart_interrupt_flag_get(USART2, USART_INT_FLAG_IDLE) != RESET) {
+        // The IDLE flag is cleared by a STAT read (the flag_get above)
+        // followed by a DATA read.
+        (void)usart_data_receive(USART2);
+        g_rx_idle_seen = true;
+    }
+}
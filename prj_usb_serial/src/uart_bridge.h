@@ -0,0 +1,36 @@
+#ifndef UART_BRIDGE_H
+#define UART_BRIDGE_H
+
+#include <cstdint>
+
+/**
+ * @brief DMA-driven USART2 <-> CDC ACM bridge.
+ *
+ * Wire RX runs as a circular DMA into a 512-byte buffer with idle-line
+ * framing: the core never takes a per-byte interrupt, so high baud
+ * rates (921600 and up) cost the same as low ones. poll() hands the
+ * chunk between the last read position and the DMA write position to
+ * the CDC TX ring (usb::write), where it is batched into full 64-byte
+ * bulk packets. Host-to-wire data goes out through a one-shot TX DMA;
+ * while a transfer is on the wire the CDC OUT endpoint is simply left
+ * un-rearmed, NAK-flow-controlling the host instead of buffering.
+ *
+ * USART2 (TX=PB10, RX=PB11) is used rather than USART0, which the
+ * debug UART owns for printf output.
+ */
+namespace bridge {
+
+// Configures USART2, both DMA channels and the IDLE interrupt, and
+// installs the CDC receive handler. Call after usb::init().
+void init(uint32_t baudrate);
+
+// Moves wire RX bytes gathered by the DMA into the CDC TX path.
+// Call from the main loop alongside usb::poll().
+void poll();
+
+} // namespace bridge
+
+// USART2 IDLE-line interrupt body, called from USART2_IRQHandler.
+extern "C" void uart_bridge_usart_isr(void);
+
+#endif // UART_BRIDGE_H
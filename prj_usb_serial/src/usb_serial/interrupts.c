@@ -38,6 +38,7 @@ OF SUCH DAMAGE.
 extern usb_core_driver cdc_acm;
 extern uint32_t usbfs_prescaler;
 extern void usb_timer_irq (void);
+extern void uart_bridge_usart_isr(void);
 
 /* local function prototypes ('static') */
 static void resume_mcu_clk(void);
@@ -85,6 +86,18 @@ void TIMER2_IRQHandler(void)
     usb_timer_irq();
 }
 
+/*!
+    \brief      this function handles the USART2 IDLE-line interrupt
+                (wire RX framing for the UART bridge, see uart_bridge.h)
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART2_IRQHandler(void)
+{
+    uart_bridge_usart_isr();
+}
+
 /*!
     \brief      resume mcu clock
     \param[in]  none
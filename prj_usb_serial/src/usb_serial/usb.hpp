@@ -30,6 +30,54 @@ void poll();
 */
 bool is_configured();
 
+/*!
+    \brief      Queues application bytes for transmission to the host.
+                Never blocks: bytes go into the TX ring and poll() flushes
+                them as full 64-byte bulk packets (a partial packet only
+                once the ring has gone idle), so many small writes coalesce
+                instead of each costing a bulk IN packet.
+    \param[in]  data: The bytes to transmit.
+    \param[in]  len:  Number of bytes in data.
+    \retval     Number of bytes accepted; less than len when the ring is
+                full (the caller may retry the remainder after poll()).
+*/
+uint32_t write(const uint8_t* data, uint32_t len);
+
+/*!
+    \brief      Installs a handler for data received from the host.
+                poll() hands it each received packet; return true to
+                consume the packet, or false to leave it pending -- the
+                OUT endpoint is then not re-armed (the host is NAK-flow-
+                controlled) and the handler is retried on the next
+                poll(). With no handler installed, received data is
+                echoed back through write() (loopback demo behavior).
+*/
+typedef bool (*rx_handler_t)(const uint8_t* data, uint32_t len);
+void set_rx_handler(rx_handler_t handler);
+
+/*!
+    \brief      Zero-copy receive: the application lends packet buffers
+                to the OUT endpoint through a small descriptor ring, and
+                each completed packet comes back through the filled
+                handler pointing into the lent buffer - no staging copy.
+                While no buffer is lent the endpoint stays un-armed and
+                the host is NAK-flow-controlled, so lending is also the
+                flow-control valve: hold a buffer back until its
+                consumer (e.g. the wire TX DMA) is done with it, then
+                lend it again. Takes precedence over set_rx_handler().
+*/
+typedef void (*rx_filled_t)(uint8_t* data, uint32_t len);
+void set_rx_filled_handler(rx_filled_t handler);
+
+/*!
+    \brief      Lends one buffer (>= the 64-byte bulk packet size) to
+                the OUT endpoint descriptor ring.
+    \retval     false when the ring is full (more buffers lent than the
+                ring tracks); the caller should re-lend after a filled
+                notification returns one.
+*/
+bool lend_rx_buffer(uint8_t* buf, uint32_t size);
+
 } // namespace usb
 
 #endif // USB_HPP
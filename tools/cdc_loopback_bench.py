@@ -0,0 +1,107 @@
+"""
+CDC loopback throughput benchmark for prj_usb_serial.
+
+Requires a firmware built with -DCDC_LOOPBACK=1 (see prj_usb_serial/config.py):
+in that build every bulk OUT packet is queued straight back on the bulk IN
+endpoint with no copy, so the number measured here is the USB stack itself,
+with no ring buffer and no UART in the path. It is the upper bound the
+ring-buffer and DMA bridge work should be compared against.
+
+The benchmark is run once per write chunk size. A background thread drains
+the echoed bytes while the main thread keeps the OUT pipe full, so the
+reported figure is sustained full-duplex throughput, not a single round trip.
+"""
+
+import sys
+import threading
+import time
+
+import serial
+import serial.tools.list_ports
+
+# A part of the description of the COM port for the Longan Nano; same
+# convention as testserial.py. The baud rate is irrelevant for a native
+# CDC device but pyserial requires one.
+TARGET_DEVICE_DESCRIPTION = "Serial Device"
+BAUD_RATE = 115200
+
+# Write sizes to sweep. 64 is one bulk packet; larger chunks show how much
+# of the cost is per-packet versus per-write-call on the host side.
+CHUNK_SIZES = [64, 256, 1024, 4096, 16384]
+
+# Seconds of sustained traffic per chunk size.
+DURATION_S = 3.0
+
+
+def find_serial_port():
+    """Scans available COM ports and finds the one matching the target device."""
+    for port in serial.tools.list_ports.comports():
+        if TARGET_DEVICE_DESCRIPTION in port.description:
+            return port.device
+    return None
+
+
+class _Drain(threading.Thread):
+    """Reads and counts echoed bytes until stopped."""
+
+    def __init__(self, ser):
+        super().__init__(daemon=True)
+        self.ser = ser
+        self.received = 0
+        self.stop_flag = False
+
+    def run(self):
+        while not self.stop_flag:
+            data = self.ser.read(65536)
+            self.received += len(data)
+
+
+def run_benchmark(ser, chunk_size, duration_s):
+    """Returns (sent_bytes, received_bytes, elapsed_s) for one chunk size."""
+    chunk = bytes(i & 0xFF for i in range(chunk_size))
+    drain = _Drain(ser)
+    drain.start()
+
+    sent = 0
+    start = time.perf_counter()
+    deadline = start + duration_s
+    while time.perf_counter() < deadline:
+        ser.write(chunk)
+        sent += chunk_size
+
+    # Let the device echo back whatever is still in flight before stopping
+    # the counter; everything unreturned after that is counted as lost.
+    settle_deadline = time.perf_counter() + 1.0
+    while drain.received < sent and time.perf_counter() < settle_deadline:
+        time.sleep(0.01)
+    elapsed = time.perf_counter() - start
+
+    drain.stop_flag = True
+    drain.join(timeout=1.0)
+    return sent, drain.received, elapsed
+
+
+def main():
+    port_name = find_serial_port()
+    if port_name is None:
+        print(f"No port matching '{TARGET_DEVICE_DESCRIPTION}' found.")
+        print("Is the board connected and running a -DCDC_LOOPBACK=1 build?")
+        return 1
+
+    print(f"Benchmarking CDC loopback on {port_name} "
+          f"({DURATION_S:.0f}s per chunk size)\n")
+    print(f"{'chunk':>8}  {'sent MB':>8}  {'rcvd MB':>8}  {'MB/s':>7}  lost")
+
+    with serial.Serial(port_name, BAUD_RATE, timeout=0.1) as ser:
+        ser.reset_input_buffer()
+        for chunk_size in CHUNK_SIZES:
+            sent, received, elapsed = run_benchmark(ser, chunk_size, DURATION_S)
+            rate = received / elapsed / 1e6
+            lost = sent - received
+            print(f"{chunk_size:>8}  {sent / 1e6:>8.2f}  {received / 1e6:>8.2f}"
+                  f"  {rate:>7.3f}  {lost if lost else '-'}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -29,6 +29,31 @@ DFU_UTIL_PATH = "dfu-util"
 # Optimization level. -Os for size, -O2 for speed, -O0 for debugging.
 OPTIMIZATION = "-Os"
 
+# ==============================================================================
+# Build Profiles
+# ==============================================================================
+# Selected with 'python bldmgr/build.py <project> --profile=<name>' (default:
+# "debug"). Each profile sets the baseline optimization level, whether debug
+# info is emitted, and whether link-time optimization is enabled. Components
+# may pin their own level with an 'optimization' key in the component table
+# (e.g. the usbfs driver stays -O2 in the size profile, the vendor peripheral
+# library stays -Os in the speed profile); that override wins in every profile.
+BUILD_PROFILES = {
+    # Current default behaviour: project OPTIMIZATION, -g per DEBUG_MODE.
+    "debug":   {"optimization": OPTIMIZATION, "debug_info": True,  "lto": False},
+    # Size-first release: smallest image, cross-TU inlining via LTO.
+    "release": {"optimization": "-Os",        "debug_info": False, "lto": True},
+    # Speed-first release: -O2 baseline, cold vendor code kept at -Os by
+    # per-component overrides.
+    "speed":   {"optimization": "-O2",        "debug_info": False, "lto": True},
+}
+
+# Flags added to every compile and to the link when a profile enables LTO.
+# -ffat-lto-objects keeps regular code alongside the GIMPLE bytecode, so
+# cached objects stay linkable from non-LTO builds and 'size' still works
+# on individual .o files.
+LTO_FLAGS = ["-flto", "-ffat-lto-objects"]
+
 # C and C++ Language Standards.
 # Use GNU standards for common extensions in embedded code.
 C_STANDARD = "-std=gnu17"
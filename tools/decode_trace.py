@@ -0,0 +1,121 @@
+"""Request and decode the firmware's binary event trace.
+
+Sends a GET_TRACE command over the custom HID interface, collects the
+trace dump reports and prints the events with timestamps converted to
+microseconds. Event ids mirror prj_usb_composite/src/trace_ids.h - keep
+the two lists in step.
+
+Usage: python decode_trace.py [core_mhz]
+"""
+
+import struct
+import sys
+import time
+
+import hid
+
+VID = 0x28E9
+PID = 0xABCD
+
+REPORT_LENGTH = 64
+REPORT_ID = 0x00
+
+CMD_GET_TRACE = 0x0C
+
+# IN report framing: first byte 0x04 marks a trace report; the second is
+# 0xFF for the header chunk, else the chunk sequence number.
+TRACE_REPORT = 0x04
+TRACE_HEADER = 0xFF
+
+EVENT_SIZE = 12  # u32 cycles, u16 id, u16 arg16, u32 arg32 (little endian)
+
+# Mirror of trace_ids.h.
+EVENT_NAMES = {
+    0x0001: "USB_OUT_PKT",
+    0x0002: "DISP_SLOT_DROP",
+    0x0003: "BLIT_START",
+    0x0004: "BLIT_DONE",
+    0x0005: "MSC_FETCH",
+    0x0006: "MSC_IN_SEND",
+    0x0007: "MSC_CSW",
+    0x0008: "INPUT_EVENT",
+    0x0009: "DISP_CRC_FAIL",
+    0x000A: "ISR_LATENCY",
+    0x000B: "SD_CMD",
+}
+
+
+def find_custom_hid_device():
+    for device_dict in hid.enumerate():
+        if device_dict['vendor_id'] == VID and \
+           device_dict['product_id'] == PID and \
+           device_dict['usage_page'] == 0xFF00:
+            return device_dict['path']
+    return None
+
+
+def collect_trace(device):
+    """Returns (events, wrapped) where events is a list of raw tuples."""
+    packet = bytearray([REPORT_ID, CMD_GET_TRACE])
+    packet.extend([0] * (REPORT_LENGTH + 1 - len(packet)))
+    device.write(packet)
+
+    expected = None
+    wrapped = False
+    events = []
+    deadline = time.time() + 2.0
+    while time.time() < deadline:
+        data = device.read(REPORT_LENGTH, timeout_ms=200)
+        if not data or data[0] != TRACE_REPORT:
+            continue  # unrelated status report (NACK, stats, button)
+        if data[1] == TRACE_HEADER:
+            expected = data[2] | (data[3] << 8)
+            wrapped = bool(data[4])
+            continue
+        count = data[2]
+        for i in range(count):
+            off = 4 + i * EVENT_SIZE
+            events.append(struct.unpack_from('<IHHI', bytes(data), off))
+        if expected is not None and len(events) >= expected:
+            break
+    return events, wrapped
+
+
+def main():
+    core_mhz = float(sys.argv[1]) if len(sys.argv) > 1 else 108.0
+
+    path = find_custom_hid_device()
+    if path is None:
+        print("ERROR: device not found (is it plugged in and configured?)")
+        sys.exit(1)
+
+    device = hid.device()
+    device.open_path(path)
+    try:
+        events, wrapped = collect_trace(device)
+    finally:
+        device.close()
+
+    if not events:
+        print("No trace events received.")
+        return
+    if wrapped:
+        print("NOTE: trace ring wrapped; older events were overwritten.")
+
+    # Timestamps are the low 32 bits of mcycle; unwrap deltas so a dump
+    # spanning a counter rollover still reads monotonically.
+    print(f"{len(events)} events (core clock {core_mhz} MHz):")
+    print(f"{'t_us':>12} {'dt_us':>10}  {'event':<16} {'arg16':>6} {'arg32':>10}")
+    t_acc = 0
+    prev = events[0][0]
+    for cycles, ev_id, arg16, arg32 in events:
+        dt = (cycles - prev) & 0xFFFFFFFF
+        t_acc += dt
+        prev = cycles
+        name = EVENT_NAMES.get(ev_id, f"0x{ev_id:04X}")
+        print(f"{t_acc / core_mhz:12.1f} {dt / core_mhz:10.1f}  "
+              f"{name:<16} {arg16:>6} 0x{arg32:08X}")
+
+
+if __name__ == "__main__":
+    main()
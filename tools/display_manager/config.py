@@ -6,17 +6,162 @@ This version introduces multiple color themes and randomly selects one at startu
 import random # Import the random module
 import os
 
+# Command ids, report ids, flag bits and shared wire sizes (REPORT_LENGTH,
+# LCD geometry, encodings, caps masks, asset-store agreement) are generated
+# into display_protocol.py from prj_usb_composite/protocol.py - one
+# description for firmware and host. Re-exported here so the rest of the
+# tools keep reading them off this module. This file keeps only host-side
+# policy: device selection, timeouts, pacing, feature toggles.
+from display_protocol import *  # noqa: F401,F403
+
 # -- Device Configuration --
 VID = 0x28E9
 PID = 0xABCD
-REPORT_LENGTH = 64
-REPORT_ID = 0x00
-CMD_IMAGE_DATA = 0x02
-CMD_DRAW_RECT = 0x06
+
+# The display rides on a vendor-specific bulk interface (WinUSB on
+# Windows, libusb elsewhere) rather than HID reports, so the host can
+# queue large transfers instead of writing one report at a time.
+DISPLAY_INTERFACE = 1
+BULK_OUT_EP = 0x02
+BULK_IN_EP = 0x82
+
+# EP0 vendor-request query codes (firmware table in vendor_ctl.h; not
+# part of the report protocol, so kept here rather than generated).
+# Device-to-host control transfers, bmRequestType 0xC0.
+VREQ_STATUS = 0xA1   # 16 B: REPORT_STATUS record sans report id
+VREQ_BUILD = 0xA2    # 4 B: build fingerprint
+VREQ_UPTIME = 0xA3   # 8 B: 64-bit mtime
+VREQ_CFG_GET = 0xA4  # 4 B, wValue = key: cfgstore value (FFFFFFFF unset)
+BULK_WRITE_TIMEOUT_MS = 2000
+# The transmit stage drains every burst the encode stage has already
+# queued and submits them as one bulk transfer, up to this many bytes:
+# the controller then streams wire packets back-to-back instead of the
+# bus idling between per-burst Python write calls. Caps the transfer so
+# a slow device NAKing a huge chained write cannot hold the endpoint
+# past the write timeout.
+TX_COALESCE_LIMIT_BYTES = 16384
+ASSET_POLL_INTERVAL_SECONDS = 0.002
+ASSET_POLL_TIMEOUT_SECONDS = 5.0
+# Idle protocol: after IDLE_AFTER_SECONDS without a changed widget the
+# host parks the device pipeline (CMD_IDLE_HINT) and keeps the link warm
+# with periodic heartbeats (see main()). The first real update unparks
+# the device by itself, so wake latency is bounded by that update's own
+# transfer.
+IDLE_AFTER_SECONDS = 10.0
+IDLE_HEARTBEAT_SECONDS = 5.0
+# Stage order mirrors the BootStage enum in prj_usb_composite/src/main.cpp.
+BOOT_STAGE_NAMES = ["main entry", "usb started", "lcd ready",
+                    "assets ready", "sd probed", "usb configured"]
+
+# How long a zero-credit wait may block the encode stage before the send
+# proceeds anyway (lost IN report, old firmware); NACK recovery then
+# covers any drop, exactly as without flow control.
+CREDIT_WAIT_TIMEOUT_SECONDS = 0.25
+
+# -- Adaptive quality governor --
+# Under bus congestion (other devices on the hub, a slow host) pushing
+# at full quality makes everything lag together; the governor trades
+# pixels for stable latency instead (see FrameGovernor). Escalation
+# triggers when the encode stage spent more than this long per tick
+# stalled on zero credits, or when the device reports dropped slots;
+# stepping back down takes this many consecutive clean ticks.
+GOVERNOR_ENABLED = True
+GOVERNOR_STALL_ESCALATE_SECONDS = 0.2
+GOVERNOR_CLEAN_TICKS_TO_RELAX = 8
+# Slowest render tick the governor may fall back to (the normal tick is
+# one second, set by the dashboard's clock widget).
+GOVERNOR_MAX_TICK_SECONDS = 2.0
+
+# End-to-end payload integrity: append a CRC32 trailer to each streamed
+# rect header (firmware must advertise caps flag bit4). The device
+# verifies it on its hardware CRC unit during reception and NACKs a
+# mismatch like a lost sequence, catching corruption that slips past the
+# per-packet USB CRC16 (host-side buffer races, firmware copy bugs).
+# Off by default: the transports already checksum per packet, so this is
+# a debugging/soak-test aid, not a production need.
+INTEGRITY_CRC = False
+# Pixel-doubled UI mode for chunky 80x40 deployments: frames handed to
+# the send paths are half-size in both axes and the firmware expands
+# each pixel to a 2x2 block on reception (caps flag bit 5, DRAW_RECT
+# header flag bit 1). Same screen, one quarter of the bulk payload.
+# The renderer must produce LCD_WIDTH/2 x LCD_HEIGHT/2 frames when this
+# is on; fill and text coordinates are translated automatically.
+PIXEL_DOUBLE = False
+
+# Traffic corpus capture for the native decode benchmarks: set to a file
+# path and every wire burst this session transmits is also appended there
+# ([u32 LE length][burst] records). The hostbench harness replays the
+# file through the firmware's actual decode paths per encoding
+# (HOSTBENCH_CORPUS=<file> build/hostbench/bench corpus), so
+# RLE-vs-palette-vs-delta decisions rest on measured cost over real
+# traffic. Capture with one panel; leave None for normal operation.
+CAPTURE_CORPUS_PATH = None
+
+# -- Virtual display sink (virtual_device.py) --
+# When set, DeviceManager.connect() binds a software device instead of
+# scanning USB: full protocol, a window showing the decoded frame, and
+# modeled link/blit bandwidth, so pipeline work runs without a board.
+# `display_manager.py virtual` sets it for a session; the environment
+# variable reaches the other tools (latency_probe, soak_bench, analyze)
+# without touching their command lines.
+VIRTUAL_DEVICE = os.environ.get("DISPLAY_VIRTUAL", "") not in ("", "0")
+# Modeled bulk OUT bandwidth; the FS bulk ceiling of 19 64-byte packets
+# per 1 ms frame by default. Lower it to rehearse congestion (credit
+# stalls, governor escalation) at will.
+VIRTUAL_LINK_BYTES_PER_SECOND = 19 * 64 * 1000
+# Modeled panel SPI rate the blit engine drains slots at (24 Mbit/s,
+# matching the hardware's SPI0 clock for the LCD).
+VIRTUAL_BLIT_BYTES_PER_SECOND = 3_000_000
+# Slot geometry announced in the CAPS reply; mirrors the firmware's
+# display::constants defaults (DISPLAY_NUM_BUFFERS / DISPLAY_BUFFER_SIZE).
+VIRTUAL_NUM_BUFFERS = 4
+VIRTUAL_BUFFER_SIZE = 4096
+# Show the decoded frame in a window; headless sessions fall back to a
+# PNG snapshot at VIRTUAL_SNAPSHOT_PATH automatically.
+VIRTUAL_WINDOW = True
+VIRTUAL_SNAPSHOT_PATH = "virtual_panel.png"
+
+# mcycle runs at the core clock; used to convert echoed cycle counts.
+# The USB projects run the 96 MHz profile (SYSTEM_CLOCK_PROFILE=96 in
+# prj_usb_composite/config.py) -- USB caps CK_SYS at 96 MHz.
+DEVICE_CYCLES_PER_SECOND = 96_000_000
+
+# How often to poll the device's pipeline instrumentation counters.
+# Set to 0 to disable polling.
+STATS_REQUEST_INTERVAL_SECONDS = 30
+
+# How many recently sent updates are remembered for NACK retransmission.
+SENT_HISTORY_DEPTH = 256
+
+# Defaults only: the CMD_GET_CAPS handshake at connect time replaces these
+# with the geometry the firmware actually reports (see DeviceManager).
 DEVICE_BUFFER_SIZE = 4096
 MAX_PIXELS_PER_CHUNK = DEVICE_BUFFER_SIZE // 2
-LCD_WIDTH = 160
-LCD_HEIGHT = 80
+
+# -- Dirty-tile diffing --
+# The frame is split into a grid of tiles; only tiles whose content hash
+# changed since the last transmitted frame are sent to the device.
+TILE_WIDTH = 32
+TILE_HEIGHT = 16
+
+# -- Rect batching --
+# Two dirty rects are merged into their bounding box when the union's
+# payload is at most this many bytes larger than sending them separately;
+# the slack stands for the fixed per-rect cost (one 64-byte command packet
+# plus the padding wasted in the payload's last packet).
+RECT_MERGE_SLACK_BYTES = 96
+
+# -- Region-of-interest prioritization --
+# Dirty rects are classed by the highest-priority widget region they
+# touch (ui_generator declares them) and queued interactive-first, so
+# when bandwidth is tight the clock digits reach the panel before a
+# decorative repaint. While the governor reports congestion, decorative
+# rects may be held over to a later tick, but never for more than
+# PRIORITY_MAX_DEFER_TICKS in a row.
+PRIORITY_INTERACTIVE = 0
+PRIORITY_NORMAL = 1
+PRIORITY_DECORATIVE = 2
+PRIORITY_MAX_DEFER_TICKS = 3
 
 # -- Location & Weather --
 LOCATION_LAT = 49.4247  # Hasenbuk, Nürnberg
@@ -93,11 +238,15 @@ COLOR_TEXT_PRIMARY = selected_theme["text_primary"]
 COLOR_TEXT_SECONDARY = selected_theme["text_secondary"]
 COLOR_SEPARATOR = (255, 255, 255, 35) # This remains consistent for a subtle look
 
-def cycle_theme():
-    """Cycles to the next theme in the list and updates the global color variables."""
+def cycle_theme(step=1):
+    """
+    Moves `step` entries through the theme list (signed; the rotary
+    encoder scrubs backwards with negative steps) and updates the global
+    color variables.
+    """
     global _current_theme_index, COLOR_GRADIENT_START, COLOR_GRADIENT_END, COLOR_TEXT_PRIMARY, COLOR_TEXT_SECONDARY
-    
-    _current_theme_index = (_current_theme_index + 1) % len(COLOR_THEMES)
+
+    _current_theme_index = (_current_theme_index + step) % len(COLOR_THEMES)
     new_theme = COLOR_THEMES[_current_theme_index]
     
     COLOR_GRADIENT_START = new_theme["gradient_start"]
@@ -0,0 +1,82 @@
+# console.py
+"""
+Interactive terminal for the firmware's runtime tuning console.
+
+The firmware carries a small command shell (lib/shell, wired up in
+prj_usb_composite/src/console.cpp) on the display bulk interface:
+CMD_CONSOLE packets deliver keystrokes, REPORT_CONSOLE packets return
+output. This script is the matching terminal: it reads lines from
+stdin, ships them to the device, and prints whatever comes back. `help`
+on the prompt lists what the connected build has.
+
+Runs against stock firmware; no bench build required. Usage:
+
+    python console.py
+"""
+import sys
+import time
+
+import config
+from display_manager import DeviceManager
+
+# CMD_CONSOLE payload per packet: [CMD, count, text bytes].
+_BYTES_PER_PACKET = config.REPORT_LENGTH - 2
+
+# How long to keep polling for output after a command before returning
+# to the prompt. Most replies arrive within a couple of SOF-paced report
+# passes; `bench` is the slow one.
+_QUIET_SECONDS = 0.25
+
+
+def _send_line(manager: DeviceManager, line: str):
+    """Ships one command line, newline-terminated, in CMD_CONSOLE packets."""
+    data = (line + "\n").encode("ascii", errors="replace")
+    for off in range(0, len(data), _BYTES_PER_PACKET):
+        chunk = data[off:off + _BYTES_PER_PACKET]
+        packet = bytearray([config.CMD_CONSOLE, len(chunk)])
+        packet.extend(chunk)
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+
+
+def _drain_output(manager: DeviceManager):
+    """Prints console output until the device goes quiet."""
+    deadline = time.perf_counter() + _QUIET_SECONDS
+    while time.perf_counter() < deadline:
+        report = manager._read(config.REPORT_LENGTH, timeout_ms=50)
+        if len(report) < 2 or report[0] != config.REPORT_CONSOLE:
+            continue  # unrelated status traffic (credits, status push, ...)
+        count = min(report[1], len(report) - 2)
+        sys.stdout.write(bytes(report[2:2 + count]).decode("ascii",
+                                                           errors="replace"))
+        sys.stdout.flush()
+        deadline = time.perf_counter() + _QUIET_SECONDS
+
+
+def console_main():
+    """Connects and runs the read-eval-print loop until EOF or quit."""
+    manager = DeviceManager()
+    if not manager.connect():
+        sys.exit(1)
+
+    print("--- Device console (`help` lists commands, `quit` exits) ---")
+    try:
+        while True:
+            try:
+                line = input("> ").strip()
+            except EOFError:
+                break
+            if line in ("quit", "exit"):
+                break
+            if not line:
+                continue
+            _send_line(manager, line)
+            _drain_output(manager)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        manager.close()
+
+
+if __name__ == "__main__":
+    console_main()
@@ -3,7 +3,8 @@
 Main application for the Longan Nano Dynamic Display.
 
 This script acts as the central controller. It performs the following tasks:
-1.  Connects to the Longan Nano device over a custom HID interface.
+1.  Connects to the Longan Nano device over its vendor bulk interface
+    (WinUSB/libusb via pyusb).
 2.  Periodically fetches live weather data.
 3.  Generates a user interface image displaying time, date, and weather.
 4.  Compares the new image with the previous one to find changed areas.
@@ -12,12 +13,19 @@ This script acts as the central controller. It performs the following tasks:
 6.  Handles device connection and disconnection gracefully.
 7.  Uses a separate thread to listen for device events (like button presses)
     for immediate responsiveness.
+8.  Runs rendering, payload encoding and USB writes as pipeline stages on
+    separate threads, so the next frame renders while the previous one is
+    still going out over the wire.
 """
 import time
 import os
+import queue
 from datetime import datetime
-from PIL import Image, ImageChops
-import hid
+from PIL import Image
+import numpy as np
+from collections import OrderedDict
+import usb.core
+import usb.util
 import sys
 import threading
 
@@ -28,41 +36,454 @@ if _SCRIPT_DIR not in sys.path:
     sys.path.insert(0, _SCRIPT_DIR)
 
 import config
+import framecodec
 import weather
 import ui_generator
 
-# A mutable list is used as a simple, thread-safe way for the listener
-# thread to signal the main thread. The main thread checks this flag,
-# and the listener thread sets it.
-theme_change_requested = [False]
+# (bus, address) of devices some DeviceManager in this process has
+# claimed, so multi-panel sessions never bind two managers to one
+# device. Keyed by bus topology rather than serial string: units
+# flashed from the same image all report the descriptor's default
+# serial until provisioned. Guarded by _claimed_lock.
+_claimed_devices = set()
+_claimed_lock = threading.Lock()
+
+def rgb565_frame(image: Image.Image) -> np.ndarray:
+    """
+    Converts a PIL image to a (height, width) uint16 RGB565 array.
+
+    One pass over the whole frame; everything downstream (the tile
+    diff, the solid-color check, the payload encoders) works on this
+    array, so the per-pixel Python loops this pipeline used to run per
+    rect are gone entirely. The pass runs in the native codec when it
+    compiled (framecodec.c), which on a Pi Zero is the difference
+    between the conversion fitting the frame budget or not; the NumPy
+    expression below is the reference fallback.
+    """
+    if framecodec.available():
+        rgb = image.convert("RGB")
+        return framecodec.convert(rgb.tobytes(), rgb.height, rgb.width)
+    rgb = np.asarray(image.convert("RGB"), dtype=np.uint16)
+    return ((rgb[..., 0] & 0xF8) << 8) | ((rgb[..., 1] & 0xFC) << 3) | (rgb[..., 2] >> 3)
+
+
+class TileDiffer:
+    """
+    Tracks the last transmitted frame and reports which areas changed.
+
+    The comparison is one vectorized not-equal over the RGB565 frame,
+    reduced per TILE_WIDTH x TILE_HEIGHT cell; a full-frame diff costs a
+    fraction of a millisecond even on a Raspberry Pi, where the previous
+    per-tile crop-and-hash loop was the frame-rate ceiling.
+    """
+    def __init__(self):
+        self._previous = None  # (height, width) uint16 RGB565 of the last frame
+        # Multiplier on the configured tile size; the governor raises it
+        # under congestion so nearby changes coalesce into fewer, larger
+        # rects (fewer command packets and draw slots per tick).
+        self.tile_scale = 1
+
+    def reset(self):
+        """Forgets the stored frame, forcing the next diff to report everything."""
+        self._previous = None
+
+    def dirty_rects(self, frame: np.ndarray) -> list[tuple[int, int, int, int]]:
+        """
+        Returns the bounding boxes of tiles that changed since the last call.
+
+        Horizontally adjacent dirty tiles in the same tile row are merged
+        into one rect so wide updates still go out as a single DRAW_RECT
+        command, and each merged rect is then shrunk to the bounding box
+        of its actually-changed pixels (np.argwhere), so a tile with a
+        one-character change no longer costs a full tile of payload.
+        The stored frame is updated as a side effect, so the caller must
+        actually transmit every returned rect.
+
+        Args:
+            frame (np.ndarray): The new (height, width) uint16 RGB565 frame.
+
+        Returns:
+            list: Bounding boxes (x1, y1, x2, y2) of the changed areas.
+        """
+        height, width = frame.shape
+        tile_h = config.TILE_HEIGHT * self.tile_scale
+        tile_w = config.TILE_WIDTH * self.tile_scale
+        if framecodec.available():
+            # One C pass over the frame: tile flags, run merging and
+            # the tight bounding boxes, same rects as the code below.
+            rects = framecodec.diff_rects(frame, self._previous,
+                                          tile_w, tile_h)
+            self._previous = frame.copy()
+            return rects
+        rows = -(-height // tile_h)
+        cols = -(-width // tile_w)
+        if self._previous is None:
+            diff = np.ones((height, width), dtype=bool)
+        else:
+            diff = self._previous != frame
+        self._previous = frame.copy()
+
+        # Reduce the pixel diff to a dirty-tile grid (pad so partial edge
+        # tiles reshape cleanly; padding is clean, so it never reports).
+        padded = np.zeros((rows * tile_h, cols * tile_w), dtype=bool)
+        padded[:height, :width] = diff
+        tile_dirty = padded.reshape(rows, tile_h, cols, tile_w).any(axis=(1, 3))
+
+        rects = []
+        for row in range(rows):
+            dirty_cols = np.flatnonzero(tile_dirty[row])
+            if dirty_cols.size == 0:
+                continue
+            breaks = np.diff(dirty_cols) > 1
+            run_starts = dirty_cols[np.concatenate(([True], breaks))]
+            run_ends = dirty_cols[np.concatenate((breaks, [True]))]
+            ty1 = row * tile_h
+            ty2 = min(ty1 + tile_h, height)
+            for c1, c2 in zip(run_starts, run_ends):
+                tx1 = int(c1) * tile_w
+                tx2 = min((int(c2) + 1) * tile_w, width)
+                changed = np.argwhere(diff[ty1:ty2, tx1:tx2])
+                (r1, p1), (r2, p2) = changed.min(axis=0), changed.max(axis=0)
+                rects.append((tx1 + int(p1), ty1 + int(r1),
+                              tx1 + int(p2) + 1, ty1 + int(r2) + 1))
+        return rects
+
+
+def merge_rects(rects: list[tuple[int, int, int, int]]) -> list[tuple[int, int, int, int]]:
+    """
+    Greedily merges dirty rects whose union is cheaper to transmit.
+
+    Two rects are combined into their bounding box whenever the union's
+    pixel payload costs at most RECT_MERGE_SLACK_BYTES more than sending
+    them separately -- the slack models the fixed per-rect overhead (one
+    command packet plus payload padding), so clustered small widgets
+    collapse into one transfer while distant rects stay apart. Dozens of
+    rects at most, so the O(n^2) passes are negligible.
+    """
+    merged = list(rects)
+    changed = True
+    while changed:
+        changed = False
+        for i in range(len(merged)):
+            for j in range(i + 1, len(merged)):
+                a, b = merged[i], merged[j]
+                union = (min(a[0], b[0]), min(a[1], b[1]),
+                         max(a[2], b[2]), max(a[3], b[3]))
+                union_bytes = (union[2] - union[0]) * (union[3] - union[1]) * 2
+                a_bytes = (a[2] - a[0]) * (a[3] - a[1]) * 2
+                b_bytes = (b[2] - b[0]) * (b[3] - b[1]) * 2
+                if union_bytes <= a_bytes + b_bytes + config.RECT_MERGE_SLACK_BYTES:
+                    merged[i] = union
+                    merged.pop(j)
+                    changed = True
+                    break
+            if changed:
+                break
+    return merged
+
+
+class RectScheduler:
+    """
+    Region-of-interest ordering for the transmit path.
+
+    Dirty rects used to queue strictly FIFO, so under congestion the
+    clock digits could sit behind a background repaint. The scheduler
+    classes each rect by the highest-priority widget region it touches
+    (ui_generator.priority_regions; pixels outside every widget are
+    decorative) and returns one batch per class, interactive first.
+    Each batch becomes its own encode job -- and, past one draw slot,
+    its own display list -- so an atomic commit never holds interactive
+    pixels hostage to a decorative chain queued behind them.
+
+    While the caller reports congestion, decorative batches are held
+    over to a later tick instead of competing for credits, but never
+    for more than PRIORITY_MAX_DEFER_TICKS in a row: the hold ages, and
+    at the bound everything flushes. A held rect is re-encoded from the
+    frame current at flush time, so the deferral can go stale but never
+    wrong (the tile differ marked it clean when it first reported it).
+    """
 
-class DeviceManager:
-    """Manages low-level HID communication with the Longan Nano device."""
     def __init__(self):
-        """Initializes the device manager."""
+        self._regions = ui_generator.priority_regions()
+        self._held = []
+        self._held_ticks = 0
+
+    def _priority(self, bbox: tuple[int, int, int, int]) -> int:
+        priority = config.PRIORITY_DECORATIVE
+        for region, region_priority in self._regions:
+            if (region_priority < priority and
+                    bbox[0] < region[2] and region[0] < bbox[2] and
+                    bbox[1] < region[3] and region[1] < bbox[3]):
+                priority = region_priority
+        return priority
+
+    def schedule(self, rects: list, congested: bool) -> list[list]:
+        """Returns priority-ordered batches of merged rects to queue now."""
+        merged = merge_rects(list(rects) + self._held)
+        self._held = []
+        batches = {}
+        for bbox in merged:
+            batches.setdefault(self._priority(bbox), []).append(bbox)
+
+        if congested and self._held_ticks < config.PRIORITY_MAX_DEFER_TICKS:
+            decorative = batches.get(config.PRIORITY_DECORATIVE)
+            # Hold decorative work only when something sharper is
+            # actually competing with it for the link.
+            if decorative and len(batches) > 1:
+                self._held = batches.pop(config.PRIORITY_DECORATIVE)
+                self._held_ticks += 1
+        if not self._held:
+            self._held_ticks = 0
+        return [batches[p] for p in sorted(batches)]
+
+
+class FrameGovernor:
+    """
+    Congestion-aware quality governor for the render loop.
+
+    When the bus or the device falls behind, pushing full-quality frames
+    just queues latency everywhere -- the knob echo that should feel
+    instant arrives half a second late while the dashboard still repaints.
+    The governor watches two congestion signals per render tick and
+    trades picture quality for stable latency, one level at a time:
+
+        level 0  full quality
+        level 1  prefer palettized payloads (one byte per pixel ceiling)
+        level 2  double the diff tile size (fewer, larger rects per tick)
+        level 3  halve the tick rate
+
+    Signals: seconds the encode stage spent stalled on zero credits
+    (DeviceManager.take_credit_stall) and the slots_dropped counter from
+    the unsolicited status push. A tick that trips either escalates
+    immediately; stepping back down waits for a run of clean ticks, so
+    the quality level does not oscillate across bursty load.
+    """
+    MAX_LEVEL = 3
+
+    def __init__(self, manager: "DeviceManager", tile_differ: TileDiffer):
+        self._manager = manager
+        self._differ = tile_differ
+        self.level = 0
+        self._clean_ticks = 0
+        self._last_drops = None
+
+    def reset(self):
+        """Back to full quality; called on (re)connect."""
+        self.level = 0
+        self._clean_ticks = 0
+        self._last_drops = None
+        self._apply()
+
+    def _dropped_since_last(self) -> int:
+        status = self._manager.last_status
+        if status is None:
+            return 0
+        drops = status['slots_dropped']
+        delta = 0
+        if self._last_drops is not None:
+            delta = (drops - self._last_drops) & 0xFFFF
+        self._last_drops = drops
+        return delta
+
+    def tick(self):
+        """Folds one render tick's congestion signals into the level."""
+        if not config.GOVERNOR_ENABLED:
+            return
+        stall = self._manager.take_credit_stall()
+        drops = self._dropped_since_last()
+        congested = (stall > config.GOVERNOR_STALL_ESCALATE_SECONDS
+                     or drops > 0)
+        if congested:
+            self._clean_ticks = 0
+            if self.level < self.MAX_LEVEL:
+                self.level += 1
+                print(f"--- Governor: congestion (stall {stall * 1000:.0f}ms, "
+                      f"{drops} drops), quality level {self.level} ---")
+                self._apply()
+        elif self.level > 0:
+            self._clean_ticks += 1
+            if self._clean_ticks >= config.GOVERNOR_CLEAN_TICKS_TO_RELAX:
+                self._clean_ticks = 0
+                self.level -= 1
+                print(f"--- Governor: link recovered, quality level "
+                      f"{self.level} ---")
+                self._apply()
+
+    def tick_seconds(self) -> float:
+        """The render tick the current level allows."""
+        return config.GOVERNOR_MAX_TICK_SECONDS if self.level >= 3 else 1.0
+
+    def _apply(self):
+        self._manager.prefer_indexed = self.level >= 1
+        self._differ.tile_scale = 2 if self.level >= 2 else 1
+
+
+class DeviceManager:
+    """Manages low-level bulk USB communication with the Longan Nano device."""
+    def __init__(self, serial: str = None):
+        """
+        Initializes the device manager.
+
+        Args:
+            serial (str): USB serial string of the panel this manager
+                binds (multi-panel deployments); None takes the first
+                unclaimed device, which keeps single-panel use and the
+                benchmark/probe tools exactly as before.
+        """
         self.device = None
+        self.serial = serial
+        self.bound_serial = None  # serial of the connected unit (may be shared)
+        self.bound_slot = None    # (bus, address) claim released by close()
+        # Per-device mailboxes written by this manager's listener and
+        # worker threads and drained by the render loop: a theme-button
+        # press, lost sequence ranges to retransmit, the first error a
+        # pipeline thread hit, and the encode stage's request for a full
+        # redraw when a NACK range has left the send history. Per device
+        # so one panel's NACK storm or disconnect never touches another.
+        self.theme_change_requested = False
+        # Net rotary detents accumulated from REPORT_ENCODER records
+        # (listener thread adds, service_events drains); one record
+        # carries a whole burst, so fast scrubbing lands in one jump.
+        self.encoder_delta = 0
+        self.nack_requests = []
+        self.pipeline_error = None
+        self.full_redraw_requested = False
         self.sequence_number = 0
+        # Recently sent updates, keyed by sequence number, so a device NACK
+        # can be answered by retransmitting only what was actually lost.
+        self.sent_history = OrderedDict()
+        # Colors already uploaded to the device palette (color bytes -> index).
+        self.palette_map = {}
+        # When attached (see main()), finished wire bursts are handed to the
+        # transmit stage instead of being written synchronously.
+        self.tx_queue = None
+        # Corpus capture (config.CAPTURE_CORPUS_PATH): every wire burst is
+        # also appended to a file the native hostbench harness replays
+        # through the firmware decode paths. Opened on first use.
+        self._capture_file = None
+        # Traffic tap (traffic_analyzer.attach): when set, every emitted
+        # burst and every latency echo is fed to it for the per-category
+        # bandwidth/latency breakdown of the analyze mode.
+        self.traffic_log = None
+        # Device limits; these defaults match config.py and are replaced by
+        # the GET_CAPS handshake in connect() when the firmware answers it.
+        self.max_pixels_per_chunk = config.MAX_PIXELS_PER_CHUNK
+        self.single_header_streams = False
+        self.delta_streams = False
+        self.display_lists = False
+        self.integrity_crc = False
+        self.pixel_double = False
+        self.overlay_plane = False
+        # Mirror of the device's resident framebuffer, kept in step with
+        # every update this manager transmits; delta encoding skips the
+        # pixels that are already right on the device. The validity mask
+        # marks regions whose device content we cannot know (on-device
+        # text rendering, lost updates) so deltas never trust them.
+        self.resident = None
+        self.resident_valid = None
+        # Credit-based flow control (REPORT_CREDITS): the firmware
+        # publishes its free draw-slot count and the encode stage waits
+        # at zero instead of pushing rects into drops and NACK recovery.
+        # Stays None until the first report, so older firmware that
+        # never sends one is unaffected.
+        self.credits = None
+        self.credits_cond = threading.Condition()
+        # Congestion signals for the frame-rate governor: seconds the
+        # encode stage spent blocked on zero credits (drained per tick by
+        # take_credit_stall), and an encoding bias it sets under load.
+        self.credit_stall_s = 0.0
+        self.prefer_indexed = False
+        # Latest unsolicited REPORT_STATUS push and the last health
+        # anomaly mask seen, so transitions print exactly once.
+        self.last_status = None
+        self.last_health_tripped = 0
+        # (fingerprint, text) from the firmware's REPORT_BUILD, once
+        # requested; the fingerprint keys measurement records to the
+        # exact build configuration that produced them.
+        self.build_info = None
+        # Geometry of assets known to live in the device's flash store,
+        # keyed by asset id (filled by upload_assets); draw_asset uses it
+        # to invalidate the right region of the resident mirror.
+        self.asset_shapes = {}
+        # Golden-image verification (set_verify_mode): expected decoded-
+        # region CRCs keyed by sequence number, recorded as rects go out
+        # and consumed when the device's REPORT_RECT_CRC echo arrives,
+        # plus the running pass/fail tally a benchmark run reports.
+        self.verify_mode = False
+        self.verify_expected = OrderedDict()
+        self.verify_checked = 0
+        self.verify_mismatches = 0
 
     def connect(self) -> bool:
         """
-        Scans for and connects to the custom HID device.
+        Scans for and connects to the device's vendor bulk interface.
 
-        It identifies the correct interface by its Vendor ID, Product ID, and
-        a specific usage page (0xFF00) defined in the firmware.
+        The firmware exposes the display stream on a vendor-specific bulk
+        interface; on Windows its MS OS 2.0 descriptors bind WinUSB
+        automatically, and on Linux libusb claims it directly.
 
         Returns:
             bool: True if connection was successful, False otherwise.
         """
         if self.device: return True
+        if config.VIRTUAL_DEVICE:
+            # Software sink (virtual_device.py): same transport shape,
+            # no USB. One virtual panel per process, claimed through the
+            # same bookkeeping so the discovery loop stops after it.
+            import virtual_device  # Deferred: tkinter may be absent.
+            slot = ("virtual", 0)
+            with _claimed_lock:
+                if slot in _claimed_devices:
+                    return False
+                _claimed_devices.add(slot)
+            self.device = virtual_device.open_device()
+            self.bound_serial = "virtual"
+            self.bound_slot = slot
+            self.sequence_number = 0
+            self.sent_history.clear()
+            self.palette_map.clear()
+            self._negotiate_caps()
+            print("--- Device Connected (virtual) ---")
+            return True
         try:
-            for device_info in hid.enumerate(config.VID, config.PID):
-                if device_info['usage_page'] == 0xFF00:
-                    self.device = hid.device()
-                    self.device.open_path(device_info['path'])
-                    self.device.set_nonblocking(1)
-                    self.sequence_number = 0
-                    print("--- Device Connected ---")
-                    return True
+            # Several panels may share VID/PID; the serial string (set
+            # per unit in usbd_descriptors.cpp) tells them apart. Skip
+            # devices another manager in this process already claimed.
+            for dev in usb.core.find(find_all=True,
+                                     idVendor=config.VID,
+                                     idProduct=config.PID):
+                try:
+                    serial = usb.util.get_string(dev, dev.iSerialNumber)
+                except (usb.core.USBError, ValueError):
+                    serial = None
+                if self.serial is not None and serial != self.serial:
+                    continue
+                slot = (dev.bus, dev.address)
+                with _claimed_lock:
+                    if slot in _claimed_devices:
+                        continue
+                    _claimed_devices.add(slot)
+                try:
+                    try:
+                        if dev.is_kernel_driver_active(config.DISPLAY_INTERFACE):
+                            dev.detach_kernel_driver(config.DISPLAY_INTERFACE)
+                    except (NotImplementedError, usb.core.USBError):
+                        pass  # No kernel driver handling on this platform.
+                    usb.util.claim_interface(dev, config.DISPLAY_INTERFACE)
+                except Exception:
+                    with _claimed_lock:
+                        _claimed_devices.discard(slot)
+                    raise
+                self.device = dev
+                self.bound_serial = serial
+                self.bound_slot = slot
+                self.sequence_number = 0
+                self.sent_history.clear()
+                self.palette_map.clear()
+                self._negotiate_caps()
+                print(f"--- Device Connected "
+                      f"({serial or 'no serial'}) ---")
+                return True
             print("Device not found. Retrying...", end='\r')
             return False
         except Exception as e:
@@ -70,53 +491,572 @@ class DeviceManager:
             self.device = None
             return False
 
-    def send_data_payload(self, data: bytearray):
+    def _negotiate_caps(self):
+        """
+        Queries the device's buffer geometry (CMD_GET_CAPS).
+
+        Runs synchronously during connect(), before the listener thread
+        exists, so the reply can be read inline. Older firmware ignores
+        the command; the read then times out and the config.py defaults
+        stay in effect. With a reply, transfer sizing comes from what
+        the device actually has -- rects are chunked to its real buffer
+        size -- and, when the firmware advertises it, payloads go out as
+        single-header streams with no per-packet command byte.
+        """
+        packet = bytearray([config.CMD_GET_CAPS])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self.max_pixels_per_chunk = config.MAX_PIXELS_PER_CHUNK
+        self.single_header_streams = False
+        self.delta_streams = False
+        self.display_lists = False
+        self.integrity_crc = False
+        self.pixel_double = False
+        self.overlay_plane = False
+        self.resident = None
+        self.resident_valid = None
+        self.credits = None
+        self.last_status = None
+        try:
+            self._write(packet)
+            for _ in range(8):
+                report = self._read(64, timeout_ms=250)
+                if not report:
+                    break
+                if report[0] != config.REPORT_CAPS:
+                    continue  # Stale status report; keep looking.
+                buffer_size = report[5] | (report[6] << 8)
+                full_frame_bytes = int.from_bytes(bytes(report[7:11]), 'little')
+                flags = report[11]
+                # Explicit native pixel format (older firmware stops at
+                # the flags byte and is RGB565 by construction). Every
+                # encoder downstream of rgb565_frame() emits RGB565, so
+                # an unrecognized id means wrong colors on every pixel;
+                # fail the connect instead of streaming garbage.
+                pixel_format = (report[12] if len(report) > 12
+                                else config.PIXEL_FORMAT_RGB565)
+                if pixel_format != config.PIXEL_FORMAT_RGB565:
+                    # Not OSError: that would be swallowed below as a
+                    # transport hiccup; connect() surfaces this one.
+                    raise RuntimeError(f"Device wants pixel format "
+                                       f"{pixel_format}; this host only "
+                                       f"encodes RGB565.")
+                # Whole-frame-resident builds take rects up to the full
+                # frame; slot builds are limited by one framebuffer slot.
+                limit = (full_frame_bytes if (flags & config.CAPS_FULL_FRAME)
+                         else buffer_size)
+                self.max_pixels_per_chunk = limit // 2
+                self.single_header_streams = bool(flags & config.CAPS_SINGLE_HEADER)
+                # Delta streams patch the device's resident frame, so they
+                # need the whole-frame build and single-header transport;
+                # start with an all-invalid mirror (nothing known yet).
+                self.delta_streams = (self.single_header_streams
+                                      and bool(flags & config.CAPS_DELTA))
+                self.display_lists = bool(flags & config.CAPS_DISPLAY_LISTS)
+                # CRC trailers cost host CPU per rect, so they stay behind
+                # the config knob even when the firmware supports them.
+                self.integrity_crc = (config.INTEGRITY_CRC
+                                      and bool(flags & config.CAPS_INTEGRITY_CRC))
+                # Pixel-doubled mode: everything host-side (frames, rect
+                # coordinates, the resident mirror) runs at quarter
+                # resolution; the device expands 2x2 on reception. The
+                # per-chunk limit shrinks fourfold because staging on the
+                # device is paid at panel scale.
+                self.pixel_double = (config.PIXEL_DOUBLE
+                                     and bool(flags & config.CAPS_PIXEL_DOUBLE))
+                # Device-composited cursor plane: a caller that keeps a
+                # moving highlight on screen should prefer move_overlay()
+                # over redrawing the region when this is set.
+                self.overlay_plane = bool(flags & config.CAPS_OVERLAY)
+                if self.pixel_double:
+                    self.max_pixels_per_chunk //= 4
+                if self.delta_streams:
+                    mirror_h = report[3] // 2 if self.pixel_double else report[3]
+                    mirror_w = report[2] // 2 if self.pixel_double else report[2]
+                    self.resident = np.zeros((mirror_h, mirror_w),
+                                             dtype=np.uint16)
+                    self.resident_valid = np.zeros((mirror_h, mirror_w),
+                                                   dtype=bool)
+                print(f"--- Device caps: {report[2]}x{report[3]} panel, "
+                      f"{report[4]} buffers of {buffer_size} bytes, "
+                      f"flags 0x{flags:02X} ---")
+                return
+        except OSError:
+            pass
+        print("--- No capability reply; using config.py defaults ---")
+
+    def _write(self, data: bytearray):
+        """
+        Writes one or more 64-byte packets to the bulk OUT endpoint.
+
+        `data` may be a single packet or many packets concatenated into one
+        buffer; a single bulk transfer is submitted either way, and the
+        hardware splits it into wire packets. Flow control is the bulk
+        protocol itself: the device NAKs while it is busy, so no host-side
+        pacing delays are needed.
+
+        Raises:
+            OSError: If the write fails, indicating a likely disconnection.
+        """
+        try:
+            self.device.write(config.BULK_OUT_EP, data,
+                              timeout=config.BULK_WRITE_TIMEOUT_MS)
+        except usb.core.USBError as e:
+            raise OSError(f"Bulk write failed: {e}. Device may be disconnected.")
+
+    def _emit(self, data: bytearray):
+        """
+        Hands a finished wire burst to the transmit stage.
+
+        With a pipeline attached (tx_queue set) this enqueues and returns
+        immediately, so encoding the next rect overlaps the bulk write of
+        this one; without one it degrades to a synchronous write, which is
+        what the benchmark entry point wants. The queue is bounded, so a
+        slow device applies backpressure instead of buffering frames.
+        """
+        if config.CAPTURE_CORPUS_PATH:
+            self._capture(data)
+        if self.traffic_log is not None:
+            self.traffic_log.note_burst(data)
+        if self.tx_queue is not None:
+            self.tx_queue.put(bytes(data))
+        else:
+            self._write(data)
+
+    def _capture(self, data: bytearray):
+        """
+        Appends one wire burst to the traffic corpus file.
+
+        Record framing is [u32 LE burst length][burst bytes]; the bursts
+        themselves are whole 64-byte wire packets, so the hostbench replay
+        (prj_usb_composite/hostbench/bench_display.cpp) can re-chunk them
+        exactly as the usbfs core would. Capture with a single panel
+        attached -- interleaved writers would shuffle the record stream.
+        """
+        if self._capture_file is None:
+            self._capture_file = open(config.CAPTURE_CORPUS_PATH, "ab")
+        self._capture_file.write(len(data).to_bytes(4, "little") + bytes(data))
+        self._capture_file.flush()
+
+    def _read(self, size: int, timeout_ms: int = 500) -> list:
+        """
+        Reads a status packet from the bulk IN endpoint.
+
+        Returns an empty list on timeout (no report pending), mirroring the
+        non-blocking hidapi read this transport replaced.
+
+        Raises:
+            OSError: If the read fails for any reason other than a timeout.
+        """
+        try:
+            return list(self.device.read(config.BULK_IN_EP, size,
+                                         timeout=timeout_ms))
+        except usb.core.USBTimeoutError:
+            return []
+        except usb.core.USBError as e:
+            raise OSError(f"Bulk read failed: {e}. Device may be disconnected.")
+
+    @staticmethod
+    def rle_encode_rgb565(data: bytearray) -> bytearray:
+        """
+        Run-length encodes RGB565 pixel data into 3-byte records.
+
+        Each record is [count, pixel_lsb, pixel_msb] where count is the number
+        of consecutive identical 16-bit pixels (1-255). Dashboard-style frames
+        with large flat-color regions typically compress 5-10x, which matters
+        because USB FS bulk bandwidth is the pipeline bottleneck.
+
+        Args:
+            data (bytearray): Raw little-endian RGB565 pixel data.
+
+        Returns:
+            bytearray: The RLE-encoded stream.
+        """
+        if framecodec.available():
+            return framecodec.rle_encode(data)
+        encoded = bytearray()
+        i = 0
+        n = len(data)
+        while i < n:
+            pixel = data[i:i + 2]
+            run = 1
+            while run < 255 and (i + run * 2 + 2) <= n and data[i + run * 2 : i + run * 2 + 2] == pixel:
+                run += 1
+            encoded.append(run)
+            encoded.extend(pixel)
+            i += run * 2
+        return encoded
+
+    @staticmethod
+    def delta_encode_rgb565(new: np.ndarray, old: np.ndarray) -> bytearray:
+        """
+        Encodes a rect as skip/copy spans against the device's resident
+        frame (ENC_DELTA).
+
+        The stream is a sequence of 2-byte [skip, copy] pixel-count
+        headers, each followed by the copy pixels as little-endian RGB565;
+        skipped pixels keep whatever the device already shows. Between
+        consecutive dashboard frames most of a scanline is unchanged --
+        a scrolling ticker shifts a few glyph edges per row -- so the
+        changed spans cost their pixels and everything else costs at most
+        one header per 255 pixels, below even RLE of the absolute values.
+
+        Args:
+            new (np.ndarray): The rect's new (h, w) uint16 RGB565 pixels.
+            old (np.ndarray): The same rect as the device currently holds.
+
+        Returns:
+            bytearray: The delta-span stream.
+        """
+        if framecodec.available():
+            return framecodec.delta_encode(new, old)
+        flat_new = new.flatten()
+        changed = flat_new != old.flatten()
+        pixel_bytes = flat_new.astype('<u2').tobytes()
+        # Run boundaries of the changed mask; only the spans themselves
+        # are walked in Python, never individual pixels.
+        edges = np.flatnonzero(changed[1:] != changed[:-1]) + 1
+        bounds = [0] + edges.tolist() + [changed.size]
+
+        encoded = bytearray()
+        skip = 0
+        for start, end in zip(bounds[:-1], bounds[1:]):
+            if not changed[start]:
+                skip = end - start
+                continue
+            while skip > 255:
+                encoded.extend((255, 0))
+                skip -= 255
+            pos = start
+            while pos < end:
+                run = min(end - pos, 255)
+                encoded.extend((skip, run))
+                encoded.extend(pixel_bytes[pos * 2:(pos + run) * 2])
+                skip = 0
+                pos += run
+        # A trailing unchanged span still has to advance the device's
+        # write offset so the rect finalizes.
+        while skip > 255:
+            encoded.extend((255, 0))
+            skip -= 255
+        if skip:
+            encoded.extend((skip, 0))
+        return encoded
+
+    def _palette_indices(self, pixel_data: bytearray):
+        """
+        Maps RGB565 pixel data onto the device palette.
+
+        Returns (indices, new_entries) where new_entries lists
+        (index, color_bytes) pairs not yet uploaded to the device, or
+        (None, None) if the data needs more colors than the palette holds.
+        The palette map itself is only updated once the caller commits to
+        the indexed encoding and actually uploads the new entries.
+        """
+        pixels = np.frombuffer(bytes(pixel_data), dtype='<u2')
+        # Only the unique colors (a handful per dashboard tile) are walked
+        # in Python; the per-pixel index lookup is one vectorized gather.
+        lut = np.zeros(0x10000, dtype=np.uint8)
+        new_entries = []
+        next_index = len(self.palette_map)
+        for value in np.unique(pixels).tolist():
+            color = int(value).to_bytes(2, 'little')
+            idx = self.palette_map.get(color)
+            if idx is None:
+                if next_index >= config.PALETTE_SIZE:
+                    return None, None
+                idx = next_index
+                next_index += 1
+                new_entries.append((idx, color))
+            lut[value] = idx
+        return bytearray(lut[pixels].tobytes()), new_entries
+
+    def note_credits(self, free_slots: int):
+        """Updates the free-slot credit count (called by the listener thread)."""
+        with self.credits_cond:
+            self.credits = free_slots
+            self.credits_cond.notify_all()
+
+    def note_status(self, report):
+        """
+        Folds an unsolicited REPORT_STATUS push (firmware with
+        CAPS_STATUS_PUSH) into the flow-control state. The record arrives
+        every few frames while the device is unparked, so the credit
+        count here is fresher than the change-triggered REPORT_CREDITS
+        alone: a credit freed and re-consumed between two change reports
+        still surfaces. Health trips are printed once per transition.
+        """
+        self.note_credits(report[1])
+        tripped = report[3]
+        if tripped and tripped != self.last_health_tripped:
+            print(f"--- Device health anomaly mask 0x{tripped:02x} "
+                  f"(see firmware health.h) ---")
+        self.last_health_tripped = tripped
+        self.last_status = {
+            'rects_drawn': report[4] | (report[5] << 8),
+            'slots_dropped': report[6] | (report[7] << 8),
+            'draw_cycles_last': int.from_bytes(bytes(report[8:12]), 'little'),
+            'received_at': time.time(),
+        }
+        # Telemetry tail (newer firmware): supply rail in mV and die
+        # temperature in tenths of a degC, signed.
+        if len(report) >= 16:
+            self.last_status['supply_mv'] = report[12] | (report[13] << 8)
+            raw = int.from_bytes(bytes(report[14:16]), 'little', signed=True)
+            self.last_status['die_temp_c'] = raw / 10.0
+
+    def control_status(self):
+        """
+        Reads the device status record over EP0 (VREQ_STATUS).
+
+        Same record as the REPORT_STATUS push (minus the report id
+        byte), but answered inside the control transfer itself by the
+        firmware's vendor-request table (vendor_ctl.h): no command
+        packet, no IN-queue contention with the display stream, and it
+        works while the listener thread is not running. Folds the
+        result into the flow-control state and returns the parsed
+        status dict, or None when the transfer fails (e.g. firmware
+        without the table).
+        """
+        if self.device is None:
+            return None
+        try:
+            data = self.device.ctrl_transfer(0xC0, config.VREQ_STATUS,
+                                             0, 0, 16)
+        except usb.core.USBError:
+            return None
+        if len(data) < 15:
+            return None
+        self.note_status(bytes([config.REPORT_STATUS]) + bytes(data))
+        return dict(self.last_status)
+
+    def control_cfg_get(self, key: int):
+        """
+        Reads one flash parameter store value over EP0 (VREQ_CFG_GET).
+
+        Returns the stored value, or None when the key is unset (the
+        firmware answers 0xFFFFFFFF) or the transfer fails. Key
+        meanings live in the firmware's tuning.h.
+        """
+        if self.device is None:
+            return None
+        try:
+            data = self.device.ctrl_transfer(0xC0, config.VREQ_CFG_GET,
+                                             key, 0, 4)
+        except usb.core.USBError:
+            return None
+        if len(data) < 4:
+            return None
+        value = int.from_bytes(bytes(data), 'little')
+        return None if value == 0xFFFFFFFF else value
+
+    def _take_credit(self):
+        """
+        Blocks while the device reports zero free draw slots.
+
+        Called before every slot-consuming command. The local count is
+        decremented optimistically and overwritten by the next
+        REPORT_CREDITS; the wait is bounded by
+        CREDIT_WAIT_TIMEOUT_SECONDS so a lost report degrades to the old
+        push-and-recover behavior instead of stalling the pipeline.
+        """
+        with self.credits_cond:
+            if self.credits is None:
+                return
+            if self.credits == 0:
+                waited = time.time()
+                self.credits_cond.wait(config.CREDIT_WAIT_TIMEOUT_SECONDS)
+                self.credit_stall_s += time.time() - waited
+            if self.credits:
+                self.credits -= 1
+
+    def take_credit_stall(self) -> float:
+        """Returns and clears the accumulated zero-credit stall time."""
+        with self.credits_cond:
+            stall = self.credit_stall_s
+            self.credit_stall_s = 0.0
+            return stall
+
+    def _note_resident(self, bbox: tuple[int, int, int, int], pixels):
+        """
+        Records what the device's resident frame now holds at bbox (a
+        pixel array or a scalar fill color), so later deltas can skip it.
+        """
+        if self.resident is None: return
+        x1, y1, x2, y2 = bbox
+        self.resident[y1:y2, x1:x2] = pixels
+        self.resident_valid[y1:y2, x1:x2] = True
+
+    def _invalidate_resident(self, bbox: tuple[int, int, int, int]):
+        """
+        Forgets the mirror content at bbox. Used where the device content
+        is not byte-exactly known on the host (on-device text rendering)
+        or known to be wrong (an update the device reported lost); rects
+        touching the area fall back to absolute encodings until rewritten.
+        """
+        if self.resident is None: return
+        x1, y1, x2, y2 = bbox
+        self.resident_valid[y1:y2, x1:x2] = False
+
+    def _send_palette_entries(self, entries: list):
+        """
+        Uploads new palette slots with CMD_SET_PALETTE packets and commits
+        them to the local palette map. Entries are allocated consecutively,
+        so each packet carries a (start, count) run of up to 30 colors.
+        """
+        for chunk_start in range(0, len(entries), config.PALETTE_ENTRIES_PER_PACKET):
+            chunk = entries[chunk_start:chunk_start + config.PALETTE_ENTRIES_PER_PACKET]
+            packet = bytearray([config.CMD_SET_PALETTE,
+                                chunk[0][0], len(chunk)])
+            for _, color in chunk:
+                packet.extend(color)
+            packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+            self._emit(packet)
+        for idx, color in entries:
+            self.palette_map[color] = idx
+
+    def send_data_payload(self, data: bytearray, command: int = config.CMD_IMAGE_DATA, align: int = 1):
         """
-        Sends a raw data payload, splitting it into HID report-sized chunks.
+        Sends a raw data payload as one queued bulk transfer.
 
         This function is the second part of the two-step update process. It sends
-        the raw pixel data that was described by a preceding `CMD_DRAW_RECT` command.
-        The data is chunked to fit into 64-byte HID reports.
+        the pixel data that was described by a preceding `CMD_DRAW_RECT` command.
+        The data is chunked into 64-byte wire packets, but all packets are
+        concatenated and submitted as a single bulk write: the controller
+        streams them back-to-back and the device NAKs whenever it needs time,
+        so no per-packet pacing is required.
 
         Args:
-            data (bytearray): The raw byte data to send.
-        
+            data (bytearray): The byte data to send.
+            command (int): The command byte identifying the payload encoding.
+            align (int): Record size the chunks must be a multiple of, so that
+                         records (e.g. 3-byte RLE runs) never straddle packets.
+
         Raises:
-            OSError: If a HID write operation fails, indicating a likely disconnection.
+            OSError: If the bulk write fails, indicating a likely disconnection.
         """
         sent_bytes = 0
-        # The actual payload size per report is the report length minus the overhead
-        # for the Report ID (1 byte) and the Command ID (1 byte).
-        payload_size = config.REPORT_LENGTH - 1
+        # The payload size per packet is the packet length minus the Command
+        # ID byte. Headerless streams (command=None) use the full packet for
+        # pixel data.
+        payload_size = config.REPORT_LENGTH if command is None else config.REPORT_LENGTH - 1
+        if align > 1:
+            payload_size = (payload_size // align) * align
+        burst = bytearray()
         while sent_bytes < len(data):
             chunk = data[sent_bytes : sent_bytes + payload_size]
-            packet = bytearray([config.REPORT_ID, config.CMD_IMAGE_DATA])
+            packet = bytearray() if command is None else bytearray([command])
             packet.extend(chunk)
             packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
-            bytes_written = self.device.write(packet)
-            if bytes_written < 0: raise OSError("HID write failed. Device may be disconnected.")
+            burst.extend(packet)
             sent_bytes += len(chunk)
-            # A small delay is crucial for flow control. It gives the firmware time
-            # to process the incoming packet and write it to the LCD's DMA buffer
-            # before the next packet arrives.
-            time.sleep(0.001) 
+        self._emit(burst)
+
+    def _send_multi_fill(self, fills: list):
+        """
+        Packs a run of solid-color rects into one CMD_MULTI_FILL packet:
+        [CMD, count, seq_lsb, seq_msb] plus a 6-byte [x, y, w, h,
+        color_lsb, color_msb] record per rect, sequence numbers
+        consecutive from seq. One wire packet retires up to
+        MULTI_FILL_MAX_RECTS widget updates.
+        """
+        if not fills: return
+        # One credit per wire packet: the batch drains slot-by-slot on
+        # the device, and a partial batch is NACKed back anyway.
+        self._take_credit()
+        seq = self.sequence_number
+        packet = bytearray([config.CMD_MULTI_FILL, len(fills),
+                            seq & 0xFF, (seq >> 8) & 0xFF])
+        # Fill records carry no payload; pixel-doubled mode translates
+        # them to panel scale here (the record has no flags field).
+        mul = 2 if self.pixel_double else 1
+        for (x1, y1, x2, y2), color in fills:
+            packet.extend([x1 * mul, y1 * mul,
+                           (x2 - x1) * mul, (y2 - y1) * mul,
+                           color & 0xFF, (color >> 8) & 0xFF])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        for bbox, color in fills:
+            self._note_resident(bbox, color)
+            self._record_sent(self.sequence_number, ('rect', bbox))
+            self.sequence_number = (self.sequence_number + 1) & 0xFFFF
 
-    def send_rect_update(self, image: Image.Image, bbox: tuple[int, int, int, int]):
+    def _send_list_marker(self, cmd: int):
         """
-        Sends a rectangular portion of an image to the device.
+        Emits a bare display-list command (CMD_LIST_BEGIN/CMD_LIST_COMMIT).
+        Markers consume no draw slot and no sequence number, so neither a
+        credit nor a history entry is taken for them.
+        """
+        packet = bytearray([cmd])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+
+    def send_rect_updates(self, frame: np.ndarray, rects: list):
+        """
+        Sends a batch of dirty rects, batching where the protocol allows.
+
+        Runs of solid-color rects (buttons, bars, separators -- the bulk
+        of widget-heavy frames) are packed into single CMD_MULTI_FILL
+        transactions; everything else goes through the regular per-rect
+        path. Rects are flushed in order so sequence numbers match the
+        wire order the device's gap detection expects.
+
+        When the firmware advertises display lists, a batch that takes
+        more than one draw slot is bracketed in CMD_LIST_BEGIN/COMMIT so
+        it reaches the panel atomically -- the device holds the slots and
+        blits them as one chain at the commit, while the next batch is
+        already uploading behind them. A lone small rect skips the
+        markers; there is nothing to tear.
+        """
+        atomic = False
+        if self.display_lists and rects:
+            if len(rects) > 1:
+                atomic = True
+            else:
+                x1, y1, x2, y2 = rects[0]
+                atomic = (x2 - x1) * (y2 - y1) > self.max_pixels_per_chunk
+        if atomic:
+            self._send_list_marker(config.CMD_LIST_BEGIN)
+        fills = []
+        for bbox in rects:
+            x1, y1, x2, y2 = bbox
+            width, height = x2 - x1, y2 - y1
+            if width <= 0 or height <= 0:
+                continue
+            crop = frame[y1:y2, x1:x2]
+            if (width * height <= self.max_pixels_per_chunk
+                    and (crop == crop.flat[0]).all()):
+                fills.append((bbox, int(crop.flat[0])))
+                if len(fills) == config.MULTI_FILL_MAX_RECTS:
+                    self._send_multi_fill(fills)
+                    fills = []
+            else:
+                self._send_multi_fill(fills)
+                fills = []
+                self.send_rect_update(frame, bbox)
+        self._send_multi_fill(fills)
+        if atomic:
+            self._send_list_marker(config.CMD_LIST_COMMIT)
+
+    def send_rect_update(self, frame: np.ndarray, bbox: tuple[int, int, int, int]):
+        """
+        Sends a rectangular portion of a frame to the device.
 
         This function implements the core display update protocol:
         1.  If the update area is too large for the device's buffer, it is
             recursively split into smaller, horizontal chunks.
         2.  A `CMD_DRAW_RECT` command packet is sent, containing the
             coordinates (x, y), dimensions (w, h), and a sequence number.
-        3.  The corresponding image data is cropped, converted from RGB to
-            RGB565 format, and sent as a data payload.
+        3.  The corresponding pixel data is sliced out of the frame array
+            and sent as a data payload.
 
         Args:
-            image (Image.Image): The full PIL Image object.
+            frame (np.ndarray): The full (height, width) uint16 RGB565 frame
+                                (see rgb565_frame()). In pixel-doubled mode
+                                this is the quarter-resolution canvas and
+                                bbox is in its coordinates; the device
+                                expands each pixel to a 2x2 block.
             bbox (tuple): The bounding box (x1, y1, x2, y2) of the area to update.
-        
+
         Raises:
             OSError: If a HID write operation fails, indicating a likely disconnection.
         """
@@ -124,58 +1064,658 @@ class DeviceManager:
         x1, y1, x2, y2 = bbox
         width, height = x2 - x1, y2 - y1
         if width <= 0 or height <= 0: return
-        if width * height > config.MAX_PIXELS_PER_CHUNK:
-            rows_per_chunk = config.MAX_PIXELS_PER_CHUNK // width or 1
+        if width * height > self.max_pixels_per_chunk:
+            rows_per_chunk = self.max_pixels_per_chunk // width or 1
             # Iterate through the large bounding box in horizontal strips.
             for y_offset in range(0, height, rows_per_chunk):
                 chunk_height = min(rows_per_chunk, height - y_offset)
                 new_bbox = (x1, y1 + y_offset, x2, y1 + y_offset + chunk_height)
                 # Recursively call this function for each smaller chunk.
-                self.send_rect_update(image, new_bbox)
+                self.send_rect_update(frame, new_bbox)
             return
+        self._take_credit()
         print(f"--- Sending Tile #{self.sequence_number} at ({x1},{y1}) size {width}x{height} ---")
-        
-        # Crop the image and convert from 8-bits-per-channel RGB to 16-bit RGB565.
-        img_data = image.crop(bbox).tobytes("raw", "RGB")
-        pixel_data_rgb565 = bytearray()
-        for i in range(0, len(img_data), 3):
-            r, g, b = img_data[i:i+3]
-            # Bitwise operations to pack the 24-bit color into 16 bits.
-            # RRRRRGGG GGGBBBBB
-            rgb565 = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
-            # Append the 16-bit value as two bytes (little-endian).
-            pixel_data_rgb565.extend(rgb565.to_bytes(2, 'little'))
-        
+
+        # Slice the rect out of the pre-converted RGB565 frame; the wire
+        # format is little-endian 16-bit pixels in row-major order.
+        crop = frame[y1:y2, x1:x2]
+        pixel_data_rgb565 = bytearray(crop.astype('<u2').tobytes())
+
+        # Solid-color areas (backgrounds, bar charts) become a single
+        # FILL_RECT command executed on-device by a repeated-word DMA;
+        # no pixel payload and no framebuffer slot is consumed at all.
+        if (crop == crop.flat[0]).all():
+            seq_lsb = self.sequence_number & 0xFF
+            seq_msb = (self.sequence_number >> 8) & 0xFF
+            # Fills carry no payload, so pixel-doubled mode just sends the
+            # rect at panel scale; the FILL_RECT command has no flags byte.
+            mul = 2 if self.pixel_double else 1
+            packet = bytearray([config.CMD_FILL_RECT,
+                                x1 * mul, y1 * mul, width * mul, height * mul,
+                                seq_lsb, seq_msb,
+                                pixel_data_rgb565[0], pixel_data_rgb565[1]])
+            packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+            self._emit(packet)
+            self._note_resident(bbox, int(crop.flat[0]))
+            self._record_sent(self.sequence_number, ('rect', bbox))
+            self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+            return
+
+        # Choose the payload encoding before announcing the rect: the device
+        # needs it up front so raw streams can be received zero-copy. The
+        # palettized form costs one byte per pixel (plus any one-time
+        # palette upload); RLE wins on flat areas, indexed on detailed ones.
+        rle_data = self.rle_encode_rgb565(pixel_data_rgb565)
+        idx_data, new_palette = self._palette_indices(pixel_data_rgb565)
+        if idx_data is None and self.palette_map:
+            # Palette exhausted (e.g. after a theme change): start a fresh
+            # one. Already-drawn rects are unaffected; expansion happens at
+            # reception time on the device.
+            self.palette_map.clear()
+            idx_data, new_palette = self._palette_indices(pixel_data_rgb565)
+
+        # Delta spans against the resident-frame mirror beat every absolute
+        # encoding when the rect is mostly unchanged (scrolling ticker,
+        # counter digits); only possible where the mirror is exact.
+        delta_data = None
+        if (self.delta_streams and self.resident is not None
+                and bool(self.resident_valid[y1:y2, x1:x2].all())):
+            delta_data = self.delta_encode_rgb565(crop,
+                                                  self.resident[y1:y2, x1:x2])
+
+        best_absolute = min(len(rle_data), len(pixel_data_rgb565),
+                            len(idx_data) if idx_data is not None
+                            else len(pixel_data_rgb565))
+        use_delta = delta_data is not None and len(delta_data) < best_absolute
+        # Under governor pressure the indexed form is taken whenever it is
+        # available, not only when it is smallest: one byte per pixel is a
+        # guaranteed payload ceiling, which matters more than the odd rect
+        # where RLE would have shaved a little extra.
+        use_indexed = (not use_delta and idx_data is not None and
+                       (self.prefer_indexed or
+                        len(idx_data) < min(len(rle_data), len(pixel_data_rgb565))))
+        use_rle = (not use_delta and not use_indexed
+                   and len(rle_data) < len(pixel_data_rgb565))
+        if use_delta:
+            encoding = config.ENC_DELTA
+        elif use_indexed:
+            encoding = config.ENC_INDEXED
+            if new_palette:
+                self._send_palette_entries(new_palette)
+        else:
+            encoding = config.ENC_RLE if use_rle else config.ENC_RAW
+
+        if use_delta:
+            # Delta streams are single-header by construction: the device
+            # only knows where the spans end from the announced length.
+            payload_data, payload_cmd, align = delta_data, None, 1
+        elif use_indexed:
+            payload_data, payload_cmd, align = idx_data, config.CMD_IMAGE_DATA_IDX, 1
+        elif use_rle:
+            payload_data, payload_cmd, align = rle_data, config.CMD_IMAGE_DATA_RLE, 3
+        else:
+            # Headerless stream: every report is pure pixel payload, which
+            # the firmware receives directly into the framebuffer slot.
+            payload_data, payload_cmd, align = pixel_data_rgb565, None, 1
+
         # Construct the command packet payload.
         seq_lsb = self.sequence_number & 0xFF
         seq_msb = (self.sequence_number >> 8) & 0xFF
-        payload = bytearray([x1, y1, width, height, seq_lsb, seq_msb])
-        
-        # Prepend Report ID and Command ID, then pad to the required report length.
-        command_packet = bytearray([config.REPORT_ID, config.CMD_DRAW_RECT])
-        command_packet.extend(payload)
+        command_packet = bytearray([config.CMD_DRAW_RECT,
+                                    x1, y1, width, height,
+                                    seq_lsb, seq_msb, encoding])
+        if self.single_header_streams and (payload_cmd is not None or use_delta):
+            # Single-header stream (negotiated via GET_CAPS): announce the
+            # encoded length so the device takes every following packet as
+            # headerless payload -- the per-packet command byte and the
+            # record-alignment padding are gone, and the whole logical
+            # transfer costs exactly one header.
+            command_packet.extend([len(payload_data) & 0xFF,
+                                   (len(payload_data) >> 8) & 0xFF])
+            payload_cmd, align = None, 1
+        # Short headers (raw streams announce no length) pad out to the
+        # flags position when any flag bit is set.
+        header_flags = config.RECT_FLAG_SCALE2X if self.pixel_double else 0
+        if self.integrity_crc and payload_cmd is None:
+            # CRC32 trailer over the encoded wire payload, verified by the
+            # device's hardware CRC unit during reception; a mismatch is
+            # NACKed and retransmitted like a lost sequence. Only possible
+            # on headerless streams, where both sides agree byte for byte
+            # on what the payload is.
+            header_flags |= config.RECT_FLAG_CRC_TRAILER
+        if header_flags:
+            if len(command_packet) == 8:
+                command_packet.extend([0, 0])
+            command_packet.append(header_flags)
+            if header_flags & config.RECT_FLAG_CRC_TRAILER:
+                command_packet.extend(
+                    framecodec.crc32(payload_data).to_bytes(4, 'little'))
         command_packet.extend([0] * (config.REPORT_LENGTH - len(command_packet)))
-        bytes_written = self.device.write(command_packet)
-        if bytes_written < 0: raise OSError("HID write failed. Device may be disconnected.")
-        time.sleep(0.005) # Wait for firmware to process the command.
-        self.send_data_payload(pixel_data_rgb565)
+        self._emit(command_packet)
+
+        self.send_data_payload(payload_data, payload_cmd, align=align)
+        self._note_resident(bbox, crop)
+        if self.verify_mode:
+            # Expected decoded-region checksum for the device's verify
+            # echo: what its framebuffer must hold once this rect's
+            # payload is decoded. In pixel-doubled mode that is the
+            # 2x2-expanded region, at panel scale.
+            if self.pixel_double:
+                decoded = np.repeat(np.repeat(crop, 2, axis=0), 2,
+                                    axis=1).astype('<u2').tobytes()
+            else:
+                decoded = bytes(pixel_data_rgb565)
+            self.verify_expected[self.sequence_number] = framecodec.crc32(decoded)
+            while len(self.verify_expected) > 512:
+                # Echo never came (dropped rect, full echo ring); age the
+                # oldest out so a long run cannot grow the map unbounded.
+                self.verify_expected.popitem(last=False)
+        self._record_sent(self.sequence_number, ('rect', bbox))
         self.sequence_number = (self.sequence_number + 1) & 0xFFFF
 
+    def send_text(self, x: int, y: int, text: str, fg: int, bg: int,
+                  font: int = config.FONT_8X16):
+        """
+        Renders a string on-device from the firmware's baked font atlas.
+
+        The whole update is a single CMD_DRAW_TEXT packet (position, colors
+        and characters); the device expands the glyphs itself, so e.g. a
+        clock update costs ~20 bytes instead of kilobytes of pixel data.
+
+        Args:
+            x, y: Top-left corner of the text run on the panel.
+            text: ASCII string; truncated to what fits in one report.
+            fg, bg: Foreground/background colors as packed RGB565 values.
+            font: config.FONT_8X16, config.FONT_16X24 or the proportional
+                config.FONT_UBUNTU_16.
+
+        Raises:
+            OSError: If the HID write fails, indicating a likely disconnection.
+        """
+        chars = text.encode('ascii', errors='replace')[:config.REPORT_LENGTH - 11]
+        if not chars: return
+
+        self._take_credit()
+        seq_lsb = self.sequence_number & 0xFF
+        seq_msb = (self.sequence_number >> 8) & 0xFF
+        packet = bytearray([config.CMD_DRAW_TEXT,
+                            x, y, font,
+                            fg & 0xFF, (fg >> 8) & 0xFF,
+                            bg & 0xFF, (bg >> 8) & 0xFF,
+                            seq_lsb, seq_msb, len(chars)])
+        packet.extend(chars)
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        # The glyphs are rasterized on-device, so the exact pixels are not
+        # known here; a generous bounding box (widest font cell, tallest
+        # line) is dropped from the resident mirror instead.
+        self._invalidate_resident((x, y, min(x + len(chars) * 16, config.LCD_WIDTH),
+                                   min(y + 24, config.LCD_HEIGHT)))
+        self._record_sent(self.sequence_number, ('text', bytes(packet)))
+        self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+
+    def send_scroll(self, offset: int, x: int = 0, w: int = config.LCD_WIDTH):
+        """
+        Shifts the displayed content of a window in hardware.
+
+        The device programs the ST7735S scroll registers: the window
+        [x, x+w) on the panel's x axis shows its frame-memory content
+        rotated left by `offset` pixels, wrapping within the window.
+        Frame memory is untouched, so a scrolling ticker advances with
+        this one packet plus a DRAW_RECT for the single column strip the
+        rotation reveals -- instead of retransmitting the whole region.
+        Note the revealed strip lives at the memory column that wrapped,
+        not at the window edge the viewer sees it on.
+
+        Args:
+            offset: Scroll offset in pixels, 0 <= offset < w; 0 restores
+                the identity mapping.
+            x, w: The scroll window on the panel's x axis.
+
+        Raises:
+            OSError: If the bulk write fails, indicating a likely disconnection.
+        """
+        seq_lsb = self.sequence_number & 0xFF
+        seq_msb = (self.sequence_number >> 8) & 0xFF
+        packet = bytearray([config.CMD_SET_SCROLL, x, w, offset,
+                            seq_lsb, seq_msb])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        self._record_sent(self.sequence_number, ('scroll', bytes(packet)))
+        self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+
+    def set_overlay(self, pixels: np.ndarray, key: int):
+        """
+        Uploads the cursor/overlay bitmap to the device (CMD_OVERLAY_SET).
+
+        The device composites this bitmap over its resident frame on the
+        way to the panel, so once uploaded, a moving highlight costs one
+        move_overlay() packet per step instead of redrawing and
+        re-sending the region underneath. Upload once per bitmap, not
+        per move. No-op unless the firmware advertised CAPS_OVERLAY
+        (whole-frame builds only: restoring the occluded pixels needs
+        the resident frame).
+
+        Args:
+            pixels: (h, w) uint16 RGB565 array, at most
+                OVERLAY_MAX_W x OVERLAY_MAX_H.
+            key: RGB565 value marking transparent pixels; pick one that
+                does not occur in the bitmap.
+
+        Raises:
+            OSError: If the bulk write fails, indicating a likely disconnection.
+        """
+        if not self.overlay_plane:
+            return
+        h, w = pixels.shape
+        if w > config.OVERLAY_MAX_W or h > config.OVERLAY_MAX_H:
+            raise ValueError(f"Overlay bitmap {w}x{h} exceeds the device "
+                             f"limit of {config.OVERLAY_MAX_W}x"
+                             f"{config.OVERLAY_MAX_H}.")
+        burst = bytearray([config.CMD_OVERLAY_SET, w, h,
+                           key & 0xFF, (key >> 8) & 0xFF])
+        burst.extend([0] * (config.REPORT_LENGTH - len(burst)))
+        # Pixel payload follows headerless, like single-header streams.
+        payload = pixels.astype('<u2').tobytes()
+        for off in range(0, len(payload), config.REPORT_LENGTH):
+            chunk = bytearray(payload[off:off + config.REPORT_LENGTH])
+            chunk.extend([0] * (config.REPORT_LENGTH - len(chunk)))
+            burst.extend(chunk)
+        self._emit(burst)
+
+    def move_overlay(self, x: int, y: int, visible: bool = True):
+        """
+        Moves or hides the overlay plane (CMD_OVERLAY_POS).
+
+        Coordinates are panel-native even in pixel-doubled mode: the
+        plane is composited after expansion. The device restores the
+        pixels under the previous position from its resident frame, so
+        nothing needs re-sending here.
+
+        Raises:
+            OSError: If the bulk write fails, indicating a likely disconnection.
+        """
+        if not self.overlay_plane:
+            return
+        packet = bytearray([config.CMD_OVERLAY_POS, x, y,
+                            1 if visible else 0,
+                            self.sequence_number & 0xFF,
+                            (self.sequence_number >> 8) & 0xFF])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        self._record_sent(self.sequence_number, ('overlay', bytes(packet)))
+        self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+
+    def _read_asset_report(self, timeout_ms: int = 250):
+        """
+        Queries the device's flash asset store (CMD_GET_ASSETS).
+
+        Synchronous, so it must only run while no listener thread is
+        consuming IN reports (connect time, like _negotiate_caps).
+
+        Returns:
+            tuple: (state, bytes_received, {id: version}) from the
+            REPORT_ASSETS reply, or None if the firmware never answered
+            (older firmware without an asset store).
+        """
+        packet = bytearray([config.CMD_GET_ASSETS])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._write(packet)
+        for _ in range(8):
+            report = self._read(64, timeout_ms=timeout_ms)
+            if not report:
+                return None
+            if report[0] != config.REPORT_ASSETS:
+                continue  # Stale status report; keep looking.
+            state = report[1]
+            bytes_received = int.from_bytes(bytes(report[2:6]), 'little')
+            directory = {}
+            for i in range(report[6]):
+                directory[report[7 + i * 3]] = (report[8 + i * 3]
+                                                | (report[9 + i * 3] << 8))
+            return state, bytes_received, directory
+        return None
+
+    def _await_asset_state(self, states: tuple) -> tuple:
+        """
+        Polls the store until its state is one of `states`.
+
+        Page erases and word programming run from the device's main loop,
+        so a wipe or upload completes across many GET_ASSETS polls; the
+        wait is bounded by ASSET_POLL_TIMEOUT_SECONDS.
+        """
+        deadline = time.time() + config.ASSET_POLL_TIMEOUT_SECONDS
+        while True:
+            reply = self._read_asset_report()
+            if reply is not None and (reply[0] in states
+                                      or reply[0] == config.ASSET_STATE_ERROR):
+                return reply
+            if time.time() > deadline:
+                raise OSError("Asset store state poll timed out.")
+            time.sleep(config.ASSET_POLL_INTERVAL_SECONDS)
+
+    def upload_assets(self, assets: dict) -> bool:
+        """
+        Ensures the given assets are resident in the device's flash store.
+
+        Queries the store directory first: when every id is already there
+        at the right version -- the store survives both reconnects and
+        reflashes -- this costs one report round-trip and nothing is sent.
+        Otherwise the store is wiped and every asset is re-uploaded (the
+        store is append-only; there is no in-place update). Uploads pace
+        themselves against the acknowledged byte count, since the firmware
+        stages at most ASSET_STAGING_BYTES ahead of its flash programming.
+
+        Runs synchronously, so call it before the listener thread starts.
+
+        Args:
+            assets: {id: (version, frame)} where frame is a (height, width)
+                uint16 RGB565 array as produced by rgb565_frame().
+
+        Returns:
+            bool: True once all assets are resident; False if the firmware
+            has no asset store or the upload failed (callers then fall
+            back to streaming the pixels each session).
+        """
+        reply = self._read_asset_report()
+        if reply is None:
+            print("--- No asset store on device; streaming assets per session ---")
+            return False
+        state, _, directory = reply
+        if (state == config.ASSET_STATE_IDLE and
+                all(directory.get(asset_id) == version
+                    for asset_id, (version, _) in assets.items())):
+            for asset_id, (_, frame) in assets.items():
+                self.asset_shapes[asset_id] = (frame.shape[1], frame.shape[0])
+            print("--- Device asset store is current ---")
+            return True
+
+        start = time.time()
+        for index, (asset_id, (version, frame)) in enumerate(assets.items()):
+            height, width = frame.shape
+            data = frame.astype('<u2').tobytes()
+            # The first begin of a refresh wipes the whole store; the
+            # firmware keeps the begin latched until the erase finishes.
+            packet = bytearray([config.CMD_ASSET_BEGIN,
+                                0x01 if index == 0 else 0x00, asset_id,
+                                version & 0xFF, (version >> 8) & 0xFF,
+                                width, height])
+            packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+            self._write(packet)
+            reply = self._await_asset_state((config.ASSET_STATE_WRITING,))
+            if reply[0] == config.ASSET_STATE_ERROR:
+                print("--- Asset upload rejected (store too small?) ---")
+                return False
+
+            # Stream the pixels, never running further ahead of the
+            # acknowledged byte count than the firmware's staging ring.
+            sent = acked = 0
+            deadline = time.time() + config.ASSET_POLL_TIMEOUT_SECONDS
+            while sent < len(data):
+                while (sent - acked + config.ASSET_DATA_BYTES_PER_PACKET
+                        > config.ASSET_STAGING_BYTES):
+                    reply = self._read_asset_report()
+                    if reply is not None:
+                        if reply[0] == config.ASSET_STATE_ERROR:
+                            return False
+                        acked = reply[1]
+                    if time.time() > deadline:
+                        raise OSError("Asset upload stalled.")
+                    time.sleep(config.ASSET_POLL_INTERVAL_SECONDS)
+                chunk = data[sent:sent + config.ASSET_DATA_BYTES_PER_PACKET]
+                packet = bytearray([config.CMD_ASSET_DATA, len(chunk)])
+                packet.extend(chunk)
+                packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+                self._write(packet)
+                sent += len(chunk)
+            # IDLE confirms the final words reached flash; trusting the
+            # directory before that would mistake a power-lost header for
+            # a finished upload on the next connect.
+            reply = self._await_asset_state((config.ASSET_STATE_IDLE,))
+            if reply[0] == config.ASSET_STATE_ERROR:
+                return False
+            self.asset_shapes[asset_id] = (width, height)
+        print(f"--- Uploaded {len(assets)} asset(s) to device flash "
+              f"in {time.time() - start:.2f}s ---")
+        return True
+
+    def draw_asset(self, asset_id: int, x: int, y: int):
+        """
+        Blits an asset from the device's flash store to the panel.
+
+        The whole update is one 6-byte CMD_DRAW_ASSET packet; the device
+        streams the stored pixels memory-mapped into the LCD DMA, so e.g.
+        the session-start background costs this packet instead of a 25 KB
+        pixel stream. Only valid for ids that upload_assets confirmed.
+
+        Args:
+            asset_id: A well-known asset id (config.ASSET_ID_*).
+            x, y: Top-left corner of the blit on the panel.
+
+        Raises:
+            OSError: If the bulk write fails, indicating a likely disconnection.
+        """
+        shape = self.asset_shapes.get(asset_id)
+        if shape is None: return
+        self._take_credit()
+        seq_lsb = self.sequence_number & 0xFF
+        seq_msb = (self.sequence_number >> 8) & 0xFF
+        packet = bytearray([config.CMD_DRAW_ASSET, asset_id, x, y,
+                            seq_lsb, seq_msb])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        # The blit source lives in device flash, not in any frame this
+        # manager encoded, so the mirror cannot vouch for those pixels.
+        self._invalidate_resident((x, y,
+                                   min(x + shape[0], config.LCD_WIDTH),
+                                   min(y + shape[1], config.LCD_HEIGHT)))
+        self._record_sent(self.sequence_number, ('asset', bytes(packet)))
+        self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+
+    def _record_sent(self, seq: int, entry: tuple):
+        """Remembers what a sequence number carried for NACK replay."""
+        self.sent_history[seq] = entry
+        while len(self.sent_history) > config.SENT_HISTORY_DEPTH:
+            self.sent_history.popitem(last=False)
+
+    def resend_lost_range(self, frame: np.ndarray, first: int, last: int) -> bool:
+        """
+        Retransmits the updates whose sequence numbers the device reported
+        lost (inclusive range, modulo-65536).
+
+        Rect updates are re-encoded from the current frame array, so a
+        retransmitted tile is never staler than the original. Returns False
+        if any entry has already been pruned from the history; the caller
+        should force a full redraw in that case.
+        """
+        count = ((last - first) & 0xFFFF) + 1
+        if count > config.SENT_HISTORY_DEPTH:
+            return False
+        entries = []
+        for i in range(count):
+            entry = self.sent_history.get((first + i) & 0xFFFF)
+            if entry is None:
+                return False
+            entries.append(entry)
+
+        for kind, payload in entries:
+            if kind == 'rect':
+                # The device never applied the lost update, so the mirror
+                # is wrong there; drop it so the resend goes out in an
+                # absolute encoding instead of a delta that skips pixels.
+                self._invalidate_resident(payload)
+                self.send_rect_update(frame, payload)
+            else:
+                # 'text'/'scroll'/'asset'/'overlay': replay the original packet with a
+                # fresh sequence number (its offset depends on the layout).
+                seq_at = 8 if kind == 'text' else 4
+                packet = bytearray(payload)
+                packet[seq_at] = self.sequence_number & 0xFF
+                packet[seq_at + 1] = (self.sequence_number >> 8) & 0xFF
+                self._emit(packet)
+                self._record_sent(self.sequence_number, (kind, bytes(packet)))
+                self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+        return True
+
+    def send_idle_hint(self, idle: bool):
+        """
+        Tells the firmware whether the host considers the screen static.
+
+        With idle set the device parks its display pipeline: the 1 kHz
+        SOF tick stops waking its main loop and the core sleeps in WFI
+        between real events. Consumes no draw slot and no sequence
+        number. Callers never need an explicit wake -- the next update
+        unparks the device on arrival.
+        """
+        packet = bytearray([config.CMD_IDLE_HINT, 1 if idle else 0])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+
+    def set_verify_mode(self, enable: bool):
+        """
+        Arms (or disarms) the firmware's golden-image verification.
+
+        While armed the device answers every pixel-carrying rect with a
+        REPORT_RECT_CRC echo: the hardware CRC unit's checksum of the
+        region as its decoder produced it. send_rect_update records the
+        matching expected value (framecodec.crc32 over the payload it
+        encoded) and the listener compares the two, so a benchmark run
+        doubles as a decoder/DMA correctness test instead of needing a
+        separate readback pass. Consumes no draw slot and no sequence
+        number.
+        """
+        packet = bytearray([config.CMD_VERIFY_MODE, 1 if enable else 0])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        self.verify_mode = enable
+        self.verify_expected.clear()
+
+    def note_rect_crc(self, seq: int, crc: int):
+        """
+        Pairs a device REPORT_RECT_CRC echo with the recorded expected
+        value (listener thread). Sequence numbers with no recorded value
+        are rects whose decoded content the host cannot predict (on-device
+        text rendering, asset draws) and are skipped, not failed.
+        """
+        expected = self.verify_expected.pop(seq, None)
+        if expected is None:
+            return
+        self.verify_checked += 1
+        if crc != expected:
+            self.verify_mismatches += 1
+            print(f"!!! Verify mismatch on seq #{seq}: device "
+                  f"{crc:08X}, expected {expected:08X}")
+
+    def play_animation(self, first_id: int, count: int, x: int, y: int,
+                       period_ms: int):
+        """
+        Starts on-device playback of a run of stored asset frames.
+
+        One CMD_ANIM_PLAY packet and the device cycles the assets
+        first_id..first_id+count-1 from (x, y) at period_ms on its own
+        timing -- a spinner costs zero bus from here on, where streaming
+        its frames cost continuous bandwidth. The frames must all have
+        been confirmed by upload_assets with one shared geometry.
+        count = 0 (see stop_animation) ends playback.
+
+        Args:
+            first_id: Asset id of frame 0; frames occupy consecutive ids.
+            count: Number of frames in the cycle (0 stops).
+            x, y: Top-left corner of the animation on the panel.
+            period_ms: Frame period in milliseconds (device floor 16).
+
+        Raises:
+            OSError: If the bulk write fails, indicating a likely disconnection.
+        """
+        seq_lsb = self.sequence_number & 0xFF
+        seq_msb = (self.sequence_number >> 8) & 0xFF
+        packet = bytearray([config.CMD_ANIM_PLAY, first_id, count, x, y,
+                            period_ms & 0xFF, (period_ms >> 8) & 0xFF,
+                            seq_lsb, seq_msb])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+        if count:
+            shape = self.asset_shapes.get(first_id)
+            if shape is not None:
+                # The device repaints this region on its own schedule, so
+                # the mirror cannot vouch for those pixels from now on.
+                self._invalidate_resident((x, y,
+                                           min(x + shape[0], config.LCD_WIDTH),
+                                           min(y + shape[1], config.LCD_HEIGHT)))
+        self.sequence_number = (self.sequence_number + 1) & 0xFFFF
+
+    def stop_animation(self):
+        """Stops on-device asset animation playback (count = 0)."""
+        self.play_animation(0, 0, 0, 0, 0)
+
+    def request_stats(self):
+        """
+        Asks the firmware for its pipeline instrumentation counters.
+
+        The device answers asynchronously with a REPORT_STATS IN report
+        (handled by the listener thread); this only sends the request.
+        """
+        packet = bytearray([config.CMD_GET_STATS])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+
+    def request_boot_stats(self):
+        """
+        Asks the firmware for its boot-stage timestamps.
+
+        The device retains an mcycle stamp per bring-up stage (USB init,
+        panel init, enumeration complete) and answers with a REPORT_BOOT
+        IN report handled by the listener thread; the stamps show where
+        the time-to-enumeration budget went on the last boot.
+        """
+        packet = bytearray([config.CMD_GET_BOOT])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+
+    def request_build_info(self):
+        """
+        Asks the firmware for its compile-time build identity.
+
+        The device answers with a REPORT_BUILD IN report (handled by the
+        listener thread): a CRC32 fingerprint over the build
+        configuration plus the git revision and profile as text. The
+        fingerprint is what measurement records should be keyed on, so
+        results from different feature sets are never compared as if
+        they came from the same build.
+        """
+        packet = bytearray([config.CMD_GET_BUILD])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._emit(packet)
+
     def close(self):
-        """Closes the connection to the HID device."""
+        """Releases the bulk interface and closes the connection."""
+        if self._capture_file is not None:
+            self._capture_file.close()
+            self._capture_file = None
         if self.device:
-            self.device.close()
+            if getattr(self.device, 'is_virtual', False):
+                self.device.close()
+            else:
+                try:
+                    usb.util.release_interface(self.device, config.DISPLAY_INTERFACE)
+                except usb.core.USBError:
+                    pass  # Already gone; nothing to release.
+                usb.util.dispose_resources(self.device)
             self.device = None
+            with _claimed_lock:
+                _claimed_devices.discard(self.bound_slot)
+            self.bound_serial = None
+            self.bound_slot = None
             print("--- Device Disconnected ---")
 
 
 # --- START OF MODIFICATION ---
 def device_listener(device_manager: DeviceManager, stop_event: threading.Event):
     """
-    Listens for incoming HID reports from the device in a separate thread.
+    Listens for incoming status packets from the device in a separate thread.
 
-    This function runs in a background thread and performs blocking reads on the
-    HID device. This is an efficient way to wait for device-initiated events
+    This function runs in a background thread and performs blocking bulk IN
+    reads. This is an efficient way to wait for device-initiated events
     (like a button press) without consuming CPU cycles in the main loop.
 
     Args:
@@ -188,12 +1728,112 @@ def device_listener(device_manager: DeviceManager, stop_event: threading.Event):
             if device_manager.device:
                 # Use a blocking read with a timeout. This is efficient, as the
                 # thread will sleep until a report arrives or 500ms passes.
-                report = device_manager.device.read(64, timeout_ms=500)
+                report = device_manager._read(64, timeout_ms=500)
                 # Check for the specific report sent by the firmware's USER button press.
-                # report[0] is the Report ID, report[1] is the button state.
-                if report and report[0] == 0x01 and report[1] == 0x01:
+                # report[0] is the report type, report[1] is the button state.
+                if report and report[0] == config.REPORT_BUTTON_EVENT and report[1] == 0x01:
                     print("--- Theme change request received from device ---")
-                    theme_change_requested[0] = True
+                    device_manager.theme_change_requested = True
+                elif report and report[0] == config.REPORT_ENCODER:
+                    delta = report[1] - 256 if report[1] >= 128 else report[1]
+                    device_manager.encoder_delta += delta
+                elif report and report[0] == config.REPORT_SEQ_NACK:
+                    first = report[1] | (report[2] << 8)
+                    last = report[3] | (report[4] << 8)
+                    device_manager.nack_requests.append((first, last))
+                elif report and report[0] == config.REPORT_CREDITS:
+                    device_manager.note_credits(report[1])
+                elif report and report[0] == config.REPORT_RECT_LATENCY:
+                    # Blit-completion echoes (latency probe armed by the
+                    # analyze mode); paired with send timestamps by the
+                    # traffic tap. Dropped when no tap is attached.
+                    if device_manager.traffic_log is not None and len(report) >= 7:
+                        device_manager.traffic_log.note_echo(
+                            report[1] | (report[2] << 8),
+                            int.from_bytes(bytes(report[3:7]), 'little'))
+                elif report and report[0] == config.REPORT_RECT_CRC:
+                    # Decoded-region checksum echoes (verification mode
+                    # armed via set_verify_mode); paired with the expected
+                    # values recorded when the rects went out.
+                    if len(report) >= 7:
+                        device_manager.note_rect_crc(
+                            report[1] | (report[2] << 8),
+                            int.from_bytes(bytes(report[3:7]), 'little'))
+                elif report and report[0] == config.REPORT_STATUS:
+                    device_manager.note_status(report)
+                elif report and report[0] == config.REPORT_BOOT:
+                    count = report[1]
+                    stages = []
+                    for i in range(count):
+                        cycles = int.from_bytes(
+                            bytes(report[2 + i * 4 : 6 + i * 4]), 'little')
+                        name = (config.BOOT_STAGE_NAMES[i]
+                                if i < len(config.BOOT_STAGE_NAMES)
+                                else f"stage {i}")
+                        ms = cycles * 1000 / config.DEVICE_CYCLES_PER_SECOND
+                        stages.append(f"{name} {ms:.1f}ms")
+                    print(f"--- Device boot budget: {', '.join(stages)} ---")
+                elif report and report[0] == config.REPORT_BUILD:
+                    fingerprint = int.from_bytes(bytes(report[1:5]), 'little')
+                    count = report[5]
+                    text = bytes(report[6:6 + count]).decode(
+                        'ascii', errors='replace')
+                    device_manager.build_info = (fingerprint, text)
+                    print(f"--- Device build: {text} "
+                          f"(fingerprint 0x{fingerprint:08X}) ---")
+                elif report and report[0] == config.REPORT_STATS:
+                    packets, dropped, rects, busy, last_draw = (
+                        int.from_bytes(bytes(report[1 + i * 4 : 5 + i * 4]), 'little')
+                        for i in range(5))
+                    # Sixth counter (integrity CRC failures) only exists on
+                    # firmware that advertises caps flag bit4; the seventh
+                    # (MSC writes skipped as byte-identical) on newer
+                    # firmware still.
+                    crc_note = ""
+                    if len(report) >= 25:
+                        crc_fails = int.from_bytes(bytes(report[21:25]), 'little')
+                        crc_note = f", {crc_fails} CRC failures"
+                    skip_note = ""
+                    if len(report) >= 29:
+                        skips = int.from_bytes(bytes(report[25:29]), 'little')
+                        skip_note = f", {skips} writes skipped"
+                    # Eighth counter: ring-occupancy high water, for tuning
+                    # the device's slot-ring geometry (DISPLAY_NUM_BUFFERS).
+                    peak_note = ""
+                    if len(report) >= 33:
+                        peak = int.from_bytes(bytes(report[29:33]), 'little')
+                        peak_note = f", peak {peak} slots"
+                    # Counters 9-12: SD command-level health (issues,
+                    # retries, timeouts, busy-wait cycles). Deltas that
+                    # climb session over session mean a dying card.
+                    sd_note = ""
+                    if len(report) >= 49:
+                        cmds, retries, touts, busy_cyc = (
+                            int.from_bytes(bytes(report[33 + i * 4 : 37 + i * 4]),
+                                           'little')
+                            for i in range(4))
+                        if cmds:
+                            busy_ms = (busy_cyc * 1000
+                                       // config.DEVICE_CYCLES_PER_SECOND)
+                            sd_note = (f"; SD {cmds} cmds, {retries} retries, "
+                                       f"{touts} timeouts, {busy_ms}ms busy")
+                    # Counters 13-15: USB NAK pressure (poll intervals
+                    # spent NAKing the MSC IN/OUT endpoints, and MSC
+                    # re-arms withheld during card stalls). Rising OUT
+                    # NAKs with deferrals mean the card paces copies.
+                    nak_note = ""
+                    if len(report) >= 61:
+                        nak_in, nak_out, deferrals = (
+                            int.from_bytes(bytes(report[49 + i * 4 : 53 + i * 4]),
+                                           'little')
+                            for i in range(3))
+                        if nak_in or nak_out or deferrals:
+                            nak_note = (f"; NAK polls {nak_in} in/{nak_out} out, "
+                                        f"{deferrals} stall deferrals")
+                    print(f"--- Device stats: {packets} packets, {dropped} dropped "
+                          f"(slots busy), {rects} rects drawn, {busy} cycles DMA "
+                          f"busy, last rect {last_draw} cycles{crc_note}"
+                          f"{skip_note}{peak_note}{sd_note}{nak_note} ---")
             else:
                 # If the device is not connected, wait a bit before checking again.
                 time.sleep(1)
@@ -205,117 +1845,530 @@ def device_listener(device_manager: DeviceManager, stop_event: threading.Event):
 # --- END OF MODIFICATION ---
 
 
-def main():
+def encode_worker(device_manager: DeviceManager, render_queue: queue.Queue,
+                  stop_event: threading.Event):
+    """
+    Pipeline stage 2: turns rendered frames into wire bursts.
+
+    Consumes jobs queued by the render stage (the main loop) and runs all
+    DeviceManager protocol logic -- payload encoding, sequence numbers,
+    palette and send-history state -- on this one thread, so none of that
+    state needs locking. Finished bursts leave through tx_queue to the
+    transmit stage.
+
+    Jobs:
+        ('rects', frame, rects)          encode and queue the given rects
+        ('asset', id, x, y)              blit a flash-stored asset
+        ('resend', frame, first, last)   replay a NACKed sequence range
+    """
+    while not stop_event.is_set():
+        try:
+            job = render_queue.get(timeout=0.5)
+        except queue.Empty:
+            continue
+        try:
+            if job[0] == 'rects':
+                _, frame, rects = job
+                device_manager.send_rect_updates(frame, rects)
+            elif job[0] == 'asset':
+                _, asset_id, x, y = job
+                device_manager.draw_asset(asset_id, x, y)
+            elif job[0] == 'resend':
+                _, frame, first, last = job
+                if not device_manager.resend_lost_range(frame, first, last):
+                    device_manager.full_redraw_requested = True
+        except OSError as e:
+            if device_manager.pipeline_error is None:
+                device_manager.pipeline_error = e
+        finally:
+            render_queue.task_done()
+
+
+def transmit_worker(device_manager: DeviceManager, tx_queue: queue.Queue,
+                    stop_event: threading.Event):
+    """
+    Pipeline stage 3: writes finished bursts to the bulk OUT endpoint.
+
+    The only thread that performs OUT transfers, so bursts hit the wire in
+    exactly the order they were encoded. Blocking in device.write() here is
+    the point: the encode and render stages keep working through it. Errors
+    are parked in pipeline_error for the main loop, and the queue keeps
+    draining so upstream stages never deadlock against a dead device.
+
+    Bursts that are already waiting when a write completes are chained
+    into the next submission (up to TX_COALESCE_LIMIT_BYTES), so the
+    controller streams their packets as one transfer with no inter-burst
+    gap. This is the ordering-safe stand-in for queued asynchronous URBs:
+    pyusb only offers synchronous writes, and a thread pool would let
+    sequence-numbered packets overtake each other on the endpoint.
+    Credits were taken per packet at encode time, so chaining changes
+    nothing the device-side flow control can see.
+    """
+    while not stop_event.is_set():
+        try:
+            burst = tx_queue.get(timeout=0.5)
+        except queue.Empty:
+            continue
+        taken = 1
+        chain = bytearray(burst)
+        while len(chain) < config.TX_COALESCE_LIMIT_BYTES:
+            try:
+                chain.extend(tx_queue.get_nowait())
+            except queue.Empty:
+                break
+            taken += 1
+        try:
+            if device_manager.pipeline_error is None:
+                device_manager._write(chain)
+        except OSError as e:
+            if device_manager.pipeline_error is None:
+                device_manager.pipeline_error = e
+        finally:
+            for _ in range(taken):
+                tx_queue.task_done()
+
+
+class PanelPipeline:
+    """
+    Everything one connected panel owns.
+
+    Multi-panel deployments drive several identical dashboards from one
+    process: the UI is rendered once per tick (that is the expensive
+    part) and each panel diffs and transmits it independently, because
+    what a panel is resident with depends on when it connected and what
+    it has acknowledged. Each instance bundles a panel's DeviceManager,
+    tile differ, quality governor, the listener/encode/transmit threads,
+    and the per-panel tick state (background asset, idle tracking, stats
+    polling) that used to live as locals in main().
+    """
+
+    def __init__(self, serial: str = None):
+        self.manager = DeviceManager(serial=serial)
+        self.tile_differ = TileDiffer()
+        self.governor = FrameGovernor(self.manager, self.tile_differ)
+        self.scheduler = RectScheduler()
+        self.stop_event = threading.Event()
+        self.threads = []
+        self.render_queue = None
+        self.previous_frame = None
+        self.bg_version = None
+        self.bg_frame = None
+        self.last_stats_request = 0.0
+        self.last_change_time = 0.0
+        self.idle_hinted = False
+        self.last_heartbeat = 0.0
+
+    def start(self) -> bool:
+        """Connects the panel and spins up its pipeline threads."""
+        if not self.manager.connect():
+            return False
+        try:
+            # Make the current theme's background resident in the panel's
+            # flash asset store (synchronous; the listener thread does not
+            # exist yet). Usually the versions already match and this is
+            # one report round-trip; thereafter every full redraw opens
+            # with a 6-byte DRAW_ASSET instead of streaming 25 KB.
+            self.bg_version, bg_image = ui_generator.background_asset()
+            self.bg_frame = rgb565_frame(bg_image)
+            if not self.manager.upload_assets(
+                    {config.ASSET_ID_BACKGROUND: (self.bg_version, self.bg_frame)}):
+                self.bg_frame = None
+        except OSError:
+            self.manager.close()
+            return False
+
+        self.stop_event.clear()
+        self.manager.theme_change_requested = False
+        self.manager.pipeline_error = None
+        self.manager.full_redraw_requested = False
+        self.manager.nack_requests.clear()
+        self.render_queue = queue.Queue(maxsize=2)
+        tx_queue = queue.Queue(maxsize=8)
+        self.manager.tx_queue = tx_queue
+        self.threads = [
+            threading.Thread(target=device_listener,
+                             args=(self.manager, self.stop_event), daemon=True),
+            threading.Thread(target=encode_worker,
+                             args=(self.manager, self.render_queue, self.stop_event),
+                             daemon=True),
+            threading.Thread(target=transmit_worker,
+                             args=(self.manager, tx_queue, self.stop_event),
+                             daemon=True),
+        ]
+        for thread in self.threads:
+            thread.start()
+
+        # One-shot per session: ask where the firmware's boot budget
+        # went and which build is running (the listener prints both
+        # replies). Old firmware ignores the requests.
+        self.manager.request_boot_stats()
+        self.manager.request_build_info()
+
+        self.governor.reset()
+        self.scheduler = RectScheduler()
+        self.previous_frame = None
+        self.last_stats_request = time.time()
+        self.last_change_time = time.time()
+        self.idle_hinted = False
+        self.last_heartbeat = 0.0
+        return True
+
+    def stop(self):
+        """Stops the pipeline threads and releases the device."""
+        self.stop_event.set()
+        for thread in self.threads:
+            thread.join(timeout=1)
+        self.threads = []
+        self.manager.tx_queue = None
+        self.manager.close()
+
+    def service_events(self) -> int:
+        """
+        Drains this panel's mailboxes at the top of a tick.
+
+        Raises the first pipeline-thread error (and disconnection) as
+        OSError so the caller runs the per-panel teardown path; hands
+        NACKed ranges to the encode stage; polls the stats counters on
+        its interval. Returns the panel's net theme step: +1 per USER
+        button press plus the accumulated rotary detents (a whole
+        encoder burst arrives as one REPORT_ENCODER record, so a fast
+        spin scrubs the theme list in one jump). The theme is shared,
+        so main() applies the combined step to every panel.
+        """
+        theme = int(self.manager.theme_change_requested)
+        self.manager.theme_change_requested = False
+        theme += self.manager.encoder_delta
+        self.manager.encoder_delta = 0
+
+        if not self.manager.device:
+            raise OSError("Device disconnected")
+        if self.manager.pipeline_error is not None:
+            raise self.manager.pipeline_error
+        if self.manager.full_redraw_requested:
+            self.manager.full_redraw_requested = False
+            self.previous_frame = None
+
+        # Hand lost ranges to the encode stage, which replays them from
+        # its send history; it requests a full redraw when they have
+        # already been pruned.
+        while self.manager.nack_requests:
+            first, last = self.manager.nack_requests.pop(0)
+            print(f"--- Device NACK: seq {first}..{last} lost, retransmitting ---")
+            if self.previous_frame is None:
+                self.manager.nack_requests.clear()
+            else:
+                self.render_queue.put(('resend', self.previous_frame, first, last))
+
+        # Periodically poll the firmware's pipeline counters; the
+        # listener thread prints the reply. Skipped while idle-parked:
+        # the request itself would unpark the device for nothing.
+        if (config.STATS_REQUEST_INTERVAL_SECONDS and not self.idle_hinted and
+                (time.time() - self.last_stats_request)
+                > config.STATS_REQUEST_INTERVAL_SECONDS):
+            self.manager.request_stats()
+            self.last_stats_request = time.time()
+        return theme
+
+    def push_idle(self):
+        """
+        Quiet tick: after a stretch with no UI change, park the panel's
+        pipeline and keep the link warm with a periodic heartbeat. The
+        dirty tick that ends the stretch unparks it with its own updates.
+        """
+        # A quiet tick has bandwidth to spare: flush anything the
+        # scheduler was still holding back before parking the panel.
+        if self.previous_frame is not None:
+            for batch in self.scheduler.schedule([], False):
+                self.render_queue.put(('rects', self.previous_frame, batch))
+
+        now_s = time.time()
+        if now_s - self.last_change_time > config.IDLE_AFTER_SECONDS:
+            if (not self.idle_hinted or (now_s - self.last_heartbeat)
+                    > config.IDLE_HEARTBEAT_SECONDS):
+                self.manager.send_idle_hint(True)
+                self.idle_hinted = True
+                self.last_heartbeat = now_s
+
+    def push_frame(self, new_frame: np.ndarray):
+        """
+        Diffs the shared rendered frame against this panel's state and
+        queues the resulting updates to its encode stage.
+        """
+        self.last_change_time = time.time()
+        self.idle_hinted = False
+
+        if self.previous_frame is None:
+            self.tile_differ.reset()
+            # With the background resident in device flash (and still
+            # matching the theme -- a mid-session theme cycle falls back
+            # to streaming), open with a blit from the store and send
+            # only the widget pixels drawn over it.
+            if (self.bg_frame is not None and
+                    ui_generator.background_asset()[0] == self.bg_version):
+                print("\n--- Background from asset store; sending widgets ---")
+                self.tile_differ.dirty_rects(self.bg_frame)  # Prime with the background.
+                self.render_queue.put(('asset', config.ASSET_ID_BACKGROUND, 0, 0))
+                for batch in self.scheduler.schedule(
+                        self.tile_differ.dirty_rects(new_frame), False):
+                    self.render_queue.put(('rects', new_frame, batch))
+            else:
+                print("\n--- Sending Full Initial Image ---")
+                self.tile_differ.dirty_rects(new_frame)  # Prime the stored frame.
+                self.render_queue.put(('rects', new_frame,
+                                       [(0, 0, config.LCD_WIDTH, config.LCD_HEIGHT)]))
+        else:
+            # Tighten the widget-reported regions to the pixels that
+            # actually changed, then merge what clusters and queue the
+            # result interactive-first (one encode job per priority
+            # class; decorative work may be held while congested).
+            for batch in self.scheduler.schedule(
+                    self.tile_differ.dirty_rects(new_frame),
+                    self.governor.level > 0):
+                self.render_queue.put(('rects', new_frame, batch))
+
+        self.previous_frame = new_frame
+        # Fold this tick's congestion signals into the quality level.
+        self.governor.tick()
+
+
+def main(analyze_seconds: float = None, analyze: bool = False):
     """
     Main execution function.
 
-    Sets up the device manager and listener thread, then enters a main loop
-    to handle UI updates, data fetching, and device disconnections.
+    Renders the shared dashboard UI once per tick and fans it out to
+    every connected panel, each behind its own pipeline threads. Panels
+    are discovered by USB serial string and come and go independently:
+    one panel disconnecting tears down only its own pipeline while the
+    rest keep streaming.
+
+    In analyze mode (`display_manager.py analyze [seconds]`) every
+    panel gets a traffic tap and the firmware's latency probe is armed;
+    the per-category bandwidth/latency breakdown prints when the
+    duration elapses or on Ctrl-C (see traffic_analyzer.py).
     """
+    if analyze:
+        import traffic_analyzer  # Deferred: it imports this module.
+    taps = {}  # panel key -> TrafficLog
     if os.path.exists(config.STATE_IMAGE_PATH):
         os.remove(config.STATE_IMAGE_PATH)
 
-    manager = DeviceManager()
-    
-    # --- START OF MODIFICATION ---
-    stop_event = threading.Event()
-    listener_thread = None
-    # --- END OF MODIFICATION ---
+    ui_renderer = ui_generator.UiRenderer()
+
+    # Weather is fetched on its own thread so the render path never waits
+    # on the network; the loop below only reads the cached snapshot.
+    weather_service = weather.WeatherService(
+        config.LOCATION_LAT, config.LOCATION_LON,
+        refresh_seconds=config.WEATHER_UPDATE_INTERVAL_SECONDS)
+    weather_service.start()
+
+    panels = {}  # serial (or synthetic key) -> PanelPipeline
+    next_probe = 0.0
 
     try:
-        # This outer loop handles device connection and reconnection.
         while True:
-            try:
-                # 1. Connect to the device. If not found, sleep and retry.
-                if not manager.connect():
-                    time.sleep(2)
-                    continue
-
-                # 2. Start the listener thread once the device is connected.
-                if not listener_thread or not listener_thread.is_alive():
-                    stop_event.clear()
-                    theme_change_requested[0] = False
-                    listener_thread = threading.Thread(
-                        target=device_listener,
-                        args=(manager, stop_event),
-                        daemon=True  # Allows main program to exit even if thread is running
-                    )
-                    listener_thread.start()
-
-                # 3. Reset state for a fresh start after connection.
-                previous_image = None
-                previous_time_string = ""
-                current_weather = None
-                last_weather_check = 0
-
-                # 4. Inner loop for continuous display updates.
+            # --- Discovery / reconnection ---
+            # Periodically claim every unclaimed device in the slot. A
+            # panel that was torn down below reappears here on its next
+            # enumeration, serial and all.
+            if (analyze_seconds is not None and taps
+                    and time.perf_counter() - min(t.started for t in
+                                                  taps.values())
+                        > analyze_seconds):
+                break
+            now_s = time.time()
+            if now_s >= next_probe:
+                next_probe = now_s + 2.0
                 while True:
-                    # --- Event Handling ---
-                    # Check if the listener thread has requested a theme change.
-                    if theme_change_requested[0]:
-                        config.cycle_theme()
-                        previous_image = None  # Force a full redraw on the next iteration
-                        theme_change_requested[0] = False # Reset the flag
-                    
-                    # If the device has disconnected, break to the outer loop to reconnect.
-                    if not manager.device:
-                        raise OSError("Device disconnected")
-
-                    # --- Data Fetching ---
-                    # Fetch weather data at the specified interval.
-                    if (time.time() - last_weather_check) > config.WEATHER_UPDATE_INTERVAL_SECONDS:
-                        current_weather = weather.get_weather(config.LOCATION_LAT, config.LOCATION_LON)
-                        last_weather_check = time.time()
-                    
-                    now = datetime.now()
-                    time_string = now.strftime("%H:%M")
-                    
-                    # --- UI Generation and Diffing ---
-                    # Optimization: Only redraw the screen if the time has changed
-                    # or a full redraw has been forced (previous_image is None).
-                    if time_string == previous_time_string and previous_image is not None:
-                        time.sleep(1) # Check again in one second.
-                        continue
+                    panel = PanelPipeline()
+                    if not panel.start():
+                        break
+                    # Prefer the serial string as the panel's name; fall
+                    # back to bus:address when units share the default
+                    # serial from a common firmware image.
+                    serial = panel.manager.bound_serial
+                    if serial and serial not in panels:
+                        key = serial
+                    else:
+                        key = "%s:%s" % panel.manager.bound_slot
+                    panels[key] = panel
+                    if analyze:
+                        taps[key] = traffic_analyzer.attach(panel.manager)
+                        # Close the loop on correctness too: the run's
+                        # rects come back as decoded-region CRC echoes
+                        # and any decoder regression fails loudly in the
+                        # summary instead of passing as a fast garbage
+                        # stream.
+                        panel.manager.set_verify_mode(True)
+                    print(f"--- Panel {key} online "
+                          f"({len(panels)} streaming) ---")
 
-                    # Generate the new UI image.
-                    date_string = now.strftime("%a %b %d")
-                    new_image = ui_generator.create_image(time_string, date_string, current_weather)
+            if not panels:
+                time.sleep(2)
+                continue
 
-                    # Determine update type: full or partial.
-                    if not previous_image:
-                        print("\n--- Sending Full Initial Image ---")
-                        manager.send_rect_update(new_image, (0, 0, config.LCD_WIDTH, config.LCD_HEIGHT))
-                    else:
-                        # Find the difference between the old and new images.
-                        diff = ImageChops.difference(previous_image, new_image)
-                        bbox = diff.getbbox()
-                        if bbox:
-                            manager.send_rect_update(new_image, bbox)
-
-                    # Save the new image as the state for the next comparison.
-                    new_image.save(config.STATE_IMAGE_PATH)
-                    previous_image = new_image
-                    previous_time_string = time_string
-                    # Wait a short time before checking for updates again.
-                    time.sleep(1)
-
-            except OSError as e:
-                print(f"\nDevice error or disconnection: {e}")
-                if listener_thread:
-                    stop_event.set() # Signal the listener thread to stop
-                    listener_thread.join(timeout=1) # Wait for it to exit
-                manager.close()
-                print("Attempting to reconnect in 3 seconds...")
-                time.sleep(3)
+            # --- Per-panel event handling ---
+            theme_step = 0
+            for key in list(panels):
+                try:
+                    theme_step += panels[key].service_events()
+                except OSError as e:
+                    print(f"\nPanel {key} error or disconnection: {e}")
+                    panels[key].stop()
+                    del panels[key]
+            if not panels:
+                continue
+            if theme_step:
+                # The theme is process-wide state; every panel redraws.
+                config.cycle_theme(theme_step)
+                for panel in panels.values():
+                    panel.previous_frame = None
+
+            # --- Data Fetching ---
+            # Read the background service's cached snapshot; never
+            # blocks, and a change flows into the weather widget.
+            current_weather = weather_service.current()
+
+            now = datetime.now()
+            time_string = now.strftime("%H:%M")
+            date_string = now.strftime("%a %b %d")
+
+            # --- UI Generation (shared across panels) ---
+            # The renderer tracks per-widget state itself: a tick where
+            # no widget changed does no PIL work and reports no dirty
+            # regions. A panel needing its first (or a full) frame
+            # forces a complete render regardless.
+            need_full = any(p.previous_frame is None for p in panels.values())
+            if need_full:
+                ui_renderer.invalidate()
+            new_image, ui_dirty = ui_renderer.render(
+                time_string, date_string, current_weather)
+            if not ui_dirty and not need_full:
+                for panel in panels.values():
+                    panel.push_idle()
+                time.sleep(1)  # Check again in one second.
+                continue
+
+            new_frame = rgb565_frame(new_image)
+            for panel in panels.values():
+                panel.push_frame(new_frame)
+
+            # Save the new image as the state for the next comparison.
+            new_image.save(config.STATE_IMAGE_PATH)
+            # The tick is shared, so the most congested panel sets it:
+            # slowing everyone beats letting one panel's latency build.
+            time.sleep(max(p.governor.tick_seconds()
+                           for p in panels.values()))
 
     except KeyboardInterrupt:
         print("\nExiting.")
     finally:
         # Ensure resources are cleaned up on exit.
-        if listener_thread:
-            stop_event.set()
-        if manager:
-            manager.close()
+        weather_service.stop()
+        for key, panel in panels.items():
+            m = panel.manager
+            if m.verify_checked or m.verify_mismatches:
+                tag = f" ({key})" if len(panels) > 1 else ""
+                verdict = (f"{m.verify_mismatches} MISMATCHES"
+                           if m.verify_mismatches else "all matched")
+                print(f"--- Verify{tag}: {m.verify_checked} rects "
+                      f"checked, {verdict} ---")
+        for panel in panels.values():
+            panel.stop()
+        for key, tap in taps.items():
+            tap.print_report(f" ({key})" if len(taps) > 1 else "")
+
+def _bench_percentiles(samples_ms: list) -> tuple:
+    """Returns (p50, p90, p99) from a list of latency samples in ms."""
+    ordered = sorted(samples_ms)
+    def pct(p):
+        return ordered[min(len(ordered) - 1, int(len(ordered) * p))]
+    return pct(0.50), pct(0.90), pct(0.99)
+
+
+def benchmark_main(duration_packets: int = 8192, echo_rounds: int = 200):
+    """
+    Measures what the USB transport actually sustains.
+
+    Requires firmware built with -DUSB_BENCH_MODE=1. Three phases:
+    1. Echo round trips for command latency percentiles (includes one
+       firmware main-loop pass, i.e. realistic command turnaround).
+    2. Sink mode: the device swallows and counts OUT packets with no
+       display processing, measuring raw host-to-device throughput.
+    3. Source mode: the device streams pattern packets from its data-IN
+       ISR, measuring raw device-to-host throughput.
+    """
+    manager = DeviceManager()
+    while not manager.connect():
+        time.sleep(1)
+    try:
+        # --- Phase 1: round-trip latency ---
+        samples = []
+        for i in range(echo_rounds):
+            packet = bytearray([config.CMD_BENCH, config.BENCH_ECHO, i & 0xFF])
+            packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+            t0 = time.perf_counter()
+            manager._write(packet)
+            while True:
+                report = manager._read(64, timeout_ms=1000)
+                if not report:
+                    raise OSError("Echo reply timed out; is the firmware "
+                                  "built with -DUSB_BENCH_MODE=1?")
+                if report[0] == config.CMD_BENCH and report[1] == config.BENCH_ECHO:
+                    break
+            samples.append((time.perf_counter() - t0) * 1000.0)
+        p50, p90, p99 = _bench_percentiles(samples)
+        print(f"Latency ({echo_rounds} echoes): "
+              f"p50={p50:.2f}ms p90={p90:.2f}ms p99={p99:.2f}ms")
+
+        # --- Phase 2: host -> device throughput ---
+        count = duration_packets
+        packet = bytearray([config.CMD_BENCH, config.BENCH_SINK])
+        packet.extend(count.to_bytes(4, 'little'))
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+        burst = bytes(config.REPORT_LENGTH) * 256  # 16 KiB per bulk write
+        t0 = time.perf_counter()
+        sent = 0
+        while sent < count:
+            n = min(256, count - sent)
+            manager._write(burst[:n * config.REPORT_LENGTH])
+            sent += n
+        while True:
+            report = manager._read(64, timeout_ms=2000)
+            if report and report[0] == config.CMD_BENCH and report[1] == config.BENCH_SINK:
+                received = int.from_bytes(bytes(report[2:6]), 'little')
+                break
+        elapsed = time.perf_counter() - t0
+        mb = (count * config.REPORT_LENGTH) / (1024.0 * 1024.0)
+        print(f"OUT: {mb:.2f} MiB in {elapsed:.2f}s = {mb / elapsed:.3f} MiB/s "
+              f"(device counted {received}/{count} packets)")
+
+        # --- Phase 3: device -> host throughput ---
+        packet = bytearray([config.CMD_BENCH, config.BENCH_SOURCE])
+        packet.extend(count.to_bytes(4, 'little'))
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+        t0 = time.perf_counter()
+        remaining = count * config.REPORT_LENGTH
+        while remaining > 0:
+            data = manager._read(min(remaining, 16384), timeout_ms=2000)
+            if not data:
+                raise OSError("Source stream stalled.")
+            remaining -= len(data)
+        elapsed = time.perf_counter() - t0
+        print(f"IN:  {mb:.2f} MiB in {elapsed:.2f}s = {mb / elapsed:.3f} MiB/s")
+    finally:
+        manager.close()
+
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    if len(sys.argv) > 1 and sys.argv[1] == "benchmark":
+        benchmark_main()
+    elif len(sys.argv) > 1 and sys.argv[1] == "analyze":
+        main(analyze=True,
+             analyze_seconds=float(sys.argv[2]) if len(sys.argv) > 2 else None)
+    elif len(sys.argv) > 1 and sys.argv[1] == "virtual":
+        config.VIRTUAL_DEVICE = True
+        main()
+    else:
+        main()
\ No newline at end of file
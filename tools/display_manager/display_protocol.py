@@ -0,0 +1,255 @@
+"""
+Generated by bldmgr/protogen.py from prj_usb_composite/protocol.py - DO NOT EDIT.
+Every id, flag bit and shared size of the host <-> device display
+protocol is defined once in the description and rendered into both
+this file and its counterpart on the other side of the link.
+"""
+
+# Shared wire geometry.
+REPORT_LENGTH = 64
+LCD_WIDTH = 160
+LCD_HEIGHT = 80
+# Largest cursor/overlay bitmap the device stages (CAPS_OVERLAY).
+OVERLAY_MAX_W = 16
+OVERLAY_MAX_H = 16
+
+# Host -> device commands (first byte of a bulk OUT packet).
+CMD_IMAGE_DATA = 0x02
+CMD_IMAGE_DATA_RLE = 0x03
+# [CMD, x, y, w, h, seq_lsb, seq_msb, encoding, (len_lsb, len_msb),
+# (flags), (crc32 LE)]; optional fields are negotiated via GET_CAPS
+# flag bits. Payload follows in REPORT_LENGTH packets.
+CMD_DRAW_RECT = 0x06
+CMD_FILL_RECT = 0x07
+CMD_DRAW_TEXT = 0x08
+# Answered with a REPORT_STATS IN report of u32 LE pipeline counters.
+CMD_GET_STATS = 0x09
+# Loads the 256-entry RGB565 palette ENC_INDEXED streams index into.
+CMD_SET_PALETTE = 0x0A
+CMD_IMAGE_DATA_IDX = 0x0B
+# Binary trace-ring readout (tools/decode_trace.py). USB_BENCH_MODE=1
+# builds repurpose this id as CMD_BENCH; the two never coexist.
+CMD_GET_TRACE = 0x0C
+# [CMD, count, seq_lsb, seq_msb] plus count 6-byte rect records.
+CMD_MULTI_FILL = 0x0D
+CMD_LATENCY_PROBE = 0x0E
+CMD_GET_CRASH = 0x0F
+# Capability handshake; answered with a REPORT_CAPS IN report.
+CMD_GET_CAPS = 0x10
+# Hardware scroll (ST7735S scroll registers): [CMD, x, w, offset,
+# seq_lsb, seq_msb] shifts the displayed window without touching
+# frame memory.
+CMD_SET_SCROLL = 0x11
+# Flash asset store directory/progress; answered with REPORT_ASSETS.
+CMD_GET_ASSETS = 0x12
+# [CMD, flags(bit0=wipe), id, ver_lsb, ver_msb, w, h]
+CMD_ASSET_BEGIN = 0x13
+# [CMD, count, payload...]
+CMD_ASSET_DATA = 0x14
+# [CMD, id, x, y, seq_lsb, seq_msb]
+CMD_DRAW_ASSET = 0x15
+# [CMD, idle]: parks/unparks the device pipeline between updates.
+CMD_IDLE_HINT = 0x16
+# Display lists (CAPS_DISPLAY_LISTS): slot-consuming commands until
+# LIST_COMMIT are held on the device and released as one atomic batch.
+CMD_LIST_BEGIN = 0x17
+CMD_LIST_COMMIT = 0x18
+# Boot-stage mcycle timestamps; answered with a REPORT_BOOT IN report.
+CMD_GET_BOOT = 0x19
+# [CMD, w, h, key_lsb, key_msb] followed by w*h RGB565 pixels in
+# headerless REPORT_LENGTH packets (CAPS_OVERLAY builds). Pixels
+# equal to the key color are transparent; w = 0 drops the plane.
+CMD_OVERLAY_SET = 0x1A
+# [CMD, x, y, visible, seq_lsb, seq_msb]: moves/hides the overlay
+# plane; the device restores the pixels underneath itself.
+CMD_OVERLAY_POS = 0x1B
+# [CMD, count, count text bytes]: keystrokes for the runtime
+# tuning console (lib/shell); output returns as REPORT_CONSOLE
+# packets. See tools/display_manager/console.py.
+CMD_CONSOLE = 0x1C
+# Firmware image identity and delta-update progress; answered
+# with a REPORT_FW_INFO IN report. The image CRC it carries is
+# what a delta patch declares as its base.
+CMD_GET_FWINFO = 0x1D
+# [CMD, base_crc (u32 LE), target_crc (u32 LE)]: opens a delta
+# update (tools/display_manager/fw_update.py). Refused (state
+# FW_STATE_BASE_MISMATCH) unless base_crc matches the running
+# image, so a diff can never land on the wrong version.
+CMD_FW_BEGIN = 0x1E
+# [CMD, count, payload...]: delta-stream bytes, a concatenation
+# of [offset u32 LE, len u16 LE, len bytes] records sorted by
+# offset. Offsets are from the flash base; only touched pages
+# are erased and reprogrammed.
+CMD_FW_DATA = 0x1F
+# Flushes the last patched page and verifies the whole image
+# against target_crc; the result lands in GET_FWINFO's state.
+CMD_FW_APPLY = 0x20
+# Build identity embedded at compile time (generated buildinfo.h);
+# answered with a REPORT_BUILD IN report.
+CMD_GET_BUILD = 0x21
+# [CMD, first_id, count, x, y, period_lsb, period_msb, seq_lsb,
+# seq_msb]: cycle the stored assets first_id..first_id+count-1 at
+# the given period (ms, floor 16) from (x, y), on-device, until a
+# count of 0 stops playback. Frames must share one geometry and
+# all exist (uploaded via ASSET_BEGIN/ASSET_DATA); a wiped store
+# ends playback on its own. A spinner thus costs zero bus after
+# its one-time upload instead of a continuous frame stream.
+CMD_ANIM_PLAY = 0x22
+# [CMD, enable]: golden-image verification for regression rigs.
+# While enabled, every pixel-carrying rect is checksummed on the
+# hardware CRC unit over its decoded region once decode completes
+# (the integrity trailer covers the encoded wire bytes; this
+# covers what the decoder actually produced) and echoed as a
+# REPORT_RECT_CRC record, so a throughput run doubles as a
+# correctness test. Fills and asset blits have no decode step
+# and are skipped. Costs CRC time per rect; off outside rigs.
+CMD_VERIFY_MODE = 0x23
+
+# Device -> host status reports (first byte of a bulk IN packet).
+REPORT_BUTTON_EVENT = 0x01
+# [0x02, first_lsb, first_msb, last_lsb, last_msb]: resend range.
+REPORT_SEQ_NACK = 0x02
+# u32 LE pipeline counters in PipelineStats order.
+REPORT_STATS = 0x03
+# [0x05, seq_lsb, seq_msb, cycles (u32 LE)], sent when the rect's
+# blit reaches the panel (see latency_probe.py).
+REPORT_RECT_LATENCY = 0x05
+# [0x07, version, width, height, num_buffers, buffer_size (u16 LE),
+# full_frame_bytes (u32 LE), flags, pixel_format]. Flag bits are the
+# CAPS_* masks; pixel_format names the device's native wire format.
+REPORT_CAPS = 0x07
+# [0x08, free_slots, total_slots], sent whenever draw-slot occupancy
+# changes; the host stops slot-consuming commands at zero credits.
+REPORT_CREDITS = 0x08
+# [0x09, state, bytes_received (u32 LE), count, count * (id, ver_lsb,
+# ver_msb)]. state is one of the ASSET_STATE_* values.
+REPORT_ASSETS = 0x09
+# [0x0A, count, count * u32 LE], absolute mcycle offsets from reset.
+REPORT_BOOT = 0x0A
+# SOF-paced status push (CAPS_STATUS_PUSH): [0x0B, free_slots,
+# total_slots, health_tripped, rects_drawn (u16 LE), slots_dropped
+# (u16 LE), draw_cycles_last (u32 LE), supply_mv (u16 LE),
+# die_temp (i16 LE, tenths of a degC)], sent every few frames while
+# the pipeline is unparked, so flow control and latency tracking
+# ride on fresh device state instead of polling round trips. The
+# telemetry tail comes from the free-running ADC scan (src/telemetry.h)
+# and is zero until the first heartbeat fold after boot.
+REPORT_STATUS = 0x0B
+# [0x0C, count, count text bytes]: console output, drained from
+# the shell's TX ring at IN-report pace.
+REPORT_CONSOLE = 0x0C
+# [0x0D, state, pages_written (u16 LE), bytes_received (u32 LE),
+# image_crc (u32 LE), image_len (u32 LE)]. state is one of the
+# FW_STATE_* values; image_crc is zlib CRC32 over the whole code
+# flash region. The host paces FW_DATA against bytes_received,
+# exactly as asset uploads pace against REPORT_ASSETS.
+REPORT_FW_INFO = 0x0D
+# [0x0E, fingerprint (u32 LE), count, count text bytes], where the
+# text is "<git revision> <profile>" from the generated
+# buildinfo.h. The fingerprint is a CRC32 over the build
+# configuration (profile, feature defines, component set), so host
+# tools can match stored benchmark results to the configuration
+# that produced them without parsing the text.
+REPORT_BUILD = 0x0E
+# [0x0F, delta (i8)]: net rotary detents since the previous report,
+# positive clockwise. The firmware's input drain coalesces a fast
+# spin into one report (ENCODER_HID_DELTA builds) instead of a
+# consumer-key press/release pair per detent.
+REPORT_ENCODER = 0x0F
+# [0x10, seq_lsb, seq_msb, crc32 (u32 LE)], sent per completed
+# pixel-carrying rect while VERIFY_MODE is armed. The CRC is the
+# hardware-unit variant (see framecodec.crc32) over the decoded
+# region pixels, little-endian RGB565 in row-major order, so the
+# host compares it against the pre-encoding payload it sent.
+REPORT_RECT_CRC = 0x10
+
+# GET_CAPS reply flag masks.
+CAPS_VERSION = 1
+# DRAW_RECT may announce the encoded length; payload packets then
+# go headerless.
+CAPS_SINGLE_HEADER = 0x01
+# Whole-frame-resident build; a rect may span the frame.
+CAPS_FULL_FRAME = 0x02
+# ENC_DELTA streams are patched against the resident frame.
+CAPS_DELTA = 0x04
+# LIST_BEGIN/LIST_COMMIT batch commits.
+CAPS_DISPLAY_LISTS = 0x08
+# DRAW_RECT CRC32 trailer, verified on the hardware CRC unit;
+# mismatches join the NACK path.
+CAPS_INTEGRITY_CRC = 0x10
+# Pixel-doubled rects (RECT_FLAG_SCALE2X): quarter-resolution
+# payload expands 2x2 on reception.
+CAPS_PIXEL_DOUBLE = 0x20
+# Unsolicited REPORT_STATUS records, SOF-paced; the host may stop
+# polling GET_STATS for flow-control purposes.
+CAPS_STATUS_PUSH = 0x40
+# Device-composited cursor plane (OVERLAY_SET/OVERLAY_POS). Needs
+# the resident frame to restore occluded pixels, so it travels
+# with the FULL_FRAME bit.
+CAPS_OVERLAY = 0x80
+
+# DRAW_RECT header flag-byte masks.
+# CRC32 trailer present after the (optional) length field.
+RECT_FLAG_CRC_TRAILER = 0x01
+# Payload is half-size in both axes; expand 2x2.
+RECT_FLAG_SCALE2X = 0x02
+
+# DRAW_RECT payload encodings.
+ENC_RAW = 0x00
+ENC_RLE = 0x01
+ENC_INDEXED = 0x02
+# [skip, copy] pixel-count span headers against the resident frame,
+# each followed by the copy pixels (whole-frame builds only).
+ENC_DELTA = 0x03
+
+# Native wire pixel formats announced in the CAPS reply.
+# RGB565, little-endian on the wire.
+PIXEL_FORMAT_RGB565 = 0
+
+# DRAW_TEXT font atlas ids.
+FONT_8X16 = 0x00
+FONT_16X24 = 0x01
+# Proportional; baked by fontgen.py (GENERATED_FONTS).
+FONT_UBUNTU_16 = 0x02
+
+# Flash asset-store upload states (REPORT_ASSETS).
+ASSET_STATE_IDLE = 0
+ASSET_STATE_ERASING = 1
+ASSET_STATE_WRITING = 2
+ASSET_STATE_ERROR = 3
+
+# Delta firmware update states (REPORT_FW_INFO).
+FW_STATE_IDLE = 0
+# FW_BEGIN's base CRC did not match the running image; nothing
+# was erased.
+FW_STATE_BASE_MISMATCH = 1
+FW_STATE_RECEIVING = 2
+# Patch applied and target CRC verified; power cycle to run it.
+FW_STATE_DONE = 3
+FW_STATE_ERROR = 4
+
+# Flash asset-store agreement.
+# Well-known id for the theme's gradient background, the largest
+# re-streamed payload without the store.
+ASSET_ID_BACKGROUND = 1
+# Firmware-side upload staging ring; the host never runs more than
+# this past the acknowledged byte count (polled via GET_ASSETS).
+ASSET_STAGING_BYTES = 512
+
+# Transport-benchmark sub-ops (USB_BENCH_MODE=1 firmware only;
+# bench builds repurpose CMD_GET_TRACE's id as the command).
+CMD_BENCH = CMD_GET_TRACE
+BENCH_ECHO = 0x00
+BENCH_SINK = 0x01
+BENCH_SOURCE = 0x02
+
+# Derived packet-layout constants.
+# ASSET_DATA payload per REPORT_LENGTH packet.
+ASSET_DATA_BYTES_PER_PACKET = 62
+# Rect records that fit one MULTI_FILL packet.
+MULTI_FILL_MAX_RECTS = 10
+PALETTE_SIZE = 256
+# SET_PALETTE entries per packet: (64 - 4) // 2.
+PALETTE_ENTRIES_PER_PACKET = 30
+# FW_DATA payload per REPORT_LENGTH packet.
+FW_DATA_BYTES_PER_PACKET = 62
@@ -0,0 +1,211 @@
+/*!
+    \file    framecodec.c
+    \brief   Native frame conversion, tile diff and payload encoders.
+
+    The per-frame hot path of display_manager.py -- RGB888 to RGB565
+    conversion, the tile diff with tight bounding boxes, and the RLE /
+    delta-span payload encoders -- compiled as a plain shared library
+    and called through ctypes (see framecodec.py). The NumPy versions
+    stay as the reference implementation and runtime fallback; these
+    routines must match them bit for bit, packet for packet.
+
+    There is no CPython or NumPy API dependency here on purpose: the
+    module builds with nothing but the host gcc, the same way the host
+    benchmark harness does, so it works on a stock Pi Zero image.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Convert an RGB888 frame (h*w*3 bytes, row major) to RGB565. */
+void fc_convert(const uint8_t* rgb, uint16_t* out, int32_t h, int32_t w)
+{
+    const uint8_t* p = rgb;
+    int32_t n = h * w;
+    for (int32_t i = 0; i < n; i++, p += 3) {
+        out[i] = (uint16_t)(((p[0] & 0xF8u) << 8) | ((p[1] & 0xFCu) << 3)
+                            | (p[2] >> 3));
+    }
+}
+
+/* Tight bounding box of the changed pixels inside one tile-row run.
+   Returns 0 if nothing actually differs (cannot happen for runs built
+   from dirty tiles, but keeps the helper honest). */
+static int fc_run_bbox(const uint16_t* now, const uint16_t* prev, int32_t w,
+                       int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+                       int32_t* bbox)
+{
+    int32_t min_x = x2, min_y = y2, max_x = -1, max_y = -1;
+    for (int32_t y = y1; y < y2; y++) {
+        const uint16_t* n = now + (size_t)y * w;
+        const uint16_t* p = prev + (size_t)y * w;
+        for (int32_t x = x1; x < x2; x++) {
+            if (n[x] != p[x]) {
+                if (x < min_x) min_x = x;
+                if (x > max_x) max_x = x;
+                if (y < min_y) min_y = y;
+                max_y = y;
+            }
+        }
+    }
+    if (max_x < 0) return 0;
+    bbox[0] = min_x; bbox[1] = min_y; bbox[2] = max_x + 1; bbox[3] = max_y + 1;
+    return 1;
+}
+
+/* Convert rgb (RGB888, may be NULL if out already holds the frame) and
+   diff against prev, producing tight per-tile-row-run rects exactly as
+   TileDiffer.dirty_rects does: horizontally adjacent dirty tiles merge
+   into one run, each run shrinks to its changed-pixel bounding box.
+   prev may be NULL (first frame): every tile row reports in full.
+   Returns the rect count; rects land in out_rects as x1,y1,x2,y2
+   quadruples, at most max_rects of them (excess runs are dropped --
+   callers size for (h/tile_h)*(w/tile_w)). */
+int32_t fc_convert_diff(const uint8_t* rgb, const uint16_t* prev,
+                        uint16_t* out, int32_t h, int32_t w,
+                        int32_t tile_w, int32_t tile_h,
+                        int32_t* out_rects, int32_t max_rects)
+{
+    if (rgb != NULL) {
+        fc_convert(rgb, out, h, w);
+    }
+
+    int32_t cols = (w + tile_w - 1) / tile_w;
+    int32_t nrects = 0;
+
+    for (int32_t ty1 = 0; ty1 < h; ty1 += tile_h) {
+        int32_t ty2 = ty1 + tile_h < h ? ty1 + tile_h : h;
+
+        if (prev == NULL) {
+            if (nrects < max_rects) {
+                int32_t* r = out_rects + nrects * 4;
+                r[0] = 0; r[1] = ty1; r[2] = w; r[3] = ty2;
+                nrects++;
+            }
+            continue;
+        }
+
+        /* Per-tile dirty flags for this tile row, then merge adjacent
+           dirty tiles into runs and shrink each run. */
+        int32_t run_start = -1;
+        for (int32_t c = 0; c <= cols; c++) {
+            int dirty = 0;
+            if (c < cols) {
+                int32_t tx1 = c * tile_w;
+                int32_t tx2 = tx1 + tile_w < w ? tx1 + tile_w : w;
+                for (int32_t y = ty1; y < ty2 && !dirty; y++) {
+                    const uint16_t* n = out + (size_t)y * w;
+                    const uint16_t* p = prev + (size_t)y * w;
+                    for (int32_t x = tx1; x < tx2; x++) {
+                        if (n[x] != p[x]) { dirty = 1; break; }
+                    }
+                }
+            }
+            if (dirty) {
+                if (run_start < 0) run_start = c;
+            } else if (run_start >= 0) {
+                int32_t tx1 = run_start * tile_w;
+                int32_t tx2 = c * tile_w < w ? c * tile_w : w;
+                int32_t bbox[4];
+                if (nrects < max_rects
+                        && fc_run_bbox(out, prev, w, tx1, ty1, tx2, ty2, bbox)) {
+                    int32_t* r = out_rects + nrects * 4;
+                    r[0] = bbox[0]; r[1] = bbox[1]; r[2] = bbox[2]; r[3] = bbox[3];
+                    nrects++;
+                }
+                run_start = -1;
+            }
+        }
+    }
+    return nrects;
+}
+
+/* Run-length encode little-endian RGB565 data into [count, lsb, msb]
+   records, runs capped at 255 pixels. out must hold 3 * (n / 2) bytes
+   (worst case: no runs). Returns the encoded length. */
+int32_t fc_rle_encode(const uint8_t* data, int32_t n, uint8_t* out)
+{
+    int32_t i = 0, o = 0;
+    while (i < n) {
+        uint8_t lsb = data[i], msb = data[i + 1];
+        int32_t run = 1;
+        while (run < 255 && i + run * 2 + 2 <= n
+               && data[i + run * 2] == lsb && data[i + run * 2 + 1] == msb) {
+            run++;
+        }
+        out[o++] = (uint8_t)run;
+        out[o++] = lsb;
+        out[o++] = msb;
+        i += run * 2;
+    }
+    return o;
+}
+
+/* CRC32 over a payload, computed the way the GD32 hardware CRC unit
+   does: polynomial 0x04C11DB7, seed 0xFFFFFFFF, digested as little-
+   endian 32-bit words with the tail zero-padded, no reflection and no
+   final XOR. Deliberately NOT zlib's CRC32 -- the device feeds its unit
+   straight from the receive copy loop, so the host must match it. */
+uint32_t fc_crc32(const uint8_t* data, int32_t n)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int32_t i = 0; i < n; i += 4) {
+        uint32_t word = 0;
+        for (int32_t b = 0; b < 4; b++) {
+            if (i + b < n) {
+                word |= (uint32_t)data[i + b] << (8 * b);
+            }
+        }
+        crc ^= word;
+        for (int b = 0; b < 32; b++) {
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/* Delta-span encode npix RGB565 pixels against the resident copy:
+   2-byte [skip, copy] headers followed by the copy pixels, matching
+   DeviceManager.delta_encode_rgb565 exactly (including the trailing
+   skip records that finalize the rect). out must hold 4 * npix + 8
+   bytes. Returns the encoded length. */
+int32_t fc_delta_encode(const uint16_t* now, const uint16_t* old,
+                        int32_t npix, uint8_t* out)
+{
+    int32_t o = 0, i = 0, skip = 0;
+    while (i < npix) {
+        if (now[i] == old[i]) {
+            skip++;
+            i++;
+            continue;
+        }
+        /* Start of a changed span: find its end. */
+        int32_t start = i;
+        while (i < npix && now[i] != old[i]) i++;
+        while (skip > 255) {
+            out[o++] = 255; out[o++] = 0;
+            skip -= 255;
+        }
+        int32_t pos = start;
+        while (pos < i) {
+            int32_t run = i - pos < 255 ? i - pos : 255;
+            out[o++] = (uint8_t)skip;
+            out[o++] = (uint8_t)run;
+            for (int32_t k = 0; k < run; k++) {
+                out[o++] = (uint8_t)(now[pos + k] & 0xFF);
+                out[o++] = (uint8_t)(now[pos + k] >> 8);
+            }
+            skip = 0;
+            pos += run;
+        }
+    }
+    while (skip > 255) {
+        out[o++] = 255; out[o++] = 0;
+        skip -= 255;
+    }
+    if (skip) {
+        out[o++] = (uint8_t)skip;
+        out[o++] = 0;
+    }
+    return o;
+}
@@ -0,0 +1,170 @@
+# framecodec.py
+"""
+ctypes loader for the native frame codec (framecodec.c).
+
+The conversion, tile-diff and payload-encode stages of the streaming
+pipeline are the host's per-frame CPU cost; NumPy keeps them workable
+on a Pi 4 but not on the Pi Zero the dashboard actually deploys to.
+framecodec.c implements the same routines in C; this module compiles it
+on first use with the host gcc (cached in build/framecodec/, rebuilt
+when the source is newer, same policy as the host benchmark harness)
+and exposes thin wrappers over ctypes.
+
+If no compiler is available the module degrades gracefully:
+available() returns False and display_manager.py stays on its NumPy
+paths, which remain the reference implementation. The C routines are
+required to produce byte-identical packets, so switching between the
+two is invisible to the device.
+"""
+import ctypes
+import os
+import subprocess
+import sys
+
+import numpy as np
+
+_SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+_SRC = os.path.join(_SCRIPT_DIR, "framecodec.c")
+_LIB_DIR = os.path.normpath(os.path.join(_SCRIPT_DIR, "..", "..",
+                                         "build", "framecodec"))
+_LIB = os.path.join(_LIB_DIR, "framecodec.so")
+
+_lib = None
+_load_attempted = False
+
+
+def _load():
+    """Compiles (if stale) and loads the shared library, once."""
+    global _lib, _load_attempted
+    if _load_attempted:
+        return _lib
+    _load_attempted = True
+    try:
+        if (not os.path.exists(_LIB)
+                or os.path.getmtime(_SRC) > os.path.getmtime(_LIB)):
+            os.makedirs(_LIB_DIR, exist_ok=True)
+            subprocess.run(
+                ["gcc", "-O2", "-Wall", "-shared", "-fPIC", _SRC, "-o", _LIB],
+                check=True, capture_output=True)
+        lib = ctypes.CDLL(_LIB)
+    except (OSError, subprocess.SubprocessError) as e:
+        print(f"framecodec: native codec unavailable ({e}); "
+              f"using NumPy fallback.", file=sys.stderr)
+        return None
+
+    # Input byte buffers ride in as c_char_p so Python bytes pass
+    # zero-copy; output buffers are caller-allocated ctypes arrays.
+    u8p = ctypes.POINTER(ctypes.c_uint8)
+    u16p = ctypes.POINTER(ctypes.c_uint16)
+    i32p = ctypes.POINTER(ctypes.c_int32)
+    lib.fc_convert.argtypes = [ctypes.c_char_p, u16p,
+                               ctypes.c_int32, ctypes.c_int32]
+    lib.fc_convert.restype = None
+    lib.fc_convert_diff.argtypes = [ctypes.c_char_p, u16p, u16p,
+                                    ctypes.c_int32, ctypes.c_int32,
+                                    ctypes.c_int32, ctypes.c_int32,
+                                    i32p, ctypes.c_int32]
+    lib.fc_convert_diff.restype = ctypes.c_int32
+    lib.fc_rle_encode.argtypes = [ctypes.c_char_p, ctypes.c_int32, u8p]
+    lib.fc_rle_encode.restype = ctypes.c_int32
+    lib.fc_delta_encode.argtypes = [u16p, u16p, ctypes.c_int32, u8p]
+    lib.fc_delta_encode.restype = ctypes.c_int32
+    lib.fc_crc32.argtypes = [ctypes.c_char_p, ctypes.c_int32]
+    lib.fc_crc32.restype = ctypes.c_uint32
+    _lib = lib
+    return _lib
+
+
+def available() -> bool:
+    """True when the native codec compiled and loaded."""
+    return _load() is not None
+
+
+def _u16p(arr: np.ndarray):
+    return arr.ctypes.data_as(ctypes.POINTER(ctypes.c_uint16))
+
+
+def convert(rgb_bytes: bytes, height: int, width: int) -> np.ndarray:
+    """RGB888 bytes (h*w*3) -> (h, w) uint16 RGB565 array."""
+    out = np.empty((height, width), dtype=np.uint16)
+    _lib.fc_convert(rgb_bytes, _u16p(out), height, width)
+    return out
+
+
+def diff_rects(frame: np.ndarray, previous: np.ndarray,
+               tile_w: int, tile_h: int) -> list:
+    """
+    Dirty rects of frame vs previous (both (h, w) uint16, previous may
+    be None for a full-frame report), one pass in C: per-tile dirty
+    flags, horizontal run merging and the tight changed-pixel bounding
+    box, matching TileDiffer.dirty_rects.
+    """
+    height, width = frame.shape
+    frame = np.ascontiguousarray(frame)
+    max_rects = (-(-height // tile_h)) * (-(-width // tile_w))
+    rects = np.empty(max_rects * 4, dtype=np.int32)
+    previous = (np.ascontiguousarray(previous)
+                if previous is not None else None)
+    prev_p = (_u16p(previous) if previous is not None
+              else ctypes.POINTER(ctypes.c_uint16)())
+    n = _lib.fc_convert_diff(None, prev_p,
+                             _u16p(frame), height, width, tile_w, tile_h,
+                             rects.ctypes.data_as(
+                                 ctypes.POINTER(ctypes.c_int32)),
+                             max_rects)
+    return [tuple(int(v) for v in rects[i * 4:i * 4 + 4]) for i in range(n)]
+
+
+def rle_encode(data) -> bytearray:
+    """RGB565 byte stream -> [count, lsb, msb] RLE records."""
+    out = bytearray(3 * (len(data) // 2))
+    n = _lib.fc_rle_encode(
+        bytes(data), len(data),
+        (ctypes.c_uint8 * len(out)).from_buffer(out))
+    return out[:n]
+
+
+# MSB-first table for the hardware-CRC fallback, built lazily.
+_crc_table = None
+
+
+def crc32(data) -> int:
+    """
+    CRC32 the way the device's hardware CRC unit computes it: polynomial
+    0x04C11DB7, seed 0xFFFFFFFF, fed as little-endian 32-bit words with
+    the tail zero-padded, no bit reflection and no final XOR. This is
+    NOT zlib.crc32; the device verifies payloads against exactly this
+    value, so both sides must agree on the variant.
+    """
+    if _load() is not None:
+        return _lib.fc_crc32(bytes(data), len(data))
+
+    global _crc_table
+    if _crc_table is None:
+        table = []
+        for i in range(256):
+            c = i << 24
+            for _ in range(8):
+                c = ((c << 1) ^ 0x04C11DB7) if (c & 0x80000000) else (c << 1)
+            table.append(c & 0xFFFFFFFF)
+        _crc_table = table
+
+    padded = bytes(data) + b"\x00" * (-len(data) % 4)
+    crc = 0xFFFFFFFF
+    # The unit digests words MSB first, but the words themselves are
+    # assembled little-endian from the byte stream.
+    for i in range(0, len(padded), 4):
+        for b in (padded[i + 3], padded[i + 2], padded[i + 1], padded[i]):
+            crc = ((crc << 8) & 0xFFFFFFFF) ^ _crc_table[(crc >> 24) ^ b]
+    return crc
+
+
+def delta_encode(new: np.ndarray, old: np.ndarray) -> bytearray:
+    """Skip/copy span stream of new vs old ((h, w) or flat uint16)."""
+    new = np.ascontiguousarray(new).ravel()
+    old = np.ascontiguousarray(old).ravel()
+    out = bytearray(4 * new.size + 8)
+    n = _lib.fc_delta_encode(
+        _u16p(new), _u16p(old), new.size,
+        (ctypes.c_uint8 * len(out)).from_buffer(out))
+    return out[:n]
@@ -0,0 +1,227 @@
+# fw_update.py
+"""
+Delta firmware update over the vendor bulk interface.
+
+Between two builds of this project the binary usually differs in a few
+kilobytes, but reflashing over the serial bootloader re-sends the whole
+image and needs the BOOT0 strap. This script diffs the new image against
+the one the device is running and streams only the changed spans; the
+firmware patches the touched 1 KB flash pages in place (see
+prj_usb_composite/src/fwup.h).
+
+Safety model: CMD_FW_BEGIN carries the CRC32 of the image the diff was
+computed against and the device refuses to erase anything unless its
+running flash matches, so a diff can never land on the wrong version.
+The part has a single flash bank, so a power loss between the first page
+erase and the final verify leaves a mixed image that needs the serial
+bootloader to recover -- the script says so and asks before starting.
+
+Usage:
+
+    python fw_update.py <running.bin> <new.bin> [--yes]
+
+<running.bin> must be the exact binary the device is running (the build
+that was last flashed); the script checks its CRC against the device's
+before sending anything.
+"""
+import binascii
+import sys
+import time
+
+import config
+from display_manager import DeviceManager
+
+# Never run further ahead of the device's drained-byte counter than half
+# its 512-byte staging ring, mirroring the asset uploader's pacing.
+MAX_BYTES_IN_FLIGHT = 256
+STATE_POLL_TIMEOUT_SECONDS = 10.0
+
+_STATE_NAMES = {
+    config.FW_STATE_IDLE: "idle",
+    config.FW_STATE_BASE_MISMATCH: "base mismatch",
+    config.FW_STATE_RECEIVING: "receiving",
+    config.FW_STATE_DONE: "done",
+    config.FW_STATE_ERROR: "error",
+}
+
+
+def _read_fw_info(manager: DeviceManager):
+    """
+    Sends CMD_GET_FWINFO and returns (state, pages, bytes_received,
+    image_crc, image_len), skipping unrelated status reports.
+    """
+    packet = bytearray([config.CMD_GET_FWINFO])
+    packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+    manager._write(packet)
+    for _ in range(8):
+        report = manager._read(config.REPORT_LENGTH, timeout_ms=200)
+        if len(report) < 16 or report[0] != config.REPORT_FW_INFO:
+            continue
+        state = report[1]
+        pages = report[2] | (report[3] << 8)
+        rx = int.from_bytes(report[4:8], "little")
+        crc = int.from_bytes(report[8:12], "little")
+        length = int.from_bytes(report[12:16], "little")
+        return state, pages, rx, crc, length
+    raise OSError("No FW_INFO report from device")
+
+
+def _await_state(manager: DeviceManager, wanted, timeout=STATE_POLL_TIMEOUT_SECONDS):
+    """Polls until the update state is one of `wanted`; returns the info."""
+    deadline = time.perf_counter() + timeout
+    while time.perf_counter() < deadline:
+        info = _read_fw_info(manager)
+        if info[0] in wanted:
+            return info
+        time.sleep(0.02)
+    raise OSError(f"Update stuck in state "
+                  f"'{_STATE_NAMES.get(info[0], info[0])}' after {timeout}s")
+
+
+def build_delta(old: bytes, new: bytes) -> bytes:
+    """
+    Returns the delta stream: [offset u32 LE, len u16 LE, data] records
+    sorted by offset. Changed runs separated by fewer unchanged bytes
+    than a record header costs are merged, and a record never exceeds
+    the u16 length field.
+    """
+    assert len(old) == len(new)
+    records = bytearray()
+    i = 0
+    while i < len(new):
+        if old[i] == new[i]:
+            i += 1
+            continue
+        start = i
+        gap = 0
+        end = i
+        while i < len(new) and gap <= 6 and (i - start) < 0xFFFF:
+            if old[i] != new[i]:
+                end = i + 1
+                gap = 0
+            else:
+                gap += 1
+            i += 1
+        records.extend(start.to_bytes(4, "little"))
+        records.extend((end - start).to_bytes(2, "little"))
+        records.extend(new[start:end])
+        i = end
+    return bytes(records)
+
+
+def _send_delta(manager: DeviceManager, delta: bytes):
+    """Streams the delta as CMD_FW_DATA packets, paced by the device's
+    drained-byte counter so the staging ring never overflows."""
+    sent = 0
+    while sent < len(delta):
+        chunk = delta[sent:sent + config.FW_DATA_BYTES_PER_PACKET]
+        packet = bytearray([config.CMD_FW_DATA, len(chunk)])
+        packet.extend(chunk)
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+        sent += len(chunk)
+        _poll_drained(manager, sent)
+        pct = 100 * sent // len(delta)
+        print(f"\r  sending delta: {sent}/{len(delta)} bytes ({pct}%)",
+              end="", flush=True)
+    print()
+
+
+def _poll_drained(manager: DeviceManager, sent: int) -> int:
+    """Waits until the device has drained to within MAX_BYTES_IN_FLIGHT
+    of `sent` and returns its counter; raises on a device-side error."""
+    deadline = time.perf_counter() + STATE_POLL_TIMEOUT_SECONDS
+    while True:
+        state, _, rx, _, _ = _read_fw_info(manager)
+        if state == config.FW_STATE_ERROR:
+            raise OSError("Device reported a delta-stream error")
+        if sent - rx <= MAX_BYTES_IN_FLIGHT:
+            return rx
+        if time.perf_counter() > deadline:
+            raise OSError("Device stopped draining the delta stream")
+        time.sleep(config.ASSET_POLL_INTERVAL_SECONDS)
+
+
+def update_main(old_path: str, new_path: str, assume_yes: bool = False):
+    with open(old_path, "rb") as f:
+        old = f.read()
+    with open(new_path, "rb") as f:
+        new = f.read()
+
+    manager = DeviceManager()
+    if not manager.connect():
+        sys.exit(1)
+    try:
+        state, _, _, dev_crc, image_len = _read_fw_info(manager)
+        if state == config.FW_STATE_RECEIVING:
+            print("Error: an update is already in progress.")
+            sys.exit(1)
+        if len(old) > image_len or len(new) > image_len:
+            print(f"Error: image exceeds the device's {image_len}-byte "
+                  f"code region.")
+            sys.exit(1)
+
+        # Pad to the full code region with the erased-flash value, the
+        # same bytes the device hashes (and programs past the image end,
+        # which erase leaves at 0xFF anyway).
+        old = old.ljust(image_len, b"\xFF")
+        new = new.ljust(image_len, b"\xFF")
+        old_crc = binascii.crc32(old)
+        new_crc = binascii.crc32(new)
+
+        if old_crc != dev_crc:
+            print(f"Error: device image CRC 0x{dev_crc:08X} does not match "
+                  f"{old_path} (0x{old_crc:08X}); wrong base binary.")
+            sys.exit(1)
+        if old_crc == new_crc:
+            print("Device already runs this image; nothing to do.")
+            return
+
+        delta = build_delta(old, new)
+        pct = 100 * len(delta) // image_len
+        print(f"--- Delta update: {len(delta)} bytes ({pct}% of the "
+              f"{image_len}-byte region) ---")
+        if not assume_yes:
+            print("A power loss while patching leaves a mixed image that "
+                  "needs the serial bootloader (BOOT0) to recover.")
+            if input("Proceed? [y/N] ").strip().lower() != "y":
+                return
+
+        packet = bytearray([config.CMD_FW_BEGIN])
+        packet.extend(old_crc.to_bytes(4, "little"))
+        packet.extend(new_crc.to_bytes(4, "little"))
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+
+        state = _await_state(manager, (config.FW_STATE_RECEIVING,
+                                       config.FW_STATE_BASE_MISMATCH))[0]
+        if state != config.FW_STATE_RECEIVING:
+            print("Error: device refused the base CRC (image changed "
+                  "since connect?).")
+            sys.exit(1)
+
+        _send_delta(manager, delta)
+
+        packet = bytearray([config.CMD_FW_APPLY])
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        manager._write(packet)
+
+        state, pages, _, crc, _ = _await_state(
+            manager, (config.FW_STATE_DONE, config.FW_STATE_ERROR))
+        if state == config.FW_STATE_DONE:
+            print(f"Update verified: {pages} pages rewritten, image CRC "
+                  f"0x{crc:08X}. Power cycle the device to run it.")
+        else:
+            print("Error: verify failed after patching -- reflash over "
+                  "the serial bootloader before power cycling.")
+            sys.exit(1)
+    finally:
+        manager.close()
+
+
+if __name__ == "__main__":
+    args = [a for a in sys.argv[1:] if a != "--yes"]
+    if len(args) != 2:
+        print(__doc__)
+        sys.exit(1)
+    update_main(args[0], args[1], assume_yes="--yes" in sys.argv)
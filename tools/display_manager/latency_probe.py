@@ -0,0 +1,123 @@
+# latency_probe.py
+"""
+End-to-end display latency probe.
+
+The transport benchmark (`display_manager.py benchmark`) measures the USB
+link in isolation; this script measures the path a real update takes:
+host submit -> bulk OUT -> firmware task slot -> SPI DMA -> panel. It
+arms the firmware's latency probe (CMD_LATENCY_PROBE), then sends small
+timed CMD_DRAW_RECT updates. When a rect's blit completes, the firmware
+echoes a REPORT_RECT_LATENCY status report carrying the rect's sequence
+number and its receive-to-panel mcycle delta. Pairing the echo with the
+host-side send timestamp yields two distributions:
+
+  host   -- submit-to-echo round trip as the host application sees it
+            (includes the IN report's return leg);
+  device -- command reception to DMA completion, measured on-device with
+            the mcycle CSR (no USB return leg, no host scheduling noise).
+
+Runs against stock firmware; no bench build required. Usage:
+
+    python latency_probe.py [rounds]
+"""
+import sys
+import time
+
+import config
+from display_manager import DeviceManager, _bench_percentiles
+
+# Probe rect: one tile, small enough that the payload plus command fit a
+# single bulk burst, large enough to exercise a real DMA blit.
+PROBE_X, PROBE_Y = 0, 0
+PROBE_W, PROBE_H = 32, 16
+
+DEFAULT_ROUNDS = 200
+ECHO_TIMEOUT_SECONDS = 1.0
+
+
+def _set_probe(manager: DeviceManager, enable: bool):
+    """Arms or disarms the firmware latency probe."""
+    packet = bytearray([config.CMD_LATENCY_PROBE, 1 if enable else 0])
+    packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+    manager._write(packet)
+
+
+def _send_probe_rect(manager: DeviceManager, color: int) -> int:
+    """
+    Sends one raw-encoded solid rect and returns its sequence number.
+
+    Built by hand rather than through send_rect_update() so the probe
+    always exercises the same path: one command packet plus one raw
+    headerless payload burst, no RLE/palette heuristics.
+    """
+    seq = manager.sequence_number
+    packet = bytearray([config.CMD_DRAW_RECT, PROBE_X, PROBE_Y,
+                        PROBE_W, PROBE_H, seq & 0xFF, (seq >> 8) & 0xFF,
+                        config.ENC_RAW])
+    packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+    manager._write(packet)
+    pixel = bytes([color & 0xFF, (color >> 8) & 0xFF])
+    manager.send_data_payload(bytearray(pixel * (PROBE_W * PROBE_H)),
+                              command=None)
+    manager.sequence_number = (manager.sequence_number + 1) & 0xFFFF
+    return seq
+
+
+def _await_echo(manager: DeviceManager, seq: int) -> int:
+    """
+    Blocks until the echo for `seq` arrives and returns its cycle count.
+
+    Unrelated status reports (button events, NACKs) are skipped; a stale
+    echo from an earlier round is skipped too, so one slow rect does not
+    misattribute its completion to the next sample.
+    """
+    deadline = time.perf_counter() + ECHO_TIMEOUT_SECONDS
+    while time.perf_counter() < deadline:
+        report = manager._read(config.REPORT_LENGTH, timeout_ms=100)
+        if len(report) < 7 or report[0] != config.REPORT_RECT_LATENCY:
+            continue
+        echo_seq = report[1] | (report[2] << 8)
+        if echo_seq != seq:
+            continue
+        return (report[3] | (report[4] << 8) |
+                (report[5] << 16) | (report[6] << 24))
+    raise OSError(f"No latency echo for sequence {seq} "
+                  f"within {ECHO_TIMEOUT_SECONDS}s")
+
+
+def probe_main(rounds: int = DEFAULT_ROUNDS):
+    """Runs the probe and prints host and device latency percentiles."""
+    manager = DeviceManager()
+    if not manager.connect():
+        sys.exit(1)
+
+    host_ms = []
+    device_ms = []
+    try:
+        _set_probe(manager, True)
+        print(f"--- Latency probe: {rounds} x {PROBE_W}x{PROBE_H} rects ---")
+        for i in range(rounds):
+            # Alternate colors so the rect is visible while probing.
+            color = 0xF800 if (i & 1) else 0x001F
+            t0 = time.perf_counter()
+            seq = _send_probe_rect(manager, color)
+            cycles = _await_echo(manager, seq)
+            host_ms.append((time.perf_counter() - t0) * 1000.0)
+            device_ms.append(cycles * 1000.0 / config.DEVICE_CYCLES_PER_SECOND)
+    finally:
+        try:
+            _set_probe(manager, False)
+        except OSError:
+            pass  # Device already gone; nothing to disarm.
+        manager.close()
+
+    for label, samples in (("host submit->echo", host_ms),
+                           ("device recv->panel", device_ms)):
+        p50, p90, p99 = _bench_percentiles(samples)
+        print(f"  {label:<20} p50 {p50:7.3f} ms   "
+              f"p90 {p90:7.3f} ms   p99 {p99:7.3f} ms   "
+              f"({len(samples)} samples)")
+
+
+if __name__ == "__main__":
+    probe_main(int(sys.argv[1]) if len(sys.argv) > 1 else DEFAULT_ROUNDS)
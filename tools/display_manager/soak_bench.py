@@ -0,0 +1,327 @@
+# soak_bench.py
+"""
+Display pipeline soak benchmark with a regression gate.
+
+The transport benchmark (`display_manager.py benchmark`) isolates the USB
+link and latency_probe.py measures one rect at a time; neither protects
+the pipeline as a whole. This driver runs the standardized workloads the
+display actually consists of -- full-frame updates, many small rects,
+text-heavy churn and hardware scrolling -- each for a fixed duration
+against stock firmware, and collects three kinds of numbers per workload:
+
+  host    -- update and pixel throughput as submitted by this script;
+  device  -- deltas of the DisplayManager counters (packets received,
+             slots dropped, rects drawn, DMA busy cycles) over the run;
+  latency -- host and device percentiles from a latency-probe round
+             (see latency_probe.py) run immediately after the pump, so
+             the numbers reflect the firmware state the workload left.
+
+Results are written as JSON for CI. With --baseline the run compares
+itself against a stored result and exits nonzero when throughput fell,
+drops rose or latency grew beyond the tolerance, so a regression in the
+USB or LCD path fails the build instead of surfacing on a device weeks
+later. Usage:
+
+    python soak_bench.py [--duration seconds] [--out results.json]
+                         [--baseline results.json] [--tolerance 0.15]
+"""
+import json
+import sys
+import time
+from datetime import datetime, timezone
+
+import numpy as np
+
+import config
+import latency_probe
+from display_manager import DeviceManager, _bench_percentiles
+
+# Seconds of sustained traffic per workload; CI trades runtime against
+# noise here (percentiles stabilize around a minute per workload).
+DEFAULT_DURATION_SECONDS = 60.0
+
+# Latency-probe rounds appended to each workload.
+LATENCY_ROUNDS = 100
+
+# Default headroom for the regression gate: a metric may be this fraction
+# worse than the baseline before the run fails. Latency additionally gets
+# a small absolute slack so microsecond-level jitter on near-zero numbers
+# does not flag.
+DEFAULT_TOLERANCE = 0.15
+LATENCY_SLACK_MS = 0.2
+
+# Small-rect workload geometry: enough scattered rects per pass that slot
+# acquisition, merging and per-rect overhead dominate over pixel payload.
+SMALL_RECT_SIZE = 16
+SMALL_RECTS_PER_PASS = 24
+
+STATS_FETCH_ATTEMPTS = 64
+
+
+def _fetch_stats(manager: DeviceManager) -> dict:
+    """
+    Fetches the DisplayManager counters synchronously.
+
+    The soak runs without the listener thread, so stale status reports
+    (credits, NACKs) queue on the IN endpoint during a pump; they are
+    skipped here until the REPORT_STATS answer arrives.
+    """
+    manager.request_stats()
+    for _ in range(STATS_FETCH_ATTEMPTS):
+        report = manager._read(config.REPORT_LENGTH, timeout_ms=250)
+        if len(report) >= 21 and report[0] == config.REPORT_STATS:
+            packets, dropped, rects, busy, last_draw = (
+                int.from_bytes(bytes(report[1 + i * 4 : 5 + i * 4]), 'little')
+                for i in range(5))
+            return {"packets": packets, "dropped": dropped, "rects": rects,
+                    "dma_busy_cycles": busy, "last_rect_cycles": last_draw}
+    raise OSError("No stats reply from device.")
+
+
+def _gradient_frame(phase: int) -> np.ndarray:
+    """
+    Deterministic full-panel RGB565 test frame.
+
+    A diagonal gradient shifted by `phase`: every pixel differs between
+    phases (so delta encodings cannot shortcut the workload) while runs
+    stay short enough that RLE sees realistic, not degenerate, input.
+    """
+    diag = np.add.outer(np.arange(config.LCD_HEIGHT),
+                        np.arange(config.LCD_WIDTH)) + phase
+    r = (diag % 32).astype(np.uint16)
+    g = ((diag // 2) % 64).astype(np.uint16)
+    b = ((diag // 4) % 32).astype(np.uint16)
+    return (r << 11) | (g << 5) | b
+
+
+def _run_full_frame(manager: DeviceManager, duration: float) -> dict:
+    """Alternates two full-panel frames as fast as the link accepts."""
+    frames = [_gradient_frame(0), _gradient_frame(7)]
+    updates = 0
+    deadline = time.perf_counter() + duration
+    while time.perf_counter() < deadline:
+        frame = frames[updates & 1]
+        manager.send_rect_update(frame, (0, 0, config.LCD_WIDTH,
+                                         config.LCD_HEIGHT))
+        updates += 1
+    pixels = updates * config.LCD_WIDTH * config.LCD_HEIGHT
+    return {"updates": updates, "pixels": pixels}
+
+
+def _run_small_rects(manager: DeviceManager, duration: float) -> dict:
+    """
+    Scatters small color-cycling rects across the panel.
+
+    Positions come from a seeded generator, so every run (and both sides
+    of a baseline comparison) submits the identical update stream.
+    """
+    rng = np.random.default_rng(seed=0x5eed)
+    frame = _gradient_frame(0).copy()
+    updates = 0
+    deadline = time.perf_counter() + duration
+    while time.perf_counter() < deadline:
+        for _ in range(SMALL_RECTS_PER_PASS):
+            x = int(rng.integers(0, config.LCD_WIDTH - SMALL_RECT_SIZE))
+            y = int(rng.integers(0, config.LCD_HEIGHT - SMALL_RECT_SIZE))
+            color = int(rng.integers(0, 0x10000))
+            frame[y:y + SMALL_RECT_SIZE, x:x + SMALL_RECT_SIZE] = color
+            manager.send_rect_update(frame, (x, y, x + SMALL_RECT_SIZE,
+                                             y + SMALL_RECT_SIZE))
+            updates += 1
+        if time.perf_counter() >= deadline:
+            break
+    pixels = updates * SMALL_RECT_SIZE * SMALL_RECT_SIZE
+    return {"updates": updates, "pixels": pixels}
+
+
+def _run_text(manager: DeviceManager, duration: float) -> dict:
+    """Cycles clock-style strings through the on-device text path."""
+    rows = ((4, 4, config.FONT_8X16), (4, 24, config.FONT_16X24),
+            (4, 52, config.FONT_UBUNTU_16))
+    updates = 0
+    deadline = time.perf_counter() + duration
+    while time.perf_counter() < deadline:
+        text = f"{updates % 24:02d}:{updates % 60:02d}:{updates % 100:02d}"
+        x, y, font = rows[updates % len(rows)]
+        manager.send_text(x, y, text, fg=0xFFFF, bg=0x0000, font=font)
+        updates += 1
+    return {"updates": updates, "pixels": 0}
+
+
+def _run_scroll(manager: DeviceManager, duration: float) -> dict:
+    """
+    Advances the hardware scroll window one pixel per update, redrawing
+    only the revealed column strip -- the ticker pattern SET_SCROLL
+    exists for.
+    """
+    frame = _gradient_frame(0)
+    manager.send_rect_update(frame, (0, 0, config.LCD_WIDTH,
+                                     config.LCD_HEIGHT))
+    updates = 0
+    deadline = time.perf_counter() + duration
+    try:
+        while time.perf_counter() < deadline:
+            offset = (updates + 1) % config.LCD_WIDTH
+            manager.send_scroll(offset)
+            # The wrapped memory column is the one the rotation reveals.
+            strip_x = (offset - 1) % config.LCD_WIDTH
+            manager.send_rect_update(frame, (strip_x, 0, strip_x + 1,
+                                             config.LCD_HEIGHT))
+            updates += 1
+    finally:
+        manager.send_scroll(0)
+    pixels = updates * config.LCD_HEIGHT
+    return {"updates": updates, "pixels": pixels}
+
+
+WORKLOADS = (
+    ("full_frame", _run_full_frame),
+    ("small_rects", _run_small_rects),
+    ("text", _run_text),
+    ("scroll", _run_scroll),
+)
+
+
+def _probe_latency(manager: DeviceManager) -> dict:
+    """Runs LATENCY_ROUNDS probe rects and returns both percentile sets."""
+    host_ms = []
+    device_ms = []
+    latency_probe._set_probe(manager, True)
+    try:
+        for i in range(LATENCY_ROUNDS):
+            color = 0xF800 if (i & 1) else 0x001F
+            t0 = time.perf_counter()
+            seq = latency_probe._send_probe_rect(manager, color)
+            cycles = latency_probe._await_echo(manager, seq)
+            host_ms.append((time.perf_counter() - t0) * 1000.0)
+            device_ms.append(cycles * 1000.0
+                             / config.DEVICE_CYCLES_PER_SECOND)
+    finally:
+        latency_probe._set_probe(manager, False)
+    result = {}
+    for side, samples in (("host", host_ms), ("device", device_ms)):
+        p50, p90, p99 = _bench_percentiles(samples)
+        result[side] = {"p50_ms": round(p50, 4), "p90_ms": round(p90, 4),
+                        "p99_ms": round(p99, 4)}
+    return result
+
+
+def run_soak(duration: float) -> dict:
+    """Runs every workload once and returns the results document."""
+    manager = DeviceManager()
+    if not manager.connect():
+        sys.exit(1)
+
+    results = {"meta": {"timestamp": datetime.now(timezone.utc).isoformat(),
+                        "duration_seconds": duration,
+                        "latency_rounds": LATENCY_ROUNDS},
+               "workloads": {}}
+    try:
+        for name, runner in WORKLOADS:
+            print(f"--- Workload '{name}': {duration:.0f}s ---")
+            before = _fetch_stats(manager)
+            t0 = time.perf_counter()
+            host = runner(manager, duration)
+            elapsed = time.perf_counter() - t0
+            after = _fetch_stats(manager)
+
+            device = {key: after[key] - before[key]
+                      for key in ("packets", "dropped", "rects",
+                                  "dma_busy_cycles")}
+            updates_per_second = host["updates"] / elapsed
+            drop_rate = (device["dropped"] / device["packets"]
+                         if device["packets"] else 0.0)
+            entry = {
+                "updates": host["updates"],
+                "updates_per_second": round(updates_per_second, 2),
+                "pixels_per_second": round(host["pixels"] / elapsed, 1),
+                "drop_rate": round(drop_rate, 5),
+                "device": device,
+                "latency": _probe_latency(manager),
+            }
+            results["workloads"][name] = entry
+            print(f"    {entry['updates_per_second']:.1f} updates/s, "
+                  f"drop rate {entry['drop_rate']:.3%}, device p99 "
+                  f"{entry['latency']['device']['p99_ms']:.3f} ms")
+    finally:
+        manager.close()
+    return results
+
+
+def compare_to_baseline(results: dict, baseline: dict,
+                        tolerance: float) -> list:
+    """
+    Returns the list of regressions against `baseline` (empty = pass).
+
+    Per workload: update throughput may not fall, and drop rate and
+    latency percentiles may not rise, by more than `tolerance` of the
+    baseline value (latency gets LATENCY_SLACK_MS of absolute slack on
+    top, drop rate one percentage point).
+    """
+    regressions = []
+    for name, base in baseline.get("workloads", {}).items():
+        cur = results["workloads"].get(name)
+        if cur is None:
+            regressions.append(f"{name}: workload missing from this run")
+            continue
+        floor = base["updates_per_second"] * (1.0 - tolerance)
+        if cur["updates_per_second"] < floor:
+            regressions.append(
+                f"{name}: {cur['updates_per_second']:.1f} updates/s, "
+                f"baseline {base['updates_per_second']:.1f} (floor {floor:.1f})")
+        ceiling = base["drop_rate"] * (1.0 + tolerance) + 0.01
+        if cur["drop_rate"] > ceiling:
+            regressions.append(
+                f"{name}: drop rate {cur['drop_rate']:.3%}, "
+                f"baseline {base['drop_rate']:.3%} (ceiling {ceiling:.3%})")
+        for side in ("host", "device"):
+            for pct in ("p50_ms", "p99_ms"):
+                limit = (base["latency"][side][pct] * (1.0 + tolerance)
+                         + LATENCY_SLACK_MS)
+                value = cur["latency"][side][pct]
+                if value > limit:
+                    regressions.append(
+                        f"{name}: {side} {pct} {value:.3f} ms, baseline "
+                        f"{base['latency'][side][pct]:.3f} (limit {limit:.3f})")
+    return regressions
+
+
+def main():
+    args = sys.argv[1:]
+    options = {"duration": DEFAULT_DURATION_SECONDS, "out": None,
+               "baseline": None, "tolerance": DEFAULT_TOLERANCE}
+    i = 0
+    while i < len(args):
+        arg = args[i]
+        if arg.startswith("--") and arg[2:] in options:
+            options[arg[2:]] = args[i + 1]
+            i += 1
+        else:
+            print(__doc__.strip(), file=sys.stderr)
+            sys.exit(1)
+        i += 1
+
+    results = run_soak(float(options["duration"]))
+    if options["out"]:
+        with open(options["out"], "w") as handle:
+            json.dump(results, handle, indent=2)
+        print(f"--- Results written to {options['out']} ---")
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+
+    if options["baseline"]:
+        with open(options["baseline"]) as handle:
+            baseline = json.load(handle)
+        regressions = compare_to_baseline(results, baseline,
+                                          float(options["tolerance"]))
+        if regressions:
+            print("--- Regression gate FAILED ---", file=sys.stderr)
+            for line in regressions:
+                print(f"    {line}", file=sys.stderr)
+            sys.exit(1)
+        print("--- Regression gate passed ---")
+
+
+if __name__ == "__main__":
+    main()
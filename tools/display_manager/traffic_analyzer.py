@@ -0,0 +1,230 @@
+# traffic_analyzer.py
+"""
+Protocol traffic analyzer and bandwidth profiler.
+
+When the frame rate drops it is never obvious whether the host pipeline,
+the USB bus, or the device is at fault. This module taps every wire
+burst the DeviceManager emits, attributes each 64-byte packet to a
+protocol category (raw / RLE / indexed / delta image streams, fills,
+text, assets, overlay, control), and pairs sequence-numbered commands
+with the firmware's REPORT_RECT_LATENCY echoes, so one session yields a
+per-category breakdown of where the bandwidth went and how long each
+kind of update took host-to-panel.
+
+Run the normal dashboard with the tap attached:
+
+    python display_manager.py analyze [seconds]
+
+Without a duration the session runs until Ctrl-C; either way the
+breakdown prints on exit. The tap costs one dict update per packet on
+the encode thread and changes nothing on the wire except arming the
+latency probe, so the numbers describe the real pipeline, not an
+instrumented imitation.
+"""
+import threading
+import time
+
+import config
+from display_manager import _bench_percentiles
+
+# Full-speed bulk ceiling: 19 packets of 64 bytes per 1 ms frame. The
+# utilization column is relative to this, the same ceiling the transport
+# benchmark measures against.
+FS_BULK_BYTES_PER_SECOND = 19 * 64 * 1000
+
+# Pending seq -> sample entries kept for echo pairing; NACKed or
+# probe-disabled sequences never get an echo, so the table is pruned.
+MAX_PENDING_ECHOES = 4096
+
+# Print order; parsing can only produce these names.
+_CATEGORIES = ["image raw", "image rle", "image indexed", "image delta",
+               "fill", "text", "asset", "overlay", "scroll", "control"]
+
+_PAYLOAD_COMMANDS = {
+    config.CMD_IMAGE_DATA: "image raw",
+    config.CMD_IMAGE_DATA_RLE: "image rle",
+    config.CMD_IMAGE_DATA_IDX: "image indexed",
+}
+
+_SIMPLE_COMMANDS = {
+    config.CMD_FILL_RECT: "fill",
+    config.CMD_MULTI_FILL: "fill",
+    config.CMD_DRAW_TEXT: "text",
+    config.CMD_DRAW_ASSET: "asset",
+    config.CMD_ASSET_BEGIN: "asset",
+    config.CMD_ASSET_DATA: "asset",
+    config.CMD_GET_ASSETS: "asset",
+    config.CMD_OVERLAY_POS: "overlay",
+    config.CMD_SET_SCROLL: "scroll",
+    # SET_PALETTE is part of the indexed encoding's cost: a palette
+    # upload only ever happens to enable indexed payloads.
+    config.CMD_SET_PALETTE: "image indexed",
+}
+
+_ENC_CATEGORY = {
+    config.ENC_RAW: "image raw",
+    config.ENC_RLE: "image rle",
+    config.ENC_INDEXED: "image indexed",
+    config.ENC_DELTA: "image delta",
+}
+
+
+class TrafficLog:
+    """
+    Per-panel traffic tap.
+
+    note_burst() runs on the encode thread (via DeviceManager._emit) and
+    note_echo() on the listener thread, so the counters sit behind one
+    lock. The packet parser mirrors the wire format the manager emits:
+    a DRAW_RECT header announces how many headerless payload bytes
+    follow (raw streams by geometry, single-header streams by their
+    length field), and those packets are attributed to the header's
+    encoding; everything else identifies itself by its command byte.
+    """
+
+    def __init__(self, manager):
+        self.manager = manager
+        self.lock = threading.Lock()
+        self.started = time.perf_counter()
+        self.messages = {c: 0 for c in _CATEGORIES}
+        self.bytes = {c: 0 for c in _CATEGORIES}
+        self.host_ms = {c: [] for c in _CATEGORIES}
+        self.device_ms = {c: [] for c in _CATEGORIES}
+        self.echoes = 0
+        # Parser state across bursts: headerless payload packets still
+        # owed to the last stream header, and their category.
+        self._stream_remaining = 0
+        self._stream_category = "image raw"
+        # seq -> (category, host send timestamp), for echo pairing.
+        self._pending = {}
+
+    # -- encode-thread side ------------------------------------------------
+
+    def note_burst(self, data):
+        now = time.perf_counter()
+        with self.lock:
+            for off in range(0, len(data), config.REPORT_LENGTH):
+                self._note_packet(data[off:off + config.REPORT_LENGTH], now)
+
+    def _note_packet(self, pkt, now):
+        if self._stream_remaining > 0:
+            # Headerless payload for the last announced stream.
+            self._count(self._stream_category, pkt, message=False)
+            self._stream_remaining = max(
+                0, self._stream_remaining - config.REPORT_LENGTH)
+            return
+        cmd = pkt[0]
+        if cmd == config.CMD_DRAW_RECT:
+            category = _ENC_CATEGORY.get(pkt[7], "image raw")
+            self._count(category, pkt)
+            self._expect_stream(pkt, category)
+            self._await_echo(pkt[5] | (pkt[6] << 8), category, now)
+        elif cmd in _PAYLOAD_COMMANDS:
+            self._count(_PAYLOAD_COMMANDS[cmd], pkt, message=False)
+        elif cmd == config.CMD_OVERLAY_SET:
+            self._count("overlay", pkt)
+            self._stream_remaining = (pkt[1] * pkt[2]) * 2
+            self._stream_category = "overlay"
+        elif cmd in _SIMPLE_COMMANDS:
+            category = _SIMPLE_COMMANDS[cmd]
+            self._count(category, pkt)
+            if cmd == config.CMD_FILL_RECT:
+                self._await_echo(pkt[5] | (pkt[6] << 8), category, now)
+            elif cmd in (config.CMD_DRAW_ASSET, config.CMD_SET_SCROLL):
+                self._await_echo(pkt[4] | (pkt[5] << 8), category, now)
+            elif cmd == config.CMD_MULTI_FILL:
+                seq = pkt[2] | (pkt[3] << 8)
+                for i in range(pkt[1]):
+                    self._await_echo((seq + i) & 0xFFFF, category, now)
+            elif cmd == config.CMD_DRAW_TEXT:
+                self._await_echo(pkt[8] | (pkt[9] << 8), category, now)
+        else:
+            self._count("control", pkt)
+
+    def _count(self, category, pkt, message=True):
+        self.bytes[category] += len(pkt)
+        if message:
+            self.messages[category] += 1
+
+    def _expect_stream(self, pkt, category):
+        """Decodes how many headerless payload bytes follow a DRAW_RECT
+        header; zero for encodings that send self-identifying payload
+        command packets instead."""
+        enc = pkt[7]
+        if enc == config.ENC_RAW:
+            # Raw streams announce no length; the device derives it from
+            # the geometry, and so do we. The flags byte (offset 10 in
+            # the padded header) may add a CRC32 trailer.
+            remaining = pkt[3] * pkt[4] * 2
+        elif self.manager.single_header_streams or enc == config.ENC_DELTA:
+            remaining = pkt[8] | (pkt[9] << 8)
+        else:
+            return  # Payload arrives as CMD_IMAGE_DATA_* packets.
+        if len(pkt) > 10 and (pkt[10] & config.RECT_FLAG_CRC_TRAILER):
+            remaining += 4
+        self._stream_remaining = remaining
+        self._stream_category = category
+
+    def _await_echo(self, seq, category, now):
+        self._pending[seq] = (category, now)
+        while len(self._pending) > MAX_PENDING_ECHOES:
+            self._pending.pop(next(iter(self._pending)))
+
+    # -- listener-thread side ----------------------------------------------
+
+    def note_echo(self, seq, cycles):
+        """Pairs a REPORT_RECT_LATENCY echo with the sent command."""
+        now = time.perf_counter()
+        with self.lock:
+            entry = self._pending.pop(seq, None)
+            if entry is None:
+                return
+            category, sent_at = entry
+            self.echoes += 1
+            self.host_ms[category].append((now - sent_at) * 1000.0)
+            self.device_ms[category].append(
+                cycles * 1000.0 / config.DEVICE_CYCLES_PER_SECOND)
+
+    # -- reporting ---------------------------------------------------------
+
+    def print_report(self, label=""):
+        with self.lock:
+            elapsed = time.perf_counter() - self.started
+            total = sum(self.bytes.values())
+            print(f"\n--- Traffic breakdown{label}: {total} bytes in "
+                  f"{elapsed:.1f}s = {total / elapsed / 1024.0:.1f} KiB/s "
+                  f"({100.0 * total / elapsed / FS_BULK_BYTES_PER_SECOND:.1f}% "
+                  f"of the FS bulk ceiling) ---")
+            print(f"  {'category':<14} {'msgs':>7} {'bytes':>9} {'share':>6} "
+                  f"{'KiB/s':>7}   latency host / device (p50/p90, ms)")
+            for cat in _CATEGORIES:
+                if self.bytes[cat] == 0:
+                    continue
+                share = 100.0 * self.bytes[cat] / total if total else 0.0
+                rate = self.bytes[cat] / elapsed / 1024.0
+                lat = ""
+                if self.host_ms[cat]:
+                    hp50, hp90, _ = _bench_percentiles(self.host_ms[cat])
+                    dp50, dp90, _ = _bench_percentiles(self.device_ms[cat])
+                    lat = (f"  {hp50:6.2f}/{hp90:6.2f} | "
+                           f"{dp50:6.2f}/{dp90:6.2f} "
+                           f"({len(self.host_ms[cat])} echoes)")
+                print(f"  {cat:<14} {self.messages[cat]:>7} "
+                      f"{self.bytes[cat]:>9} {share:>5.1f}% {rate:>7.1f}{lat}")
+            unpaired = len(self._pending)
+            if self.echoes or unpaired:
+                print(f"  ({self.echoes} echoes paired, {unpaired} still "
+                      f"pending -- pending is normal for recent sends)")
+
+
+def attach(manager) -> TrafficLog:
+    """
+    Attaches a tap to a connected DeviceManager and arms the firmware's
+    latency probe so device-side completion timestamps flow back.
+    """
+    log = TrafficLog(manager)
+    manager.traffic_log = log
+    packet = bytearray([config.CMD_LATENCY_PROBE, 1])
+    packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+    manager._write(packet)
+    return log
@@ -2,43 +2,69 @@
 """
 Handles all visual and layout aspects of the dynamic display.
 
-This module is responsible for creating the complete UI image that gets sent
-to the device. It generates a background, draws weather icons, and arranges
-text elements in a clean, structured layout.
+This module composes the UI image that gets sent to the device from a set
+of widgets (time, separator, weather, date) that each declare the state
+they render from. UiRenderer redraws only the widgets whose state changed
+since the last tick and reports exactly which regions it touched, so a
+steady-state tick costs a few tuple compares instead of a full-frame PIL
+render. Rendered patches are cached per (widget, state, theme), so even
+the redraws that do happen usually skip glyph rasterization -- the
+dominant cost in host render profiles.
 """
 from PIL import Image, ImageDraw
 from math import sin, cos, radians
+import numpy as np
+import zlib
 import config
 
+# Gradient backgrounds, cached per (start, end) color pair: a theme only
+# pays for its gradient once, and patch redraws reuse it for free.
+_background_cache = {}
+
 def _draw_vibrant_gradient_background() -> Image.Image:
     """
     Creates a visually appealing, high-contrast diagonal gradient background.
 
     The gradient is calculated based on the (x+y) position of each pixel,
     which produces a smooth diagonal transition between the start and end
-    colors defined in the configuration.
+    colors defined in the configuration. Computed vectorized and cached
+    per theme; callers must not draw on the returned image.
 
     Returns:
         Image.Image: A PIL Image object with the generated gradient.
     """
-    image = Image.new('RGB', (config.LCD_WIDTH, config.LCD_HEIGHT))
-    r1, g1, b1 = config.COLOR_GRADIENT_START
-    r2, g2, b2 = config.COLOR_GRADIENT_END
-    
-    # Calculate the maximum value for normalization
-    max_val = float(config.LCD_WIDTH + config.LCD_HEIGHT)
-
-    for y in range(config.LCD_HEIGHT):
-        for x in range(config.LCD_WIDTH):
-            # Normalize the position to a 0.0-1.0 scale
-            p = (x + y) / max_val
-            # Linearly interpolate each color channel
-            r = int(r1 + (r2 - r1) * p)
-            g = int(g1 + (g2 - g1) * p)
-            b = int(b1 + (b2 - b1) * p)
-            image.putpixel((x, y), (r, g, b))
+    key = (config.COLOR_GRADIENT_START, config.COLOR_GRADIENT_END)
+    cached = _background_cache.get(key)
+    if cached is not None:
+        return cached
+
+    # Normalized (x+y) position for every pixel in one outer sum.
+    p = (np.add.outer(np.arange(config.LCD_HEIGHT), np.arange(config.LCD_WIDTH))
+         / float(config.LCD_WIDTH + config.LCD_HEIGHT))
+    start = np.array(config.COLOR_GRADIENT_START, dtype=float)
+    end = np.array(config.COLOR_GRADIENT_END, dtype=float)
+    rgb = (start + (end - start) * p[..., None]).astype(np.uint8)
+    image = Image.fromarray(rgb, 'RGB')
+    _background_cache[key] = image
     return image
 
+def background_asset() -> tuple[int, Image.Image]:
+    """
+    Returns the current theme's background as a versioned asset.
+
+    The version is derived from the gradient colors, so it changes exactly
+    when the rendered background would: the device flash store (see
+    DeviceManager.upload_assets) keeps the pixels across sessions and the
+    host skips the upload whenever the stored version still matches.
+
+    Returns:
+        tuple: (version, image) where version is a 16-bit content tag and
+        image is the full-panel gradient (callers must not draw on it).
+    """
+    key = (config.COLOR_GRADIENT_START, config.COLOR_GRADIENT_END)
+    version = zlib.crc32(repr(key).encode()) & 0xFFFF
+    return version, _draw_vibrant_gradient_background()
+
 def _create_weather_icon(icon_name: str, size: tuple[int, int]) -> Image.Image:
     """
     Generates high-quality, anti-aliased weather icons with a layered effect.
@@ -177,69 +203,262 @@ def _create_weather_icon(icon_name: str, size: tuple[int, int]) -> Image.Image:
         
     return icon
 
-def create_image(time_str: str, date_str: str, weather_info: dict | None) -> Image.Image:
-    """
-    Composes the final UI by layering text and icons over a gradient background.
+# --- Layout Panes ---
+_SEPARATOR_X = 100
+_PANE_LEFT_WIDTH = _SEPARATOR_X
+_PANE_RIGHT_X_START = _SEPARATOR_X + 1
+_PANE_RIGHT_WIDTH = config.LCD_WIDTH - _PANE_RIGHT_X_START
 
-    The layout is divided into two vertical panes:
-    - Left Pane: Displays the current time, horizontally and vertically centered.
-    - Right Pane: Displays the weather icon, temperature, and date, stacked
-      vertically and centered within the pane.
 
-    Args:
-        time_str (str): The formatted time string (e.g., "14:30").
-        date_str (str): The formatted date string (e.g., "Mon Jan 01").
-        weather_info (dict | None): A dictionary with weather data or None.
+class Widget:
+    """
+    A rectangular UI element that re-renders only when its state changes.
 
-    Returns:
-        Image.Image: The final, composed UI as an RGB PIL Image.
+    Subclasses set `region` (x1, y1, x2, y2) to the area their drawing can
+    touch and implement draw(), which renders from self._state at absolute
+    canvas coordinates. The renderer calls update() each tick with the
+    state the widget should currently show; a True return marks the region
+    dirty.
+
+    `priority` ranks the region for the streamer's transmit ordering
+    (config.PRIORITY_*): what the user is actively watching goes out
+    first when bandwidth is tight.
     """
-    image = _draw_vibrant_gradient_background()
-    # Create a transparent overlay to draw text and icons on
-    overlay = Image.new('RGBA', image.size, (255, 255, 255, 0))
-    draw = ImageDraw.Draw(overlay)
-    
-    # --- Define Layout Panes ---
-    separator_x = 100
-    pane_left_width = separator_x
-    pane_right_x_start = separator_x + 1
-    pane_right_width = config.LCD_WIDTH - pane_right_x_start
-
-    # --- LEFT PANE: Time ---
-    # Center the time text within the left pane
-    time_bbox = draw.textbbox((0, 0), time_str, font=config.FONT_TIME)
-    time_width = time_bbox[2] - time_bbox[0]
-    time_height = time_bbox[3] - time_bbox[1]
-    time_x = (pane_left_width - time_width) // 2 # Center horizontally in the left pane
-    time_y = (config.LCD_HEIGHT - time_height) // 2 - 10 # Minor vertical adjustment
-    draw.text((time_x, time_y), time_str, font=config.FONT_TIME, fill=config.COLOR_TEXT_PRIMARY)
-    
-    # --- Visual Separator ---
-    # A subtle line between the two panes
-    draw.line([(separator_x, 10), (separator_x, config.LCD_HEIGHT - 10)], fill=config.COLOR_SEPARATOR, width=1)
-              
-    # --- RIGHT PANE: Weather and Date (Vertically Stacked) ---
-    if weather_info:
+    region = (0, 0, 0, 0)
+    priority = config.PRIORITY_NORMAL
+
+    def __init__(self):
+        self._state = None
+        self._drawn = False
+
+    def invalidate(self):
+        """Forces the next update() to report dirty (e.g. theme change)."""
+        self._drawn = False
+
+    def update(self, state) -> bool:
+        """Declares the current state; returns True if a redraw is needed."""
+        if self._drawn and state == self._state:
+            return False
+        self._state = state
+        self._drawn = True
+        return True
+
+    def draw(self, draw: ImageDraw.ImageDraw, overlay: Image.Image):
+        raise NotImplementedError
+
+
+class TimeWidget(Widget):
+    """The current time, centered in the left pane."""
+    region = (0, 0, _PANE_LEFT_WIDTH, config.LCD_HEIGHT)
+    # The clock is what a glance checks; its digits must never queue
+    # behind a background repaint.
+    priority = config.PRIORITY_INTERACTIVE
+
+    def draw(self, draw, overlay):
+        time_str = self._state
+        time_bbox = draw.textbbox((0, 0), time_str, font=config.FONT_TIME)
+        time_width = time_bbox[2] - time_bbox[0]
+        time_height = time_bbox[3] - time_bbox[1]
+        time_x = (_PANE_LEFT_WIDTH - time_width) // 2 # Center horizontally in the left pane
+        time_y = (config.LCD_HEIGHT - time_height) // 2 - 10 # Minor vertical adjustment
+        draw.text((time_x, time_y), time_str, font=config.FONT_TIME, fill=config.COLOR_TEXT_PRIMARY)
+
+
+class SeparatorWidget(Widget):
+    """A subtle vertical line between the two panes."""
+    region = (_SEPARATOR_X, 0, _SEPARATOR_X + 1, config.LCD_HEIGHT)
+    priority = config.PRIORITY_DECORATIVE
+
+    def draw(self, draw, overlay):
+        draw.line([(_SEPARATOR_X, 10), (_SEPARATOR_X, config.LCD_HEIGHT - 10)],
+                  fill=config.COLOR_SEPARATOR, width=1)
+
+
+class WeatherWidget(Widget):
+    """Weather icon and temperature, stacked at the top of the right pane."""
+    region = (_PANE_RIGHT_X_START, 0, config.LCD_WIDTH, 62)
+
+    def draw(self, draw, overlay):
+        if self._state is None:
+            return
+        icon_name, temperature = self._state
+
         # 1. Weather Icon (Centered horizontally at the top of the pane)
         icon_size = (36, 36)
-        icon = _create_weather_icon(weather_info['icon'], icon_size)
-        icon_x = pane_right_x_start + (pane_right_width - icon_size[0]) // 2 # Center in right pane
+        icon = _create_weather_icon(icon_name, icon_size)
+        icon_x = _PANE_RIGHT_X_START + (_PANE_RIGHT_WIDTH - icon_size[0]) // 2 # Center in right pane
         overlay.paste(icon, (icon_x, 5), icon)
-        
+
         # 2. Temperature (Centered horizontally below the icon)
-        temp_text = f"{weather_info['temperature']}°"
+        temp_text = f"{temperature}°"
         temp_bbox = draw.textbbox((0, 0), temp_text, font=config.FONT_TEMP)
         temp_width = temp_bbox[2] - temp_bbox[0]
-        temp_x = pane_right_x_start + (pane_right_width - temp_width) // 2 # Center in right pane
+        temp_x = _PANE_RIGHT_X_START + (_PANE_RIGHT_WIDTH - temp_width) // 2 # Center in right pane
         draw.text((temp_x, 38), temp_text, font=config.FONT_TEMP, fill=config.COLOR_TEXT_PRIMARY)
-        
-    # 3. Date (Centered horizontally at the bottom of the pane)
-    date_bbox = draw.textbbox((0, 0), date_str, font=config.FONT_DATE)
-    date_width = date_bbox[2] - date_bbox[0]
-    # Center the date within the right pane.
-    date_x = pane_right_x_start // 2 + (pane_right_width - date_width) // 2
-    draw.text((date_x, 60), date_str, font=config.FONT_DATE, fill=config.COLOR_TEXT_SECONDARY)
-    
-    # Composite the overlay onto the background and return the final image
-    image.paste(overlay, (0, 0), overlay)
-    return image.convert('RGB')
\ No newline at end of file
+
+
+class DateWidget(Widget):
+    """The date, centered at the bottom of the right pane (its centering
+    lets long date strings spill left of the separator, so the region
+    starts well inside the left pane)."""
+    region = (30, 56, config.LCD_WIDTH, config.LCD_HEIGHT)
+
+    def draw(self, draw, overlay):
+        date_str = self._state
+        date_bbox = draw.textbbox((0, 0), date_str, font=config.FONT_DATE)
+        date_width = date_bbox[2] - date_bbox[0]
+        # Center the date within the right pane.
+        date_x = _PANE_RIGHT_X_START // 2 + (_PANE_RIGHT_WIDTH - date_width) // 2
+        draw.text((date_x, 60), date_str, font=config.FONT_DATE, fill=config.COLOR_TEXT_SECONDARY)
+
+
+def _rects_intersect(a: tuple, b: tuple) -> bool:
+    return a[0] < b[2] and b[0] < a[2] and a[1] < b[3] and b[1] < a[3]
+
+
+# Rendered widget patches, keyed on (widget name, declared state, theme
+# colors): glyph rasterization dominates the host render profile, and the
+# same strings recur constantly -- the unchanged date re-rasterizes every
+# minute only because its region overlaps the clock's, and a theme cycle
+# redraws identical content in new colors. A cache hit replaces the PIL
+# text/vector work with one alpha_composite of the stored RGBA patch.
+_patch_cache = {}
+
+# Bounded by wholesale clearing rather than LRU bookkeeping: entries are
+# a few KB each and the working set per theme is four widgets, so the cap
+# only matters across long sessions of unique time strings.
+_PATCH_CACHE_MAX = 256
+
+
+def _theme_key() -> tuple:
+    """The color values render output depends on (see config.cycle_theme)."""
+    return (config.COLOR_GRADIENT_START, config.COLOR_GRADIENT_END,
+            config.COLOR_TEXT_PRIMARY, config.COLOR_TEXT_SECONDARY,
+            config.COLOR_SEPARATOR)
+
+
+def _widget_patch(name: str, widget: Widget) -> Image.Image:
+    """
+    The widget's region rendered from its current state, cached.
+
+    Misses render onto a full-canvas transparent overlay (draw() works at
+    absolute coordinates) and keep the cropped region, so a hit skips the
+    rasterization entirely and hands back pixels identical to a fresh
+    draw.
+    """
+    key = (name, widget._state, _theme_key())
+    patch = _patch_cache.get(key)
+    if patch is None:
+        if len(_patch_cache) >= _PATCH_CACHE_MAX:
+            _patch_cache.clear()
+        canvas = Image.new('RGBA', (config.LCD_WIDTH, config.LCD_HEIGHT),
+                           (255, 255, 255, 0))
+        widget.draw(ImageDraw.Draw(canvas), canvas)
+        patch = canvas.crop(widget.region)
+        _patch_cache[key] = patch
+    return patch
+
+
+def priority_regions() -> list[tuple[tuple, int]]:
+    """
+    (region, priority) for every widget the renderer composes.
+
+    The streamer classifies its dirty rects against these: a rect takes
+    the highest priority of the regions it touches, and anything outside
+    every widget (the background gradient) is decorative by definition.
+    """
+    return [(cls.region, cls.priority)
+            for cls in (TimeWidget, SeparatorWidget, WeatherWidget, DateWidget)]
+
+
+class UiRenderer:
+    """
+    Composes the UI incrementally from dirty-tracked widgets.
+
+    Keeps the composed frame between ticks. render() updates every
+    widget's declared state, redraws only the regions whose state
+    actually changed (re-rendering any widget that overlaps them, so
+    e.g. the date spilling past the separator stays intact), and returns
+    exactly those regions so the streamer can skip diffing entirely when
+    nothing changed.
+    """
+    def __init__(self):
+        self._widgets = {
+            'time': TimeWidget(),
+            'separator': SeparatorWidget(),
+            'weather': WeatherWidget(),
+            'date': DateWidget(),
+        }
+        self._image = None
+
+    def invalidate(self):
+        """Drops the composed frame so the next render() redraws everything
+        (used after a theme change or device reconnect)."""
+        self._image = None
+        for widget in self._widgets.values():
+            widget.invalidate()
+
+    def render(self, time_str: str, date_str: str,
+               weather_info: dict | None) -> tuple[Image.Image, list]:
+        """
+        Brings the composed frame up to date.
+
+        Args:
+            time_str (str): The formatted time string (e.g., "14:30").
+            date_str (str): The formatted date string (e.g., "Mon Jan 01").
+            weather_info (dict | None): A dictionary with weather data or None.
+
+        Returns:
+            tuple: (image, dirty_rects) -- the full composed RGB frame and
+            the list of (x1, y1, x2, y2) regions this call changed; empty
+            when the frame is already current.
+        """
+        full_redraw = self._image is None
+        if full_redraw:
+            self._image = _draw_vibrant_gradient_background().copy()
+            for widget in self._widgets.values():
+                widget.invalidate()
+
+        weather_state = None
+        if weather_info:
+            weather_state = (weather_info['icon'], weather_info['temperature'])
+        states = {'time': time_str, 'separator': config.COLOR_SEPARATOR,
+                  'weather': weather_state, 'date': date_str}
+
+        dirty = [widget.region for name, widget in self._widgets.items()
+                 if widget.update(states[name])]
+        if not dirty:
+            return self._image, []
+
+        # Composite every widget that overlaps a dirty region onto a
+        # transparent overlay, then patch just the dirty regions over the
+        # cached gradient. The patches come from the render cache, so a
+        # widget only pays for rasterization the first time a (state,
+        # theme) combination appears -- the overlapping neighbors dragged
+        # into a redraw are usually unchanged and hit every time.
+        overlay = Image.new('RGBA', self._image.size, (255, 255, 255, 0))
+        for name, widget in self._widgets.items():
+            if any(_rects_intersect(widget.region, rect) for rect in dirty):
+                overlay.alpha_composite(_widget_patch(name, widget),
+                                        (widget.region[0], widget.region[1]))
+
+        background = _draw_vibrant_gradient_background()
+        for region in dirty:
+            patch = background.crop(region).convert('RGBA')
+            patch.alpha_composite(overlay.crop(region))
+            self._image.paste(patch.convert('RGB'), (region[0], region[1]))
+
+        if full_redraw:
+            return self._image, [(0, 0, config.LCD_WIDTH, config.LCD_HEIGHT)]
+        return self._image, dirty
+
+
+def create_image(time_str: str, date_str: str, weather_info: dict | None) -> Image.Image:
+    """
+    One-shot convenience wrapper: composes a full UI frame from scratch.
+
+    The streamer keeps a UiRenderer instance instead, so its steady-state
+    ticks only patch the widgets that changed.
+    """
+    image, _ = UiRenderer().render(time_str, date_str, weather_info)
+    return image
\ No newline at end of file
@@ -0,0 +1,664 @@
+# virtual_device.py
+"""
+Software display sink: the firmware's protocol surface without a board.
+
+Pipeline work on the host -- encoders, flow control, the governor, the
+traffic analyzer -- currently needs a flashed Longan Nano on the desk to
+run at all, and then runs at hardware speed. This module stands in for
+the device behind the same transport seam DeviceManager already uses
+(an object with pyusb-shaped write()/read() calls): it speaks the full
+protocol (capability handshake, credits, sequence NACKs, status pushes,
+latency echoes, the asset store), renders the decoded frame into a
+window, and models the two budgets that shape real behavior -- USB FS
+bulk bandwidth on the OUT path and the panel SPI rate on the blit path
+-- so congestion, credit stalls and governor escalation reproduce on a
+laptop or in CI at full speed.
+
+Enable it with `python display_manager.py virtual`, or set
+DISPLAY_VIRTUAL=1 in the environment to point any tool in this
+directory (latency_probe, soak_bench, the analyzer) at the sink.
+
+What is modeled and what is not: slot geometry, blit timing and the
+drop/NACK path mirror the firmware's slot build (display::constants
+defaults; see the VIRTUAL_* knobs in config.py). Flash pacing is not --
+asset uploads complete instantly -- and on-device text rendering is
+approximated with a host font, so the window is a development aid, not
+a pixel-exact reference.
+"""
+import heapq
+import threading
+import time
+
+import numpy as np
+import usb.core
+from PIL import Image, ImageDraw
+
+import config
+import framecodec
+
+# Modeled per-rect blit overhead: CS assertion plus the CASET/RASET
+# window setup before pixels flow, from the latency probe's measurements
+# of small rects on hardware.
+_RECT_SETUP_SECONDS = 20e-6
+
+# Cadence of unsolicited REPORT_STATUS pushes while unparked; the
+# firmware latches one every 32 SOF frames.
+_STATUS_PUSH_SECONDS = 0.032
+
+_WINDOW_SCALE = 3  # panel pixels are tiny; the window shows them 3x
+
+
+def _rgb888(frame: np.ndarray) -> np.ndarray:
+    """Expands a (h, w) uint16 RGB565 array to (h, w, 3) uint8 RGB."""
+    r = ((frame >> 11) & 0x1F).astype(np.uint8) << 3
+    g = ((frame >> 5) & 0x3F).astype(np.uint8) << 2
+    b = (frame & 0x1F).astype(np.uint8) << 3
+    return np.stack([r, g, b], axis=-1)
+
+
+class _Slot:
+    """One draw task staged toward the modeled blit engine."""
+
+    def __init__(self, seq, x, y, w, h, encoding, enqueued):
+        self.seq = seq
+        self.x, self.y, self.w, self.h = x, y, w, h
+        self.encoding = encoding
+        self.payload = bytearray()
+        self.fill_color = None
+        self.enqueued = enqueued
+        self.held = False  # open display list
+
+    def payload_complete(self) -> bool:
+        """Whether the accumulated payload decodes to the whole rect.
+        Needed on the per-packet path, where the encoded length was
+        never announced (RLE streams vary per rect)."""
+        pixels = self.w * self.h
+        if self.encoding == config.ENC_RLE:
+            return sum(self.payload[0::3]) >= pixels
+        if self.encoding == config.ENC_INDEXED:
+            return len(self.payload) >= pixels
+        return len(self.payload) >= pixels * 2
+
+
+class VirtualDevice:
+    """
+    Drop-in stand-in for the pyusb device handle.
+
+    write() models the bulk OUT link (the call blocks for the burst's
+    wire time, like a synchronous transfer does) and feeds the packets
+    to the protocol model under one lock. read() drains the IN-report
+    queue, materializing blit completions and status pushes as their
+    modeled due times pass -- no background device thread is needed,
+    because reports can only matter once some thread asks for them.
+    """
+
+    is_virtual = True
+
+    def __init__(self):
+        self._lock = threading.Condition()
+        self._closed = False
+        self._in_reports = []  # queued IN packets, oldest first
+        self._due = []  # heap of (done_time, seq, enqueued) blit retirements
+
+        # Slot ring, mirroring the firmware's admission rule: one ring
+        # slot always stays unusable.
+        self._total_slots = config.VIRTUAL_NUM_BUFFERS - 1
+        self._queued = []  # finalized slots waiting on the blit engine
+        self._receiving = None  # slot mid-payload (stream target)
+        self._stream_headerless = 0  # headerless bytes still owed
+        self._slots_used = 0
+        self._busy_until = 0.0  # modeled blit-engine time
+        self._list_open = False
+
+        self._expected_seq = 0
+        self._latency_probe = False
+        self._verify = False
+        self._parked = False
+        self._next_push = time.perf_counter() + _STATUS_PUSH_SECONDS
+
+        self._palette = np.zeros(config.PALETTE_SIZE, dtype=np.uint16)
+        self._assets = {}  # id -> (version, w, h, pixels bytearray)
+        self._asset_rx = None  # (id, version, w, h, buffer) mid-upload
+        self._anim = None  # (first_id, count, x, y, period_s) playing
+        self._anim_index = 0
+        self._anim_deadline = 0.0
+
+        self._stats_packets = 0
+        self._stats_dropped = 0
+        self._stats_rects = 0
+        self._stats_cycles_last = 0
+
+        self.framebuffer = np.zeros(
+            (config.LCD_HEIGHT, config.LCD_WIDTH), dtype=np.uint16)
+        self._fb_dirty = True
+        self._window = _PanelWindow(self) if config.VIRTUAL_WINDOW else None
+
+    # -- transport seam ----------------------------------------------------
+
+    def write(self, endpoint, data, timeout=None):
+        """Accepts one bulk OUT burst at modeled FS bulk bandwidth."""
+        time.sleep(len(data) / config.VIRTUAL_LINK_BYTES_PER_SECOND)
+        with self._lock:
+            if self._closed:
+                raise usb.core.USBError("virtual device closed")
+            for off in range(0, len(data), config.REPORT_LENGTH):
+                self._packet(bytes(data[off:off + config.REPORT_LENGTH]))
+            self._lock.notify_all()
+        return len(data)
+
+    def read(self, endpoint, size, timeout=None):
+        """Returns the next IN report, or raises USBTimeoutError."""
+        deadline = time.perf_counter() + (timeout or 500) / 1000.0
+        with self._lock:
+            while True:
+                now = time.perf_counter()
+                self._materialize(now)
+                if self._in_reports:
+                    return list(self._in_reports.pop(0))
+                if self._closed or now >= deadline:
+                    raise usb.core.USBTimeoutError("no report pending",
+                                                   110, 110)
+                # Sleep until the next modeled event can produce a
+                # report, or the caller's deadline, whichever is first.
+                wake = deadline
+                if self._due:
+                    wake = min(wake, self._due[0][0])
+                if not self._parked:
+                    wake = min(wake, self._next_push)
+                if self._anim is not None:
+                    wake = min(wake, self._anim_deadline)
+                self._lock.wait(max(0.0, wake - now))
+
+    def ctrl_transfer(self, bmRequestType, bRequest, wValue=0, wIndex=0,
+                      data_or_wLength=None, timeout=None):
+        """Models the EP0 vendor query table (firmware vendor_ctl.h)."""
+        if bmRequestType != 0xC0:
+            raise usb.core.USBError("unsupported control request")
+        with self._lock:
+            if self._closed:
+                raise usb.core.USBError("virtual device closed")
+            now = time.perf_counter()
+            self._materialize(now)
+            if bRequest == config.VREQ_STATUS:
+                data = bytes([self._total_slots - self._slots_used,
+                              self._total_slots, 0,
+                              self._stats_rects & 0xFF,
+                              (self._stats_rects >> 8) & 0xFF,
+                              self._stats_dropped & 0xFF,
+                              (self._stats_dropped >> 8) & 0xFF])
+                data += self._stats_cycles_last.to_bytes(4, 'little')
+                data += bytes(5)  # no telemetry rail to report
+            elif bRequest == config.VREQ_BUILD:
+                data = bytes(4)  # fingerprint 0, like _on_get_build
+            elif bRequest == config.VREQ_UPTIME:
+                ticks = int(now * config.DEVICE_CYCLES_PER_SECOND) // 4
+                data = ticks.to_bytes(8, 'little')
+            elif bRequest == config.VREQ_CFG_GET:
+                data = b'\xff\xff\xff\xff'  # no parameter store here
+            else:
+                raise usb.core.USBError("unknown vendor request")
+        if isinstance(data_or_wLength, int):
+            data = data[:data_or_wLength]
+        return list(data)
+
+    def close(self):
+        with self._lock:
+            self._closed = True
+            self._lock.notify_all()
+        if self._window is not None:
+            self._window.stop()
+
+    # -- modeled time ------------------------------------------------------
+
+    def _blit_seconds(self, slot) -> float:
+        """Panel time for one rect: window setup plus the SPI stream."""
+        return (_RECT_SETUP_SECONDS
+                + slot.w * slot.h * 2 / config.VIRTUAL_BLIT_BYTES_PER_SECOND)
+
+    def _materialize(self, now):
+        """Retires every blit due by `now` and emits due status pushes."""
+        while self._due and self._due[0][0] <= now:
+            done, seq, enqueued = heapq.heappop(self._due)
+            self._slots_used -= 1
+            self._stats_rects += 1
+            self._stats_cycles_last = int(
+                (done - enqueued) * config.DEVICE_CYCLES_PER_SECOND)
+            self._report([config.REPORT_CREDITS,
+                          self._total_slots - self._slots_used,
+                          self._total_slots])
+            if self._latency_probe:
+                report = bytearray([config.REPORT_RECT_LATENCY,
+                                    seq & 0xFF, (seq >> 8) & 0xFF])
+                report.extend(self._stats_cycles_last.to_bytes(4, 'little'))
+                self._report(report)
+        while self._anim is not None and now >= self._anim_deadline:
+            first, count, x, y, period = self._anim
+            asset = self._assets.get((first + self._anim_index) & 0xFF)
+            if asset is None:
+                self._anim = None  # wiped store ends playback, like the device
+                break
+            _, w, h, pixels = asset
+            frame = np.frombuffer(bytes(pixels), dtype='<u2')
+            self.framebuffer[y:y + h, x:x + w] = frame.reshape(h, w)
+            self._fb_dirty = True
+            self._anim_index = (self._anim_index + 1) % count
+            self._anim_deadline = max(self._anim_deadline + period,
+                                      now - period)
+        if not self._parked and now >= self._next_push:
+            self._next_push = now + _STATUS_PUSH_SECONDS
+            report = bytearray([config.REPORT_STATUS,
+                                self._total_slots - self._slots_used,
+                                self._total_slots, 0,
+                                self._stats_rects & 0xFF,
+                                (self._stats_rects >> 8) & 0xFF,
+                                self._stats_dropped & 0xFF,
+                                (self._stats_dropped >> 8) & 0xFF])
+            report.extend(self._stats_cycles_last.to_bytes(4, 'little'))
+            self._report(report)
+
+    def _report(self, payload):
+        packet = bytearray(payload)
+        packet.extend([0] * (config.REPORT_LENGTH - len(packet)))
+        self._in_reports.append(packet)
+        self._lock.notify_all()
+
+    # -- protocol model ----------------------------------------------------
+
+    def _note_seq(self, seq):
+        """Firmware-style gap detection: a forward jump NACKs the range."""
+        if seq != self._expected_seq:
+            first, last = self._expected_seq, (seq - 1) & 0xFFFF
+            self._report([config.REPORT_SEQ_NACK,
+                          first & 0xFF, (first >> 8) & 0xFF,
+                          last & 0xFF, (last >> 8) & 0xFF])
+            self._expected_seq = seq
+        self._expected_seq = (self._expected_seq + 1) & 0xFFFF
+
+    def _admit(self, seq, x, y, w, h, encoding):
+        """Takes a slot for one draw task, or drops it like the firmware
+        (no seq consumed, so the next command raises the NACK)."""
+        if self._slots_used >= self._total_slots:
+            self._stats_dropped += 1
+            return None
+        self._note_seq(seq)
+        slot = _Slot(seq, x, y, w, h, encoding, time.perf_counter())
+        self._slots_used += 1
+        slot.held = self._list_open
+        self._report([config.REPORT_CREDITS,
+                      self._total_slots - self._slots_used,
+                      self._total_slots])
+        return slot
+
+    def _finalize(self, slot):
+        """Applies the decoded pixels and queues the slot for the blit
+        engine (or holds it while a display list is open)."""
+        self._apply(slot)
+        if (self._verify and slot.fill_color is None
+                and slot.x + slot.w <= config.LCD_WIDTH
+                and slot.y + slot.h <= config.LCD_HEIGHT):
+            # Verification echo, like the firmware's: checksum the region
+            # as the decoder left it in the framebuffer.
+            region = self.framebuffer[slot.y:slot.y + slot.h,
+                                      slot.x:slot.x + slot.w]
+            crc = framecodec.crc32(region.astype('<u2').tobytes())
+            report = bytearray([config.REPORT_RECT_CRC,
+                                slot.seq & 0xFF, (slot.seq >> 8) & 0xFF])
+            report.extend(crc.to_bytes(4, 'little'))
+            self._report(report)
+        self._queued.append(slot)
+        if not self._list_open:
+            self._dispatch()
+
+    def _dispatch(self):
+        """Schedules every queued slot on the modeled blit engine."""
+        now = time.perf_counter()
+        self._busy_until = max(self._busy_until, now)
+        for slot in self._queued:
+            self._busy_until += self._blit_seconds(slot)
+            heapq.heappush(self._due,
+                           (self._busy_until, slot.seq, slot.enqueued))
+        self._queued = []
+
+    def _apply(self, slot):
+        """Decodes the slot's payload into the framebuffer."""
+        fb = self.framebuffer
+        x, y, w, h = slot.x, slot.y, slot.w, slot.h
+        if x + w > config.LCD_WIDTH or y + h > config.LCD_HEIGHT:
+            return
+        if slot.fill_color is not None:
+            fb[y:y + h, x:x + w] = slot.fill_color
+        elif slot.encoding == config.ENC_RAW:
+            pixels = np.frombuffer(bytes(slot.payload[:w * h * 2]),
+                                   dtype='<u2')
+            fb[y:y + h, x:x + w] = pixels.reshape(h, w)
+        elif slot.encoding == config.ENC_RLE:
+            out = np.zeros(w * h, dtype=np.uint16)
+            pos = 0
+            for i in range(0, len(slot.payload) - 2, 3):
+                count = slot.payload[i]
+                pixel = slot.payload[i + 1] | (slot.payload[i + 2] << 8)
+                out[pos:pos + count] = pixel
+                pos += count
+                if pos >= w * h:
+                    break
+            fb[y:y + h, x:x + w] = out[:w * h].reshape(h, w)
+        elif slot.encoding == config.ENC_INDEXED:
+            indices = np.frombuffer(bytes(slot.payload[:w * h]),
+                                    dtype=np.uint8)
+            fb[y:y + h, x:x + w] = self._palette[indices].reshape(h, w)
+        self._fb_dirty = True
+
+    def _packet(self, pkt):
+        self._stats_packets += 1
+        if self._stream_headerless > 0:
+            # Headerless payload for the announced stream.
+            take = min(self._stream_headerless, len(pkt))
+            self._stream_headerless -= take
+            if self._receiving is not None:
+                self._receiving.payload.extend(pkt[:take])
+                if self._stream_headerless == 0:
+                    self._finalize(self._receiving)
+                    self._receiving = None
+            return
+        cmd = pkt[0]
+        if cmd != config.CMD_IDLE_HINT:
+            self._parked = False
+        handler = self._HANDLERS.get(cmd)
+        if handler is not None:
+            handler(self, pkt)
+
+    def _on_draw_rect(self, pkt):
+        x, y, w, h = pkt[1], pkt[2], pkt[3], pkt[4]
+        seq = pkt[5] | (pkt[6] << 8)
+        encoding = pkt[7]
+        announced = pkt[8] | (pkt[9] << 8)
+        if encoding == config.ENC_RAW:
+            stream = w * h * 2  # raw streams are headerless by geometry
+        else:
+            stream = announced  # single-header stream, or 0 (per-packet)
+        slot = self._admit(seq, x, y, w, h, encoding)
+        if slot is None:
+            # Dropped: the owed headerless payload still crosses the
+            # wire and must be swallowed so the next command byte parses
+            # (per-packet payloads identify themselves and just fall
+            # through to no receiving slot).
+            self._receiving = None
+            self._stream_headerless = stream
+            return
+        self._receiving = slot
+        self._stream_headerless = stream
+
+    def _on_image_data(self, pkt):
+        # Per-packet command-byte payload (RLE records / palette indices).
+        slot = self._receiving
+        if slot is None:
+            return
+        slot.payload.extend(pkt[1:])
+        if slot.payload_complete():
+            self._finalize(slot)
+            self._receiving = None
+
+    def _on_fill_rect(self, pkt):
+        slot = self._admit(pkt[5] | (pkt[6] << 8), pkt[1], pkt[2],
+                           pkt[3], pkt[4], config.ENC_RAW)
+        if slot is not None:
+            slot.fill_color = pkt[7] | (pkt[8] << 8)
+            self._finalize(slot)
+
+    def _on_multi_fill(self, pkt):
+        seq = pkt[2] | (pkt[3] << 8)
+        for i in range(pkt[1]):
+            rec = pkt[4 + i * 6:10 + i * 6]
+            slot = self._admit((seq + i) & 0xFFFF, rec[0], rec[1],
+                               rec[2], rec[3], config.ENC_RAW)
+            if slot is None:
+                break
+            slot.fill_color = rec[4] | (rec[5] << 8)
+            self._finalize(slot)
+
+    def _on_set_palette(self, pkt):
+        start, count = pkt[1], pkt[2]
+        for i in range(count):
+            self._palette[start + i] = pkt[3 + i * 2] | (pkt[4 + i * 2] << 8)
+
+    def _on_draw_text(self, pkt):
+        # Approximate: the firmware rasterizes from its baked atlas; here
+        # PIL's built-in font stands in so the window stays readable.
+        x, y, font = pkt[1], pkt[2], pkt[3]
+        fg = pkt[4] | (pkt[5] << 8)
+        bg = pkt[6] | (pkt[7] << 8)
+        seq = pkt[8] | (pkt[9] << 8)
+        text = bytes(pkt[11:11 + pkt[10]]).decode('ascii', errors='replace')
+        cell_w, cell_h = (16, 24) if font == config.FONT_16X24 else (8, 16)
+        w = min(len(text) * cell_w, config.LCD_WIDTH - x)
+        h = min(cell_h, config.LCD_HEIGHT - y)
+        if w <= 0 or h <= 0:
+            self._note_seq(seq)
+            return
+        slot = self._admit(seq, x, y, w, h, config.ENC_RAW)
+        if slot is None:
+            return
+        image = Image.new('RGB', (w, h),
+                          tuple(int(c) for c in _rgb888(
+                              np.array([[bg]], dtype=np.uint16))[0, 0]))
+        draw = ImageDraw.Draw(image)
+        draw.text((0, 2), text, fill=tuple(
+            int(c) for c in _rgb888(np.array([[fg]], dtype=np.uint16))[0, 0]))
+        rgb = np.asarray(image, dtype=np.uint16)
+        slot.payload = bytearray((((rgb[..., 0] & 0xF8) << 8)
+                                  | ((rgb[..., 1] & 0xFC) << 3)
+                                  | (rgb[..., 2] >> 3))
+                                 .astype('<u2').tobytes())
+        self._finalize(slot)
+
+    def _on_set_scroll(self, pkt):
+        # The scroll registers remap what the controller displays without
+        # touching frame memory; the window models that as a column roll
+        # of the displayed image within [x, x+w).
+        x, w, offset = pkt[1], pkt[2], pkt[3]
+        self._note_seq(pkt[4] | (pkt[5] << 8))
+        if w and x + w <= config.LCD_WIDTH:
+            window = self.framebuffer[:, x:x + w]
+            self.framebuffer[:, x:x + w] = np.roll(window, -offset, axis=1)
+            self._fb_dirty = True
+
+    def _on_get_caps(self, pkt):
+        flags = (config.CAPS_SINGLE_HEADER | config.CAPS_DISPLAY_LISTS
+                 | config.CAPS_STATUS_PUSH)
+        report = bytearray([config.REPORT_CAPS, config.CAPS_VERSION,
+                            config.LCD_WIDTH, config.LCD_HEIGHT,
+                            config.VIRTUAL_NUM_BUFFERS,
+                            config.VIRTUAL_BUFFER_SIZE & 0xFF,
+                            (config.VIRTUAL_BUFFER_SIZE >> 8) & 0xFF])
+        report.extend((0).to_bytes(4, 'little'))  # no resident full frame
+        report.append(flags)
+        report.append(config.PIXEL_FORMAT_RGB565)
+        self._report(report)
+
+    def _on_get_stats(self, pkt):
+        report = bytearray([config.REPORT_STATS])
+        for counter in (self._stats_packets, self._stats_dropped,
+                        self._stats_rects, 0, self._stats_cycles_last):
+            report.extend((counter & 0xFFFFFFFF).to_bytes(4, 'little'))
+        self._report(report)
+
+    def _on_get_build(self, pkt):
+        # The sink has no generated buildinfo.h; it names itself so any
+        # measurement record keyed on the fingerprint can never be
+        # mistaken for one taken against real hardware.
+        text = b"virtual sink"
+        report = bytearray([config.REPORT_BUILD])
+        report.extend((0).to_bytes(4, 'little'))
+        report.append(len(text))
+        report.extend(text)
+        self._report(report)
+
+    def _on_latency_probe(self, pkt):
+        self._latency_probe = bool(pkt[1])
+
+    def _on_verify_mode(self, pkt):
+        self._verify = bool(pkt[1])
+
+    def _on_idle_hint(self, pkt):
+        self._parked = bool(pkt[1])
+        if not self._parked:
+            self._next_push = time.perf_counter()
+
+    def _on_list_begin(self, pkt):
+        self._list_open = True
+
+    def _on_list_commit(self, pkt):
+        self._list_open = False
+        self._dispatch()
+
+    def _on_get_assets(self, pkt):
+        state = (config.ASSET_STATE_WRITING if self._asset_rx is not None
+                 else config.ASSET_STATE_IDLE)
+        received = (len(self._asset_rx[4]) if self._asset_rx is not None
+                    else 0)
+        report = bytearray([config.REPORT_ASSETS, state])
+        report.extend(received.to_bytes(4, 'little'))
+        report.append(len(self._assets))
+        for asset_id, (version, _, _, _) in self._assets.items():
+            report.extend([asset_id, version & 0xFF, (version >> 8) & 0xFF])
+        self._report(report)
+
+    def _on_asset_begin(self, pkt):
+        if pkt[1] & 0x01:
+            self._assets.clear()  # wipe; instant here, paged on hardware
+        self._asset_rx = (pkt[2], pkt[3] | (pkt[4] << 8), pkt[5], pkt[6],
+                          bytearray())
+
+    def _on_asset_data(self, pkt):
+        if self._asset_rx is None:
+            return
+        asset_id, version, w, h, buf = self._asset_rx
+        buf.extend(pkt[2:2 + pkt[1]])
+        if len(buf) >= w * h * 2:
+            self._assets[asset_id] = (version, w, h, bytes(buf[:w * h * 2]))
+            self._asset_rx = None
+
+    def _on_draw_asset(self, pkt):
+        asset = self._assets.get(pkt[1])
+        seq = pkt[4] | (pkt[5] << 8)
+        if asset is None:
+            self._note_seq(seq)
+            return
+        version, w, h, pixels = asset
+        slot = self._admit(seq, pkt[2], pkt[3], w, h, config.ENC_RAW)
+        if slot is not None:
+            slot.payload = bytearray(pixels)
+            self._finalize(slot)
+
+    def _on_anim_play(self, pkt):
+        # Playback timing lives on the device; the sink keeps the
+        # parameters so _push_frames can cycle the stored frames on the
+        # same schedule. count = 0 stops, like the firmware.
+        self._note_seq(pkt[7] | (pkt[8] << 8))
+        if pkt[2] == 0:
+            self._anim = None
+            return
+        self._anim = (pkt[1], pkt[2], pkt[3], pkt[4],
+                      max(pkt[5] | (pkt[6] << 8), 16) / 1000.0)
+        self._anim_index = 0
+        self._anim_deadline = time.perf_counter()
+
+    _HANDLERS = {
+        config.CMD_DRAW_RECT: _on_draw_rect,
+        config.CMD_IMAGE_DATA: _on_image_data,
+        config.CMD_IMAGE_DATA_RLE: _on_image_data,
+        config.CMD_IMAGE_DATA_IDX: _on_image_data,
+        config.CMD_FILL_RECT: _on_fill_rect,
+        config.CMD_MULTI_FILL: _on_multi_fill,
+        config.CMD_SET_PALETTE: _on_set_palette,
+        config.CMD_DRAW_TEXT: _on_draw_text,
+        config.CMD_SET_SCROLL: _on_set_scroll,
+        config.CMD_GET_CAPS: _on_get_caps,
+        config.CMD_GET_STATS: _on_get_stats,
+        config.CMD_GET_BUILD: _on_get_build,
+        config.CMD_LATENCY_PROBE: _on_latency_probe,
+        config.CMD_VERIFY_MODE: _on_verify_mode,
+        config.CMD_IDLE_HINT: _on_idle_hint,
+        config.CMD_LIST_BEGIN: _on_list_begin,
+        config.CMD_LIST_COMMIT: _on_list_commit,
+        config.CMD_GET_ASSETS: _on_get_assets,
+        config.CMD_ASSET_BEGIN: _on_asset_begin,
+        config.CMD_ASSET_DATA: _on_asset_data,
+        config.CMD_DRAW_ASSET: _on_draw_asset,
+        config.CMD_ANIM_PLAY: _on_anim_play,
+    }
+
+
+class _PanelWindow:
+    """
+    Shows the virtual panel's framebuffer.
+
+    A tkinter window on its own thread where a display is available;
+    headless sessions (CI) fall back to a periodic PNG snapshot at
+    config.VIRTUAL_SNAPSHOT_PATH, so a failing pipeline run still
+    leaves evidence of what the panel ended up showing.
+    """
+
+    def __init__(self, device):
+        self._device = device
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+
+    def _image(self) -> Image.Image:
+        frame = _rgb888(self._device.framebuffer)
+        image = Image.fromarray(frame, 'RGB')
+        return image.resize((config.LCD_WIDTH * _WINDOW_SCALE,
+                             config.LCD_HEIGHT * _WINDOW_SCALE),
+                            Image.NEAREST)
+
+    def _run(self):
+        try:
+            import tkinter
+            root = tkinter.Tk()
+        except Exception:
+            self._run_headless()
+            return
+        root.title("virtual panel")
+        root.resizable(False, False)
+        label = tkinter.Label(root)
+        label.pack()
+        photo = None  # kept referenced; tk only borrows it
+        while not self._stop.is_set():
+            if self._device._fb_dirty:
+                self._device._fb_dirty = False
+                # PhotoImage reads PPM directly; no ImageTk dependency.
+                image = self._image()
+                ppm = (b"P6 %d %d 255\n" % image.size) + image.tobytes()
+                photo = tkinter.PhotoImage(data=ppm)
+                label.configure(image=photo)
+            try:
+                root.update()
+            except tkinter.TclError:
+                break  # window closed
+            time.sleep(0.05)
+        try:
+            root.destroy()
+        except tkinter.TclError:
+            pass
+
+    def _run_headless(self):
+        while not self._stop.is_set():
+            if self._device._fb_dirty:
+                self._device._fb_dirty = False
+                self._image().save(config.VIRTUAL_SNAPSHOT_PATH)
+            time.sleep(1.0)
+        self._image().save(config.VIRTUAL_SNAPSHOT_PATH)
+
+
+def open_device() -> VirtualDevice:
+    """Creates the sink; DeviceManager.connect() calls this when
+    config.VIRTUAL_DEVICE is set."""
+    print("--- Virtual display sink: "
+          f"{config.VIRTUAL_NUM_BUFFERS} buffers of "
+          f"{config.VIRTUAL_BUFFER_SIZE} bytes, link "
+          f"{config.VIRTUAL_LINK_BYTES_PER_SECOND // 1024} KiB/s ---")
+    return VirtualDevice()
@@ -3,8 +3,12 @@
 Handles fetching and parsing weather data from the free Open-Meteo API.
 
 This module provides a simple interface to get current weather conditions
-for a given latitude and longitude.
+for a given latitude and longitude. WeatherService wraps the fetch in a
+background thread with a cached last-good snapshot, so the render path
+always reads memory and never waits on the network.
 """
+import threading
+import time
 import requests
 from typing import Optional, Dict, Any
 
@@ -43,6 +47,79 @@ def get_weather(lat: float, lon: float) -> Optional[Dict[str, Any]]:
         print(f"Error fetching weather: {e}")
         return None
 
+class WeatherService:
+    """
+    Serves weather data from memory, refreshed by a background thread.
+
+    get_weather() blocks for up to its network timeout, which used to
+    stall the display pipeline for seconds whenever the API was slow.
+    The service fetches on its own daemon thread at a fixed cadence
+    (retrying sooner after a failure) and keeps the last-good snapshot;
+    current() is a lock-protected read that never touches the network.
+    """
+    def __init__(self, lat: float, lon: float, refresh_seconds: float,
+                 retry_seconds: float = 60.0,
+                 max_age_seconds: float = 3 * 3600.0):
+        """
+        Args:
+            lat, lon: Coordinates passed through to get_weather().
+            refresh_seconds: Snapshot TTL; how often to fetch new data.
+            retry_seconds: Fetch retry delay after a failed attempt.
+            max_age_seconds: Once the snapshot is older than this (every
+                fetch failing for hours), current() reports None rather
+                than keep showing long-stale data.
+        """
+        self._lat = lat
+        self._lon = lon
+        self._refresh_seconds = refresh_seconds
+        self._retry_seconds = retry_seconds
+        self._max_age_seconds = max_age_seconds
+        self._lock = threading.Lock()
+        self._snapshot: Optional[Dict[str, Any]] = None
+        self._fetched_at = 0.0
+        self._stop_event = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    def start(self):
+        """Starts the background fetch thread (idempotent)."""
+        if self._thread and self._thread.is_alive():
+            return
+        self._stop_event.clear()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """Signals the fetch thread to exit."""
+        self._stop_event.set()
+
+    def current(self) -> Optional[Dict[str, Any]]:
+        """
+        Returns the cached weather snapshot without blocking.
+
+        None until the first successful fetch, and again once the data
+        has gone stale beyond max_age_seconds.
+        """
+        with self._lock:
+            if self._snapshot is None:
+                return None
+            if (time.time() - self._fetched_at) > self._max_age_seconds:
+                return None
+            return self._snapshot
+
+    def _run(self):
+        while not self._stop_event.is_set():
+            weather_info = get_weather(self._lat, self._lon)
+            if weather_info is not None:
+                with self._lock:
+                    self._snapshot = weather_info
+                    self._fetched_at = time.time()
+                delay = self._refresh_seconds
+            else:
+                # Keep serving the last-good snapshot and retry sooner.
+                delay = self._retry_seconds
+            self._stop_event.wait(delay)
+
+
 def _map_weather_code_to_icon(code: int, is_day: int) -> str:
     """
     Maps WMO weather interpretation codes to our internal icon names,
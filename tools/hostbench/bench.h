@@ -0,0 +1,126 @@
+/*!
+    \file    bench.h
+    \brief   Minimal Google-Benchmark-style harness for host builds
+
+    The device-logic modules (DisplayManager protocol parsing, the ring
+    buffer, decoders) are pure code; compiled for the host against the
+    stub headers in tools/hostbench/stubs they can be measured and
+    regression-tested per commit without flashing a board. This header
+    is the whole framework: BENCHMARK(fn) registers a case, the runner
+    calibrates the iteration count until a case runs for at least
+    ~200 ms, then reports ns/op and - when the case calls
+    SetBytesProcessed() - MB/s.
+
+    Usage mirrors the Google Benchmark idiom:
+
+        static void bm_decode(bench::State& state) {
+            while (state.KeepRunning()) {
+                decode(packet, sizeof packet);
+            }
+            state.SetBytesProcessed(state.iterations() * sizeof packet);
+        }
+        BENCHMARK(bm_decode);
+        BENCHMARK_MAIN();
+
+    Numbers are host numbers: they track relative regressions between
+    commits, not absolute device performance.
+*/
+
+#ifndef HOSTBENCH_BENCH_H
+#define HOSTBENCH_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace bench {
+
+class State {
+public:
+    explicit State(int64_t iterations) : m_iterations(iterations) {}
+
+    bool KeepRunning() { return m_done++ < m_iterations; }
+    int64_t iterations() const { return m_iterations; }
+    void SetBytesProcessed(int64_t bytes) { m_bytes = bytes; }
+    int64_t bytes_processed() const { return m_bytes; }
+
+private:
+    int64_t m_iterations;
+    int64_t m_done = 0;
+    int64_t m_bytes = 0;
+};
+
+using CaseFn = void (*)(State&);
+
+struct Case {
+    const char* name;
+    CaseFn fn;
+};
+
+inline std::vector<Case>& registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int register_case(const char* name, CaseFn fn) {
+    registry().push_back({name, fn});
+    return static_cast<int>(registry().size());
+}
+
+inline double run_once(CaseFn fn, int64_t iterations, int64_t& bytes) {
+    State state(iterations);
+    auto start = std::chrono::steady_clock::now();
+    fn(state);
+    auto stop = std::chrono::steady_clock::now();
+    bytes = state.bytes_processed();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+inline int run_all(int argc, char** argv) {
+    // An optional argument filters cases by substring, as in the original.
+    const char* filter = (argc > 1) ? argv[1] : nullptr;
+
+    std::printf("%-40s %15s %15s %12s\n", "Benchmark", "Time", "Iterations", "Throughput");
+    std::printf("%.*s\n", 86,
+                "--------------------------------------------------------------"
+                "------------------------------");
+
+    for (const Case& c : registry()) {
+        if (filter && !std::strstr(c.name, filter)) continue;
+
+        // Calibrate: grow the iteration count until the case runs long
+        // enough for the clock resolution not to matter.
+        int64_t iterations = 1;
+        int64_t bytes = 0;
+        double seconds = run_once(c.fn, iterations, bytes);
+        while (seconds < 0.2 && iterations < (int64_t(1) << 40)) {
+            int64_t grow = (seconds > 1e-4)
+                ? static_cast<int64_t>(iterations * (0.25 / seconds)) + 1
+                : iterations * 100;
+            iterations = grow;
+            seconds = run_once(c.fn, iterations, bytes);
+        }
+
+        double ns_per_op = seconds * 1e9 / static_cast<double>(iterations);
+        std::printf("%-40s %12.1f ns %15lld", c.name, ns_per_op,
+                    static_cast<long long>(iterations));
+        if (bytes > 0) {
+            double mb_per_s = static_cast<double>(bytes) / seconds / 1e6;
+            std::printf(" %9.1f MB/s", mb_per_s);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+} // namespace bench
+
+#define BENCHMARK(fn) \
+    static const int fn##_registered = ::bench::register_case(#fn, fn)
+
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return ::bench::run_all(argc, argv); }
+
+#endif // HOSTBENCH_BENCH_H
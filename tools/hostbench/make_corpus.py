@@ -0,0 +1,108 @@
+"""Generate a synthetic replay corpus for the host bench.
+
+The corpus cases in prj_usb_composite/hostbench/bench_display.cpp replay
+captured wire bursts through the real decode paths. A capture needs a
+live session (config.CAPTURE_CORPUS_PATH in display_manager.py); this
+writes a small synthetic one in the same [u32 LE length][burst] format
+so the replay machinery can be smoke-tested without a board: a mix of
+raw, RLE and palettized rects plus fills, every packet padded to the
+64-byte wire report like the capturing host emits. Delta rects are
+deliberately absent - a caps-aware host never sends them to a
+DISPLAY_FULL_FRAME=0 build, which is what the bench compiles.
+
+Usage: python make_corpus.py <output-file>
+"""
+
+import random
+import struct
+import sys
+
+CMD_DRAW_RECT = 0x06
+CMD_FILL_RECT = 0x07
+CMD_SET_PALETTE = 0x0A
+
+ENC_RAW = 0
+ENC_RLE = 1
+ENC_INDEXED = 2
+
+PACKET_BYTES = 64
+
+_sequence = 0
+
+
+def _next_seq():
+    global _sequence
+    seq = _sequence
+    _sequence = (_sequence + 1) & 0xFFFF
+    return seq
+
+
+def _pad(packet):
+    return bytes(packet) + b"\x00" * (PACKET_BYTES - len(packet))
+
+
+def _draw_header(x, y, w, h, encoding, stream_len):
+    return _pad(struct.pack(
+        "<BBBBBHBH", CMD_DRAW_RECT, x, y, w, h, _next_seq(),
+        encoding, stream_len))
+
+
+def _payload_packets(payload):
+    return [_pad(payload[off:off + PACKET_BYTES])
+            for off in range(0, len(payload), PACKET_BYTES)]
+
+
+def raw_rect(rng, w, h):
+    payload = rng.randbytes(w * h * 2)
+    return [_draw_header(0, 0, w, h, ENC_RAW, 0)] + _payload_packets(payload)
+
+
+def rle_rect(rng, w, h):
+    runs = bytearray()
+    pixels = w * h
+    while pixels:
+        count = min(pixels, rng.randint(1, 160))
+        runs += struct.pack("<BH", count, rng.getrandbits(16))
+        pixels -= count
+    return ([_draw_header(0, 0, w, h, ENC_RLE, len(runs))]
+            + _payload_packets(bytes(runs)))
+
+
+def indexed_rect(rng, w, h):
+    palette = struct.pack("<BBB", CMD_SET_PALETTE, 0, 16)
+    palette += struct.pack("<16H", *(rng.getrandbits(16) for _ in range(16)))
+    indices = bytes(rng.randint(0, 15) for _ in range(w * h))
+    return ([_pad(palette),
+             _draw_header(0, 0, w, h, ENC_INDEXED, len(indices))]
+            + _payload_packets(indices))
+
+
+def fill_rect(rng, w, h):
+    return [_pad(struct.pack("<BBBBBHH", CMD_FILL_RECT, 0, 0, w, h,
+                             _next_seq(), rng.getrandbits(16)))]
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__, file=sys.stderr)
+        sys.exit(1)
+
+    rng = random.Random(1)  # deterministic: same corpus every run
+    bursts = []
+    for _ in range(8):
+        for w, h in ((40, 40), (16, 12), (64, 8)):
+            bursts.append(raw_rect(rng, w, h))
+            bursts.append(rle_rect(rng, w, h))
+            bursts.append(indexed_rect(rng, w, h))
+            bursts.append(fill_rect(rng, w, h))
+
+    with open(sys.argv[1], "wb") as out:
+        for packets in bursts:
+            burst = b"".join(packets)
+            out.write(struct.pack("<I", len(burst)))
+            out.write(burst)
+    print(f"wrote {len(bursts)} bursts to {sys.argv[1]}")
+
+
+if __name__ == "__main__":
+    main()
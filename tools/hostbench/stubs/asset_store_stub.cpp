@@ -0,0 +1,109 @@
+/*!
+    \file    asset_store_stub.cpp
+    \brief   Host stand-in for the flash asset store
+
+    Implements the asset_store.h API over a RAM array instead of the FMC,
+    so display_manager.cpp links on the host and its asset command paths
+    can be exercised. Uploads complete synchronously inside poll() just
+    as the real store does from the main loop, only without the erase
+    and programming stalls.
+*/
+
+#include "asset_store.h"
+
+#include <cstring>
+
+namespace assets {
+
+namespace {
+
+constexpr uint32_t StoreBytes = 32 * 1024;
+
+uint8_t s_store[StoreBytes];
+uint32_t s_write_addr = 0;
+uint32_t s_data_remaining = 0;
+StoreState s_state = StoreState::IDLE;
+uint32_t s_bytes_received = 0;
+bool s_info_requested = false;
+
+uint32_t asset_span(const AssetHeader* h) {
+    return sizeof(AssetHeader) + ((static_cast<uint32_t>(h->length) + 3u) & ~3u);
+}
+
+} // namespace
+
+void init() {
+    memset(s_store, 0xFF, sizeof(s_store));
+    s_write_addr = 0;
+    s_state = StoreState::IDLE;
+}
+
+const AssetHeader* find(uint8_t id) {
+    uint32_t addr = 0;
+    while ((addr + sizeof(AssetHeader)) <= s_write_addr) {
+        const AssetHeader* h = reinterpret_cast<const AssetHeader*>(&s_store[addr]);
+        if (h->magic != AssetMagic) break;
+        if (h->id == id) return h;
+        addr += asset_span(h);
+    }
+    return nullptr;
+}
+
+const uint8_t* pixels(const AssetHeader* header) {
+    return reinterpret_cast<const uint8_t*>(header) + sizeof(AssetHeader);
+}
+
+uint32_t directory(const AssetHeader** out, uint32_t max) {
+    uint32_t count = 0;
+    uint32_t addr = 0;
+    while (count < max && (addr + sizeof(AssetHeader)) <= s_write_addr) {
+        const AssetHeader* h = reinterpret_cast<const AssetHeader*>(&s_store[addr]);
+        if (h->magic != AssetMagic) break;
+        out[count++] = h;
+        addr += asset_span(h);
+    }
+    return count;
+}
+
+void beginUpload(uint8_t id, uint16_t version, uint8_t w, uint8_t h, bool wipe) {
+    if (s_state == StoreState::WRITING) return;
+    if (wipe) {
+        memset(s_store, 0xFF, sizeof(s_store));
+        s_write_addr = 0;
+    }
+    uint32_t length = static_cast<uint32_t>(w) * static_cast<uint32_t>(h) * 2u;
+    AssetHeader header = {AssetMagic, id, w, h, 0, version,
+                          static_cast<uint16_t>(length)};
+    if (length == 0 || (s_write_addr + asset_span(&header)) > sizeof(s_store)) {
+        s_state = StoreState::ERROR;
+        return;
+    }
+    memcpy(&s_store[s_write_addr], &header, sizeof(header));
+    s_write_addr += sizeof(header);
+    s_data_remaining = length;
+    s_bytes_received = 0;
+    s_state = StoreState::WRITING;
+}
+
+void stageData(const uint8_t* data, uint32_t len) {
+    if (s_state != StoreState::WRITING) return;
+    if (len > s_data_remaining) len = s_data_remaining;
+    memcpy(&s_store[s_write_addr], data, len);
+    s_write_addr += len;
+    s_bytes_received += len;
+    s_data_remaining -= len;
+    if (s_data_remaining == 0) {
+        s_write_addr = (s_write_addr + 3u) & ~3u;
+        s_state = StoreState::IDLE;
+    }
+}
+
+void requestInfo()      { s_info_requested = true; }
+bool infoRequested()    { return s_info_requested; }
+void clearInfoRequest() { s_info_requested = false; }
+StoreState state()      { return s_state; }
+uint32_t bytesReceived(){ return s_bytes_received; }
+
+void poll() {}
+
+} // namespace assets
@@ -0,0 +1,119 @@
+/*!
+    \file    fwup_stub.cpp
+    \brief   Host stand-in for the delta firmware updater
+
+    Implements the fwup.h API over a RAM image instead of the FMC, so
+    display_manager.cpp links on the host and its FW_* command dispatch
+    can be exercised. Delta records patch the RAM image synchronously
+    inside poll(), like the real updater drains its staging ring from
+    the main loop, only without erase stalls or a base image to verify:
+    begin() always matches, since the host has no running firmware to
+    diff against.
+*/
+
+#include "fwup.h"
+#include "display_protocol.h"
+
+#include <cstring>
+
+namespace fwup {
+
+namespace {
+
+constexpr uint32_t ImageBytes = 96 * 1024;
+constexpr uint32_t PageBytes = 1024;
+
+uint8_t s_image[ImageBytes];
+uint8_t s_staging[4096];
+uint32_t s_staged = 0;
+uint32_t s_image_len = 0;
+uint32_t s_target_crc = 0;
+uint16_t s_pages_written = 0;
+uint32_t s_bytes_received = 0;
+bool s_page_touched[ImageBytes / PageBytes];
+bool s_apply_pending = false;
+bool s_info_requested = false;
+uint8_t s_state = display::wire::FwStateIdle;
+
+} // namespace
+
+void begin(uint32_t base_crc, uint32_t target_crc)
+{
+    (void)base_crc;
+    if (s_state == display::wire::FwStateReceiving) return;
+    s_target_crc = target_crc;
+    s_staged = 0;
+    s_bytes_received = 0;
+    s_pages_written = 0;
+    s_apply_pending = false;
+    memset(s_page_touched, 0, sizeof(s_page_touched));
+    s_state = display::wire::FwStateReceiving;
+}
+
+void stageData(const uint8_t* data, uint32_t len)
+{
+    if (s_state != display::wire::FwStateReceiving) return;
+    uint32_t room = sizeof(s_staging) - s_staged;
+    if (len > room) len = room;
+    memcpy(&s_staging[s_staged], data, len);
+    s_staged += len;
+}
+
+void apply()
+{
+    if (s_state == display::wire::FwStateReceiving) s_apply_pending = true;
+}
+
+void requestInfo()      { s_info_requested = true; }
+bool infoRequested()    { return s_info_requested; }
+void clearInfoRequest() { s_info_requested = false; }
+uint8_t state()         { return s_state; }
+uint16_t pagesWritten() { return s_pages_written; }
+uint32_t bytesReceived(){ return s_bytes_received; }
+uint32_t imageCrc()     { return 0; }
+uint32_t imageLen()     { return s_image_len; }
+
+void poll()
+{
+    if (s_state != display::wire::FwStateReceiving) return;
+
+    // Drain complete [offset u32 LE, len u16 LE, data] records.
+    uint32_t pos = 0;
+    while (s_staged - pos >= 6) {
+        uint32_t offset = static_cast<uint32_t>(s_staging[pos])
+                        | (static_cast<uint32_t>(s_staging[pos + 1]) << 8)
+                        | (static_cast<uint32_t>(s_staging[pos + 2]) << 16)
+                        | (static_cast<uint32_t>(s_staging[pos + 3]) << 24);
+        uint32_t len = static_cast<uint32_t>(s_staging[pos + 4])
+                     | (static_cast<uint32_t>(s_staging[pos + 5]) << 8);
+        if (s_staged - pos - 6 < len) break;
+        if (offset + len <= ImageBytes) {
+            memcpy(&s_image[offset], &s_staging[pos + 6], len);
+            s_bytes_received += len;
+            if (offset + len > s_image_len) s_image_len = offset + len;
+            for (uint32_t p = offset / PageBytes;
+                 p <= (offset + len - 1) / PageBytes; p++) {
+                if (!s_page_touched[p]) {
+                    s_page_touched[p] = true;
+                    s_pages_written++;
+                }
+            }
+        } else {
+            s_state = display::wire::FwStateError;
+            return;
+        }
+        pos += 6 + len;
+    }
+    memmove(s_staging, &s_staging[pos], s_staged - pos);
+    s_staged -= pos;
+
+    if (s_apply_pending && s_staged == 0) {
+        s_apply_pending = false;
+        // No flash CRC to re-verify on the host; a fully drained
+        // staging buffer is the whole success condition.
+        (void)s_target_crc;
+        s_state = display::wire::FwStateDone;
+    }
+}
+
+} // namespace fwup
@@ -0,0 +1,41 @@
+/*!
+    \file    gd32vf103_crc.h
+    \brief   Host stand-in for the hardware CRC unit
+
+    Software model of the peripheral's fixed algorithm - polynomial
+    0x04C11DB7, seed 0xFFFFFFFF, one 32-bit word per feed digested MSB
+    first, no bit reflection, no final XOR (the same variant
+    tools/display_manager/framecodec.py documents) - so the integrity
+    and verify paths in display_manager.cpp produce real, comparable
+    checksums on the host instead of being compiled out.
+*/
+
+#ifndef HOSTBENCH_GD32VF103_CRC_H
+#define HOSTBENCH_GD32VF103_CRC_H
+
+#include <stdint.h>
+
+static uint32_t hostbench_crc_value = 0xFFFFFFFFu;
+
+static inline void crc_data_register_reset(void)
+{
+    hostbench_crc_value = 0xFFFFFFFFu;
+}
+
+static inline uint32_t crc_data_register_read(void)
+{
+    return hostbench_crc_value;
+}
+
+static inline uint32_t crc_single_data_calculate(uint32_t sdata)
+{
+    uint32_t crc = hostbench_crc_value ^ sdata;
+    int bit;
+    for (bit = 0; bit < 32; bit++) {
+        crc = (crc & 0x80000000u) ? ((crc << 1) ^ 0x04C11DB7u) : (crc << 1);
+    }
+    hostbench_crc_value = crc;
+    return crc;
+}
+
+#endif /* HOSTBENCH_GD32VF103_CRC_H */
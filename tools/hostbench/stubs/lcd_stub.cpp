@@ -0,0 +1,71 @@
+/*!
+    \file    lcd_stub.cpp
+    \brief   Host stand-in for the ST7735S DMA driver
+
+    Implements the lcd.h API against memory instead of SPI0: uploads are
+    consumed immediately and the transfer-complete callback fires
+    synchronously, once per rect, exactly as the DMA interrupt would
+    (just with zero latency). That keeps the DisplayManager slot
+    pipeline advancing on the host so its full receive -> decode ->
+    retire path can be benchmarked. Byte and rect counters let a
+    harness assert on what reached the "panel".
+*/
+
+extern "C" {
+#include "lcd.h"
+}
+
+#include "lcd_stub.h"
+
+static void (*s_dma_done_callback)(void) = nullptr;
+
+namespace hostbench {
+unsigned long lcd_bytes_written = 0;
+unsigned long lcd_rects_written = 0;
+} // namespace hostbench
+
+extern "C" {
+
+void lcd_init(void) {}
+
+void lcd_write_u16(int, int, int w, int h, const void*)
+{
+    hostbench::lcd_bytes_written += (unsigned long)(w * h) * 2u;
+    hostbench::lcd_rects_written++;
+    if (s_dma_done_callback) s_dma_done_callback();
+}
+
+void lcd_fill_u16(int, int, int w, int h, uint16_t)
+{
+    hostbench::lcd_bytes_written += (unsigned long)(w * h) * 2u;
+    hostbench::lcd_rects_written++;
+    if (s_dma_done_callback) s_dma_done_callback();
+}
+
+int lcd_write_rects(const lcd_blit_desc* rects, int count)
+{
+    for (int i = 0; i < count; i++) {
+        hostbench::lcd_bytes_written += (unsigned long)(rects[i].w * rects[i].h) * 2u;
+        hostbench::lcd_rects_written++;
+        if (s_dma_done_callback) s_dma_done_callback();
+    }
+    return 0;
+}
+
+int lcd_dma_busy(void) { return 0; }
+
+void lcd_wait_dma_idle(void) {}
+
+void lcd_set_dma_done_callback(void (*callback)(void))
+{
+    s_dma_done_callback = callback;
+}
+
+void lcd_scroll_area(int, int) {}
+void lcd_scroll_start(int) {}
+
+void lcd_fb_setaddr(const uint16_t*) {}
+void lcd_fb_enable(void) {}
+void lcd_fb_disable(void) {}
+
+} // extern "C"
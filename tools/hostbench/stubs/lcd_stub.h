@@ -0,0 +1,17 @@
+/*!
+    \file    lcd_stub.h
+    \brief   Counters exported by the host LCD stub
+
+    What the stubbed driver "uploaded to the panel"; benchmarks use
+    these to verify that the pipeline under test actually drained.
+*/
+
+#ifndef HOSTBENCH_LCD_STUB_H
+#define HOSTBENCH_LCD_STUB_H
+
+namespace hostbench {
+extern unsigned long lcd_bytes_written;
+extern unsigned long lcd_rects_written;
+} // namespace hostbench
+
+#endif // HOSTBENCH_LCD_STUB_H
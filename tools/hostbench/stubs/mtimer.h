@@ -0,0 +1,53 @@
+/*!
+    \file    mtimer.h
+    \brief   Host stand-in for the CLINT mtime layer
+
+    Shadows lib/system/mtimer.h (the stubs directory comes first on the
+    host include path), whose real version reads the CLINT registers
+    through n200_timer.h. Here a tick is one CLOCK_MONOTONIC
+    nanosecond, so mtimer_ticks_per_us() is a fixed 1000 and deadlines
+    computed through it stay consistent with mtimer_now(). The full
+    API surface is kept so any device module the bench picks up
+    compiles unchanged.
+*/
+
+#ifndef HOSTBENCH_MTIMER_H
+#define HOSTBENCH_MTIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t mtimer_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t mtimer_ticks_per_us(void)
+{
+    return 1000u;
+}
+
+static inline void delay_us(uint32_t us)
+{
+    uint64_t deadline = mtimer_now() + (uint64_t)us * mtimer_ticks_per_us();
+    while (mtimer_now() < deadline) {
+    }
+}
+
+typedef struct {
+    uint64_t deadline;
+} mtimer_timeout;
+
+static inline void mtimer_timeout_start(mtimer_timeout *t, uint32_t us)
+{
+    t->deadline = mtimer_now() + (uint64_t)us * mtimer_ticks_per_us();
+}
+
+static inline int mtimer_timeout_expired(const mtimer_timeout *t)
+{
+    return mtimer_now() >= t->deadline;
+}
+
+#endif /* HOSTBENCH_MTIMER_H */
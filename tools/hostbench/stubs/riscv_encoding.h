@@ -0,0 +1,33 @@
+/*!
+    \file    riscv_encoding.h
+    \brief   Host stand-in for the Nuclei CSR access macros
+
+    Shadows lib/system/riscv_encoding.h (the stubs directory comes first
+    on the host include path) so device logic that samples mcycle or
+    toggles MIE compiles unchanged on the host. read_csr() of any
+    register yields a monotonic nanosecond counter - close enough for
+    code that only ever takes deltas - and the interrupt-enable macros
+    dissolve, since the host harness is single-threaded.
+*/
+
+#ifndef HOSTBENCH_RISCV_ENCODING_H
+#define HOSTBENCH_RISCV_ENCODING_H
+
+#include <stdint.h>
+#include <time.h>
+
+#define MSTATUS_MIE 0x00000008
+
+static inline unsigned long hostbench_csr_counter(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)(ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+#define read_csr(reg) hostbench_csr_counter()
+#define write_csr(reg, val) ((void)(val))
+#define set_csr(reg, bit) ((void)(bit))
+#define clear_csr(reg, bit) ((void)(bit))
+
+#endif /* HOSTBENCH_RISCV_ENCODING_H */